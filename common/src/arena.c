@@ -0,0 +1,177 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "arena.h"
+#include "error_handler.h"
+
+/* Size of the error messages, which the applications define in different
+   headers */
+#ifndef STR_SIZE
+#define STR_SIZE 1024
+#endif
+
+/******************************************************************************
+MODULE:  init_arena
+
+PURPOSE:  Initializes the arena so it holds no memory.
+
+RETURN VALUE:
+Type = None
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+******************************************************************************/
+void init_arena
+(
+    Arena_t *arena       /* O: arena to be initialized */
+)
+{
+    arena->base = NULL;
+    arena->size = 0;
+    arena->used = 0;
+}
+
+
+/******************************************************************************
+MODULE:  reserve_arena
+
+PURPOSE:  Releases all the buffers carved from the arena, and makes sure the
+arena holds at least nbytes bytes.
+
+RETURN VALUE:
+Type = int
+Value      Description
+-----      -----------
+ERROR      Error allocating the memory block
+SUCCESS    Successful completion
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. The memory block is kept if it is large enough, otherwise it is
+     replaced by a larger block.  Either way the buffers carved before are
+     no longer valid.
+  2. nbytes should be the sum of ARENA_SIZE of each of the buffers to be
+     carved.
+******************************************************************************/
+int reserve_arena
+(
+    Arena_t *arena,      /* I/O: arena to be reserved */
+    size_t nbytes        /* I: number of bytes needed in the arena */
+)
+{
+    char FUNC_NAME[] = "reserve_arena";   /* function name */
+    char errmsg[STR_SIZE];    /* error message */
+    void *base = NULL;        /* new memory block */
+
+    arena->used = 0;
+    if (nbytes <= arena->size)
+        return (SUCCESS);
+
+    free (arena->base);
+    init_arena (arena);
+    if (posix_memalign (&base, ARENA_ALIGN, nbytes) != 0)
+    {
+        sprintf (errmsg, "Error allocating %zu bytes for the arena", nbytes);
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+    arena->base = base;
+    arena->size = nbytes;
+
+    return (SUCCESS);
+}
+
+
+/******************************************************************************
+MODULE:  carve_arena
+
+PURPOSE:  Carves a buffer of nbytes bytes from the arena.
+
+RETURN VALUE:
+Type = void *
+Value      Description
+-----      -----------
+NULL       The buffer doesn't fit in the arena
+non-NULL   Buffer, aligned to ARENA_ALIGN
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. Buffers which are completely written before they are read don't need
+     to be cleared, so zero is false for them.
+******************************************************************************/
+void *carve_arena
+(
+    Arena_t *arena,      /* I/O: arena to carve the buffer from */
+    size_t nbytes,       /* I: number of bytes in the buffer */
+    bool zero            /* I: should the buffer be cleared to 0s? */
+)
+{
+    char FUNC_NAME[] = "carve_arena";   /* function name */
+    char errmsg[STR_SIZE];    /* error message */
+    char *buf = NULL;         /* buffer carved from the arena */
+
+    if (arena->used + ARENA_SIZE (nbytes) > arena->size)
+    {
+        sprintf (errmsg, "Buffer of %zu bytes doesn't fit in the %zu bytes "
+            "left in the arena", nbytes, arena->size - arena->used);
+        error_handler (true, FUNC_NAME, errmsg);
+        return (NULL);
+    }
+
+    buf = arena->base + arena->used;
+    arena->used += ARENA_SIZE (nbytes);
+    if (zero)
+        memset (buf, 0, nbytes);
+
+    return (buf);
+}
+
+
+/******************************************************************************
+MODULE:  free_arena
+
+PURPOSE:  Frees the memory block of the arena, releasing all the buffers
+carved from it.
+
+RETURN VALUE:
+Type = None
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+******************************************************************************/
+void free_arena
+(
+    Arena_t *arena       /* I/O: arena to be freed */
+)
+{
+    free (arena->base);
+    init_arena (arena);
+}
@@ -0,0 +1,51 @@
+#ifndef _ARENA_H_
+#define _ARENA_H_
+
+#include <stddef.h>
+
+/* bool is the one of the application, from its error_handler.h */
+#include "error_handler.h"
+
+/* Alignment of the buffers carved from an arena, which is a cache line and
+   the widest SIMD load */
+#define ARENA_ALIGN 64
+
+/* Number of bytes of an arena used by a buffer of nbytes bytes */
+#define ARENA_SIZE(nbytes) \
+    (((size_t) (nbytes) + ARENA_ALIGN - 1) & ~((size_t) ARENA_ALIGN - 1))
+
+/* Arena holding the buffers for a scene in one memory block.  The buffers
+   are carved from the block in turn and are all released at once, so the
+   block can be reused for the next scene. */
+typedef struct {
+    char *base;          /* memory block, aligned to ARENA_ALIGN; NULL if not
+                            allocated */
+    size_t size;         /* number of bytes in the block */
+    size_t used;         /* number of bytes carved from the block */
+} Arena_t;
+
+/* Prototypes */
+void init_arena
+(
+    Arena_t *arena       /* O: arena to be initialized */
+);
+
+int reserve_arena
+(
+    Arena_t *arena,      /* I/O: arena to be reserved */
+    size_t nbytes        /* I: number of bytes needed in the arena */
+);
+
+void *carve_arena
+(
+    Arena_t *arena,      /* I/O: arena to carve the buffer from */
+    size_t nbytes,       /* I: number of bytes in the buffer */
+    bool zero            /* I: should the buffer be cleared to 0s? */
+);
+
+void free_arena
+(
+    Arena_t *arena       /* I/O: arena to be freed */
+);
+
+#endif
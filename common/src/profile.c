@@ -0,0 +1,343 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "profile.h"
+#include "error_handler.h"
+
+/* Size of the error messages, which the applications define in different
+   headers */
+#ifndef STR_SIZE
+#define STR_SIZE 1024
+#endif
+
+/******************************************************************************
+MODULE:  profile_clock
+
+PURPOSE:  Returns the current wall clock time, for timing the stages.
+
+RETURN VALUE:
+Type = double
+Value      Description
+-----      -----------
+seconds    Seconds from an arbitrary starting point (monotonic clock)
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+******************************************************************************/
+double profile_clock (void)
+{
+    struct timespec ts;       /* current time */
+
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    return (ts.tv_sec + ts.tv_nsec * 1.0e-9);
+}
+
+
+/******************************************************************************
+MODULE:  profile_cpu (static)
+
+PURPOSE:  Returns the CPU time used by all the threads of the process.
+
+RETURN VALUE:
+Type = double
+Value      Description
+-----      -----------
+seconds    CPU time in seconds
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+******************************************************************************/
+static double profile_cpu (void)
+{
+    struct timespec ts;       /* current CPU time */
+
+    clock_gettime (CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return (ts.tv_sec + ts.tv_nsec * 1.0e-9);
+}
+
+
+/******************************************************************************
+MODULE:  init_profile
+
+PURPOSE:  Initializes the profile, with all the stage totals cleared.
+
+RETURN VALUE:
+Type = None
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. The profile points to stage_names, so they need to stay valid while the
+     profile is in use.
+******************************************************************************/
+void init_profile
+(
+    bool enabled,          /* I: should the profile be collected */
+    int nstages,           /* I: number of stages */
+    char **stage_names,    /* I: name of each stage */
+    Profile_t *prof        /* O: profile to be initialized */
+)
+{
+    memset (prof, 0, sizeof (Profile_t));
+    prof->enabled = enabled;
+    prof->nstages = (nstages < PROFILE_MAX_STAGES) ? nstages :
+        PROFILE_MAX_STAGES;
+    prof->stage_names = stage_names;
+    prof->wall_start = profile_clock ();
+    prof->cpu_start = profile_cpu ();
+}
+
+
+/******************************************************************************
+MODULE:  start_profile_stage
+
+PURPOSE:  Marks the start of a stage.
+
+RETURN VALUE:
+Type = None
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. The stages are started and stopped from the main thread.  The CPU time
+     includes all the threads, so parallel stages report their total CPU.
+******************************************************************************/
+void start_profile_stage
+(
+    Profile_t *prof,       /* I: profile */
+    Profile_mark_t *mark   /* O: start of the stage */
+)
+{
+    if (!prof->enabled)
+        return;
+
+    mark->wall = profile_clock ();
+    mark->cpu = profile_cpu ();
+}
+
+
+/******************************************************************************
+MODULE:  stop_profile_stage
+
+PURPOSE:  Adds the time since the start of the stage and the pixels and bytes
+processed to the totals for the stage.
+
+RETURN VALUE:
+Type = None
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+******************************************************************************/
+void stop_profile_stage
+(
+    Profile_t *prof,       /* I/O: profile */
+    int stage,             /* I: stage being stopped */
+    Profile_mark_t *mark,  /* I: start of the stage */
+    long long npix,        /* I: number of pixels processed */
+    long long bytes_read,  /* I: number of bytes read */
+    long long bytes_written  /* I: number of bytes written */
+)
+{
+    Profile_stage_t *ps = NULL;   /* totals for the stage */
+
+    if (!prof->enabled || stage < 0 || stage >= prof->nstages)
+        return;
+
+    ps = &prof->stage[stage];
+    ps->ncalls++;
+    ps->wall_sec += profile_clock () - mark->wall;
+    ps->cpu_sec += profile_cpu () - mark->cpu;
+    ps->npix += npix;
+    ps->bytes_read += bytes_read;
+    ps->bytes_written += bytes_written;
+}
+
+
+/******************************************************************************
+MODULE:  split_profile_stage
+
+PURPOSE:  Divides the time since the start of a group of stages which run
+together (such as kernels called in the same parallel loop) among the stages
+by their weights.
+
+RETURN VALUE:
+Type = None
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. The weights are generally the time spent in each of the kernels summed
+     over the threads.  If all the weights are 0, the time is divided evenly.
+******************************************************************************/
+void split_profile_stage
+(
+    Profile_t *prof,       /* I/O: profile */
+    int nsplit,            /* I: number of stages sharing the time */
+    int *stages,           /* I: stages sharing the time */
+    double *weights,       /* I: share of the time for each stage */
+    Profile_mark_t *mark,  /* I: start of the shared stages */
+    long long npix         /* I: number of pixels processed by each stage */
+)
+{
+    int i;                    /* looping variable for the stages */
+    double wall;              /* elapsed time for the group of stages */
+    double cpu;               /* CPU time for the group of stages */
+    double total = 0.0;       /* sum of the weights */
+    double share;             /* share of the time for the current stage */
+    Profile_stage_t *ps = NULL;   /* totals for the current stage */
+
+    if (!prof->enabled)
+        return;
+
+    wall = profile_clock () - mark->wall;
+    cpu = profile_cpu () - mark->cpu;
+    for (i = 0; i < nsplit; i++)
+        total += weights[i];
+
+    for (i = 0; i < nsplit; i++)
+    {
+        if (stages[i] < 0 || stages[i] >= prof->nstages)
+            continue;
+        share = (total > 0.0) ? weights[i] / total : 1.0 / nsplit;
+        ps = &prof->stage[stages[i]];
+        ps->ncalls++;
+        ps->wall_sec += wall * share;
+        ps->cpu_sec += cpu * share;
+        ps->npix += npix;
+    }
+}
+
+
+/******************************************************************************
+MODULE:  write_profile
+
+PURPOSE:  Writes the profile as a JSON summary.
+
+RETURN VALUE:
+Type = int
+Value      Description
+-----      -----------
+ERROR      Error writing the profile
+SUCCESS    Successful completion
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. The rates are derived from the wall clock time of each stage.  Stages
+     which didn't run report rates of 0.
+******************************************************************************/
+int write_profile
+(
+    Profile_t *prof,       /* I: profile */
+    char *app_name,        /* I: name of the application */
+    int nthreads,          /* I: number of threads used for processing */
+    char *profile_file     /* I: JSON file to write; NULL or "-" writes to
+                                 stdout */
+)
+{
+    char FUNC_NAME[] = "write_profile";   /* function name */
+    char errmsg[STR_SIZE];    /* error message */
+    int i;                    /* looping variable for the stages */
+    bool to_stdout;           /* is the profile written to stdout */
+    FILE *fptr = NULL;        /* JSON file pointer */
+    Profile_stage_t *ps = NULL;   /* totals for the current stage */
+
+    if (!prof->enabled)
+        return (SUCCESS);
+
+    to_stdout = (profile_file == NULL || !strcmp (profile_file, "-"));
+    if (to_stdout)
+        fptr = stdout;
+    else
+    {
+        fptr = fopen (profile_file, "w");
+        if (fptr == NULL)
+        {
+            sprintf (errmsg, "Error opening the profile file: %s",
+                profile_file);
+            error_handler (true, FUNC_NAME, errmsg);
+            return (ERROR);
+        }
+    }
+
+    fprintf (fptr, "{\n");
+    fprintf (fptr, "  \"application\": \"%s\",\n", app_name);
+    fprintf (fptr, "  \"threads\": %d,\n", nthreads);
+    fprintf (fptr, "  \"wall_sec\": %.6f,\n",
+        profile_clock () - prof->wall_start);
+    fprintf (fptr, "  \"cpu_sec\": %.6f,\n", profile_cpu () - prof->cpu_start);
+    fprintf (fptr, "  \"stages\": [\n");
+    for (i = 0; i < prof->nstages; i++)
+    {
+        ps = &prof->stage[i];
+        fprintf (fptr, "    {\"name\": \"%s\", \"calls\": %ld, "
+            "\"wall_sec\": %.6f, \"cpu_sec\": %.6f, \"bytes_read\": %lld, "
+            "\"bytes_written\": %lld, \"pixels\": %lld, "
+            "\"pixels_per_sec\": %.1f, \"mb_per_sec\": %.3f}%s\n",
+            prof->stage_names[i], ps->ncalls, ps->wall_sec, ps->cpu_sec,
+            ps->bytes_read, ps->bytes_written, ps->npix,
+            (ps->wall_sec > 0.0) ? ps->npix / ps->wall_sec : 0.0,
+            (ps->wall_sec > 0.0) ? (ps->bytes_read + ps->bytes_written) /
+            (ps->wall_sec * 1024.0 * 1024.0) : 0.0,
+            (i < prof->nstages - 1) ? "," : "");
+    }
+    fprintf (fptr, "  ]\n");
+    fprintf (fptr, "}\n");
+
+    if (to_stdout)
+        fflush (fptr);
+    else if (fclose (fptr) != 0)
+    {
+        sprintf (errmsg, "Error writing the profile file: %s", profile_file);
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+
+    return (SUCCESS);
+}
@@ -0,0 +1,84 @@
+#ifndef _PROFILE_H_
+#define _PROFILE_H_
+
+/* bool is the one of the application, from its error_handler.h */
+#include "error_handler.h"
+
+/* Maximum number of stages which can be profiled */
+#define PROFILE_MAX_STAGES 16
+
+/* Totals for one of the processing stages */
+typedef struct {
+    long ncalls;              /* number of times the stage was run */
+    double wall_sec;          /* elapsed (wall clock) time in seconds */
+    double cpu_sec;           /* CPU time of all the threads in seconds */
+    long long bytes_read;     /* number of bytes read by the stage */
+    long long bytes_written;  /* number of bytes written by the stage */
+    long long npix;           /* number of pixels processed by the stage */
+} Profile_stage_t;
+
+/* Profile of the processing stages.  When the profile isn't enabled, none
+   of the profile routines do anything. */
+typedef struct {
+    bool enabled;             /* is the profile being collected */
+    int nstages;              /* number of stages */
+    char **stage_names;       /* name of each stage, as used in the JSON
+                                 summary */
+    double wall_start;        /* wall clock time the profile was started */
+    double cpu_start;         /* CPU time the profile was started */
+    Profile_stage_t stage[PROFILE_MAX_STAGES];  /* totals for each stage */
+} Profile_t;
+
+/* Wall clock and CPU time at the start of a stage */
+typedef struct {
+    double wall;              /* wall clock time in seconds */
+    double cpu;               /* CPU time in seconds */
+} Profile_mark_t;
+
+/* Prototypes */
+double profile_clock (void);
+
+void init_profile
+(
+    bool enabled,          /* I: should the profile be collected */
+    int nstages,           /* I: number of stages */
+    char **stage_names,    /* I: name of each stage */
+    Profile_t *prof        /* O: profile to be initialized */
+);
+
+void start_profile_stage
+(
+    Profile_t *prof,       /* I: profile */
+    Profile_mark_t *mark   /* O: start of the stage */
+);
+
+void stop_profile_stage
+(
+    Profile_t *prof,       /* I/O: profile */
+    int stage,             /* I: stage being stopped */
+    Profile_mark_t *mark,  /* I: start of the stage */
+    long long npix,        /* I: number of pixels processed */
+    long long bytes_read,  /* I: number of bytes read */
+    long long bytes_written  /* I: number of bytes written */
+);
+
+void split_profile_stage
+(
+    Profile_t *prof,       /* I/O: profile */
+    int nsplit,            /* I: number of stages sharing the time */
+    int *stages,           /* I: stages sharing the time */
+    double *weights,       /* I: share of the time for each stage */
+    Profile_mark_t *mark,  /* I: start of the shared stages */
+    long long npix         /* I: number of pixels processed by each stage */
+);
+
+int write_profile
+(
+    Profile_t *prof,       /* I: profile */
+    char *app_name,        /* I: name of the application */
+    int nthreads,          /* I: number of threads used for processing */
+    char *profile_file     /* I: JSON file to write; NULL or "-" writes to
+                                 stdout */
+);
+
+#endif
@@ -0,0 +1,472 @@
+#include <stdlib.h>
+#include <string.h>
+#include <zlib.h>
+#include "tiled_output.h"
+#include "error_handler.h"
+
+/* Size of the error messages, which the applications define in different
+   headers */
+#ifndef STR_SIZE
+#define STR_SIZE 1024
+#endif
+
+/******************************************************************************
+MODULE:  write_tile_row (static)
+
+PURPOSE:  Compresses and writes each of the tiles in the row of tiles held
+for the level, and starts the next row of tiles.
+
+RETURN VALUE:
+Type = int
+Value      Description
+-----      -----------
+ERROR      Error compressing or writing the tiles
+SUCCESS    Successful completion
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. The row of tiles holds level->row_nlines lines, which is TILE_SIZE
+     lines except for the last row of the level.
+******************************************************************************/
+static int write_tile_row
+(
+    Tiled_output_t *this,  /* I/O: tiled output file */
+    Tile_level_t *level    /* I/O: level with the row of tiles to write */
+)
+{
+    char FUNC_NAME[] = "write_tile_row";   /* function name */
+    char errmsg[STR_SIZE];    /* error message */
+    int col;                  /* loop counter for the tiles in the row */
+    int line;                 /* loop counter for the lines in a tile */
+    int samp0;                /* first sample of the tile */
+    size_t tile_width;        /* number of bytes in each line of the tile */
+    size_t line_width;        /* number of bytes in each line of the level */
+    long itile;               /* location of the tile in the index */
+    unsigned long zlen;       /* number of bytes in the compressed tile */
+
+    line_width = (size_t) level->nsamps * this->nbytes;
+    for (col = 0; col < level->ntile_cols; col++)
+    {
+        /* Gather the lines of the tile */
+        samp0 = col * TILE_SIZE;
+        tile_width = (size_t) ((level->nsamps - samp0 < TILE_SIZE) ?
+            level->nsamps - samp0 : TILE_SIZE) * this->nbytes;
+        for (line = 0; line < level->row_nlines; line++)
+            memcpy (&this->tile_buf[line * tile_width],
+                &level->row_buf[line * line_width + (size_t) samp0 *
+                this->nbytes], tile_width);
+
+        /* Compress the tile and append it to the file */
+        zlen = this->zbuf_size;
+        if (compress2 (this->zbuf, &zlen, (unsigned char *) this->tile_buf,
+            tile_width * level->row_nlines, TILE_DEFLATE_LEVEL) != Z_OK)
+        {
+            sprintf (errmsg, "Error compressing tile %d of row %d of %s", col,
+                level->row, this->file_name);
+            error_handler (true, FUNC_NAME, errmsg);
+            return (ERROR);
+        }
+        if (fwrite (this->zbuf, 1, zlen, this->fp) != zlen)
+        {
+            sprintf (errmsg, "Error writing tile %d of row %d of %s", col,
+                level->row, this->file_name);
+            error_handler (true, FUNC_NAME, errmsg);
+            return (ERROR);
+        }
+
+        itile = level->first_tile + (long) level->row * level->ntile_cols +
+            col;
+        this->index[2*itile] = this->end;
+        this->index[2*itile+1] = zlen;
+        this->end += zlen;
+    }
+
+    level->row++;
+    level->row_nlines = 0;
+
+    return (SUCCESS);
+}
+
+
+/******************************************************************************
+MODULE:  open_tiled_output
+
+PURPOSE:  Creates a tiled output file for an image, and sets up the levels
+holding the image and its overviews.
+
+RETURN VALUE:
+Type = Tiled_output_t *
+Value          Description
+-----          -----------
+NULL           Error creating the tiled output file
+non-NULL       Successful completion
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. See tiled_output.h for the layout of the file.  Overviews are added,
+     each half the size of the level before it, until the last level fits
+     in one tile.
+  2. The header and index are written as 0s, and are filled in by
+     close_tiled_output once all of the tiles have been written.
+******************************************************************************/
+Tiled_output_t *open_tiled_output
+(
+    char *file_name,     /* I: name of the tiled output file */
+    int nlines,          /* I: number of lines in the image */
+    int nsamps,          /* I: number of samples in the image */
+    int nbytes,          /* I: number of bytes per pixel */
+    double ul_corner[2], /* I: map x and y of the UL corner of the UL pixel */
+    double pixel_size[2] /* I: pixel size in x and y */
+)
+{
+    char FUNC_NAME[] = "open_tiled_output";   /* function name */
+    char errmsg[STR_SIZE];    /* error message */
+    int il;                   /* loop counter for the levels */
+    long i;                   /* loop counter for the header and index */
+    Tile_level_t *level = NULL;   /* level being set up */
+    Tiled_output_t *this = NULL;  /* tiled output file */
+
+    if (nlines < 1 || nsamps < 1 || nbytes < 1)
+    {
+        sprintf (errmsg, "Invalid image size for %s: %d lines, %d samples, "
+            "%d bytes per pixel", file_name, nlines, nsamps, nbytes);
+        error_handler (true, FUNC_NAME, errmsg);
+        return (NULL);
+    }
+
+    this = calloc (1, sizeof (Tiled_output_t));
+    if (this == NULL)
+    {
+        sprintf (errmsg, "Error allocating memory for the tiled output data "
+            "structure");
+        error_handler (true, FUNC_NAME, errmsg);
+        return (NULL);
+    }
+    this->nlines = nlines;
+    this->nsamps = nsamps;
+    this->nbytes = nbytes;
+    this->ul_corner[0] = ul_corner[0];
+    this->ul_corner[1] = ul_corner[1];
+    this->pixel_size[0] = pixel_size[0];
+    this->pixel_size[1] = pixel_size[1];
+    this->file_name = strdup (file_name);
+    if (this->file_name == NULL)
+    {
+        sprintf (errmsg, "Error allocating memory for the tiled output file "
+            "name");
+        error_handler (true, FUNC_NAME, errmsg);
+        free_tiled_output (this);
+        return (NULL);
+    }
+
+    /* Set up the levels, each holding every other line and sample of the
+       level before it */
+    this->ntiles = 0;
+    for (il = 0; il < TILE_MAX_LEVELS; il++)
+    {
+        level = &this->level[il];
+        level->nlines = (int) (((long) nlines + (1L << il) - 1) >> il);
+        level->nsamps = (int) (((long) nsamps + (1L << il) - 1) >> il);
+        level->ntile_cols = (level->nsamps + TILE_SIZE - 1) / TILE_SIZE;
+        level->first_tile = this->ntiles;
+        this->ntiles += (long) level->ntile_cols *
+            ((level->nlines + TILE_SIZE - 1) / TILE_SIZE);
+        level->row_buf = malloc ((size_t) TILE_SIZE * level->nsamps * nbytes);
+        if (level->row_buf == NULL)
+        {
+            sprintf (errmsg, "Error allocating memory for level %d of %s", il,
+                file_name);
+            error_handler (true, FUNC_NAME, errmsg);
+            free_tiled_output (this);
+            return (NULL);
+        }
+        this->nlevels = il + 1;
+        if (level->nlines <= TILE_SIZE && level->nsamps <= TILE_SIZE)
+            break;
+    }
+
+    this->index = calloc (2 * this->ntiles, sizeof (int64_t));
+    this->tile_buf = malloc ((size_t) TILE_SIZE * TILE_SIZE * nbytes);
+    this->zbuf_size = compressBound ((uLong) TILE_SIZE * TILE_SIZE * nbytes);
+    this->zbuf = malloc (this->zbuf_size);
+    if (this->index == NULL || this->tile_buf == NULL || this->zbuf == NULL)
+    {
+        sprintf (errmsg, "Error allocating memory for the tiles of %s",
+            file_name);
+        error_handler (true, FUNC_NAME, errmsg);
+        free_tiled_output (this);
+        return (NULL);
+    }
+
+    /* Create the file, and hold the space for the header and index */
+    this->fp = fopen (file_name, "wb");
+    if (this->fp == NULL)
+    {
+        sprintf (errmsg, "Error creating the tiled output file %s",
+            file_name);
+        error_handler (true, FUNC_NAME, errmsg);
+        free_tiled_output (this);
+        return (NULL);
+    }
+    this->end = TILE_HEADER_SIZE + 2 * this->ntiles * (int64_t)
+        sizeof (int64_t);
+    for (i = 0; i < this->end; i++)
+    {
+        if (putc (0, this->fp) == EOF)
+        {
+            sprintf (errmsg, "Error writing the header of %s", file_name);
+            error_handler (true, FUNC_NAME, errmsg);
+            fclose (this->fp);
+            this->fp = NULL;
+            free_tiled_output (this);
+            return (NULL);
+        }
+    }
+
+    return (this);
+}
+
+
+/******************************************************************************
+MODULE:  put_tiled_output_lines
+
+PURPOSE:  Adds lines of the image to the tiled output file, and to each of
+its overviews.
+
+RETURN VALUE:
+Type = int
+Value      Description
+-----      -----------
+ERROR      Error writing the lines
+SUCCESS    Successful completion
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. The lines must be written in order, starting with line 0.
+******************************************************************************/
+int put_tiled_output_lines
+(
+    Tiled_output_t *this,  /* I/O: tiled output file */
+    void *buf,             /* I: lines to be written */
+    int iline,             /* I: first line to be written (0-based) */
+    int nlines             /* I: number of lines to be written */
+)
+{
+    char FUNC_NAME[] = "put_tiled_output_lines";   /* function name */
+    char errmsg[STR_SIZE];    /* error message */
+    int il;                   /* loop counter for the levels */
+    int line;                 /* line of the image being added */
+    int samp;                 /* loop counter for the samples of a level */
+    size_t line_width;        /* number of bytes in each line of the image */
+    char *src = NULL;         /* line of the image being added */
+    char *dst = NULL;         /* line of the level being filled */
+    Tile_level_t *level = NULL;   /* level being filled */
+
+    if (iline != this->next_line || nlines < 0 ||
+        iline + nlines > this->nlines)
+    {
+        sprintf (errmsg, "Lines %d to %d of %s are out of order; line %d is "
+            "next", iline, iline + nlines - 1, this->file_name,
+            this->next_line);
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+
+    line_width = (size_t) this->nsamps * this->nbytes;
+    for (line = iline; line < iline + nlines; line++)
+    {
+        src = (char *) buf + (size_t) (line - iline) * line_width;
+        for (il = 0; il < this->nlevels; il++)
+        {
+            /* Level il only holds every 2^il-th line */
+            if (line & ((1 << il) - 1))
+                break;
+
+            level = &this->level[il];
+            dst = &level->row_buf[(size_t) level->row_nlines * level->nsamps *
+                this->nbytes];
+            if (il == 0)
+                memcpy (dst, src, line_width);
+            else if (this->nbytes == 1)
+            {
+                for (samp = 0; samp < level->nsamps; samp++)
+                    dst[samp] = src[(size_t) samp << il];
+            }
+            else
+            {
+                for (samp = 0; samp < level->nsamps; samp++)
+                    memcpy (&dst[(size_t) samp * this->nbytes],
+                        &src[((size_t) samp << il) * this->nbytes],
+                        this->nbytes);
+            }
+
+            /* Write the row of tiles once it is filled */
+            level->row_nlines++;
+            if (level->row_nlines == TILE_SIZE ||
+                level->row * TILE_SIZE + level->row_nlines == level->nlines)
+            {
+                if (write_tile_row (this, level) != SUCCESS)
+                {
+                    sprintf (errmsg, "Error writing level %d of %s", il,
+                        this->file_name);
+                    error_handler (true, FUNC_NAME, errmsg);
+                    return (ERROR);
+                }
+            }
+        }
+    }
+    this->next_line += nlines;
+
+    return (SUCCESS);
+}
+
+
+/******************************************************************************
+MODULE:  close_tiled_output
+
+PURPOSE:  Writes the header and tile index of the tiled output file, and
+closes the file.
+
+RETURN VALUE:
+Type = int
+Value      Description
+-----      -----------
+ERROR      Error writing the header or not all lines were written
+SUCCESS    Successful completion
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. The file is closed even if an error occurs.
+******************************************************************************/
+int close_tiled_output
+(
+    Tiled_output_t *this   /* I/O: tiled output file to close */
+)
+{
+    char FUNC_NAME[] = "close_tiled_output";   /* function name */
+    char errmsg[STR_SIZE];    /* error message */
+    int status = SUCCESS;     /* return status */
+    char header[TILE_HEADER_SIZE];  /* header of the file */
+    int32_t ival[7];          /* integer values in the header */
+    int64_t index_offset = TILE_HEADER_SIZE;  /* file offset of the index */
+
+    if (this->fp == NULL)
+    {
+        sprintf (errmsg, "Tiled output file is not open");
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+    if (this->next_line != this->nlines)
+    {
+        sprintf (errmsg, "Only %d of the %d lines were written to %s",
+            this->next_line, this->nlines, this->file_name);
+        error_handler (true, FUNC_NAME, errmsg);
+        status = ERROR;
+    }
+
+    /* Fill in the header and index */
+    memset (header, 0, TILE_HEADER_SIZE);
+    memcpy (header, TILE_MAGIC, 8);
+    ival[0] = TILE_VERSION;
+    ival[1] = this->nlines;
+    ival[2] = this->nsamps;
+    ival[3] = this->nbytes;
+    ival[4] = TILE_SIZE;
+    ival[5] = this->nlevels;
+    ival[6] = TILE_COMPRESS_DEFLATE;
+    memcpy (&header[8], ival, sizeof (ival));
+    memcpy (&header[40], this->ul_corner, 2 * sizeof (double));
+    memcpy (&header[56], this->pixel_size, 2 * sizeof (double));
+    memcpy (&header[72], &index_offset, sizeof (int64_t));
+    if (status == SUCCESS &&
+        (fseek (this->fp, 0, SEEK_SET) != 0 ||
+         fwrite (header, 1, TILE_HEADER_SIZE, this->fp) != TILE_HEADER_SIZE ||
+         fwrite (this->index, sizeof (int64_t), 2 * this->ntiles, this->fp) !=
+         (size_t) (2 * this->ntiles)))
+    {
+        sprintf (errmsg, "Error writing the header and tile index of %s",
+            this->file_name);
+        error_handler (true, FUNC_NAME, errmsg);
+        status = ERROR;
+    }
+
+    if (fclose (this->fp) != 0 && status == SUCCESS)
+    {
+        sprintf (errmsg, "Error closing %s", this->file_name);
+        error_handler (true, FUNC_NAME, errmsg);
+        status = ERROR;
+    }
+    this->fp = NULL;
+
+    return (status);
+}
+
+
+/******************************************************************************
+MODULE:  free_tiled_output
+
+PURPOSE:  Frees the memory for the tiled output file.
+
+RETURN VALUE:
+Type = None
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. If the file is still open, it is closed without writing the header, so
+     it is not a valid tiled output file.
+******************************************************************************/
+void free_tiled_output
+(
+    Tiled_output_t *this   /* I/O: tiled output file to free */
+)
+{
+    int il;                   /* loop counter for the levels */
+
+    if (this == NULL)
+        return;
+
+    if (this->fp != NULL)
+        fclose (this->fp);
+    for (il = 0; il < TILE_MAX_LEVELS; il++)
+        free (this->level[il].row_buf);
+    free (this->index);
+    free (this->tile_buf);
+    free (this->zbuf);
+    free (this->file_name);
+    free (this);
+}
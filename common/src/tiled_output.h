@@ -0,0 +1,103 @@
+#ifndef _TILED_OUTPUT_H_
+#define _TILED_OUTPUT_H_
+
+#include <stdio.h>
+#include <stdint.h>
+
+/* Define the size of the tiles, the maximum number of levels (the full
+   resolution image plus its overviews), and the deflate level of the tiles
+   in the tiled output files */
+#define TILE_SIZE 256
+#define TILE_MAX_LEVELS 16
+#define TILE_DEFLATE_LEVEL 6
+
+/* Define the layout of the tiled output files.  The file starts with a
+   header of TILE_HEADER_SIZE bytes:
+     offset  0: magic string TILE_MAGIC (8 chars, not NUL terminated)
+     offset  8: int32 version (TILE_VERSION)
+     offset 12: int32 number of lines in the image
+     offset 16: int32 number of samples in the image
+     offset 20: int32 number of bytes per pixel
+     offset 24: int32 tile size, in lines and samples
+     offset 28: int32 number of levels, including the full resolution image
+     offset 32: int32 compression of the tiles (TILE_COMPRESS_DEFLATE)
+     offset 40: double map x and y of the UL corner of the UL pixel
+     offset 56: double pixel size in x and y, in map units
+     offset 72: int64 file offset of the tile index
+   and the rest of the header is 0s.  The tile index follows the header, so
+   a reader can find any tile with two reads.  It holds an int64 file offset
+   and an int64 number of bytes for each tile, for each level in turn and
+   for the tiles of each level by row.  Level l has (nlines + 2^l - 1) / 2^l
+   lines and (nsamps + 2^l - 1) / 2^l samples, and holds every 2^l-th
+   sample of every 2^l-th line of the image, so the overviews keep the mask
+   values rather than averaging them.  The tiles of the last row and column
+   are cropped to the image.  Each tile is its lines of pixels, compressed as
+   a zlib stream.  All of the values are in the byte order of the host. */
+#define TILE_MAGIC "SCATILE1"
+#define TILE_VERSION 1
+#define TILE_COMPRESS_DEFLATE 1
+#define TILE_HEADER_SIZE 128
+
+/* Structure for a level of a tiled output file */
+typedef struct {
+    int nlines;           /* number of lines in the level */
+    int nsamps;           /* number of samples in the level */
+    int ntile_cols;       /* number of tiles in each row of tiles */
+    long first_tile;      /* location in the index of the first tile */
+    int row;              /* row of tiles being filled */
+    int row_nlines;       /* number of lines held in row_buf */
+    char *row_buf;        /* lines of the row of tiles being filled */
+} Tile_level_t;
+
+/* Structure for a tiled output file.  The lines are written in order, and
+   each row of tiles of each level is compressed and written as soon as it
+   is filled. */
+typedef struct {
+    char *file_name;      /* name of the tiled output file */
+    FILE *fp;             /* file pointer for the tiled output file */
+    int nlines;           /* number of lines in the image */
+    int nsamps;           /* number of samples in the image */
+    int nbytes;           /* number of bytes per pixel */
+    double ul_corner[2];  /* map x and y of the UL corner of the UL pixel */
+    double pixel_size[2]; /* pixel size in x and y */
+    int next_line;        /* next line of the image to be written */
+    int nlevels;          /* number of levels, including the image */
+    Tile_level_t level[TILE_MAX_LEVELS];  /* levels of the file */
+    long ntiles;          /* number of tiles in all of the levels */
+    int64_t *index;       /* file offset and number of bytes of each tile */
+    int64_t end;          /* file offset at which the next tile is written */
+    char *tile_buf;       /* pixels of the tile being compressed */
+    unsigned char *zbuf;  /* compressed tile */
+    unsigned long zbuf_size;  /* number of bytes allocated for zbuf */
+} Tiled_output_t;
+
+/* Prototypes */
+Tiled_output_t *open_tiled_output
+(
+    char *file_name,     /* I: name of the tiled output file */
+    int nlines,          /* I: number of lines in the image */
+    int nsamps,          /* I: number of samples in the image */
+    int nbytes,          /* I: number of bytes per pixel */
+    double ul_corner[2], /* I: map x and y of the UL corner of the UL pixel */
+    double pixel_size[2] /* I: pixel size in x and y */
+);
+
+int put_tiled_output_lines
+(
+    Tiled_output_t *this,  /* I/O: tiled output file */
+    void *buf,             /* I: lines to be written */
+    int iline,             /* I: first line to be written (0-based) */
+    int nlines             /* I: number of lines to be written */
+);
+
+int close_tiled_output
+(
+    Tiled_output_t *this   /* I/O: tiled output file to close */
+);
+
+void free_tiled_output
+(
+    Tiled_output_t *this   /* I/O: tiled output file to free */
+);
+
+#endif
@@ -0,0 +1,369 @@
+#! /usr/bin/env python
+
+'''
+Created on October 15, 2026 by agent
+
+License:
+  "NASA Open Source Agreement 1.3"
+
+Description:
+  Golden-output regression of revised_cloud_mask.  A reference
+  revised_cloud_mask is built from an earlier revision of the tree (or given
+  as an executable), and it and the revised_cloud_mask under test are run on
+  copies of the fixture scenes.  Every band which the reference adds to the
+  XML file (the NDVI, NDSI, variance, and revised cloud mask bands) is then
+  compared pixel for pixel with the same band from the run under test.
+
+  The revised_cloud_mask under test may be run with several variants of its
+  optional arguments (threads, memory budget, write mode, shards, ...),
+  each of which is compared with the same reference bands.
+
+Usage:
+  regress_revised_cloud_mask.py --help prints the help message
+'''
+
+import sys
+import os
+import array
+import shutil
+import subprocess
+import tempfile
+import xml.etree.ElementTree as ElementTree
+from optparse import OptionParser
+
+# source directory of revised_cloud_mask in the tree
+SRC_DIR = 'fSCA/src'
+# directory of the modules shared with the other application
+COMMON_DIR = 'common'
+EXE = 'revised_cloud_mask'
+
+# array typecodes of the ESPA raw binary data types
+ESPA_TYPES = {'INT8': 'b', 'UINT8': 'B', 'INT16': 'h', 'UINT16': 'H',
+    'INT32': 'i', 'UINT32': 'I', 'FLOAT32': 'f', 'FLOAT64': 'd'}
+
+
+############################################################################
+# Description: readFixtures reads the list of fixture scenes.
+#
+# Inputs:
+#   fixtures - name of the fixture list.  Each line names the ESPA XML file
+#       of a scene.  Relative names are relative to the directory of the
+#       fixture list.  Blank lines and lines starting with '#' are skipped.
+#
+# Returns:
+#   list of the full XML file names
+############################################################################
+def readFixtures (fixtures):
+    fixdir = os.path.dirname (os.path.abspath (fixtures))
+    scenes = []
+    ffile = open (fixtures, 'r')
+    for line in ffile:
+        line = line.strip()
+        if line == '' or line.startswith ('#'):
+            continue
+        scenes.append (os.path.join (fixdir, line))
+    ffile.close()
+
+    if len(scenes) == 0:
+        raise ValueError ('No fixture scenes are listed in %s' % fixtures)
+    return scenes
+
+
+############################################################################
+# Description: readBands reads the band information from an ESPA XML file.
+#
+# Inputs:
+#   xml_file - name of the XML file
+#
+# Returns:
+#   list of (name, file_name, data_type, nlines, nsamps) tuples, one for
+#   each band, with the file names relative to the XML file
+############################################################################
+def readBands (xml_file):
+    bands = []
+    for elem in ElementTree.parse (xml_file).getroot().iter():
+        if elem.tag.split ('}')[-1] != 'band':
+            continue
+        file_name = None
+        for child in elem:
+            if child.tag.split ('}')[-1] == 'file_name':
+                file_name = child.text.strip()
+        bands.append ((elem.get ('name'), file_name, elem.get ('data_type'),
+            int (elem.get ('nlines')), int (elem.get ('nsamps'))))
+    return bands
+
+
+############################################################################
+# Description: buildReference builds revised_cloud_mask from the specified
+# revision of the tree.
+#
+# Inputs:
+#   ref_rev - git revision of the reference
+#   work_dir - directory for the reference tree
+#   make_args - list of the variable assignments for make, such as the
+#       include and library directories
+#
+# Returns:
+#   name of the reference executable
+#
+# Notes:
+#   1. The revision is extracted with git archive rather than checked out,
+#      so the working tree is left alone.  The modules shared by the
+#      applications are extracted too, if the revision has them.  make is
+#      run in the extracted tree with make_args, which give the include and
+#      library directories of the ESPA, XML2, and Boost libraries.  The
+#      baseline also links OpenCV, so make_args need OPENCVINC and
+#      OPENCVLIB to build it.
+############################################################################
+def buildReference (ref_rev, work_dir, make_args):
+    top = subprocess.check_output (['git', 'rev-parse', '--show-toplevel'],
+        cwd=os.path.dirname (os.path.abspath (__file__)))
+    top = top.decode().strip()
+    ref_tree = os.path.join (work_dir, 'ref_tree')
+    os.mkdir (ref_tree)
+
+    print ('Building the reference %s from %s' % (EXE, ref_rev))
+    paths = [os.path.dirname (SRC_DIR)]
+    if subprocess.call (['git', 'cat-file', '-e', '%s:%s' % (ref_rev,
+        COMMON_DIR)], cwd=top, stderr=open (os.devnull, 'w')) == 0:
+        paths.append (COMMON_DIR)
+    archive = subprocess.Popen (['git', 'archive', '--format=tar', ref_rev]
+        + paths, cwd=top, stdout=subprocess.PIPE)
+    subprocess.check_call (['tar', '-xf', '-'], cwd=ref_tree,
+        stdin=archive.stdout)
+    archive.stdout.close()
+    if archive.wait() != 0:
+        raise RuntimeError ('Error extracting revision %s' % ref_rev)
+    subprocess.check_call (['make', EXE] + make_args,
+        cwd=os.path.join (ref_tree, SRC_DIR))
+
+    ref_exe = os.path.join (work_dir, EXE + '_ref')
+    shutil.copy (os.path.join (ref_tree, SRC_DIR, EXE), ref_exe)
+    shutil.rmtree (ref_tree)
+    return ref_exe
+
+
+############################################################################
+# Description: runScenes runs revised_cloud_mask on a copy of each of the
+# fixture scenes.
+#
+# Inputs:
+#   exe - revised_cloud_mask executable
+#   runs - list of the argument lists of each run; a variant may need more
+#       than one run on a scene, such as the shards and their finalize step
+#   scenes - list of the XML files
+#   run_dir - directory for the copies of the scenes and their outputs
+#
+# Returns:
+#   list of the XML files of the copies, one for each scene
+#
+# Notes:
+#   1. revised_cloud_mask writes its bands next to the input bands and adds
+#      them to the XML file, so each run works on its own copy of the XML
+#      file and the input bands.
+############################################################################
+def runScenes (exe, runs, scenes, run_dir):
+    xml_files = []
+    for (iscene, xml_file) in enumerate (scenes):
+        scene_dir = os.path.join (run_dir, 'scene%d' % iscene)
+        os.makedirs (scene_dir)
+        xml_dir = os.path.dirname (xml_file)
+        for band in readBands (xml_file):
+            for f in (band[1], os.path.splitext (band[1])[0] + '.hdr'):
+                if os.path.isfile (os.path.join (xml_dir, f)):
+                    shutil.copy (os.path.join (xml_dir, f), scene_dir)
+        scene_xml = os.path.join (scene_dir, os.path.basename (xml_file))
+        shutil.copy (xml_file, scene_xml)
+
+        log = open (os.path.join (scene_dir, 'log.txt'), 'w')
+        for args in runs:
+            cmd = [exe, '--xml=%s' % scene_xml] + args
+            status = subprocess.call (cmd, cwd=scene_dir, stdout=log,
+                stderr=subprocess.STDOUT)
+            if status != 0:
+                log.close()
+                raise RuntimeError ('Error running %s; see %s' % (' '.join (cmd), os.path.join (scene_dir, 'log.txt')))
+        log.close()
+        xml_files.append (scene_xml)
+    return xml_files
+
+
+############################################################################
+# Description: readOutputBands reads the bands which were added to the XML
+# file by revised_cloud_mask.
+#
+# Inputs:
+#   xml_file - name of the XML file written by revised_cloud_mask
+#   in_names - names of the bands in the input XML file
+#
+# Returns:
+#   dictionary of (bytes, typecode, nlines, nsamps) tuples, keyed by the
+#   band name
+############################################################################
+def readOutputBands (xml_file, in_names):
+    xml_dir = os.path.dirname (xml_file)
+    bands = {}
+    for (name, file_name, data_type, nlines, nsamps) in readBands (xml_file):
+        if name in in_names:
+            continue
+        bfile = open (os.path.join (xml_dir, file_name), 'rb')
+        data = bfile.read()
+        bfile.close()
+        typecode = ESPA_TYPES[data_type]
+        if len(data) != nlines * nsamps * array.array (typecode).itemsize:
+            raise RuntimeError ('%s is %d bytes, which is not %d x %d %s pixels' % (file_name, len(data), nlines, nsamps, data_type))
+        bands[name] = (data, typecode, nlines, nsamps)
+    return bands
+
+
+############################################################################
+# Description: compareBytes compares two rasters pixel for pixel.  The raw
+# bytes are compared, so floats are compared bit for bit and any change to
+# an exact-match kernel is reported.
+#
+# Inputs:
+#   ref - bytes of the reference raster
+#   test - bytes of the raster under test
+#   typecode - array typecode of the pixels
+#   nlines - number of lines in the rasters
+#   nsamps - number of samples in the rasters
+#
+# Returns:
+#   None if the rasters match, otherwise a message describing the
+#   differences
+#
+# Notes:
+#   1. Whole lines are compared first, and only the lines which differ are
+#      compared pixel by pixel.
+############################################################################
+def compareBytes (ref, test, typecode, nlines, nsamps):
+    if len(ref) != len(test):
+        return '%d bytes vs %d bytes' % (len(ref), len(test))
+    if ref == test:
+        return None
+
+    size = array.array (typecode).itemsize
+    line_size = nsamps * size
+    ndiff = 0
+    maxdiff = 0.0
+    first = None
+    for line in range(nlines):
+        ref_line = ref[line * line_size:(line + 1) * line_size]
+        test_line = test[line * line_size:(line + 1) * line_size]
+        if ref_line == test_line:
+            continue
+        ref_pix = array.array (typecode, ref_line)
+        test_pix = array.array (typecode, test_line)
+        for samp in range(nsamps):
+            if ref_line[samp * size:(samp + 1) * size] == \
+                test_line[samp * size:(samp + 1) * size]:
+                continue
+            ndiff += 1
+            maxdiff = max (maxdiff, abs (float (ref_pix[samp]) -
+                float (test_pix[samp])))
+            if first == None:
+                first = (line, samp, ref_pix[samp], test_pix[samp])
+
+    return '%d of %d pixels differ, max abs diff %g, first at line %d sample %d (%s vs %s)' % ((ndiff, nlines * nsamps, maxdiff) + first)
+
+
+def main ():
+    parser = OptionParser (usage='%prog --fixtures=FILE --exe=FILE (--ref_rev=REV | --ref_exe=FILE) [--variant=ARGS ...]')
+    parser.add_option ('--fixtures', type='string', dest='fixtures',
+        help='list of the XML files of the fixture scenes', metavar='FILE')
+    parser.add_option ('--exe', type='string', dest='exe',
+        help='revised_cloud_mask under test', metavar='FILE')
+    parser.add_option ('--ref_exe', type='string', dest='ref_exe',
+        help='reference revised_cloud_mask', metavar='FILE')
+    parser.add_option ('--ref_rev', type='string', dest='ref_rev',
+        help='git revision to build the reference revised_cloud_mask from',
+        metavar='REV')
+    parser.add_option ('--ref_make_args', type='string',
+        dest='ref_make_args', default='',
+        help='variable assignments for make when building the reference from ref_rev, such as the include and library directories it needs')
+    parser.add_option ('--ref_args', type='string', dest='ref_args',
+        default='', help='additional arguments for the reference run')
+    parser.add_option ('--test_args', type='string', dest='test_args',
+        default='',
+        help='additional arguments for every run under test, such as --write_intermediate so the intermediate bands are compared')
+    parser.add_option ('--variant', type='string', dest='variants',
+        action='append',
+        help='additional arguments for a run under test; may be repeated.  Runs separated by ; are run one after the other on the same copy of the scene, and {work} is replaced with the work directory (default is one run with no additional arguments)')
+    parser.add_option ('--work_dir', type='string', dest='work_dir',
+        help='directory for the outputs, which is kept (default is a temporary directory, which is removed)', metavar='DIR')
+    (options, args) = parser.parse_args()
+
+    if not options.fixtures:
+        parser.error ('missing fixtures command-line argument')
+    if options.exe == None:
+        parser.error ('missing exe command-line argument')
+    if (options.ref_exe == None) == (options.ref_rev == None):
+        parser.error ('specify one of the ref_exe and ref_rev command-line arguments')
+    variants = options.variants
+    if variants == None:
+        variants = ['']
+
+    scenes = readFixtures (options.fixtures)
+    if options.work_dir:
+        work_dir = os.path.abspath (options.work_dir)
+        os.makedirs (work_dir)
+    else:
+        work_dir = tempfile.mkdtemp (prefix='regress_fsca_')
+
+    exe = os.path.abspath (options.exe)
+    if options.ref_exe:
+        ref_exe = os.path.abspath (options.ref_exe)
+    else:
+        ref_exe = buildReference (options.ref_rev, work_dir,
+            options.ref_make_args.split())
+
+    # run the reference and keep its bands in memory, since each variant is
+    # compared with them
+    print ('Running the reference on %d scenes' % len(scenes))
+    in_names = [set ([b[0] for b in readBands (f)]) for f in scenes]
+    ref_xml = runScenes (ref_exe, [options.ref_args.split()], scenes,
+        os.path.join (work_dir, 'ref'))
+    ref_bands = [readOutputBands (f, in_names[i])
+        for (i, f) in enumerate (ref_xml)]
+
+    nfailed = 0
+    for (ivar, variant) in enumerate (variants):
+        variant = variant.replace ('{work}', work_dir)
+        print ('Variant %d: %s %s %s' % (ivar, EXE, options.test_args,
+            variant))
+        runs = [options.test_args.split() + run.split()
+            for run in variant.split (';')]
+        test_xml = runScenes (exe, runs, scenes,
+            os.path.join (work_dir, 'variant%d' % ivar))
+        for (iscene, xml_file) in enumerate (test_xml):
+            test_bands = readOutputBands (xml_file, in_names[iscene])
+            for name in sorted (ref_bands[iscene].keys()):
+                if name not in test_bands:
+                    msg = 'missing'
+                else:
+                    (ref, typecode, nlines, nsamps) = \
+                        ref_bands[iscene][name]
+                    msg = compareBytes (ref, test_bands[name][0], typecode,
+                        nlines, nsamps)
+                if msg == None:
+                    print ('  scene %d %-10s identical' % (iscene, name))
+                else:
+                    print ('  scene %d %-10s DIFFERS: %s' % (iscene, name,
+                        msg))
+                    nfailed += 1
+            for name in sorted (test_bands.keys()):
+                if name not in ref_bands[iscene]:
+                    print ('  scene %d %-10s not in the reference' %
+                        (iscene, name))
+
+    if options.work_dir == None:
+        shutil.rmtree (work_dir)
+
+    if nfailed > 0:
+        print ('%d bands differ from the reference' % nfailed)
+        return 1
+    print ('All bands match the reference')
+    return 0
+
+if __name__ == "__main__":
+    sys.exit (main ())
@@ -0,0 +1,594 @@
+#include <getopt.h>
+#include "revised_cloud_mask.h"
+
+/* Default size of the synthetic scene, about the size of a Landsat scene */
+#define BENCH_NLINES 7000
+#define BENCH_NSAMPS 8000
+
+/* Default size of the blocks of pixels which share a surface class, so the
+   clouds, snow, and fill form patches like they do in a real scene */
+#define BENCH_BLOCK 32
+
+/* Fill and saturation values of the synthetic reflectance bands, which match
+   the LEDAPS TOA reflectance product */
+#define BENCH_REFL_FILL -9999
+#define BENCH_REFL_SATU 20000
+
+/* Kernels which are benchmarked */
+typedef enum {BK_MAKE_INDEX=0, BK_INDEX_INT16, BK_CLOUD_SPANS,
+    BK_VARIANCE_SPANS, BK_VARIANCE_FULL, BK_RULES, BK_MORPH_BUFFER, BK_NUM}
+    Bench_kernel_t;
+
+/* Names of the kernels, as used in the report and the baseline files */
+static char *bench_names[BK_NUM] = {"make_index", "spectral_index_int16",
+    "build_cloud_spans", "variance_strip_spans", "variance_strip_full",
+    "rule_based_model", "morph_buffer_mask"};
+
+/* Approximate number of bytes read and written for each pixel by each
+   kernel, used for the GB/s rates.  The variances and rules only touch the
+   cloud pixels, but the rates are per scene pixel. */
+static double bench_bytes[BK_NUM] = {16.0, 12.0, 1.0, 52.0, 52.0, 51.0,
+    4.0};
+
+/* Surface classes of the synthetic pixels and the cfmask value for each */
+typedef enum {BC_CLEAR=0, BC_CLOUD, BC_SNOW, BC_FILL} Bench_class_t;
+static uint8 bench_cfmask[BC_FILL+1] = {0, CFMASK_CLOUD, 3, 255};
+
+/* Typical values of bands 1-5 and 7 (TOA reflectance * 10000) for each of
+   the surface classes */
+static int bench_values[BC_FILL][NBAND_REFL_MAX] = {
+    {800, 900, 1000, 2500, 2000, 1200},    /* clear vegetation/soil */
+    {4500, 4300, 4200, 4500, 2500, 1800},  /* cloud */
+    {7000, 6800, 6500, 6000, 600, 400}};   /* snow, which cfmask often
+                                              flags as cloud */
+
+/******************************************************************************
+MODULE:  bench_rand (static)
+
+PURPOSE:  Returns a pseudo-random number for the position and seed, so the
+synthetic scene is the same each time it's generated.
+
+RETURN VALUE:
+Type = unsigned int
+Value      Description
+-----      -----------
+n          Pseudo-random number
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+******************************************************************************/
+static unsigned int bench_rand
+(
+    unsigned int seed,    /* I: seed for the scene */
+    unsigned int x,       /* I: first coordinate */
+    unsigned int y        /* I: second coordinate */
+)
+{
+    unsigned int h;       /* hashed value */
+
+    h = seed ^ (x * 0x9E3779B1u) ^ (y * 0x85EBCA77u);
+    h ^= h >> 15;
+    h *= 0x2C1B3C6Du;
+    h ^= h >> 12;
+    h *= 0x297A2D39u;
+    h ^= h >> 15;
+    return (h);
+}
+
+
+/******************************************************************************
+MODULE:  make_bench_strip (static)
+
+PURPOSE:  Generates the synthetic reflectance bands and cfmask for a strip of
+the scene.
+
+RETURN VALUE:
+Type = None
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. The surface class is picked for each block of block x block pixels
+     using the cloud, snow, and fill fractions, and noise is added to each
+     pixel.  Half of the snow blocks are flagged as cloud in the cfmask, as
+     the cfmask does for many snow pixels.
+  2. The reflectance bands are generated for strip_nlines lines starting at
+     strip_start, and the cfmask for nlines lines starting at line.
+******************************************************************************/
+static void make_bench_strip
+(
+    int strip_start,      /* I: first line of the reflectance strip */
+    int strip_nlines,     /* I: number of lines in the reflectance strip */
+    int line,             /* I: first line of the cfmask strip */
+    int nlines,           /* I: number of lines in the cfmask strip */
+    int nsamps,           /* I: number of samples in each line */
+    int block,            /* I: size of the surface class blocks */
+    float cloud_frac,     /* I: fraction of cloud pixels */
+    float snow_frac,      /* I: fraction of snow pixels */
+    float fill_frac,      /* I: fraction of fill pixels */
+    unsigned int seed,    /* I: seed for the scene */
+    int16 **bands,        /* O: bands 1-5 and 7 */
+    uint8 *cfmask         /* O: cfmask */
+)
+{
+    int iline;            /* line in the scene */
+    int samp;             /* current sample */
+    int ib;               /* looping variable for the bands */
+    long pix;             /* current pixel in the strip */
+    unsigned int h;       /* random value for the current block */
+    float r;              /* random value between 0 and 1 */
+    Bench_class_t class;  /* surface class of the current block */
+
+    for (iline = strip_start; iline < strip_start + strip_nlines; iline++)
+    {
+        for (samp = 0; samp < nsamps; samp++)
+        {
+            pix = (long) (iline - strip_start) * nsamps + samp;
+            h = bench_rand (seed, samp / block, iline / block);
+            r = (h & 0xffff) / 65536.0;
+            if (r < fill_frac)
+                class = BC_FILL;
+            else if (r < fill_frac + cloud_frac)
+                class = BC_CLOUD;
+            else if (r < fill_frac + cloud_frac + snow_frac)
+                class = BC_SNOW;
+            else
+                class = BC_CLEAR;
+
+            for (ib = 0; ib < NBAND_REFL_MAX; ib++)
+            {
+                if (class == BC_FILL)
+                    bands[ib][pix] = BENCH_REFL_FILL;
+                else
+                    bands[ib][pix] = bench_values[class][ib] +
+                        (int) (bench_rand (seed + ib + 1, samp, iline) % 401)
+                        - 200;
+            }
+
+            if (iline >= line && iline < line + nlines)
+            {
+                if (class == BC_SNOW && (h & 0x10000))
+                    class = BC_CLOUD;
+                cfmask[(long) (iline - line) * nsamps + samp] =
+                    bench_cfmask[class];
+            }
+        }
+    }
+}
+
+
+/******************************************************************************
+MODULE:  read_bench_baseline (static)
+
+PURPOSE:  Reads the ns/pixel of each kernel from a baseline file written by
+--save_baseline.
+
+RETURN VALUE:
+Type = int
+Value      Description
+-----      -----------
+ERROR      The baseline file couldn't be opened
+SUCCESS    Successful completion
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. Kernels which aren't in the baseline file are left at 0.
+******************************************************************************/
+static int read_bench_baseline
+(
+    char *baseline_file,  /* I: name of the baseline file */
+    double *base_ns       /* O: baseline ns/pixel for each kernel */
+)
+{
+    char line[STR_SIZE];  /* current line of the baseline file */
+    char name[STR_SIZE];  /* kernel name on the current line */
+    double ns;            /* ns/pixel on the current line */
+    int ik;               /* looping variable for the kernels */
+    FILE *fptr = NULL;    /* baseline file pointer */
+
+    for (ik = 0; ik < BK_NUM; ik++)
+        base_ns[ik] = 0.0;
+
+    fptr = fopen (baseline_file, "r");
+    if (fptr == NULL)
+        return (ERROR);
+
+    while (fgets (line, sizeof (line), fptr) != NULL)
+    {
+        if (line[0] == '#' ||
+            sscanf (line, "%1023s %lf", name, &ns) != 2)
+            continue;
+        for (ik = 0; ik < BK_NUM; ik++)
+            if (!strcmp (name, bench_names[ik]))
+                base_ns[ik] = ns;
+    }
+
+    fclose (fptr);
+    return (SUCCESS);
+}
+
+
+/******************************************************************************
+MODULE:  main
+
+PURPOSE:  Benchmarks the revised_cloud_mask pixel kernels on a synthetic
+scene and reports the ns/pixel and GB/s of each kernel.
+
+RETURN VALUE:
+Type = int
+Value      Description
+-----      -----------
+ERROR      An error occurred during the benchmark
+SUCCESS    Successful completion
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. The scene is processed one PROC_NLINES strip at a time with the
+     variance halo, the same as in revised_cloud_mask, and each kernel is
+     timed on its own over all the strips.  The erosion, dilation, and
+     buffering are timed on the two whole-scene revised cloud masks.
+  2. spectral_index_int16 computes the same NDVI and NDSI as make_index, as
+     fixed-point values, to compare against the float indices.
+  3. variance_strip_spans is the default run, which only computes the
+     variances for the cfmask cloud pixels, and variance_strip_full is the
+     --write_intermediate run, which computes them for every pixel.
+  4. With --save_baseline the results are written to the baseline file, and
+     with --baseline the results are compared against a baseline file
+     written earlier.  "make bench" and "make bench_baseline" use
+     bench_baseline.txt.
+******************************************************************************/
+int main (int argc, char *argv[])
+{
+    char FUNC_NAME[] = "main";  /* function name */
+    char errmsg[STR_SIZE];    /* error message */
+    char *baseline_file = NULL;  /* baseline file to compare against */
+    char *save_file = NULL;   /* baseline file to be written */
+    int nlines = BENCH_NLINES;  /* number of lines in the scene */
+    int nsamps = BENCH_NSAMPS;  /* number of samples in the scene */
+    int block = BENCH_BLOCK;  /* size of the surface class blocks */
+    float cloud_frac = 0.3;   /* fraction of cloud pixels */
+    float snow_frac = 0.2;    /* fraction of snow pixels */
+    float fill_frac = 0.1;    /* fraction of fill pixels */
+    unsigned int seed = 1;    /* seed for the scene */
+    int c;                    /* current option */
+    int option_index;         /* index of the current option */
+    int ib;                   /* looping variable for the bands */
+    int ik;                   /* looping variable for the kernels */
+    int line;                 /* first line of the current strip */
+    int nlines_proc;          /* number of lines in the current strip */
+    int strip_start;          /* first line read for the current strip,
+                                 including the variance halo */
+    int strip_nlines;         /* number of lines read for the current strip,
+                                 including the variance halo */
+    int halo_top;             /* number of halo lines above the strip */
+    long pix;                 /* first pixel of the strip within the halo */
+    long strip_npix;          /* number of pixels in a strip with the halo */
+    double bench_sec[BK_NUM]; /* time spent in each kernel */
+    double base_ns[BK_NUM];   /* baseline ns/pixel for each kernel */
+    double t0;                /* start time of the current kernel */
+    double ns;                /* ns/pixel for the current kernel */
+    long ncloud_pix = 0;      /* number of cfmask cloud pixels */
+    bool have_baseline = false;  /* was the baseline file read */
+    int16 *bands[NBAND_REFL_MAX];  /* bands 1-5 and 7 */
+    int16 *strip_refl[NBAND_REFL_MAX];  /* bands without the halo */
+    uint8 *cfmask = NULL;     /* cfmask for the strip */
+    float *ndvi = NULL;       /* NDVI for the strip with the halo */
+    float *ndsi = NULL;       /* NDSI for the strip with the halo */
+    int16 *fixed_indx = NULL; /* fixed-point NDVI and NDSI for the strip
+                                 with the halo */
+    float *var_indices[2];    /* NDVI and NDSI for the variances */
+    float *var_strip[NUM_VARIANCE];  /* variance strips */
+    uint8 *rev_cm = NULL;     /* revised cloud mask, whole scene */
+    uint8 *rev_lim_cm = NULL; /* limited revised cloud mask, whole scene */
+    Span_index_t cloud_spans; /* index of the cloud pixels in the strip */
+    Rule_model_t conserv_model;  /* conservative rule-based model */
+    Rule_model_t lim_model;   /* limited rule-based model */
+    FILE *fptr = NULL;        /* baseline file pointer for the results */
+    static struct option long_options[] =
+    {
+        {"lines", required_argument, 0, 'l'},
+        {"samples", required_argument, 0, 's'},
+        {"block", required_argument, 0, 'b'},
+        {"cloud_frac", required_argument, 0, 'c'},
+        {"snow_frac", required_argument, 0, 'n'},
+        {"fill_frac", required_argument, 0, 'f'},
+        {"seed", required_argument, 0, 'r'},
+        {"baseline", required_argument, 0, 'B'},
+        {"save_baseline", required_argument, 0, 'S'},
+        {"help", no_argument, 0, 'h'},
+        {0, 0, 0, 0}
+    };
+
+    /* Read the command-line arguments */
+    opterr = 0;
+    while ((c = getopt_long (argc, argv, "", long_options, &option_index))
+        != -1)
+    {
+        switch (c)
+        {
+            case 'l':
+                nlines = atoi (optarg);
+                break;
+            case 's':
+                nsamps = atoi (optarg);
+                break;
+            case 'b':
+                block = atoi (optarg);
+                break;
+            case 'c':
+                cloud_frac = atof (optarg);
+                break;
+            case 'n':
+                snow_frac = atof (optarg);
+                break;
+            case 'f':
+                fill_frac = atof (optarg);
+                break;
+            case 'r':
+                seed = (unsigned int) atol (optarg);
+                break;
+            case 'B':
+                baseline_file = optarg;
+                break;
+            case 'S':
+                save_file = optarg;
+                break;
+            case 'h':
+            default:
+                printf ("usage: bench_kernels [--lines=nlines] "
+                    "[--samples=nsamps] [--block=pixels] "
+                    "[--cloud_frac=fraction] [--snow_frac=fraction] "
+                    "[--fill_frac=fraction] [--seed=seed] "
+                    "[--baseline=file] [--save_baseline=file]\n");
+                exit (c == 'h' ? SUCCESS : ERROR);
+        }
+    }
+
+    if (nlines < 1 || nsamps < 1 || block < 1 || cloud_frac < 0.0 ||
+        snow_frac < 0.0 || fill_frac < 0.0 ||
+        cloud_frac + snow_frac + fill_frac > 1.0)
+    {
+        sprintf (errmsg, "Invalid scene size, block size, or class "
+            "fractions");
+        error_handler (true, FUNC_NAME, errmsg);
+        exit (ERROR);
+    }
+
+    /* Load the built-in rule-based models */
+    init_rule_model (&conserv_model);
+    init_rule_model (&lim_model);
+    if (get_builtin_rules (true, &conserv_model) != SUCCESS ||
+        get_builtin_rules (false, &lim_model) != SUCCESS)
+    {
+        sprintf (errmsg, "Loading the built-in rule-based models.");
+        error_handler (true, FUNC_NAME, errmsg);
+        exit (ERROR);
+    }
+
+    /* Allocate the strip buffers, which hold PROC_NLINES plus the variance
+       halo, and the whole-scene revised cloud masks */
+    strip_npix = (long) (PROC_NLINES + 2*PROC_HALO) * nsamps;
+    for (ib = 0; ib < NBAND_REFL_MAX; ib++)
+        bands[ib] = calloc (strip_npix, sizeof (int16));
+    cfmask = calloc ((long) PROC_NLINES * nsamps, sizeof (uint8));
+    ndvi = calloc (strip_npix, sizeof (float));
+    ndsi = calloc (strip_npix, sizeof (float));
+    fixed_indx = calloc (2 * strip_npix, sizeof (int16));
+    var_strip[0] = calloc ((long) NUM_VARIANCE * PROC_NLINES * nsamps,
+        sizeof (float));
+    rev_cm = calloc ((long) nlines * nsamps, sizeof (uint8));
+    rev_lim_cm = calloc ((long) nlines * nsamps, sizeof (uint8));
+    for (ib = 0; ib < NBAND_REFL_MAX; ib++)
+        if (bands[ib] == NULL)
+            cfmask = NULL;
+    if (cfmask == NULL || ndvi == NULL || ndsi == NULL ||
+        fixed_indx == NULL || var_strip[0] == NULL || rev_cm == NULL ||
+        rev_lim_cm == NULL)
+    {
+        sprintf (errmsg, "Error allocating memory for the strip buffers");
+        error_handler (true, FUNC_NAME, errmsg);
+        exit (ERROR);
+    }
+    for (ib = 1; ib < NUM_VARIANCE; ib++)
+        var_strip[ib] = var_strip[ib-1] + (long) PROC_NLINES * nsamps;
+    var_indices[0] = ndvi;
+    var_indices[1] = ndsi;
+    init_cloud_spans (&cloud_spans);
+
+    printf ("Benchmarking the revised_cloud_mask kernels on a %d x %d scene "
+        "(cloud %.2f, snow %.2f, fill %.2f, %d pixel blocks)\n", nlines,
+        nsamps, cloud_frac, snow_frac, fill_frac, block);
+
+    /* Run the kernels one strip at a time, timing each of them */
+    for (ik = 0; ik < BK_NUM; ik++)
+        bench_sec[ik] = 0.0;
+    nlines_proc = PROC_NLINES;
+    for (line = 0; line < nlines; line += PROC_NLINES)
+    {
+        if (line + nlines_proc >= nlines)
+            nlines_proc = nlines - line;
+        halo_top = (line < PROC_HALO) ? line : PROC_HALO;
+        strip_start = line - halo_top;
+        strip_nlines = halo_top + nlines_proc + PROC_HALO;
+        if (strip_start + strip_nlines > nlines)
+            strip_nlines = nlines - strip_start;
+        make_bench_strip (strip_start, strip_nlines, line, nlines_proc,
+            nsamps, block, cloud_frac, snow_frac, fill_frac, seed, bands,
+            cfmask);
+
+        t0 = profile_clock ();
+        make_index (bands[3] /*b4*/, bands[2] /*b3*/, BENCH_REFL_FILL,
+            BENCH_REFL_SATU, strip_nlines, nsamps, NULL, ndvi);
+        make_index (bands[1] /*b2*/, bands[4] /*b5*/, BENCH_REFL_FILL,
+            BENCH_REFL_SATU, strip_nlines, nsamps, NULL, ndsi);
+        bench_sec[BK_MAKE_INDEX] += profile_clock () - t0;
+
+        t0 = profile_clock ();
+        spectral_index_int16 (bands[3] /*b4*/, bands[2] /*b3*/,
+            BENCH_REFL_FILL, strip_nlines * nsamps, FILL_VALUE, fixed_indx);
+        spectral_index_int16 (bands[1] /*b2*/, bands[4] /*b5*/,
+            BENCH_REFL_FILL, strip_nlines * nsamps, FILL_VALUE,
+            &fixed_indx[strip_npix]);
+        bench_sec[BK_INDEX_INT16] += profile_clock () - t0;
+
+        t0 = profile_clock ();
+        if (build_cloud_spans (cfmask, nlines_proc, nsamps, &cloud_spans)
+            != SUCCESS)
+        {
+            sprintf (errmsg, "Error indexing the cloud pixels for line %d",
+                line);
+            error_handler (true, FUNC_NAME, errmsg);
+            exit (ERROR);
+        }
+        bench_sec[BK_CLOUD_SPANS] += profile_clock () - t0;
+        ncloud_pix += cloud_spans.npix;
+
+        t0 = profile_clock ();
+        if (variance_strip (bands, NBAND_REFL_MAX, var_indices, 2,
+            BENCH_REFL_FILL, VARIANCE_WINDOW, strip_nlines, nsamps, halo_top,
+            nlines_proc, NULL, var_strip) != SUCCESS)
+        {
+            sprintf (errmsg, "Error computing variances for line %d", line);
+            error_handler (true, FUNC_NAME, errmsg);
+            exit (ERROR);
+        }
+        bench_sec[BK_VARIANCE_FULL] += profile_clock () - t0;
+
+        /* The spans run is last so the variances of the cloud pixels are
+           what the rules see, as in revised_cloud_mask */
+        t0 = profile_clock ();
+        if (variance_strip (bands, NBAND_REFL_MAX, var_indices, 2,
+            BENCH_REFL_FILL, VARIANCE_WINDOW, strip_nlines, nsamps, halo_top,
+            nlines_proc, &cloud_spans, var_strip) != SUCCESS)
+        {
+            sprintf (errmsg, "Error computing variances for line %d", line);
+            error_handler (true, FUNC_NAME, errmsg);
+            exit (ERROR);
+        }
+        bench_sec[BK_VARIANCE_SPANS] += profile_clock () - t0;
+
+        t0 = profile_clock ();
+        pix = (long) halo_top * nsamps;
+        for (ib = 0; ib < NBAND_REFL_MAX; ib++)
+            strip_refl[ib] = &bands[ib][pix];
+        rule_based_model (&conserv_model, &lim_model, strip_refl, cfmask,
+            &ndsi[pix], &ndvi[pix],
+            var_strip[VARIANCE_B1-VARIANCE_B1],
+            var_strip[VARIANCE_B2-VARIANCE_B1],
+            var_strip[VARIANCE_B4-VARIANCE_B1],
+            var_strip[VARIANCE_B5-VARIANCE_B1],
+            var_strip[VARIANCE_B7-VARIANCE_B1],
+            var_strip[VARIANCE_NDVI-VARIANCE_B1],
+            var_strip[VARIANCE_NDSI-VARIANCE_B1],
+            nlines_proc * nsamps, &rev_cm[(long) line * nsamps],
+            &rev_lim_cm[(long) line * nsamps]);
+        bench_sec[BK_RULES] += profile_clock () - t0;
+    }  /* end for line */
+
+    /* Filter and buffer the whole-scene revised cloud masks, with the same
+       settings as revised_cloud_mask */
+    t0 = profile_clock ();
+    if (morph_buffer_mask (rev_cm, nlines, nsamps, 5, 1, 6) != SUCCESS ||
+        morph_buffer_mask (rev_lim_cm, nlines, nsamps, 5, 2, 6) != SUCCESS)
+    {
+        sprintf (errmsg, "Filtering and buffering the revised cloud masks");
+        error_handler (true, FUNC_NAME, errmsg);
+        exit (ERROR);
+    }
+    bench_sec[BK_MORPH_BUFFER] += profile_clock () - t0;
+
+    /* Report the rates, compared against the baseline if there is one */
+    if (baseline_file != NULL)
+    {
+        if (read_bench_baseline (baseline_file, base_ns) == SUCCESS)
+            have_baseline = true;
+        else
+        {
+            sprintf (errmsg, "Unable to read the baseline file %s; run "
+                "with --save_baseline to create it", baseline_file);
+            error_handler (false, FUNC_NAME, errmsg);
+        }
+    }
+
+    if (save_file != NULL)
+    {
+        fptr = fopen (save_file, "w");
+        if (fptr == NULL)
+        {
+            sprintf (errmsg, "Error opening the baseline file %s",
+                save_file);
+            error_handler (true, FUNC_NAME, errmsg);
+            exit (ERROR);
+        }
+        fprintf (fptr, "# kernel ns_per_pixel gb_per_sec (%d x %d, cloud "
+            "%.2f, snow %.2f, fill %.2f)\n", nlines, nsamps, cloud_frac,
+            snow_frac, fill_frac);
+    }
+
+    printf ("  cfmask cloud pixels: %ld (%.1f%%)\n", ncloud_pix,
+        100.0 * ncloud_pix / ((double) nlines * nsamps));
+    printf ("%-30s %12s %10s%s\n", "kernel", "ns/pixel", "GB/s",
+        have_baseline ? "   speedup" : "");
+    for (ik = 0; ik < BK_NUM; ik++)
+    {
+        ns = bench_sec[ik] * 1.0e9 / ((double) nlines * nsamps);
+        printf ("%-30s %12.3f %10.3f", bench_names[ik], ns,
+            (ns > 0.0) ? bench_bytes[ik] / ns : 0.0);
+        if (have_baseline && base_ns[ik] > 0.0 && ns > 0.0)
+            printf (" %9.2fx", base_ns[ik] / ns);
+        printf ("\n");
+        if (fptr != NULL)
+            fprintf (fptr, "%s %.3f %.3f\n", bench_names[ik], ns,
+                (ns > 0.0) ? bench_bytes[ik] / ns : 0.0);
+    }
+
+    if (fptr != NULL && fclose (fptr) != 0)
+    {
+        sprintf (errmsg, "Error writing the baseline file %s", save_file);
+        error_handler (true, FUNC_NAME, errmsg);
+        exit (ERROR);
+    }
+
+    /* Free the buffers and models */
+    for (ib = 0; ib < NBAND_REFL_MAX; ib++)
+        free (bands[ib]);
+    free (cfmask);
+    free (ndvi);
+    free (ndsi);
+    free (fixed_indx);
+    free (var_strip[0]);
+    free (rev_cm);
+    free (rev_lim_cm);
+    free_cloud_spans (&cloud_spans);
+    free_rule_model (&conserv_model);
+    free_rule_model (&lim_model);
+
+    exit (SUCCESS);
+}
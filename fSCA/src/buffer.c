@@ -2,7 +2,7 @@
 #include "revised_cloud_mask.h"
 
 /******************************************************************************
-MODULE:  buffer
+MODULE:  buffer_scan (static)
 
 PURPOSE:  Buffers the non-zero pixels by the specified distance.  Thus any
 pixel which is distance pixels away from the nearest non-zero pixel is marked
@@ -23,11 +23,15 @@ HISTORY:
 Date          Programmer       Reason
 ---------     ---------------  -------------------------------------
 6/4/2014      Gail Schmidt     Original Development
+10/14/2026    agent            Renamed from buffer; only used for masks with
+                               more than one non-zero value
 
 NOTES:
   1. Input and output arrays are 1D arrays of size nlines * nsamps.
+  2. Where the buffers of pixels with different values overlap, the last of
+     those pixels (in line/sample order) sets the value.
 ******************************************************************************/
-short buffer
+static short buffer_scan
 (
     uint8 *array,       /* I: input array of data for which to buffer by the
                               distance value */
@@ -37,7 +41,7 @@ short buffer
     uint8 *buff_array   /* O: output array with buffer applied */
 )
 {
-    char FUNC_NAME[] = "buffer";   /* function name */
+    char FUNC_NAME[] = "buffer_scan";   /* function name */
     char errmsg[STR_SIZE];    /* error message */
     int line;           /* current line being processed */
     int samp;           /* current sample being processed */
@@ -159,3 +163,343 @@ short buffer
     /* Successful completion of the buffer */
     return (SUCCESS);
 }
+
+
+/******************************************************************************
+MODULE:  buffer_dist_line
+
+PURPOSE:  Runs the first (forward) pass of the city-block distance transform
+for one line of a mask.
+
+RETURN VALUE:
+Type = None
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+---------     ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. Non-zero pixels are at distance zero, and the other pixels are one more
+     than the nearest of the pixels above and to the left.
+  2. The distances are capped at distance+1, which doesn't change which
+     pixels are within the buffer and keeps them in a uint8.
+  3. The output line may be the same as the input line.
+******************************************************************************/
+void buffer_dist_line
+(
+    uint8 *in_line,     /* I: current line of the mask */
+    uint8 *prev_dist,   /* I: distances for the previous line; NULL for the
+                              first line */
+    int nsamps,         /* I: number of samples in the line */
+    int distance,       /* I: distance to buffer */
+    uint8 *dist_line    /* O: distances for the current line */
+)
+{
+    int samp;           /* current sample being processed */
+    int dist;           /* distance to the nearest non-zero pixel */
+    int cap = distance + 1;  /* cap on the stored distances */
+
+    dist = cap;
+    for (samp = 0; samp < nsamps; samp++)
+    {
+        if (in_line[samp] != 0)
+            dist = 0;
+        else
+        {
+            dist++;
+            if (prev_dist != NULL && prev_dist[samp] + 1 < dist)
+                dist = prev_dist[samp] + 1;
+            if (dist > cap)
+                dist = cap;
+        }
+        dist_line[samp] = dist;
+    }
+}
+
+
+/******************************************************************************
+MODULE:  buffer_mark_line
+
+PURPOSE:  Runs the second (backward) pass of the city-block distance transform
+for one line of a mask, and marks the pixels within the buffer distance.
+
+RETURN VALUE:
+Type = None
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+---------     ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. The lines must be processed from the last line to the first.  The
+     distances for the line below should be initialized to distance+1 for
+     the last line.
+  2. Each pixel takes the nearest of its first-pass distance and the pixels
+     below and to the right.
+******************************************************************************/
+void buffer_mark_line
+(
+    uint8 *line_buf,    /* I/O: first-pass distances for the current line on
+                                input; buffered mask values on output */
+    uint8 *below,       /* I/O: distances for the line below on input; the
+                                distances for the current line on output */
+    int nsamps,         /* I: number of samples in the line */
+    int distance,       /* I: distance to buffer */
+    uint8 value         /* I: value for the buffered pixels */
+)
+{
+    int samp;           /* current sample being processed */
+    int dist;           /* distance to the nearest non-zero pixel */
+    int cap = distance + 1;  /* cap on the stored distances */
+
+    dist = cap;
+    for (samp = nsamps - 1; samp >= 0; samp--)
+    {
+        dist++;
+        if (below[samp] + 1 < dist)
+            dist = below[samp] + 1;
+        if (line_buf[samp] < dist)
+            dist = line_buf[samp];
+        if (dist > cap)
+            dist = cap;
+        below[samp] = dist;
+        line_buf[samp] = (dist <= distance) ? value : 0;
+    }
+}
+
+
+/******************************************************************************
+MODULE:  buffer_masks
+
+PURPOSE:  Buffers the non-zero pixels of one or more masks by the specified
+distance.  Thus any pixel which is distance pixels away from the nearest
+non-zero pixel is marked with the same value as the non-zero pixel.  The
+distance is calculated at right angles and not diagonally.
+
+RETURN VALUE:
+Type = short
+Value          Description
+-----          -----------
+ERROR          Error occurred buffering the arrays
+SUCCESS        Successful completion
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+---------     ---------------  -------------------------------------
+10/14/2026    agent            Original Development, replacing the filter
+                               scan in buffer
+
+NOTES:
+  1. Input and output arrays are 1D arrays of size nlines * nsamps.  The
+     output array for a mask may be the same as the input array, in which
+     case the mask is buffered in place.
+  2. The distance is the city-block (L1) distance, so the buffer is the same
+     diamond as the filter used by buffer_scan.  A two-pass city-block
+     distance transform gives the distance from each pixel to the nearest
+     non-zero pixel, and the pixels within the buffer distance are marked.
+     This is O(nlines * nsamps) no matter how many non-zero pixels there
+     are, where the filter scan touches (2*distance+1)^2 pixels for each
+     non-zero pixel.
+  3. The first pass (buffer_dist_line) runs down the lines and from left to
+     right, and the second pass (buffer_mark_line) runs up the lines and from
+     right to left, keeping the distances for the previous line.  The
+     distances are stored in the output array during the first pass.
+  4. The revised cloud masks have a single non-zero value, so this gives the
+     same result as the filter scan.  A mask with more than one non-zero
+     value is passed to buffer_scan, so overlapping buffers are still set
+     the same way.
+  5. The masks are processed together, line by line, in one pass over the
+     lines.
+******************************************************************************/
+short buffer_masks
+(
+    uint8 **arrays,     /* I: array of pointers to the masks to be buffered */
+    int nmasks,         /* I: number of masks */
+    int distance,       /* I: distance to buffer */
+    int nlines,         /* I: number of lines in the data arrays */
+    int nsamps,         /* I: number of samples in the data arrays */
+    uint8 **buff_arrays /* O: array of pointers to the output masks with the
+                              buffer applied */
+)
+{
+    char FUNC_NAME[] = "buffer_masks";   /* function name */
+    char errmsg[STR_SIZE];    /* error message */
+    int line;           /* current line being processed */
+    int im;             /* looping variable for the masks */
+    int nscan = 0;      /* number of masks buffered via buffer_scan */
+    long pix;           /* current pixel being processed */
+    long npix;          /* number of pixels in each mask */
+    bool *use_scan=NULL; /* should the mask be buffered via buffer_scan,
+                            since it has more than one non-zero value */
+    uint8 *value=NULL;  /* non-zero value of each mask (0 if none) */
+    uint8 *in=NULL;     /* current input mask */
+    uint8 *prev=NULL;   /* distances for the previous line of each mask in
+                           the second pass */
+    uint8 *copy=NULL;   /* copy of an input mask to be buffered in place via
+                           buffer_scan */
+
+    if (distance < 0 || distance > 254)
+    {
+        sprintf (errmsg, "Buffer distance %d is not supported; must be "
+            "between 0 and 254", distance);
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+    npix = (long) nlines * nsamps;
+
+    /* Allocate memory for the mask values and previous line distances */
+    use_scan = calloc (nmasks, sizeof (bool));
+    value = calloc (nmasks, sizeof (uint8));
+    prev = calloc ((long) nmasks * nsamps, sizeof (uint8));
+    if (use_scan == NULL || value == NULL || prev == NULL)
+    {
+        strcpy (errmsg, "Error allocating memory for buffering.");
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+
+    /* Find the non-zero value of each mask, and flag the masks with more
+       than one non-zero value */
+    for (im = 0; im < nmasks; im++)
+    {
+        in = arrays[im];
+        for (pix = 0; pix < npix; pix++)
+        {
+            if (in[pix] == 0)
+                continue;
+            if (value[im] == 0)
+                value[im] = in[pix];
+            else if (in[pix] != value[im])
+            {
+                use_scan[im] = true;
+                nscan++;
+                break;
+            }
+        }
+    }
+
+    /* First pass, down and to the right */
+    for (line = 0; line < nlines; line++)
+    {
+        for (im = 0; im < nmasks; im++)
+        {
+            if (use_scan[im])
+                continue;
+
+            pix = (long) line * nsamps;
+            buffer_dist_line (&arrays[im][pix], (line > 0) ?
+                &buff_arrays[im][pix-nsamps] : NULL, nsamps, distance,
+                &buff_arrays[im][pix]);
+        }
+    }
+
+    /* Second pass, up and to the left */
+    for (im = 0; im < nmasks; im++)
+        memset (&prev[(long) im * nsamps], distance + 1,
+            nsamps * sizeof (uint8));
+    for (line = nlines - 1; line >= 0; line--)
+    {
+        for (im = 0; im < nmasks; im++)
+        {
+            if (use_scan[im])
+                continue;
+
+            buffer_mark_line (&buff_arrays[im][(long) line * nsamps],
+                &prev[(long) im * nsamps], nsamps, distance, value[im]);
+        }
+    }
+
+    /* Buffer the masks with more than one value via the filter scan */
+    for (im = 0; im < nmasks && nscan > 0; im++)
+    {
+        if (!use_scan[im])
+            continue;
+
+        in = arrays[im];
+        if (in == buff_arrays[im])
+        {
+            /* The filter scan can't be done in place, so work from a copy of
+               the input mask */
+            copy = malloc (npix * sizeof (uint8));
+            if (copy == NULL)
+            {
+                strcpy (errmsg, "Error allocating memory for buffering.");
+                error_handler (true, FUNC_NAME, errmsg);
+                return (ERROR);
+            }
+            memcpy (copy, in, npix * sizeof (uint8));
+            in = copy;
+        }
+
+        if (buffer_scan (in, distance, nlines, nsamps, buff_arrays[im]) !=
+            SUCCESS)
+        {
+            sprintf (errmsg, "Error buffering mask %d", im);
+            error_handler (true, FUNC_NAME, errmsg);
+            return (ERROR);
+        }
+
+        free (copy);
+        copy = NULL;
+    }
+
+    /* Free the memory */
+    free (use_scan);
+    free (value);
+    free (prev);
+
+    /* Successful completion of the buffer */
+    return (SUCCESS);
+}
+
+
+/******************************************************************************
+MODULE:  buffer
+
+PURPOSE:  Buffers the non-zero pixels by the specified distance.  Thus any
+pixel which is distance pixels away from the nearest non-zero pixel is marked
+with the same value as the non-zero pixel.  The distance is calculated at right
+angles and not diagonally.
+
+RETURN VALUE:
+Type = short
+Value          Description
+-----          -----------
+ERROR          Error occurred buffering the array
+SUCCESS        Successful completion
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+---------     ---------------  -------------------------------------
+6/4/2014      Gail Schmidt     Original Development
+10/14/2026    agent            Use the distance transform in buffer_masks
+
+NOTES:
+  1. Input and output arrays are 1D arrays of size nlines * nsamps.
+******************************************************************************/
+short buffer
+(
+    uint8 *array,       /* I: input array of data for which to buffer by the
+                              distance value */
+    int distance,       /* I: distance to buffer */
+    int nlines,         /* I: number of lines in the data arrays */
+    int nsamps,         /* I: number of samples in the data arrays */
+    uint8 *buff_array   /* O: output array with buffer applied */
+)
+{
+    return (buffer_masks (&array, 1, distance, nlines, nsamps, &buff_array));
+}
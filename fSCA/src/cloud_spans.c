@@ -0,0 +1,186 @@
+#include "revised_cloud_mask.h"
+
+/******************************************************************************
+MODULE:  init_cloud_spans
+
+PURPOSE:  Initializes the span index so it holds no spans or memory.
+
+RETURN VALUE:
+Type = None
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+---------     ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+******************************************************************************/
+void init_cloud_spans
+(
+    Span_index_t *spans    /* O: span index to be initialized */
+)
+{
+    spans->nlines = 0;
+    spans->nspans = 0;
+    spans->npix = 0;
+    spans->max_lines = 0;
+    spans->max_spans = 0;
+    spans->line_span = NULL;
+    spans->span_start = NULL;
+    spans->span_end = NULL;
+}
+
+
+/******************************************************************************
+MODULE:  free_cloud_spans
+
+PURPOSE:  Frees the memory held by the span index.
+
+RETURN VALUE:
+Type = None
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+---------     ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+******************************************************************************/
+void free_cloud_spans
+(
+    Span_index_t *spans    /* I/O: span index to be freed */
+)
+{
+    free (spans->line_span);
+    free (spans->span_start);
+    free (spans->span_end);
+    init_cloud_spans (spans);
+}
+
+
+/******************************************************************************
+MODULE:  build_cloud_spans
+
+PURPOSE:  Builds the run-length index of the cfmask cloud pixels for a strip
+of lines.  Each span is a run of consecutive cloud pixels within a line.
+These are the only pixels the rule-based models revise, so the variances and
+models only need to be evaluated within the spans.
+
+RETURN VALUE:
+Type = int
+Value          Description
+-----          -----------
+ERROR          Error occurred building the index
+SUCCESS        Successful completion
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+---------     ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. The cfmask array is a 1D array of size nlines * nsamps.
+  2. The spans for line i are span_start/span_end[line_span[i]] through
+     [line_span[i+1]-1].  The sample ranges are inclusive.
+  3. The index memory is grown as needed and kept between calls, so the same
+     index can be reused for each strip.
+  4. The 9x9 neighborhoods of the span pixels are not stored; the variance
+     calculation reads them directly from the input strips.
+******************************************************************************/
+int build_cloud_spans
+(
+    uint8 *cfmask,         /* I: cfmask values for the strip */
+    int nlines,            /* I: number of lines in the strip */
+    int nsamps,            /* I: number of samples in the strip */
+    Span_index_t *spans    /* I/O: span index to be populated */
+)
+{
+    char FUNC_NAME[] = "build_cloud_spans";   /* function name */
+    char errmsg[STR_SIZE];    /* error message */
+    int line;           /* current line being processed */
+    int samp;           /* current sample being processed */
+    int start;          /* first sample of the current span */
+    int new_max;        /* new size of the span arrays */
+    int *tmp_ptr=NULL;  /* temporary pointer for reallocating */
+    uint8 *cm_line=NULL;  /* cfmask values for the current line */
+
+    /* Make sure there is room for the line offsets */
+    if (spans->max_lines < nlines + 1)
+    {
+        tmp_ptr = realloc (spans->line_span, (nlines + 1) * sizeof (int));
+        if (tmp_ptr == NULL)
+        {
+            strcpy (errmsg, "Error allocating memory for the span index "
+                "lines.");
+            error_handler (true, FUNC_NAME, errmsg);
+            return (ERROR);
+        }
+        spans->line_span = tmp_ptr;
+        spans->max_lines = nlines + 1;
+    }
+
+    spans->nlines = nlines;
+    spans->nspans = 0;
+    spans->npix = 0;
+    for (line = 0; line < nlines; line++)
+    {
+        spans->line_span[line] = spans->nspans;
+        cm_line = &cfmask[(long) line * nsamps];
+        samp = 0;
+        while (samp < nsamps)
+        {
+            /* Find the start of the next run of cloud pixels */
+            if (cm_line[samp] != CFMASK_CLOUD)
+            {
+                samp++;
+                continue;
+            }
+            start = samp;
+            while (samp < nsamps && cm_line[samp] == CFMASK_CLOUD)
+                samp++;
+
+            /* Grow the span arrays if needed */
+            if (spans->nspans == spans->max_spans)
+            {
+                new_max = (spans->max_spans == 0) ? nsamps :
+                    2 * spans->max_spans;
+                tmp_ptr = realloc (spans->span_start, new_max * sizeof (int));
+                if (tmp_ptr == NULL)
+                {
+                    strcpy (errmsg, "Error allocating memory for the span "
+                        "index.");
+                    error_handler (true, FUNC_NAME, errmsg);
+                    return (ERROR);
+                }
+                spans->span_start = tmp_ptr;
+                tmp_ptr = realloc (spans->span_end, new_max * sizeof (int));
+                if (tmp_ptr == NULL)
+                {
+                    strcpy (errmsg, "Error allocating memory for the span "
+                        "index.");
+                    error_handler (true, FUNC_NAME, errmsg);
+                    return (ERROR);
+                }
+                spans->span_end = tmp_ptr;
+                spans->max_spans = new_max;
+            }
+
+            spans->span_start[spans->nspans] = start;
+            spans->span_end[spans->nspans] = samp - 1;
+            spans->nspans++;
+            spans->npix += samp - start;
+        }
+    }
+    spans->line_span[nlines] = spans->nspans;
+
+    return (SUCCESS);
+}
@@ -10,10 +10,35 @@ typedef enum {CM_NDVI=0, CM_NDSI, VARIANCE_B1, VARIANCE_B2, VARIANCE_B3,
     VARIANCE_B4, VARIANCE_B5, VARIANCE_B7, VARIANCE_NDVI, VARIANCE_NDSI,
     REVISED_CM, REVISED_LIM_CM, NUM_CM} Mycm_list_t;
 
+/* Number of variance products, VARIANCE_B1 through VARIANCE_NDSI */
+#define NUM_VARIANCE (VARIANCE_NDSI - VARIANCE_B1 + 1)
+
 /* Application version */
 #define CLOUD_MASK_VERSION "1.0.0"
 
-/* How many lines of data should be processed at one time */
+/* How many lines of data should be processed at one time, unless the strip
+   height is picked from the memory budget (see --mem_budget_mb) */
 #define PROC_NLINES 1000
 
+/* Smallest strip height picked from the memory budget */
+#define MIN_PROC_NLINES 16
+
+/* Size of the window (window x window) used for the variance calculations */
+#define VARIANCE_WINDOW 9
+
+/* Number of extra lines read above and below each strip so the variance
+   windows for the lines in the strip are complete */
+#define PROC_HALO (VARIANCE_WINDOW / 2)
+
+/* Number of lines in each chunk of a strip handed to a thread.  The chunks
+   are a fixed size, so the results don't depend on the number of threads. */
+#define PROC_CHUNK_NLINES 32
+
+/* Number of lines and samples around a processing window which are also
+   processed, so the pixels at the edges of the window see the same
+   neighbors as for the whole scene.  This covers the variance window, the
+   erosion and dilation with the 5x5 element anchored at (1,1), which reach
+   3 pixels each, and the 6 pixel cloud buffer. */
+#define WINDOW_HALO (PROC_HALO + 3 + 3 + 6)
+
 #endif
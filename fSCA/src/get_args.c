@@ -22,35 +22,140 @@ HISTORY:
 Date          Programmer       Reason
 ----------    ---------------  -------------------------------------
 5/19/2014     Gail Schmidt     Original Development
+10/14/2026    agent            Added the --write_intermediate flag
+10/14/2026    agent            Added the --rules_file and --lim_rules_file
+                               options
+10/14/2026    agent            Added the --write_mode option
+10/14/2026    agent            Added the --scratch_dir and --plane_mem_mb
+                               options
+10/14/2026    agent            Added the --profile option
+10/14/2026    agent            Added the --window option
+10/14/2026    agent            Added the --mem_budget_mb option
+10/14/2026    agent            Added the --tiled_output flag
+10/14/2026    agent            Added the --mmap_input flag
+10/14/2026    agent            Added the --threads option
+10/14/2026    agent            Added the --shard option and the
+                               --shard_finalize flag
+10/14/2026    agent            Added the --outputs option
 
 NOTES:
   1. Memory is allocated for the input file.  This should be character a
      pointer set to NULL on input.  The caller is responsible for freeing the
      allocated memory upon successful return.
+  2. Memory is also allocated for the rules files and scratch directory, if
+     specified.  These should be set to NULL on input, and are left NULL if
+     not specified.
+  3. --profile takes an optional JSON filename.  Without one, the profile is
+     written to stdout and profile_file is left NULL.
+  4. --window=line0,samp0,nlines,nsamps processes only that window of the
+     scene.  It's checked against the scene size when the scene is opened.
+  5. The memory budget is left at 0 if not specified, which means the strips
+     are PROC_NLINES lines.  The budget also picks the plane memory, so it
+     can't be specified along with --plane_mem_mb.
+  6. The number of threads is left at 0 if not specified, which means the
+     OpenMP default is used.
+  7. --shard=index,count processes only shard index (0-based) of the count
+     bands of lines the scene is split into.  The shard count is left at 0
+     if not specified.  The shards are windows of the scene, so --shard
+     can't be specified along with --window, and the tiled files would
+     only cover one shard, so it can't be specified with --tiled_output.
+     --shard_finalize is run once after all of the shards, so it can't be
+     specified along with --shard, --window, or --tiled_output either.
+  8. --outputs=name[,name...] lists the bands to be output by their short
+     names, which are checked once the bands are set up.  Memory is
+     allocated for the list, if specified.  It replaces the bands picked by
+     --write_intermediate, so the two can't be specified together.
 ******************************************************************************/
 short get_args
 (
     int argc,             /* I: number of cmd-line args */
     char *argv[],         /* I: string of cmd-line args */
     char **xml_infile,    /* O: address of input XML file */
+    char **rules_file,    /* O: address of the C5.0 rules file for the
+                                conservative model (NULL if not specified) */
+    char **lim_rules_file, /* O: address of the C5.0 rules file for the
+                                 limited model (NULL if not specified) */
+    bool *write_intermediate, /* O: should the NDVI, NDSI, and variance
+                                    bands be written as output products */
+    Out_write_mode_t *write_mode, /* O: how the output bands are written */
+    char **scratch_dir,   /* O: address of the directory for the scratch
+                                files (NULL if not specified) */
+    long *plane_mem_mb,   /* O: megabytes of whole-scene planes to hold in
+                                memory before using scratch files */
+    bool *profile,        /* O: should the processing stages be profiled */
+    char **profile_file,  /* O: address of the profile JSON file (NULL for
+                                stdout or if not specified) */
+    Img_window_t *window, /* O: window of the scene to be processed; 0 lines
+                                for the whole scene */
+    long *mem_budget_mb,  /* O: megabytes of memory to size the strips and
+                                planes for; 0 for strips of PROC_NLINES
+                                lines */
+    bool *tiled_output,   /* O: should the bands also be written to tiled
+                                files */
+    bool *mmap_input,     /* O: should the reflectance bands be mapped
+                                rather than read */
+    int *nthreads,        /* O: number of threads for processing */
+    int *shard_index,     /* O: shard of the scene to be processed */
+    int *shard_count,     /* O: number of shards the scene is split into; 0
+                                if the scene isn't sharded */
+    bool *shard_finalize, /* O: should only the ENVI headers and XML file of
+                                a sharded scene be written */
+    char **outputs,       /* O: address of the comma-separated short names
+                                of the bands to be output (NULL for the
+                                default bands) */
     bool *verbose         /* O: verbose flag */
 )
 {
     int c;                           /* current argument index */
     int option_index;                /* index for the command-line option */
     static int verbose_flag=0;       /* verbose flag */
+    static int intermediate_flag=0;  /* write intermediate bands flag */
+    static int tiled_flag=0;         /* tiled output flag */
+    static int mmap_flag=0;          /* mapped input flag */
+    static int finalize_flag=0;      /* shard finalize flag */
+    bool plane_mem_set = false;      /* was --plane_mem_mb specified */
     char errmsg[STR_SIZE];           /* error message */
     char FUNC_NAME[] = "get_args";   /* function name */
     static struct option long_options[] =
     {
         {"verbose", no_argument, &verbose_flag, 1},
+        {"write_intermediate", no_argument, &intermediate_flag, 1},
+        {"tiled_output", no_argument, &tiled_flag, 1},
+        {"mmap_input", no_argument, &mmap_flag, 1},
+        {"shard_finalize", no_argument, &finalize_flag, 1},
         {"xml", required_argument, 0, 'i'},
+        {"rules_file", required_argument, 0, 'r'},
+        {"lim_rules_file", required_argument, 0, 'l'},
+        {"write_mode", required_argument, 0, 'w'},
+        {"scratch_dir", required_argument, 0, 's'},
+        {"plane_mem_mb", required_argument, 0, 'm'},
+        {"profile", optional_argument, 0, 'p'},
+        {"window", required_argument, 0, 'n'},
+        {"mem_budget_mb", required_argument, 0, 'g'},
+        {"threads", required_argument, 0, 't'},
+        {"shard", required_argument, 0, 'd'},
+        {"outputs", required_argument, 0, 'o'},
         {"help", no_argument, 0, 'h'},
         {0, 0, 0, 0}
     };
 
     /* Initialize the flags to false */
     *verbose = false;
+    *write_intermediate = false;
+    *tiled_output = false;
+    *mmap_input = false;
+    *write_mode = OUT_WRITE_CACHED;
+    *plane_mem_mb = 0;
+    *profile = false;
+    window->line0 = 0;
+    window->samp0 = 0;
+    window->nlines = 0;
+    window->nsamps = 0;
+    *mem_budget_mb = 0;
+    *nthreads = 0;
+    *shard_index = 0;
+    *shard_count = 0;
+    *shard_finalize = false;
 
     /* Loop through all the cmd-line options */
     opterr = 0;   /* turn off getopt_long error msgs as we'll print our own */
@@ -79,6 +184,111 @@ short get_args
             case 'i':  /* input file */
                 *xml_infile = strdup (optarg);
                 break;
+
+            case 'r':  /* rules file for the conservative model */
+                *rules_file = strdup (optarg);
+                break;
+
+            case 'l':  /* rules file for the limited model */
+                *lim_rules_file = strdup (optarg);
+                break;
+
+            case 'w':  /* how the output bands are written */
+                if (!strcmp (optarg, "cached"))
+                    *write_mode = OUT_WRITE_CACHED;
+                else if (!strcmp (optarg, "dontneed"))
+                    *write_mode = OUT_WRITE_DONTNEED;
+                else if (!strcmp (optarg, "direct"))
+                    *write_mode = OUT_WRITE_DIRECT;
+                else
+                {
+                    sprintf (errmsg, "Unknown write mode %s.  Must be "
+                        "cached, dontneed, or direct.", optarg);
+                    error_handler (true, FUNC_NAME, errmsg);
+                    usage ();
+                    return (ERROR);
+                }
+                break;
+
+            case 's':  /* directory for the scratch files */
+                *scratch_dir = strdup (optarg);
+                break;
+
+            case 'm':  /* megabytes of planes held in memory */
+                plane_mem_set = true;
+                *plane_mem_mb = atol (optarg);
+                if (*plane_mem_mb < 0)
+                {
+                    sprintf (errmsg, "Invalid plane memory size %s.  Must be "
+                        "0 or more megabytes.", optarg);
+                    error_handler (true, FUNC_NAME, errmsg);
+                    usage ();
+                    return (ERROR);
+                }
+                break;
+
+            case 'g':  /* memory budget */
+                *mem_budget_mb = atol (optarg);
+                if (*mem_budget_mb < 1)
+                {
+                    sprintf (errmsg, "Memory budget must be at least 1 "
+                        "megabyte: %s", optarg);
+                    error_handler (true, FUNC_NAME, errmsg);
+                    usage ();
+                    return (ERROR);
+                }
+                break;
+
+            case 't':  /* number of threads */
+                *nthreads = atoi (optarg);
+                if (*nthreads < 1)
+                {
+                    sprintf (errmsg, "Number of threads must be at least 1: "
+                        "%s", optarg);
+                    error_handler (true, FUNC_NAME, errmsg);
+                    usage ();
+                    return (ERROR);
+                }
+                break;
+
+            case 'd':  /* shard of the scene */
+                if (sscanf (optarg, "%d,%d", shard_index, shard_count) != 2 ||
+                    *shard_count < 1 || *shard_index < 0 ||
+                    *shard_index >= *shard_count)
+                {
+                    sprintf (errmsg, "Shard must be index,count with a count "
+                        "of at least 1 and an index from 0 to count-1: %s",
+                        optarg);
+                    error_handler (true, FUNC_NAME, errmsg);
+                    usage ();
+                    return (ERROR);
+                }
+                break;
+
+            case 'o':  /* bands to be output */
+                *outputs = strdup (optarg);
+                break;
+
+            case 'p':  /* profile the processing stages */
+                *profile = true;
+                if (optarg != NULL)
+                    *profile_file = strdup (optarg);
+                break;
+
+            case 'n':  /* processing window */
+                if (sscanf (optarg, "%d,%d,%d,%d", &window->line0,
+                    &window->samp0, &window->nlines, &window->nsamps) != 4 ||
+                    window->line0 < 0 || window->samp0 < 0 ||
+                    window->nlines < 1 || window->nsamps < 1)
+                {
+                    sprintf (errmsg, "Window must be line0,samp0,nlines,"
+                        "nsamps with a starting line and sample of at least "
+                        "0 and a size of at least 1: %s", optarg);
+                    error_handler (true, FUNC_NAME, errmsg);
+                    usage ();
+                    return (ERROR);
+                }
+                break;
      
             case '?':
             default:
@@ -99,9 +309,59 @@ short get_args
         return (ERROR);
     }
 
-    /* Check the verbose flag */
+    /* The memory budget picks the plane memory */
+    if (plane_mem_set && *mem_budget_mb > 0)
+    {
+        sprintf (errmsg, "--plane_mem_mb can't be specified along with "
+            "--mem_budget_mb");
+        error_handler (true, FUNC_NAME, errmsg);
+        usage ();
+        return (ERROR);
+    }
+
+    /* The shards are windows of the scene, and the tiled files would only
+       cover one of them */
+    if (*shard_count > 0 && (window->nlines > 0 || tiled_flag))
+    {
+        sprintf (errmsg, "--shard can't be specified along with --window or "
+            "--tiled_output");
+        error_handler (true, FUNC_NAME, errmsg);
+        usage ();
+        return (ERROR);
+    }
+
+    /* The finalize step writes the metadata of the whole sharded scene */
+    if (finalize_flag && (*shard_count > 0 || window->nlines > 0 ||
+        tiled_flag))
+    {
+        sprintf (errmsg, "--shard_finalize can't be specified along with "
+            "--shard, --window, or --tiled_output");
+        error_handler (true, FUNC_NAME, errmsg);
+        usage ();
+        return (ERROR);
+    }
+
+    /* The output list replaces the intermediate bands flag */
+    if (*outputs != NULL && intermediate_flag)
+    {
+        sprintf (errmsg, "--outputs can't be specified along with "
+            "--write_intermediate");
+        error_handler (true, FUNC_NAME, errmsg);
+        usage ();
+        return (ERROR);
+    }
+
+    /* Check the flags */
     if (verbose_flag)
         *verbose = true;
+    if (intermediate_flag)
+        *write_intermediate = true;
+    if (tiled_flag)
+        *tiled_output = true;
+    if (mmap_flag)
+        *mmap_input = true;
+    if (finalize_flag)
+        *shard_finalize = true;
 
     return (SUCCESS);
 }
@@ -1,3 +1,7 @@
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include "input.h"
 
 /******************************************************************************
@@ -22,13 +26,19 @@ Date         Programmer       Reason
 ---------    ---------------  -------------------------------------
 5/19/2014    Gail Schmidt     Original Development (based on input routines
                               from the spectral indices application)
+10/14/2026   agent            Start with the whole scene as the window
+10/14/2026   agent            Allocate the read buffers with
+                              set_input_strip_nlines
 
 NOTES:
   1. This routine opens the input reflectance files.  It also allocates memory
      for pointers in the input structure.  It is up to the caller to use
      close_input and free_input to close the files and free up the memory when
      done using the input data structure.
-  2. The read buffers are only set up to read NPROC_LINES at a time.
+  2. The read buffers are only set up to read PROC_NLINES at a time, until
+     set_input_strip_nlines is called with another number of lines.
+  3. The read buffers are sized for the samples of the whole scene, so they
+     hold the lines of any window set by set_input_window.
 ******************************************************************************/
 Input_t *open_input
 (
@@ -44,8 +54,6 @@ Input_t *open_input
     int ib;                   /* loop counter for bands */
     int refl_indx = -1;       /* band index in XML file for the reflectance
                                  band */
-    int16 *buf = NULL;        /* temporary buffer to allocate memory for
-                                 the reflectance bands */
     Espa_global_meta_t *gmeta = &metadata->global; /* pointer to global meta */
   
     /* Create the Input data structure */
@@ -64,10 +72,17 @@ Input_t *open_input
         this->file_name[ib] = NULL;
         this->fp_bin[ib] = NULL;
         this->refl_buf[ib] = NULL;
+        this->read_buf[ib] = NULL;
+        this->map[ib] = NULL;
     }
+    this->mapped = false;
+    this->map_size = 0;
     this->cfmask_file_name = NULL;
     this->fp_cfmask = NULL;
     this->cfmask_buf = NULL;
+    this->span = NULL;
+    this->nvalid_lines = 0;
+    this->proc_nlines = 0;
 
     /* Initialize the input fields using information from the metadata
        structure */
@@ -173,6 +188,10 @@ Input_t *open_input
     /* Pull the reflectance info from representative band1 in the XML file */
     this->nsamps = metadata->band[refl_indx].nsamps;
     this->nlines = metadata->band[refl_indx].nlines;
+    this->scene_nsamps = this->nsamps;
+    this->scene_nlines = this->nlines;
+    this->line0 = 0;
+    this->samp0 = 0;
     this->pixsize[0] = metadata->band[refl_indx].pixel_size[0];
     this->pixsize[1] = metadata->band[refl_indx].pixel_size[1];
     this->refl_fill = metadata->band[refl_indx].fill_value;
@@ -215,35 +234,13 @@ Input_t *open_input
         return (NULL);
     }
 
-    /* Allocate input buffer.  Reflectance buffer has multiple bands.
-       Allocate PROC_NLINES of data for each band. */
-    buf = calloc (PROC_NLINES * this->nsamps * this->nrefl_band,
-        sizeof (int16));
-    if (buf == NULL)
+    /* Allocate the input buffers */
+    if (set_input_strip_nlines (this, PROC_NLINES) != SUCCESS)
     {
         close_input (this);
         free_input (this);
-        sprintf (errmsg, "Allocating memory for input reflectance buffer "
-            "containing %d lines.", PROC_NLINES);
-        error_handler (true, FUNC_NAME, errmsg);
-        return (NULL);
-    }
-    else
-    {
-        /* Set up the memory buffers for each band */
-        this->refl_buf[0] = buf;
-        for (ib = 1; ib < this->nrefl_band; ib++)
-            this->refl_buf[ib] = this->refl_buf[ib-1] +
-                PROC_NLINES * this->nsamps;
-    }
-
-    this->cfmask_buf = calloc (PROC_NLINES * this->nsamps, sizeof (uint8));
-    if (this->cfmask_buf == NULL)
-    {
-        close_input (this);
-        free_input (this);
-        sprintf (errmsg, "Allocating memory for input cfmask buffer "
-            "containing %d lines.", PROC_NLINES);
+        sprintf (errmsg, "Allocating memory for input buffers containing %d "
+            "lines.", PROC_NLINES);
         error_handler (true, FUNC_NAME, errmsg);
         return (NULL);
     }
@@ -269,6 +266,7 @@ Date         Programmer       Reason
 ---------    ---------------  -------------------------------------
 5/19/2014    Gail Schmidt     Original Development (based on input routines
                               from the spectral indices application)
+10/14/2026   agent            Unmap the mapped reflectance bands
 
 NOTES:
 ******************************************************************************/
@@ -279,6 +277,17 @@ void close_input
 {
     int ib;      /* loop counter for bands */
   
+    /* Unmap the reflectance bands, which leaves refl_buf pointing at the
+       read buffers */
+    for (ib = 0; ib < this->nrefl_band; ib++)
+    {
+        if (this->map[ib] != NULL)
+            munmap (this->map[ib], this->map_size);
+        this->map[ib] = NULL;
+        this->refl_buf[ib] = this->read_buf[ib];
+    }
+    this->mapped = false;
+
     /* Close the raw binary files */
     if (this->refl_open)
     {
@@ -334,8 +343,9 @@ void free_input
         free (this->cfmask_file_name);
   
         /* Free the data buffers */
-        free (this->refl_buf[0]);
+        free (this->read_buf[0]);
         free (this->cfmask_buf);
+        free (this->span);
 
         /* Free the data structure */
         free (this);
@@ -343,6 +353,292 @@ void free_input
 }
 
 
+/******************************************************************************
+MODULE:  set_input_window
+
+PURPOSE:  Restricts the input to a window of the scene.  The lines and samples
+of the Input_t data structure become those of the window, and the lines read
+from the input files are relative to the upper left corner of the window.
+
+RETURN VALUE:
+Type = int
+Value      Description
+-----      -----------
+ERROR      The window is not within the scene
+SUCCESS    Successful completion
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. The window is always relative to the whole scene, so a new window
+     replaces the previous one.
+******************************************************************************/
+int set_input_window
+(
+    Input_t *this,          /* I/O: pointer to input data structure */
+    Img_window_t *window    /* I: window of the scene to be read */
+)
+{
+    char FUNC_NAME[] = "set_input_window";   /* function name */
+    char errmsg[STR_SIZE];    /* error message */
+
+    if (window->line0 < 0 || window->samp0 < 0 || window->nlines < 1 ||
+        window->nsamps < 1 ||
+        window->line0 + window->nlines > this->scene_nlines ||
+        window->samp0 + window->nsamps > this->scene_nsamps)
+    {
+        sprintf (errmsg, "Window of %d lines and %d samples starting at line "
+            "%d, sample %d is not within the %d lines and %d samples of the "
+            "scene", window->nlines, window->nsamps, window->line0,
+            window->samp0, this->scene_nlines, this->scene_nsamps);
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+
+    this->line0 = window->line0;
+    this->samp0 = window->samp0;
+    this->nlines = window->nlines;
+    this->nsamps = window->nsamps;
+
+    return (SUCCESS);
+}
+
+
+/******************************************************************************
+MODULE:  set_input_strip_nlines
+
+PURPOSE:  Allocates the read buffers to hold strips of proc_nlines lines,
+replacing the read buffers already allocated.
+
+RETURN VALUE:
+Type = int
+Value      Description
+-----      -----------
+ERROR      Error allocating the read buffers
+SUCCESS    Successful completion
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development (pulled from open_input)
+10/14/2026    agent            Don't clear the buffers to 0s
+10/14/2026    agent            Allocate the valid spans of the strip lines
+
+NOTES:
+  1. Reflectance buffer has multiple bands.  Each band holds proc_nlines
+     lines plus PROC_HALO lines above and below for the variance windows.
+     The cfmask buffer holds proc_nlines lines.  There is a valid span for
+     each line of the reflectance buffer.
+  2. The buffers are allocated for the whole width of the scene.  If the
+     allocation fails, the previous buffers are kept.
+  3. The buffers are not cleared to 0s, since the lines of each strip are
+     read into them before they are used.
+******************************************************************************/
+int set_input_strip_nlines
+(
+    Input_t *this,   /* I/O: pointer to input data structure */
+    int proc_nlines  /* I: number of lines in each strip */
+)
+{
+    char FUNC_NAME[] = "set_input_strip_nlines";   /* function name */
+    char errmsg[STR_SIZE];    /* error message */
+    int ib;                   /* loop counter for bands */
+    size_t band_size;         /* number of pixels in each band buffer */
+    int16 *buf = NULL;        /* memory block for the reflectance bands */
+    uint8 *cfmask_buf = NULL; /* buffer for the cfmask */
+    Valid_span_t *span = NULL;  /* valid spans of the strip lines */
+
+    if (proc_nlines < 1)
+    {
+        sprintf (errmsg, "Invalid number of strip lines: %d", proc_nlines);
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+
+    band_size = (size_t) (proc_nlines + 2*PROC_HALO) * this->scene_nsamps;
+    buf = malloc (band_size * this->nrefl_band * sizeof (int16));
+    cfmask_buf = malloc ((size_t) proc_nlines * this->scene_nsamps *
+        sizeof (uint8));
+    span = malloc ((proc_nlines + 2*PROC_HALO) * sizeof (Valid_span_t));
+    if (buf == NULL || cfmask_buf == NULL || span == NULL)
+    {
+        free (buf);
+        free (cfmask_buf);
+        free (span);
+        sprintf (errmsg, "Allocating memory for input buffers containing %d "
+            "lines.", proc_nlines + 2*PROC_HALO);
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+
+    /* Set up the memory buffers for each band */
+    free (this->read_buf[0]);
+    free (this->cfmask_buf);
+    for (ib = 0; ib < this->nrefl_band; ib++)
+    {
+        this->read_buf[ib] = buf + ib * band_size;
+        this->refl_buf[ib] = this->read_buf[ib];
+    }
+    this->cfmask_buf = cfmask_buf;
+    free (this->span);
+    this->span = span;
+    this->nvalid_lines = 0;
+    this->proc_nlines = proc_nlines;
+
+    return (SUCCESS);
+}
+
+
+/******************************************************************************
+MODULE:  read_window_lines (static)
+
+PURPOSE:  Reads lines of the window from one of the input files.
+
+RETURN VALUE:
+Type = int
+Value      Description
+-----      -----------
+ERROR      Error occurred seeking or reading the lines
+SUCCESS    Successful completion
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. If the window covers the whole width of the scene, the lines are read
+     with one seek and read.  Otherwise each line is read separately,
+     starting at the first sample of the window.
+******************************************************************************/
+static int read_window_lines
+(
+    Input_t *this,   /* I: pointer to input data structure */
+    FILE *fp,        /* I: file pointer of the file to read */
+    int iline,       /* I: first line to read, relative to the window */
+    int nlines,      /* I: number of lines to read */
+    int nbytes,      /* I: number of bytes per pixel in the file */
+    void *buf        /* O: buffer for nlines lines of the window */
+)
+{
+    int line;                 /* current line being read */
+    long loc;                 /* current location in the input file */
+
+    if (this->samp0 == 0 && this->nsamps == this->scene_nsamps)
+    {
+        loc = ((long) this->line0 + iline) * this->scene_nsamps * nbytes;
+        if (fseek (fp, loc, SEEK_SET))
+            return (ERROR);
+        return (read_raw_binary (fp, nlines, this->nsamps, nbytes, buf));
+    }
+
+    for (line = 0; line < nlines; line++)
+    {
+        loc = (((long) this->line0 + iline + line) * this->scene_nsamps +
+            this->samp0) * nbytes;
+        if (fseek (fp, loc, SEEK_SET))
+            return (ERROR);
+        if (read_raw_binary (fp, 1, this->nsamps, nbytes,
+            (char *) buf + (long) line * this->nsamps * nbytes) != SUCCESS)
+            return (ERROR);
+    }
+
+    return (SUCCESS);
+}
+
+
+/******************************************************************************
+MODULE:  widen_valid_spans (static)
+
+PURPOSE:  Widens the valid span of each line in refl_buf to cover the pixels
+of the band just read which aren't fill.
+
+RETURN VALUE:
+Type = None
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. Reading band 0 starts the spans of a new strip, so the bands of a strip
+     need to be read starting with band 0.
+  2. Only the samples outside the current span are searched, from each end
+     of the line, so once the first band is read only the fill corners of
+     the scene are looked at.
+******************************************************************************/
+static void widen_valid_spans
+(
+    Input_t *this,   /* I/O: pointer to input data structure */
+    int iband,       /* I: band just read into refl_buf (0-based) */
+    int nlines       /* I: number of lines read */
+)
+{
+    int line;                 /* current line of the strip */
+    int samp;                 /* current sample of the line */
+    int16 *buf = NULL;        /* current line of the band */
+    Valid_span_t *span = NULL;  /* valid span of the current line */
+
+    this->nvalid_lines = 0;
+    for (line = 0; line < nlines; line++)
+    {
+        buf = &this->refl_buf[iband][(long) line * this->nsamps];
+        span = &this->span[line];
+        if (iband == 0)
+        {
+            span->start = this->nsamps;
+            span->end = 0;
+        }
+
+        /* Look for pixels which aren't fill before the span, then after it;
+           if the line has been all fill so far the first search covers the
+           whole line */
+        for (samp = 0; samp < span->start; samp++)
+        {
+            if (buf[samp] != this->refl_fill)
+            {
+                if (span->end < samp + 1)
+                    span->end = samp + 1;
+                span->start = samp;
+                break;
+            }
+        }
+        for (samp = this->nsamps - 1; samp >= span->end; samp--)
+        {
+            if (buf[samp] != this->refl_fill)
+            {
+                span->end = samp + 1;
+                break;
+            }
+        }
+
+        if (span->start < span->end)
+            this->nvalid_lines++;
+        else
+        {
+            span->start = this->nsamps;
+            span->end = 0;
+        }
+    }
+}
+
+
 /******************************************************************************
 MODULE:  get_input_refl_lines
 
@@ -367,10 +663,23 @@ Date         Programmer       Reason
 ---------    ---------------  -------------------------------------
 5/19/2014    Gail Schmidt     Original Development (based on input routines
                               from the spectral indices application)
+10/14/2026   agent            Read the lines of the input window
+10/14/2026   agent            Find the valid spans of the lines read into
+                              refl_buf
+10/14/2026   agent            Use the lines of the mapped bands in place
 
 NOTES:
   1. The Input_t data structure needs to be populated and memory allocated
      before calling this routine.  Use open_input to do that.
+  2. iline is relative to the upper left corner of the input window.
+  3. When the lines are read into refl_buf, the valid spans of the lines are
+     widened for the pixels of the band which aren't fill (see
+     widen_valid_spans).  The bands of a strip are read starting with band
+     0, and the spans cover all of the bands once they have been read.
+  4. If the bands are mapped (see map_input) and the window covers the whole
+     width of the scene, refl_buf is pointed at the lines in the mapped band
+     rather than copying them.  A narrower window copies the lines of the
+     window from the mapped band into the read buffer, without any seeks.
 ******************************************************************************/
 int get_input_refl_lines
 (
@@ -383,8 +692,9 @@ int get_input_refl_lines
 {
     char FUNC_NAME[] = "get_input_refl_line";   /* function name */
     char errmsg[STR_SIZE];    /* error message */
-    long loc;                 /* current location in the input file */
-    void *buf = NULL;         /* pointer to the buffer for the current band */
+    int line;                 /* current line being copied */
+    int16 *buf = NULL;        /* pointer to the buffer for the current band */
+    int16 *src = NULL;        /* first line to read in the mapped band */
   
     /* Check the parameters */
     if (this == NULL) 
@@ -405,30 +715,42 @@ int get_input_refl_lines
         error_handler (true, FUNC_NAME, errmsg);
         return (ERROR);
     }
-    if (iline < 0 || iline >= this->nlines)
+    if (iline < 0 || iline >= this->nlines || nlines < 1 ||
+        iline + nlines > this->nlines)
     {
         strcpy (errmsg, "Invalid line number for reflectance band");
         error_handler (true, FUNC_NAME, errmsg);
         return (ERROR);
     }
   
-    /* If the output array is not NULL then use it, otherwise use the refl_buf
-       in the Input_t data structure */
+    /* If the output array is not NULL then use it, otherwise use the read
+       buffer in the Input_t data structure */
     if (out_arr == NULL)
-        buf = (void *) this->refl_buf[iband];
+    {
+        buf = this->read_buf[iband];
+        this->refl_buf[iband] = buf;
+    }
     else
-        buf = (void *) out_arr;
+        buf = out_arr;
 
-    /* Read the data, but first seek to the correct line */
-    loc = (long) iline * this->nsamps * sizeof (int16);
-    if (fseek (this->fp_bin[iband], loc, SEEK_SET))
+    /* Use or copy the lines of the window in the mapped band */
+    if (this->mapped)
     {
-        strcpy (errmsg, "Seeking to the current line in the input file");
-        error_handler (true, FUNC_NAME, errmsg);
-        return (ERROR);
+        src = &this->map[iband][((long) this->line0 + iline) *
+            this->scene_nsamps + this->samp0];
+        if (out_arr == NULL && this->nsamps == this->scene_nsamps)
+            this->refl_buf[iband] = src;
+        else
+        {
+            for (line = 0; line < nlines; line++)
+                memcpy (&buf[(long) line * this->nsamps],
+                    &src[(long) line * this->scene_nsamps],
+                    this->nsamps * sizeof (int16));
+        }
     }
 
-    if (read_raw_binary (this->fp_bin[iband], nlines, this->nsamps,
+    /* Read the lines of the window */
+    else if (read_window_lines (this, this->fp_bin[iband], iline, nlines,
         sizeof (int16), buf) != SUCCESS)
     {
         sprintf (errmsg, "Reading %d lines from reflectance band %d starting "
@@ -436,6 +758,10 @@ int get_input_refl_lines
         error_handler (true, FUNC_NAME, errmsg);
         return (ERROR);
     }
+
+    /* Find the part of each line which isn't fill in every band */
+    if (out_arr == NULL)
+        widen_valid_spans (this, iband, nlines);
   
     return (SUCCESS);
 }
@@ -465,10 +791,12 @@ Date         Programmer       Reason
 ---------    ---------------  -------------------------------------
 5/19/2014    Gail Schmidt     Original Development (based on input routines
                               from the spectral indices application)
+10/14/2026   agent            Read the lines of the input window
 
 NOTES:
   1. The Input_t data structure needs to be populated and memory allocated
      before calling this routine.  Use open_input to do that.
+  2. iline is relative to the upper left corner of the input window.
 ******************************************************************************/
 int get_input_cfmask_lines
 (
@@ -480,7 +808,6 @@ int get_input_cfmask_lines
 {
     char FUNC_NAME[] = "get_input_cfmask_line";   /* function name */
     char errmsg[STR_SIZE];    /* error message */
-    long loc;                 /* current location in the input file */
     void *buf = NULL;         /* pointer to the buffer for the current band */
   
     /* Check the parameters */
@@ -510,24 +837,177 @@ int get_input_cfmask_lines
     else
         buf = (void *) out_arr;
 
-    /* Read the data, but first seek to the correct line */
-    loc = (long) iline * this->nsamps * sizeof (uint8);
-    if (fseek (this->fp_cfmask, loc, SEEK_SET))
+    /* Read the lines of the window */
+    if (read_window_lines (this, this->fp_cfmask, iline, nlines,
+        sizeof (uint8), buf) != SUCCESS)
     {
-        strcpy (errmsg, "Seeking to the current line in the input cfmask file");
+        sprintf (errmsg, "Reading %d lines from cfmask band starting at line "
+            "%d", nlines, iline);
         error_handler (true, FUNC_NAME, errmsg);
         return (ERROR);
     }
+  
+    return (SUCCESS);
+}
+
+
+
+/******************************************************************************
+MODULE:  map_input
+
+PURPOSE:  Maps the reflectance band files into memory, so the lines of the
+strips are used in place by get_input_refl_lines instead of being read.
+
+RETURN VALUE:
+Type = int
+Value      Description
+-----      -----------
+ERROR      Error mapping the band files
+SUCCESS    Successful completion
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
 
-    if (read_raw_binary (this->fp_cfmask, nlines, this->nsamps, sizeof (uint8),
-        buf) != SUCCESS)
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. The bands are mapped read-only, so the lines in refl_buf must not be
+     written while the bands are mapped.  close_input unmaps the bands.
+  2. The page cache holds the lines of the bands, so the halo lines shared
+     by two strips are only read from the file once.  Use
+     advise_input_lines to start reading the next strip ahead of time.
+  3. If one of the bands can't be mapped, a warning is printed, the bands
+     which were mapped are unmapped, and the bands are read as before.
+******************************************************************************/
+int map_input
+(
+    Input_t *this    /* I/O: pointer to input data structure */
+)
+{
+    char FUNC_NAME[] = "map_input";   /* function name */
+    char errmsg[STR_SIZE];    /* error message */
+    int ib;                   /* loop counter for bands */
+    struct stat st;           /* status of the current band file */
+    void *map = NULL;         /* mapping of the current band file */
+
+    if (this == NULL || !this->refl_open)
     {
-        sprintf (errmsg, "Reading %d lines from cfmask band starting at line "
-            "%d", nlines, iline);
+        strcpy (errmsg, "Reflectance file has not been opened");
         error_handler (true, FUNC_NAME, errmsg);
         return (ERROR);
     }
-  
+
+    this->map_size = (size_t) this->scene_nlines * this->scene_nsamps *
+        sizeof (int16);
+    for (ib = 0; ib < this->nrefl_band; ib++)
+    {
+        /* Make sure the file holds the whole band, since reading past the
+           end of the file through the mapping is a bus error */
+        if (fstat (fileno (this->fp_bin[ib]), &st) != 0 ||
+            (size_t) st.st_size < this->map_size)
+        {
+            sprintf (errmsg, "Reflectance band file is smaller than the %d "
+                "lines and %d samples of the scene: %s", this->scene_nlines,
+                this->scene_nsamps, this->file_name[ib]);
+            error_handler (false, FUNC_NAME, errmsg);
+            break;
+        }
+
+        map = mmap (NULL, this->map_size, PROT_READ, MAP_SHARED,
+            fileno (this->fp_bin[ib]), 0);
+        if (map == MAP_FAILED)
+        {
+            sprintf (errmsg, "Mapping the reflectance band file: %s",
+                this->file_name[ib]);
+            error_handler (false, FUNC_NAME, errmsg);
+            break;
+        }
+        this->map[ib] = (int16 *) map;
+    }
+
+    /* Unmap the bands if they weren't all mapped */
+    if (ib < this->nrefl_band)
+    {
+        for (ib = 0; ib < this->nrefl_band; ib++)
+        {
+            if (this->map[ib] != NULL)
+                munmap (this->map[ib], this->map_size);
+            this->map[ib] = NULL;
+        }
+        return (ERROR);
+    }
+
+    this->mapped = true;
     return (SUCCESS);
 }
 
+
+/******************************************************************************
+MODULE:  advise_input_lines
+
+PURPOSE:  Tells the kernel which lines of the reflectance bands and cfmask
+will be read next, so it can read them ahead of time.
+
+RETURN VALUE:
+Type = None
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. The hints are madvise calls for the mapped bands and posix_fadvise
+     calls for the files which are read.  They are only hints, so any
+     errors are ignored.
+  2. The lines outside the window are clipped.  For a window narrower than
+     the scene, the hint covers the whole width of the lines.
+******************************************************************************/
+void advise_input_lines
+(
+    Input_t *this,   /* I: pointer to input data structure */
+    int iline,       /* I: first line which will be read (0-based) */
+    int nlines       /* I: number of lines which will be read */
+)
+{
+    int ib;                   /* loop counter for bands */
+    long page_size;           /* size of the memory pages */
+    long start_pix;           /* first pixel of the lines in the scene */
+    long npix;                /* number of pixels spanned by the lines */
+    long start_byte;          /* first byte of the lines in a mapped band,
+                                 rounded down to a page */
+
+    if (iline < 0)
+    {
+        nlines += iline;
+        iline = 0;
+    }
+    if (iline + nlines > this->nlines)
+        nlines = this->nlines - iline;
+    if (nlines < 1 || !this->refl_open)
+        return;
+
+    start_pix = ((long) this->line0 + iline) * this->scene_nsamps +
+        this->samp0;
+    npix = (long) (nlines - 1) * this->scene_nsamps + this->nsamps;
+    page_size = sysconf (_SC_PAGESIZE);
+    start_byte = start_pix * (long) sizeof (int16) / page_size * page_size;
+
+    for (ib = 0; ib < this->nrefl_band; ib++)
+    {
+        if (this->mapped)
+            madvise ((char *) this->map[ib] + start_byte, (start_pix + npix) *
+                sizeof (int16) - start_byte, MADV_WILLNEED);
+        else
+            posix_fadvise (fileno (this->fp_bin[ib]), start_pix *
+                sizeof (int16), npix * sizeof (int16), POSIX_FADV_WILLNEED);
+    }
+    posix_fadvise (fileno (this->fp_cfmask), start_pix, npix,
+        POSIX_FADV_WILLNEED);
+}
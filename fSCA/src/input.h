@@ -15,24 +15,63 @@
    which are input for this application. */
 #define NBAND_REFL_MAX 6
 
+/* Structure for a window of the scene, in lines and samples of the scene */
+typedef struct {
+    int line0;               /* first line of the window (0-based) */
+    int samp0;               /* first sample of the window (0-based) */
+    int nlines;              /* number of lines in the window */
+    int nsamps;              /* number of samples in the window */
+} Img_window_t;
+
+/* Structure for the valid span of a line: the samples outside of it are fill
+   in every reflectance band, which is the case for the corners of the tilted
+   Landsat footprint */
+typedef struct {
+    int start;               /* first sample which isn't fill in every band */
+    int end;                 /* sample after the last one which isn't fill in
+                                every band; start == end if the whole line
+                                is fill */
+} Valid_span_t;
+
 /* Structure for the 'input' data type, particularly to handle the file/SDS
    IDs and the band-specific information */
 typedef struct {
     bool refl_open;          /* open reflectance file flag; open = true */
     int nrefl_band;          /* number of input reflectance bands */
-    int nlines;              /* number of input lines */
-    int nsamps;              /* number of input samples */
+    int nlines;              /* number of input lines, in the window */
+    int nsamps;              /* number of input samples, in the window */
+    int scene_nlines;        /* number of lines in the scene */
+    int scene_nsamps;        /* number of samples in the scene */
+    int line0;               /* first line of the window in the scene */
+    int samp0;               /* first sample of the window in the scene */
     float pixsize[2];        /* pixel size x, y */
     int refl_band[NBAND_REFL_MAX];   /* band numbers for reflectance data */
     char *file_name[NBAND_REFL_MAX]; /* name of the input image files */
-    int16 *refl_buf[NBAND_REFL_MAX]; /* input data buffer for unscaled
-                                        reflectance and cfmask data
-                                        (PROC_NLINES lines of data) */
+    int16 *refl_buf[NBAND_REFL_MAX]; /* lines of the strip for each
+                                        unscaled reflectance band
+                                        (proc_nlines lines of data plus
+                                        PROC_HALO lines above and below);
+                                        either read_buf or a view of the
+                                        mapped band, which must not be
+                                        written */
+    int16 *read_buf[NBAND_REFL_MAX]; /* read buffer for each reflectance
+                                        band, holding the same lines as
+                                        refl_buf */
+    bool mapped;             /* are the reflectance bands mapped? */
+    int16 *map[NBAND_REFL_MAX];      /* mapped reflectance band files; NULL
+                                        if not mapped */
+    size_t map_size;         /* size of each mapped band file in bytes */
     FILE *fp_bin[NBAND_REFL_MAX];    /* file pointer for binary files */
     char *cfmask_file_name;  /* name of the input cfmask files */
     uint8 *cfmask_buf;       /* input data buffer for cfmask data
-                                (PROC_NLINES lines of data) */
+                                (proc_nlines lines of data) */
     FILE *fp_cfmask;         /* file pointer for cfmask file */
+    int proc_nlines;         /* number of lines held in the read buffers,
+                                not counting the halo */
+    Valid_span_t *span;      /* valid span of each line in refl_buf, across
+                                the bands read for the strip so far */
+    int nvalid_lines;        /* number of lines in refl_buf which aren't all
+                                fill */
     int16 refl_fill;         /* fill value for reflectance bands */
     float refl_scale_fact;   /* scale factor for reflectance bands */
     int refl_saturate_val;   /* saturation value for reflectance bands */
@@ -56,6 +95,18 @@ void free_input
     Input_t *this    /* I: pointer to input data structure */
 );
 
+int set_input_window
+(
+    Input_t *this,          /* I/O: pointer to input data structure */
+    Img_window_t *window    /* I: window of the scene to be read */
+);
+
+int set_input_strip_nlines
+(
+    Input_t *this,   /* I/O: pointer to input data structure */
+    int proc_nlines  /* I: number of lines in each strip */
+);
+
 int get_input_refl_lines
 (
     Input_t *this,   /* I: pointer to input data structure */
@@ -73,4 +124,16 @@ int get_input_cfmask_lines
     int16 *out_arr   /* O: output array to populate, if not NULL */
 );
 
+int map_input
+(
+    Input_t *this    /* I/O: pointer to input data structure */
+);
+
+void advise_input_lines
+(
+    Input_t *this,   /* I: pointer to input data structure */
+    int iline,       /* I: first line which will be read (0-based) */
+    int nlines       /* I: number of lines which will be read */
+);
+
 #endif
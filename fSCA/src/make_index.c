@@ -18,6 +18,11 @@ Date          Programmer       Reason
 5/19/2014     Gail Schmidt     Original Development
 6/17/2014     Gail Schmidt     Don't handle the saturated values as special
                                cases
+10/14/2026    agent            Only compute the index in the valid span of
+                               each line
+10/14/2026    agent            Compute the index of each span with
+                               spectral_index_float, which is vectorized
+10/14/2026    agent            Split the lines across threads
 
 NOTES:
   1. Input and output arrays are 1D arrays of size nlines * nsamps.
@@ -26,6 +31,8 @@ NOTES:
      simple band ratios.  Both bands are scaled by the same amount.
   3. If the current pixel is saturated in either band, then the output pixel
      value for the index will also be saturated.  The same applies for fill.
+  4. The pixels outside the valid span are fill in both bands, so they are
+     set to fill without looking at the bands.
 ******************************************************************************/
 void make_index
 (
@@ -37,32 +44,44 @@ void make_index
     int satu_value,       /* I: saturation value for the reflectance values */
     int nlines,           /* I: number of lines in the data arrays */
     int nsamps,           /* I: number of samples in the data arrays */
+    Valid_span_t *span,   /* I: valid span of each line, outside of which the
+                                pixels are fill in every band; NULL if all
+                                of the samples are processed */
     float *spec_indx      /* O: output spectral index */
 )
 {
+    int line;               /* current line being processed */
+    int samp;               /* current sample being processed */
     int pix;                /* current pixel being processed */
-    float ratio;            /* band ratio */
+    int start, end;         /* valid span of the current line */
 
-    /* Loop through the pixels in the array and compute the spectral index */
-    for (pix = 0; pix < nlines * nsamps; pix++)
+    /* Loop through the pixels in the array and compute the spectral index,
+       setting the pixels outside the valid span of each line to fill.  The
+       lines are independent, so they are divided among the threads. */
+#ifdef _OPENMP
+    #pragma omp parallel for private(samp, pix, start, end) schedule(static)
+#endif
+    for (line = 0; line < nlines; line++)
     {
-        /* If the current pixel is saturated in either band then the output
-           is saturated.  Ditto for fill. */
-        if (band1[pix] == fill_value || band2[pix] == fill_value)
-            spec_indx[pix] = (float) FILL_VALUE;
-        else
+        start = 0;
+        end = nsamps;
+        if (span != NULL)
         {
-            /* Compute the band ratio */
-            ratio = (float) (band1[pix] - band2[pix]) /
-                    (float) (band1[pix] + band2[pix]);
-
-            /* Keep the ratio between -1.0, 1.0 */
-            if (ratio > 1.0)
-                ratio = 1.0;
-            else if (ratio < -1.0)
-                ratio = -1.0;
-            spec_indx[pix] = ratio;
+            start = span[line].start;
+            end = span[line].end;
         }
+        pix = line * nsamps;
+        for (samp = 0; samp < start; samp++)
+            spec_indx[pix + samp] = (float) FILL_VALUE;
+        for (samp = end; samp < nsamps; samp++)
+            spec_indx[pix + samp] = (float) FILL_VALUE;
+
+        /* Compute the band ratio of the valid span, setting the pixels
+           which are fill in either band to fill */
+        if (end > start)
+            spectral_index_float (&band1[pix + start], &band2[pix + start],
+                fill_value, end - start, (float) FILL_VALUE,
+                &spec_indx[pix + start]);
     }
 }
 
@@ -0,0 +1,434 @@
+#include "revised_cloud_mask.h"
+
+/* Work space for a morphology pass; see morph_pass */
+typedef struct {
+    int ksize;          /* size of the (square) structuring element */
+    int nsamps;         /* number of samples in the lines */
+    uint8 *pad;         /* input line padded with the identity value */
+    uint8 *prefix;      /* running min/max from the start of each block */
+    uint8 *suffix;      /* running min/max to the end of each block */
+    uint8 *cur_suffix;  /* ksize lines of suffix values for the current block
+                           of output lines */
+    uint8 *next_prefix; /* ksize lines of prefix values for the next block */
+    uint8 *next_suffix; /* ksize lines of suffix values for the next block */
+} Morph_work_t;
+
+
+/******************************************************************************
+MODULE:  minmax (static)
+
+PURPOSE:  Returns the minimum (erosion) or maximum (dilation) of two values.
+
+RETURN VALUE:
+Type = uint8
+Value          Description
+-----          -----------
+min/max        Minimum or maximum of the two values
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+---------     ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+******************************************************************************/
+static inline uint8 minmax
+(
+    uint8 a,            /* I: first value */
+    uint8 b,            /* I: second value */
+    bool dilate         /* I: return the maximum (true) or minimum (false) */
+)
+{
+    if (dilate)
+        return ((a > b) ? a : b);
+    else
+        return ((a < b) ? a : b);
+}
+
+
+/******************************************************************************
+MODULE:  morph_line (static)
+
+PURPOSE:  Runs the running min (erosion) or max (dilation) along one line,
+using the van Herk/Gil-Werman algorithm.
+
+RETURN VALUE:
+Type = None
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+---------     ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. out[samp] is the min/max of in[samp-anchor] through
+     in[samp-anchor+ksize-1], ignoring the samples outside the line.
+  2. The padded line pad[i] = in[i-anchor] is split into blocks of ksize
+     samples.  The window for out[samp] is pad[samp] through
+     pad[samp+ksize-1], which is the suffix of one block and the prefix of
+     the next, so each output sample takes a single min/max of the two
+     running values no matter the size of the element.
+******************************************************************************/
+static void morph_line
+(
+    uint8 *in,          /* I: input line */
+    int anchor,         /* I: anchor of the structuring element */
+    bool dilate,        /* I: dilate (true) or erode (false) */
+    Morph_work_t *work, /* I/O: work space */
+    uint8 *out          /* O: output line; may not be the input line */
+)
+{
+    int ksize = work->ksize;    /* size of the structuring element */
+    int nsamps = work->nsamps;  /* number of samples in the line */
+    int npad;           /* number of padded samples, a multiple of ksize */
+    int i, j;           /* looping variables */
+    uint8 identity;     /* value which doesn't change the min/max */
+    uint8 *pad = work->pad;        /* padded input line */
+    uint8 *prefix = work->prefix;  /* prefix min/max for each block */
+    uint8 *suffix = work->suffix;  /* suffix min/max for each block */
+
+    identity = dilate ? 0 : 255;
+    npad = ((nsamps + ksize - 1 + ksize - 1) / ksize) * ksize;
+
+    /* Pad the line with the identity value, so the samples outside the line
+       are ignored */
+    memset (pad, identity, npad * sizeof (uint8));
+    memcpy (&pad[anchor], in, nsamps * sizeof (uint8));
+
+    /* Compute the running values within each block */
+    for (i = 0; i < npad; i += ksize)
+    {
+        prefix[i] = pad[i];
+        for (j = i + 1; j < i + ksize; j++)
+            prefix[j] = minmax (prefix[j-1], pad[j], dilate);
+
+        suffix[i+ksize-1] = pad[i+ksize-1];
+        for (j = i + ksize - 2; j >= i; j--)
+            suffix[j] = minmax (suffix[j+1], pad[j], dilate);
+    }
+
+    /* Combine the suffix and prefix for each window */
+    for (i = 0; i < nsamps; i++)
+        out[i] = minmax (suffix[i], prefix[i+ksize-1], dilate);
+}
+
+
+/******************************************************************************
+MODULE:  load_block (static)
+
+PURPOSE:  Loads a block of ksize lines for the vertical pass, running the
+horizontal pass on each line, and computes the prefix and suffix values for
+the block.
+
+RETURN VALUE:
+Type = None
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+---------     ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. Lines outside the mask are set to the identity value so they are
+     ignored.
+******************************************************************************/
+static void load_block
+(
+    uint8 *mask,        /* I: mask being processed */
+    int nlines,         /* I: number of lines in the mask */
+    int first_line,     /* I: first line of the block; may be negative */
+    int anchor,         /* I: anchor of the structuring element */
+    bool dilate,        /* I: dilate (true) or erode (false) */
+    Morph_work_t *work, /* I/O: work space */
+    uint8 *prefix,      /* O: ksize lines of prefix values */
+    uint8 *suffix       /* O: ksize lines of suffix values */
+)
+{
+    int ksize = work->ksize;    /* size of the structuring element */
+    int nsamps = work->nsamps;  /* number of samples in the lines */
+    int i;              /* looping variable for the lines in the block */
+    int samp;           /* looping variable for the samples */
+    int line;           /* current line of the mask */
+    uint8 *row = NULL;  /* current line of the block after the horizontal
+                           pass */
+    uint8 *pre = NULL;  /* prefix values for the current line */
+    uint8 *suf = NULL;  /* suffix values for the current line */
+
+    /* Run the horizontal pass on each line and keep the running prefix.  The
+       raw lines are kept in the suffix block until the suffix is
+       computed. */
+    for (i = 0; i < ksize; i++)
+    {
+        line = first_line + i;
+        row = &suffix[(long) i * nsamps];
+        if (line < 0 || line >= nlines)
+            memset (row, dilate ? 0 : 255, nsamps * sizeof (uint8));
+        else
+            morph_line (&mask[(long) line * nsamps], anchor, dilate, work,
+                row);
+
+        pre = &prefix[(long) i * nsamps];
+        if (i == 0)
+            memcpy (pre, row, nsamps * sizeof (uint8));
+        else
+        {
+            for (samp = 0; samp < nsamps; samp++)
+                pre[samp] = minmax (pre[samp-nsamps], row[samp], dilate);
+        }
+    }
+
+    /* Compute the running suffix from the last line up */
+    for (i = ksize - 2; i >= 0; i--)
+    {
+        suf = &suffix[(long) i * nsamps];
+        for (samp = 0; samp < nsamps; samp++)
+            suf[samp] = minmax (suf[samp], suf[samp+nsamps], dilate);
+    }
+}
+
+
+/******************************************************************************
+MODULE:  morph_pass (static)
+
+PURPOSE:  Erodes or dilates the mask in place with a square structuring
+element.
+
+RETURN VALUE:
+Type = None
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+---------     ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. The element is separable, so each line is run through the horizontal
+     pass as it is loaded for the vertical pass.  Both passes use the van
+     Herk/Gil-Werman running min/max.
+  2. The output lines are processed in blocks of ksize lines.  The window
+     for each output line is the suffix of the current block of input lines
+     and the prefix of the next block.  The next block is loaded before the
+     current block of output lines is written, and every input line loaded
+     after that is below the lines being written, so the mask can be
+     processed in place.
+  3. If buffer_dist is not negative, the first pass of the buffer distance
+     transform is run on each output line once it is written.
+******************************************************************************/
+static void morph_pass
+(
+    uint8 *mask,        /* I/O: mask to be eroded or dilated */
+    int nlines,         /* I: number of lines in the mask */
+    int anchor,         /* I: anchor of the structuring element */
+    bool dilate,        /* I: dilate (true) or erode (false) */
+    int buffer_dist,    /* I: buffer distance for the fused distance
+                              transform; negative for none */
+    Morph_work_t *work  /* I/O: work space */
+)
+{
+    int ksize = work->ksize;    /* size of the structuring element */
+    int nsamps = work->nsamps;  /* number of samples in the lines */
+    int block;          /* first output line of the current block */
+    int line;           /* current output line */
+    int i;              /* line within the current block */
+    int samp;           /* looping variable for the samples */
+    uint8 *tmp = NULL;  /* temporary pointer for swapping blocks */
+    uint8 *out = NULL;  /* current output line */
+    uint8 *suf = NULL;  /* suffix values for the current output line */
+    uint8 *pre = NULL;  /* prefix values for the current output line */
+
+    /* Load the first block of input lines.  The window for output line 0
+       starts at line -anchor. */
+    load_block (mask, nlines, -anchor, anchor, dilate, work,
+        work->next_prefix, work->cur_suffix);
+
+    for (block = 0; block < nlines; block += ksize)
+    {
+        /* Load the next block of input lines */
+        load_block (mask, nlines, block + ksize - anchor, anchor, dilate,
+            work, work->next_prefix, work->next_suffix);
+
+        /* Write the output lines for the current block */
+        for (i = 0; i < ksize && block + i < nlines; i++)
+        {
+            line = block + i;
+            out = &mask[(long) line * nsamps];
+            suf = &work->cur_suffix[(long) i * nsamps];
+            if (i == 0)
+                memcpy (out, suf, nsamps * sizeof (uint8));
+            else
+            {
+                pre = &work->next_prefix[(long) (i - 1) * nsamps];
+                for (samp = 0; samp < nsamps; samp++)
+                    out[samp] = minmax (suf[samp], pre[samp], dilate);
+            }
+
+            if (buffer_dist >= 0)
+                buffer_dist_line (out, (line > 0) ? out - nsamps : NULL,
+                    nsamps, buffer_dist, out);
+        }
+
+        /* The next block becomes the current block */
+        tmp = work->cur_suffix;
+        work->cur_suffix = work->next_suffix;
+        work->next_suffix = tmp;
+    }
+}
+
+
+/******************************************************************************
+MODULE:  morph_buffer_mask
+
+PURPOSE:  Erodes and then dilates the mask in place with a square structuring
+element, and then buffers the non-zero pixels by the specified distance.
+
+RETURN VALUE:
+Type = short
+Value          Description
+-----          -----------
+ERROR          Error occurred processing the mask
+SUCCESS        Successful completion
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+---------     ---------------  -------------------------------------
+10/14/2026    agent            Original Development, replacing the OpenCV
+                               erosion and dilation
+
+NOTES:
+  1. The mask is a 1D array of size nlines * nsamps.
+  2. The element covers samples samp-anchor through samp-anchor+ksize-1 (and
+     likewise for the lines), the same as an OpenCV rectangular element with
+     the anchor at (anchor, anchor).  Pixels outside the mask are ignored,
+     as they are by the OpenCV erode and dilate with the default border.
+  3. Iterating a 3x3 element n times is the same as one pass with a
+     (2n+1)x(2n+1) element anchored at the center.
+  4. The first pass of the buffer distance transform is fused with the
+     dilation, so the buffering only needs one more pass over the mask.
+     This requires a single non-zero value in the mask, which is the case
+     for the revised cloud masks.  Other masks are buffered separately via
+     buffer.
+******************************************************************************/
+short morph_buffer_mask
+(
+    uint8 *mask,        /* I/O: mask to be processed */
+    int nlines,         /* I: number of lines in the mask */
+    int nsamps,         /* I: number of samples in the mask */
+    int ksize,          /* I: size of the (square) structuring element */
+    int anchor,         /* I: anchor of the structuring element; between 0
+                              and ksize-1 */
+    int distance        /* I: distance to buffer */
+)
+{
+    char FUNC_NAME[] = "morph_buffer_mask";   /* function name */
+    char errmsg[STR_SIZE];    /* error message */
+    int line;           /* current line being processed */
+    long pix;           /* current pixel being processed */
+    long npix;          /* number of pixels in the mask */
+    long npad;          /* size of the padded line work space */
+    bool single = true; /* does the mask have a single non-zero value */
+    uint8 value = 0;    /* non-zero value of the mask */
+    uint8 *below = NULL;  /* distances for the line below in the second pass
+                             of the distance transform */
+    Morph_work_t work;  /* work space for the morphology passes */
+
+    if (ksize < 1 || anchor < 0 || anchor >= ksize)
+    {
+        sprintf (errmsg, "Invalid structuring element size %d and anchor %d",
+            ksize, anchor);
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+    if (distance < 0 || distance > 254)
+    {
+        sprintf (errmsg, "Buffer distance %d is not supported; must be "
+            "between 0 and 254", distance);
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+
+    /* Find the non-zero value of the mask */
+    npix = (long) nlines * nsamps;
+    for (pix = 0; pix < npix; pix++)
+    {
+        if (mask[pix] == 0)
+            continue;
+        if (value == 0)
+            value = mask[pix];
+        else if (mask[pix] != value)
+        {
+            single = false;
+            break;
+        }
+    }
+
+    /* Allocate the work space */
+    work.ksize = ksize;
+    work.nsamps = nsamps;
+    npad = nsamps + 2 * ksize;
+    work.pad = malloc (npad * sizeof (uint8));
+    work.prefix = malloc (npad * sizeof (uint8));
+    work.suffix = malloc (npad * sizeof (uint8));
+    work.cur_suffix = malloc ((long) ksize * nsamps * sizeof (uint8));
+    work.next_prefix = malloc ((long) ksize * nsamps * sizeof (uint8));
+    work.next_suffix = malloc ((long) ksize * nsamps * sizeof (uint8));
+    below = malloc (nsamps * sizeof (uint8));
+    if (work.pad == NULL || work.prefix == NULL || work.suffix == NULL ||
+        work.cur_suffix == NULL ||
+        work.next_prefix == NULL || work.next_suffix == NULL || below == NULL)
+    {
+        strcpy (errmsg, "Error allocating memory for the morphology work "
+            "space.");
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+
+    /* Erode and then dilate the mask.  If the mask has a single value then
+       run the first pass of the buffering along with the dilation. */
+    morph_pass (mask, nlines, anchor, false, -1, &work);
+    morph_pass (mask, nlines, anchor, true, single ? distance : -1, &work);
+
+    if (single)
+    {
+        /* Second pass of the buffering, up and to the left */
+        memset (below, distance + 1, nsamps * sizeof (uint8));
+        for (line = nlines - 1; line >= 0; line--)
+            buffer_mark_line (&mask[(long) line * nsamps], below, nsamps,
+                distance, value);
+    }
+    else
+    {
+        /* Buffer the mask separately */
+        if (buffer (mask, distance, nlines, nsamps, mask) != SUCCESS)
+        {
+            sprintf (errmsg, "Error buffering the mask");
+            error_handler (true, FUNC_NAME, errmsg);
+            return (ERROR);
+        }
+    }
+
+    /* Free the work space */
+    free (work.pad);
+    free (work.prefix);
+    free (work.suffix);
+    free (work.cur_suffix);
+    free (work.next_prefix);
+    free (work.next_suffix);
+    free (below);
+
+    return (SUCCESS);
+}
@@ -1,5 +1,9 @@
+#define _GNU_SOURCE        /* for O_DIRECT */
 #include <time.h>
 #include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
 #include "output.h"
 
 
@@ -24,21 +28,45 @@ Date         Programmer       Reason
 ---------    ---------------  -------------------------------------
 5/19/2014    Gail Schmidt     Original Development (based on input routines
                               from the spectral indices application)
+10/14/2026   agent            Only create the bands flagged in write_band
+10/14/2026   agent            Set up a buffered writer for each band
+10/14/2026   agent            Size the bands for the whole scene if the input
+                              is a window
+10/14/2026   agent            Open the band files without truncating them if
+                              they are shared by the shards of the scene
 
 NOTES:
   1. Don't allocate space for buf, since pointers to existing buffers will
      be assigned in the output structure.
+  2. The file pointers stay indexed by Mycm_list_t.  band_indx maps each
+     band to its entry in the metadata band array, which only holds the
+     bands being output.
+  3. For OUT_WRITE_DIRECT a second descriptor is opened on each band file
+     with O_DIRECT.  If the file system doesn't support O_DIRECT, a warning
+     is printed and the band is written with OUT_WRITE_DONTNEED instead.
+  4. The bands always cover the whole scene, so they match the grid of the
+     XML file they are appended to.  Use set_output_window to write only a
+     window of the scene.
+  5. With shared, the band files are created if they don't exist, but
+     aren't truncated, so the processes for the other shards can write their
+     lines to the same files at the same time.  Each process writes its own
+     lines with pwrite, so the lines don't overlap.
 ******************************************************************************/
 Output_t *open_output
 (
     Espa_internal_meta_t *in_meta,  /* I: input metadata structure */
     Input_t *input,                 /* I: input reflectance band data */
-    int nband,                      /* I: number of bands to be created */
+    int nband,                      /* I: number of possible bands */
+    bool *write_band,               /* I: array of nband flags specifying
+                                          which bands are to be created */
     char short_names[][STR_SIZE],   /* I: array of short names for new bands */
     char long_names[][STR_SIZE],    /* I: array of long names for new bands */
     char data_units[][STR_SIZE],    /* I: array of data units for new bands */
-    bool toa         /* I: are we processing TOA reflectance data, otherwise
+    bool toa,        /* I: are we processing TOA reflectance data, otherwise
                            process surface reflectance data */
+    Out_write_mode_t write_mode, /* I: how the output bands are written */
+    bool shared      /* I: are the band files shared with the processes
+                           writing the other shards of the scene? */
 )
 {
     Output_t *this = NULL;
@@ -51,10 +79,13 @@ Output_t *open_output
     time_t tp;                   /* time structure */
     struct tm *tm = NULL;        /* time structure for UTC time */
     int ib;    /* looping variable for bands */
+    int im;    /* index of the current band in the metadata band array */
+    int fd;    /* descriptor of a shared band file */
     int refl_indx = -1;          /* band index in XML file for the reflectance
                                     band */
     Espa_band_meta_t *bmeta = NULL;  /* pointer to the band metadata array
                                         within the output structure */
+    Out_writer_t *wr = NULL;     /* pointer to the writer for the band */
 
     /* Check parameters */
     if (nband < 1 || nband > MAX_OUT_BANDS)
@@ -101,8 +132,18 @@ Output_t *open_output
        and used later for appending to the original XML file. */
     init_metadata_struct (&this->metadata);
 
-    /* Allocate memory for the total bands */
-    if (allocate_band_metadata (&this->metadata, nband) != SUCCESS)
+    /* Allocate memory for the bands being output */
+    this->nband_out = 0;
+    for (ib = 0; ib < nband; ib++)
+        if (write_band[ib])
+            this->nband_out++;
+    if (this->nband_out < 1)
+    {
+        sprintf (errmsg, "No output bands were selected");
+        error_handler (true, FUNC_NAME, errmsg);
+        return (NULL);
+    }
+    if (allocate_band_metadata (&this->metadata, this->nband_out) != SUCCESS)
     {
         sprintf (errmsg, "Allocating band metadata.");
         error_handler (true, FUNC_NAME, errmsg);
@@ -142,45 +183,62 @@ Output_t *open_output
     /* Populate the data structure */
     this->open = false;
     this->nband = nband;
-    this->nlines = input->nlines;
-    this->nsamps = input->nsamps;
+    this->nlines = input->scene_nlines;
+    this->nsamps = input->scene_nsamps;
+    this->write_mode = write_mode;
+    this->shared = shared;
+    this->window.nlines = 0;
     for (ib = 0; ib < this->nband; ib++)
+    {
+        this->win_line[ib] = NULL;
+        this->tiled[ib] = NULL;
         this->fp_bin[ib] = NULL;
+        this->band_indx[ib] = -1;
+        memset (&this->writer[ib], 0, sizeof (Out_writer_t));
+        this->writer[ib].fd = -1;
+        this->writer[ib].direct_fd = -1;
+    }
  
+    im = 0;
     for (ib = 0; ib < nband; ib++)
     {
-        strncpy (bmeta[ib].short_name, in_meta->band[refl_indx].short_name, 3);
-        bmeta[ib].short_name[3] = '\0';
+        /* Skip the bands which aren't being output */
+        if (!write_band[ib])
+            continue;
+        this->band_indx[ib] = im;
+
+        strncpy (bmeta[im].short_name, in_meta->band[refl_indx].short_name, 3);
+        bmeta[im].short_name[3] = '\0';
         upper_str = upper_case_str (short_names[ib]);
-        strcat (bmeta[ib].short_name, upper_str);
-        strcpy (bmeta[ib].product, "revised_cloud_mask");
+        strcat (bmeta[im].short_name, upper_str);
+        strcpy (bmeta[im].product, "revised_cloud_mask");
         if (toa)
-            strcpy (bmeta[ib].source, "toa_refl");
+            strcpy (bmeta[im].source, "toa_refl");
         else
-            strcpy (bmeta[ib].source, "sr_refl");
-        strcpy (bmeta[ib].category, "index");
-        bmeta[ib].nlines = this->nlines;
-        bmeta[ib].nsamps = this->nsamps;
-        bmeta[ib].pixel_size[0] = input->pixsize[0];
-        bmeta[ib].pixel_size[1] = input->pixsize[1];
-        strcpy (bmeta[ib].pixel_units, "meters");
-        sprintf (bmeta[ib].app_version, "revised_cloud_mask_%s",
+            strcpy (bmeta[im].source, "sr_refl");
+        strcpy (bmeta[im].category, "index");
+        bmeta[im].nlines = this->nlines;
+        bmeta[im].nsamps = this->nsamps;
+        bmeta[im].pixel_size[0] = input->pixsize[0];
+        bmeta[im].pixel_size[1] = input->pixsize[1];
+        strcpy (bmeta[im].pixel_units, "meters");
+        sprintf (bmeta[im].app_version, "revised_cloud_mask_%s",
             CLOUD_MASK_VERSION);
-        strcpy (bmeta[ib].production_date, production_date);
-        strcpy (bmeta[ib].name, short_names[ib]);
-        strcpy (bmeta[ib].long_name, long_names[ib]);
-        strcpy (bmeta[ib].data_units, data_units[ib]);
+        strcpy (bmeta[im].production_date, production_date);
+        strcpy (bmeta[im].name, short_names[ib]);
+        strcpy (bmeta[im].long_name, long_names[ib]);
+        strcpy (bmeta[im].data_units, data_units[ib]);
 
         /* Handle the cloud mask bands differently */
         if (ib == REVISED_CM || ib == REVISED_LIM_CM)
         {
-            bmeta[ib].data_type = ESPA_UINT8;
-            bmeta[ib].fill_value = CFMASK_FILL_VALUE;
-            bmeta[ib].valid_range[0] = 0;
-            bmeta[ib].valid_range[1] = 4;
+            bmeta[im].data_type = ESPA_UINT8;
+            bmeta[im].fill_value = CFMASK_FILL_VALUE;
+            bmeta[im].valid_range[0] = 0;
+            bmeta[im].valid_range[1] = 4;
 
             /* Set up class values information */
-            if (allocate_class_metadata (&bmeta[ib], 2) != SUCCESS)
+            if (allocate_class_metadata (&bmeta[im], 2) != SUCCESS)
             {
                 sprintf (errmsg, "Allocating cfmask classes.");
                 error_handler (true, FUNC_NAME, errmsg);
@@ -188,41 +246,79 @@ Output_t *open_output
             }
           
             /* Identify the class values for the mask */
-            bmeta[ib].class_values[0].class = 0;
-            bmeta[ib].class_values[1].class = 4;
-            strcpy (bmeta[ib].class_values[0].description, "clear");
-            strcpy (bmeta[ib].class_values[1].description, "cloud");
+            bmeta[im].class_values[0].class = 0;
+            bmeta[im].class_values[1].class = 4;
+            strcpy (bmeta[im].class_values[0].description, "clear");
+            strcpy (bmeta[im].class_values[1].description, "cloud");
         }
         else if (ib >= VARIANCE_B1 && ib <= VARIANCE_B7)
         {
-            bmeta[ib].data_type = ESPA_FLOAT32;
-            bmeta[ib].fill_value = FILL_VALUE;
+            bmeta[im].data_type = ESPA_FLOAT32;
+            bmeta[im].fill_value = FILL_VALUE;
         }
         else if (ib == VARIANCE_NDVI || ib == VARIANCE_NDSI)
         {
-            bmeta[ib].data_type = ESPA_FLOAT32;
-            bmeta[ib].fill_value = FILL_VALUE;
+            bmeta[im].data_type = ESPA_FLOAT32;
+            bmeta[im].fill_value = FILL_VALUE;
         }
         else if (ib == CM_NDVI || ib == CM_NDSI)
         {
-            bmeta[ib].data_type = ESPA_FLOAT32;
-            bmeta[ib].fill_value = FILL_VALUE;
+            bmeta[im].data_type = ESPA_FLOAT32;
+            bmeta[im].fill_value = FILL_VALUE;
         }
 
         /* Set up the filename with the scene name and band name and open the
-           file for read/write access */
-        sprintf (bmeta[ib].file_name, "%s_%s.img", scene_name, bmeta[ib].name);
-        this->fp_bin[ib] = open_raw_binary (bmeta[ib].file_name, "w+");
+           file for read/write access.  Shared files are left as they are, so
+           the lines of the other shards aren't lost. */
+        sprintf (bmeta[im].file_name, "%s_%s.img", scene_name, bmeta[im].name);
+        if (shared)
+        {
+            fd = open (bmeta[im].file_name, O_RDWR | O_CREAT, 0644);
+            this->fp_bin[ib] = (fd == -1) ? NULL : fdopen (fd, "r+");
+            if (fd != -1 && this->fp_bin[ib] == NULL)
+                close (fd);
+        }
+        else
+            this->fp_bin[ib] = open_raw_binary (bmeta[im].file_name, "w+");
         if (this->fp_bin[ib] == NULL)
         {
-            sprintf (errmsg, "Unable to open output band %d file: %s", ib,
-                bmeta[ib].file_name);
+            snprintf (errmsg, sizeof (errmsg),
+                "Unable to open output band %d file: %.*s", ib,
+                (int) (sizeof (errmsg) / 2), bmeta[im].file_name);
             error_handler (true, FUNC_NAME, errmsg);
             return (NULL);
         }
 
+        /* Set up the writer for the band */
+        wr = &this->writer[ib];
+        wr->fd = fileno (this->fp_bin[ib]);
+        if (posix_memalign ((void **) &wr->buf, OUT_WBUF_ALIGN,
+            OUT_WBUF_SIZE) != 0)
+        {
+            wr->buf = NULL;
+            sprintf (errmsg, "Allocating the write buffer for output band %d",
+                ib);
+            error_handler (true, FUNC_NAME, errmsg);
+            return (NULL);
+        }
+
+        if (write_mode == OUT_WRITE_DIRECT)
+        {
+            wr->direct_fd = open (bmeta[im].file_name, O_WRONLY | O_DIRECT);
+            if (wr->direct_fd == -1)
+            {
+                snprintf (errmsg, sizeof (errmsg),
+                    "Unable to open output band file %.*s with "
+                    "O_DIRECT (%s).  Dropping the written blocks from the "
+                    "page cache instead.", (int) (sizeof (errmsg) / 2),
+                    bmeta[im].file_name, strerror (errno));
+                error_handler (false, FUNC_NAME, errmsg);
+            }
+        }
+
         /* Free the memory for the upper-case string */
         free (upper_str);
+        im++;
     }  /* for ib */
     this->open = true;
 
@@ -253,8 +349,13 @@ Date         Programmer       Reason
                               from the LEDAPS lndsr application)
 2/14/2014    Gail Schmidt     Modified to work with ESPA internal raw binary
                               file format
+10/14/2026   agent            Flush and free the write buffers
+10/14/2026   agent            Free the window lines
+10/14/2026   agent            Finish and free the tiled output files
 
 NOTES:
+  1. The files are still closed if flushing a write buffer fails, but ERROR
+     is returned.  The same goes for finishing a tiled output file.
 ******************************************************************************/
 int close_output
 (
@@ -264,6 +365,8 @@ int close_output
     char FUNC_NAME[] = "close_output";   /* function name */
     char errmsg[STR_SIZE];    /* error message */
     int ib;                   /* looping variable */
+    int retval = SUCCESS;     /* return status */
+    Out_writer_t *wr = NULL;  /* pointer to the writer for the band */
 
     if (!this->open)
     {
@@ -272,12 +375,48 @@ int close_output
         return (ERROR);
     }
 
-    /* Close raw binary products */
+    /* Flush the write buffers and close raw binary products */
     for (ib = 0; ib < this->nband; ib++)
-        close_raw_binary (this->fp_bin[ib]);
+    {
+        wr = &this->writer[ib];
+        if (this->fp_bin[ib] != NULL)
+        {
+            if (flush_output_band (this, ib) != SUCCESS)
+            {
+                sprintf (errmsg, "Flushing the write buffer for band %d", ib);
+                error_handler (true, FUNC_NAME, errmsg);
+                retval = ERROR;
+            }
+            if (this->write_mode != OUT_WRITE_CACHED && wr->advise_len > 0)
+                posix_fadvise (wr->fd, wr->advise_start, wr->advise_len,
+                    POSIX_FADV_DONTNEED);
+            close_raw_binary (this->fp_bin[ib]);
+        }
+        this->fp_bin[ib] = NULL;
+
+        if (wr->direct_fd != -1)
+            close (wr->direct_fd);
+        wr->direct_fd = -1;
+        wr->fd = -1;
+        free (wr->buf);
+        wr->buf = NULL;
+        free (this->win_line[ib]);
+        this->win_line[ib] = NULL;
+
+        if (this->tiled[ib] != NULL &&
+            close_tiled_output (this->tiled[ib]) != SUCCESS)
+        {
+            sprintf (errmsg, "Finishing the tiled output file for band %d",
+                ib);
+            error_handler (true, FUNC_NAME, errmsg);
+            retval = ERROR;
+        }
+        free_tiled_output (this->tiled[ib]);
+        this->tiled[ib] = NULL;
+    }
     this->open = false;
 
-    return (SUCCESS);
+    return (retval);
 }
 
 
@@ -325,8 +464,12 @@ int free_output
     if (this != NULL)
     {
         /* Free the band data */
-        free (this->metadata.band[REVISED_CM].class_values);
-        free (this->metadata.band[REVISED_LIM_CM].class_values);
+        if (this->band_indx[REVISED_CM] != -1)
+            free (this->metadata.band[this->band_indx[REVISED_CM]].
+                class_values);
+        if (this->band_indx[REVISED_LIM_CM] != -1)
+            free (this->metadata.band[this->band_indx[REVISED_LIM_CM]].
+                class_values);
         free (this->metadata.band);
 
         /* Free the data structure */
@@ -337,6 +480,282 @@ int free_output
 }
 
 
+/******************************************************************************
+MODULE:  buffer_output_bytes (static)
+
+PURPOSE:  Copies bytes for a location in a band file to the write buffer of
+the band, flushing the buffer as needed.
+
+RETURN VALUE:
+Type = int
+Value      Description
+-----      -----------
+ERROR      Error occurred flushing the write buffer
+SUCCESS    Successful completion
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development (pulled from
+                               put_output_lines)
+
+NOTES:
+  1. The buffer is flushed first if the bytes don't follow the bytes already
+     held in it.
+******************************************************************************/
+static int buffer_output_bytes
+(
+    Output_t *this,    /* I/O: Output data structure */
+    int iband,         /* I: band to be written (0-based) */
+    off_t loc,         /* I: location in the band file of the bytes */
+    char *src,         /* I: bytes to be written */
+    size_t nleft       /* I: number of bytes to be written */
+)
+{
+    size_t ncopy;             /* number of bytes to copy to the buffer */
+    Out_writer_t *wr = &this->writer[iband];  /* writer for the band */
+
+    /* Flush the buffer if these bytes don't follow the bytes already in it */
+    if (wr->len > 0 && loc != wr->start + (off_t) wr->len)
+    {
+        if (flush_output_band (this, iband) != SUCCESS)
+            return (ERROR);
+    }
+
+    /* Copy the bytes to the buffer, flushing it each time it fills up */
+    while (nleft > 0)
+    {
+        if (wr->len == 0)
+            wr->start = loc;
+        ncopy = OUT_WBUF_SIZE - wr->len;
+        if (ncopy > nleft)
+            ncopy = nleft;
+        memcpy (&wr->buf[wr->len], src, ncopy);
+        wr->len += ncopy;
+        src += ncopy;
+        loc += ncopy;
+        nleft -= ncopy;
+
+        if (wr->len == OUT_WBUF_SIZE)
+        {
+            if (flush_output_band (this, iband) != SUCCESS)
+                return (ERROR);
+        }
+    }
+
+    return (SUCCESS);
+}
+
+
+/******************************************************************************
+MODULE:  set_output_window
+
+PURPOSE:  Sets up the output bands so only a window of the scene is written
+from the lines passed to put_output_lines, and writes fill to the rest of the
+scene.
+
+RETURN VALUE:
+Type = int
+Value      Description
+-----      -----------
+ERROR      Error occurred setting up the window
+SUCCESS    Successful completion
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+10/14/2026    agent            Leave the lines outside the window alone for
+                               shared band files
+
+NOTES:
+  1. proc is the part of the scene covered by the lines passed to
+     put_output_lines, which is the window plus the halo processed around
+     it.  Both proc and window are in lines and samples of the scene.
+  2. The lines of the scene outside the window are written as fill here,
+     unless the band files are shared by the shards of the scene, in which
+     case those lines belong to the other shards.  The samples outside the
+     window, in the lines of the window, are filled when those lines are
+     written.
+******************************************************************************/
+int set_output_window
+(
+    Output_t *this,         /* I/O: Output data structure */
+    Img_window_t *proc,     /* I: part of the scene in the lines passed to
+                                  put_output_lines */
+    Img_window_t *window    /* I: window of the scene to be written */
+)
+{
+    char FUNC_NAME[] = "set_output_window";   /* function name */
+    char errmsg[STR_SIZE];    /* error message */
+    int ib;                   /* looping variable for bands */
+    int line;                 /* looping variable for lines */
+    int samp;                 /* looping variable for samples */
+    int nbytes;               /* number of bytes per pixel in the band */
+    Espa_band_meta_t *bmeta = NULL;  /* metadata for the current band */
+
+    if (window->line0 < proc->line0 || window->samp0 < proc->samp0 ||
+        window->line0 + window->nlines > proc->line0 + proc->nlines ||
+        window->samp0 + window->nsamps > proc->samp0 + proc->nsamps ||
+        proc->line0 + proc->nlines > this->nlines ||
+        proc->samp0 + proc->nsamps > this->nsamps)
+    {
+        sprintf (errmsg, "Output window is not within the processed lines "
+            "and samples of the scene");
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+    this->proc = *proc;
+    this->window = *window;
+
+    for (ib = 0; ib < this->nband; ib++)
+    {
+        if (this->fp_bin[ib] == NULL)
+            continue;
+
+        /* Set up a line of fill for the band */
+        bmeta = &this->metadata.band[this->band_indx[ib]];
+        nbytes = (bmeta->data_type == ESPA_FLOAT32) ? sizeof (float) :
+            sizeof (uint8);
+        this->win_line[ib] = malloc ((size_t) this->nsamps * nbytes);
+        if (this->win_line[ib] == NULL)
+        {
+            sprintf (errmsg, "Allocating the window line for band %d", ib);
+            error_handler (true, FUNC_NAME, errmsg);
+            return (ERROR);
+        }
+        if (nbytes == sizeof (float))
+        {
+            for (samp = 0; samp < this->nsamps; samp++)
+                ((float *) this->win_line[ib])[samp] = bmeta->fill_value;
+        }
+        else
+            memset (this->win_line[ib], bmeta->fill_value, this->nsamps);
+
+        /* Write fill to the lines outside the window */
+        for (line = 0; line < this->nlines && !this->shared; line++)
+        {
+            if (line == window->line0)
+                line += window->nlines - 1;
+            else if (buffer_output_bytes (this, ib, (off_t) line *
+                this->nsamps * nbytes, this->win_line[ib],
+                (size_t) this->nsamps * nbytes) != SUCCESS)
+            {
+                sprintf (errmsg, "Writing fill to line %d of band %d", line,
+                    ib);
+                error_handler (true, FUNC_NAME, errmsg);
+                return (ERROR);
+            }
+        }
+    }
+
+    return (SUCCESS);
+}
+
+
+/******************************************************************************
+MODULE:  open_output_tiles
+
+PURPOSE:  Creates a tiled output file for each of the output bands, so the
+lines written to the band files are also written as tiles with overviews.
+
+RETURN VALUE:
+Type = int
+Value      Description
+-----      -----------
+ERROR      Error creating the tiled output files
+SUCCESS    Successful completion
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. The tiled output file for each band is named after the band file, with
+     .tile in place of .img.  See tiled_output.h for the layout of the
+     files.
+  2. If a window was set with set_output_window, this must be called after
+     it.  The tiles only cover the window, rather than the whole scene as
+     the band files do, and their UL corner is that of the window.
+  3. The tiles are written by put_output_lines and the files are finished
+     by close_output, so the lines of each band must be written in order.
+******************************************************************************/
+int open_output_tiles
+(
+    Output_t *this,      /* I/O: Output data structure */
+    double ul_corner[2]  /* I: map x and y of the UL corner of the scene */
+)
+{
+    char FUNC_NAME[] = "open_output_tiles";   /* function name */
+    char errmsg[STR_SIZE];       /* error message */
+    char tile_file[STR_SIZE];    /* name of the tiled output file */
+    char *cptr = NULL;           /* extension of the band file */
+    int ib;                      /* looping variable for bands */
+    int base_len;                /* length of the band file name without its
+                                    extension */
+    int nlines = this->nlines;   /* number of lines in the tiles */
+    int nsamps = this->nsamps;   /* number of samples in the tiles */
+    int nbytes;                  /* number of bytes per pixel */
+    double tile_ul[2];           /* UL corner of the tiles */
+    Espa_band_meta_t *bmeta = NULL;  /* metadata for the band */
+
+    for (ib = 0; ib < this->nband; ib++)
+    {
+        if (this->band_indx[ib] == -1)
+            continue;
+        bmeta = &this->metadata.band[this->band_indx[ib]];
+
+        tile_ul[0] = ul_corner[0];
+        tile_ul[1] = ul_corner[1];
+        if (this->window.nlines > 0)
+        {
+            nlines = this->window.nlines;
+            nsamps = this->window.nsamps;
+            tile_ul[0] += this->window.samp0 * bmeta->pixel_size[0];
+            tile_ul[1] -= this->window.line0 * bmeta->pixel_size[1];
+        }
+
+        cptr = strrchr (bmeta->file_name, '.');
+        base_len = (cptr != NULL && strchr (cptr, '/') == NULL) ?
+            (int) (cptr - bmeta->file_name) : (int) strlen (bmeta->file_name);
+        if (snprintf (tile_file, STR_SIZE, "%.*s.tile", base_len,
+            bmeta->file_name) >= STR_SIZE)
+        {
+            snprintf (errmsg, sizeof (errmsg),
+                "Tiled output file name for band %.*s is too long",
+                (int) (sizeof (errmsg) / 2), bmeta->name);
+            error_handler (true, FUNC_NAME, errmsg);
+            return (ERROR);
+        }
+        nbytes = (bmeta->data_type == ESPA_UINT8) ? sizeof (uint8) :
+            sizeof (float);
+
+        this->tiled[ib] = open_tiled_output (tile_file, nlines, nsamps,
+            nbytes, tile_ul, bmeta->pixel_size);
+        if (this->tiled[ib] == NULL)
+        {
+            snprintf (errmsg, sizeof (errmsg),
+                "Error creating the tiled output file %.*s",
+                (int) (sizeof (errmsg) / 2), tile_file);
+            error_handler (true, FUNC_NAME, errmsg);
+            return (ERROR);
+        }
+    }
+
+    return (SUCCESS);
+}
+
+
 /******************************************************************************
 MODULE:  put_output_lines
 
@@ -357,8 +776,20 @@ Date         Programmer       Reason
 ---------    ---------------  -------------------------------------
 5/19/2014    Gail Schmidt     Original Development (based on input routines
                               from the spectral indices application)
+10/14/2026   agent            Gather the lines in the band's write buffer
+10/14/2026   agent            Only write the output window, if one was set
+10/14/2026   agent            Also write the lines to the tiled output file
 
 NOTES:
+  1. The lines are copied to the write buffer for the band, which is flushed
+     when it is full or when lines are written which don't follow the lines
+     already held in it.  The lines aren't in the file until the buffer is
+     flushed by flush_output_band, get_output_lines, or close_output.
+  2. If a window was set with set_output_window, iline and nlines are lines
+     of the processed part of the scene and buf holds lines of its width.
+     Only the part of the lines within the window is written.
+  3. If the band has a tiled output file, the lines must be written in
+     order.
 ******************************************************************************/
 int put_output_lines
 (
@@ -373,7 +804,9 @@ int put_output_lines
 {
     char FUNC_NAME[] = "put_output_lines";   /* function name */
     char errmsg[STR_SIZE];    /* error message */
-    long loc;                 /* current location in the output file */
+    int line;                 /* line of the scene being written */
+    int in_nlines;            /* number of lines in the image in buf */
+    char *src = (char *) buf; /* current location in the input buffer */
   
     /* Check the parameters */
     if (this == (Output_t *)NULL) 
@@ -394,43 +827,283 @@ int put_output_lines
         error_handler (true, FUNC_NAME, errmsg);
         return (ERROR);
     }
-    if (iline < 0 || iline >= this->nlines)
+    if (this->fp_bin[iband] == NULL)
+    {
+        sprintf (errmsg, "Band %d is not being output.", iband);
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+    in_nlines = (this->window.nlines > 0) ? this->proc.nlines : this->nlines;
+    if (iline < 0 || iline >= in_nlines)
     {
         sprintf (errmsg, "Invalid line number.");
         error_handler (true, FUNC_NAME, errmsg);
         return (ERROR);
     }
-    if (nlines < 0 || iline+nlines > this->nlines)
+    if (nlines < 0 || iline+nlines > in_nlines)
     {
         sprintf (errmsg, "Line plus number of lines to be written exceeds "
             "the predefined size of the image.");
         error_handler (true, FUNC_NAME, errmsg);
         return (ERROR);
     }
-  
-    /* Write the data, but first seek to the correct line */
-    loc = (long) iline * this->nsamps * nbytes;
-    if (fseek (this->fp_bin[iband], loc, SEEK_SET))
+
+    /* Without a window, the lines go to the buffer as they are */
+    if (this->window.nlines == 0)
     {
-        sprintf (errmsg, "Seeking to the current line in the output file for "
-            "band %d", iband);
-        error_handler (true, FUNC_NAME, errmsg);
-        return (ERROR);
+        if (buffer_output_bytes (this, iband, (off_t) iline * this->nsamps *
+            nbytes, src, (size_t) nlines * this->nsamps * nbytes) != SUCCESS)
+        {
+            sprintf (errmsg, "Error writing the output line(s) for band %d.",
+                iband);
+            error_handler (true, FUNC_NAME, errmsg);
+            return (ERROR);
+        }
+        if (this->tiled[iband] != NULL &&
+            put_tiled_output_lines (this->tiled[iband], src, iline, nlines)
+            != SUCCESS)
+        {
+            sprintf (errmsg, "Error writing the tiled output line(s) for band "
+                "%d.", iband);
+            error_handler (true, FUNC_NAME, errmsg);
+            return (ERROR);
+        }
+        return (SUCCESS);
     }
 
-    if (write_raw_binary (this->fp_bin[iband], nlines, this->nsamps, nbytes,
-        buf) != SUCCESS)
+    /* Otherwise copy the window part of each line within the window to the
+       line of fill for the band, and write that line of the scene */
+    for (line = this->proc.line0 + iline;
+         line < this->proc.line0 + iline + nlines;
+         line++, src += (size_t) this->proc.nsamps * nbytes)
+    {
+        if (line < this->window.line0 ||
+            line >= this->window.line0 + this->window.nlines)
+            continue;
+
+        memcpy (&this->win_line[iband][(size_t) this->window.samp0 * nbytes],
+            &src[(size_t) (this->window.samp0 - this->proc.samp0) * nbytes],
+            (size_t) this->window.nsamps * nbytes);
+        if (buffer_output_bytes (this, iband, (off_t) line * this->nsamps *
+            nbytes, this->win_line[iband], (size_t) this->nsamps * nbytes)
+            != SUCCESS)
+        {
+            sprintf (errmsg, "Error writing the output line(s) for band %d.",
+                iband);
+            error_handler (true, FUNC_NAME, errmsg);
+            return (ERROR);
+        }
+        if (this->tiled[iband] != NULL &&
+            put_tiled_output_lines (this->tiled[iband],
+            &this->win_line[iband][(size_t) this->window.samp0 * nbytes],
+            line - this->window.line0, 1) != SUCCESS)
+        {
+            sprintf (errmsg, "Error writing the tiled output line(s) for band "
+                "%d.", iband);
+            error_handler (true, FUNC_NAME, errmsg);
+            return (ERROR);
+        }
+    }
+    
+    return (SUCCESS);
+}
+
+
+/******************************************************************************
+MODULE:  pwrite_block (static)
+
+PURPOSE:  Writes a block of bytes to the specified location in a file,
+retrying until the whole block is written.
+
+RETURN VALUE:
+Type = int
+Value      Description
+-----      -----------
+ERROR      Error occurred writing the block
+SUCCESS    Successful completion
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+******************************************************************************/
+static int pwrite_block
+(
+    int fd,          /* I: file descriptor to write to */
+    char *buf,       /* I: block to be written */
+    size_t len,      /* I: number of bytes to write */
+    off_t loc        /* I: location in the file to write the block */
+)
+{
+    ssize_t nwrite;  /* number of bytes written by pwrite */
+
+    while (len > 0)
+    {
+        nwrite = pwrite (fd, buf, len, loc);
+        if (nwrite < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return (ERROR);
+        }
+        buf += nwrite;
+        len -= nwrite;
+        loc += nwrite;
+    }
+
+    return (SUCCESS);
+}
+
+
+/******************************************************************************
+MODULE:  flush_output_band
+
+PURPOSE:  Writes the lines held in the write buffer for the band to the
+output file.
+
+RETURN VALUE:
+Type = int
+Value      Description
+-----      -----------
+ERROR      Error occurred writing the buffer
+SUCCESS    Successful completion
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. With O_DIRECT, the part of the buffer which covers whole aligned blocks
+     of the file is written with the O_DIRECT descriptor, and the rest (the
+     end of the file, or lines which didn't start on an aligned block) is
+     written through the page cache.
+  2. With OUT_WRITE_DONTNEED, or OUT_WRITE_DIRECT without O_DIRECT, the
+     block written by the previous flush is dropped from the page cache.
+     The previous block is used since the kernel can't drop dirty pages, and
+     by now that block has most likely been written back.
+******************************************************************************/
+int flush_output_band
+(
+    Output_t *this,    /* I/O: Output data structure */
+    int iband          /* I: band to be flushed (0-based) */
+)
+{
+    char FUNC_NAME[] = "flush_output_band";   /* function name */
+    char errmsg[STR_SIZE];    /* error message */
+    size_t ndirect = 0;       /* number of bytes written with O_DIRECT */
+    Out_writer_t *wr = NULL;  /* pointer to the writer for the band */
+
+    if (iband < 0 || iband >= this->nband || this->fp_bin[iband] == NULL)
     {
-        sprintf (errmsg, "Error writing the output line(s) for band %d.",
-            iband);
+        sprintf (errmsg, "Band %d is not being output.", iband);
         error_handler (true, FUNC_NAME, errmsg);
         return (ERROR);
     }
-    
+
+    wr = &this->writer[iband];
+    if (wr->len == 0)
+        return (SUCCESS);
+
+    /* Write the aligned blocks with O_DIRECT */
+    if (wr->direct_fd != -1 && wr->start % OUT_WBUF_ALIGN == 0)
+    {
+        ndirect = wr->len - wr->len % OUT_WBUF_ALIGN;
+        if (ndirect > 0)
+        {
+            if (pwrite_block (wr->direct_fd, wr->buf, ndirect, wr->start)
+                != SUCCESS)
+            {
+                sprintf (errmsg, "Writing %ld bytes with O_DIRECT to band %d "
+                    "at offset %ld (%s)", (long) ndirect, iband,
+                    (long) wr->start, strerror (errno));
+                error_handler (true, FUNC_NAME, errmsg);
+                return (ERROR);
+            }
+            wr->ndirect++;
+        }
+    }
+
+    /* Write the rest of the buffer through the page cache */
+    if (ndirect < wr->len)
+    {
+        if (pwrite_block (wr->fd, &wr->buf[ndirect], wr->len - ndirect,
+            wr->start + ndirect) != SUCCESS)
+        {
+            sprintf (errmsg, "Writing %ld bytes to band %d at offset %ld (%s)",
+                (long) (wr->len - ndirect), iband,
+                (long) (wr->start + ndirect), strerror (errno));
+            error_handler (true, FUNC_NAME, errmsg);
+            return (ERROR);
+        }
+
+        /* Drop the previous block from the page cache */
+        if (this->write_mode != OUT_WRITE_CACHED)
+        {
+            if (wr->advise_len > 0)
+                posix_fadvise (wr->fd, wr->advise_start, wr->advise_len,
+                    POSIX_FADV_DONTNEED);
+            wr->advise_start = wr->start + ndirect;
+            wr->advise_len = wr->len - ndirect;
+        }
+    }
+
+    wr->nbytes += wr->len;
+    wr->nflush++;
+    wr->len = 0;
+
     return (SUCCESS);
 }
 
 
+/******************************************************************************
+MODULE:  print_output_stats
+
+PURPOSE:  Prints the number of bytes written and the number of flushes for
+each of the output bands.
+
+RETURN VALUE:
+Type = None
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. Lines still held in the write buffers aren't counted.
+******************************************************************************/
+void print_output_stats
+(
+    Output_t *this     /* I: Output data structure */
+)
+{
+    int ib;                   /* looping variable for bands */
+    Out_writer_t *wr = NULL;  /* pointer to the writer for the band */
+
+    for (ib = 0; ib < this->nband; ib++)
+    {
+        if (this->band_indx[ib] == -1)
+            continue;
+        wr = &this->writer[ib];
+        printf ("    %s: %lld bytes written in %ld flushes (%ld with "
+            "O_DIRECT)\n", this->metadata.band[this->band_indx[ib]].name,
+            wr->nbytes, wr->nflush, wr->ndirect);
+    }
+}
+
+
 /******************************************************************************
 MODULE:  get_output_lines
 
@@ -455,6 +1128,9 @@ Date         Programmer       Reason
 NOTES:
   1. The Output_t data structure needs to be populated and memory allocated
      before calling this routine.  Use open_output to do that.
+  2. The write buffer for the band is flushed first, so any lines written
+     with put_output_lines are read back.
+  3. iline is always a line of the scene, even if an output window was set.
 ******************************************************************************/
 int get_output_lines
 (
@@ -483,6 +1159,12 @@ int get_output_lines
         error_handler (true, FUNC_NAME, errmsg);
         return (ERROR);
     }
+    if (iband < 0 || iband >= this->nband || this->fp_bin[iband] == NULL)
+    {
+        sprintf (errmsg, "Band %d is not being output.", iband);
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
     if (iline < 0 || iline >= this->nlines)
     {
         strcpy (errmsg, "Invalid line number for cfmask band");
@@ -490,6 +1172,14 @@ int get_output_lines
         return (ERROR);
     }
   
+    /* Flush the lines still held in the write buffer */
+    if (flush_output_band (this, iband) != SUCCESS)
+    {
+        sprintf (errmsg, "Flushing the write buffer for band %d", iband);
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+
     /* Read the data, but first seek to the correct line */
     loc = (long) iline * this->nsamps * nbytes;
     if (fseek (this->fp_bin[iband], loc, SEEK_SET))
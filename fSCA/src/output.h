@@ -1,8 +1,10 @@
 #ifndef OUTPUT_H
 #define OUTPUT_H
 
+#include <sys/types.h>
 #include "common.h"
 #include "input.h"
+#include "tiled_output.h"
 
 #define MAX_DATE_LEN (28)
 
@@ -12,21 +14,74 @@
 /* Define some of the constants to use in the output data products */
 #define FILL_VALUE -9999
 #define CFMASK_FILL_VALUE 255
+#define CFMASK_CLOUD 4
 #define SATURATE_VALUE 20000
 #define FLOAT_TO_INT 10000.0
 #define SCALE_FACTOR 0.0001
 
+/* Define the size of the write buffer for each output band, and the
+   alignment of the buffers and file blocks for O_DIRECT writes.  The buffer
+   size needs to be a multiple of the alignment. */
+#define OUT_WBUF_SIZE (4 * 1024 * 1024)
+#define OUT_WBUF_ALIGN 4096
+
+/* Define how the write buffers are flushed to the output files */
+typedef enum {
+    OUT_WRITE_CACHED=0,   /* plain writes through the page cache */
+    OUT_WRITE_DONTNEED,   /* drop the written blocks from the page cache */
+    OUT_WRITE_DIRECT      /* write the aligned blocks with O_DIRECT */
+} Out_write_mode_t;
+
+/* Structure for the buffered writer of an output band.  Lines which are
+   contiguous in the file are gathered in buf and written with a single
+   pwrite once the buffer is full. */
+typedef struct {
+  char *buf;            /* write buffer of OUT_WBUF_SIZE bytes, aligned to
+                           OUT_WBUF_ALIGN */
+  off_t start;          /* file offset of the first byte in buf */
+  size_t len;           /* number of bytes held in buf */
+  int fd;               /* file descriptor of the band file */
+  int direct_fd;        /* O_DIRECT file descriptor of the band file; -1 if
+                           O_DIRECT isn't being used */
+  off_t advise_start;   /* file offset of the last block written, which is
+                           dropped from the page cache after the next one */
+  size_t advise_len;    /* size of the last block written */
+  long long nbytes;     /* number of bytes written to the file */
+  long nflush;          /* number of times the buffer was flushed */
+  long ndirect;         /* number of pwrites done with O_DIRECT */
+} Out_writer_t;
+
 /* Structure for the 'output' data type */
 typedef struct {
   bool open;            /* Flag to indicate whether output file is open;
                            'true' = open, 'false' = not open */
-  int nband;            /* Number of output image bands */
+  int nband;            /* Number of possible output image bands, indexed
+                           by Mycm_list_t */
+  int nband_out;        /* Number of bands actually being output; the size
+                           of the metadata band array */
+  int band_indx[MAX_OUT_BANDS];  /* Index of each band in the metadata band
+                           array; -1 if the band is not being output */
   int nlines;           /* Number of output lines */
   int nsamps;           /* Number of output samples */
   Espa_internal_meta_t metadata;  /* Metadata container to hold the band
                            metadata for the output bands; global metadata
                            won't be valid */
-  FILE *fp_bin[MAX_OUT_BANDS];  /* File pointer for binary files */
+  FILE *fp_bin[MAX_OUT_BANDS];  /* File pointer for binary files; NULL if
+                           the band is not being output */
+  Out_write_mode_t write_mode;  /* How the write buffers are flushed */
+  Out_writer_t writer[MAX_OUT_BANDS];  /* Buffered writer for each band */
+  bool shared;          /* Are the band files shared with the processes
+                           writing the other shards of the scene?  If so,
+                           they aren't truncated, and only the window is
+                           written. */
+  Img_window_t window;  /* Window of the scene which is written; 0 lines if
+                           the whole scene is written */
+  Img_window_t proc;    /* Part of the scene in the lines passed to
+                           put_output_lines, if a window is written */
+  char *win_line[MAX_OUT_BANDS];  /* Line of the scene for each band, with
+                           fill outside the window; NULL without a window */
+  Tiled_output_t *tiled[MAX_OUT_BANDS];  /* Tiled output file for each band;
+                           NULL unless the tiles are written */
 } Output_t;
 
 /* Prototypes */
@@ -34,12 +89,17 @@ Output_t *open_output
 (
     Espa_internal_meta_t *in_meta,  /* I: input metadata structure */
     Input_t *input,                 /* I: input reflectance band data */
-    int nband,                      /* I: number of bands to be created */
+    int nband,                      /* I: number of possible bands */
+    bool *write_band,               /* I: array of nband flags specifying
+                                          which bands are to be created */
     char short_names[][STR_SIZE],   /* I: array of short names for new bands */
     char long_names[][STR_SIZE],    /* I: array of long names for new bands */
     char data_units[][STR_SIZE],    /* I: array of data units for new bands */
-    bool toa         /* I: are we processing TOA reflectance data, otherwise
+    bool toa,        /* I: are we processing TOA reflectance data, otherwise
                            process surface reflectance data */
+    Out_write_mode_t write_mode, /* I: how the output bands are written */
+    bool shared      /* I: are the band files shared with the processes
+                           writing the other shards of the scene? */
 );
 
 int close_output
@@ -52,6 +112,20 @@ int free_output
     Output_t *this    /* I/O: Output data structure to free */
 );
 
+int set_output_window
+(
+    Output_t *this,         /* I/O: Output data structure */
+    Img_window_t *proc,     /* I: part of the scene in the lines passed to
+                                  put_output_lines */
+    Img_window_t *window    /* I: window of the scene to be written */
+);
+
+int open_output_tiles
+(
+    Output_t *this,      /* I/O: Output data structure */
+    double ul_corner[2]  /* I: map x and y of the UL corner of the scene */
+);
+
 int put_output_lines
 (
     Output_t *this,    /* I: Output data structure; buf contains the line to
@@ -63,6 +137,17 @@ int put_output_lines
     int nbytes         /* I: number of bytes per pixel in this band */
 );
 
+int flush_output_band
+(
+    Output_t *this,    /* I/O: Output data structure */
+    int iband          /* I: band to be flushed (0-based) */
+);
+
+void print_output_stats
+(
+    Output_t *this     /* I: Output data structure */
+);
+
 int get_output_lines
 (
     Output_t *this,  /* I: pointer to output data structure */
@@ -0,0 +1,196 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "plane_store.h"
+#include "error_handler.h"
+
+/******************************************************************************
+MODULE:  init_plane_store
+
+PURPOSE:  Initializes the plane store so it holds no planes.
+
+RETURN VALUE:
+Type = None
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+---------     ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. The store points to scratch_dir, so it needs to stay valid while the
+     store is in use.
+******************************************************************************/
+void init_plane_store
+(
+    char *scratch_dir,     /* I: directory for the scratch files; NULL to
+                                 hold all the planes in memory */
+    long mem_limit_mb,     /* I: megabytes of planes to hold in memory before
+                                 using scratch files; ignored without a
+                                 scratch directory */
+    Plane_store_t *store   /* O: plane store to be initialized */
+)
+{
+    store->scratch_dir = scratch_dir;
+    store->mem_limit = (mem_limit_mb > 0) ?
+        (size_t) mem_limit_mb * 1024 * 1024 : 0;
+    store->mem_used = 0;
+    store->nmapped = 0;
+}
+
+
+/******************************************************************************
+MODULE:  alloc_plane
+
+PURPOSE:  Allocates a plane from the store, initialized to 0s.  The plane is
+held in memory if it fits within the memory limit of the store, otherwise it
+is mapped from a scratch file.
+
+RETURN VALUE:
+Type = int
+Value      Description
+-----      -----------
+ERROR      Error allocating the plane
+SUCCESS    Successful completion
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+---------     ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. The scratch file is unlinked as soon as it is mapped, so it goes away
+     when the plane is freed or the application exits.  The file is extended
+     with ftruncate, so it reads as 0s without writing them.
+******************************************************************************/
+int alloc_plane
+(
+    Plane_store_t *store,  /* I/O: plane store */
+    size_t nbytes,         /* I: size of the plane in bytes */
+    Plane_t *plane         /* O: allocated plane */
+)
+{
+    char FUNC_NAME[] = "alloc_plane";   /* function name */
+    char errmsg[STR_SIZE];    /* error message */
+    char scratch_file[STR_SIZE];  /* name of the scratch file */
+    int fd;                   /* file descriptor for the scratch file */
+
+    plane->data = NULL;
+    plane->nbytes = nbytes;
+    plane->mapped = false;
+
+    /* Hold the plane in memory if it fits */
+    if (store->scratch_dir == NULL || store->mem_used + nbytes <=
+        store->mem_limit)
+    {
+        plane->data = calloc (nbytes, 1);
+        if (plane->data == NULL)
+        {
+            sprintf (errmsg, "Error allocating memory for a plane of %ld "
+                "bytes", (long) nbytes);
+            error_handler (true, FUNC_NAME, errmsg);
+            return (ERROR);
+        }
+        store->mem_used += nbytes;
+        return (SUCCESS);
+    }
+
+    /* Otherwise map it from a scratch file */
+    if (snprintf (scratch_file, sizeof (scratch_file), "%s/plane_XXXXXX",
+        store->scratch_dir) >= (int) sizeof (scratch_file))
+    {
+        snprintf (errmsg, sizeof (errmsg),
+            "Scratch directory name is too long: %.*s",
+            (int) (sizeof (errmsg) / 2), store->scratch_dir);
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+    fd = mkstemp (scratch_file);
+    if (fd == -1)
+    {
+        snprintf (errmsg, sizeof (errmsg),
+            "Error creating a scratch file in %.*s (%s)",
+            (int) (sizeof (errmsg) / 2), store->scratch_dir,
+            strerror (errno));
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+    unlink (scratch_file);
+
+    if (ftruncate (fd, (off_t) nbytes) == -1)
+    {
+        sprintf (errmsg, "Error extending the scratch file to %ld bytes (%s)",
+            (long) nbytes, strerror (errno));
+        error_handler (true, FUNC_NAME, errmsg);
+        close (fd);
+        return (ERROR);
+    }
+
+    plane->data = mmap (NULL, nbytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd,
+        0);
+    close (fd);
+    if (plane->data == MAP_FAILED)
+    {
+        plane->data = NULL;
+        sprintf (errmsg, "Error mapping the scratch file of %ld bytes (%s)",
+            (long) nbytes, strerror (errno));
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+    plane->mapped = true;
+    store->nmapped++;
+
+    return (SUCCESS);
+}
+
+
+/******************************************************************************
+MODULE:  free_plane
+
+PURPOSE:  Frees a plane allocated from the store.
+
+RETURN VALUE:
+Type = None
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+---------     ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+******************************************************************************/
+void free_plane
+(
+    Plane_store_t *store,  /* I/O: plane store */
+    Plane_t *plane         /* I/O: plane to be freed */
+)
+{
+    if (plane->data == NULL)
+        return;
+
+    if (plane->mapped)
+    {
+        munmap (plane->data, plane->nbytes);
+        store->nmapped--;
+    }
+    else
+    {
+        free (plane->data);
+        store->mem_used -= plane->nbytes;
+    }
+    plane->data = NULL;
+    plane->nbytes = 0;
+    plane->mapped = false;
+}
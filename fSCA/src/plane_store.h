@@ -0,0 +1,52 @@
+#ifndef _PLANE_STORE_H_
+#define _PLANE_STORE_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/* Store for the whole-scene intermediate planes.  The planes are held in
+   memory until mem_limit bytes are in use, and after that they are mapped
+   from unlinked scratch files in scratch_dir, so the kernel can write them
+   back and drop them when memory is short.  Without a scratch directory all
+   the planes are held in memory. */
+typedef struct {
+    char *scratch_dir;   /* directory for the scratch files; NULL if the
+                            planes are always held in memory */
+    size_t mem_limit;    /* number of bytes of planes held in memory before
+                            the planes are mapped from scratch files */
+    size_t mem_used;     /* number of bytes of planes held in memory */
+    int nmapped;         /* number of planes mapped from scratch files */
+} Plane_store_t;
+
+/* Plane allocated from the store */
+typedef struct {
+    void *data;          /* plane values, initialized to 0s */
+    size_t nbytes;       /* size of the plane in bytes */
+    bool mapped;         /* is the plane mapped from a scratch file */
+} Plane_t;
+
+/* Prototypes */
+void init_plane_store
+(
+    char *scratch_dir,     /* I: directory for the scratch files; NULL to
+                                 hold all the planes in memory */
+    long mem_limit_mb,     /* I: megabytes of planes to hold in memory before
+                                 using scratch files; ignored without a
+                                 scratch directory */
+    Plane_store_t *store   /* O: plane store to be initialized */
+);
+
+int alloc_plane
+(
+    Plane_store_t *store,  /* I/O: plane store */
+    size_t nbytes,         /* I: size of the plane in bytes */
+    Plane_t *plane         /* O: allocated plane */
+);
+
+void free_plane
+(
+    Plane_store_t *store,  /* I/O: plane store */
+    Plane_t *plane         /* I/O: plane to be freed */
+);
+
+#endif
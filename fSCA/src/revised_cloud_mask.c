@@ -1,6 +1,281 @@
-#include <cv.h>
 #include "revised_cloud_mask.h"
 
+/* Define the names of the profiled stages (see Rcm_profile_stage_t) */
+static char *profile_stage_names[RP_NUM] = {"input_read", "index",
+    "cloud_spans", "variance", "rules", "morphology_buffer", "output_write"};
+
+/******************************************************************************
+MODULE:  plan_mem_budget (static)
+
+PURPOSE:  Picks the number of lines in each strip, and the megabytes of
+whole-scene planes held in memory, so the buffers fit in the memory budget.
+Reports how the budget is used.
+
+RETURN VALUE:
+Type = None
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. The strip buffers are the reflectance and cfmask read buffers, the
+     NDVI and NDSI, and the variance strips.  The halo lines of the read
+     buffers and indices don't depend on the strip height.  The planes are
+     the two whole-scene revised cloud masks.
+  2. The planes are kept in memory if that leaves room for strips of
+     PROC_NLINES lines, and the strips get the rest of the budget.
+     Otherwise the strips are PROC_NLINES lines (or as many as fit, but at
+     least MIN_PROC_NLINES), and the planes get what is left.  Planes which
+     don't fit are mapped from the scratch files, so they can only go over
+     the budget if there's no scratch directory.
+  3. The strips are never taller than the scene.
+******************************************************************************/
+static void plan_mem_budget
+(
+    Input_t *input,        /* I: input reflectance data */
+    long mem_budget_mb,    /* I: megabytes of memory to size for */
+    bool scratch,          /* I: is there a scratch directory for the
+                                 planes? */
+    int *proc_nlines,      /* O: number of lines in each strip */
+    long *plane_mem_mb     /* O: megabytes of planes to hold in memory */
+)
+{
+    char FUNC_NAME[] = "plan_mem_budget"; /* function name */
+    char errmsg[STR_SIZE];   /* error message */
+    double mb = 1024.0 * 1024.0;  /* bytes in a megabyte */
+    double avail;            /* bytes of the budget for the strips and
+                                planes */
+    double line_bytes;       /* bytes of the strip buffers for each line */
+    double halo_bytes;       /* bytes of the halo lines of the strips */
+    double plane_bytes;      /* bytes of the planes */
+    double nlines;           /* number of lines which fit in the budget */
+
+    line_bytes = (double) input->scene_nsamps * (input->nrefl_band *
+        sizeof (int16) + sizeof (uint8)) + (double) input->nsamps *
+        (2 + NUM_VARIANCE) * sizeof (float);
+    halo_bytes = 2.0 * PROC_HALO * ((double) input->scene_nsamps *
+        input->nrefl_band * sizeof (int16) + (double) input->nsamps * 2 *
+        sizeof (float));
+    plane_bytes = 2.0 * input->nlines * input->nsamps * sizeof (uint8);
+    avail = mem_budget_mb * mb - halo_bytes;
+
+    if (avail - plane_bytes >= PROC_NLINES * line_bytes)
+    {
+        /* The planes fit, so the strips get the rest */
+        nlines = (avail - plane_bytes) / line_bytes;
+        *plane_mem_mb = (long) ceil (plane_bytes / mb);
+    }
+    else
+    {
+        /* The planes spill, so the strips get their usual height first */
+        nlines = avail / line_bytes;
+        if (nlines > PROC_NLINES)
+            nlines = PROC_NLINES;
+        if (nlines < MIN_PROC_NLINES)
+        {
+            if (input->nlines > nlines)
+            {
+                sprintf (errmsg, "Memory budget of %ld MB doesn't allow "
+                    "strips of %d lines; using %d lines anyway",
+                    mem_budget_mb, MIN_PROC_NLINES, MIN_PROC_NLINES);
+                error_handler (false, FUNC_NAME, errmsg);
+            }
+            nlines = MIN_PROC_NLINES;
+        }
+        *plane_mem_mb = (long) ((avail - (int) nlines * line_bytes) / mb);
+        if (*plane_mem_mb < 0)
+            *plane_mem_mb = 0;
+        if (!scratch)
+        {
+            sprintf (errmsg, "The %.1f MB of cloud mask planes don't fit in "
+                "the memory budget, and there is no scratch directory, so "
+                "they are held in memory anyway", plane_bytes / mb);
+            error_handler (false, FUNC_NAME, errmsg);
+        }
+    }
+    if (nlines >= input->nlines)
+        *proc_nlines = input->nlines;
+    else
+        *proc_nlines = (int) nlines;
+
+    printf ("  Memory budget: %ld MB; strips of %d lines use %.1f MB and "
+        "up to %ld MB of the %.1f MB of cloud mask planes are held in "
+        "memory\n", mem_budget_mb, *proc_nlines,
+        (*proc_nlines * line_bytes + halo_bytes) / mb, *plane_mem_mb,
+        plane_bytes / mb);
+}
+
+
+/******************************************************************************
+MODULE:  select_output_bands (static)
+
+PURPOSE:  Picks the bands to be output, either from the list of short names
+given with --outputs or from the --write_intermediate flag.
+
+RETURN VALUE:
+Type = int
+Value      Description
+-----      -----------
+ERROR      The list names an unknown band, or no bands
+SUCCESS    Successful completion
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. Without a list, the revised cloud masks are always output, and the
+     NDVI, NDSI, and variance bands are output if write_intermediate is
+     set.
+  2. The list is split in place as it is parsed.
+******************************************************************************/
+static int select_output_bands
+(
+    char *outputs,         /* I/O: comma-separated short names of the bands
+                                   to be output; NULL for the default bands */
+    bool write_intermediate, /* I: should the NDVI, NDSI, and variance bands
+                                   be output by default */
+    int nband,             /* I: number of possible bands */
+    char short_names[][STR_SIZE],  /* I: short names of the bands */
+    bool *write_band       /* O: array of nband flags specifying which bands
+                                 are to be output */
+)
+{
+    char FUNC_NAME[] = "select_output_bands";   /* function name */
+    char errmsg[STR_SIZE];    /* error message */
+    char *name = NULL;        /* current short name in the list */
+    char *saveptr = NULL;     /* rest of the list for strtok_r */
+    int ib;                   /* looping variable for bands */
+    int nselect = 0;          /* number of bands selected */
+
+    if (outputs == NULL)
+    {
+        for (ib = 0; ib < nband; ib++)
+            write_band[ib] = write_intermediate;
+        write_band[REVISED_CM] = true;
+        write_band[REVISED_LIM_CM] = true;
+        return (SUCCESS);
+    }
+
+    for (ib = 0; ib < nband; ib++)
+        write_band[ib] = false;
+    for (name = strtok_r (outputs, ",", &saveptr); name != NULL;
+         name = strtok_r (NULL, ",", &saveptr))
+    {
+        for (ib = 0; ib < nband; ib++)
+        {
+            if (!strcmp (name, short_names[ib]))
+                break;
+        }
+        if (ib == nband)
+        {
+            sprintf (errmsg, "Unknown output band %s", name);
+            error_handler (true, FUNC_NAME, errmsg);
+            return (ERROR);
+        }
+        if (!write_band[ib])
+            nselect++;
+        write_band[ib] = true;
+    }
+
+    if (nselect == 0)
+    {
+        sprintf (errmsg, "No output bands were listed");
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+
+    return (SUCCESS);
+}
+
+
+/******************************************************************************
+MODULE:  write_output_metadata (static)
+
+PURPOSE:  Writes the ENVI header of each output band and appends the output
+bands to the XML file.
+
+RETURN VALUE:
+Type = int
+Value      Description
+-----      -----------
+ERROR      Error writing the ENVI headers or the XML file
+SUCCESS    Successful completion
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. For a sharded scene this is only called by the --shard_finalize step,
+     once all of the shards have completed, so the XML file is never
+     rewritten while a shard is reading it.
+******************************************************************************/
+static int write_output_metadata
+(
+    Output_t *cm_output,       /* I: output structure and metadata for the
+                                     cloud mask products */
+    Espa_global_meta_t *gmeta, /* I: global metadata of the input XML file */
+    char *xml_infile           /* I: XML file the bands are appended to */
+)
+{
+    char FUNC_NAME[] = "write_output_metadata";   /* function name */
+    char errmsg[STR_SIZE];     /* error message */
+    char envi_file[STR_SIZE];  /* name of the output ENVI header file */
+    char *cptr=NULL;           /* pointer to the file extension */
+    int ib;                    /* looping variable for bands */
+    Envi_header_t envi_hdr;    /* output ENVI header information */
+
+    /* Write the ENVI header for the output files */
+    for (ib = 0; ib < cm_output->nband_out; ib++)
+    {
+        /* Create the ENVI header file this band */
+        if (create_envi_struct (&cm_output->metadata.band[ib], gmeta,
+            &envi_hdr) != SUCCESS)
+        {
+            sprintf (errmsg, "Creating ENVI header structure.");
+            error_handler (true, FUNC_NAME, errmsg);
+            return (ERROR);
+        }
+
+        /* Write the ENVI header */
+        strcpy (envi_file, cm_output->metadata.band[ib].file_name);
+        cptr = strchr (envi_file, '.');
+        strcpy (cptr, ".hdr");
+        if (write_envi_hdr (envi_file, &envi_hdr) != SUCCESS)
+        {
+            sprintf (errmsg, "Writing ENVI header file.");
+            error_handler (true, FUNC_NAME, errmsg);
+            return (ERROR);
+        }
+    }
+
+    /* Append the spectral index bands to the XML file */
+    if (append_metadata (cm_output->nband_out, cm_output->metadata.band,
+        xml_infile) != SUCCESS)
+    {
+        sprintf (errmsg, "Appending revised cloud mask bands to XML file.");
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+
+    return (SUCCESS);
+}
+
+
 /******************************************************************************
 MODULE:  revised_cloud_mask
 
@@ -24,6 +299,29 @@ Date          Programmer       Reason
 ----------    ---------------  -------------------------------------
 5/19/2014     Gail Schmidt     Original Development, based on an algorithm
                                provided by David Selkowitz
+10/14/2026    agent            Added the --profile JSON summary of the time
+                               and throughput of each processing stage
+10/14/2026    agent            Added the --window processing of a subset of
+                               the scene
+10/14/2026    agent            Added the --mem_budget_mb sizing of the strips
+                               and planes
+10/14/2026    agent            Carve the index and variance strips from one
+                               arena
+10/14/2026    agent            Added the --tiled_output files, with overviews
+10/14/2026    agent            Only compute the indices in the valid span of
+                               each line, skipping the fill corners
+10/14/2026    agent            Added the --mmap_input flag, and read ahead
+                               for the next strip
+10/14/2026    agent            Added the --threads option, splitting the
+                               indices, variances, rules, and cloud mask
+                               filtering across OpenMP threads
+10/14/2026    agent            Added the --shard processing of one band of
+                               lines of the scene, and the --shard_finalize
+                               step which writes the headers and XML file
+10/14/2026    agent            Added the --outputs selection of the bands,
+                               only setting up and computing what they need
+10/14/2026    agent            Skip the variances and rule-based models for
+                               the strips without cfmask cloud
 
 NOTES:
   1. The rule-based models expect that the variances for the TOA reflectance
@@ -32,16 +330,87 @@ NOTES:
      models also expect the variances for the NDVI and NDSI values to be 
      computed on the original values between -1.0 and 1.0.  Thus these values
      need to be unscaled after being written to the output file as scaled.
+  2. The indices, variances, and rule-based models are run together one
+     strip at a time from memory.  The NDVI, NDSI, and variance bands are
+     only written as products when --write_intermediate is specified or
+     they are listed with --outputs.
+  3. The rule-based models only revise the cfmask cloud pixels, so a span
+     index of those pixels is built for each strip and the variances are
+     only computed within the spans.  When the variance bands are written
+     they are computed for every pixel.
+  4. The whole-scene revised cloud masks are allocated from a plane store.
+     With --scratch_dir, the masks beyond --plane_mem_mb are mapped from
+     scratch files instead of being held in memory.
+  5. The erosion and dilation are done together with the buffering in
+     morph_buffer_mask, so they are profiled as one stage.
+  6. For a window, the window plus a halo of WINDOW_HALO lines and samples
+     (where the scene has them) is read and processed.  The output bands
+     still cover the whole scene, to match the XML file, with only the
+     window written and fill elsewhere.
+  7. The strips are PROC_NLINES lines unless --mem_budget_mb is specified,
+     in which case the strip height and the plane memory are picked to fit
+     the budget (see plan_mem_budget).
+  8. With --tiled_output, each output band is also written to a tiled file
+     with overviews (see tiled_output.h), which can be read a tile at a time
+     without converting the band file.  For a window, the tiles only cover
+     the window.
+  9. With --mmap_input, the reflectance bands are mapped and the strips use
+     the lines in place (see map_input).  Either way, the kernel is told to
+     read the next strip ahead while the current one is processed.
+  10. The indices, variances, and rule-based models are divided among the
+      threads in chunks of lines of each strip (see PROC_CHUNK_NLINES), and
+      the two revised cloud masks are filtered and buffered at the same
+      time.  The chunks don't depend on the number of threads, so neither
+      do the outputs.  Reading the strips and writing the outputs remain
+      single-threaded.  The OpenMP threads are the only backend; there is
+      no GPU offload of the chain.
+  11. With --shard=index,count, the scene is split into count bands of
+      lines and only band index is processed, as a window of the scene
+      (see note 6).  The shards may be run as separate processes, on the
+      same node or on nodes sharing the output directory.  Every shard
+      writes its own lines to the same band files, which aren't truncated.
+      No shard writes the ENVI headers or the XML file, so the shards may
+      be started in any order.  Once all of the shards have completed,
+      --shard_finalize is run once with the same output bands; it only
+      parses the XML file, writes the ENVI headers, and appends the bands to
+      the XML file.  Since each shard reads the halo around its window, the
+      stitched bands then match processing the whole scene at once.
+  12. With --outputs, only the listed bands are created.  The rule-based
+      models are only loaded and run, and the whole-scene cloud masks only
+      allocated, if one of the revised cloud masks is listed, and only the
+      listed masks are filtered and buffered.  The variances are computed
+      for every pixel if a variance band is listed, for the cloud pixels if
+      only the models need them, and not at all otherwise.
+  13. The cloud span index doubles as the cloud statistics of the strip.  A
+      strip without cfmask cloud has nothing for the rule-based models to
+      revise, so unless the variance bands are written, the variances and
+      models are skipped and its lines of the revised cloud masks are set
+      to 0s, which is what the models would have produced.
 ******************************************************************************/
 int main (int argc, char *argv[])
 {
     bool verbose;              /* verbose flag for printing messages */
+    bool write_intermediate;   /* should the NDVI, NDSI, and variance bands
+                                  be written as output products */
+    bool tiled_output;         /* should the output bands also be written to
+                                  tiled files */
+    bool mmap_input;           /* should the reflectance bands be mapped
+                                  rather than read */
+    bool write_masks;          /* is either revised cloud mask output, so the
+                                  rule-based models are run? */
+    bool write_variance;       /* is any of the variance bands output? */
+    int nmasks_out;            /* number of revised cloud masks output */
+    int nindex_out;            /* number of NDVI, NDSI, and variance bands
+                                  output */
+    double tile_ul[2];         /* map x and y of the UL corner of the UL
+                                  pixel of the scene, for the tiled files */
+    bool write_band[MAX_OUT_BANDS]; /* which of the bands are to be output */
+    Out_write_mode_t write_mode; /* how the output bands are written */
     bool toa_refl=true;        /* process TOA reflectance by default, but leave
                                   it open to use surface reflectance in the
                                   future */
     char FUNC_NAME[] = "main"; /* function name */
     char errmsg[STR_SIZE];     /* error message */
-    char envi_file[STR_SIZE];  /* name of the output ENVI header file */
     char short_cm_names[MAX_OUT_BANDS][STR_SIZE]; /* output short names for new
                                                      cloud mask bands */
     char long_cm_names[MAX_OUT_BANDS][STR_SIZE];  /* output long names for new
@@ -49,111 +418,132 @@ int main (int argc, char *argv[])
     char cm_data_units[MAX_OUT_BANDS][STR_SIZE];  /* output data units for new
                                                      cloud mask bands */
     char *xml_infile=NULL;     /* input XML filename */
-    char *cptr=NULL;           /* pointer to the file extension */
+    char *rules_file=NULL;     /* C5.0 rules file for the conservative model */
+    char *lim_rules_file=NULL; /* C5.0 rules file for the limited model */
+    char *scratch_dir=NULL;    /* directory for the scratch files */
+    char *profile_file=NULL;   /* profile JSON filename; NULL for stdout */
+    char *outputs=NULL;        /* short names of the bands to be output;
+                                  NULL for the default bands */
+    bool profile;              /* should the processing stages be profiled */
+    Profile_t prof;            /* profile of the processing stages */
+    Profile_mark_t mark;       /* start of the stage being profiled */
+    Img_window_t window;       /* window of the scene to be processed; 0
+                                  lines for the whole scene */
+    Img_window_t proc_window;  /* window being processed, which is the
+                                  requested window plus the halo */
+    long long strip_pix;       /* number of pixels in the current strip */
+    long plane_mem_mb;         /* megabytes of whole-scene planes to hold in
+                                  memory before using scratch files */
+    long mem_budget_mb;        /* megabytes of memory to size the strips and
+                                  planes for; 0 for strips of PROC_NLINES
+                                  lines */
     int retval;                /* return status */
     int i;                     /* looping variable */
+    int nthreads;              /* number of threads for processing; 0 uses
+                                  the OpenMP default */
+    int shard_index;           /* shard of the scene to be processed */
+    int shard_count;           /* number of shards the scene is split into;
+                                  0 if the scene isn't sharded */
+    bool shard_finalize;       /* should only the ENVI headers and XML file
+                                  of a sharded scene be written? */
+    int chunk;                 /* first line of the current chunk of the
+                                  strip */
+    int chunk_nlines;          /* number of lines in the current chunk */
+    long chunk_pix;            /* first pixel of the current chunk within
+                                  the strip */
+    int morph_status[2];       /* status of the filtering and buffering of
+                                  each revised cloud mask */
     int ib;                    /* looping variable for bands */
-    int pix;                   /* current pixel */
-    int line, samp;            /* current line,samp to be processed */
+    int line;                  /* current line to be processed */
+    int proc_nlines;           /* number of lines in each strip */
     int nlines_proc;           /* number of lines to process at one time */
     int num_cm;                /* number of cloud mask products to be output */
     float *ndvi=NULL;          /* NDVI values */
     float *ndsi=NULL;          /* NDSI values */
-    int16 *band_arr=NULL;      /* values for current reflectance band */
-    float *flt_arr=NULL;       /* values for current reflectance band, as
-                                  floats*/
-    float *index_arr=NULL;     /* values for current index */
-    float *variance_arr=NULL;  /* variance values for current band/index */
-    float *b1_var=NULL;        /* band1 variance values */
-    float *b2_var=NULL;        /* band2 variance values */
-    float *b3_var=NULL;        /* band3 variance values */
-    float *b4_var=NULL;        /* band4 variance values */
-    float *b5_var=NULL;        /* band5 variance values */
-    float *b7_var=NULL;        /* band7 variance values */
-    float *ndvi_var=NULL;      /* NDVI variance values */
-    float *ndsi_var=NULL;      /* NDSI variance values */
+    int strip_start;           /* first line read for the current strip,
+                                  including the variance halo */
+    int strip_nlines;          /* number of lines read for the current strip,
+                                  including the variance halo */
+    int halo_top;              /* number of halo lines read above the
+                                  current strip */
+    long pix;                  /* first pixel of the current strip within
+                                  the strips read with a halo */
+    int16 *strip_refl[NBAND_REFL_MAX]; /* reflectance bands for the current
+                                  strip, without the halo */
+    int16 *chunk_refl[NBAND_REFL_MAX]; /* reflectance bands for the current
+                                  chunk of the strip */
+    long ncloud_pix = 0;       /* number of cfmask cloud pixels in the scene */
+    int nclear_strips = 0;     /* number of strips without cfmask cloud, for
+                                  which the rule-based models are skipped */
+    Span_index_t cloud_spans;  /* index of the cfmask cloud pixels in the
+                                  current strip */
+    Rule_model_t conserv_model; /* conservative rule-based model, which uses
+                                   the variances */
+    Rule_model_t lim_model;    /* limited rule-based model, which does not
+                                  use the variances */
+    float *var_indices[2];     /* NDVI and NDSI strips for the variances */
+    float *var_strip[NUM_VARIANCE];  /* variance strips for the reflectance
+                                        bands, NDVI, and NDSI */
+    Arena_t strip_arena;       /* arena holding the index and variance
+                                  strips */
+    size_t index_size;         /* number of bytes in each index strip */
+    size_t var_size;           /* number of bytes in each variance strip */
     uint8 *rev_cm=NULL;        /* revised cloud mask */
     uint8 *rev_lim_cm=NULL;    /* revised cloud mask without variances */
-    uint8 *buff_cm=NULL;       /* revised cloud mask with buffering */
-    uint8 *opencv_img=NULL;    /* pointer to the opencv image data */
-    void *ptr=NULL;            /* generic pointer for reading data */
+    Plane_store_t plane_store; /* store for the whole-scene planes */
+    Plane_t rev_cm_plane;      /* plane holding rev_cm */
+    Plane_t rev_lim_cm_plane;  /* plane holding rev_lim_cm */
     Input_t *refl_input=NULL;  /* input structure for the TOA product */
     Output_t *cm_output=NULL;  /* output structure and metadata for the new
                                   cloud mask products */
     Espa_internal_meta_t xml_metadata;  /* XML metadata structure */
-    Envi_header_t envi_hdr;   /* output ENVI header information */
-    IplImage* cv_img=NULL;    /* image pointer to hold the cloud mask imagery
-                                 for OpenCV */
-    IplConvKernel* element=NULL; /* 5x5 kernel for the erosion and dilation */
 
     printf ("Starting revised cloud mask processing ...\n");
 
     /* Read the command-line arguments */
-    retval = get_args (argc, argv, &xml_infile, &verbose);
+    retval = get_args (argc, argv, &xml_infile, &rules_file, &lim_rules_file,
+        &write_intermediate, &write_mode, &scratch_dir, &plane_mem_mb,
+        &profile, &profile_file, &window, &mem_budget_mb, &tiled_output,
+        &mmap_input, &nthreads, &shard_index, &shard_count,
+        &shard_finalize, &outputs, &verbose);
     if (retval != SUCCESS)
     {   /* get_args already printed the error message */
         exit (ERROR);
     }
 
-    /* Provide user information if verbose is turned on */
-    if (verbose)
-        printf ("  XML input file: %s\n", xml_infile);
-
-    /* Validate the input metadata file */
-    if (validate_xml_file (xml_infile) != SUCCESS)
-    {  /* Error messages already written */
-        exit (ERROR);
-    }
-
-    /* Initialize the metadata structure */
-    init_metadata_struct (&xml_metadata);
+    /* Set up the number of threads for processing */
+#ifdef _OPENMP
+    if (nthreads > 0)
+        omp_set_num_threads (nthreads);
+    else
+        nthreads = omp_get_max_threads ();
+#else
+    if (nthreads > 1)
+        printf ("  Warning: not built with OpenMP support.  Processing with "
+            "a single thread.\n");
+    nthreads = 1;
+#endif
 
-    /* Parse the metadata file into our internal metadata structure; also
-       allocates space as needed for various pointers in the global and band
-       metadata */
-    if (parse_metadata (xml_infile, &xml_metadata) != SUCCESS)
-    {  /* Error messages already written */
-        exit (ERROR);
-    }
-
-    /* Open the reflectance product, set up the input data structure, and
-       allocate memory for the data buffers */
-    refl_input = open_input (&xml_metadata, toa_refl);
-    if (refl_input == (Input_t *) NULL)
-    {
-        sprintf (errmsg, "Error opening/reading the reflectance data: %s",
-            xml_infile);
-        error_handler (true, FUNC_NAME, errmsg);
-        exit (ERROR);
-    }
-
-    /* Output some information from the input files if verbose */
+    /* Provide user information if verbose is turned on */
     if (verbose)
     {
-        printf ("  Number of lines/samples: %d/%d\n", refl_input->nlines,
-            refl_input->nsamps);
-        printf ("  Number of reflective bands: %d\n", refl_input->nrefl_band);
-        printf ("  Fill value: %d\n", refl_input->refl_fill);
-        printf ("  Scale factor: %f\n", refl_input->refl_scale_fact);
-        printf ("  Saturation value: %d\n", refl_input->refl_saturate_val);
-    }
-
-    /* Allocate memory for the NDVI and NDSI, holds PROC_NLINES */
-    ndvi = calloc (PROC_NLINES*refl_input->nsamps, sizeof (float));
-    if (ndvi == NULL)
-    {
-        sprintf (errmsg, "Error allocating memory for the NDVI");
-        error_handler (true, FUNC_NAME, errmsg);
-        exit (ERROR);
+        printf ("  XML input file: %s\n", xml_infile);
+        printf ("  Write intermediate bands: %s\n",
+            write_intermediate ? "true" : "false");
+        printf ("  Conservative model rules: %s\n",
+            rules_file ? rules_file : "built-in");
+        printf ("  Limited model rules: %s\n",
+            lim_rules_file ? lim_rules_file : "built-in");
+        printf ("  Write mode: %s\n",
+            write_mode == OUT_WRITE_DIRECT ? "direct" :
+            write_mode == OUT_WRITE_DONTNEED ? "dontneed" : "cached");
+        if (scratch_dir)
+            printf ("  Scratch directory: %s (%ld MB of planes in memory)\n",
+                scratch_dir, plane_mem_mb);
+        printf ("  Number of threads: %d\n", nthreads);
     }
 
-    ndsi = calloc (PROC_NLINES*refl_input->nsamps, sizeof (float));
-    if (ndsi == NULL)
-    {
-        sprintf (errmsg, "Error allocating memory for the NDSI");
-        error_handler (true, FUNC_NAME, errmsg);
-        exit (ERROR);
-    }
+    init_profile (profile, RP_NUM, profile_stage_names, &prof);
 
     /* Set up the output information for the NDVI and NDSI */
     num_cm = NUM_CM;
@@ -192,665 +582,710 @@ int main (int argc, char *argv[])
     strcpy (long_cm_names[REVISED_LIM_CM], "revised limited cloud mask");
     strcpy (cm_data_units[REVISED_LIM_CM], "quality/feature classification");
 
-    /* Open the specified output files and create the metadata structure */
-    cm_output = open_output (&xml_metadata, refl_input, num_cm,
-        short_cm_names, long_cm_names, cm_data_units, toa_refl);
-    if (cm_output == NULL)
-    {   /* error message already printed */
+    /* Pick the bands to be output, and what needs to be computed for
+       them */
+    if (select_output_bands (outputs, write_intermediate, num_cm,
+        short_cm_names, write_band) != SUCCESS)
+    {
+        sprintf (errmsg, "Selecting the output bands");
         error_handler (true, FUNC_NAME, errmsg);
         exit (ERROR);
     }
-
-    /* Print the processing status if verbose */
-    if (verbose)
+    nmasks_out = (write_band[REVISED_CM] ? 1 : 0) +
+        (write_band[REVISED_LIM_CM] ? 1 : 0);
+    write_masks = (nmasks_out > 0);
+    write_variance = false;
+    nindex_out = 0;
+    for (ib = CM_NDVI; ib <= VARIANCE_NDSI; ib++)
     {
-        printf ("  Processing spectral indices %d lines at a time\n",
-            PROC_NLINES);
+        if (write_band[ib])
+            nindex_out++;
+        if (write_band[ib] && ib >= VARIANCE_B1)
+            write_variance = true;
     }
-
-    /* Loop through the lines and samples in the reflectance product,
-       computing the NDVI and NDSI */
-    nlines_proc = PROC_NLINES;
-    for (line = 0; line < refl_input->nlines; line += PROC_NLINES)
+    if (verbose)
     {
-        /* Do we have nlines_proc left to process? */
-        if (line + nlines_proc >= refl_input->nlines)
-            nlines_proc = refl_input->nlines - line;
-
-        /* Read the current lines from the reflectance file for each of the
-           reflectance bands */
-        for (ib = 0; ib < refl_input->nrefl_band; ib++)
+        printf ("  Output bands:");
+        for (ib = 0; ib < num_cm; ib++)
         {
-            if (get_input_refl_lines (refl_input, ib, line, nlines_proc, NULL)
-                != SUCCESS)
-            {
-                sprintf (errmsg, "Error reading %d lines from band %d of the "
-                    "reflectance file starting at line %d", nlines_proc, ib,
-                    line);
-                error_handler (true, FUNC_NAME, errmsg);
-                exit (ERROR);
-            }
-        }  /* end for ib */
-
-        /* Compute the NDVI and write to output file
-           NDVI = (nir - red) / (nir + red) */
-        make_index (refl_input->refl_buf[3] /*b4*/,
-            refl_input->refl_buf[2] /*b3*/, refl_input->refl_fill,
-            refl_input->refl_saturate_val, nlines_proc, refl_input->nsamps,
-            ndvi);
+            if (write_band[ib])
+                printf (" %s", short_cm_names[ib]);
+        }
+        printf ("\n");
+    }
 
-        if (put_output_lines (cm_output, ndvi, CM_NDVI, line, nlines_proc,
-            sizeof (float)) != SUCCESS)
+    /* Load the rule-based models, either the built-in rules or the rules
+       from the specified C5.0 rules files, if the revised cloud masks are
+       output.  The finalize step of a sharded scene doesn't run them. */
+    init_rule_model (&conserv_model);
+    init_rule_model (&lim_model);
+    if (write_masks && !shard_finalize)
+    {
+        if (rules_file)
+            retval = read_rules_file (rules_file, &conserv_model);
+        else
+            retval = get_builtin_rules (true, &conserv_model);
+        if (retval != SUCCESS)
         {
-            sprintf (errmsg, "Writing output NDVI data for line %d", line);
+            sprintf (errmsg, "Loading the conservative rule-based model.");
             error_handler (true, FUNC_NAME, errmsg);
             exit (ERROR);
         }
 
-        /* Compute the NDSI and write to output file
-           NDSI = (green - mir) / (green + mir) */
-        make_index (refl_input->refl_buf[1] /*b2*/,
-            refl_input->refl_buf[4] /*b5*/, refl_input->refl_fill,
-            refl_input->refl_saturate_val, nlines_proc, refl_input->nsamps,
-            ndsi);
-
-        if (put_output_lines (cm_output, ndsi, CM_NDSI, line, nlines_proc,
-            sizeof (float)) != SUCCESS)
+        if (lim_rules_file)
+            retval = read_rules_file (lim_rules_file, &lim_model);
+        else
+            retval = get_builtin_rules (false, &lim_model);
+        if (retval != SUCCESS)
         {
-            sprintf (errmsg, "Writing output NDSI data for line %d", line);
+            sprintf (errmsg, "Loading the limited rule-based model.");
             error_handler (true, FUNC_NAME, errmsg);
             exit (ERROR);
         }
-    }  /* end for line */
-
-    /* Free the index pointers */
-    free (ndvi);
-    free (ndsi);
-
-    /* Print the processing status if verbose */
-    if (verbose)
-        printf ("  Spectral indices -- complete\n");
+    }
 
-    /* Allocate memory for the variance array, whole band */
-    variance_arr = calloc (refl_input->nlines * refl_input->nsamps,
-        sizeof (float));
-    if (variance_arr == NULL)
-    {
-        sprintf (errmsg, "Error allocating memory for the variance array");
-        error_handler (true, FUNC_NAME, errmsg);
+    /* Validate the input metadata file */
+    if (validate_xml_file (xml_infile) != SUCCESS)
+    {  /* Error messages already written */
         exit (ERROR);
     }
 
-    /* Allocate memory for the band array to read the entire reflectance band
-       vs just a subset of lines, whole band */
-    band_arr = calloc (refl_input->nlines * refl_input->nsamps,
-        sizeof (int16));
-    if (band_arr == NULL)
-    {
-        sprintf (errmsg, "Error allocating memory for the band array");
-        error_handler (true, FUNC_NAME, errmsg);
+    /* Initialize the metadata structure */
+    init_metadata_struct (&xml_metadata);
+
+    /* Parse the metadata file into our internal metadata structure; also
+       allocates space as needed for various pointers in the global and band
+       metadata */
+    if (parse_metadata (xml_infile, &xml_metadata) != SUCCESS)
+    {  /* Error messages already written */
         exit (ERROR);
     }
 
-    /* Allocate memory for the float array to hold the entire reflectance band
-       vs just a subset of lines, whole band */
-    flt_arr = calloc (refl_input->nlines * refl_input->nsamps, sizeof (float));
-    if (flt_arr == NULL)
+    /* Open the reflectance product, set up the input data structure, and
+       allocate memory for the data buffers */
+    refl_input = open_input (&xml_metadata, toa_refl);
+    if (refl_input == (Input_t *) NULL)
     {
-        sprintf (errmsg, "Error allocating memory for the floating point band "
-            "array");
+        sprintf (errmsg, "Error opening/reading the reflectance data: %s",
+            xml_infile);
         error_handler (true, FUNC_NAME, errmsg);
         exit (ERROR);
     }
 
-    /* Print the processing status if verbose */
+    /* Output some information from the input files if verbose */
     if (verbose)
-        printf ("  Processing variance for reflectance bands and indices\n");
+    {
+        printf ("  Number of lines/samples: %d/%d\n", refl_input->nlines,
+            refl_input->nsamps);
+        printf ("  Number of reflective bands: %d\n", refl_input->nrefl_band);
+        printf ("  Fill value: %d\n", refl_input->refl_fill);
+        printf ("  Scale factor: %f\n", refl_input->refl_scale_fact);
+        printf ("  Saturation value: %d\n", refl_input->refl_saturate_val);
+    }
 
-    /* Compute the variance for each reflectance band, NDVI, and NDSI.  Write
-       these to the output.  Process the whole band or index at a time, one
-       at a time. */ 
-    /* reflectance bands */
-    for (ib = 0; ib < refl_input->nrefl_band; ib++)
+    /* The finalize step of a sharded scene runs once all of the shards have
+       written their lines to the band files, so it only writes the ENVI
+       headers and appends the bands to the XML file */
+    if (shard_finalize)
     {
-        /* Read the band */
-        if (verbose)
-            printf ("    - reflectance band %d\n", ib);
-        if (get_input_refl_lines (refl_input, ib, 0, refl_input->nlines,
-            band_arr) != SUCCESS)
+        cm_output = open_output (&xml_metadata, refl_input, num_cm,
+            write_band, short_cm_names, long_cm_names, cm_data_units,
+            toa_refl, write_mode, true);
+        if (cm_output == NULL)
+        {   /* error message already printed */
+            exit (ERROR);
+        }
+        close_input (refl_input);
+        free_input (refl_input);
+
+        if (write_output_metadata (cm_output, &xml_metadata.global,
+            xml_infile) != SUCCESS)
         {
-            sprintf (errmsg, "Error reading band %d of reflectance file", ib);
+            sprintf (errmsg, "Writing the metadata of the sharded scene");
             error_handler (true, FUNC_NAME, errmsg);
             exit (ERROR);
         }
+        free_metadata (&xml_metadata);
 
-        /* Convert band_arr to float for the variance calculation */
-        for (pix = 0; pix < refl_input->nlines * refl_input->nsamps; pix++)
-            flt_arr[pix] = (float) band_arr[pix];
-
-        /* Compute the variance */
-        variance (flt_arr, refl_input->refl_fill, refl_input->nlines,
-            refl_input->nsamps, variance_arr);
-
-        /* Write variance to the output file */
-        if (put_output_lines (cm_output, variance_arr, ib+VARIANCE_B1, 0,
-            refl_input->nlines, sizeof (float)) != SUCCESS)
+        if (close_output (cm_output) != SUCCESS)
         {
-            sprintf (errmsg, "Error writing variance for band %d of "
-                "reflectance file", ib);
+            sprintf (errmsg, "Closing the revised cloud mask products.");
             error_handler (true, FUNC_NAME, errmsg);
             exit (ERROR);
         }
-    }  /* end for ib */
-
-    /* Free the band arrays */
-    free (band_arr);
-    free (flt_arr);
-
-    /* Allocate memory for the index array, whole band */
-    index_arr = calloc (refl_input->nlines * refl_input->nsamps,
-        sizeof (float));
-    if (index_arr == NULL)
-    {
-        sprintf (errmsg, "Error allocating memory for the index array");
-        error_handler (true, FUNC_NAME, errmsg);
-        exit (ERROR);
+        free_output (cm_output);
+
+        free (xml_infile);
+        free (rules_file);
+        free (lim_rules_file);
+        free (scratch_dir);
+        free (profile_file);
+        free (outputs);
+        printf ("Revised cloud mask shard finalize complete!\n");
+        exit (SUCCESS);
     }
 
-    /* index bands */
-    for (ib = CM_NDVI; ib <= CM_NDSI; ib++)
+    /* A shard is the window of its band of lines, across the whole scene */
+    if (shard_count > 0)
     {
-        /* Read the index band from the output file */
-        if (verbose && ib == CM_NDVI)
-            printf ("    - NDVI band\n");
-        else if (verbose && ib == CM_NDSI)
-            printf ("    - NDSI band\n");
-        if (get_output_lines (cm_output, ib, 0, refl_input->nlines,
-            sizeof(float), index_arr) != SUCCESS)
+        window.line0 = (int) ((long) shard_index * refl_input->nlines /
+            shard_count);
+        window.nlines = (int) ((long) (shard_index + 1) * refl_input->nlines /
+            shard_count) - window.line0;
+        window.samp0 = 0;
+        window.nsamps = refl_input->nsamps;
+        if (window.nlines < 1)
         {
-            sprintf (errmsg, "Error reading band %d of indices", ib);
+            sprintf (errmsg, "Shard %d of %d has no lines of the %d line "
+                "scene", shard_index, shard_count, refl_input->nlines);
             error_handler (true, FUNC_NAME, errmsg);
             exit (ERROR);
         }
 
-        /* Compute the variance */
-        variance (index_arr, refl_input->refl_fill, refl_input->nlines,
-            refl_input->nsamps, variance_arr);
+        if (verbose)
+            printf ("  Shard %d of %d: lines %d to %d\n", shard_index,
+                shard_count, window.line0, window.line0 + window.nlines - 1);
+    }
 
-        /* Write variance to the output file */
-        if (put_output_lines (cm_output, variance_arr, ib+VARIANCE_NDVI, 0,
-            refl_input->nlines, sizeof (float)) != SUCCESS)
+    /* Restrict the processing to the window, if one was specified, plus the
+       halo needed by the neighborhood operators */
+    if (window.nlines > 0)
+    {
+        if (window.line0 + window.nlines > refl_input->nlines ||
+            window.samp0 + window.nsamps > refl_input->nsamps)
         {
-            sprintf (errmsg, "Error writing variance for band %d of "
-                "reflectance file", ib);
+            sprintf (errmsg, "Window of %d lines and %d samples starting at "
+                "line %d, sample %d is not within the %d lines and %d "
+                "samples of the scene", window.nlines, window.nsamps,
+                window.line0, window.samp0, refl_input->nlines,
+                refl_input->nsamps);
             error_handler (true, FUNC_NAME, errmsg);
             exit (ERROR);
         }
-    }  /* end for ib */
-
-    /* Free the index and variance arrays */
-    free (variance_arr);
-    free (index_arr);
-
-    /* Print the processing status if verbose */
-    if (verbose)
-        printf ("  Computing variance -- complete\n");
 
-    /* Allocate memory for the NDVI and NDSI to hold one line of data */
-    ndvi = calloc (refl_input->nsamps, sizeof (float));
-    if (ndvi == NULL)
-    {
-        sprintf (errmsg, "Error allocating memory for the NDVI");
-        error_handler (true, FUNC_NAME, errmsg);
-        exit (ERROR);
-    }
+        proc_window.line0 = (window.line0 > WINDOW_HALO) ?
+            window.line0 - WINDOW_HALO : 0;
+        proc_window.samp0 = (window.samp0 > WINDOW_HALO) ?
+            window.samp0 - WINDOW_HALO : 0;
+        proc_window.nlines = ((window.line0 + window.nlines + WINDOW_HALO <
+            refl_input->nlines) ? window.line0 + window.nlines + WINDOW_HALO :
+            refl_input->nlines) - proc_window.line0;
+        proc_window.nsamps = ((window.samp0 + window.nsamps + WINDOW_HALO <
+            refl_input->nsamps) ? window.samp0 + window.nsamps + WINDOW_HALO :
+            refl_input->nsamps) - proc_window.samp0;
+        if (set_input_window (refl_input, &proc_window) != SUCCESS)
+        {
+            sprintf (errmsg, "Error setting the processing window");
+            error_handler (true, FUNC_NAME, errmsg);
+            exit (ERROR);
+        }
 
-    ndsi = calloc (refl_input->nsamps, sizeof (float));
-    if (ndsi == NULL)
-    {
-        sprintf (errmsg, "Error allocating memory for the NDSI");
-        error_handler (true, FUNC_NAME, errmsg);
-        exit (ERROR);
+        if (verbose)
+            printf ("  Window lines/samples: %d/%d starting at line %d, "
+                "sample %d (processing %d/%d with the halo)\n",
+                window.nlines, window.nsamps, window.line0, window.samp0,
+                proc_window.nlines, proc_window.nsamps);
     }
 
-    /* Allocate memory for the variances to hold one line of data */
-    ndvi_var = calloc (refl_input->nsamps, sizeof (float));
-    if (ndvi_var == NULL)
+    /* Size the strips and planes for the memory budget, if one was
+       specified */
+    proc_nlines = PROC_NLINES;
+    if (mem_budget_mb > 0)
     {
-        sprintf (errmsg, "Error allocating memory for the NDVI variance");
-        error_handler (true, FUNC_NAME, errmsg);
-        exit (ERROR);
+        plan_mem_budget (refl_input, mem_budget_mb, scratch_dir != NULL,
+            &proc_nlines, &plane_mem_mb);
+        if (set_input_strip_nlines (refl_input, proc_nlines) != SUCCESS)
+        {
+            sprintf (errmsg, "Error allocating the input strips of %d lines",
+                proc_nlines);
+            error_handler (true, FUNC_NAME, errmsg);
+            exit (ERROR);
+        }
     }
 
-    ndsi_var = calloc (refl_input->nsamps, sizeof (float));
-    if (ndsi_var == NULL)
+    /* Map the reflectance bands, if requested.  If they can't be mapped,
+       they are read instead. */
+    if (mmap_input)
     {
-        sprintf (errmsg, "Error allocating memory for the NDSI variance");
-        error_handler (true, FUNC_NAME, errmsg);
-        exit (ERROR);
+        if (map_input (refl_input) != SUCCESS)
+        {
+            sprintf (errmsg, "Reading the reflectance bands since they "
+                "couldn't be mapped");
+            error_handler (false, FUNC_NAME, errmsg);
+        }
+        else if (verbose)
+            printf ("  Mapped the reflectance bands\n");
     }
 
-    b1_var = calloc (refl_input->nsamps, sizeof (float));
-    if (b1_var == NULL)
+    /* Allocate one arena for the NDVI and NDSI, which hold proc_nlines plus
+       the variance halo above and below, and the variance strips, which
+       hold proc_nlines of each.  The strips are completely written for each
+       strip before they are read, so they aren't cleared to 0s. */
+    index_size = (size_t) (proc_nlines + 2*PROC_HALO) * refl_input->nsamps *
+        sizeof (float);
+    var_size = (size_t) proc_nlines * refl_input->nsamps * sizeof (float);
+    init_arena (&strip_arena);
+    if (reserve_arena (&strip_arena, 2 * ARENA_SIZE (index_size) +
+        NUM_VARIANCE * ARENA_SIZE (var_size)) != SUCCESS)
     {
-        sprintf (errmsg, "Error allocating memory for the band1 variance");
+        sprintf (errmsg, "Error allocating memory for the NDVI, NDSI, and "
+            "variance strips");
         error_handler (true, FUNC_NAME, errmsg);
         exit (ERROR);
     }
-
-    b2_var = calloc (refl_input->nsamps, sizeof (float));
-    if (b2_var == NULL)
+    ndvi = carve_arena (&strip_arena, index_size, false);
+    ndsi = carve_arena (&strip_arena, index_size, false);
+    for (ib = 0; ib < NUM_VARIANCE; ib++)
+        var_strip[ib] = carve_arena (&strip_arena, var_size, false);
+    var_indices[0] = ndvi;
+    var_indices[1] = ndsi;
+    init_cloud_spans (&cloud_spans);
+
+    /* Allocate the revised cloud mask, whole band, if the cloud masks are
+       output.  The cloud masks are filtered and buffered as a whole once the
+       rule-based models have been run for all the strips. */
+    init_plane_store (scratch_dir, plane_mem_mb, &plane_store);
+    rev_cm_plane.data = NULL;
+    rev_lim_cm_plane.data = NULL;
+    if (write_masks)
     {
-        sprintf (errmsg, "Error allocating memory for the band2 variance");
-        error_handler (true, FUNC_NAME, errmsg);
-        exit (ERROR);
-    }
+        if (alloc_plane (&plane_store, (size_t) refl_input->nlines *
+            refl_input->nsamps * sizeof (uint8), &rev_cm_plane) != SUCCESS)
+        {
+            sprintf (errmsg, "Error allocating memory for the revised cloud "
+                "mask");
+            error_handler (true, FUNC_NAME, errmsg);
+            exit (ERROR);
+        }
+        rev_cm = rev_cm_plane.data;
 
-    b3_var = calloc (refl_input->nsamps, sizeof (float));
-    if (b3_var == NULL)
-    {
-        sprintf (errmsg, "Error allocating memory for the band3 variance");
-        error_handler (true, FUNC_NAME, errmsg);
-        exit (ERROR);
+        /* Allocate the limited revised cloud mask, whole band */
+        if (alloc_plane (&plane_store, (size_t) refl_input->nlines *
+            refl_input->nsamps * sizeof (uint8), &rev_lim_cm_plane) != SUCCESS)
+        {
+            sprintf (errmsg, "Error allocating memory for the limited revised "
+                "cloud mask");
+            error_handler (true, FUNC_NAME, errmsg);
+            exit (ERROR);
+        }
+        rev_lim_cm = rev_lim_cm_plane.data;
+        if (mem_budget_mb > 0)
+            printf ("  Cloud mask planes mapped from scratch files: %d of 2\n",
+                plane_store.nmapped);
     }
 
-    b4_var = calloc (refl_input->nsamps, sizeof (float));
-    if (b4_var == NULL)
-    {
-        sprintf (errmsg, "Error allocating memory for the band4 variance");
+    /* Open the specified output files and create the metadata structure */
+    cm_output = open_output (&xml_metadata, refl_input, num_cm, write_band,
+        short_cm_names, long_cm_names, cm_data_units, toa_refl, write_mode,
+        shard_count > 0);
+    if (cm_output == NULL)
+    {   /* error message already printed */
         error_handler (true, FUNC_NAME, errmsg);
         exit (ERROR);
     }
-
-    b5_var = calloc (refl_input->nsamps, sizeof (float));
-    if (b5_var == NULL)
+    if (window.nlines > 0 &&
+        set_output_window (cm_output, &proc_window, &window) != SUCCESS)
     {
-        sprintf (errmsg, "Error allocating memory for the band5 variance");
+        sprintf (errmsg, "Error setting up the output window");
         error_handler (true, FUNC_NAME, errmsg);
         exit (ERROR);
     }
 
-    b7_var = calloc (refl_input->nsamps, sizeof (float));
-    if (b7_var == NULL)
+    /* Create the tiled output files.  The tiles hold the corner of the UL
+       pixel, where the XML file may hold its center. */
+    if (tiled_output)
     {
-        sprintf (errmsg, "Error allocating memory for the band7 variance");
-        error_handler (true, FUNC_NAME, errmsg);
-        exit (ERROR);
+        tile_ul[0] = xml_metadata.global.proj_info.ul_corner[0];
+        tile_ul[1] = xml_metadata.global.proj_info.ul_corner[1];
+        if (!strcmp (xml_metadata.global.proj_info.grid_origin, "CENTER"))
+        {
+            tile_ul[0] -= 0.5 * refl_input->pixsize[0];
+            tile_ul[1] += 0.5 * refl_input->pixsize[1];
+        }
+        if (open_output_tiles (cm_output, tile_ul) != SUCCESS)
+        {
+            sprintf (errmsg, "Error creating the tiled output files");
+            error_handler (true, FUNC_NAME, errmsg);
+            exit (ERROR);
+        }
     }
 
-    /* Allocate memory for the revised cfmask arrays, for one line */
-    rev_cm = calloc (refl_input->nsamps, sizeof (uint8));
-    if (rev_cm == NULL)
+    /* Print the processing status if verbose */
+    if (verbose)
     {
-        sprintf (errmsg, "Error allocating memory for the revised cloud mask");
-        error_handler (true, FUNC_NAME, errmsg);
-        exit (ERROR);
+        printf ("  Processing spectral indices, variances, and rule-based "
+            "models %d lines at a time\n", proc_nlines);
     }
 
-    rev_lim_cm = calloc (refl_input->nsamps, sizeof (uint8));
-    if (rev_lim_cm == NULL)
+    /* Loop through the lines and samples in the reflectance product,
+       computing the NDVI, NDSI, and the variances of the reflectance bands
+       and indices, then running the rule-based models on those in-memory
+       strips.  Each strip is read with PROC_HALO extra lines above and
+       below, where the scene has them, so the variance windows for the
+       lines in the strip are complete.  All the variance planes are computed
+       together in one pass over the strip. */
+    nlines_proc = proc_nlines;
+    for (line = 0; line < refl_input->nlines; line += proc_nlines)
     {
-        sprintf (errmsg, "Error allocating memory for the revised cloud mask");
-        error_handler (true, FUNC_NAME, errmsg);
-        exit (ERROR);
-    }
+        /* Do we have nlines_proc left to process? */
+        if (line + nlines_proc >= refl_input->nlines)
+            nlines_proc = refl_input->nlines - line;
 
-    /* Print the processing status if verbose */
-    if (verbose)
-        printf ("  Running the rule-based models\n");
+        /* Determine the lines to be read, including the halo */
+        halo_top = (line < PROC_HALO) ? line : PROC_HALO;
+        strip_start = line - halo_top;
+        strip_nlines = halo_top + nlines_proc + PROC_HALO;
+        if (strip_start + strip_nlines > refl_input->nlines)
+            strip_nlines = refl_input->nlines - strip_start;
 
-    /* Run the rule-based models one line at a time to compute the revised
-       cloud masks */
-    for (line = 0; line < refl_input->nlines; line++)
-    {
-        /* Read the reflectance bands */
+        /* Read the current lines from the reflectance file for each of the
+           reflectance bands */
+        strip_pix = (long long) nlines_proc * refl_input->nsamps;
+        start_profile_stage (&prof, &mark);
         for (ib = 0; ib < refl_input->nrefl_band; ib++)
         {
-            if (get_input_refl_lines (refl_input, ib, line, 1, NULL) != SUCCESS)
+            if (get_input_refl_lines (refl_input, ib, strip_start,
+                strip_nlines, NULL) != SUCCESS)
             {
-                sprintf (errmsg, "Error reading reflectance band %d", ib);
+                sprintf (errmsg, "Error reading %d lines from band %d of the "
+                    "reflectance file starting at line %d", strip_nlines, ib,
+                    strip_start);
                 error_handler (true, FUNC_NAME, errmsg);
                 exit (ERROR);
             }
-        }
+        }  /* end for ib */
 
-        /* Read the cfmask */
-        if (get_input_cfmask_lines (refl_input, line, 1, NULL) != SUCCESS)
+        /* Read the cfmask for the current lines, no halo is needed */
+        if (get_input_cfmask_lines (refl_input, line, nlines_proc, NULL)
+            != SUCCESS)
         {
-            sprintf (errmsg, "Error reading reflectance band %d", ib);
+            sprintf (errmsg, "Error reading %d lines from the cfmask file "
+                "starting at line %d", nlines_proc, line);
             error_handler (true, FUNC_NAME, errmsg);
             exit (ERROR);
         }
-
-        /* Read the index bands */
-        for (ib = CM_NDVI; ib <= CM_NDSI; ib++)
+        stop_profile_stage (&prof, RP_INPUT_READ, &mark, strip_pix,
+            (long long) strip_nlines * refl_input->nsamps *
+            refl_input->nrefl_band * sizeof (int16) +
+            strip_pix * sizeof (uint8), 0);
+
+        /* Start reading the next strip, with its halo, in the background */
+        advise_input_lines (refl_input, line + proc_nlines - PROC_HALO,
+            proc_nlines + 2*PROC_HALO);
+
+        /* Index the cfmask cloud pixels in the current strip.  These are the
+           only pixels revised by the rule-based models, so they're only
+           needed for the revised cloud masks. */
+        if (write_masks)
         {
-            /* Read the index band from the output file */
-            switch (ib)
-            {
-                case CM_NDVI:
-                    ptr = ndvi; break;
-                case CM_NDSI:
-                    ptr = ndsi; break;
-            }
-            if (get_output_lines (cm_output, ib, line, 1, sizeof(float), ptr)
-                != SUCCESS)
+            start_profile_stage (&prof, &mark);
+            if (build_cloud_spans (refl_input->cfmask_buf, nlines_proc,
+                refl_input->nsamps, &cloud_spans) != SUCCESS)
             {
-                sprintf (errmsg, "Error reading band %d of indices", ib);
+                sprintf (errmsg, "Error indexing the cloud pixels for line "
+                    "%d", line);
                 error_handler (true, FUNC_NAME, errmsg);
                 exit (ERROR);
             }
+            ncloud_pix += cloud_spans.npix;
+            stop_profile_stage (&prof, RP_CLOUD_SPANS, &mark, strip_pix, 0,
+                0);
         }
 
-        /* Read the variance bands */
-        for (ib = VARIANCE_B1; ib <= VARIANCE_NDSI; ib++)
+        /* Compute the NDVI
+           NDVI = (nir - red) / (nir + red)
+           Only the valid span of each line, found as the bands were read,
+           is computed; the fill corners of the scene are set to fill. */
+        start_profile_stage (&prof, &mark);
+        make_index (refl_input->refl_buf[3] /*b4*/,
+            refl_input->refl_buf[2] /*b3*/, refl_input->refl_fill,
+            refl_input->refl_saturate_val, strip_nlines, refl_input->nsamps,
+            refl_input->span, ndvi);
+
+        /* Compute the NDSI
+           NDSI = (green - mir) / (green + mir) */
+        make_index (refl_input->refl_buf[1] /*b2*/,
+            refl_input->refl_buf[4] /*b5*/, refl_input->refl_fill,
+            refl_input->refl_saturate_val, strip_nlines, refl_input->nsamps,
+            refl_input->span, ndsi);
+        stop_profile_stage (&prof, RP_INDEX, &mark,
+            (long long) strip_nlines * refl_input->nsamps, 0, 0);
+
+        /* Compute the variances for the reflectance bands, NDVI, and NDSI.
+           The reflectance bands are passed as-is (unscaled int16).  The
+           indices use the reflectance fill value, as they always have.
+           Unless the full variance bands are being written, the variances
+           are only computed for the cloud pixels, and only if the revised
+           cloud masks are output and the strip has cloud pixels. */
+        if (write_variance || (write_masks && cloud_spans.npix > 0))
         {
-            /* Read the index or variance band from the output file */
-            switch (ib)
+            start_profile_stage (&prof, &mark);
+            if (variance_strip (refl_input->refl_buf, refl_input->nrefl_band,
+                var_indices, 2, refl_input->refl_fill, VARIANCE_WINDOW,
+                strip_nlines, refl_input->nsamps, halo_top, nlines_proc,
+                write_variance ? NULL : &cloud_spans, var_strip) != SUCCESS)
             {
-                case VARIANCE_B1:
-                    ptr = b1_var; break;
-                case VARIANCE_B2:
-                    ptr = b2_var; break;
-                case VARIANCE_B3:
-                    ptr = b3_var; break;
-                case VARIANCE_B4:
-                    ptr = b4_var; break;
-                case VARIANCE_B5:
-                    ptr = b5_var; break;
-                case VARIANCE_B7:
-                    ptr = b7_var; break;
-                case VARIANCE_NDVI:
-                    ptr = ndvi_var; break;
-                case VARIANCE_NDSI:
-                    ptr = ndsi_var; break;
-            }
-            if (get_output_lines (cm_output, ib, line, 1, sizeof(float), ptr)
-                != SUCCESS)
-            {
-                sprintf (errmsg, "Error reading band %d of variances", ib);
+                sprintf (errmsg, "Error computing variances for line %d",
+                    line);
                 error_handler (true, FUNC_NAME, errmsg);
                 exit (ERROR);
             }
+            stop_profile_stage (&prof, RP_VARIANCE, &mark,
+                write_variance ? strip_pix : cloud_spans.npix, 0, 0);
         }
 
-        /* Run the rule-based models on all the input data */
-        rule_based_model (refl_input, ndsi, ndvi, b1_var, b2_var, b4_var,
-            b5_var, b7_var, ndvi_var, ndsi_var, refl_input->nsamps, rev_cm,
-            rev_lim_cm);
+        /* First pixel of the strip, skipping the halo lines read above it */
+        pix = halo_top * refl_input->nsamps;
 
-        /* Write the revised cloud masks */
-        if (put_output_lines (cm_output, rev_cm, REVISED_CM, line, 1,
-            sizeof (uint8)) != SUCCESS)
+        /* Run the rule-based models on the current strip, skipping the halo
+           lines of the reflectance bands and indices.  The cloudy pixels of
+           each chunk of the strip are gathered into blocks so the blocks
+           stay full even when the cloud spans are short, and the chunks are
+           divided among the threads.  A strip without cloud pixels is
+           left as not cloudy. */
+        if (write_masks && cloud_spans.npix == 0)
         {
-            sprintf (errmsg, "Writing revised cloud mask for line %d", line);
-            error_handler (true, FUNC_NAME, errmsg);
-            exit (ERROR);
+            memset (&rev_cm[(long) line * refl_input->nsamps], 0,
+                (size_t) nlines_proc * refl_input->nsamps);
+            memset (&rev_lim_cm[(long) line * refl_input->nsamps], 0,
+                (size_t) nlines_proc * refl_input->nsamps);
+            nclear_strips++;
         }
-
-        if (put_output_lines (cm_output, rev_lim_cm, REVISED_LIM_CM, line, 1,
-            sizeof (uint8)) != SUCCESS)
+        else if (write_masks)
         {
-            sprintf (errmsg, "Writing revised limited cloud mask for line %d",
-                line);
-            error_handler (true, FUNC_NAME, errmsg);
-            exit (ERROR);
+            start_profile_stage (&prof, &mark);
+            for (ib = 0; ib < refl_input->nrefl_band; ib++)
+                strip_refl[ib] = &refl_input->refl_buf[ib][pix];
+#ifdef _OPENMP
+            #pragma omp parallel for private(ib, chunk_nlines, chunk_pix, \
+                chunk_refl) schedule(dynamic, 1)
+#endif
+            for (chunk = 0; chunk < nlines_proc; chunk += PROC_CHUNK_NLINES)
+            {
+                chunk_nlines = (chunk + PROC_CHUNK_NLINES < nlines_proc) ?
+                    PROC_CHUNK_NLINES : nlines_proc - chunk;
+                chunk_pix = (long) chunk * refl_input->nsamps;
+                for (ib = 0; ib < refl_input->nrefl_band; ib++)
+                    chunk_refl[ib] = &strip_refl[ib][chunk_pix];
+                rule_based_model (&conserv_model, &lim_model, chunk_refl,
+                    &refl_input->cfmask_buf[chunk_pix],
+                    &ndsi[pix + chunk_pix], &ndvi[pix + chunk_pix],
+                    &var_strip[VARIANCE_B1-VARIANCE_B1][chunk_pix],
+                    &var_strip[VARIANCE_B2-VARIANCE_B1][chunk_pix],
+                    &var_strip[VARIANCE_B4-VARIANCE_B1][chunk_pix],
+                    &var_strip[VARIANCE_B5-VARIANCE_B1][chunk_pix],
+                    &var_strip[VARIANCE_B7-VARIANCE_B1][chunk_pix],
+                    &var_strip[VARIANCE_NDVI-VARIANCE_B1][chunk_pix],
+                    &var_strip[VARIANCE_NDSI-VARIANCE_B1][chunk_pix],
+                    chunk_nlines * refl_input->nsamps,
+                    &rev_cm[(long) (line + chunk) * refl_input->nsamps],
+                    &rev_lim_cm[(long) (line + chunk) *
+                    refl_input->nsamps]);
+            }
+            stop_profile_stage (&prof, RP_RULES, &mark, cloud_spans.npix, 0,
+                0);
         }
-    }  /* end for line */
-
-    /* Print the processing status if verbose */
-    if (verbose)
-        printf ("  Rule-based models -- complete\n");
-
-    /* Free the index and variance pointers */
-    free (ndvi);
-    free (ndsi);
-    free (b1_var);
-    free (b2_var);
-    free (b3_var);
-    free (b4_var);
-    free (b5_var);
-    free (b7_var);
-    free (ndvi_var);
-    free (ndsi_var);
-    free (rev_cm);
-    free (rev_lim_cm);
-
-    /* Print the processing status if verbose */
-    if (verbose)
-        printf ("  Running the erosion and dilation filters on the revised "
-            "cloud mask\n");
-
-    /* Set up a 5x5 kernel for applying the erosion and dilation */
-    element = cvCreateStructuringElementEx (5, 5, 1, 1, CV_SHAPE_RECT, NULL);
-    if (element == NULL)
-    {
-        sprintf (errmsg, "Unable to establish a 5x5 kernel for erosion and "
-            "dilation.");
-        error_handler (true, FUNC_NAME, errmsg);
-        exit (ERROR);
-    }
 
-    /* Create the OpenCV image to be used for the erosion and dilation */
-    cv_img = cvCreateImage (cvSize (cm_output->nsamps, cm_output->nlines),
-        IPL_DEPTH_8U, 1);
-    if (cv_img == NULL)
-    {
-        sprintf (errmsg, "Unable to create the OpenCV image");
-        error_handler (true, FUNC_NAME, errmsg);
-        exit (ERROR);
-    }
-    opencv_img = (uint8 *)cv_img->imageData;
-
-    /* Allocate memory for the revised cloud mask */
-    rev_cm = calloc (refl_input->nlines * refl_input->nsamps, sizeof (uint8));
-    if (rev_cm == NULL)
-    {
-        sprintf (errmsg, "Error allocating memory for the revised cloud mask");
-        error_handler (true, FUNC_NAME, errmsg);
-        exit (ERROR);
-    }
-
-    /* Allocate memory for the limited revised cloud mask */
-    rev_lim_cm = calloc (refl_input->nlines * refl_input->nsamps,
-        sizeof (uint8));
-    if (rev_lim_cm == NULL)
-    {
-        sprintf (errmsg, "Error allocating memory for the limited revised "
-            "cloud mask");
-        error_handler (true, FUNC_NAME, errmsg);
-        exit (ERROR);
-    }
-
-    /* Read the revised cloud mask */
-    if (get_output_lines (cm_output, REVISED_CM, 0, cm_output->nlines,
-        sizeof(uint8), rev_cm) != SUCCESS)
-    {
-        sprintf (errmsg, "Reading the revised cloud mask band");
-        error_handler (true, FUNC_NAME, errmsg);
-        exit (ERROR);
-    }
-
-    /* Loop through the revised cloud mask and put it in the OpenCV image */
-    for (line = 0; line < cm_output->nlines; line++)
-        for (samp = 0; samp < cm_output->nsamps; samp++)
+        /* Write the NDVI, NDSI, and variance bands which were requested */
+        if (nindex_out > 0)
         {
-            opencv_img[line*cv_img->widthStep + samp] =
-                rev_cm[line*cm_output->nsamps + samp];
-        }
+            start_profile_stage (&prof, &mark);
+            if (write_band[CM_NDVI] && put_output_lines (cm_output,
+                &ndvi[pix], CM_NDVI, line, nlines_proc, sizeof (float)) !=
+                SUCCESS)
+            {
+                sprintf (errmsg, "Writing output NDVI data for line %d", line);
+                error_handler (true, FUNC_NAME, errmsg);
+                exit (ERROR);
+            }
 
-    /* Apply the erosion and dilation filters to the revised cloud mask */
-    cvErode (cv_img, cv_img, element, 1);
-    cvDilate (cv_img, cv_img, element, 1);
+            if (write_band[CM_NDSI] && put_output_lines (cm_output,
+                &ndsi[pix], CM_NDSI, line, nlines_proc, sizeof (float)) !=
+                SUCCESS)
+            {
+                sprintf (errmsg, "Writing output NDSI data for line %d", line);
+                error_handler (true, FUNC_NAME, errmsg);
+                exit (ERROR);
+            }
 
-    /* Loop through OpenCV image and put it back in the revised cloud mask */
-    opencv_img = (uint8 *)cv_img->imageData;
-    for (line = 0; line < cm_output->nlines; line++)
-        for (samp = 0; samp < cm_output->nsamps; samp++)
-        {
-            rev_cm[line*cm_output->nsamps + samp] =
-                opencv_img[line*cv_img->widthStep + samp];
+            for (ib = 0; ib < NUM_VARIANCE; ib++)
+            {
+                if (write_band[VARIANCE_B1+ib] && put_output_lines (cm_output,
+                    var_strip[ib], VARIANCE_B1+ib, line, nlines_proc,
+                    sizeof (float)) != SUCCESS)
+                {
+                    sprintf (errmsg, "Error writing variance band %d for "
+                        "line %d", ib, line);
+                    error_handler (true, FUNC_NAME, errmsg);
+                    exit (ERROR);
+                }
+            }
+            stop_profile_stage (&prof, RP_OUTPUT_WRITE, &mark, strip_pix, 0,
+                strip_pix * nindex_out * sizeof (float));
         }
+    }  /* end for line */
 
-    /* Print the processing status if verbose */
-    if (verbose)
-        printf ("  Erosion and dilation -- complete\n");
+    /* Free the index and variance strips and the cloud index */
+    free_arena (&strip_arena);
+    free_cloud_spans (&cloud_spans);
+    free_rule_model (&conserv_model);
+    free_rule_model (&lim_model);
 
     /* Print the processing status if verbose */
     if (verbose)
-        printf ("  Running the erosion and dilation filters on the revised "
-            "limited cloud mask\n");
-
-    /* Read the limited cloud mask */
-    if (get_output_lines (cm_output, REVISED_LIM_CM, 0, cm_output->nlines,
-        sizeof(uint8), rev_lim_cm) != SUCCESS)
     {
-        sprintf (errmsg, "Reading the revised limited cloud mask band");
-        error_handler (true, FUNC_NAME, errmsg);
-        exit (ERROR);
+        printf ("  Number of cfmask cloud pixels: %ld\n", ncloud_pix);
+        if (write_masks)
+            printf ("  Strips without cfmask cloud: %d\n", nclear_strips);
+        printf ("  Spectral indices, variances, and rule-based models -- "
+            "complete\n");
     }
 
-    /* Loop through the revised limited cloud mask and put it in the OpenCV
-       image */
-    for (line = 0; line < cm_output->nlines; line++)
-        for (samp = 0; samp < cm_output->nsamps; samp++)
+    /* Print the processing status if verbose */
+    if (verbose && write_masks)
+        printf ("  Running the erosion, dilation, and buffering on the revised "
+            "cloud mask and the revised limited cloud mask\n");
+
+    /* The two revised cloud masks are independent, so they are filtered and
+       buffered at the same time.  Only the masks which are output are
+       filtered and buffered. */
+    morph_status[0] = SUCCESS;
+    morph_status[1] = SUCCESS;
+    start_profile_stage (&prof, &mark);
+#ifdef _OPENMP
+    #pragma omp parallel sections
+#endif
+    {
+#ifdef _OPENMP
+        #pragma omp section
+#endif
         {
-            opencv_img[line*cv_img->widthStep + samp] =
-                rev_lim_cm[line*cm_output->nsamps + samp];
+            /* Apply the erosion and dilation filters to the revised cloud
+               mask, using a 5x5 kernel anchored at (1,1), then apply a 7
+               pixel buffer to all cloudy pixels */
+            if (write_band[REVISED_CM])
+                morph_status[0] = morph_buffer_mask (rev_cm,
+                    refl_input->nlines, refl_input->nsamps, 5, 1, 6);
         }
-
-    /* Apply the erosion and dilation filters to the revised limited cloud
-       mask.  Given there are more false clouds (speckles), let's use a
-       2-pass erosion followed by dilation. */
-    cvErode (cv_img, cv_img, NULL, 2);
-    cvDilate (cv_img, cv_img, NULL, 2);
-
-    /* Loop through OpenCV image and put it back in the revised cloud mask
-       for buffering */
-    for (line = 0; line < cm_output->nlines; line++)
-        for (samp = 0; samp < cm_output->nsamps; samp++)
+#ifdef _OPENMP
+        #pragma omp section
+#endif
         {
-            rev_lim_cm[line*cm_output->nsamps + samp] =
-                opencv_img[line*cv_img->widthStep + samp];
+            /* Apply the erosion and dilation filters to the revised limited
+               cloud mask.  Given there are more false clouds (speckles),
+               let's use a 2-pass erosion followed by dilation with a 3x3
+               kernel, which is the same as a 5x5 kernel anchored at the
+               center.  Then apply a 7 pixel buffer to all cloudy pixels. */
+            if (write_band[REVISED_LIM_CM])
+                morph_status[1] = morph_buffer_mask (rev_lim_cm,
+                    refl_input->nlines, refl_input->nsamps, 5, 2, 6);
         }
-
-    /* Release the OpenCV image and structuring element */
-    cvReleaseImage (&cv_img);
-    cvReleaseStructuringElement (&element);
-    
-    /* Print the processing status if verbose */
-    if (verbose)
-        printf ("  Erosion and dilation -- complete\n");
-
-    /* Print the processing status if verbose */
-    if (verbose)
-        printf ("  Buffering the revised cloud mask\n");
-
-    /* Allocate memory for the buffered cloud mask */
-    buff_cm = calloc (refl_input->nlines * refl_input->nsamps, sizeof (uint8));
-    if (buff_cm == NULL)
+    }
+    if (morph_status[0] != SUCCESS)
     {
-        sprintf (errmsg, "Error allocating memory for the buffered cloud mask");
+        sprintf (errmsg, "Filtering and buffering revised cloud mask band");
         error_handler (true, FUNC_NAME, errmsg);
         exit (ERROR);
     }
-
-    /* Apply a 7 pixel buffer to all cloudy pixels in the revised cloud mask */
-    if (buffer (rev_cm, 6, cm_output->nlines, cm_output->nsamps, buff_cm) !=
-        SUCCESS)
+    if (morph_status[1] != SUCCESS)
     {
-        sprintf (errmsg, "Buffering revised cloud mask band");
+        sprintf (errmsg, "Filtering and buffering limited revised cloud mask "
+            "band");
         error_handler (true, FUNC_NAME, errmsg);
         exit (ERROR);
     }
+    stop_profile_stage (&prof, RP_MORPH_BUFFER, &mark,
+        (long long) nmasks_out * refl_input->nlines * refl_input->nsamps, 0,
+        0);
 
     /* Write the revised buffered cloud mask */
-    if (put_output_lines (cm_output, buff_cm, REVISED_CM, 0, cm_output->nlines,
-        sizeof (uint8)) != SUCCESS)
+    start_profile_stage (&prof, &mark);
+    if (write_band[REVISED_CM] && put_output_lines (cm_output, rev_cm,
+        REVISED_CM, 0, refl_input->nlines, sizeof (uint8)) != SUCCESS)
     {
         sprintf (errmsg, "Writing revised cloud mask band");
         error_handler (true, FUNC_NAME, errmsg);
         exit (ERROR);
     }
 
-    /* Print the processing status if verbose */
-    if (verbose)
-        printf ("  Buffering the limited revised cloud mask\n");
-
-    /* Apply a 7 pixel buffer to all cloudy pixels in the limited revised
-       cloud mask */
-    if (buffer (rev_lim_cm, 6, cm_output->nlines, cm_output->nsamps, buff_cm) !=
+    /* Write the limited revised buffered cloud mask */
+    if (write_band[REVISED_LIM_CM] && put_output_lines (cm_output,
+        rev_lim_cm, REVISED_LIM_CM, 0, refl_input->nlines, sizeof (uint8)) !=
         SUCCESS)
-    {
-        sprintf (errmsg, "Buffering limited revised cloud mask band");
-        error_handler (true, FUNC_NAME, errmsg);
-        exit (ERROR);
-    }
-
-    /* Write the revised buffered cloud mask */
-    if (put_output_lines (cm_output, buff_cm, REVISED_LIM_CM, 0,
-        cm_output->nlines, sizeof (uint8)) != SUCCESS)
     {
         sprintf (errmsg, "Writing limited revised cloud mask band");
         error_handler (true, FUNC_NAME, errmsg);
         exit (ERROR);
     }
+    stop_profile_stage (&prof, RP_OUTPUT_WRITE, &mark,
+        (long long) refl_input->nlines * refl_input->nsamps, 0,
+        (long long) nmasks_out * refl_input->nlines * refl_input->nsamps *
+        sizeof (uint8));
 
     /* Print the processing status if verbose */
-    if (verbose)
-        printf ("  Cloud buffering -- complete\n");
+    if (verbose && write_masks)
+        printf ("  Erosion, dilation, and cloud buffering -- complete\n");
 
-    /* Free the revised and buffered cloud masks */
-    free (rev_cm);
-    free (rev_lim_cm);
-    free (buff_cm);
+    /* Free the revised cloud masks */
+    free_plane (&plane_store, &rev_cm_plane);
+    free_plane (&plane_store, &rev_lim_cm_plane);
+    rev_cm = NULL;
+    rev_lim_cm = NULL;
 
     /* Close the reflectance product */
     close_input (refl_input);
     free_input (refl_input);
 
-    /* Write the ENVI header for spectral indices files */
-    for (ib = 0; ib < cm_output->nband; ib++)
+    /* Write the ENVI headers for the output files and append the bands to
+       the XML file.  For a sharded scene they are written by the finalize
+       step instead. */
+    if (shard_count == 0 && write_output_metadata (cm_output,
+        &xml_metadata.global, xml_infile) != SUCCESS)
     {
-        /* Create the ENVI header file this band */
-        if (create_envi_struct (&cm_output->metadata.band[ib],
-            &xml_metadata.global, &envi_hdr) != SUCCESS)
-        {
-            sprintf (errmsg, "Creating ENVI header structure.");
-            error_handler (true, FUNC_NAME, errmsg);
-            exit (ERROR);
-        }
-  
-        /* Write the ENVI header */
-        strcpy (envi_file, cm_output->metadata.band[ib].file_name);
-        cptr = strchr (envi_file, '.');
-        strcpy (cptr, ".hdr");
-        if (write_envi_hdr (envi_file, &envi_hdr) != SUCCESS)
-        {
-            sprintf (errmsg, "Writing ENVI header file.");
-            error_handler (true, FUNC_NAME, errmsg);
-            exit (ERROR);
-        }
-    }
-  
-    /* Append the spectral index bands to the XML file */
-    if (append_metadata (cm_output->nband, cm_output->metadata.band,
-        xml_infile) != SUCCESS)
-    {
-        sprintf (errmsg, "Appending revised cloud mask bands to XML file.");
+        sprintf (errmsg, "Writing the metadata of the revised cloud mask "
+            "products");
         error_handler (true, FUNC_NAME, errmsg);
         exit (ERROR);
     }
-  
+
     /* Free the metadata structure */
     free_metadata (&xml_metadata);
 
-    /* Close the output revised cloud mask product */
-    close_output (cm_output);
+    /* Close the output revised cloud mask product, which flushes the lines
+       still held in the write buffers */
+    start_profile_stage (&prof, &mark);
+    if (close_output (cm_output) != SUCCESS)
+    {
+        sprintf (errmsg, "Closing the revised cloud mask products.");
+        error_handler (true, FUNC_NAME, errmsg);
+        exit (ERROR);
+    }
+    stop_profile_stage (&prof, RP_OUTPUT_WRITE, &mark, 0, 0, 0);
+
+    /* Print the output write statistics if verbose */
+    if (verbose)
+    {
+        printf ("  Output write statistics:\n");
+        print_output_stats (cm_output);
+    }
     free_output (cm_output);
 
+    /* Write the profile of the processing stages, if requested */
+    if (write_profile (&prof, "revised_cloud_mask", nthreads, profile_file)
+        != SUCCESS)
+    {
+        sprintf (errmsg, "Error writing the profile");
+        error_handler (true, FUNC_NAME, errmsg);
+        exit (ERROR);
+    }
+
     /* Free the filename pointers */
     free (xml_infile);
+    free (rules_file);
+    free (lim_rules_file);
+    free (scratch_dir);
+    free (profile_file);
+    free (outputs);
 
     /* Indicate successful completion of processing */
     printf ("Revised cloud mask processing complete!\n");
@@ -881,12 +1316,78 @@ void usage ()
             "will clean up the cloud mask to correctly identify the snow "
             "pixels.\n\n");
     printf ("usage: revised_cloud_mask "
-            "--xml=input_xml_filename [--verbose]\n");
+            "--xml=input_xml_filename [--rules_file=conservative_rules] "
+            "[--lim_rules_file=limited_rules] [--write_intermediate] "
+            "[--write_mode=cached|dontneed|direct] [--scratch_dir=dir] "
+            "[--plane_mem_mb=megabytes] [--profile[=profile_file]] "
+            "[--window=line0,samp0,nlines,nsamps] "
+            "[--mem_budget_mb=megabytes] [--tiled_output] [--mmap_input] "
+            "[--threads=num_threads] [--shard=index,count] "
+            "[--shard_finalize] [--outputs=band[,band...]] [--verbose]\n");
 
     printf ("\nwhere the following parameters are required:\n");
     printf ("    -xml: name of the input XML file to be processed\n");
 
     printf ("\nwhere the following parameters are optional:\n");
+    printf ("    -rules_file: name of a C5.0 rules file to be used for the "
+            "conservative model, which uses the variances (default is the "
+            "built-in rules)\n");
+    printf ("    -lim_rules_file: name of a C5.0 rules file to be used for "
+            "the limited model, which does not use the variances (default is "
+            "the built-in rules)\n");
+    printf ("    -write_intermediate: should the NDVI, NDSI, and variance "
+            "bands be written as output products? (default is false, only "
+            "the revised cloud masks are written)\n");
+    printf ("    -write_mode: how the output bands are written; cached writes "
+            "through the page cache, dontneed drops the written blocks from "
+            "the page cache, and direct writes the blocks with O_DIRECT "
+            "(default is cached)\n");
+    printf ("    -scratch_dir: directory for scratch files, which hold the "
+            "whole-scene cloud masks when they don't fit in the plane memory "
+            "(default is to hold them in memory)\n");
+    printf ("    -plane_mem_mb: megabytes of whole-scene cloud masks to hold "
+            "in memory before using the scratch files; only used with "
+            "--scratch_dir (default is 0)\n");
+    printf ("    -profile: write a JSON summary of the time, bytes, and "
+            "pixels per second of each processing stage, to profile_file "
+            "if given, otherwise to stdout (default is no profile)\n");
+    printf ("    -window: only process the window of nlines lines and "
+            "nsamps samples starting at line line0 and sample samp0 (0-based) "
+            "of the scene.  The output bands cover the whole scene, with fill "
+            "outside the window (default is the whole scene)\n");
+    printf ("    -mem_budget_mb: megabytes of memory for the processing "
+            "buffers.  The strip height and the megabytes of cloud masks "
+            "held in memory are picked to fit, and the choices are reported. "
+            "Can't be used with --plane_mem_mb. (default is strips of %d "
+            "lines)\n", PROC_NLINES);
+    printf ("    -tiled_output: should each output band also be written to "
+            "a tiled file with overviews, named after the band file with "
+            ".tile in place of .img?  The tiles are %dx%d pixels and deflate "
+            "compressed, and the overviews hold every other line and sample "
+            "of the level before them. (default is false)\n", TILE_SIZE,
+            TILE_SIZE);
+    printf ("    -mmap_input: should the reflectance bands be mapped into "
+            "memory, so the lines of each strip are used in place rather "
+            "than read? (default is false)\n");
+    printf ("    -threads: number of threads to use for processing "
+            "(default is the number of cores)\n");
+    printf ("    -shard: only process shard index (0-based) of the count "
+            "bands of lines the scene is split into, writing its lines to the "
+            "shared output bands.  Run one process for each shard, in any "
+            "order, on nodes sharing the output directory, then run "
+            "--shard_finalize.  Can't be used with --window or "
+            "--tiled_output. (default is the whole scene)\n");
+    printf ("    -shard_finalize: once all of the shards have completed, only "
+            "write the ENVI headers of the output bands and append them to "
+            "the XML file.  Give it the same --outputs or "
+            "--write_intermediate as the shards. Can't be used with --shard, "
+            "--window, or --tiled_output. (default is false)\n");
+    printf ("    -outputs: comma-separated list of the bands to be output, "
+            "from ndvi, ndsi, varb1, varb2, varb3, varb4, varb5, varb7, "
+            "varndvi, varndsi, revcm, and revlimcm.  Only what the listed "
+            "bands need is computed.  Can't be used with "
+            "--write_intermediate. (default is revcm and revlimcm, plus the "
+            "rest with --write_intermediate)\n");
     printf ("    -verbose: should intermediate messages be printed? (default "
             "is false)\n");
     printf ("\nrevised_cloud_mask --help will print the usage statement\n");
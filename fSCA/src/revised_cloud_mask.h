@@ -14,6 +14,41 @@
 #include "write_metadata.h"
 #include "envi_header.h"
 #include "error_handler.h"
+#include "rule_model.h"
+#include "plane_store.h"
+#include "arena.h"
+#include "profile.h"
+#include "spectral_index.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/* Run-length index of the cfmask cloud pixels in a strip; see
+   build_cloud_spans */
+typedef struct {
+    int nlines;         /* number of lines indexed */
+    int nspans;         /* total number of spans in the index */
+    long npix;          /* total number of pixels in the spans */
+    int max_lines;      /* allocated size of line_span */
+    int max_spans;      /* allocated size of span_start and span_end */
+    int *line_span;     /* index of the first span for each line, plus one
+                           extra entry holding nspans */
+    int *span_start;    /* first sample of each span */
+    int *span_end;      /* last sample of each span (inclusive) */
+} Span_index_t;
+
+/* Stages of the processing which are profiled with --profile */
+typedef enum {
+    RP_INPUT_READ=0,      /* reading the reflectance bands and cfmask */
+    RP_INDEX,             /* computing the NDVI and NDSI */
+    RP_CLOUD_SPANS,       /* indexing the cfmask cloud pixels */
+    RP_VARIANCE,          /* computing the variances */
+    RP_RULES,             /* running the rule-based models */
+    RP_MORPH_BUFFER,      /* erosion, dilation, and buffering of the revised
+                             cloud masks */
+    RP_OUTPUT_WRITE,      /* writing the output bands */
+    RP_NUM                /* number of profiled stages */
+} Rcm_profile_stage_t;
 
 /* Prototypes */
 void usage ();
@@ -23,6 +58,38 @@ short get_args
     int argc,             /* I: number of cmd-line args */
     char *argv[],         /* I: string of cmd-line args */
     char **xml_infile,    /* O: address of input XML file */
+    char **rules_file,    /* O: address of the C5.0 rules file for the
+                                conservative model (NULL if not specified) */
+    char **lim_rules_file, /* O: address of the C5.0 rules file for the
+                                 limited model (NULL if not specified) */
+    bool *write_intermediate, /* O: should the NDVI, NDSI, and variance
+                                    bands be written as output products */
+    Out_write_mode_t *write_mode, /* O: how the output bands are written */
+    char **scratch_dir,   /* O: address of the directory for the scratch
+                                files (NULL if not specified) */
+    long *plane_mem_mb,   /* O: megabytes of whole-scene planes to hold in
+                                memory before using scratch files */
+    bool *profile,        /* O: should the processing stages be profiled */
+    char **profile_file,  /* O: address of the profile JSON file (NULL for
+                                stdout or if not specified) */
+    Img_window_t *window, /* O: window of the scene to be processed; 0 lines
+                                for the whole scene */
+    long *mem_budget_mb,  /* O: megabytes of memory to size the strips and
+                                planes for; 0 for strips of PROC_NLINES
+                                lines */
+    bool *tiled_output,   /* O: should the bands also be written to tiled
+                                files */
+    bool *mmap_input,     /* O: should the reflectance bands be mapped
+                                rather than read */
+    int *nthreads,        /* O: number of threads for processing */
+    int *shard_index,     /* O: shard of the scene to be processed */
+    int *shard_count,     /* O: number of shards the scene is split into; 0
+                                if the scene isn't sharded */
+    bool *shard_finalize, /* O: should only the ENVI headers and XML file of
+                                a sharded scene be written */
+    char **outputs,       /* O: address of the comma-separated short names
+                                of the bands to be output (NULL for the
+                                default bands) */
     bool *verbose         /* O: verbose flag */
 );
 
@@ -36,24 +103,72 @@ void make_index
     int satu_value,       /* I: saturation value for the reflectance values */
     int nlines,           /* I: number of lines in the data arrays */
     int nsamps,           /* I: number of samples in the data arrays */
+    Valid_span_t *span,   /* I: valid span of each line, outside of which the
+                                pixels are fill in every band; NULL if all
+                                of the samples are processed */
     float *spec_indx      /* O: output spectral index */
 );
 
-void variance
+int variance
 (
     float *array,       /* I: input array of data for which to compute the
                               covariances */
     int fill_value,     /* I: fill value for the band */
+    int window,         /* I: size of the (square) variance window; must be
+                              odd */
     int nlines,         /* I: number of lines in the data arrays */
     int nsamps,         /* I: number of samples in the data arrays */
     float *variance     /* O: output variance array */
 );
 
+int variance_strip
+(
+    int16 **bands,      /* I: array of pointers to the int16 band planes */
+    int nbands,         /* I: number of int16 band planes */
+    float **indices,    /* I: array of pointers to the float index planes */
+    int nindices,       /* I: number of float index planes */
+    int fill_value,     /* I: fill value for the bands and indices */
+    int window,         /* I: size of the (square) variance window; must be
+                              odd */
+    int nlines,         /* I: number of lines in the input planes */
+    int nsamps,         /* I: number of samples in the planes */
+    int first_line,     /* I: first line in the input planes for which the
+                              variance is to be computed */
+    int nout_lines,     /* I: number of lines of variance to be computed */
+    Span_index_t *spans,  /* I: if not NULL, only compute the variance for
+                                the pixels in these spans (indexed from the
+                                first output line) */
+    float **variances   /* O: array of nbands + nindices pointers to the
+                              output variance planes */
+);
+
+void init_cloud_spans
+(
+    Span_index_t *spans    /* O: span index to be initialized */
+);
+
+void free_cloud_spans
+(
+    Span_index_t *spans    /* I/O: span index to be freed */
+);
+
+int build_cloud_spans
+(
+    uint8 *cfmask,         /* I: cfmask values for the strip */
+    int nlines,            /* I: number of lines in the strip */
+    int nsamps,            /* I: number of samples in the strip */
+    Span_index_t *spans    /* I/O: span index to be populated */
+);
+
 void rule_based_model
 (
-    Input_t *input_img,     /* I: pointer to input data structure containing
-                                  the scaled reflectance and cloud mask
-                                  buffers (reflectance bands are scaled) */
+    Rule_model_t *conserv_model, /* I: conservative rule model, which uses
+                                       the variances */
+    Rule_model_t *lim_model,     /* I: limited rule model, which does not use
+                                       the variances */
+    int16 **refl_arr,       /* I: array of pointers to the scaled reflectance
+                                  values for bands 1-5 and 7 */
+    uint8 *cfmask_arr,      /* I: cfmask values */
     float *ndsi_arr,        /* I: NDSI scaled values */
     float *ndvi_arr,        /* I: NDVI scaled values */
     float *b1_var_arr,      /* I: band1 variance values */
@@ -63,7 +178,7 @@ void rule_based_model
     float *b7_var_arr,      /* I: band7 variance values */
     float *ndvi_var_arr,    /* I: NDVI variance values */
     float *ndsi_var_arr,    /* I: NDSI variance values */
-    int nsamps,             /* I: number of samples in the input arrays */
+    int npix,               /* I: number of pixels in the input arrays */
     uint8 *rev_cloud_mask,      /* O: revised cloud mask */
     uint8 *rev_lim_cloud_mask   /* O: revised cloud mask without variances */
 );
@@ -78,4 +193,47 @@ short buffer
     uint8 *buff_array   /* O: output array with buffer applied */
 );
 
+void buffer_dist_line
+(
+    uint8 *in_line,     /* I: current line of the mask */
+    uint8 *prev_dist,   /* I: distances for the previous line; NULL for the
+                              first line */
+    int nsamps,         /* I: number of samples in the line */
+    int distance,       /* I: distance to buffer */
+    uint8 *dist_line    /* O: distances for the current line */
+);
+
+void buffer_mark_line
+(
+    uint8 *line_buf,    /* I/O: first-pass distances for the current line on
+                                input; buffered mask values on output */
+    uint8 *below,       /* I/O: distances for the line below on input; the
+                                distances for the current line on output */
+    int nsamps,         /* I: number of samples in the line */
+    int distance,       /* I: distance to buffer */
+    uint8 value         /* I: value for the buffered pixels */
+);
+
+short buffer_masks
+(
+    uint8 **arrays,     /* I: array of pointers to the masks to be buffered */
+    int nmasks,         /* I: number of masks */
+    int distance,       /* I: distance to buffer */
+    int nlines,         /* I: number of lines in the data arrays */
+    int nsamps,         /* I: number of samples in the data arrays */
+    uint8 **buff_arrays /* O: array of pointers to the output masks with the
+                              buffer applied */
+);
+
+short morph_buffer_mask
+(
+    uint8 *mask,        /* I/O: mask to be processed */
+    int nlines,         /* I: number of lines in the mask */
+    int nsamps,         /* I: number of samples in the mask */
+    int ksize,          /* I: size of the (square) structuring element */
+    int anchor,         /* I: anchor of the structuring element; between 0
+                              and ksize-1 */
+    int distance        /* I: distance to buffer */
+);
+
 #endif
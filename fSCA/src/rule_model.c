@@ -0,0 +1,647 @@
+#include <strings.h>
+#include "revised_cloud_mask.h"
+
+/* Feature names as used in the C5.0 rules files */
+static const struct {
+    char *name;                /* attribute name */
+    Rule_feature_t feature;    /* associated feature */
+} rule_features[] =
+{
+    {"b1", RF_B1}, {"b2", RF_B2}, {"b3", RF_B3}, {"b4", RF_B4},
+    {"b5", RF_B5}, {"b7", RF_B7}, {"b1_var", RF_B1_VAR},
+    {"b2_var", RF_B2_VAR}, {"b4_var", RF_B4_VAR}, {"b5_var", RF_B5_VAR},
+    {"b7_var", RF_B7_VAR}, {"ndvi", RF_NDVI}, {"ndsi", RF_NDSI},
+    {"ndvi_var", RF_NDVI_VAR}, {"ndsi_var", RF_NDSI_VAR}
+};
+
+
+/******************************************************************************
+MODULE:  init_rule_model
+
+PURPOSE:  Initializes the rule model so it holds no rules or memory.
+
+RETURN VALUE:
+Type = None
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+---------     ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+******************************************************************************/
+void init_rule_model
+(
+    Rule_model_t *model    /* O: rule model to be initialized */
+)
+{
+    model->ntrials = 0;
+    model->nrules = 0;
+    model->nconds = 0;
+    model->max_trials = 0;
+    model->max_rules = 0;
+    model->max_conds = 0;
+    model->max_class = 0;
+    model->trial_rule = NULL;
+    model->trial_default = NULL;
+    model->rule_cond = NULL;
+    model->rule_class = NULL;
+    model->cond_feature = NULL;
+    model->cond_op = NULL;
+    model->cond_thresh = NULL;
+}
+
+
+/******************************************************************************
+MODULE:  free_rule_model
+
+PURPOSE:  Frees the memory held by the rule model.
+
+RETURN VALUE:
+Type = None
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+---------     ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+******************************************************************************/
+void free_rule_model
+(
+    Rule_model_t *model    /* I/O: rule model to be freed */
+)
+{
+    free (model->trial_rule);
+    free (model->trial_default);
+    free (model->rule_cond);
+    free (model->rule_class);
+    free (model->cond_feature);
+    free (model->cond_op);
+    free (model->cond_thresh);
+    init_rule_model (model);
+}
+
+
+/******************************************************************************
+MODULE:  grow_array (static)
+
+PURPOSE:  Reallocates one of the rule model arrays to the new size.
+
+RETURN VALUE:
+Type = int
+Value          Description
+-----          -----------
+ERROR          Error allocating the memory
+SUCCESS        Successful completion
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+---------     ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. The array is left as-is if the reallocation fails.
+******************************************************************************/
+static int grow_array
+(
+    void **array,          /* I/O: address of the array to be reallocated */
+    int nelem,             /* I: new number of elements in the array */
+    size_t size            /* I: size of each element */
+)
+{
+    void *tmp_ptr = NULL;  /* reallocated array */
+
+    tmp_ptr = realloc (*array, nelem * size);
+    if (tmp_ptr == NULL)
+        return (ERROR);
+    *array = tmp_ptr;
+
+    return (SUCCESS);
+}
+
+
+/******************************************************************************
+MODULE:  add_rule_trial
+
+PURPOSE:  Starts a new trial (model run) in the rule model.  Rules added after
+this call belong to the new trial.
+
+RETURN VALUE:
+Type = int
+Value          Description
+-----          -----------
+ERROR          Error occurred adding the trial
+SUCCESS        Successful completion
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+---------     ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+******************************************************************************/
+int add_rule_trial
+(
+    int16 default_class,   /* I: default class for the trial */
+    Rule_model_t *model    /* I/O: rule model */
+)
+{
+    char FUNC_NAME[] = "add_rule_trial";   /* function name */
+    char errmsg[STR_SIZE];    /* error message */
+    int new_max;              /* new size of the trial arrays */
+
+    /* Grow the trial arrays if needed, leaving room for the extra entry in
+       trial_rule */
+    if (model->ntrials + 2 > model->max_trials)
+    {
+        new_max = (model->max_trials == 0) ? 8 : 2 * model->max_trials;
+        if (grow_array ((void **) &model->trial_rule, new_max,
+                sizeof (int)) != SUCCESS ||
+            grow_array ((void **) &model->trial_default, new_max,
+                sizeof (int16)) != SUCCESS)
+        {
+            strcpy (errmsg, "Error allocating memory for the rule trials.");
+            error_handler (true, FUNC_NAME, errmsg);
+            return (ERROR);
+        }
+        model->max_trials = new_max;
+    }
+
+    model->trial_rule[model->ntrials] = model->nrules;
+    model->trial_default[model->ntrials] = default_class;
+    model->ntrials++;
+    model->trial_rule[model->ntrials] = model->nrules;
+    if (default_class > model->max_class)
+        model->max_class = default_class;
+
+    return (SUCCESS);
+}
+
+
+/******************************************************************************
+MODULE:  add_rule
+
+PURPOSE:  Adds a new rule to the current trial of the rule model.  Conditions
+added after this call belong to the new rule.
+
+RETURN VALUE:
+Type = int
+Value          Description
+-----          -----------
+ERROR          Error occurred adding the rule
+SUCCESS        Successful completion
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+---------     ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. A rule without any conditions fires for every pixel which reaches it.
+******************************************************************************/
+int add_rule
+(
+    int16 class_code,      /* I: class assigned when the rule fires */
+    Rule_model_t *model    /* I/O: rule model */
+)
+{
+    char FUNC_NAME[] = "add_rule";   /* function name */
+    char errmsg[STR_SIZE];    /* error message */
+    int new_max;              /* new size of the rule arrays */
+
+    if (model->ntrials == 0)
+    {
+        strcpy (errmsg, "A trial must be added before the rules.");
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+
+    /* Grow the rule arrays if needed, leaving room for the extra entry in
+       rule_cond */
+    if (model->nrules + 2 > model->max_rules)
+    {
+        new_max = (model->max_rules == 0) ? 64 : 2 * model->max_rules;
+        if (grow_array ((void **) &model->rule_cond, new_max,
+                sizeof (int)) != SUCCESS ||
+            grow_array ((void **) &model->rule_class, new_max,
+                sizeof (int16)) != SUCCESS)
+        {
+            strcpy (errmsg, "Error allocating memory for the rules.");
+            error_handler (true, FUNC_NAME, errmsg);
+            return (ERROR);
+        }
+        model->max_rules = new_max;
+    }
+
+    model->rule_cond[model->nrules] = model->nconds;
+    model->rule_class[model->nrules] = class_code;
+    model->nrules++;
+    model->rule_cond[model->nrules] = model->nconds;
+    model->trial_rule[model->ntrials] = model->nrules;
+    if (class_code > model->max_class)
+        model->max_class = class_code;
+
+    return (SUCCESS);
+}
+
+
+/******************************************************************************
+MODULE:  add_rule_cond
+
+PURPOSE:  Adds a new condition to the current rule of the rule model.
+
+RETURN VALUE:
+Type = int
+Value          Description
+-----          -----------
+ERROR          Error occurred adding the condition
+SUCCESS        Successful completion
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+---------     ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. The features are evaluated as floats.  The threshold is stored as the
+     largest float which is less than or equal to the double threshold.  For
+     a float feature value x, x <= threshold is then the same as
+     x <= float threshold (and likewise for >), so the float compares give
+     the same results as comparing the feature values against the double
+     thresholds.
+******************************************************************************/
+int add_rule_cond
+(
+    Rule_feature_t feature,  /* I: feature being tested */
+    Rule_op_t op,            /* I: comparison against the threshold */
+    double threshold,        /* I: threshold for the comparison */
+    Rule_model_t *model      /* I/O: rule model */
+)
+{
+    char FUNC_NAME[] = "add_rule_cond";   /* function name */
+    char errmsg[STR_SIZE];    /* error message */
+    int new_max;              /* new size of the condition arrays */
+    float thresh;             /* threshold rounded down to a float */
+
+    if (model->nrules == 0)
+    {
+        strcpy (errmsg, "A rule must be added before the conditions.");
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+    if (feature < 0 || feature >= RF_NUM)
+    {
+        sprintf (errmsg, "Invalid rule feature %d", feature);
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+
+    /* Grow the condition arrays if needed */
+    if (model->nconds + 1 > model->max_conds)
+    {
+        new_max = (model->max_conds == 0) ? 256 : 2 * model->max_conds;
+        if (grow_array ((void **) &model->cond_feature, new_max,
+                sizeof (Rule_feature_t)) != SUCCESS ||
+            grow_array ((void **) &model->cond_op, new_max,
+                sizeof (Rule_op_t)) != SUCCESS ||
+            grow_array ((void **) &model->cond_thresh, new_max,
+                sizeof (float)) != SUCCESS)
+        {
+            strcpy (errmsg, "Error allocating memory for the rule "
+                "conditions.");
+            error_handler (true, FUNC_NAME, errmsg);
+            return (ERROR);
+        }
+        model->max_conds = new_max;
+    }
+
+    /* Round the threshold down to a float */
+    thresh = (float) threshold;
+    if ((double) thresh > threshold)
+        thresh = nextafterf (thresh, -HUGE_VALF);
+
+    model->cond_feature[model->nconds] = feature;
+    model->cond_op[model->nconds] = op;
+    model->cond_thresh[model->nconds] = thresh;
+    model->nconds++;
+    model->rule_cond[model->nrules] = model->nconds;
+
+    return (SUCCESS);
+}
+
+
+/******************************************************************************
+MODULE:  get_rules_value (static)
+
+PURPOSE:  Gets the value of the specified key="value" entry in a line of the
+C5.0 rules file.
+
+RETURN VALUE:
+Type = bool
+Value          Description
+-----          -----------
+false          Key was not found in the line
+true           Key was found and the value returned
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+---------     ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. The value is truncated to STR_SIZE characters.
+******************************************************************************/
+static bool get_rules_value
+(
+    char *line,            /* I: line from the rules file */
+    char *key,             /* I: key to be found */
+    char *value            /* O: value for the key (STR_SIZE characters) */
+)
+{
+    char *ptr = line;      /* current location in the line */
+    char *end = NULL;      /* end of the value */
+    int len;               /* length of the key or value */
+
+    len = strlen (key);
+    while ((ptr = strstr (ptr, key)) != NULL)
+    {
+        /* Make sure this is the whole key and is followed by =" */
+        if ((ptr == line || ptr[-1] == ' ') && ptr[len] == '=' &&
+            ptr[len+1] == '"')
+        {
+            ptr += len + 2;
+            end = strchr (ptr, '"');
+            if (end == NULL)
+                return (false);
+            len = end - ptr;
+            if (len > STR_SIZE - 1)
+                len = STR_SIZE - 1;
+            strncpy (value, ptr, len);
+            value[len] = '\0';
+            return (true);
+        }
+        ptr += len;
+    }
+
+    return (false);
+}
+
+
+/******************************************************************************
+MODULE:  get_rules_class (static)
+
+PURPOSE:  Converts a class name from the C5.0 rules file to the class value.
+
+RETURN VALUE:
+Type = int
+Value          Description
+-----          -----------
+ERROR          Class name is not known
+SUCCESS        Successful completion
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+---------     ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. The classes may be named cloud_free and cloud, or may be given as the
+     class values (50 and 100).
+******************************************************************************/
+static int get_rules_class
+(
+    char *name,            /* I: class name */
+    int16 *class_code      /* O: class value */
+)
+{
+    if (!strcasecmp (name, "cloud_free") ||
+        atoi (name) == RULE_CLOUD_FREE)
+        *class_code = RULE_CLOUD_FREE;
+    else if (!strcasecmp (name, "cloud") || atoi (name) == RULE_CLOUD)
+        *class_code = RULE_CLOUD;
+    else
+        return (ERROR);
+
+    return (SUCCESS);
+}
+
+
+/******************************************************************************
+MODULE:  read_rules_file
+
+PURPOSE:  Reads the rule sets from a C5.0 rules file into a rule model, so
+newly trained rules can be used without changing the code.
+
+RETURN VALUE:
+Type = int
+Value          Description
+-----          -----------
+ERROR          Error occurred reading the rules file
+SUCCESS        Successful completion
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+---------     ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. The model should be initialized via init_rule_model before calling this
+     routine.
+  2. The rules file holds one trial per rules="..." default="..." line
+     (boosted models have several trials), followed by a conds="..."
+     class="..." line for each rule and a type="2" att="..." cut="..."
+     result="<|>" line for each condition.  Other lines are ignored.
+  3. Only threshold conditions (type 2) on the features in rule_features
+     are supported.  A result of "<" is a <= test and ">" is a > test.
+******************************************************************************/
+int read_rules_file
+(
+    char *rules_file,      /* I: name of the C5.0 rules file */
+    Rule_model_t *model    /* O: rule model read from the file */
+)
+{
+    char FUNC_NAME[] = "read_rules_file";   /* function name */
+    char errmsg[STR_SIZE];    /* error message */
+    char line[STR_SIZE];      /* current line in the rules file */
+    char value[STR_SIZE];     /* value of the current key */
+    char value2[STR_SIZE];    /* value of the second key */
+    int line_num = 0;         /* line number in the rules file */
+    int nfeat;                /* number of known features */
+    int expected = 0;         /* expected number of conditions for the
+                                 current rule */
+    int i;                    /* looping variable for the features */
+    int16 class_code;         /* class for the current trial or rule */
+    Rule_op_t op;             /* comparison for the current condition */
+    FILE *fp = NULL;          /* file pointer for the rules file */
+
+    fp = fopen (rules_file, "r");
+    if (fp == NULL)
+    {
+        snprintf (errmsg, sizeof (errmsg),
+            "Error opening the rules file: %.*s", (int) (sizeof (errmsg) / 2),
+            rules_file);
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+
+    nfeat = sizeof (rule_features) / sizeof (rule_features[0]);
+    while (fgets (line, sizeof (line), fp) != NULL)
+    {
+        line_num++;
+
+        /* Check the number of conditions for the previous rule once a new
+           rule or trial is started */
+        if ((!strncmp (line, "rules=", 6) || !strncmp (line, "conds=", 6)) &&
+            model->nrules > 0 &&
+            model->rule_cond[model->nrules] -
+            model->rule_cond[model->nrules-1] != expected)
+        {
+            snprintf (errmsg, sizeof (errmsg),
+                "Rule ending before line %d of %.*s does not have the "
+                "expected %d conditions", line_num,
+                (int) (sizeof (errmsg) / 2), rules_file, expected);
+            error_handler (true, FUNC_NAME, errmsg);
+            fclose (fp);
+            return (ERROR);
+        }
+
+        if (!strncmp (line, "rules=", 6))
+        {   /* New trial */
+            if (!get_rules_value (line, "default", value) ||
+                get_rules_class (value, &class_code) != SUCCESS ||
+                add_rule_trial (class_code, model) != SUCCESS)
+            {
+                snprintf (errmsg, sizeof (errmsg),
+                    "Invalid trial on line %d of %.*s", line_num,
+                    (int) (sizeof (errmsg) / 2), rules_file);
+                error_handler (true, FUNC_NAME, errmsg);
+                fclose (fp);
+                return (ERROR);
+            }
+        }
+        else if (!strncmp (line, "conds=", 6))
+        {   /* New rule */
+            get_rules_value (line, "conds", value);
+            expected = atoi (value);
+            if (!get_rules_value (line, "class", value) ||
+                get_rules_class (value, &class_code) != SUCCESS ||
+                add_rule (class_code, model) != SUCCESS)
+            {
+                snprintf (errmsg, sizeof (errmsg),
+                    "Invalid rule on line %d of %.*s", line_num,
+                    (int) (sizeof (errmsg) / 2), rules_file);
+                error_handler (true, FUNC_NAME, errmsg);
+                fclose (fp);
+                return (ERROR);
+            }
+        }
+        else if (!strncmp (line, "type=", 5))
+        {   /* New condition */
+            get_rules_value (line, "type", value);
+            if (atoi (value) != 2)
+            {
+                snprintf (errmsg, sizeof (errmsg),
+                    "Unsupported condition type %.*s on line %d of %.*s",
+                    (int) (sizeof (errmsg) / 4), value, line_num,
+                    (int) (sizeof (errmsg) / 2), rules_file);
+                error_handler (true, FUNC_NAME, errmsg);
+                fclose (fp);
+                return (ERROR);
+            }
+
+            /* Get the feature */
+            if (!get_rules_value (line, "att", value))
+                value[0] = '\0';
+            for (i = 0; i < nfeat; i++)
+            {
+                if (!strcasecmp (value, rule_features[i].name))
+                    break;
+            }
+            if (i == nfeat)
+            {
+                snprintf (errmsg, sizeof (errmsg),
+                    "Unknown feature '%.*s' on line %d of %.*s",
+                    (int) (sizeof (errmsg) / 4), value, line_num,
+                    (int) (sizeof (errmsg) / 2), rules_file);
+                error_handler (true, FUNC_NAME, errmsg);
+                fclose (fp);
+                return (ERROR);
+            }
+
+            /* Get the comparison and threshold */
+            if (!get_rules_value (line, "result", value) ||
+                !get_rules_value (line, "cut", value2) ||
+                (strcmp (value, "<") && strcmp (value, ">")))
+            {
+                snprintf (errmsg, sizeof (errmsg),
+                    "Invalid condition on line %d of %.*s", line_num,
+                    (int) (sizeof (errmsg) / 2), rules_file);
+                error_handler (true, FUNC_NAME, errmsg);
+                fclose (fp);
+                return (ERROR);
+            }
+            op = (value[0] == '<') ? RULE_LE : RULE_GT;
+
+            if (add_rule_cond (rule_features[i].feature, op, atof (value2),
+                model) != SUCCESS)
+            {
+                snprintf (errmsg, sizeof (errmsg),
+                    "Error adding the condition on line %d of %.*s",
+                    line_num, (int) (sizeof (errmsg) / 2), rules_file);
+                error_handler (true, FUNC_NAME, errmsg);
+                fclose (fp);
+                return (ERROR);
+            }
+        }
+    }
+    fclose (fp);
+
+    /* Check the last rule and make sure some rules were found */
+    if (model->nrules > 0 && model->rule_cond[model->nrules] -
+        model->rule_cond[model->nrules-1] != expected)
+    {
+        snprintf (errmsg, sizeof (errmsg),
+            "Last rule of %.*s does not have the expected %d conditions",
+            (int) (sizeof (errmsg) / 2), rules_file, expected);
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+    if (model->ntrials == 0)
+    {
+        snprintf (errmsg, sizeof (errmsg),
+            "No rule sets found in %.*s", (int) (sizeof (errmsg) / 2),
+            rules_file);
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+
+    return (SUCCESS);
+}
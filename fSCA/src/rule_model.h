@@ -0,0 +1,111 @@
+#ifndef _RULE_MODEL_H_
+#define _RULE_MODEL_H_
+
+#include <stdbool.h>
+#include "common.h"
+
+/* Class values assigned by the rule-based models */
+#define RULE_CLOUD_FREE 50
+#define RULE_CLOUD 100
+
+/* Maximum number of conditions in one of the built-in rules */
+#define MAX_RULE_CONDS 10
+
+/* Number of pixels evaluated together by the rule-based models.  The
+   per-block loops have this fixed length so the compiler can vectorize the
+   threshold compares. */
+#define RULE_BLOCK 16
+
+/* Features (attributes) available to the rules */
+typedef enum {RF_B1=0, RF_B2, RF_B3, RF_B4, RF_B5, RF_B7, RF_B1_VAR,
+    RF_B2_VAR, RF_B4_VAR, RF_B5_VAR, RF_B7_VAR, RF_NDVI, RF_NDSI,
+    RF_NDVI_VAR, RF_NDSI_VAR, RF_NUM} Rule_feature_t;
+
+/* Comparisons used by the rule conditions */
+typedef enum {RULE_LE=0, RULE_GT} Rule_op_t;
+
+/* Condition and rule definitions, as used by the built-in rule tables */
+typedef struct {
+    Rule_feature_t feature;   /* feature being tested */
+    Rule_op_t op;             /* comparison against the threshold */
+    double threshold;         /* threshold for the comparison */
+} Rule_cond_def_t;
+
+typedef struct {
+    int trial;                /* model run (trial) for this rule */
+    int16 class_code;         /* class assigned when the rule fires */
+    int nconds;               /* number of conditions for the rule */
+    Rule_cond_def_t conds[MAX_RULE_CONDS];  /* conditions, all of which must
+                                               be true for the rule to fire */
+} Rule_def_t;
+
+/* Rule-based model ready for evaluation.  A model consists of one or more
+   trials (model runs).  Within a trial the first rule whose conditions are
+   all true assigns the class, and the trial default is used if no rule
+   fires.  The result of the model is the maximum class over the trials. */
+typedef struct {
+    int ntrials;              /* number of trials in the model */
+    int nrules;               /* number of rules over all the trials */
+    int nconds;               /* number of conditions over all the rules */
+    int max_trials;           /* allocated size of the trial arrays */
+    int max_rules;            /* allocated size of the rule arrays */
+    int max_conds;            /* allocated size of the condition arrays */
+    int16 max_class;          /* largest class the model can produce */
+    int *trial_rule;          /* first rule of each trial, plus one extra
+                                 entry holding nrules */
+    int16 *trial_default;     /* default class for each trial */
+    int *rule_cond;           /* first condition of each rule, plus one extra
+                                 entry holding nconds */
+    int16 *rule_class;        /* class assigned by each rule */
+    Rule_feature_t *cond_feature;  /* feature tested by each condition */
+    Rule_op_t *cond_op;       /* comparison for each condition */
+    float *cond_thresh;       /* threshold for each condition; see
+                                 add_rule_cond */
+} Rule_model_t;
+
+/* Prototypes */
+void init_rule_model
+(
+    Rule_model_t *model    /* O: rule model to be initialized */
+);
+
+void free_rule_model
+(
+    Rule_model_t *model    /* I/O: rule model to be freed */
+);
+
+int add_rule_trial
+(
+    int16 default_class,   /* I: default class for the trial */
+    Rule_model_t *model    /* I/O: rule model */
+);
+
+int add_rule
+(
+    int16 class_code,      /* I: class assigned when the rule fires */
+    Rule_model_t *model    /* I/O: rule model */
+);
+
+int add_rule_cond
+(
+    Rule_feature_t feature,  /* I: feature being tested */
+    Rule_op_t op,            /* I: comparison against the threshold */
+    double threshold,        /* I: threshold for the comparison */
+    Rule_model_t *model      /* I/O: rule model */
+);
+
+int read_rules_file
+(
+    char *rules_file,      /* I: name of the C5.0 rules file */
+    Rule_model_t *model    /* O: rule model read from the file */
+);
+
+int get_builtin_rules
+(
+    bool use_variances,    /* I: load the conservative model which uses the
+                                 variances (true) or the limited model which
+                                 does not (false) */
+    Rule_model_t *model    /* O: built-in rule model */
+);
+
+#endif
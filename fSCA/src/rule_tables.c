@@ -0,0 +1,1150 @@
+#include "revised_cloud_mask.h"
+
+/* Built-in rule sets for the rule-based models, provided by David Selkowitz,
+   USGS Alaska Science Center.  There are five trials (model runs) for each
+   model.  Each rule is listed as {trial, class, number of conditions,
+   {{feature, comparison, threshold}, ...}} and the rules for a trial are
+   listed in the order they are to be applied.  The comments give the C5.0
+   rule number, the (cases covered/cases misclassified), and the lift. */
+
+/* Conservative cloud mask model, which uses the variances */
+static const Rule_def_t conserv_rules[] =
+{
+    /* Rule 0/1: (8646/45, lift 2.1) */
+    {0, RULE_CLOUD_FREE, 4, {{RF_B7, RULE_LE, 2077},
+        {RF_B1_VAR, RULE_GT, 308729}, {RF_B7_VAR, RULE_LE, 234934},
+        {RF_NDSI_VAR, RULE_GT, 0.00215485}}},
+    /* Rule 0/2: (270/1, lift 2.1) */
+    {0, RULE_CLOUD_FREE, 3, {{RF_B1, RULE_LE, 2839}, {RF_B3, RULE_GT, 2917},
+        {RF_NDSI_VAR, RULE_LE, 0.0020372}}},
+    /* Rule 0/3: (10298/67, lift 2.1) */
+    {0, RULE_CLOUD_FREE, 2, {{RF_B7, RULE_LE, 2077},
+        {RF_NDSI_VAR, RULE_GT, 0.04491}}},
+    /* Rule 0/4: (11273/132, lift 2.1) */
+    {0, RULE_CLOUD_FREE, 3, {{RF_B3, RULE_GT, 1341}, {RF_B7, RULE_LE, 1464},
+        {RF_NDSI_VAR, RULE_GT, 0.00816928}}},
+    /* Rule 0/5: (979/11, lift 2.1) */
+    {0, RULE_CLOUD_FREE, 4, {{RF_B1, RULE_LE, 2999},
+        {RF_NDSI, RULE_LE, -0.199329}, {RF_B1_VAR, RULE_LE, 86087.4},
+        {RF_NDVI_VAR, RULE_GT, 0.00170841}}},
+    /* Rule 0/6: (9044/143, lift 2.1) */
+    {0, RULE_CLOUD_FREE, 1, {{RF_B5, RULE_LE, 1005}}},
+    /* Rule 0/7: (1837/110, lift 2.0) */
+    {0, RULE_CLOUD_FREE, 5, {{RF_B1, RULE_LE, 2999}, {RF_B7, RULE_GT, 1464},
+        {RF_NDVI, RULE_LE, 0.0817003}, {RF_NDSI, RULE_LE, -0.0544693},
+        {RF_NDSI_VAR, RULE_GT, 0.000305468}}},
+    /* Rule 0/8: (961/69, lift 1.9) */
+    {0, RULE_CLOUD_FREE, 2, {{RF_B1, RULE_LE, 2999}, {RF_B3, RULE_GT, 2917}}},
+    /* Rule 0/9: (342/28, lift 1.9) */
+    {0, RULE_CLOUD_FREE, 3, {{RF_NDSI, RULE_LE, -0.199329},
+        {RF_B4_VAR, RULE_GT, 5655.39}, {RF_B7_VAR, RULE_LE, 10260.5}}},
+    /* Rule 0/10: (2161/200, lift 1.9) */
+    {0, RULE_CLOUD_FREE, 3, {{RF_B1, RULE_LE, 2999},
+        {RF_NDVI, RULE_LE, 0.0817003}, {RF_NDSI, RULE_LE, -0.0544693}}},
+    /* Rule 0/11: (23277/7218, lift 1.4) */
+    {0, RULE_CLOUD_FREE, 1, {{RF_B1, RULE_LE, 2999}}},
+    /* Rule 0/12: (13760/38, lift 1.9) */
+    {0, RULE_CLOUD, 3, {{RF_B1, RULE_GT, 2999}, {RF_B7, RULE_GT, 1464},
+        {RF_B1_VAR, RULE_LE, 308729}}},
+    /* Rule 0/13: (11071/44, lift 1.9) */
+    {0, RULE_CLOUD, 3, {{RF_B1, RULE_GT, 2839}, {RF_B7, RULE_GT, 1464},
+        {RF_NDSI_VAR, RULE_LE, 0.0020372}}},
+    /* Rule 0/14: (2176/14, lift 1.9) */
+    {0, RULE_CLOUD, 4, {{RF_B7, RULE_GT, 1464}, {RF_NDVI, RULE_GT, 0.0817003},
+        {RF_B1_VAR, RULE_GT, 86087.4}, {RF_NDSI_VAR, RULE_LE, 0.0020372}}},
+    /* Rule 0/15: (1041/9, lift 1.9) */
+    {0, RULE_CLOUD, 4, {{RF_B3, RULE_LE, 2917}, {RF_B7, RULE_GT, 1464},
+        {RF_NDVI, RULE_GT, 0.0817003}, {RF_B4_VAR, RULE_LE, 5655.39}}},
+    /* Rule 0/16: (10040/128, lift 1.9) */
+    {0, RULE_CLOUD, 2, {{RF_B7, RULE_GT, 1464},
+        {RF_NDSI_VAR, RULE_LE, 0.000305468}}},
+    /* Rule 0/17: (3796/101, lift 1.9) */
+    {0, RULE_CLOUD, 5, {{RF_B3, RULE_LE, 2917}, {RF_B7, RULE_GT, 1464},
+        {RF_NDVI, RULE_GT, 0.0817003}, {RF_NDSI, RULE_GT, -0.199329},
+        {RF_NDSI_VAR, RULE_LE, 0.0020372}}},
+    /* Rule 0/18: (1151/34, lift 1.9) */
+    {0, RULE_CLOUD, 5, {{RF_B7, RULE_GT, 1464}, {RF_NDVI, RULE_GT, 0.169039},
+        {RF_B7_VAR, RULE_GT, 10260.5}, {RF_NDVI_VAR, RULE_LE, 0.00170841},
+        {RF_NDSI_VAR, RULE_LE, 0.0020372}}},
+    /* Rule 0/19: (18644/561, lift 1.9) */
+    {0, RULE_CLOUD, 2, {{RF_B1, RULE_GT, 2999}, {RF_B7, RULE_GT, 1464}}},
+    /* Rule 0/20: (13648/467, lift 1.8) */
+    {0, RULE_CLOUD, 4, {{RF_B5, RULE_GT, 1005}, {RF_NDVI, RULE_LE, 0.410316},
+        {RF_NDSI, RULE_GT, -0.117693}, {RF_NDSI_VAR, RULE_LE, 0.0023633}}},
+    /* Rule 0/21: (2291/87, lift 1.8) */
+    {0, RULE_CLOUD, 3, {{RF_B7, RULE_GT, 1464}, {RF_B7_VAR, RULE_GT, 312503},
+        {RF_NDSI_VAR, RULE_LE, 0.0109275}}},
+    /* Rule 0/22: (5902/238, lift 1.8) */
+    {0, RULE_CLOUD, 5, {{RF_B7, RULE_GT, 1464}, {RF_NDVI, RULE_GT, 0.0410272},
+        {RF_NDSI, RULE_GT, -0.128104}, {RF_NDVI_VAR, RULE_LE, 0.00150992},
+        {RF_NDSI_VAR, RULE_LE, 0.0109275}}},
+    /* Rule 0/23: (289/15, lift 1.8) */
+    {0, RULE_CLOUD, 5, {{RF_B1, RULE_GT, 1639}, {RF_B5, RULE_GT, 1005},
+        {RF_B7, RULE_LE, 1464}, {RF_B7_VAR, RULE_GT, 103775},
+        {RF_NDSI_VAR, RULE_LE, 0.00816928}}},
+    /* Rule 0/24: (10865/622, lift 1.8) */
+    {0, RULE_CLOUD, 3, {{RF_B5, RULE_GT, 1005},
+        {RF_NDVI_VAR, RULE_LE, 0.00017896},
+        {RF_NDSI_VAR, RULE_LE, 0.0023633}}},
+    /* Rule 0/25: (597/42, lift 1.8) */
+    {0, RULE_CLOUD, 5, {{RF_B5, RULE_GT, 1005}, {RF_B7, RULE_LE, 1464},
+        {RF_NDVI, RULE_LE, 0.410316}, {RF_B2_VAR, RULE_GT, 14609.2},
+        {RF_NDSI_VAR, RULE_LE, 0.0023633}}},
+    /* Rule 0/26: (231/21, lift 1.7) */
+    {0, RULE_CLOUD, 5, {{RF_B1, RULE_GT, 1536}, {RF_B3, RULE_LE, 1341},
+        {RF_B7_VAR, RULE_GT, 84988.3}, {RF_NDVI_VAR, RULE_LE, 0.00255233},
+        {RF_NDSI_VAR, RULE_LE, 0.0347677}}},
+    /* Rule 0/27: (942/93, lift 1.7) */
+    {0, RULE_CLOUD, 5, {{RF_B5, RULE_GT, 1005}, {RF_B5, RULE_LE, 1538},
+        {RF_NDVI, RULE_LE, 0.410316}, {RF_B2_VAR, RULE_LE, 57818},
+        {RF_NDSI_VAR, RULE_LE, 0.00416476}}},
+    /* Rule 1/1: (2863.5/6.1, lift 2.1) */
+    {1, RULE_CLOUD_FREE, 1, {{RF_NDSI, RULE_GT, 0.863486}}},
+    /* Rule 1/2: (524.1/13.6, lift 2.1) */
+    {1, RULE_CLOUD_FREE, 3, {{RF_B2, RULE_LE, 3971},
+        {RF_NDSI, RULE_LE, -0.272461}, {RF_B7_VAR, RULE_GT, 217782}}},
+    /* Rule 1/3: (3592/133.3, lift 2.0) */
+    {1, RULE_CLOUD_FREE, 2, {{RF_B2, RULE_LE, 3971},
+        {RF_NDSI, RULE_GT, 0.403054}}},
+    /* Rule 1/4: (1431.9/108.2, lift 2.0) */
+    {1, RULE_CLOUD_FREE, 4, {{RF_B1, RULE_LE, 3503}, {RF_B3, RULE_GT, 3076},
+        {RF_B7_VAR, RULE_LE, 217782}, {RF_NDSI_VAR, RULE_GT, 0.000593467}}},
+    /* Rule 1/5: (412.1/35.6, lift 1.9) */
+    {1, RULE_CLOUD_FREE, 3, {{RF_B1, RULE_LE, 2683}, {RF_B3, RULE_GT, 2573},
+        {RF_NDSI_VAR, RULE_LE, 0.000593467}}},
+    /* Rule 1/6: (3358/315.7, lift 1.9) */
+    {1, RULE_CLOUD_FREE, 3, {{RF_B2, RULE_GT, 3971}, {RF_B5, RULE_LE, 2549},
+        {RF_B4_VAR, RULE_GT, 267311}}},
+    /* Rule 1/7: (2239.2/352, lift 1.8) */
+    {1, RULE_CLOUD_FREE, 5, {{RF_B1, RULE_LE, 3503}, {RF_B7, RULE_GT, 2282},
+        {RF_B7_VAR, RULE_LE, 217782}, {RF_NDSI_VAR, RULE_GT, 0.000593467},
+        {RF_NDSI_VAR, RULE_LE, 0.0345117}}},
+    /* Rule 1/8: (34996.9/15368.2, lift 1.2) */
+    {1, RULE_CLOUD_FREE, 1, {{RF_B2, RULE_LE, 3971}}},
+    /* Rule 1/9: (9359.6/39.8, lift 1.9) */
+    {1, RULE_CLOUD, 2, {{RF_B2, RULE_GT, 3971}, {RF_B5, RULE_GT, 2549}}},
+    /* Rule 1/10: (192.7, lift 1.9) */
+    {1, RULE_CLOUD, 3, {{RF_NDSI, RULE_LE, 0.403054},
+        {RF_B4_VAR, RULE_LE, 3374.14}, {RF_NDSI_VAR, RULE_GT, 0.000593467}}},
+    /* Rule 1/11: (8302/47.1, lift 1.9) */
+    {1, RULE_CLOUD, 3, {{RF_B2, RULE_GT, 3971}, {RF_NDSI, RULE_LE, 0.863486},
+        {RF_B4_VAR, RULE_LE, 267311}}},
+    /* Rule 1/12: (4769.8/48.3, lift 1.9) */
+    {1, RULE_CLOUD, 5, {{RF_B1, RULE_GT, 3503}, {RF_NDSI, RULE_LE, 0.403054},
+        {RF_B4_VAR, RULE_GT, 3374.14}, {RF_B7_VAR, RULE_LE, 217782},
+        {RF_NDSI_VAR, RULE_LE, 0.0345117}}},
+    /* Rule 1/13: (833.5/44.3, lift 1.8) */
+    {1, RULE_CLOUD, 5, {{RF_B1, RULE_GT, 1825}, {RF_B2, RULE_LE, 1540},
+        {RF_NDSI, RULE_LE, 0.403054}, {RF_NDSI_VAR, RULE_GT, 0.000593467},
+        {RF_NDSI_VAR, RULE_LE, 0.0345117}}},
+    /* Rule 1/14: (11430/1036, lift 1.7) */
+    {1, RULE_CLOUD, 4, {{RF_B5, RULE_GT, 1090}, {RF_NDSI, RULE_LE, 0.863486},
+        {RF_B7_VAR, RULE_GT, 0}, {RF_NDSI_VAR, RULE_LE, 0.000593467}}},
+    /* Rule 1/15: (3499.4/422.9, lift 1.7) */
+    {1, RULE_CLOUD, 6, {{RF_B1, RULE_GT, 1825}, {RF_B7, RULE_GT, 1167},
+        {RF_B7, RULE_LE, 2282}, {RF_NDSI, RULE_LE, 0.403054},
+        {RF_B1_VAR, RULE_GT, 12517}, {RF_NDSI_VAR, RULE_LE, 0.00544464}}},
+    /* Rule 1/16: (4696.5/581.1, lift 1.7) */
+    {1, RULE_CLOUD, 6, {{RF_NDVI, RULE_LE, 0.392095},
+        {RF_NDSI, RULE_GT, -0.272461}, {RF_NDSI, RULE_LE, 0.863486},
+        {RF_B7_VAR, RULE_GT, 217782}, {RF_NDVI_VAR, RULE_GT, 0.000185316},
+        {RF_NDSI_VAR, RULE_LE, 0.0345117}}},
+    /* Rule 1/17: (5900.9/751, lift 1.6) */
+    {1, RULE_CLOUD, 3, {{RF_NDVI, RULE_LE, 0.392095},
+        {RF_NDSI, RULE_LE, 0.863486}, {RF_B5_VAR, RULE_GT, 904312}}},
+    /* Rule 1/18: (1387.9/244, lift 1.6) */
+    {1, RULE_CLOUD, 6, {{RF_B2, RULE_GT, 1011}, {RF_B3, RULE_LE, 1099},
+        {RF_NDVI, RULE_LE, 0.392095}, {RF_NDSI, RULE_LE, 0.403054},
+        {RF_B7_VAR, RULE_LE, 217782}, {RF_NDSI_VAR, RULE_LE, 0.0345117}}},
+    /* Rule 2/1: (408.9, lift 2.1) */
+    {2, RULE_CLOUD_FREE, 2, {{RF_B5, RULE_LE, 723},
+        {RF_NDSI_VAR, RULE_LE, 0.00365532}}},
+    /* Rule 2/2: (2473.9/26.8, lift 2.1) */
+    {2, RULE_CLOUD_FREE, 7, {{RF_B3, RULE_LE, 3829},
+        {RF_NDVI, RULE_GT, -0.0104225}, {RF_B1_VAR, RULE_GT, 1920000},
+        {RF_B5_VAR, RULE_LE, 1610000}, {RF_B7_VAR, RULE_LE, 425578},
+        {RF_NDVI_VAR, RULE_LE, 0.0652907},
+        {RF_NDSI_VAR, RULE_GT, 0.00365532}}},
+    /* Rule 2/3: (1579.3/20.2, lift 2.1) */
+    {2, RULE_CLOUD_FREE, 5, {{RF_B1, RULE_LE, 2587},
+        {RF_NDVI, RULE_GT, -0.0104225}, {RF_B1_VAR, RULE_GT, 28042.1},
+        {RF_B7_VAR, RULE_LE, 46730.4}, {RF_NDSI_VAR, RULE_GT, 0.00365532}}},
+    /* Rule 2/4: (1662.5/27.7, lift 2.1) */
+    {2, RULE_CLOUD_FREE, 6, {{RF_B2, RULE_GT, 1321}, {RF_B3, RULE_LE, 3829},
+        {RF_NDVI, RULE_GT, -0.0104225}, {RF_NDSI, RULE_GT, 0.267579},
+        {RF_NDVI_VAR, RULE_LE, 0.0652907},
+        {RF_NDSI_VAR, RULE_GT, 0.00365532}}},
+    /* Rule 2/5: (126.4/2.4, lift 2.0) */
+    {2, RULE_CLOUD_FREE, 4, {{RF_B1, RULE_LE, 2598},
+        {RF_B1_VAR, RULE_LE, 175885}, {RF_B2_VAR, RULE_GT, 190105},
+        {RF_NDSI_VAR, RULE_LE, 0.00365532}}},
+    /* Rule 2/6: (1403.3/57.5, lift 2.0) */
+    {2, RULE_CLOUD_FREE, 3, {{RF_B1, RULE_LE, 2598}, {RF_B3, RULE_GT, 2528},
+        {RF_B7_VAR, RULE_LE, 1860000}}},
+    /* Rule 2/7: (1411.1/105.7, lift 1.9) */
+    {2, RULE_CLOUD_FREE, 4, {{RF_B1, RULE_LE, 2598}, {RF_B7, RULE_GT, 2683},
+        {RF_B1_VAR, RULE_LE, 175885}, {RF_NDSI_VAR, RULE_GT, 0.000125769}}},
+    /* Rule 2/8: (1074.5/99, lift 1.9) */
+    {2, RULE_CLOUD_FREE, 3, {{RF_B1, RULE_LE, 3218}, {RF_B2, RULE_GT, 3032},
+        {RF_B7_VAR, RULE_LE, 1860000}}},
+    /* Rule 2/9: (5184/544, lift 1.9) */
+    {2, RULE_CLOUD_FREE, 2, {{RF_B1, RULE_GT, 2598}, {RF_B7, RULE_LE, 1208}}},
+    /* Rule 2/10: (892.6/97.8, lift 1.9) */
+    {2, RULE_CLOUD_FREE, 5, {{RF_B2, RULE_GT, 1321}, {RF_B3, RULE_LE, 3829},
+        {RF_B1_VAR, RULE_LE, 28042.1}, {RF_NDVI_VAR, RULE_LE, 0.0878528},
+        {RF_NDSI_VAR, RULE_GT, 0.00365532}}},
+    /* Rule 2/11: (6939.7/1213, lift 1.7) */
+    {2, RULE_CLOUD_FREE, 4, {{RF_B1, RULE_LE, 2587}, {RF_B2, RULE_GT, 1321},
+        {RF_B7_VAR, RULE_LE, 425578}, {RF_NDSI_VAR, RULE_GT, 0.00365532}}},
+    /* Rule 2/12: (1701.5/298.6, lift 1.7) */
+    {2, RULE_CLOUD_FREE, 4, {{RF_B3, RULE_GT, 3829}, {RF_B1_VAR, RULE_GT, 0},
+        {RF_B7_VAR, RULE_LE, 162839}, {RF_NDSI_VAR, RULE_GT, 0.00365532}}},
+    /* Rule 2/13: (2671.6/480.1, lift 1.7) */
+    {2, RULE_CLOUD_FREE, 8, {{RF_B1, RULE_LE, 2598}, {RF_B3, RULE_GT, 1051},
+        {RF_B5, RULE_GT, 1026}, {RF_NDVI, RULE_LE, 0.0978049},
+        {RF_B1_VAR, RULE_LE, 175885}, {RF_B5_VAR, RULE_GT, 15651.8},
+        {RF_NDSI_VAR, RULE_GT, 0.000191934},
+        {RF_NDSI_VAR, RULE_LE, 0.00365532}}},
+    /* Rule 2/14: (42439.5/19761.5, lift 1.1) */
+    {2, RULE_CLOUD_FREE, 1, {{RF_B1_VAR, RULE_GT, 0}}},
+    /* Rule 2/15: (1023.8/0.6, lift 1.9) */
+    {2, RULE_CLOUD, 1, {{RF_B7_VAR, RULE_GT, 1860000}}},
+    /* Rule 2/16: (267.5, lift 1.9) */
+    {2, RULE_CLOUD, 3, {{RF_B3, RULE_LE, 2528}, {RF_B1_VAR, RULE_GT, 0},
+        {RF_NDVI_VAR, RULE_LE, 3.78e-05}}},
+    /* Rule 2/17: (229.7, lift 1.9) */
+    {2, RULE_CLOUD, 4, {{RF_B3, RULE_LE, 2528}, {RF_B5, RULE_GT, 723},
+        {RF_B1_VAR, RULE_GT, 0}, {RF_B5_VAR, RULE_LE, 1908.3}}},
+    /* Rule 2/18: (126.9, lift 1.9) */
+    {2, RULE_CLOUD, 6, {{RF_B1, RULE_LE, 2598}, {RF_B2_VAR, RULE_GT, 2109},
+        {RF_B4_VAR, RULE_LE, 3585.67}, {RF_B5_VAR, RULE_GT, 5639.05},
+        {RF_NDSI_VAR, RULE_GT, 0.000191934},
+        {RF_NDSI_VAR, RULE_LE, 0.00365532}}},
+    /* Rule 2/19: (2506.1/29.9, lift 1.9) */
+    {2, RULE_CLOUD, 4, {{RF_B5, RULE_GT, 723}, {RF_NDSI, RULE_LE, 0.881556},
+        {RF_NDVI_VAR, RULE_GT, 3.78e-05},
+        {RF_NDSI_VAR, RULE_LE, 0.000125769}}},
+    /* Rule 2/20: (1252.6/19.9, lift 1.9) */
+    {2, RULE_CLOUD, 4, {{RF_B7, RULE_LE, 2683}, {RF_NDSI, RULE_LE, 0.881556},
+        {RF_B2_VAR, RULE_GT, 2109}, {RF_NDSI_VAR, RULE_LE, 0.000191934}}},
+    /* Rule 2/21: (6791.6/166, lift 1.9) */
+    {2, RULE_CLOUD, 3, {{RF_B1, RULE_GT, 3218}, {RF_B7, RULE_GT, 1208},
+        {RF_NDSI_VAR, RULE_LE, 0.00365532}}},
+    /* Rule 2/22: (744.5/20.4, lift 1.9) */
+    {2, RULE_CLOUD, 8, {{RF_B5, RULE_GT, 1026}, {RF_B7, RULE_LE, 2683},
+        {RF_NDVI, RULE_LE, 0.0978049}, {RF_NDSI, RULE_LE, 0.881556},
+        {RF_B1_VAR, RULE_LE, 175885}, {RF_B5_VAR, RULE_GT, 5639.05},
+        {RF_B5_VAR, RULE_LE, 15651.8}, {RF_NDSI_VAR, RULE_LE, 0.00365532}}},
+    /* Rule 2/23: (5925.2/178.5, lift 1.9) */
+    {2, RULE_CLOUD, 2, {{RF_NDSI, RULE_LE, 0.881556},
+        {RF_B1_VAR, RULE_LE, 0}}},
+    /* Rule 2/24: (471.4/13.7, lift 1.9) */
+    {2, RULE_CLOUD, 5, {{RF_B1, RULE_LE, 2598}, {RF_B3, RULE_LE, 2528},
+        {RF_B5, RULE_GT, 723}, {RF_B1_VAR, RULE_GT, 175885},
+        {RF_NDSI_VAR, RULE_LE, 0.00365532}}},
+    /* Rule 2/25: (4937.7/251.3, lift 1.8) */
+    {2, RULE_CLOUD, 7, {{RF_B1, RULE_GT, 1604}, {RF_B2, RULE_GT, 1321},
+        {RF_B5, RULE_GT, 899}, {RF_NDVI, RULE_LE, -0.0104225},
+        {RF_NDSI, RULE_LE, 0.881556}, {RF_NDVI_VAR, RULE_LE, 0.0652907},
+        {RF_NDSI_VAR, RULE_LE, 0.0378146}}},
+    /* Rule 2/26: (2754.4/162.4, lift 1.8) */
+    {2, RULE_CLOUD, 4, {{RF_B1, RULE_GT, 2598}, {RF_B2, RULE_LE, 3032},
+        {RF_B7, RULE_GT, 1208}, {RF_NDSI_VAR, RULE_LE, 0.00365532}}},
+    /* Rule 2/27: (491.2/28.8, lift 1.8) */
+    {2, RULE_CLOUD, 5, {{RF_B5, RULE_GT, 899}, {RF_NDSI, RULE_LE, 0.881556},
+        {RF_NDVI_VAR, RULE_GT, 0.0652907}, {RF_NDSI_VAR, RULE_GT, 0.00365532},
+        {RF_NDSI_VAR, RULE_LE, 0.0378146}}},
+    /* Rule 2/28: (351.6/21.4, lift 1.8) */
+    {2, RULE_CLOUD, 6, {{RF_B1, RULE_LE, 2598}, {RF_B5, RULE_GT, 723},
+        {RF_B5, RULE_LE, 1026}, {RF_B1_VAR, RULE_GT, 0},
+        {RF_B2_VAR, RULE_LE, 190105}, {RF_NDSI_VAR, RULE_LE, 0.00365532}}},
+    /* Rule 2/29: (2898.5/186.1, lift 1.8) */
+    {2, RULE_CLOUD, 8, {{RF_NDVI, RULE_GT, 0.0978049},
+        {RF_NDSI, RULE_GT, -0.228882}, {RF_NDSI, RULE_LE, 0.093273},
+        {RF_B2_VAR, RULE_GT, 2109}, {RF_B2_VAR, RULE_LE, 190105},
+        {RF_B5_VAR, RULE_GT, 5639.05}, {RF_NDVI_VAR, RULE_LE, 0.00049353},
+        {RF_NDSI_VAR, RULE_LE, 0.00365532}}},
+    /* Rule 2/30: (7312.9/623.2, lift 1.8) */
+    {2, RULE_CLOUD, 6, {{RF_B1, RULE_GT, 2587}, {RF_NDSI, RULE_LE, 0.267579},
+        {RF_B1_VAR, RULE_LE, 1920000}, {RF_B5_VAR, RULE_LE, 1610000},
+        {RF_NDVI_VAR, RULE_LE, 0.0652907}, {RF_NDSI_VAR, RULE_LE, 0.0378146}}},
+    /* Rule 2/31: (493.2/45.1, lift 1.7) */
+    {2, RULE_CLOUD, 7, {{RF_B1, RULE_LE, 2598}, {RF_B5, RULE_GT, 723},
+        {RF_B7, RULE_LE, 752}, {RF_NDVI, RULE_LE, 0.44504},
+        {RF_B1_VAR, RULE_GT, 0}, {RF_B2_VAR, RULE_LE, 190105},
+        {RF_NDSI_VAR, RULE_LE, 0.00365532}}},
+    /* Rule 2/32: (3829.7/353.5, lift 1.7) */
+    {2, RULE_CLOUD, 4, {{RF_B3, RULE_GT, 3829}, {RF_NDSI, RULE_LE, 0.881556},
+        {RF_B7_VAR, RULE_GT, 162839}, {RF_NDSI_VAR, RULE_LE, 0.113723}}},
+    /* Rule 2/33: (10939.1/1102, lift 1.7) */
+    {2, RULE_CLOUD, 3, {{RF_B3, RULE_GT, 3829}, {RF_NDSI, RULE_LE, 0.881556},
+        {RF_NDSI_VAR, RULE_LE, 0.113723}}},
+    /* Rule 2/34: (738.8/80.5, lift 1.7) */
+    {2, RULE_CLOUD, 4, {{RF_B1, RULE_GT, 1604}, {RF_B2, RULE_LE, 1321},
+        {RF_NDSI_VAR, RULE_GT, 0.00365532}, {RF_NDSI_VAR, RULE_LE, 0.113723}}},
+    /* Rule 2/35: (2149.8/246.3, lift 1.7) */
+    {2, RULE_CLOUD, 5, {{RF_B1, RULE_GT, 1604}, {RF_B5, RULE_GT, 899},
+        {RF_B5_VAR, RULE_LE, 1610000}, {RF_B7_VAR, RULE_GT, 425578},
+        {RF_NDSI_VAR, RULE_LE, 0.0378146}}},
+    /* Rule 2/36: (1826.2/221.4, lift 1.7) */
+    {2, RULE_CLOUD, 3, {{RF_B5, RULE_GT, 3063}, {RF_B7, RULE_LE, 2683},
+        {RF_NDSI_VAR, RULE_LE, 0.00365532}}},
+    /* Rule 2/37: (5110.1/634.1, lift 1.7) */
+    {2, RULE_CLOUD, 9, {{RF_B3, RULE_GT, 1051}, {RF_NDVI, RULE_GT, 0.0978049},
+        {RF_NDVI, RULE_LE, 0.44504}, {RF_NDSI, RULE_GT, -0.228882},
+        {RF_NDSI, RULE_LE, 0.093273}, {RF_B2_VAR, RULE_GT, 2109},
+        {RF_B5_VAR, RULE_GT, 5639.05}, {RF_B7_VAR, RULE_GT, 9219.45},
+        {RF_NDSI_VAR, RULE_LE, 0.00365532}}},
+    /* Rule 2/38: (1808.8/399.7, lift 1.5) */
+    {2, RULE_CLOUD, 6, {{RF_B1, RULE_GT, 1604}, {RF_B5, RULE_GT, 899},
+        {RF_NDSI, RULE_LE, 0.881556}, {RF_NDVI_VAR, RULE_GT, 0.0878528},
+        {RF_NDSI_VAR, RULE_GT, 0.00365532}, {RF_NDSI_VAR, RULE_LE, 0.113723}}},
+    /* Rule 2/39: (3338.3/765.1, lift 1.5) */
+    {2, RULE_CLOUD, 9, {{RF_B1, RULE_GT, 1885}, {RF_B5, RULE_GT, 899},
+        {RF_B5, RULE_LE, 2807}, {RF_B7, RULE_LE, 2226},
+        {RF_B1_VAR, RULE_GT, 28042.1}, {RF_B1_VAR, RULE_LE, 1920000},
+        {RF_B5_VAR, RULE_LE, 1610000}, {RF_B7_VAR, RULE_GT, 46730.4},
+        {RF_NDSI_VAR, RULE_LE, 0.0378146}}},
+    /* Rule 2/40: (4731.9/1390.1, lift 1.4) */
+    {2, RULE_CLOUD, 8, {{RF_B1, RULE_GT, 1604}, {RF_B5, RULE_LE, 2807},
+        {RF_B7, RULE_LE, 2226}, {RF_B1_VAR, RULE_GT, 28042.1},
+        {RF_B1_VAR, RULE_LE, 1920000}, {RF_B5_VAR, RULE_LE, 1610000},
+        {RF_B7_VAR, RULE_GT, 46730.4}, {RF_NDSI_VAR, RULE_LE, 0.0378146}}},
+    /* Rule 3/1: (1616, lift 2.0) */
+    {3, RULE_CLOUD_FREE, 1, {{RF_NDSI, RULE_GT, 0.888811}}},
+    /* Rule 3/2: (1937.6/10.3, lift 2.0) */
+    {3, RULE_CLOUD_FREE, 3, {{RF_B5, RULE_LE, 4153},
+        {RF_B4_VAR, RULE_GT, 1090000}, {RF_B7_VAR, RULE_LE, 325542}}},
+    /* Rule 3/3: (2810.4/27.7, lift 2.0) */
+    {3, RULE_CLOUD_FREE, 5, {{RF_B5, RULE_LE, 4153},
+        {RF_NDVI, RULE_GT, -0.00044238}, {RF_B2_VAR, RULE_GT, 89280.1},
+        {RF_B2_VAR, RULE_LE, 1.15e+07}, {RF_NDSI_VAR, RULE_GT, 0.0355158}}},
+    /* Rule 3/4: (509.9/5.1, lift 2.0) */
+    {3, RULE_CLOUD_FREE, 4, {{RF_B1, RULE_LE, 2874}, {RF_B3, RULE_GT, 2844},
+        {RF_B5, RULE_LE, 4153}, {RF_NDSI_VAR, RULE_LE, 0.00144666}}},
+    /* Rule 3/5: (255.6/2.3, lift 2.0) */
+    {3, RULE_CLOUD_FREE, 4, {{RF_B5, RULE_LE, 4153},
+        {RF_NDVI, RULE_GT, -0.00044238}, {RF_B2_VAR, RULE_LE, 89280.1},
+        {RF_B7_VAR, RULE_GT, 325542}}},
+    /* Rule 3/6: (1022.4/19.8, lift 2.0) */
+    {3, RULE_CLOUD_FREE, 2, {{RF_B1, RULE_LE, 2499}, {RF_B3, RULE_GT, 2484}}},
+    /* Rule 3/7: (1331.4/35.4, lift 1.9) */
+    {3, RULE_CLOUD_FREE, 3, {{RF_B1, RULE_LE, 2874},
+        {RF_B1_VAR, RULE_LE, 103107}, {RF_NDVI_VAR, RULE_GT, 0.00504752}}},
+    /* Rule 3/8: (4721/161.2, lift 1.9) */
+    {3, RULE_CLOUD_FREE, 3, {{RF_B5, RULE_LE, 4153},
+        {RF_B5_VAR, RULE_LE, 1.05e+07}, {RF_NDSI_VAR, RULE_GT, 0.0780484}}},
+    /* Rule 3/9: (224.5/6.9, lift 1.9) */
+    {3, RULE_CLOUD_FREE, 5, {{RF_B5, RULE_LE, 4153},
+        {RF_B1_VAR, RULE_GT, 5.47e+07}, {RF_B2_VAR, RULE_LE, 1.15e+07},
+        {RF_B7_VAR, RULE_GT, 325542}, {RF_NDSI_VAR, RULE_GT, 0.00144666}}},
+    /* Rule 3/10: (1647.9/81.9, lift 1.9) */
+    {3, RULE_CLOUD_FREE, 3, {{RF_B1, RULE_LE, 1367},
+        {RF_B7_VAR, RULE_LE, 325542}, {RF_NDSI_VAR, RULE_GT, 0.00144666}}},
+    /* Rule 3/11: (529.6/26.4, lift 1.9) */
+    {3, RULE_CLOUD_FREE, 3, {{RF_B5, RULE_LE, 1480},
+        {RF_B5_VAR, RULE_LE, 15695.8}, {RF_NDSI_VAR, RULE_GT, 0.00144666}}},
+    /* Rule 3/12: (4600.6/271.2, lift 1.9) */
+    {3, RULE_CLOUD_FREE, 4, {{RF_B2, RULE_GT, 1673}, {RF_B5, RULE_LE, 1480},
+        {RF_B7_VAR, RULE_LE, 325542}, {RF_NDSI_VAR, RULE_GT, 0.00144666}}},
+    /* Rule 3/13: (747.8/47.3, lift 1.9) */
+    {3, RULE_CLOUD_FREE, 5, {{RF_B5, RULE_GT, 1480}, {RF_B5, RULE_LE, 4153},
+        {RF_B1_VAR, RULE_GT, 3400000}, {RF_B2_VAR, RULE_LE, 274632},
+        {RF_NDSI_VAR, RULE_GT, 0.00144666}}},
+    /* Rule 3/14: (704.2/49.6, lift 1.9) */
+    {3, RULE_CLOUD_FREE, 4, {{RF_B1, RULE_GT, 1367}, {RF_B2, RULE_LE, 1673},
+        {RF_NDVI, RULE_LE, 0.00974093}, {RF_NDSI_VAR, RULE_GT, 0.00144666}}},
+    /* Rule 3/15: (486.5/35.6, lift 1.9) */
+    {3, RULE_CLOUD_FREE, 3, {{RF_B1, RULE_LE, 2499},
+        {RF_NDVI, RULE_LE, -0.0123566}, {RF_B1_VAR, RULE_LE, 103107}}},
+    /* Rule 3/16: (3003.1/235.2, lift 1.8) */
+    {3, RULE_CLOUD_FREE, 5, {{RF_B1, RULE_LE, 2040}, {RF_B5, RULE_GT, 1480},
+        {RF_NDVI, RULE_LE, 0.223642}, {RF_B7_VAR, RULE_LE, 325542},
+        {RF_NDSI_VAR, RULE_GT, 0.00144666}}},
+    /* Rule 3/17: (10526.7/874.7, lift 1.8) */
+    {3, RULE_CLOUD_FREE, 4, {{RF_B5, RULE_LE, 4153},
+        {RF_B5_VAR, RULE_LE, 1.05e+07}, {RF_B7_VAR, RULE_LE, 325542},
+        {RF_NDSI_VAR, RULE_GT, 0.0177706}}},
+    /* Rule 3/18: (1419.2/201.5, lift 1.7) */
+    {3, RULE_CLOUD_FREE, 3, {{RF_B1, RULE_LE, 2499}, {RF_B7, RULE_GT, 2458},
+        {RF_B1_VAR, RULE_LE, 103107}}},
+    /* Rule 3/19: (8128.2/1254.3, lift 1.7) */
+    {3, RULE_CLOUD_FREE, 7, {{RF_B1, RULE_LE, 3255}, {RF_B2, RULE_GT, 1763},
+        {RF_B5, RULE_LE, 4153}, {RF_NDVI, RULE_LE, 0.223642},
+        {RF_B5_VAR, RULE_LE, 1.05e+07}, {RF_B7_VAR, RULE_LE, 325542},
+        {RF_NDSI_VAR, RULE_GT, 0.00144666}}},
+    /* Rule 3/20: (4365.8/698.2, lift 1.7) */
+    {3, RULE_CLOUD_FREE, 6, {{RF_B1, RULE_LE, 2884},
+        {RF_NDVI, RULE_GT, -0.00044238}, {RF_NDVI, RULE_LE, 0.0894992},
+        {RF_B2_VAR, RULE_GT, 89280.1}, {RF_B5_VAR, RULE_LE, 1.05e+07},
+        {RF_NDSI_VAR, RULE_GT, 0.00144666}}},
+    /* Rule 3/21: (1063.6/187.6, lift 1.6) */
+    {3, RULE_CLOUD_FREE, 1, {{RF_NDVI, RULE_GT, 0.392625}}},
+    /* Rule 3/22: (897.1/272.9, lift 1.4) */
+    {3, RULE_CLOUD_FREE, 5, {{RF_B1, RULE_LE, 2499},
+        {RF_NDVI, RULE_GT, 0.0394758}, {RF_NDVI, RULE_LE, 0.107908},
+        {RF_B1_VAR, RULE_LE, 11846.8}, {RF_B4_VAR, RULE_GT, 5354.76}}},
+    /* Rule 3/23: (2089/669.5, lift 1.4) */
+    {3, RULE_CLOUD_FREE, 2, {{RF_NDSI, RULE_LE, -0.201802},
+        {RF_B2_VAR, RULE_LE, 16676}}},
+    /* Rule 3/24: (724.7/301.1, lift 1.2) */
+    {3, RULE_CLOUD_FREE, 2, {{RF_B1, RULE_LE, 3446}, {RF_B5, RULE_GT, 4153}}},
+    /* Rule 3/25: (632.5/0.5, lift 2.0) */
+    {3, RULE_CLOUD, 7, {{RF_B1, RULE_GT, 2884}, {RF_B5, RULE_LE, 4153},
+        {RF_B1_VAR, RULE_LE, 5.47e+07}, {RF_B2_VAR, RULE_GT, 89280.1},
+        {RF_B5_VAR, RULE_LE, 1.05e+07}, {RF_B7_VAR, RULE_GT, 325542},
+        {RF_NDSI_VAR, RULE_LE, 0.0355158}}},
+    /* Rule 3/26: (404.5, lift 2.0) */
+    {3, RULE_CLOUD, 4, {{RF_B1, RULE_LE, 2499}, {RF_B3, RULE_LE, 2484},
+        {RF_B1_VAR, RULE_GT, 103107}, {RF_NDSI_VAR, RULE_LE, 0.00144666}}},
+    /* Rule 3/27: (5612.6/10.7, lift 2.0) */
+    {3, RULE_CLOUD, 2, {{RF_B1, RULE_GT, 3446}, {RF_B5, RULE_GT, 4153}}},
+    /* Rule 3/28: (746.4/8.1, lift 2.0) */
+    {3, RULE_CLOUD, 4, {{RF_B1, RULE_GT, 2040}, {RF_B2, RULE_LE, 1763},
+        {RF_B5, RULE_GT, 1480}, {RF_B2_VAR, RULE_LE, 274632}}},
+    /* Rule 3/29: (282.9/10.7, lift 1.9) */
+    {3, RULE_CLOUD, 6, {{RF_B3, RULE_LE, 2844}, {RF_B7, RULE_LE, 2458},
+        {RF_NDVI, RULE_LE, 0.0394758}, {RF_B1_VAR, RULE_LE, 11846.8},
+        {RF_B4_VAR, RULE_GT, 5354.76}, {RF_NDSI_VAR, RULE_LE, 0.00144666}}},
+    /* Rule 3/30: (1413.5/63.1, lift 1.9) */
+    {3, RULE_CLOUD, 3, {{RF_B2_VAR, RULE_GT, 1.15e+07},
+        {RF_B7_VAR, RULE_GT, 325542}, {RF_NDSI_VAR, RULE_LE, 0.0780484}}},
+    /* Rule 3/31: (588.1/30.1, lift 1.9) */
+    {3, RULE_CLOUD, 6, {{RF_B7, RULE_LE, 2458}, {RF_NDVI, RULE_LE, 0.392625},
+        {RF_NDSI, RULE_LE, -0.201802}, {RF_B2_VAR, RULE_GT, 16676},
+        {RF_NDVI_VAR, RULE_LE, 0.00504752},
+        {RF_NDSI_VAR, RULE_LE, 0.00144666}}},
+    /* Rule 3/32: (2585.3/155.5, lift 1.9) */
+    {3, RULE_CLOUD, 1, {{RF_B5_VAR, RULE_GT, 1.05e+07}}},
+    /* Rule 3/33: (938.6/67.7, lift 1.9) */
+    {3, RULE_CLOUD, 5, {{RF_NDVI, RULE_LE, -0.00044238},
+        {RF_B1_VAR, RULE_LE, 5.47e+07}, {RF_B2_VAR, RULE_LE, 1.15e+07},
+        {RF_B7_VAR, RULE_GT, 325542}, {RF_NDSI_VAR, RULE_LE, 0.0780484}}},
+    /* Rule 3/34: (1250.1/124, lift 1.8) */
+    {3, RULE_CLOUD, 4, {{RF_NDVI, RULE_GT, 0.0894992},
+        {RF_B2_VAR, RULE_GT, 89280.1}, {RF_B7_VAR, RULE_GT, 325542},
+        {RF_NDSI_VAR, RULE_LE, 0.0355158}}},
+    /* Rule 3/35: (5470.8/578.9, lift 1.8) */
+    {3, RULE_CLOUD, 5, {{RF_NDVI, RULE_GT, 0.107908},
+        {RF_NDVI, RULE_LE, 0.392625}, {RF_NDSI, RULE_GT, -0.201802},
+        {RF_NDVI_VAR, RULE_LE, 0.00504752},
+        {RF_NDSI_VAR, RULE_LE, 0.00144666}}},
+    /* Rule 3/36: (2035.7/366.4, lift 1.6) */
+    {3, RULE_CLOUD, 7, {{RF_B1, RULE_GT, 1367}, {RF_B2, RULE_LE, 1673},
+        {RF_B5, RULE_LE, 1480}, {RF_NDVI, RULE_GT, 0.00974093},
+        {RF_B4_VAR, RULE_LE, 1090000}, {RF_B5_VAR, RULE_GT, 15695.8},
+        {RF_NDSI_VAR, RULE_LE, 0.0177706}}},
+    /* Rule 3/37: (2207.5/402.6, lift 1.6) */
+    {3, RULE_CLOUD, 4, {{RF_B1, RULE_GT, 1367}, {RF_B5, RULE_GT, 1480},
+        {RF_B2_VAR, RULE_GT, 274632}, {RF_NDSI_VAR, RULE_LE, 0.0177706}}},
+    /* Rule 3/38: (28846/10368.5, lift 1.3) */
+    {3, RULE_CLOUD, 3, {{RF_B1, RULE_GT, 1367}, {RF_B4_VAR, RULE_LE, 1090000},
+        {RF_NDSI_VAR, RULE_LE, 0.0177706}}},
+    /* Rule 4/1: (713.8, lift 2.1) */
+    {4, RULE_CLOUD_FREE, 4, {{RF_B2, RULE_LE, 4222}, {RF_B7, RULE_LE, 1298},
+        {RF_NDSI, RULE_GT, 0.438529}, {RF_NDSI_VAR, RULE_LE, 0.0284024}}},
+    /* Rule 4/2: (1328.1, lift 2.1) */
+    {4, RULE_CLOUD_FREE, 1, {{RF_NDSI, RULE_GT, 0.888811}}},
+    /* Rule 4/3: (1293.4, lift 2.1) */
+    {4, RULE_CLOUD_FREE, 1, {{RF_NDSI_VAR, RULE_GT, 0.136021}}},
+    /* Rule 4/4: (225.7, lift 2.1) */
+    {4, RULE_CLOUD_FREE, 3, {{RF_B1, RULE_LE, 2756}, {RF_B3, RULE_GT, 2842},
+        {RF_NDSI_VAR, RULE_LE, 0.000488092}}},
+    /* Rule 4/5: (864.9/7.2, lift 2.1) */
+    {4, RULE_CLOUD_FREE, 3, {{RF_B1, RULE_LE, 2162}, {RF_B3, RULE_GT, 2095},
+        {RF_NDSI_VAR, RULE_GT, 0.000488092}}},
+    /* Rule 4/6: (219.2/5.1, lift 2.0) */
+    {4, RULE_CLOUD_FREE, 4, {{RF_B2, RULE_LE, 4222}, {RF_B7, RULE_LE, 1298},
+        {RF_NDVI, RULE_LE, 0.110778}, {RF_B2_VAR, RULE_LE, 3129.56}}},
+    /* Rule 4/7: (798.1/21.3, lift 2.0) */
+    {4, RULE_CLOUD_FREE, 1, {{RF_B1, RULE_LE, 1187}}},
+    /* Rule 4/8: (672.1/27.5, lift 2.0) */
+    {4, RULE_CLOUD_FREE, 7, {{RF_B1, RULE_LE, 2162}, {RF_B5, RULE_GT, 1649},
+        {RF_NDVI, RULE_LE, 0.0932514}, {RF_B1_VAR, RULE_LE, 170233},
+        {RF_B4_VAR, RULE_GT, 5354.76}, {RF_NDSI_VAR, RULE_GT, 0.000488092},
+        {RF_NDSI_VAR, RULE_LE, 0.00313462}}},
+    /* Rule 4/9: (830.5/39.5, lift 2.0) */
+    {4, RULE_CLOUD_FREE, 2, {{RF_B1, RULE_LE, 3362}, {RF_B2, RULE_GT, 3250}}},
+    /* Rule 4/10: (1202.4/69.1, lift 2.0) */
+    {4, RULE_CLOUD_FREE, 5, {{RF_B1, RULE_LE, 2162}, {RF_B5, RULE_GT, 1819},
+        {RF_B1_VAR, RULE_LE, 170233}, {RF_NDVI_VAR, RULE_GT, 0.00355646},
+        {RF_NDSI_VAR, RULE_GT, 0.000488092}}},
+    /* Rule 4/11: (4352.5/423, lift 1.9) */
+    {4, RULE_CLOUD_FREE, 3, {{RF_B1, RULE_LE, 2162}, {RF_B5, RULE_GT, 1649},
+        {RF_NDSI_VAR, RULE_GT, 0.00313462}}},
+    /* Rule 4/12: (1488/161, lift 1.9) */
+    {4, RULE_CLOUD_FREE, 2, {{RF_NDVI, RULE_LE, 0.0564516},
+        {RF_NDSI, RULE_LE, -0.115053}}},
+    /* Rule 4/13: (2569.8/299.6, lift 1.9) */
+    {4, RULE_CLOUD_FREE, 6, {{RF_B1, RULE_LE, 2162}, {RF_B5, RULE_GT, 1819},
+        {RF_NDVI, RULE_LE, 0.236486}, {RF_B4_VAR, RULE_GT, 5354.76},
+        {RF_B7_VAR, RULE_LE, 121237}, {RF_NDSI_VAR, RULE_GT, 0.000488092}}},
+    /* Rule 4/14: (1296.5/153.8, lift 1.8) */
+    {4, RULE_CLOUD_FREE, 2, {{RF_B5, RULE_GT, 1770}, {RF_B7, RULE_LE, 1298}}},
+    /* Rule 4/15: (1612.4/206.9, lift 1.8) */
+    {4, RULE_CLOUD_FREE, 5, {{RF_B1, RULE_GT, 2162}, {RF_B7, RULE_LE, 1505},
+        {RF_NDVI, RULE_GT, 0.0749564}, {RF_B4_VAR, RULE_GT, 5354.76},
+        {RF_NDSI_VAR, RULE_GT, 0.000488092}}},
+    /* Rule 4/16: (4377.1/800.4, lift 1.7) */
+    {4, RULE_CLOUD_FREE, 3, {{RF_B1, RULE_GT, 3362}, {RF_B5, RULE_LE, 2173},
+        {RF_NDSI_VAR, RULE_GT, 0.000488092}}},
+    /* Rule 4/17: (302.5/77.1, lift 1.6) */
+    {4, RULE_CLOUD_FREE, 3, {{RF_NDVI, RULE_GT, 0.307271},
+        {RF_NDSI, RULE_LE, -0.115053}, {RF_NDSI_VAR, RULE_LE, 0.000488092}}},
+    /* Rule 4/18: (28646.7/10725.7, lift 1.3) */
+    {4, RULE_CLOUD_FREE, 2, {{RF_B1, RULE_LE, 3362},
+        {RF_NDSI_VAR, RULE_GT, 0.000488092}}},
+    /* Rule 4/19: (1608.5, lift 1.9) */
+    {4, RULE_CLOUD, 3, {{RF_B1, RULE_GT, 2756}, {RF_NDVI, RULE_GT, 0.0564516},
+        {RF_NDSI_VAR, RULE_LE, 0.000488092}}},
+    /* Rule 4/20: (227.1, lift 1.9) */
+    {4, RULE_CLOUD, 3, {{RF_B5, RULE_LE, 1770}, {RF_NDVI, RULE_GT, 0.110778},
+        {RF_NDSI_VAR, RULE_LE, 0.000350481}}},
+    /* Rule 4/21: (193.5, lift 1.9) */
+    {4, RULE_CLOUD, 4, {{RF_B3, RULE_LE, 2095}, {RF_B7, RULE_GT, 1298},
+        {RF_B1_VAR, RULE_GT, 170233}, {RF_NDSI_VAR, RULE_LE, 0.00313462}}},
+    /* Rule 4/22: (877.9/10, lift 1.9) */
+    {4, RULE_CLOUD, 5, {{RF_B1, RULE_GT, 2162}, {RF_B3, RULE_LE, 2003},
+        {RF_B7, RULE_GT, 1505}, {RF_NDVI, RULE_GT, 0.0749564},
+        {RF_NDSI_VAR, RULE_LE, 0.136021}}},
+    /* Rule 4/23: (8938.3/275.6, lift 1.9) */
+    {4, RULE_CLOUD, 3, {{RF_B1, RULE_GT, 3362}, {RF_B5, RULE_GT, 2173},
+        {RF_NDSI_VAR, RULE_LE, 0.136021}}},
+    /* Rule 4/24: (323.2/9.4, lift 1.9) */
+    {4, RULE_CLOUD, 4, {{RF_B1, RULE_GT, 2162}, {RF_B2, RULE_LE, 1898},
+        {RF_B7, RULE_GT, 1298}, {RF_NDVI, RULE_LE, 0.0749564}}},
+    /* Rule 4/25: (3254.9/166.5, lift 1.8) */
+    {4, RULE_CLOUD, 4, {{RF_B2, RULE_GT, 4222}, {RF_NDSI, RULE_LE, 0.888811},
+        {RF_NDVI_VAR, RULE_LE, 0.00194084},
+        {RF_NDSI_VAR, RULE_LE, 0.0284024}}},
+    /* Rule 4/26: (1165.7/97.5, lift 1.8) */
+    {4, RULE_CLOUD, 4, {{RF_B1, RULE_LE, 3362}, {RF_B5, RULE_LE, 1649},
+        {RF_B7, RULE_GT, 1298}, {RF_NDSI_VAR, RULE_LE, 0.136021}}},
+    /* Rule 4/27: (5129.8/488.6, lift 1.8) */
+    {4, RULE_CLOUD, 5, {{RF_B1, RULE_GT, 2376}, {RF_B7, RULE_GT, 1505},
+        {RF_NDVI, RULE_GT, 0.0749564}, {RF_B4_VAR, RULE_GT, 5354.76},
+        {RF_NDSI_VAR, RULE_LE, 0.136021}}},
+    /* Rule 4/28: (126.5/12.1, lift 1.7) */
+    {4, RULE_CLOUD, 6, {{RF_B1, RULE_GT, 1187}, {RF_B7, RULE_LE, 1298},
+        {RF_NDSI, RULE_LE, 0.438529}, {RF_B2_VAR, RULE_GT, 356345},
+        {RF_NDVI_VAR, RULE_LE, 0.00194084},
+        {RF_NDSI_VAR, RULE_LE, 0.0284024}}},
+    /* Rule 4/29: (7965.1/822.8, lift 1.7) */
+    {4, RULE_CLOUD, 3, {{RF_B7, RULE_GT, 1298}, {RF_NDVI, RULE_LE, 0.307271},
+        {RF_NDSI_VAR, RULE_LE, 0.000488092}}},
+    /* Rule 4/30: (2268.3/362.9, lift 1.6) */
+    {4, RULE_CLOUD, 8, {{RF_B1, RULE_GT, 1187}, {RF_B2, RULE_LE, 4222},
+        {RF_B5, RULE_LE, 1770}, {RF_B7, RULE_GT, 1192},
+        {RF_NDSI, RULE_LE, 0.438529}, {RF_B2_VAR, RULE_LE, 356345},
+        {RF_NDVI_VAR, RULE_LE, 0.00194084},
+        {RF_NDSI_VAR, RULE_LE, 0.0284024}}},
+    /* Rule 4/31: (3018/556.2, lift 1.6) */
+    {4, RULE_CLOUD, 6, {{RF_B1, RULE_GT, 2629}, {RF_B2, RULE_LE, 3250},
+        {RF_B5, RULE_GT, 1649}, {RF_B7, RULE_GT, 1298}, {RF_B7, RULE_LE, 2681},
+        {RF_NDSI_VAR, RULE_LE, 0.136021}}},
+    /* Rule 4/32: (2135.4/411.8, lift 1.6) */
+    {4, RULE_CLOUD, 6, {{RF_B1, RULE_GT, 1187}, {RF_B3, RULE_LE, 1873},
+        {RF_B5, RULE_LE, 1770}, {RF_NDVI, RULE_GT, 0.110778},
+        {RF_NDVI_VAR, RULE_LE, 0.00194084},
+        {RF_NDSI_VAR, RULE_LE, 0.0284024}}},
+    /* Rule 4/33: (10111.7/2158.9, lift 1.5) */
+    {4, RULE_CLOUD, 3, {{RF_B7, RULE_GT, 1298}, {RF_NDVI, RULE_GT, 0.0932514},
+        {RF_NDSI_VAR, RULE_LE, 0.00313462}}},
+    /* Rule 4/34: (1258.5/278.7, lift 1.5) */
+    {4, RULE_CLOUD, 8, {{RF_B1, RULE_GT, 1187}, {RF_B2, RULE_LE, 1276},
+        {RF_B5, RULE_LE, 1770}, {RF_B7, RULE_LE, 1192},
+        {RF_NDSI, RULE_LE, 0.438529}, {RF_B2_VAR, RULE_LE, 356345},
+        {RF_NDVI_VAR, RULE_LE, 0.00194084}, {RF_NDSI_VAR, RULE_LE, 0.0284024}}}
+};
+
+/* Default class for each trial of the conservative model */
+static const int16 conserv_defaults[] =
+    {RULE_CLOUD, RULE_CLOUD, RULE_CLOUD,
+     RULE_CLOUD_FREE, RULE_CLOUD_FREE};
+
+/* Limited cloud mask model, which does not use the variances.  This is for
+   cases where the variance calculation is not possible, such as SLC-off
+   areas and areas near the edge of the image. */
+static const Rule_def_t lim_rules[] =
+{
+    /* Rule 0/1: (10764/235, lift 2.1) */
+    {0, RULE_CLOUD_FREE, 2, {{RF_B3, RULE_GT, 1424}, {RF_B7, RULE_LE, 1187}}},
+    /* Rule 0/2: (753/16, lift 2.1) */
+    {0, RULE_CLOUD_FREE, 3, {{RF_B1, RULE_LE, 2999},
+        {RF_NDVI, RULE_LE, 0.158153}, {RF_NDSI, RULE_LE, -0.212327}}},
+    /* Rule 0/3: (447/10, lift 2.0) */
+    {0, RULE_CLOUD_FREE, 2, {{RF_B1, RULE_LE, 2079}, {RF_B3, RULE_GT, 2080}}},
+    /* Rule 0/4: (1763/48, lift 2.0) */
+    {0, RULE_CLOUD_FREE, 3, {{RF_B1, RULE_GT, 6251}, {RF_B4, RULE_LE, 5012},
+        {RF_B7, RULE_LE, 2077}}},
+    /* Rule 0/5: (960/27, lift 2.0) */
+    {0, RULE_CLOUD_FREE, 3, {{RF_B1, RULE_LE, 2483}, {RF_B3, RULE_GT, 2408},
+        {RF_NDSI, RULE_GT, -0.212327}}},
+    /* Rule 0/6: (728/29, lift 2.0) */
+    {0, RULE_CLOUD_FREE, 3, {{RF_B1, RULE_LE, 2999}, {RF_B2, RULE_GT, 2771},
+        {RF_NDVI, RULE_LE, 0.0912175}}},
+    /* Rule 0/7: (4653/195, lift 2.0) */
+    {0, RULE_CLOUD_FREE, 2, {{RF_B4, RULE_GT, 4172}, {RF_B7, RULE_LE, 1464}}},
+    /* Rule 0/8: (5826/279, lift 2.0) */
+    {0, RULE_CLOUD_FREE, 4, {{RF_B1, RULE_LE, 3532}, {RF_B3, RULE_GT, 1727},
+        {RF_B4, RULE_GT, 1928}, {RF_B7, RULE_LE, 1464}}},
+    /* Rule 0/9: (1917/93, lift 2.0) */
+    {0, RULE_CLOUD_FREE, 5, {{RF_B1, RULE_LE, 2999}, {RF_B2, RULE_GT, 1970},
+        {RF_B5, RULE_LE, 1937}, {RF_B7, RULE_LE, 1619},
+        {RF_NDVI, RULE_LE, 0.0912175}}},
+    /* Rule 0/10: (1198/63, lift 2.0) */
+    {0, RULE_CLOUD_FREE, 4, {{RF_B1, RULE_GT, 2999}, {RF_B1, RULE_LE, 3589},
+        {RF_B4, RULE_GT, 3588}, {RF_B7, RULE_LE, 2077}}},
+    /* Rule 0/11: (1293/71, lift 2.0) */
+    {0, RULE_CLOUD_FREE, 3, {{RF_B1, RULE_LE, 2999}, {RF_B4, RULE_GT, 3173},
+        {RF_NDSI, RULE_GT, -0.0444104}}},
+    /* Rule 0/12: (2832/157, lift 2.0) */
+    {0, RULE_CLOUD_FREE, 2, {{RF_B1, RULE_LE, 1600}, {RF_B4, RULE_LE, 1928}}},
+    /* Rule 0/13: (2380/185, lift 1.9) */
+    {0, RULE_CLOUD_FREE, 2, {{RF_B4, RULE_LE, 2729},
+        {RF_NDSI, RULE_LE, -0.212327}}},
+    /* Rule 0/14: (2208/176, lift 1.9) */
+    {0, RULE_CLOUD_FREE, 3, {{RF_B1, RULE_LE, 2638}, {RF_B5, RULE_GT, 1937},
+        {RF_NDVI, RULE_LE, 0.0912175}}},
+    /* Rule 0/15: (1742/156, lift 1.9) */
+    {0, RULE_CLOUD_FREE, 2, {{RF_B7, RULE_LE, 1799},
+        {RF_NDSI, RULE_LE, -0.212327}}},
+    /* Rule 0/16: (1724/180, lift 1.9) */
+    {0, RULE_CLOUD_FREE, 4, {{RF_B1, RULE_LE, 1993}, {RF_B5, RULE_GT, 1937},
+        {RF_B7, RULE_GT, 1464}, {RF_NDVI, RULE_LE, 0.210062}}},
+    /* Rule 0/17: (23277/7218, lift 1.4) */
+    {0, RULE_CLOUD_FREE, 1, {{RF_B1, RULE_LE, 2999}}},
+    /* Rule 0/18: (3593/38, lift 1.9) */
+    {0, RULE_CLOUD, 3, {{RF_B1, RULE_GT, 2483}, {RF_NDVI, RULE_GT, 0.0912175},
+        {RF_NDSI, RULE_LE, -0.0444104}}},
+    /* Rule 0/19: (5613/71, lift 1.9) */
+    {0, RULE_CLOUD, 2, {{RF_B7, RULE_GT, 1266}, {RF_NDSI, RULE_GT, 0.491986}}},
+    /* Rule 0/20: (1100/125, lift 1.7) */
+    {0, RULE_CLOUD, 3, {{RF_B7, RULE_GT, 1464}, {RF_NDVI, RULE_GT, 0.210062},
+        {RF_NDSI, RULE_GT, -0.212327}}},
+    /* Rule 0/21: (267/39, lift 1.6) */
+    {0, RULE_CLOUD, 5, {{RF_B1, RULE_GT, 1600}, {RF_B3, RULE_LE, 1299},
+        {RF_B4, RULE_LE, 1928}, {RF_B7, RULE_GT, 919},
+        {RF_B7, RULE_LE, 1464}}},
+    /* Rule 0/22: (193/35, lift 1.6) */
+    {0, RULE_CLOUD, 6, {{RF_B1, RULE_GT, 1451}, {RF_B3, RULE_LE, 1139},
+        {RF_B7, RULE_LE, 919}, {RF_NDVI, RULE_GT, 0.0602801},
+        {RF_NDVI, RULE_LE, 0.421493}, {RF_NDSI, RULE_LE, 0.169811}}},
+    /* Rule 0/23: (32298/7826, lift 1.4) */
+    {0, RULE_CLOUD, 2, {{RF_B1, RULE_GT, 1802}, {RF_B7, RULE_GT, 919}}},
+    /* Rule 1/1: (801.4/3.8, lift 2.1) */
+    {1, RULE_CLOUD_FREE, 2, {{RF_B4, RULE_GT, 6829}, {RF_B5, RULE_LE, 3315}}},
+    /* Rule 1/2: (657/4.5, lift 2.1) */
+    {1, RULE_CLOUD_FREE, 1, {{RF_NDVI, RULE_GT, 0.44504}}},
+    /* Rule 1/3: (220.2/1.5, lift 2.1) */
+    {1, RULE_CLOUD_FREE, 4, {{RF_B1, RULE_LE, 3544}, {RF_B4, RULE_GT, 4212},
+        {RF_B5, RULE_GT, 1136}, {RF_B5, RULE_LE, 3315}}},
+    /* Rule 1/4: (6122.8/130.4, lift 2.1) */
+    {1, RULE_CLOUD_FREE, 2, {{RF_B3, RULE_GT, 1258}, {RF_B5, RULE_LE, 1136}}},
+    /* Rule 1/5: (988.6/45.5, lift 2.1) */
+    {1, RULE_CLOUD_FREE, 4, {{RF_B1, RULE_LE, 3544}, {RF_B5, RULE_GT, 1136},
+        {RF_B7, RULE_LE, 1067}, {RF_NDSI, RULE_GT, 0.143936}}},
+    /* Rule 1/6: (3721.5/193.8, lift 2.0) */
+    {1, RULE_CLOUD_FREE, 2, {{RF_B1, RULE_GT, 6251}, {RF_B7, RULE_LE, 1683}}},
+    /* Rule 1/7: (504.2/47.8, lift 1.9) */
+    {1, RULE_CLOUD_FREE, 5, {{RF_B1, RULE_GT, 1555}, {RF_B1, RULE_LE, 2321},
+        {RF_B4, RULE_LE, 3520}, {RF_B5, RULE_GT, 2467},
+        {RF_B7, RULE_LE, 1726}}},
+    /* Rule 1/8: (1057/103.5, lift 1.9) */
+    {1, RULE_CLOUD_FREE, 3, {{RF_B1, RULE_LE, 3544}, {RF_B2, RULE_GT, 3236},
+        {RF_B5, RULE_LE, 3315}}},
+    /* Rule 1/9: (671.1/76.4, lift 1.9) */
+    {1, RULE_CLOUD_FREE, 4, {{RF_B1, RULE_LE, 2835}, {RF_B3, RULE_GT, 2538},
+        {RF_NDSI, RULE_GT, -0.106196}, {RF_NDSI, RULE_LE, 0.143936}}},
+    /* Rule 1/10: (650.1/75.1, lift 1.9) */
+    {1, RULE_CLOUD_FREE, 3, {{RF_B4, RULE_LE, 4001}, {RF_B5, RULE_GT, 3315},
+        {RF_NDVI, RULE_LE, 0.0617448}}},
+    /* Rule 1/11: (1812.6/334.2, lift 1.8) */
+    {1, RULE_CLOUD_FREE, 3, {{RF_B1, RULE_LE, 2082}, {RF_B3, RULE_GT, 1839},
+        {RF_B4, RULE_LE, 3520}}},
+    /* Rule 1/12: (31120.8/12936.8, lift 1.3) */
+    {1, RULE_CLOUD_FREE, 1, {{RF_B4, RULE_LE, 4001}}},
+    /* Rule 1/13: (11094.4/118.4, lift 1.8) */
+    {1, RULE_CLOUD, 2, {{RF_B4, RULE_GT, 4001}, {RF_B5, RULE_GT, 3315}}},
+    /* Rule 1/14: (519/12.9, lift 1.8) */
+    {1, RULE_CLOUD, 3, {{RF_B1, RULE_GT, 2043}, {RF_B2, RULE_LE, 1763},
+        {RF_NDSI, RULE_LE, 0.143936}}},
+    /* Rule 1/15: (12178.2/334.3, lift 1.8) */
+    {1, RULE_CLOUD, 2, {{RF_B1, RULE_GT, 3544}, {RF_B7, RULE_GT, 1683}}},
+    /* Rule 1/16: (3402.2/106.4, lift 1.8) */
+    {1, RULE_CLOUD, 3, {{RF_B1, RULE_GT, 2599}, {RF_B5, RULE_GT, 3315},
+        {RF_NDVI, RULE_GT, 0.0617448}}},
+    /* Rule 1/17: (9675.1/785.7, lift 1.7) */
+    {1, RULE_CLOUD, 2, {{RF_B1, RULE_GT, 2835}, {RF_NDSI, RULE_LE, 0.143936}}},
+    /* Rule 1/18: (1278.7/104.9, lift 1.7) */
+    {1, RULE_CLOUD, 3, {{RF_B1, RULE_GT, 3264}, {RF_B2, RULE_LE, 3334},
+        {RF_B7, RULE_GT, 1067}}},
+    /* Rule 1/19: (564.8/53.3, lift 1.7) */
+    {1, RULE_CLOUD, 3, {{RF_B1, RULE_GT, 2151}, {RF_B2, RULE_LE, 1898},
+        {RF_B5, RULE_GT, 1537}}},
+    /* Rule 1/20: (228.7/24.9, lift 1.7) */
+    {1, RULE_CLOUD, 4, {{RF_B1, RULE_GT, 2082}, {RF_B3, RULE_LE, 1994},
+        {RF_NDVI, RULE_GT, 0.179141}, {RF_NDSI, RULE_LE, 0.143936}}},
+    /* Rule 1/21: (4430.9/528.7, lift 1.6) */
+    {1, RULE_CLOUD, 4, {{RF_B1, RULE_GT, 3544}, {RF_B1, RULE_LE, 6251},
+        {RF_B4, RULE_LE, 6829}, {RF_B5, RULE_GT, 1136}}},
+    /* Rule 1/22: (179.6/32.6, lift 1.5) */
+    {1, RULE_CLOUD, 5, {{RF_B2, RULE_LE, 2204}, {RF_B4, RULE_GT, 3520},
+        {RF_B5, RULE_LE, 3315}, {RF_NDVI, RULE_LE, 0.44504},
+        {RF_NDSI, RULE_LE, 0.143936}}},
+    /* Rule 1/23: (481.3/131.1, lift 1.4) */
+    {1, RULE_CLOUD, 7, {{RF_B1, RULE_GT, 1800}, {RF_B1, RULE_LE, 2082},
+        {RF_B3, RULE_LE, 1839}, {RF_B5, RULE_LE, 3315}, {RF_B7, RULE_GT, 1342},
+        {RF_NDVI, RULE_GT, 0.179141}, {RF_NDVI, RULE_LE, 0.207702}}},
+    /* Rule 1/24: (4787.7/1392.3, lift 1.3) */
+    {1, RULE_CLOUD, 5, {{RF_B1, RULE_GT, 2321}, {RF_B2, RULE_LE, 3236},
+        {RF_B4, RULE_LE, 4212}, {RF_B5, RULE_LE, 3315},
+        {RF_NDSI, RULE_LE, 0.143936}}},
+    /* Rule 1/25: (2379.8/758.4, lift 1.3) */
+    {1, RULE_CLOUD, 7, {{RF_B1, RULE_GT, 1555}, {RF_B1, RULE_LE, 1800},
+        {RF_B3, RULE_LE, 1839}, {RF_B5, RULE_GT, 1537},
+        {RF_NDVI, RULE_GT, 0.179141}, {RF_NDVI, RULE_LE, 0.44504},
+        {RF_NDSI, RULE_LE, -0.0472716}}},
+    /* Rule 1/26: (2563.3/868.5, lift 1.2) */
+    {1, RULE_CLOUD, 6, {{RF_B1, RULE_GT, 1182}, {RF_B5, RULE_GT, 1136},
+        {RF_B5, RULE_LE, 1537}, {RF_B7, RULE_GT, 542},
+        {RF_NDVI, RULE_LE, 0.44504}, {RF_NDSI, RULE_LE, 0.143936}}},
+    /* Rule 1/27: (897.2/366.5, lift 1.1) */
+    {1, RULE_CLOUD, 4, {{RF_B3, RULE_LE, 1258}, {RF_B5, RULE_LE, 1136},
+        {RF_B7, RULE_GT, 542}, {RF_NDVI, RULE_LE, 0.44504}}},
+    /* Rule 2/1: (286.3, lift 2.0) */
+    {2, RULE_CLOUD_FREE, 5, {{RF_B1, RULE_LE, 2497}, {RF_B3, RULE_GT, 2156},
+        {RF_B3, RULE_LE, 2276}, {RF_B7, RULE_LE, 1626},
+        {RF_NDVI, RULE_GT, 0.0650248}}},
+    /* Rule 2/2: (2084.7/6.1, lift 2.0) */
+    {2, RULE_CLOUD_FREE, 1, {{RF_NDSI, RULE_GT, 0.881556}}},
+    /* Rule 2/3: (347/7.9, lift 2.0) */
+    {2, RULE_CLOUD_FREE, 3, {{RF_B2, RULE_GT, 3653}, {RF_B7, RULE_LE, 1626},
+        {RF_NDVI, RULE_GT, 0.0650248}}},
+    /* Rule 2/4: (642.5/16.7, lift 2.0) */
+    {2, RULE_CLOUD_FREE, 4, {{RF_B1, RULE_LE, 2497}, {RF_B3, RULE_GT, 1979},
+        {RF_B7, RULE_LE, 1626}, {RF_NDSI, RULE_LE, 0.0546875}}},
+    /* Rule 2/5: (3129.8/84.8, lift 2.0) */
+    {2, RULE_CLOUD_FREE, 2, {{RF_B2, RULE_GT, 1011}, {RF_B7, RULE_LE, 486}}},
+    /* Rule 2/6: (264.7/8.4, lift 2.0) */
+    {2, RULE_CLOUD_FREE, 5, {{RF_B1, RULE_LE, 1966}, {RF_B5, RULE_GT, 1707},
+        {RF_B7, RULE_LE, 1626}, {RF_NDVI, RULE_GT, 0.0650248},
+        {RF_NDVI, RULE_LE, 0.12763}}},
+    /* Rule 2/7: (152/6.1, lift 1.9) */
+    {2, RULE_CLOUD_FREE, 4, {{RF_B5, RULE_GT, 2507}, {RF_B7, RULE_LE, 1626},
+        {RF_NDVI, RULE_GT, 0.0650248}, {RF_NDSI, RULE_GT, -0.254112}}},
+    /* Rule 2/8: (1358.7/66.7, lift 1.9) */
+    {2, RULE_CLOUD_FREE, 1, {{RF_B2, RULE_LE, 1011}}},
+    /* Rule 2/9: (7074/402.6, lift 1.9) */
+    {2, RULE_CLOUD_FREE, 2, {{RF_B3, RULE_GT, 1265}, {RF_B7, RULE_LE, 1008}}},
+    /* Rule 2/10: (918.4/59.4, lift 1.9) */
+    {2, RULE_CLOUD_FREE, 2, {{RF_B3, RULE_LE, 1265},
+        {RF_NDVI, RULE_GT, 0.403095}}},
+    /* Rule 2/11: (2111.8/153.8, lift 1.9) */
+    {2, RULE_CLOUD_FREE, 3, {{RF_B1, RULE_LE, 1725}, {RF_B7, RULE_LE, 1286},
+        {RF_NDVI, RULE_LE, 0.139127}}},
+    /* Rule 2/12: (1275.7/107.6, lift 1.9) */
+    {2, RULE_CLOUD_FREE, 4, {{RF_B1, RULE_LE, 1725}, {RF_B3, RULE_GT, 1205},
+        {RF_B4, RULE_LE, 2458}, {RF_B7, RULE_LE, 1286}}},
+    /* Rule 2/13: (3639.5/324.7, lift 1.8) */
+    {2, RULE_CLOUD_FREE, 5, {{RF_B1, RULE_GT, 1842}, {RF_B2, RULE_LE, 4235},
+        {RF_B4, RULE_GT, 1742}, {RF_B7, RULE_LE, 1286},
+        {RF_NDVI, RULE_LE, 0.0979757}}},
+    /* Rule 2/14: (1170.6/111.3, lift 1.8) */
+    {2, RULE_CLOUD_FREE, 4, {{RF_B2, RULE_LE, 4235}, {RF_B3, RULE_GT, 1265},
+        {RF_B5, RULE_GT, 1747}, {RF_B7, RULE_LE, 1286}}},
+    /* Rule 2/15: (126.8/12.2, lift 1.8) */
+    {2, RULE_CLOUD_FREE, 3, {{RF_B4, RULE_GT, 6150}, {RF_B5, RULE_LE, 3315},
+        {RF_NDSI, RULE_LE, 0.49737}}},
+    /* Rule 2/16: (1897.2/223.5, lift 1.8) */
+    {2, RULE_CLOUD_FREE, 3, {{RF_B5, RULE_LE, 3315},
+        {RF_NDSI, RULE_GT, 0.368125}, {RF_NDSI, RULE_LE, 0.49737}}},
+    /* Rule 2/17: (775.9/102.5, lift 1.8) */
+    {2, RULE_CLOUD_FREE, 5, {{RF_B1, RULE_LE, 3284}, {RF_B3, RULE_GT, 2276},
+        {RF_B5, RULE_GT, 1707}, {RF_B7, RULE_LE, 1626},
+        {RF_NDVI, RULE_GT, 0.0650248}}},
+    /* Rule 2/18: (441.9/66.5, lift 1.7) */
+    {2, RULE_CLOUD_FREE, 2, {{RF_B4, RULE_LE, 3074}, {RF_B5, RULE_GT, 3315}}},
+    /* Rule 2/19: (972/154.3, lift 1.7) */
+    {2, RULE_CLOUD_FREE, 3, {{RF_B1, RULE_LE, 3418}, {RF_B5, RULE_GT, 3315},
+        {RF_NDVI, RULE_LE, 0.079329}}},
+    /* Rule 2/20: (1000.4/161.7, lift 1.7) */
+    {2, RULE_CLOUD_FREE, 3, {{RF_B3, RULE_LE, 1205}, {RF_B7, RULE_LE, 1286},
+        {RF_NDSI, RULE_LE, -0.0934991}}},
+    /* Rule 2/21: (168.1/31.5, lift 1.6) */
+    {2, RULE_CLOUD_FREE, 4, {{RF_B5, RULE_GT, 2885}, {RF_B7, RULE_LE, 2112},
+        {RF_NDVI, RULE_GT, 0.0650248}, {RF_NDSI, RULE_GT, -0.254112}}},
+    /* Rule 2/22: (3523.5/696, lift 1.6) */
+    {2, RULE_CLOUD_FREE, 4, {{RF_B1, RULE_LE, 1966}, {RF_B3, RULE_GT, 1220},
+        {RF_B4, RULE_LE, 2470}, {RF_B7, RULE_LE, 1458}}},
+    /* Rule 2/23: (795.3/160.6, lift 1.6) */
+    {2, RULE_CLOUD_FREE, 5, {{RF_B1, RULE_LE, 1966}, {RF_B4, RULE_GT, 2470},
+        {RF_B4, RULE_LE, 3217}, {RF_B7, RULE_GT, 1286},
+        {RF_B7, RULE_LE, 1626}}},
+    /* Rule 2/24: (557.4/120.5, lift 1.6) */
+    {2, RULE_CLOUD_FREE, 4, {{RF_B5, RULE_GT, 2528}, {RF_B7, RULE_LE, 1805},
+        {RF_NDVI, RULE_GT, 0.0650248}, {RF_NDSI, RULE_GT, -0.254112}}},
+    /* Rule 2/25: (8172.8/1851.2, lift 1.6) */
+    {2, RULE_CLOUD_FREE, 2, {{RF_B1, RULE_LE, 3376},
+        {RF_NDVI, RULE_LE, 0.0650248}}},
+    /* Rule 2/26: (1800.2/430.1, lift 1.5) */
+    {2, RULE_CLOUD_FREE, 2, {{RF_B4, RULE_LE, 2856},
+        {RF_NDSI, RULE_LE, -0.254112}}},
+    /* Rule 2/27: (308.2/41.3, lift 1.7) */
+    {2, RULE_CLOUD, 3, {{RF_B1, RULE_GT, 1725}, {RF_B3, RULE_LE, 1265},
+        {RF_B7, RULE_GT, 486}}},
+    /* Rule 2/28: (278.4/47.5, lift 1.6) */
+    {2, RULE_CLOUD, 7, {{RF_B1, RULE_LE, 1725}, {RF_B2, RULE_GT, 1011},
+        {RF_B3, RULE_LE, 1265}, {RF_B4, RULE_GT, 2458}, {RF_B7, RULE_GT, 486},
+        {RF_B7, RULE_LE, 1286}, {RF_NDVI, RULE_LE, 0.403095}}},
+    /* Rule 2/29: (1011.9/222.6, lift 1.5) */
+    {2, RULE_CLOUD, 4, {{RF_B2, RULE_GT, 1011}, {RF_B5, RULE_LE, 1707},
+        {RF_B7, RULE_GT, 1286}, {RF_NDSI, RULE_LE, 0.368125}}},
+    /* Rule 2/30: (515.1/136.5, lift 1.5) */
+    {2, RULE_CLOUD, 4, {{RF_B1, RULE_GT, 1842}, {RF_B4, RULE_LE, 1742},
+        {RF_B5, RULE_LE, 1747}, {RF_B7, RULE_GT, 1008}}},
+    /* Rule 2/31: (46915.3/22120.7, lift 1.0) */
+    {2, RULE_CLOUD, 1, {{RF_NDSI, RULE_LE, 0.881556}}},
+    /* Rule 3/1: (709.4/15.7, lift 1.9) */
+    {3, RULE_CLOUD_FREE, 2, {{RF_B1, RULE_LE, 2118}, {RF_B2, RULE_GT, 2012}}},
+    /* Rule 3/2: (196.5/4.4, lift 1.8) */
+    {3, RULE_CLOUD_FREE, 3, {{RF_B1, RULE_LE, 3234}, {RF_B2, RULE_GT, 3108},
+        {RF_B5, RULE_GT, 3315}}},
+    /* Rule 3/3: (1753.6/96.9, lift 1.8) */
+    {3, RULE_CLOUD_FREE, 2, {{RF_B1, RULE_LE, 2467}, {RF_B3, RULE_GT, 2364}}},
+    /* Rule 3/4: (1047.4/69.7, lift 1.8) */
+    {3, RULE_CLOUD_FREE, 3, {{RF_B1, RULE_LE, 2654}, {RF_B5, RULE_GT, 3315},
+        {RF_NDVI, RULE_LE, 0.1719}}},
+    /* Rule 3/5: (2283.3/179.7, lift 1.7) */
+    {3, RULE_CLOUD_FREE, 4, {{RF_B1, RULE_LE, 2467}, {RF_B2, RULE_GT, 1983},
+        {RF_B5, RULE_GT, 1706}, {RF_NDVI, RULE_LE, 0.114312}}},
+    /* Rule 3/6: (1552.5/128.6, lift 1.7) */
+    {3, RULE_CLOUD_FREE, 3, {{RF_B1, RULE_LE, 2762}, {RF_B3, RULE_GT, 2437},
+        {RF_NDSI, RULE_GT, -0.115228}}},
+    /* Rule 3/7: (3784.7/387.6, lift 1.7) */
+    {3, RULE_CLOUD_FREE, 4, {{RF_B3, RULE_GT, 1665}, {RF_B7, RULE_LE, 1347},
+        {RF_NDVI, RULE_GT, -0.0240739}, {RF_NDVI, RULE_LE, 0.131339}}},
+    /* Rule 3/8: (3288.9/361.2, lift 1.7) */
+    {3, RULE_CLOUD_FREE, 3, {{RF_B1, RULE_GT, 6251}, {RF_B5, RULE_LE, 3112},
+        {RF_B7, RULE_LE, 2077}}},
+    /* Rule 3/9: (1266.7/159.1, lift 1.7) */
+    {3, RULE_CLOUD_FREE, 3, {{RF_B1, RULE_LE, 3160}, {RF_B3, RULE_GT, 2834},
+        {RF_B5, RULE_LE, 3112}}},
+    /* Rule 3/10: (1701.1/238.9, lift 1.6) */
+    {3, RULE_CLOUD_FREE, 3, {{RF_B4, RULE_GT, 5404}, {RF_B5, RULE_LE, 3112},
+        {RF_B7, RULE_LE, 2077}}},
+    /* Rule 3/11: (388.7/55.3, lift 1.6) */
+    {3, RULE_CLOUD_FREE, 5, {{RF_B1, RULE_LE, 2467}, {RF_B5, RULE_GT, 1706},
+        {RF_B7, RULE_GT, 1347}, {RF_NDVI, RULE_GT, 0.114312},
+        {RF_NDSI, RULE_GT, -0.0444104}}},
+    /* Rule 3/12: (902.2/145.9, lift 1.6) */
+    {3, RULE_CLOUD_FREE, 4, {{RF_B1, RULE_LE, 2118}, {RF_B4, RULE_LE, 3249},
+        {RF_B5, RULE_GT, 2406}, {RF_B7, RULE_LE, 1726}}},
+    /* Rule 3/13: (2501.9/446.9, lift 1.6) */
+    {3, RULE_CLOUD_FREE, 3, {{RF_B1, RULE_LE, 2118}, {RF_B4, RULE_LE, 2223},
+        {RF_B5, RULE_GT, 1706}}},
+    /* Rule 3/14: (2864.7/535.5, lift 1.5) */
+    {3, RULE_CLOUD_FREE, 4, {{RF_B1, RULE_LE, 1873}, {RF_B5, RULE_GT, 1138},
+        {RF_B7, RULE_LE, 1347}, {RF_NDVI, RULE_LE, 0.317016}}},
+    /* Rule 3/15: (1899.1/420.7, lift 1.5) */
+    {3, RULE_CLOUD_FREE, 3, {{RF_B1, RULE_LE, 3544}, {RF_B2, RULE_GT, 3043},
+        {RF_B5, RULE_LE, 3112}}},
+    /* Rule 3/16: (1598/394.3, lift 1.4) */
+    {3, RULE_CLOUD_FREE, 2, {{RF_B1, RULE_LE, 2654}, {RF_B5, RULE_GT, 3315}}},
+    /* Rule 3/17: (737.3/186, lift 1.4) */
+    {3, RULE_CLOUD_FREE, 4, {{RF_B1, RULE_LE, 1684}, {RF_B2, RULE_GT, 1342},
+        {RF_B5, RULE_LE, 2406}, {RF_B7, RULE_GT, 1347}}},
+    /* Rule 3/18: (38683.4/14494.6, lift 1.2) */
+    {3, RULE_CLOUD_FREE, 1, {{RF_B5, RULE_LE, 3315}}},
+    /* Rule 3/19: (7194.6, lift 2.1) */
+    {3, RULE_CLOUD, 2, {{RF_B1, RULE_GT, 3544}, {RF_B7, RULE_GT, 2077}}},
+    /* Rule 3/20: (323/3.8, lift 2.1) */
+    {3, RULE_CLOUD, 3, {{RF_B1, RULE_GT, 2467}, {RF_B5, RULE_LE, 3315},
+        {RF_NDSI, RULE_LE, -0.115228}}},
+    /* Rule 3/21: (563.4/23.1, lift 2.0) */
+    {3, RULE_CLOUD, 3, {{RF_B1, RULE_GT, 3160}, {RF_B2, RULE_LE, 3043},
+        {RF_B7, RULE_GT, 1347}}},
+    /* Rule 3/22: (8425.6/406.2, lift 2.0) */
+    {3, RULE_CLOUD, 2, {{RF_B1, RULE_GT, 2654}, {RF_B5, RULE_GT, 3315}}},
+    /* Rule 3/23: (8942.7/654, lift 2.0) */
+    {3, RULE_CLOUD, 3, {{RF_B1, RULE_GT, 3544}, {RF_B7, RULE_GT, 1347},
+        {RF_NDVI, RULE_GT, -0.626148}}},
+    /* Rule 3/24: (5373.8/411.2, lift 2.0) */
+    {3, RULE_CLOUD, 4, {{RF_B5, RULE_GT, 1157}, {RF_NDVI, RULE_GT, -0.564211},
+        {RF_NDVI, RULE_LE, -0.0240739}, {RF_NDSI, RULE_LE, 0.881468}}},
+    /* Rule 3/25: (1531.5/144.8, lift 1.9) */
+    {3, RULE_CLOUD, 3, {{RF_B1, RULE_GT, 2762}, {RF_B3, RULE_LE, 2834},
+        {RF_B7, RULE_GT, 1347}}},
+    /* Rule 3/26: (115.6/13, lift 1.9) */
+    {3, RULE_CLOUD, 5, {{RF_B1, RULE_GT, 1526}, {RF_B2, RULE_LE, 1342},
+        {RF_B5, RULE_LE, 3315}, {RF_B7, RULE_GT, 1347},
+        {RF_NDVI, RULE_GT, 0.114312}}},
+    /* Rule 3/27: (1386.2/198.3, lift 1.8) */
+    {3, RULE_CLOUD, 3, {{RF_B1, RULE_GT, 2467}, {RF_B3, RULE_LE, 2437},
+        {RF_B7, RULE_GT, 1347}}},
+    /* Rule 3/28: (107.2/23.2, lift 1.7) */
+    {3, RULE_CLOUD, 2, {{RF_B5, RULE_GT, 1136}, {RF_B5, RULE_LE, 1138}}},
+    /* Rule 3/29: (1097.6/247.2, lift 1.7) */
+    {3, RULE_CLOUD, 3, {{RF_B1, RULE_GT, 2123}, {RF_B2, RULE_LE, 1983},
+        {RF_B7, RULE_GT, 1347}}},
+    /* Rule 3/30: (4230.3/989.1, lift 1.6) */
+    {3, RULE_CLOUD, 4, {{RF_B1, RULE_GT, 2118}, {RF_B7, RULE_GT, 1347},
+        {RF_NDVI, RULE_GT, 0.114312}, {RF_NDSI, RULE_LE, -0.0444104}}},
+    /* Rule 3/31: (483.4/114.7, lift 1.6) */
+    {3, RULE_CLOUD, 6, {{RF_B1, RULE_GT, 1526}, {RF_B2, RULE_LE, 2012},
+        {RF_B4, RULE_GT, 3249}, {RF_B5, RULE_LE, 3315}, {RF_B7, RULE_GT, 1347},
+        {RF_NDVI, RULE_LE, 0.44504}}},
+    /* Rule 3/32: (516.7/123.6, lift 1.6) */
+    {3, RULE_CLOUD, 5, {{RF_B1, RULE_GT, 1526}, {RF_B1, RULE_LE, 2467},
+        {RF_B3, RULE_LE, 2364}, {RF_B5, RULE_LE, 1706},
+        {RF_B7, RULE_GT, 1347}}},
+    /* Rule 3/33: (1601.7/412.5, lift 1.6) */
+    {3, RULE_CLOUD, 6, {{RF_B1, RULE_GT, 1873}, {RF_B3, RULE_LE, 1665},
+        {RF_B5, RULE_GT, 1157}, {RF_NDVI, RULE_GT, -0.0240739},
+        {RF_NDVI, RULE_LE, 0.317016}, {RF_NDSI, RULE_GT, -0.184974}}},
+    /* Rule 3/34: (2091.4/633.1, lift 1.5) */
+    {3, RULE_CLOUD, 7, {{RF_B1, RULE_GT, 1684}, {RF_B4, RULE_GT, 2223},
+        {RF_B5, RULE_LE, 2406}, {RF_B7, RULE_GT, 1347},
+        {RF_NDVI, RULE_GT, 0.114312}, {RF_NDVI, RULE_LE, 0.44504},
+        {RF_NDSI, RULE_LE, -0.0800831}}},
+    /* Rule 3/35: (2531.2/772, lift 1.5) */
+    {3, RULE_CLOUD, 5, {{RF_B1, RULE_GT, 1526}, {RF_B3, RULE_LE, 2364},
+        {RF_B5, RULE_LE, 2626}, {RF_B7, RULE_GT, 1726},
+        {RF_NDVI, RULE_GT, 0.114312}}},
+    /* Rule 3/36: (781.6/292.1, lift 1.3) */
+    {3, RULE_CLOUD, 4, {{RF_B7, RULE_GT, 1086}, {RF_NDVI, RULE_GT, 0.131339},
+        {RF_NDSI, RULE_GT, 0.0375777}, {RF_NDSI, RULE_LE, 0.416984}}},
+    /* Rule 3/37: (4079.4/1565.3, lift 1.3) */
+    {3, RULE_CLOUD, 6, {{RF_B1, RULE_GT, 1526}, {RF_B3, RULE_LE, 2364},
+        {RF_B5, RULE_LE, 2406}, {RF_B7, RULE_GT, 1347},
+        {RF_NDVI, RULE_GT, 0.114312}, {RF_NDVI, RULE_LE, 0.44504}}},
+    /* Rule 4/1: (400.1, lift 2.1) */
+    {4, RULE_CLOUD_FREE, 2, {{RF_B7, RULE_LE, 1461},
+        {RF_NDSI, RULE_LE, -0.224928}}},
+    /* Rule 4/2: (815.6/0.4, lift 2.1) */
+    {4, RULE_CLOUD_FREE, 3, {{RF_B1, RULE_LE, 2601}, {RF_B3, RULE_GT, 2260},
+        {RF_B7, RULE_LE, 1623}}},
+    /* Rule 4/3: (273, lift 2.1) */
+    {4, RULE_CLOUD_FREE, 3, {{RF_B1, RULE_LE, 1511}, {RF_B2, RULE_GT, 1317},
+        {RF_B5, RULE_GT, 1516}}},
+    /* Rule 4/4: (1665.9/5.6, lift 2.1) */
+    {4, RULE_CLOUD_FREE, 1, {{RF_NDSI, RULE_GT, 0.85271}}},
+    /* Rule 4/5: (677.9/4.5, lift 2.1) */
+    {4, RULE_CLOUD_FREE, 3, {{RF_B1, RULE_LE, 2601},
+        {RF_NDVI, RULE_LE, 0.107894}, {RF_NDSI, RULE_LE, -0.177533}}},
+    /* Rule 4/6: (1275.5/13, lift 2.1) */
+    {4, RULE_CLOUD_FREE, 2, {{RF_B1, RULE_LE, 1645},
+        {RF_NDVI, RULE_LE, 0.107894}}},
+    /* Rule 4/7: (586.3/6.4, lift 2.1) */
+    {4, RULE_CLOUD_FREE, 2, {{RF_B2, RULE_LE, 1027}, {RF_B5, RULE_GT, 796}}},
+    /* Rule 4/8: (2953.5/46.3, lift 2.0) */
+    {4, RULE_CLOUD_FREE, 1, {{RF_B5, RULE_LE, 796}}},
+    /* Rule 4/9: (1042.7/19.5, lift 2.0) */
+    {4, RULE_CLOUD_FREE, 2, {{RF_B1, RULE_LE, 2601}, {RF_B3, RULE_GT, 2569}}},
+    /* Rule 4/10: (988.3/19.6, lift 2.0) */
+    {4, RULE_CLOUD_FREE, 3, {{RF_B1, RULE_LE, 1802}, {RF_B2, RULE_GT, 1292},
+        {RF_NDVI, RULE_LE, 0.107894}}},
+    /* Rule 4/11: (268/4.7, lift 2.0) */
+    {4, RULE_CLOUD_FREE, 4, {{RF_B2, RULE_GT, 1387}, {RF_B3, RULE_LE, 1461},
+        {RF_NDVI, RULE_LE, 0.412224}, {RF_NDSI, RULE_LE, -0.22841}}},
+    /* Rule 4/12: (719.9/16, lift 2.0) */
+    {4, RULE_CLOUD_FREE, 2, {{RF_B1, RULE_LE, 2005}, {RF_B3, RULE_GT, 1949}}},
+    /* Rule 4/13: (565.2/15.4, lift 2.0) */
+    {4, RULE_CLOUD_FREE, 1, {{RF_NDVI, RULE_GT, 0.412224}}},
+    /* Rule 4/14: (3293.8/99.1, lift 2.0) */
+    {4, RULE_CLOUD_FREE, 1, {{RF_B7, RULE_LE, 579}}},
+    /* Rule 4/15: (966.4/33.4, lift 2.0) */
+    {4, RULE_CLOUD_FREE, 3, {{RF_B1, RULE_LE, 3037}, {RF_B2, RULE_GT, 2885},
+        {RF_B5, RULE_LE, 4374}}},
+    /* Rule 4/16: (744.4/28.7, lift 2.0) */
+    {4, RULE_CLOUD_FREE, 3, {{RF_B2, RULE_LE, 1317}, {RF_B5, RULE_GT, 1516},
+        {RF_NDVI, RULE_GT, 0.107894}}},
+    /* Rule 4/17: (864.7/38.2, lift 2.0) */
+    {4, RULE_CLOUD_FREE, 3, {{RF_B1, RULE_GT, 2601}, {RF_B1, RULE_LE, 3037},
+        {RF_NDSI, RULE_GT, 0.143982}}},
+    /* Rule 4/18: (1667.8/114.9, lift 1.9) */
+    {4, RULE_CLOUD_FREE, 2, {{RF_B1, RULE_LE, 3037}, {RF_B3, RULE_GT, 2909}}},
+    /* Rule 4/19: (441.2/30.5, lift 1.9) */
+    {4, RULE_CLOUD_FREE, 2, {{RF_B4, RULE_GT, 7015}, {RF_B5, RULE_LE, 4374}}},
+    /* Rule 4/20: (129.7/8.6, lift 1.9) */
+    {4, RULE_CLOUD_FREE, 2, {{RF_B4, RULE_LE, 4251}, {RF_B5, RULE_GT, 4374}}},
+    /* Rule 4/21: (1596/121.5, lift 1.9) */
+    {4, RULE_CLOUD_FREE, 4, {{RF_B1, RULE_LE, 2247}, {RF_B2, RULE_GT, 1763},
+        {RF_B5, RULE_GT, 1493}, {RF_NDVI, RULE_LE, 0.107894}}},
+    /* Rule 4/22: (6175.3/491.4, lift 1.9) */
+    {4, RULE_CLOUD_FREE, 3, {{RF_B3, RULE_GT, 1223}, {RF_B7, RULE_LE, 1084},
+        {RF_NDSI, RULE_GT, -0.0853392}}},
+    /* Rule 4/23: (3766.2/366.4, lift 1.9) */
+    {4, RULE_CLOUD_FREE, 2, {{RF_B2, RULE_LE, 3959},
+        {RF_NDSI, RULE_GT, 0.267478}}},
+    /* Rule 4/24: (414.9/46.3, lift 1.8) */
+    {4, RULE_CLOUD_FREE, 2, {{RF_B5, RULE_LE, 1516},
+        {RF_NDSI, RULE_LE, -0.0853392}}},
+    /* Rule 4/25: (3150.8/363.8, lift 1.8) */
+    {4, RULE_CLOUD_FREE, 3, {{RF_B1, RULE_LE, 2005}, {RF_B5, RULE_GT, 1516},
+        {RF_NDVI, RULE_LE, 0.175138}}},
+    /* Rule 4/26: (1868.5/321.3, lift 1.7) */
+    {4, RULE_CLOUD_FREE, 3, {{RF_B1, RULE_LE, 2005}, {RF_B4, RULE_LE, 2856},
+        {RF_NDSI, RULE_LE, -0.22841}}},
+    /* Rule 4/27: (126.6/21.5, lift 1.7) */
+    {4, RULE_CLOUD_FREE, 3, {{RF_B2, RULE_GT, 3959}, {RF_B5, RULE_LE, 4374},
+        {RF_NDVI, RULE_GT, 0.0799109}}},
+    /* Rule 4/28: (2695.3/480.2, lift 1.7) */
+    {4, RULE_CLOUD_FREE, 4, {{RF_B1, RULE_LE, 2601}, {RF_B2, RULE_GT, 1906},
+        {RF_NDVI, RULE_LE, 0.107894}, {RF_NDSI, RULE_GT, -0.115822}}},
+    /* Rule 4/29: (3038/650.2, lift 1.6) */
+    {4, RULE_CLOUD_FREE, 3, {{RF_B1, RULE_LE, 2394}, {RF_B5, RULE_GT, 2533},
+        {RF_NDVI, RULE_LE, 0.201976}}},
+    /* Rule 4/30: (13065.9/2877.5, lift 1.6) */
+    {4, RULE_CLOUD_FREE, 3, {{RF_B3, RULE_GT, 1267}, {RF_B7, RULE_LE, 1461},
+        {RF_NDVI, RULE_LE, 0.412224}}},
+    /* Rule 4/31: (3319.6/846.9, lift 1.5) */
+    {4, RULE_CLOUD_FREE, 5, {{RF_B1, RULE_LE, 2392}, {RF_B2, RULE_GT, 1698},
+        {RF_B5, RULE_GT, 1516}, {RF_B7, RULE_LE, 1623},
+        {RF_NDVI, RULE_LE, 0.412224}}},
+    /* Rule 4/32: (477.2, lift 2.0) */
+    {4, RULE_CLOUD, 3, {{RF_B1, RULE_GT, 2005}, {RF_B2, RULE_LE, 1698},
+        {RF_B5, RULE_GT, 1516}}},
+    /* Rule 4/33: (261.5, lift 2.0) */
+    {4, RULE_CLOUD, 3, {{RF_B1, RULE_GT, 2247}, {RF_B2, RULE_LE, 1906},
+        {RF_B7, RULE_GT, 1082}}},
+    /* Rule 4/34: (546.4/1.6, lift 2.0) */
+    {4, RULE_CLOUD, 3, {{RF_B1, RULE_GT, 1645}, {RF_B2, RULE_LE, 1292},
+        {RF_B5, RULE_GT, 796}}},
+    /* Rule 4/35: (286.3/3.2, lift 2.0) */
+    {4, RULE_CLOUD, 4, {{RF_B1, RULE_GT, 2040}, {RF_B2, RULE_LE, 1763},
+        {RF_B7, RULE_GT, 1082}, {RF_NDVI, RULE_LE, 0.107894}}},
+    /* Rule 4/36: (262.7/10.2, lift 1.9) */
+    {4, RULE_CLOUD, 5, {{RF_B5, RULE_LE, 1516}, {RF_B7, RULE_GT, 1084},
+        {RF_NDVI, RULE_GT, 0.107894}, {RF_NDSI, RULE_GT, -0.0853392},
+        {RF_NDSI, RULE_LE, 0.267478}}},
+    /* Rule 4/37: (375.3/16.8, lift 1.9) */
+    {4, RULE_CLOUD, 4, {{RF_B1, RULE_GT, 2392}, {RF_B3, RULE_LE, 2260},
+        {RF_B5, RULE_GT, 1516}, {RF_NDVI, RULE_GT, 0.107894}}},
+    /* Rule 4/38: (7438.5/586.8, lift 1.8) */
+    {4, RULE_CLOUD, 4, {{RF_B2, RULE_GT, 3959}, {RF_B5, RULE_GT, 796},
+        {RF_NDVI, RULE_LE, 0.0799109}, {RF_NDSI, RULE_LE, 0.85271}}},
+    /* Rule 4/39: (863.1/107.7, lift 1.8) */
+    {4, RULE_CLOUD, 4, {{RF_B1, RULE_GT, 2247}, {RF_B3, RULE_LE, 2569},
+        {RF_NDSI, RULE_GT, -0.177533}, {RF_NDSI, RULE_LE, -0.115822}}},
+    /* Rule 4/40: (198.3/30.9, lift 1.7) */
+    {4, RULE_CLOUD, 5, {{RF_B1, RULE_GT, 1511}, {RF_B2, RULE_GT, 1317},
+        {RF_B2, RULE_LE, 1387}, {RF_B7, RULE_GT, 1461},
+        {RF_NDVI, RULE_GT, 0.175138}}},
+    /* Rule 4/41: (2902.8/463.9, lift 1.7) */
+    {4, RULE_CLOUD, 4, {{RF_B1, RULE_GT, 2601}, {RF_B2, RULE_LE, 2885},
+        {RF_B3, RULE_LE, 2909}, {RF_NDSI, RULE_LE, 0.143982}}},
+    /* Rule 4/42: (1471.7/245.2, lift 1.7) */
+    {4, RULE_CLOUD, 5, {{RF_B1, RULE_GT, 1802}, {RF_B2, RULE_LE, 1584},
+        {RF_B5, RULE_GT, 796}, {RF_NDSI, RULE_GT, -0.177533},
+        {RF_NDSI, RULE_LE, 0.267478}}},
+    /* Rule 4/43: (369.8/61.3, lift 1.7) */
+    {4, RULE_CLOUD, 6, {{RF_B1, RULE_GT, 2040}, {RF_B1, RULE_LE, 2601},
+        {RF_B3, RULE_LE, 2569}, {RF_B5, RULE_LE, 1493}, {RF_B7, RULE_GT, 1082},
+        {RF_NDSI, RULE_LE, 0.267478}}},
+    /* Rule 4/44: (3386.7/901.7, lift 1.5) */
+    {4, RULE_CLOUD, 4, {{RF_B1, RULE_GT, 1511}, {RF_B7, RULE_GT, 1461},
+        {RF_NDVI, RULE_GT, 0.175138}, {RF_NDSI, RULE_GT, -0.22841}}},
+    /* Rule 4/45: (44465.5/20067, lift 1.1) */
+    {4, RULE_CLOUD, 2, {{RF_B5, RULE_GT, 796}, {RF_NDSI, RULE_LE, 0.85271}}}
+};
+
+/* Default class for each trial of the limited model */
+static const int16 lim_defaults[] =
+    {RULE_CLOUD, RULE_CLOUD_FREE, RULE_CLOUD,
+     RULE_CLOUD_FREE, RULE_CLOUD};
+
+
+/******************************************************************************
+MODULE:  get_builtin_rules
+
+PURPOSE:  Loads the built-in conservative or limited rule set into a rule
+model.
+
+RETURN VALUE:
+Type = int
+Value          Description
+-----          -----------
+ERROR          Error occurred loading the rules
+SUCCESS        Successful completion
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+---------     ---------------  -------------------------------------
+10/14/2026    agent            Original Development, replacing the
+                               hard-coded rule chains in rule_based_model
+
+NOTES:
+  1. The model should be initialized via init_rule_model before calling this
+     routine.
+******************************************************************************/
+int get_builtin_rules
+(
+    bool use_variances,    /* I: load the conservative model which uses the
+                                 variances (true) or the limited model which
+                                 does not (false) */
+    Rule_model_t *model    /* O: built-in rule model */
+)
+{
+    char FUNC_NAME[] = "get_builtin_rules";   /* function name */
+    char errmsg[STR_SIZE];    /* error message */
+    int i;                    /* looping variable for the rules */
+    int j;                    /* looping variable for the conditions */
+    int nrules;               /* number of rules in the table */
+    int trial = -1;           /* current trial */
+    const Rule_def_t *rules = NULL;    /* rule table to be loaded */
+    const int16 *defaults = NULL;      /* default classes for the trials */
+
+    if (use_variances)
+    {
+        rules = conserv_rules;
+        nrules = sizeof (conserv_rules) / sizeof (conserv_rules[0]);
+        defaults = conserv_defaults;
+    }
+    else
+    {
+        rules = lim_rules;
+        nrules = sizeof (lim_rules) / sizeof (lim_rules[0]);
+        defaults = lim_defaults;
+    }
+
+    for (i = 0; i < nrules; i++)
+    {
+        /* Start a new trial if needed.  The rules for each trial are
+           contiguous in the tables. */
+        while (trial < rules[i].trial)
+        {
+            trial++;
+            if (add_rule_trial (defaults[trial], model) != SUCCESS)
+            {
+                sprintf (errmsg, "Error adding trial %d", trial);
+                error_handler (true, FUNC_NAME, errmsg);
+                return (ERROR);
+            }
+        }
+
+        if (add_rule (rules[i].class_code, model) != SUCCESS)
+        {
+            sprintf (errmsg, "Error adding rule %d", i);
+            error_handler (true, FUNC_NAME, errmsg);
+            return (ERROR);
+        }
+
+        for (j = 0; j < rules[i].nconds; j++)
+        {
+            if (add_rule_cond (rules[i].conds[j].feature, rules[i].conds[j].op,
+                rules[i].conds[j].threshold, model) != SUCCESS)
+            {
+                sprintf (errmsg, "Error adding condition %d for rule %d", j,
+                    i);
+                error_handler (true, FUNC_NAME, errmsg);
+                return (ERROR);
+            }
+        }
+    }
+
+    return (SUCCESS);
+}
@@ -0,0 +1,336 @@
+#include <math.h>
+#include "spectral_index.h"
+
+/* The vectorized indices are compiled for AVX2 with gcc's target attribute
+   and selected at run time, so the application doesn't need to be built
+   with -mavx2 to use them */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SPEC_INDEX_AVX2
+#include <immintrin.h>
+#endif
+
+/******************************************************************************
+MODULE:  index_ratio (static)
+
+PURPOSE:  Computes the band ratio of the index for a pixel.
+index = (band1 - band2) / (band1 + band2)
+
+RETURN VALUE:
+Type = float
+Value      Description
+-----      -----------
+ratio      Band ratio, kept between -1.0 and 1.0
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development (pulled from make_index)
+
+NOTES:
+  1. The sum and difference of two int16 values are exact as floats, so the
+     ratio is the correctly rounded quotient, the same as the AVX2 division.
+  2. If both bands are 0, the ratio is not a number.
+******************************************************************************/
+static inline float index_ratio
+(
+    int band1,           /* I: first band value */
+    int band2            /* I: second band value */
+)
+{
+    float ratio;         /* band ratio */
+
+    ratio = (float) (band1 - band2) / (float) (band1 + band2);
+
+    /* Keep the ratio between -1.0, 1.0 */
+    if (ratio > 1.0)
+        ratio = 1.0;
+    else if (ratio < -1.0)
+        ratio = -1.0;
+    return (ratio);
+}
+
+
+#ifdef SPEC_INDEX_AVX2
+/******************************************************************************
+MODULE:  index_ratio_avx2 (static)
+
+PURPOSE:  Computes the band ratio of the index for 8 pixels, and flags the
+pixels which are fill in either band.
+
+RETURN VALUE:
+Type = __m256
+Value      Description
+-----      -----------
+ratio      Band ratios, kept between -1.0 and 1.0
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. The ratios are the same as index_ratio, including the ratio which is
+     not a number when both bands are 0, since the comparisons used to clamp
+     the ratio are false for it.
+******************************************************************************/
+__attribute__ ((target ("avx2")))
+static inline __m256 index_ratio_avx2
+(
+    int16 *band1,        /* I: first band values for the 8 pixels */
+    int16 *band2,        /* I: second band values for the 8 pixels */
+    __m256i fill_value,  /* I: fill value of the bands */
+    __m256 *fill         /* O: all bits set for the fill pixels */
+)
+{
+    __m256i b1, b2;      /* band values as 32-bit integers */
+    __m256 ratio;        /* band ratios */
+    __m256 one = _mm256_set1_ps (1.0);        /* upper limit of the ratio */
+    __m256 minus_one = _mm256_set1_ps (-1.0); /* lower limit of the ratio */
+
+    b1 = _mm256_cvtepi16_epi32 (_mm_loadu_si128 ((__m128i *) band1));
+    b2 = _mm256_cvtepi16_epi32 (_mm_loadu_si128 ((__m128i *) band2));
+    *fill = _mm256_castsi256_ps (_mm256_or_si256 (
+        _mm256_cmpeq_epi32 (b1, fill_value),
+        _mm256_cmpeq_epi32 (b2, fill_value)));
+
+    ratio = _mm256_div_ps (_mm256_cvtepi32_ps (_mm256_sub_epi32 (b1, b2)),
+        _mm256_cvtepi32_ps (_mm256_add_epi32 (b1, b2)));
+    ratio = _mm256_blendv_ps (ratio, one,
+        _mm256_cmp_ps (ratio, one, _CMP_GT_OQ));
+    ratio = _mm256_blendv_ps (ratio, minus_one,
+        _mm256_cmp_ps (ratio, minus_one, _CMP_LT_OQ));
+    return (ratio);
+}
+
+
+/******************************************************************************
+MODULE:  spectral_index_float_avx2 (static)
+
+PURPOSE:  Computes the float index for as many groups of 8 pixels as the
+arrays hold.
+
+RETURN VALUE:
+Type = int
+Value      Description
+-----      -----------
+pix        Pixel after the last one computed; the caller computes the
+           pixels from here to the end of the arrays
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+******************************************************************************/
+__attribute__ ((target ("avx2")))
+static int spectral_index_float_avx2
+(
+    int16 *band1,        /* I: first band of the index */
+    int16 *band2,        /* I: second band of the index */
+    int fill_value,      /* I: fill value of the bands */
+    int npix,            /* I: number of pixels in the arrays */
+    float index_fill,    /* I: index value for the fill pixels */
+    float *index         /* O: index values */
+)
+{
+    int pix;             /* current pixel being processed */
+    __m256i fill_v = _mm256_set1_epi32 (fill_value);  /* band fill value */
+    __m256 index_fill_v = _mm256_set1_ps (index_fill); /* index fill value */
+    __m256 fill;         /* fill flags for the pixels */
+    __m256 ratio;        /* band ratios for the pixels */
+
+    for (pix = 0; pix + 8 <= npix; pix += 8)
+    {
+        ratio = index_ratio_avx2 (&band1[pix], &band2[pix], fill_v, &fill);
+        _mm256_storeu_ps (&index[pix], _mm256_blendv_ps (ratio, index_fill_v,
+            fill));
+    }
+
+    return (pix);
+}
+
+
+/******************************************************************************
+MODULE:  spectral_index_int16_avx2 (static)
+
+PURPOSE:  Computes the fixed-point index for as many groups of 8 pixels as the
+arrays hold.
+
+RETURN VALUE:
+Type = int
+Value      Description
+-----      -----------
+pix        Pixel after the last one computed; the caller computes the
+           pixels from here to the end of the arrays
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. The conversion rounds to the nearest integer with ties to even, which is
+     the default rounding mode also used by lrintf in the scalar code.
+******************************************************************************/
+__attribute__ ((target ("avx2")))
+static int spectral_index_int16_avx2
+(
+    int16 *band1,        /* I: first band of the index */
+    int16 *band2,        /* I: second band of the index */
+    int fill_value,      /* I: fill value of the bands */
+    int npix,            /* I: number of pixels in the arrays */
+    int16 index_fill,    /* I: index value for the fill pixels */
+    int16 *index         /* O: fixed-point index values */
+)
+{
+    int pix;             /* current pixel being processed */
+    __m256i fill_v = _mm256_set1_epi32 (fill_value);  /* band fill value */
+    __m256 scale = _mm256_set1_ps ((float) SPEC_INDEX_SCALE);  /* scale of
+                            the fixed-point values */
+    __m256 fill;         /* fill flags for the pixels */
+    __m256 ratio;        /* band ratios for the pixels */
+    __m256i value;       /* fixed-point values for the pixels */
+
+    for (pix = 0; pix + 8 <= npix; pix += 8)
+    {
+        /* Scale the ratios, using 0 for the ratios which are not a number */
+        ratio = index_ratio_avx2 (&band1[pix], &band2[pix], fill_v, &fill);
+        ratio = _mm256_and_ps (ratio, _mm256_cmp_ps (ratio, ratio,
+            _CMP_ORD_Q));
+        value = _mm256_cvtps_epi32 (_mm256_mul_ps (ratio, scale));
+        value = _mm256_blendv_epi8 (value, _mm256_set1_epi32 (index_fill),
+            _mm256_castps_si256 (fill));
+
+        /* Pack the values to 16 bits */
+        _mm_storeu_si128 ((__m128i *) &index[pix], _mm_packs_epi32 (
+            _mm256_castsi256_si128 (value),
+            _mm256_extracti128_si256 (value, 1)));
+    }
+
+    return (pix);
+}
+#endif
+
+
+/******************************************************************************
+MODULE:  spectral_index_float
+
+PURPOSE:  Computes the spectral index of two bands as floats.
+index = (band1 - band2) / (band1 + band2)
+
+RETURN VALUE:
+Type = None
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development (pulled from make_index)
+
+NOTES:
+  1. If the current pixel is fill in either band, then the index is
+     index_fill.  Saturated values are not handled as special cases.
+  2. The AVX2 index (spectral_index_float_avx2) produces identical results.
+     The loop below computes the pixels it leaves over, or all of the pixels
+     if AVX2 isn't available.
+******************************************************************************/
+void spectral_index_float
+(
+    int16 *band1,        /* I: first band of the index */
+    int16 *band2,        /* I: second band of the index */
+    int fill_value,      /* I: fill value of the bands */
+    int npix,            /* I: number of pixels in the arrays */
+    float index_fill,    /* I: index value for the fill pixels */
+    float *index         /* O: index values */
+)
+{
+    int pix = 0;         /* current pixel being processed */
+
+#ifdef SPEC_INDEX_AVX2
+    if (__builtin_cpu_supports ("avx2"))
+        pix = spectral_index_float_avx2 (band1, band2, fill_value, npix,
+            index_fill, index);
+#endif
+
+    for ( ; pix < npix; pix++)
+    {
+        if (band1[pix] == fill_value || band2[pix] == fill_value)
+            index[pix] = index_fill;
+        else
+            index[pix] = index_ratio (band1[pix], band2[pix]);
+    }
+}
+
+
+/******************************************************************************
+MODULE:  spectral_index_int16
+
+PURPOSE:  Computes the spectral index of two bands as fixed-point values,
+which hold the index scaled by SPEC_INDEX_SCALE.
+
+RETURN VALUE:
+Type = None
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. The fixed-point value is the float index of spectral_index_float times
+     SPEC_INDEX_SCALE, rounded to the nearest integer, so it is within 0.5 of
+     the scaled float index and takes half the bytes.
+  2. If the current pixel is fill in either band, then the index is
+     index_fill.  If both bands are 0, the index is 0.
+  3. The AVX2 index (spectral_index_int16_avx2) produces identical results.
+******************************************************************************/
+void spectral_index_int16
+(
+    int16 *band1,        /* I: first band of the index */
+    int16 *band2,        /* I: second band of the index */
+    int fill_value,      /* I: fill value of the bands */
+    int npix,            /* I: number of pixels in the arrays */
+    int16 index_fill,    /* I: index value for the fill pixels */
+    int16 *index         /* O: fixed-point index values */
+)
+{
+    int pix = 0;         /* current pixel being processed */
+    float ratio;         /* band ratio */
+
+#ifdef SPEC_INDEX_AVX2
+    if (__builtin_cpu_supports ("avx2"))
+        pix = spectral_index_int16_avx2 (band1, band2, fill_value, npix,
+            index_fill, index);
+#endif
+
+    for ( ; pix < npix; pix++)
+    {
+        if (band1[pix] == fill_value || band2[pix] == fill_value)
+            index[pix] = index_fill;
+        else if (band1[pix] == 0 && band2[pix] == 0)
+            index[pix] = 0;
+        else
+        {
+            ratio = index_ratio (band1[pix], band2[pix]);
+            index[pix] = (int16) lrintf (ratio * (float) SPEC_INDEX_SCALE);
+        }
+    }
+}
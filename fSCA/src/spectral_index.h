@@ -0,0 +1,32 @@
+#ifndef _SPECTRAL_INDEX_H_
+#define _SPECTRAL_INDEX_H_
+
+#include "common.h"
+
+/* Scale of the fixed-point index values, which hold index * SPEC_INDEX_SCALE
+   rounded to the nearest integer.  This matches the SCALE_FACTOR of the
+   scaled products. */
+#define SPEC_INDEX_SCALE 10000
+
+/* Prototypes */
+void spectral_index_float
+(
+    int16 *band1,        /* I: first band of the index */
+    int16 *band2,        /* I: second band of the index */
+    int fill_value,      /* I: fill value of the bands */
+    int npix,            /* I: number of pixels in the arrays */
+    float index_fill,    /* I: index value for the fill pixels */
+    float *index         /* O: index values */
+);
+
+void spectral_index_int16
+(
+    int16 *band1,        /* I: first band of the index */
+    int16 *band2,        /* I: second band of the index */
+    int fill_value,      /* I: fill value of the bands */
+    int npix,            /* I: number of pixels in the arrays */
+    int16 index_fill,    /* I: index value for the fill pixels */
+    int16 *index         /* O: fixed-point index values */
+);
+
+#endif
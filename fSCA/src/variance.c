@@ -1,10 +1,78 @@
+#include <float.h>
 #include <math.h>
 #include "revised_cloud_mask.h"
 
+/* Scale of the index values in the sums.  The indices are ratios of int16
+   differences and sums, so a nonzero index is at least 2^-16 in size and is
+   a multiple of 2^-39, the spacing of the floats from 2^-16 to 2^-15.  Index
+   values scaled by 2^39 are therefore integers. */
+#define INDEX_SCALE 549755813888.0
+
+/* Running column tables for one input plane.  For every sample these hold
+   the sum and the sum of squares of the scaled values, and the number of
+   fill pixels and of pixels which the sums can't hold, in the window lines
+   of that column.  The sums are integers, so they are exact however many
+   lines are added and dropped.  The squares of the scaled index values need
+   128 bits, while those of the bands fit in 64. */
+typedef struct {
+    const int16 *band;   /* int16 plane, or NULL for a float plane */
+    const float *index;  /* float plane, or NULL for an int16 plane */
+    double scale;        /* scale of the values in the sums */
+    long long *col_sum;  /* sum of the scaled values in each window column */
+    long long *col_sumsq;  /* sum of the squared values in each window
+                              column (int16 planes) */
+    __int128 *col_wide_sumsq;  /* sum of the squared scaled values in each
+                                  window column (float planes) */
+    int *col_fill;       /* number of fill pixels in each window column */
+    int *col_other;      /* number of pixels in each window column which
+                            aren't in the sums (NaN, the 0/0 index, or any
+                            value which doesn't scale to an integer) */
+} Var_tables_t;
+
+
 /******************************************************************************
-MODULE:  variance
+MODULE:  scale_index (static)
+
+PURPOSE:  Scales an index value to the integer which is kept in the sums.
+
+RETURN VALUE:
+Type = bool
+Value          Description
+-----          -----------
+true           The value was scaled
+false          The value is NaN, or doesn't scale to an integer
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+---------     ---------------  -------------------------------------
+10/15/2026    agent            Original Development
+
+NOTES:
+******************************************************************************/
+static bool scale_index
+(
+    float value,         /* I: index value */
+    long long *scaled    /* O: scaled value */
+)
+{
+    double scaled_value = value * INDEX_SCALE;   /* exact scaled value */
+
+    if (!(fabs (value) <= 1.0))
+        return false;
+    *scaled = (long long) scaled_value;
+    return (*scaled == scaled_value);
+}
 
-PURPOSE:  Computes the variance of the 9x9 window of pixels in the input array.
+
+/******************************************************************************
+MODULE:  update_columns_int16, update_columns_float
+
+PURPOSE:  Adds one input line to, and optionally drops one input line from,
+the running column tables of a plane.  The int16 version works directly on
+the reflectance bands so they don't need to be converted to floats first.
 
 RETURN VALUE:
 Type = None
@@ -15,105 +83,897 @@ at the USGS EROS
 HISTORY:
 Date          Programmer       Reason
 ---------     ---------------  -------------------------------------
-5/19/2014     Gail Schmidt     Original Development
+10/14/2026    agent            Original Development
+10/15/2026    agent            Keep integer sums of the scaled values, which
+                               are exact
 
 NOTES:
-  1. Input and output arrays are 1D arrays of size nlines * nsamps.
-  2. Any window containing a fill value will not have a variance calculated.
+  1. Fill pixels are never added to the sum tables (only to the fill count),
+     so the large fill values don't overflow the sums.
+  2. NaN pixels, which the indices have where both bands are 0, are only
+     counted as well, as are any index values which don't scale to an
+     integer.  The variance of the windows holding them is computed from
+     the window pixels.
 ******************************************************************************/
-void variance
+static void update_columns_int16
 (
-    float *array,       /* I: input array of data for which to compute the
-                              covariances */
-    int fill_value,     /* I: fill value for the band */
-    int nlines,         /* I: number of lines in the data arrays */
-    int nsamps,         /* I: number of samples in the data arrays */
-    float *variance     /* O: output variance array */
+    const int16 *add_line,   /* I: line to be added to the tables */
+    const int16 *drop_line,  /* I: line to be dropped from the tables; NULL
+                                   if no line is to be dropped */
+    int fill_value,          /* I: fill value for the plane */
+    int nsamps,              /* I: number of samples in the lines */
+    Var_tables_t *tbl        /* I/O: running column tables */
 )
 {
-    bool skip_window;   /* should the current window be skipped due to fill */
-    int i;              /* looping variable */
-    int line;           /* current line being processed */
     int samp;           /* current sample being processed */
-    int line_window;    /* current line in the window being processed */
-    int samp_window;    /* current sample in the window being processed */
+    long long val;      /* current input value */
+
+    if (drop_line != NULL)
+    {
+        for (samp = 0; samp < nsamps; samp++)
+        {
+            if (drop_line[samp] == fill_value)
+                tbl->col_fill[samp]--;
+            else
+            {
+                val = drop_line[samp];
+                tbl->col_sum[samp] -= val;
+                tbl->col_sumsq[samp] -= val * val;
+            }
+        }
+    }
+
+    for (samp = 0; samp < nsamps; samp++)
+    {
+        if (add_line[samp] == fill_value)
+            tbl->col_fill[samp]++;
+        else
+        {
+            val = add_line[samp];
+            tbl->col_sum[samp] += val;
+            tbl->col_sumsq[samp] += val * val;
+        }
+    }
+}
+
+static void update_columns_float
+(
+    const float *add_line,   /* I: line to be added to the tables */
+    const float *drop_line,  /* I: line to be dropped from the tables; NULL
+                                   if no line is to be dropped */
+    int fill_value,          /* I: fill value for the plane */
+    int nsamps,              /* I: number of samples in the lines */
+    Var_tables_t *tbl        /* I/O: running column tables */
+)
+{
+    int samp;           /* current sample being processed */
+    long long val;      /* current scaled input value */
+
+    if (drop_line != NULL)
+    {
+        for (samp = 0; samp < nsamps; samp++)
+        {
+            if (drop_line[samp] == fill_value)
+                tbl->col_fill[samp]--;
+            else if (!scale_index (drop_line[samp], &val))
+                tbl->col_other[samp]--;
+            else
+            {
+                tbl->col_sum[samp] -= val;
+                tbl->col_wide_sumsq[samp] -= (__int128) val * val;
+            }
+        }
+    }
+
+    for (samp = 0; samp < nsamps; samp++)
+    {
+        if (add_line[samp] == fill_value)
+            tbl->col_fill[samp]++;
+        else if (!scale_index (add_line[samp], &val))
+            tbl->col_other[samp]++;
+        else
+        {
+            tbl->col_sum[samp] += val;
+            tbl->col_wide_sumsq[samp] += (__int128) val * val;
+        }
+    }
+}
+
+
+/******************************************************************************
+MODULE:  update_column
+
+PURPOSE:  Brings the running column tables of every plane up to date for a
+single sample, for the window centered on the specified line.  The tables
+are either slid down from the previous line or rebuilt from the window lines.
+
+RETURN VALUE:
+Type = None
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+---------     ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+10/15/2026    agent            Keep integer sums of the scaled values, which
+                               are exact
+
+NOTES:
+  1. This is used for the sparse (span) calculations, where a column may not
+     have been needed for the previous line.
+******************************************************************************/
+static void update_column
+(
+    int16 **bands,      /* I: array of pointers to the int16 band planes */
+    int nbands,         /* I: number of int16 band planes */
+    float **indices,    /* I: array of pointers to the float index planes */
+    int nindices,       /* I: number of float index planes */
+    int fill_value,     /* I: fill value for the bands and indices */
+    int window,         /* I: size of the (square) variance window */
+    int nsamps,         /* I: number of samples in the planes */
+    int line,           /* I: center line of the window */
+    int samp,           /* I: sample (column) to be updated */
+    bool rebuild,       /* I: rebuild the column from the window lines;
+                              otherwise slide it down from line - 1 */
+    Var_tables_t *tbl   /* I/O: running column tables for each plane */
+)
+{
+    int ip;             /* plane looping variable */
+    int win_line;       /* current line in the window */
+    int half_window = window / 2;     /* half window size */
     long pix;           /* current pixel being processed */
-    long win_pix;       /* current pixel in the window being processed */
-    int count;          /* count of the pixels in the window */
-    int WINDOW = 9;     /* variance window 9x9 around the center pixel */
-    int HALF_WINDOW = (int) (WINDOW / 2); /* half window size */
-    int SQR_WINDOW = (WINDOW * WINDOW); /* squared window size */
+    long long val;      /* current scaled input value */
+    Var_tables_t *ptbl; /* tables for the current plane */
+
+    if (rebuild)
+    {
+        for (ip = 0; ip < nbands + nindices; ip++)
+        {
+            tbl[ip].col_sum[samp] = 0;
+            if (ip < nbands)
+                tbl[ip].col_sumsq[samp] = 0;
+            else
+                tbl[ip].col_wide_sumsq[samp] = 0;
+            tbl[ip].col_fill[samp] = 0;
+            tbl[ip].col_other[samp] = 0;
+        }
+
+        for (win_line = line - half_window; win_line <= line + half_window;
+             win_line++)
+        {
+            pix = (long) win_line * nsamps + samp;
+            for (ip = 0; ip < nbands; ip++)
+            {
+                ptbl = &tbl[ip];
+                if (bands[ip][pix] == fill_value)
+                    ptbl->col_fill[samp]++;
+                else
+                {
+                    val = bands[ip][pix];
+                    ptbl->col_sum[samp] += val;
+                    ptbl->col_sumsq[samp] += val * val;
+                }
+            }
+            for (ip = 0; ip < nindices; ip++)
+            {
+                ptbl = &tbl[nbands+ip];
+                if (indices[ip][pix] == fill_value)
+                    ptbl->col_fill[samp]++;
+                else if (!scale_index (indices[ip][pix], &val))
+                    ptbl->col_other[samp]++;
+                else
+                {
+                    ptbl->col_sum[samp] += val;
+                    ptbl->col_wide_sumsq[samp] += (__int128) val * val;
+                }
+            }
+        }
+        return;
+    }
+
+    /* Drop the old top line, then add the new bottom line */
+    pix = (long) (line - half_window - 1) * nsamps + samp;
+    for (ip = 0; ip < nbands; ip++)
+    {
+        ptbl = &tbl[ip];
+        if (bands[ip][pix] == fill_value)
+            ptbl->col_fill[samp]--;
+        else
+        {
+            val = bands[ip][pix];
+            ptbl->col_sum[samp] -= val;
+            ptbl->col_sumsq[samp] -= val * val;
+        }
+    }
+    for (ip = 0; ip < nindices; ip++)
+    {
+        ptbl = &tbl[nbands+ip];
+        if (indices[ip][pix] == fill_value)
+            ptbl->col_fill[samp]--;
+        else if (!scale_index (indices[ip][pix], &val))
+            ptbl->col_other[samp]--;
+        else
+        {
+            ptbl->col_sum[samp] -= val;
+            ptbl->col_wide_sumsq[samp] -= (__int128) val * val;
+        }
+    }
+
+    pix += (long) window * nsamps;
+    for (ip = 0; ip < nbands; ip++)
+    {
+        ptbl = &tbl[ip];
+        if (bands[ip][pix] == fill_value)
+            ptbl->col_fill[samp]++;
+        else
+        {
+            val = bands[ip][pix];
+            ptbl->col_sum[samp] += val;
+            ptbl->col_sumsq[samp] += val * val;
+        }
+    }
+    for (ip = 0; ip < nindices; ip++)
+    {
+        ptbl = &tbl[nbands+ip];
+        if (indices[ip][pix] == fill_value)
+            ptbl->col_fill[samp]++;
+        else if (!scale_index (indices[ip][pix], &val))
+            ptbl->col_other[samp]++;
+        else
+        {
+            ptbl->col_sum[samp] += val;
+            ptbl->col_wide_sumsq[samp] += (__int128) val * val;
+        }
+    }
+}
+
+
+/******************************************************************************
+MODULE:  window_variance (static)
+
+PURPOSE:  Computes the variance of the window centered on a pixel from the
+window pixels, with the original two-pass calculation.
+
+RETURN VALUE:
+Type = double
+Value          Description
+-----          -----------
+var            Variance of the window
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+---------     ---------------  -------------------------------------
+10/15/2026    agent            Original Development (pulled from the
+                               original variance)
+
+NOTES:
+  1. The window must not contain fill.  The pixels are visited in the same
+     order, and the sums are formed in the same order, as the original
+     variance, so the result is the same to the last bit.  A NaN in the
+     window makes the variance NaN as it always did.
+  2. The squares must not be fused with the sums into multiply-adds, which
+     the original didn't use, so contraction is turned off for gcc and the
+     square is its own statement for compilers which only contract within
+     an expression.
+******************************************************************************/
+#if defined(__GNUC__) && !defined(__clang__)
+__attribute__ ((optimize ("fp-contract=off")))
+#endif
+static double window_variance
+(
+    const Var_tables_t *tbl,  /* I: tables holding the plane */
+    int window,          /* I: size of the (square) variance window */
+    int nsamps,          /* I: number of samples in the plane */
+    int line,            /* I: center line of the window */
+    int samp             /* I: center sample of the window */
+)
+{
+    int i;              /* looping variable */
+    int win_line;       /* current line in the window */
+    int half_window = window / 2;     /* half window size */
+    int win_npix = window * window;   /* number of pixels in the window */
+    long pix;           /* current pixel in the window */
     double diff;        /* difference between the current pixel and the
                            average */
+    double sqr_diff;    /* squared difference */
     double avg;         /* average/mean value of the window */
     double sum;         /* sum of values in the window */
+
+    /* Compute the average and then loop back through computing the
+       variance */
+    sum = 0.0;
+    for (win_line = line - half_window; win_line <= line + half_window;
+         win_line++)
+    {
+        pix = (long) win_line * nsamps + samp - half_window;
+        for (i = 0; i < window; i++, pix++)
+            sum += (tbl->band != NULL) ? tbl->band[pix] : tbl->index[pix];
+    }
+    avg = sum / win_npix;
+
+    sum = 0.0;
+    for (win_line = line - half_window; win_line <= line + half_window;
+         win_line++)
+    {
+        pix = (long) win_line * nsamps + samp - half_window;
+        for (i = 0; i < window; i++, pix++)
+        {
+            diff = ((tbl->band != NULL) ? tbl->band[pix] : tbl->index[pix]) -
+                avg;
+            sqr_diff = diff * diff;
+            sum += sqr_diff;
+        }
+    }
+
+    return (sum / (win_npix - 1));
+}
+
+
+/******************************************************************************
+MODULE:  variance_range
+
+PURPOSE:  Slides the window across the running column tables of a plane and
+computes the variance for a range of samples of the current line.
+
+RETURN VALUE:
+Type = None
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+---------     ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+10/15/2026    agent            Match the original two-pass variance to the
+                               last bit
+
+NOTES:
+  1. The window sums are exact, so (N*sumsq - sum*sum) / (N*(N-1)) is the
+     exact sample variance, give or take the two roundings of computing it
+     in double.  The original two-pass calculation is within (N+6) units of
+     roundoff of the exact variance, plus a term for the rounding of the
+     average which only matters for nearly flat windows.  When everything
+     within twice that bound of the computed variance rounds to the same
+     float, that is the float the two-pass calculation gives.  Otherwise
+     (about 0.05% of the windows, mostly exact rounding ties) the variance
+     is computed with the two-pass calculation.
+  2. first_samp and last_samp must be at least half a window from the
+     left/right edges, and the column tables must be current for the
+     columns within half a window of the range.
+  3. Samples whose window contains fill are left untouched (i.e. as fill).
+     The variance of windows containing pixels which aren't in the sums,
+     such as NaN, is computed with the two-pass calculation.
+******************************************************************************/
+static void variance_range
+(
+    const Var_tables_t *tbl,  /* I: running column tables for the plane */
+    int window,          /* I: size of the (square) variance window */
+    int nsamps,          /* I: number of samples in the plane */
+    int line,            /* I: current line of the plane */
+    int first_samp,      /* I: first sample to be computed */
+    int last_samp,       /* I: last sample to be computed */
+    float *var_line      /* O: output variance values for the line */
+)
+{
+    int samp;           /* current sample being processed */
+    int half_window = window / 2;     /* half window size */
+    int win_npix = window * window;   /* number of pixels in the window */
+    int win_fill;       /* number of fill pixels in the current window */
+    int win_other;      /* number of pixels in the current window which
+                           aren't in the sums */
+    long long sum;      /* sum of the scaled values in the window */
+    long long sumsq;    /* sum of the squared values in the window (int16
+                           planes) */
+    __int128 wide_sumsq;  /* sum of the squared scaled values in the window
+                             (float planes) */
     double var;         /* variance of values in the window */
-    double unscaled_arr[SQR_WINDOW];  /* array of unscaled values */
+    double avg;         /* average of values in the window */
+    double margin;      /* bound on the difference between var and the
+                           two-pass variance */
+    double var_denom;   /* N*(N-1) times the square of the scale */
+    double avg_scale;   /* 1 / (N times the scale) */
+    double margin_scale;  /* relative part of the margin */
+    float var_flt;      /* float nearest to the variance */
 
-    /* Fill the variance array will fill values by default, since any window
-       with a fill pixel will not have a variance calculated */
-    for (pix = 0; pix < nlines * nsamps; pix++)
-        variance[pix] = fill_value;
-
-    /* Loop through the lines and samples in the array and compute the
-       variance.  Start at the HALF_WINDOW location, as no variance values
-       will be calculated for windows in the fill areas. */
-    for (line = HALF_WINDOW; line < nlines-HALF_WINDOW; line++)
-    {
-        pix = line * nsamps + HALF_WINDOW;
-        for (samp = HALF_WINDOW; samp < nsamps-HALF_WINDOW; samp++, pix++)
-        {
-            /* Loop through the lines and samps in the window for this pixel
-               and compute the sum */
-            skip_window = false;
-            sum = 0.0;
-            count = 0;
-            for (line_window = -HALF_WINDOW; line_window <= HALF_WINDOW;
-                 line_window++)
+    var_denom = (double) win_npix * (win_npix - 1) * tbl->scale * tbl->scale;
+    avg_scale = 1.0 / (win_npix * tbl->scale);
+    margin_scale = (win_npix + 16) * DBL_EPSILON;
+
+    /* Load the window for the first sample in the range */
+    sum = 0;
+    sumsq = 0;
+    wide_sumsq = 0;
+    win_fill = 0;
+    win_other = 0;
+    for (samp = first_samp - half_window; samp <= first_samp + half_window;
+         samp++)
+    {
+        sum += tbl->col_sum[samp];
+        if (tbl->band != NULL)
+            sumsq += tbl->col_sumsq[samp];
+        else
+            wide_sumsq += tbl->col_wide_sumsq[samp];
+        win_fill += tbl->col_fill[samp];
+        win_other += tbl->col_other[samp];
+    }
+
+    for (samp = first_samp; samp <= last_samp; samp++)
+    {
+        /* Slide the window across one sample */
+        if (samp > first_samp)
+        {
+            sum += tbl->col_sum[samp+half_window] -
+                tbl->col_sum[samp-half_window-1];
+            if (tbl->band != NULL)
+                sumsq += tbl->col_sumsq[samp+half_window] -
+                    tbl->col_sumsq[samp-half_window-1];
+            else
+                wide_sumsq += tbl->col_wide_sumsq[samp+half_window] -
+                    tbl->col_wide_sumsq[samp-half_window-1];
+            win_fill += tbl->col_fill[samp+half_window] -
+                tbl->col_fill[samp-half_window-1];
+            win_other += tbl->col_other[samp+half_window] -
+                tbl->col_other[samp-half_window-1];
+        }
+
+        /* Windows containing fill are left as fill */
+        if (win_fill > 0)
+            continue;
+
+        /* Assign the variance from the sums, if it's sure to be the float
+           the two-pass calculation gives.  A flat window is exactly 0. */
+        if (win_other == 0)
+        {
+            if (tbl->band != NULL)
+                var = (double) (win_npix * sumsq - sum * sum) / var_denom;
+            else
+                var = (double) (win_npix * wide_sumsq - (__int128) sum * sum) /
+                    var_denom;
+            if (var == 0.0)
             {
-                win_pix = (line + line_window) * nsamps + (samp - HALF_WINDOW);
-                for (samp_window = -HALF_WINDOW; samp_window <= HALF_WINDOW;
-                     samp_window++, win_pix++, count++)
-                {
-                    /* If this pixel is fill break out, otherwise add it to
-                       the window average */
-                    if (array[win_pix] == fill_value)
-                    {
-                        skip_window = true;
-                        break;
-                    }
-                    else
-                    {
-                        unscaled_arr[count] = array[win_pix];
-                        sum += unscaled_arr[count];
-                    }
-                }  /* for samp_window */
-
-                /* Should the window be skipped */
-                if (skip_window)
-                    break;
-            }  /* for line_window */
-
-            /* Should the pixel be skipped */
-            if (skip_window)
+                var_line[samp] = 0.0;
+                continue;
+            }
+            avg = sum * avg_scale;
+            margin = margin_scale * var +
+                DBL_EPSILON * DBL_EPSILON * avg * avg;
+            var_flt = (float) (var - margin);
+            if (var_flt == (float) (var + margin))
+            {
+                var_line[samp] = var_flt;
                 continue;
+            }
+        }
+
+        var_line[samp] = (float) window_variance (tbl, window, nsamps, line,
+            samp);
+    }  /* for samp */
+}
+
+
+/******************************************************************************
+MODULE:  variance_lines (static)
+
+PURPOSE:  Computes the window x window variance of several planes at once for
+a range of lines whose windows fit in the input strip.
+
+RETURN VALUE:
+Type = int
+Value          Description
+-----          -----------
+ERROR          Error occurred computing the variances
+SUCCESS        Successful completion
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+---------     ---------------  -------------------------------------
+10/14/2026    agent            Original Development (pulled from
+                               variance_strip)
+10/15/2026    agent            Allocate the integer sum tables
+
+NOTES:
+  1. See variance_strip.  The output planes have already been set to fill,
+     and only the lines calc_first to calc_last are computed.
+  2. The running tables are allocated and loaded for each call, so calls
+     for different ranges of lines are independent and may run at the same
+     time.
+******************************************************************************/
+static int variance_lines
+(
+    int16 **bands,      /* I: array of pointers to the int16 band planes */
+    int nbands,         /* I: number of int16 band planes */
+    float **indices,    /* I: array of pointers to the float index planes */
+    int nindices,       /* I: number of float index planes */
+    int fill_value,     /* I: fill value for the bands and indices */
+    int window,         /* I: size of the (square) variance window */
+    int nsamps,         /* I: number of samples in the planes */
+    int first_line,     /* I: input line of the first output line */
+    int calc_first,     /* I: first input line to be computed */
+    int calc_last,      /* I: last input line to be computed */
+    Span_index_t *spans,  /* I: if not NULL, only compute the variance for
+                                the pixels in these spans (indexed from the
+                                first output line) */
+    float **variances   /* O: array of nbands + nindices pointers to the
+                              output variance planes */
+)
+{
+    char FUNC_NAME[] = "variance_lines";   /* function name */
+    char errmsg[STR_SIZE];    /* error message */
+    int ip;             /* plane looping variable */
+    int nplanes;        /* total number of planes */
+    int line;           /* current input line being processed */
+    int out_line;       /* current output line being processed */
+    int win_line;       /* current line in the window */
+    int samp;           /* current sample being processed */
+    int isp;            /* current span being processed */
+    int first_samp;     /* first sample of the current span to compute */
+    int last_samp;      /* last sample of the current span to compute */
+    int half_window;    /* half window size */
+    long pix;           /* current pixel being processed */
+    const int16 *drop_i16;   /* int16 line dropped from the window */
+    const float *drop_flt;   /* float line dropped from the window */
+    int *col_line = NULL;      /* line for which each column of the tables
+                                  is current (sparse calculations only) */
+    Var_tables_t *tbl = NULL;  /* running column tables for each plane */
+    void *tbl_buf = NULL;      /* memory for all of the column tables */
+    __int128 *wide_buf;        /* sum of squares tables of the float
+                                  planes, at the start of tbl_buf */
+    long long *sum_buf;        /* sum tables of all the planes, then the sum
+                                  of squares tables of the int16 planes */
+    int *count_buf;            /* fill and other count tables of all the
+                                  planes */
+
+    half_window = window / 2;
+    nplanes = nbands + nindices;
 
-            /* Compute the average and then loop back through computing the
-               variance.  No need to check for fill values, since if there
-               are any the code already jumped to the next pixel.  Use the
-               unscaled values stored in the unscaled array. */
-            avg = sum / SQR_WINDOW;
-            sum = 0.0;
-            for (i = 0; i < SQR_WINDOW; i++)
+    /* Allocate the running column tables for each plane in one block */
+    tbl = calloc (nplanes, sizeof (Var_tables_t));
+    tbl_buf = calloc ((size_t) nsamps, nindices * sizeof (__int128) +
+        (nplanes + nbands) * sizeof (long long) + 2 * nplanes * sizeof (int));
+    if (tbl == NULL || tbl_buf == NULL)
+    {
+        free (tbl);
+        free (tbl_buf);
+        strcpy (errmsg, "Error allocating memory for the variance tables.");
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+    wide_buf = tbl_buf;
+    sum_buf = (long long *) (wide_buf + (long) nindices * nsamps);
+    count_buf = (int *) (sum_buf + (long) (nplanes + nbands) * nsamps);
+    for (ip = 0; ip < nplanes; ip++)
+    {
+        tbl[ip].band = (ip < nbands) ? bands[ip] : NULL;
+        tbl[ip].index = (ip < nbands) ? NULL : indices[ip-nbands];
+        tbl[ip].scale = (ip < nbands) ? 1.0 : INDEX_SCALE;
+        tbl[ip].col_sum = sum_buf + (long) ip * nsamps;
+        if (ip < nbands)
+            tbl[ip].col_sumsq = sum_buf + (long) (nplanes + ip) * nsamps;
+        else
+            tbl[ip].col_wide_sumsq = wide_buf + (long) (ip - nbands) * nsamps;
+        tbl[ip].col_fill = count_buf + (long) ip * nsamps;
+        tbl[ip].col_other = count_buf + (long) (nplanes + ip) * nsamps;
+    }
+
+    /* Sparse calculation, only for the pixels in the spans.  Each column of
+       the tables is brought up to date only when a span needs it; columns
+       that were current for the previous line are slid down a line, and
+       any others are rebuilt from the window lines. */
+    if (spans != NULL)
+    {
+        col_line = malloc (nsamps * sizeof (int));
+        if (col_line == NULL)
+        {
+            free (tbl);
+            free (tbl_buf);
+            strcpy (errmsg, "Error allocating memory for the variance "
+                "column status.");
+            error_handler (true, FUNC_NAME, errmsg);
+            return (ERROR);
+        }
+        for (samp = 0; samp < nsamps; samp++)
+            col_line[samp] = -2;
+
+        for (line = calc_first; line <= calc_last; line++)
+        {
+            out_line = line - first_line;
+            for (isp = spans->line_span[out_line];
+                 isp < spans->line_span[out_line+1]; isp++)
             {
-                diff = unscaled_arr[i] - avg;
-                sum += diff * diff;
+                /* Limit the span to the samples whose windows fit */
+                first_samp = spans->span_start[isp];
+                if (first_samp < half_window)
+                    first_samp = half_window;
+                last_samp = spans->span_end[isp];
+                if (last_samp > nsamps - half_window - 1)
+                    last_samp = nsamps - half_window - 1;
+                if (first_samp > last_samp)
+                    continue;
+
+                /* Update the columns covered by the span windows */
+                for (samp = first_samp - half_window;
+                     samp <= last_samp + half_window; samp++)
+                {
+                    if (col_line[samp] == line)
+                        continue;
+                    update_column (bands, nbands, indices, nindices,
+                        fill_value, window, nsamps, line, samp,
+                        col_line[samp] != line - 1, tbl);
+                    col_line[samp] = line;
+                }
+
+                for (ip = 0; ip < nplanes; ip++)
+                    variance_range (&tbl[ip], window, nsamps, line,
+                        first_samp, last_samp,
+                        &variances[ip][(long) out_line * nsamps]);
             }
+        }  /* for line */
+
+        free (col_line);
+        free (tbl);
+        free (tbl_buf);
+        return (SUCCESS);
+    }
+
+    /* Load the column tables with the lines of the window for the first
+       calculated line */
+    for (win_line = calc_first - half_window;
+         win_line <= calc_first + half_window; win_line++)
+    {
+        pix = (long) win_line * nsamps;
+        for (ip = 0; ip < nbands; ip++)
+            update_columns_int16 (&bands[ip][pix], NULL, fill_value, nsamps,
+                &tbl[ip]);
+        for (ip = 0; ip < nindices; ip++)
+            update_columns_float (&indices[ip][pix], NULL, fill_value, nsamps,
+                &tbl[nbands+ip]);
+    }
 
-            /* Assign the variance to the current pixel */
-            var = sum / (SQR_WINDOW - 1);
-            variance[pix] = (float) var;
-        }  /* for samp */
+    /* Loop through the lines, sliding all the planes down one line at a time
+       and computing the variance for each */
+    for (line = calc_first; line <= calc_last; line++)
+    {
+        out_line = line - first_line;
+        if (line > calc_first)
+        {
+            pix = (long) (line + half_window) * nsamps;
+            for (ip = 0; ip < nbands; ip++)
+            {
+                drop_i16 = &bands[ip][pix - (long) window * nsamps];
+                update_columns_int16 (&bands[ip][pix], drop_i16, fill_value,
+                    nsamps, &tbl[ip]);
+            }
+            for (ip = 0; ip < nindices; ip++)
+            {
+                drop_flt = &indices[ip][pix - (long) window * nsamps];
+                update_columns_float (&indices[ip][pix], drop_flt, fill_value,
+                    nsamps, &tbl[nbands+ip]);
+            }
+        }
+
+        for (ip = 0; ip < nplanes; ip++)
+            variance_range (&tbl[ip], window, nsamps, line, half_window,
+                nsamps - half_window - 1,
+                &variances[ip][(long) out_line * nsamps]);
     }  /* for line */
+
+    /* Free the column tables */
+    free (tbl);
+    free (tbl_buf);
+
+    return (SUCCESS);
 }
 
+
+/******************************************************************************
+MODULE:  variance_strip
+
+PURPOSE:  Computes the window x window variance of several planes at once for
+a strip of lines.  The int16 reflectance bands and the floating point spectral
+indices are processed together, one pass over the shared window lines, and
+all the variance planes are output together.
+
+RETURN VALUE:
+Type = int
+Value          Description
+-----          -----------
+ERROR          Error occurred computing the variances
+SUCCESS        Successful completion
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+---------     ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+10/14/2026    agent            Split the lines into chunks which are
+                               computed by separate threads
+10/15/2026    agent            Limit the window to 4095 pixels, so the
+                               integer window sums can't overflow
+
+NOTES:
+  1. Input planes are 1D arrays of size nlines * nsamps.  Output planes are
+     1D arrays of size nout_lines * nsamps and are ordered with the bands
+     first then the indices.
+  2. The input strip should contain half a window of lines above and below
+     the output lines, where the scene has them.  Output lines whose window
+     doesn't fit within the input strip are fill, as are the samples within
+     half a window of the left/right edges.  Thus at the top and bottom of
+     the scene the results match a whole-scene calculation.
+  3. Any window containing a fill value will not have a variance calculated.
+  4. The running tables are loaded fresh for each strip, so strips may be
+     processed in any order.  Within a strip the lines are computed in
+     chunks of PROC_CHUNK_NLINES lines, each with its own tables, and the
+     chunks are divided among the threads.  The chunks don't depend on the
+     number of threads, so neither do the variances.
+  5. If a span index is provided, only the pixels in the spans are computed
+     and all other pixels are left as fill.  This is used to limit the work
+     to the cfmask cloud pixels, which are the only pixels the rule-based
+     models look at.
+******************************************************************************/
+int variance_strip
+(
+    int16 **bands,      /* I: array of pointers to the int16 band planes */
+    int nbands,         /* I: number of int16 band planes */
+    float **indices,    /* I: array of pointers to the float index planes */
+    int nindices,       /* I: number of float index planes */
+    int fill_value,     /* I: fill value for the bands and indices */
+    int window,         /* I: size of the (square) variance window; must be
+                              odd */
+    int nlines,         /* I: number of lines in the input planes */
+    int nsamps,         /* I: number of samples in the planes */
+    int first_line,     /* I: first line in the input planes for which the
+                              variance is to be computed */
+    int nout_lines,     /* I: number of lines of variance to be computed */
+    Span_index_t *spans,  /* I: if not NULL, only compute the variance for
+                                the pixels in these spans (indexed from the
+                                first output line) */
+    float **variances   /* O: array of nbands + nindices pointers to the
+                              output variance planes */
+)
+{
+    char FUNC_NAME[] = "variance_strip";   /* function name */
+    char errmsg[STR_SIZE];    /* error message */
+    int ip;             /* plane looping variable */
+    int nplanes;        /* total number of planes */
+    int half_window;    /* half window size */
+    int first_calc;     /* first input line whose window fits in the strip */
+    int last_calc;      /* last input line whose window fits in the strip */
+    int nchunks;        /* number of chunks of lines to be computed */
+    int ichunk;         /* current chunk being computed */
+    int chunk_first;    /* first input line of the current chunk */
+    int chunk_last;     /* last input line of the current chunk */
+    int nerrors = 0;    /* number of chunks which failed */
+    long pix;           /* current pixel being processed */
+
+    /* Validate the window size and the output lines */
+    if (window < 3 || window % 2 == 0 || window > 4095)
+    {
+        sprintf (errmsg, "Invalid variance window size: %d.  The window must "
+            "be an odd number of 3 to 4095 pixels.", window);
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+    if (first_line < 0 || nout_lines < 0 || first_line + nout_lines > nlines)
+    {
+        sprintf (errmsg, "Invalid output lines %d to %d for an input strip of "
+            "%d lines", first_line, first_line + nout_lines - 1, nlines);
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+    if (spans != NULL && spans->nlines < nout_lines)
+    {
+        sprintf (errmsg, "The span index holds %d lines, but %d output lines "
+            "were requested", spans->nlines, nout_lines);
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+    half_window = window / 2;
+    nplanes = nbands + nindices;
+
+    /* Fill the variance arrays with fill values by default, since any window
+       with a fill pixel will not have a variance calculated */
+    for (ip = 0; ip < nplanes; ip++)
+        for (pix = 0; pix < (long) nout_lines * nsamps; pix++)
+            variances[ip][pix] = fill_value;
+
+    /* Determine which of the output lines have windows that fit in the
+       strip.  If there are none, or the strip is narrower than the window,
+       there is nothing else to be done. */
+    first_calc = first_line;
+    if (first_calc < half_window)
+        first_calc = half_window;
+    last_calc = first_line + nout_lines - 1;
+    if (last_calc > nlines - half_window - 1)
+        last_calc = nlines - half_window - 1;
+    if (first_calc > last_calc || nsamps < window)
+        return (SUCCESS);
+    if (spans != NULL && spans->nspans == 0)
+        return (SUCCESS);
+
+    /* Compute the chunks of lines, split across the threads */
+    nchunks = (last_calc - first_calc) / PROC_CHUNK_NLINES + 1;
+#ifdef _OPENMP
+    #pragma omp parallel for private(chunk_first, chunk_last) \
+        reduction(+:nerrors) schedule(dynamic, 1)
+#endif
+    for (ichunk = 0; ichunk < nchunks; ichunk++)
+    {
+        chunk_first = first_calc + ichunk * PROC_CHUNK_NLINES;
+        chunk_last = chunk_first + PROC_CHUNK_NLINES - 1;
+        if (chunk_last > last_calc)
+            chunk_last = last_calc;
+        if (variance_lines (bands, nbands, indices, nindices, fill_value,
+            window, nsamps, first_line, chunk_first, chunk_last, spans,
+            variances) != SUCCESS)
+            nerrors++;
+    }
+
+    if (nerrors > 0)
+    {
+        sprintf (errmsg, "Error computing the variances for %d of the %d "
+            "chunks of lines", nerrors, nchunks);
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+
+    return (SUCCESS);
+}
+
+
+/******************************************************************************
+MODULE:  variance
+
+PURPOSE:  Computes the variance of the window x window block of pixels
+centered on each pixel in the input array.
+
+RETURN VALUE:
+Type = int
+Value          Description
+-----          -----------
+ERROR          Error occurred computing the variance
+SUCCESS        Successful completion
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+---------     ---------------  -------------------------------------
+5/19/2014     Gail Schmidt     Original Development
+10/14/2026    agent            Replaced the per-pixel window loops with
+                               running column sums so the cost per pixel no
+                               longer depends on the window size; the window
+                               size is now a parameter
+10/14/2026    agent            Now a single-plane wrapper around
+                               variance_strip
+
+NOTES:
+  1. Input and output arrays are 1D arrays of size nlines * nsamps.
+  2. Any window containing a fill value will not have a variance calculated.
+******************************************************************************/
+int variance
+(
+    float *array,       /* I: input array of data for which to compute the
+                              covariances */
+    int fill_value,     /* I: fill value for the band */
+    int window,         /* I: size of the (square) variance window; must be
+                              odd */
+    int nlines,         /* I: number of lines in the data arrays */
+    int nsamps,         /* I: number of samples in the data arrays */
+    float *variance     /* O: output variance array */
+)
+{
+    return (variance_strip (NULL, 0, &array, 1, fill_value, window, nlines,
+        nsamps, 0, nlines, NULL, &variance));
+}
@@ -16,6 +16,10 @@ History:
   Updated on October/2013 by Ron Dilley, USGS/EROS
     - Modified to use espa-common.
     - Modified to require the DEM file to use on the command line.
+  Updated on October/2026 by agent
+    - Added runScaBatch, which processes a list of scenes with a single
+      scene_based_sca --manifest run rather than one run per scene.
+    - Added the --manifest command-line option for a list of scenes.
 
 Usage:
   do_snow_cover.py --help prints the help message
@@ -26,6 +30,7 @@ import os
 import re
 import commands
 import datetime
+import tempfile
 from optparse import OptionParser
 
 from espa_constants import *
@@ -44,9 +49,10 @@ class Sca():
     # Description: runSca will use the parameters passed for the input/output
     # files, logfile, and usebin.  If input/output files are None (i.e. not
     # specified) then the command-line parameters will be parsed for this
-    # information.  The scene-based DEM and snow cover applications are then
-    # executed on the specified input files.  If a log file was specified,
-    # then the output from each application will be logged to that file.
+    # information.  The scene-based snow cover application is then executed
+    # on the specified input files, or on every scene of the --manifest
+    # file in a single run (see runScaBatch).  If a log file was specified,
+    # then the output from the application will be logged to that file.
     #
     # Inputs:
     #   metafile - name of the Landsat metadata file to be processed
@@ -66,9 +72,9 @@ class Sca():
     #     SUCCESS - successful processing
     #
     # Notes:
-    #   1. The script obtains the path of the metadata file and changes
-    #      directory to that path for running the scene-based DEM and SCA
-    #      code.  If the metafile directory is not writable, then this script
+    #   1. The input and output files are relative to the path of the
+    #      metadata file, which is where the snow cover products are written.
+    #      If the metafile directory is not writable, then this script
     #      exits with an error.
     #   2. If the metadata file is not specified and the information is going
     #      to be grabbed from the command line, then it's assumed all the
@@ -78,6 +84,10 @@ class Sca():
     #      The raw binary products will be used for downstream processing,
     #      but only the output HDF-EOS product should be delivered to the
     #      general public.
+    #   4. Each line of the --manifest file names the metadata, TOA
+    #      reflectance, DEM, brightness temperature, and output snow cover
+    #      files of a scene, separated by white space.  Blank lines and lines
+    #      starting with '#' are skipped.
     #######################################################################
     def runSca (self, metafile=None, toa_infile=None, dem=None, \
         btemp_infile=None, sca_outfile=None, logfile=None, usebin=None):
@@ -101,6 +111,9 @@ class Sca():
             parser.add_option ("-s", "--sca_outfile", type="string",
                 dest="sca_outfile",
                 help="name of output snow cover HDF file", metavar="FILE")
+            parser.add_option ("-m", "--manifest", type="string",
+                dest="manifest",
+                help="name of a file listing the metadata, TOA, DEM, brightness temperature, and snow cover files of each scene to process in one run", metavar="FILE")
             parser.add_option ("--usebin", dest="usebin", default=False,
                 action="store_true",
                 help="use BIN environment variable as the location of DEM and SCA apps")
@@ -112,6 +125,13 @@ class Sca():
             usebin = options.usebin          # should $BIN directory be used
             logfile = options.logfile        # name of the log file
 
+            # the manifest replaces the files of a single scene
+            if options.manifest != None:
+                scenes = self.readManifest (options.manifest)
+                if scenes == None:
+                    return ERROR
+                return self.runScaBatch (scenes, logfile, usebin)
+
             # metadata file
             metafile = options.metafile
             if metafile == None:
@@ -143,13 +163,86 @@ class Sca():
             if sca_outfile == None:
                 parser.error ("missing snow cover output file command-line argument");
                 return ERROR
-        
-        # let the world know what we are processing
-        msg = 'SCA processing of Landsat metadata file: %s' % metafile
-        log (msg)
-        
-        # should we expect the DEM and SCA applications to be in the PATH or
-        # in the BIN directory?
+
+        # a single scene is a batch of one
+        return self.runScaBatch ([(metafile, toa_infile, dem, btemp_infile, \
+            sca_outfile)], logfile, usebin)
+
+
+    ########################################################################
+    # Description: readManifest reads the scenes listed in the --manifest
+    # file.
+    #
+    # Inputs:
+    #   manifest - name of the file listing the scenes (see note 4 of runSca)
+    #
+    # Returns:
+    #     None - error reading the manifest
+    #     list of (metafile, toa_infile, dem, btemp_infile, sca_outfile)
+    #         tuples, one for each scene
+    #######################################################################
+    def readManifest (self, manifest):
+        # make sure the manifest exists
+        if not os.path.isfile(manifest):
+            msg = "Error: manifest file does not exist or is not accessible: " + manifest
+            log (msg)
+            return None
+
+        scenes = []
+        mfile = open (manifest, 'r')
+        for (iline, line) in enumerate (mfile):
+            line = line.strip()
+            if line == '' or line.startswith ('#'):
+                continue
+            fields = line.split()
+            if len(fields) != 5:
+                msg = 'Error: line %d of the manifest does not have the metadata, TOA, DEM, brightness temperature, and snow cover files: %s' % (iline + 1, manifest)
+                log (msg)
+                mfile.close()
+                return None
+            scenes.append (tuple (fields))
+        mfile.close()
+
+        if len(scenes) == 0:
+            msg = 'Error: manifest file does not list any scenes: %s' % manifest
+            log (msg)
+            return None
+
+        return scenes
+
+
+    ########################################################################
+    # Description: runScaBatch runs scene_based_sca once, with a --manifest
+    # of all the scenes, rather than once for each scene.  The snow cover
+    # application keeps its threads and buffers from one scene to the next,
+    # so each scene only pays for opening its own files.
+    #
+    # Inputs:
+    #   scenes - list of (metafile, toa_infile, dem, btemp_infile,
+    #       sca_outfile) tuples, one for each scene
+    #   logfile - name of the logfile for logging information; if None then
+    #       the output will be written to stdout
+    #   usebin - this specifies if the SCA exe resides in the $BIN directory;
+    #       if None then the SCA exe is expected to be in the PATH
+    #
+    # Returns:
+    #     ERROR - error running the SCA application for one or more scenes
+    #     SUCCESS - successful processing
+    #
+    # Notes:
+    #   1. The input and output files of each scene are taken relative to the
+    #      path of its metadata file, as they were when the script changed
+    #      to that directory for each scene.  The manifest lists them with
+    #      their full paths.
+    #   2. The manifest separates the files with white space, so file names
+    #      with white space are rejected.
+    #   3. scene_based_sca still processes the rest of the scenes when one
+    #      fails, and then exits with an error.  The error messages in the
+    #      log name the scenes which failed.
+    #######################################################################
+    def runScaBatch (self, scenes, logfile=None, usebin=None):
+        # should we expect the SCA application to be in the PATH or in the
+        # BIN directory?
         if usebin:
             # get the BIN dir environment variable
             bin_dir = os.environ.get('BIN')
@@ -161,49 +254,65 @@ class Sca():
             bin_dir = ""
             msg = 'DEM and SCA executables expected to be in the PATH'
             log (msg)
-        
-        # make sure the metadata file exists
-        if not os.path.isfile(metafile):
-            msg = "Error: metadata file does not exist or is not accessible: " + metafile
-            log (msg)
-            return ERROR
 
-        # use the base metadata filename and not the full path.
-        base_metafile = os.path.basename (metafile)
-        msg = 'Processing metadata file: %s' % base_metafile
-        log (msg)
-        
-        # get the path of the MTL file and change directory to that location
-        # for running this script.  save the current working directory for
-        # return to upon error or when processing is complete.  Note: use
-        # abspath to handle the case when the filepath is just the filename
-        # and doesn't really include a file path (i.e. the current working
-        # directory).
-        mydir = os.getcwd()
-        metadir = os.path.dirname (os.path.abspath (metafile))
-        if not os.access(metadir, os.W_OK):
-            msg = 'Path of metadata file is not writable: %s.  Script needs write access to the metadata directory.' % metadir
+        # check each scene and resolve its files against the path of its
+        # metadata file
+        manifest_lines = []
+        for (metafile, toa_infile, dem, btemp_infile, sca_outfile) in scenes:
+            # let the world know what we are processing
+            msg = 'SCA processing of Landsat metadata file: %s' % metafile
             log (msg)
-            return ERROR
-        msg = 'Changing directories for snow cover processing: %s' % metadir
+
+            # make sure the metadata file exists
+            if not os.path.isfile(metafile):
+                msg = "Error: metadata file does not exist or is not accessible: " + metafile
+                log (msg)
+                return ERROR
+
+            # the outputs are written to the path of the MTL file.  Note: use
+            # abspath to handle the case when the filepath is just the
+            # filename and doesn't really include a file path (i.e. the
+            # current working directory).
+            metadir = os.path.dirname (os.path.abspath (metafile))
+            if not os.access(metadir, os.W_OK):
+                msg = 'Path of metadata file is not writable: %s.  Script needs write access to the metadata directory.' % metadir
+                log (msg)
+                return ERROR
+
+            files = [os.path.join (metadir, f) for f in \
+                (toa_infile, btemp_infile, dem, sca_outfile)]
+            for f in files:
+                if re.search (r'\s', f):
+                    msg = 'Error: file names with white space cannot be listed in the snow cover manifest: %s' % f
+                    log (msg)
+                    return ERROR
+            manifest_lines.append (' '.join (files) + '\n')
+
+        # write the manifest of the scenes for scene_based_sca
+        (fd, manifest) = tempfile.mkstemp (prefix='sca_manifest_', \
+            suffix='.txt')
+        mfile = os.fdopen (fd, 'w')
+        mfile.write ('# TOA, brightness temp, DEM, and snow cover files\n')
+        mfile.writelines (manifest_lines)
+        mfile.close()
+        msg = 'Processing %d scenes with the manifest: %s' % \
+            (len(manifest_lines), manifest)
         log (msg)
-        os.chdir (metadir)
 
-        # run snow cover algorithm, checking the return status of each module.
-        # exit if any errors occur.
-        cmdstr = "%sscene_based_sca --toa=%s --btemp=%s --dem=%s --snow_cover=%s --write_binary --verbose" % (bin_dir, toa_infile, btemp_infile, dem, sca_outfile)
+        # run snow cover algorithm once for all the scenes, checking the
+        # return status.
+        cmdstr = "%sscene_based_sca --manifest=%s --write_binary --verbose" % (bin_dir, manifest)
 #        print 'DEBUG: scene_based_sca command: %s' % cmdstr
         (status, output) = commands.getstatusoutput (cmdstr)
         log (output)
+        os.remove (manifest)
         exit_code = status >> 8
         if exit_code != 0:
             msg = 'Error running scene_based_sca.  Processing will terminate.'
             log (msg)
-            os.chdir (mydir)
             return ERROR
         
-        # successful completion.  return to the original directory.
-        os.chdir (mydir)
+        # successful completion.
         msg = 'Completion of scene based snow cover.'
         log (msg)
 
@@ -0,0 +1,323 @@
+#! /usr/bin/env python
+
+'''
+Created on October 15, 2026 by agent
+
+License:
+  "NASA Open Source Agreement 1.3"
+
+Description:
+  Golden-output regression of scene_based_sca.  A reference scene_based_sca
+  is built from an earlier revision of the tree (or given as an
+  executable), and it and the scene_based_sca under test are run on the
+  fixture scenes.  Every SDS of the reference snow cover product is then
+  compared pixel for pixel with the same SDS of the product under test.
+
+  The scene_based_sca under test may be run with several variants of its
+  optional arguments (threads, memory budget, terrain cache, ...), each of
+  which is compared with the same reference product.
+
+Usage:
+  regress_scene_based_sca.py --help prints the help message
+'''
+
+import sys
+import os
+import array
+import shutil
+import subprocess
+import tempfile
+from optparse import OptionParser
+
+from pyhdf.SD import SD, SDC
+
+# source directory of scene_based_sca in the tree
+SRC_DIR = 'scene_based/src'
+# directory of the modules shared with the other application
+COMMON_DIR = 'common'
+EXE = 'scene_based_sca'
+
+
+############################################################################
+# Description: readFixtures reads the list of fixture scenes.
+#
+# Inputs:
+#   fixtures - name of the fixture list.  Each line names the TOA
+#       reflectance, brightness temperature, and DEM files of a scene,
+#       separated by white space.  Relative names are relative to the
+#       directory of the fixture list.  Blank lines and lines starting with
+#       '#' are skipped.
+#
+# Returns:
+#   list of (toa, btemp, dem) tuples with the full file names
+############################################################################
+def readFixtures (fixtures):
+    fixdir = os.path.dirname (os.path.abspath (fixtures))
+    scenes = []
+    ffile = open (fixtures, 'r')
+    for (iline, line) in enumerate (ffile):
+        line = line.strip()
+        if line == '' or line.startswith ('#'):
+            continue
+        fields = line.split()
+        if len(fields) != 3:
+            ffile.close()
+            raise ValueError ('Line %d of %s does not have the TOA, brightness temperature, and DEM files' % (iline + 1, fixtures))
+        scenes.append (tuple ([os.path.join (fixdir, f) for f in fields]))
+    ffile.close()
+
+    if len(scenes) == 0:
+        raise ValueError ('No fixture scenes are listed in %s' % fixtures)
+    return scenes
+
+
+############################################################################
+# Description: buildReference builds scene_based_sca from the specified
+# revision of the tree.
+#
+# Inputs:
+#   ref_rev - git revision of the reference
+#   work_dir - directory for the reference tree
+#   make_args - list of the variable assignments for make, such as the
+#       include and library directories
+#
+# Returns:
+#   name of the reference executable
+#
+# Notes:
+#   1. The revision is extracted with git archive rather than checked out,
+#      so the working tree is left alone.  The modules shared by the
+#      applications are extracted too, if the revision has them.  make is
+#      run in the extracted tree with make_args, which give the HDF and
+#      HDF-EOS include and library directories.
+############################################################################
+def buildReference (ref_rev, work_dir, make_args):
+    top = subprocess.check_output (['git', 'rev-parse', '--show-toplevel'],
+        cwd=os.path.dirname (os.path.abspath (__file__)))
+    top = top.decode().strip()
+    ref_tree = os.path.join (work_dir, 'ref_tree')
+    os.mkdir (ref_tree)
+
+    print ('Building the reference %s from %s' % (EXE, ref_rev))
+    paths = [os.path.dirname (SRC_DIR)]
+    if subprocess.call (['git', 'cat-file', '-e', '%s:%s' % (ref_rev,
+        COMMON_DIR)], cwd=top, stderr=open (os.devnull, 'w')) == 0:
+        paths.append (COMMON_DIR)
+    archive = subprocess.Popen (['git', 'archive', '--format=tar', ref_rev]
+        + paths, cwd=top, stdout=subprocess.PIPE)
+    subprocess.check_call (['tar', '-xf', '-'], cwd=ref_tree,
+        stdin=archive.stdout)
+    archive.stdout.close()
+    if archive.wait() != 0:
+        raise RuntimeError ('Error extracting revision %s' % ref_rev)
+    subprocess.check_call (['make', EXE] + make_args,
+        cwd=os.path.join (ref_tree, SRC_DIR))
+
+    ref_exe = os.path.join (work_dir, EXE + '_ref')
+    shutil.copy (os.path.join (ref_tree, SRC_DIR, EXE), ref_exe)
+    shutil.rmtree (ref_tree)
+    return ref_exe
+
+
+############################################################################
+# Description: runScenes runs scene_based_sca on each of the fixture
+# scenes.
+#
+# Inputs:
+#   exe - scene_based_sca executable
+#   args - list of additional arguments
+#   scenes - list of (toa, btemp, dem) tuples
+#   run_dir - directory for the outputs of this run
+#
+# Returns:
+#   list of the output snow cover files, one for each scene
+############################################################################
+def runScenes (exe, args, scenes, run_dir):
+    outfiles = []
+    for (iscene, (toa, btemp, dem)) in enumerate (scenes):
+        scene_dir = os.path.join (run_dir, 'scene%d' % iscene)
+        os.makedirs (scene_dir)
+        outfile = os.path.join (scene_dir, 'snow_cover.hdf')
+        cmd = [exe, '--toa=%s' % toa, '--btemp=%s' % btemp, '--dem=%s' % dem,
+            '--snow_cover=%s' % outfile] + args
+        log = open (os.path.join (scene_dir, 'log.txt'), 'w')
+        status = subprocess.call (cmd, cwd=scene_dir, stdout=log,
+            stderr=subprocess.STDOUT)
+        log.close()
+        if status != 0:
+            raise RuntimeError ('Error running %s on %s; see %s' % (' '.join (cmd), toa, os.path.join (scene_dir, 'log.txt')))
+        outfiles.append (outfile)
+    return outfiles
+
+
+############################################################################
+# Description: readSds reads every SDS of an HDF file.
+#
+# Inputs:
+#   hdf_file - name of the HDF file
+#
+# Returns:
+#   dictionary of (bytes, typecode, nlines, nsamps) tuples, keyed by the
+#   SDS name.  The samples are the last dimension of the SDS, and the lines
+#   are the rest of its dimensions.
+############################################################################
+def readSds (hdf_file):
+    sd = SD (hdf_file, SDC.READ)
+    sds = {}
+    for name in sd.datasets().keys():
+        sds_id = sd.select (name)
+        data = sds_id.get()
+        sds_id.endaccess()
+        nsamps = data.shape[-1]
+        sds[name] = (data.tobytes(), data.dtype.char, data.size // nsamps,
+            nsamps)
+    sd.end()
+    return sds
+
+
+############################################################################
+# Description: compareBytes compares two rasters pixel for pixel.  The raw
+# bytes are compared, so floats are compared bit for bit and any change to
+# an exact-match kernel is reported.
+#
+# Inputs:
+#   ref - bytes of the reference raster
+#   test - bytes of the raster under test
+#   typecode - array typecode of the pixels
+#   nlines - number of lines in the rasters
+#   nsamps - number of samples in the rasters
+#
+# Returns:
+#   None if the rasters match, otherwise a message describing the
+#   differences
+#
+# Notes:
+#   1. Whole lines are compared first, and only the lines which differ are
+#      compared pixel by pixel.
+############################################################################
+def compareBytes (ref, test, typecode, nlines, nsamps):
+    if len(ref) != len(test):
+        return '%d bytes vs %d bytes' % (len(ref), len(test))
+    if ref == test:
+        return None
+
+    size = array.array (typecode).itemsize
+    line_size = nsamps * size
+    ndiff = 0
+    maxdiff = 0.0
+    first = None
+    for line in range(nlines):
+        ref_line = ref[line * line_size:(line + 1) * line_size]
+        test_line = test[line * line_size:(line + 1) * line_size]
+        if ref_line == test_line:
+            continue
+        ref_pix = array.array (typecode, ref_line)
+        test_pix = array.array (typecode, test_line)
+        for samp in range(nsamps):
+            if ref_line[samp * size:(samp + 1) * size] == \
+                test_line[samp * size:(samp + 1) * size]:
+                continue
+            ndiff += 1
+            maxdiff = max (maxdiff, abs (float (ref_pix[samp]) -
+                float (test_pix[samp])))
+            if first == None:
+                first = (line, samp, ref_pix[samp], test_pix[samp])
+
+    return '%d of %d pixels differ, max abs diff %g, first at line %d sample %d (%s vs %s)' % ((ndiff, nlines * nsamps, maxdiff) + first)
+
+
+def main ():
+    parser = OptionParser (usage='%prog --fixtures=FILE --exe=FILE (--ref_rev=REV | --ref_exe=FILE) [--variant=ARGS ...]')
+    parser.add_option ('--fixtures', type='string', dest='fixtures',
+        help='list of the TOA, brightness temperature, and DEM files of each fixture scene', metavar='FILE')
+    parser.add_option ('--exe', type='string', dest='exe',
+        help='scene_based_sca under test', metavar='FILE')
+    parser.add_option ('--ref_exe', type='string', dest='ref_exe',
+        help='reference scene_based_sca', metavar='FILE')
+    parser.add_option ('--ref_rev', type='string', dest='ref_rev',
+        help='git revision to build the reference scene_based_sca from',
+        metavar='REV')
+    parser.add_option ('--ref_make_args', type='string',
+        dest='ref_make_args', default='',
+        help='variable assignments for make when building the reference from ref_rev, such as the include and library directories it needs')
+    parser.add_option ('--ref_args', type='string', dest='ref_args',
+        default='', help='additional arguments for the reference run')
+    parser.add_option ('--variant', type='string', dest='variants',
+        action='append',
+        help='additional arguments for a run under test; may be repeated, and {work} is replaced with the work directory (default is one run with no additional arguments)')
+    parser.add_option ('--work_dir', type='string', dest='work_dir',
+        help='directory for the outputs, which is kept (default is a temporary directory, which is removed)', metavar='DIR')
+    (options, args) = parser.parse_args()
+
+    if not options.fixtures:
+        parser.error ('missing fixtures command-line argument')
+    if options.exe == None:
+        parser.error ('missing exe command-line argument')
+    if (options.ref_exe == None) == (options.ref_rev == None):
+        parser.error ('specify one of the ref_exe and ref_rev command-line arguments')
+    variants = options.variants
+    if variants == None:
+        variants = ['']
+
+    scenes = readFixtures (options.fixtures)
+    if options.work_dir:
+        work_dir = os.path.abspath (options.work_dir)
+        os.makedirs (work_dir)
+    else:
+        work_dir = tempfile.mkdtemp (prefix='regress_sca_')
+
+    exe = os.path.abspath (options.exe)
+    if options.ref_exe:
+        ref_exe = os.path.abspath (options.ref_exe)
+    else:
+        ref_exe = buildReference (options.ref_rev, work_dir,
+            options.ref_make_args.split())
+
+    # run the reference and keep its products in memory, since each
+    # variant is compared with them
+    print ('Running the reference on %d scenes' % len(scenes))
+    ref_files = runScenes (ref_exe, options.ref_args.split(), scenes,
+        os.path.join (work_dir, 'ref'))
+    ref_sds = [readSds (f) for f in ref_files]
+
+    nfailed = 0
+    for (ivar, variant) in enumerate (variants):
+        variant = variant.replace ('{work}', work_dir)
+        print ('Variant %d: %s %s' % (ivar, EXE, variant))
+        test_files = runScenes (exe, variant.split(), scenes,
+            os.path.join (work_dir, 'variant%d' % ivar))
+        for (iscene, test_file) in enumerate (test_files):
+            test_sds = readSds (test_file)
+            for name in sorted (ref_sds[iscene].keys()):
+                if name not in test_sds:
+                    msg = 'missing'
+                else:
+                    (ref, typecode, nlines, nsamps) = ref_sds[iscene][name]
+                    if test_sds[name][1:] != (typecode, nlines, nsamps):
+                        msg = 'type/shape %s vs %s' % (
+                            (typecode, nlines, nsamps), test_sds[name][1:])
+                    else:
+                        msg = compareBytes (ref, test_sds[name][0],
+                            typecode, nlines, nsamps)
+                if msg == None:
+                    print ('  scene %d %-24s identical' % (iscene, name))
+                else:
+                    print ('  scene %d %-24s DIFFERS: %s' % (iscene, name,
+                        msg))
+                    nfailed += 1
+            for name in sorted (test_sds.keys()):
+                if name not in ref_sds[iscene]:
+                    print ('  scene %d %-24s not in the reference' %
+                        (iscene, name))
+
+    if options.work_dir == None:
+        shutil.rmtree (work_dir)
+
+    if nfailed > 0:
+        print ('%d SDS differ from the reference' % nfailed)
+        return 1
+    print ('All SDS match the reference')
+    return 0
+
+if __name__ == "__main__":
+    sys.exit (main ())
@@ -0,0 +1,1038 @@
+#include <getopt.h>
+#include "sca.h"
+
+/* Default size of the synthetic scene, about the size of a Landsat scene */
+#define BENCH_NLINES 7000
+#define BENCH_NSAMPS 8000
+
+/* Default size of the blocks of pixels which share a surface class, so the
+   clouds, snow, and fill form patches like they do in a real scene */
+#define BENCH_BLOCK 32
+
+/* Fill values and scale factors of the synthetic bands, which match the
+   LEDAPS TOA reflectance and brightness temperature products */
+#define BENCH_REFL_FILL -9999
+#define BENCH_BTEMP_FILL -9999
+#define BENCH_REFL_SCALE 0.0001
+#define BENCH_BTEMP_SCALE 0.1
+#define BENCH_REFL_SATU 20000
+
+/* Maximum number of edge case pixels in the snow cover classifier check */
+#define CHECK_MAX_EDGE 65536
+
+/* Thresholds of the snow cover tree on the scaled band values, as the
+   band (0-5 for bands 1-5 and 7, 6 for band 6) and threshold */
+typedef struct {
+    int band;             /* band tested against the threshold */
+    double thresh;        /* threshold on the scaled band value */
+} Check_thresh_t;
+static Check_thresh_t check_band_thresh[] = {{0, 0.11}, {0, 0.3},
+    {0, 0.34}, {0, 0.35}, {2, 0.35}, {2, 0.042}, {2, 0.0432}, {3, 0.11},
+    {3, 0.32}, {4, 0.072}, {4, 0.1}, {5, 0.14}, {5, 0.22}, {5, 0.11},
+    {6, 24.85}, {6, 18.85}};
+
+/* Thresholds of the snow cover tree on the NDSI and NDVI, and 0 where the
+   percentages are clipped */
+static double check_ndsi_thresh[] = {0.0, 0.15, 0.21, 0.25, 0.57};
+static double check_ndvi_thresh[] = {0.0, 0.18, 0.19};
+
+/* Names of the snow cover classifier outputs, as used in the report */
+#define CHECK_NOUT 5
+static char *check_out_names[CHECK_NOUT] = {"snow_mask",
+    "probability_score", "tree_node", "ndsi", "ndvi"};
+
+/* Kernels which are benchmarked */
+typedef enum {BK_QA_CLOUD=0, BK_CLOUD_CLASS, BK_SNOW_TREE, BK_DEEP_SHADOW,
+    BK_COMBINE, BK_POST_PROCESS, BK_SNOW_COUNT, BK_NUM} Bench_kernel_t;
+
+/* Names of the kernels, as used in the report and the baseline files */
+static char *bench_names[BK_NUM] = {"qa_cloud_mask", "cloud_cover_class",
+    "snow_cover_class", "deep_shadow", "combine_qa_mask",
+    "post_process_snow_cover_class", "count_adjacent_snow_cover"};
+
+/* Approximate number of bytes read and written for each pixel by each
+   kernel, used for the GB/s rates */
+static double bench_bytes[BK_NUM] = {17.125, 11.0, 20.0, 4.0, 1.25, 3.0,
+    1.25};
+
+/* Surface classes of the synthetic pixels */
+typedef enum {BC_CLEAR=0, BC_CLOUD, BC_SNOW, BC_FILL} Bench_class_t;
+
+/* Typical values of bands 1-5 and 7 (TOA reflectance * 10000) and band 6
+   (brightness temp in degrees C * 10) for each of the surface classes */
+static int bench_values[BC_FILL][NBAND_REFL_MAX+1] = {
+    {800, 900, 1000, 2500, 2000, 1200, 150},    /* clear vegetation/soil */
+    {4500, 4300, 4200, 4500, 2500, 1800, -250}, /* cloud */
+    {7000, 6800, 6500, 6000, 600, 400, -80}};   /* snow */
+
+/******************************************************************************
+MODULE:  bench_rand (static)
+
+PURPOSE:  Returns a pseudo-random number for the position and seed, so the
+synthetic scene is the same each time it's generated.
+
+RETURN VALUE:
+Type = unsigned int
+Value      Description
+-----      -----------
+n          Pseudo-random number
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+******************************************************************************/
+static unsigned int bench_rand
+(
+    unsigned int seed,    /* I: seed for the scene */
+    unsigned int x,       /* I: first coordinate */
+    unsigned int y        /* I: second coordinate */
+)
+{
+    unsigned int h;       /* hashed value */
+
+    h = seed ^ (x * 0x9E3779B1u) ^ (y * 0x85EBCA77u);
+    h ^= h >> 15;
+    h *= 0x2C1B3C6Du;
+    h ^= h >> 12;
+    h *= 0x297A2D39u;
+    h ^= h >> 15;
+    return (h);
+}
+
+
+/******************************************************************************
+MODULE:  make_bench_strip (static)
+
+PURPOSE:  Generates the synthetic bands and DEM for a strip of the scene.
+
+RETURN VALUE:
+Type = None
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. The surface class is picked for each block of block x block pixels
+     using the cloud, snow, and fill fractions, and noise is added to each
+     pixel.
+  2. The DEM holds one extra line above and below the strip, as needed by
+     deep_shadow.
+******************************************************************************/
+static void make_bench_strip
+(
+    int first_line,       /* I: first line of the strip in the scene */
+    int nlines,           /* I: number of lines in the strip */
+    int nsamps,           /* I: number of samples in each line */
+    int block,            /* I: size of the surface class blocks */
+    float cloud_frac,     /* I: fraction of cloud pixels */
+    float snow_frac,      /* I: fraction of snow pixels */
+    float fill_frac,      /* I: fraction of fill pixels */
+    unsigned int seed,    /* I: seed for the scene */
+    int16 **bands,        /* O: bands 1-5 and 7, then band 6 */
+    int16 *dem            /* O: DEM for the strip, nlines+2 lines */
+)
+{
+    int line;             /* line in the scene */
+    int samp;             /* current sample */
+    int ib;               /* looping variable for the bands */
+    long pix;             /* current pixel in the strip */
+    float r;              /* random value between 0 and 1 */
+    Bench_class_t class;  /* surface class of the current block */
+
+    for (line = first_line; line < first_line + nlines; line++)
+    {
+        for (samp = 0; samp < nsamps; samp++)
+        {
+            pix = (long) (line - first_line) * nsamps + samp;
+            r = (bench_rand (seed, samp / block, line / block) & 0xffff) /
+                65536.0;
+            if (r < fill_frac)
+                class = BC_FILL;
+            else if (r < fill_frac + cloud_frac)
+                class = BC_CLOUD;
+            else if (r < fill_frac + cloud_frac + snow_frac)
+                class = BC_SNOW;
+            else
+                class = BC_CLEAR;
+
+            for (ib = 0; ib <= NBAND_REFL_MAX; ib++)
+            {
+                if (class == BC_FILL)
+                    bands[ib][pix] = (ib == NBAND_REFL_MAX) ?
+                        BENCH_BTEMP_FILL : BENCH_REFL_FILL;
+                else
+                    bands[ib][pix] = bench_values[class][ib] +
+                        (int) (bench_rand (seed + ib + 1, samp, line) % 401)
+                        - 200;
+            }
+        }
+    }
+
+    for (line = first_line - 1; line <= first_line + nlines; line++)
+    {
+        for (samp = 0; samp < nsamps; samp++)
+        {
+            pix = (long) (line - first_line + 1) * nsamps + samp;
+            dem[pix] = (int16) (2000.0 + 800.0 * sin (samp / 300.0) *
+                cos (line / 250.0) + 150.0 * sin (samp / 37.0 + line / 53.0) +
+                bench_rand (seed, samp, line) % 5);
+        }
+    }
+}
+
+
+/******************************************************************************
+MODULE:  set_check_pixel (static)
+
+PURPOSE:  Sets the bands of a pixel for the snow cover classifier check to
+random values, either over the whole int16 range or over the range of the
+TOA reflectance and brightness temperature products.
+
+RETURN VALUE:
+Type = None
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/15/2026    agent            Original Development
+
+NOTES:
+  1. A quarter of the pixels get values over the whole int16 range.  The
+     rest get values which usually pass the water and thermal tests, so
+     the pixels reach the leaves of the tree.
+******************************************************************************/
+static void set_check_pixel
+(
+    unsigned int seed,    /* I: seed for the pixel values */
+    long id,              /* I: pixel number, for the random values */
+    int16 **bands,        /* O: bands 1-5 and 7, then band 6 */
+    long pix              /* I: pixel to be set in the bands */
+)
+{
+    int ib;               /* looping variable for the bands */
+    unsigned int r;       /* random value for the current band */
+    bool full_range;      /* use the whole int16 range? */
+
+    full_range = (bench_rand (seed, (unsigned int) id, 0) & 3) == 0;
+    for (ib = 0; ib <= NBAND_REFL_MAX; ib++)
+    {
+        r = bench_rand (seed + ib + 1, (unsigned int) id, 1);
+        if (full_range)
+            bands[ib][pix] = (int16) (r & 0xffff);
+        else if (ib == NBAND_REFL_MAX)
+            bands[ib][pix] = (int16) (r % 801) - 400;
+        else
+            bands[ib][pix] = (int16) (r % 12001);
+    }
+}
+
+
+/******************************************************************************
+MODULE:  make_check_edges (static)
+
+PURPOSE:  Generates the edge case pixels for the snow cover classifier check.
+
+RETURN VALUE:
+Type = long
+Value      Description
+-----      -----------
+npix       Number of edge case pixels
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/15/2026    agent            Original Development
+
+NOTES:
+  1. The edge cases are saturated and fill pixels, 0/0 and x/0 NDSI and
+     NDVI, the int16 limits, and band values, NDSI, and NDVI from 3 steps
+     below to 3 steps above each threshold of the tree.  The bands which
+     aren't part of a case get random values (see set_check_pixel).
+  2. The reflective QA mask is off for all of the pixels except a copy of
+     the fill pixels, so the classifier runs on the edge cases.
+******************************************************************************/
+static long make_check_edges
+(
+    unsigned int seed,    /* I: seed for the random band values */
+    int16 **bands,        /* O: bands 1-5 and 7, then band 6, of at least
+                                CHECK_MAX_EDGE pixels */
+    uint8 *refl_qa_mask   /* O: reflective QA mask for the pixels */
+)
+{
+    long npix = 0;        /* number of edge case pixels */
+    int it;               /* looping variable for the thresholds */
+    int d;                /* step from the threshold */
+    int k;                /* looping variable for the base pixels */
+    int ib;               /* looping variable for the bands */
+    int nband_thresh;     /* number of band thresholds */
+    double scale;         /* scale factor for the band of a threshold */
+    double t;             /* NDSI or NDVI threshold */
+    int16 low;            /* band 5 or band 3 value for the index case */
+    static int16 index_low[] = {1, 7, 100, 500, 1000, 1234, 2500, 3333,
+        5000, 9999};      /* values of the second band of the index cases */
+    static int16 limits[] = {-32768, -9999, -1, 0, 1, 20000, 32767};
+                          /* int16 limits, fill, and saturation */
+
+#define CHECK_NEXT_PIXEL \
+    set_check_pixel (seed, npix, bands, npix); \
+    refl_qa_mask[npix] = 0;
+
+    /* Band values around the thresholds of the tree */
+    nband_thresh = sizeof (check_band_thresh) / sizeof (Check_thresh_t);
+    for (it = 0; it < nband_thresh; it++)
+    {
+        scale = (check_band_thresh[it].band == NBAND_REFL_MAX) ?
+            BENCH_BTEMP_SCALE : BENCH_REFL_SCALE;
+        for (k = 0; k < 16; k++)
+        {
+            for (d = -3; d <= 3; d++)
+            {
+                CHECK_NEXT_PIXEL
+                bands[check_band_thresh[it].band][npix] = (int16) (lround (
+                    check_band_thresh[it].thresh / scale) + d);
+                npix++;
+            }
+        }
+    }
+
+    /* NDSI and NDVI values around the thresholds of the tree.  Band 4 and
+       band 6 are set so the pixels pass the water and thermal tests. */
+    for (it = 0; it < (int) (sizeof (check_ndsi_thresh) / sizeof (double));
+        it++)
+    {
+        t = check_ndsi_thresh[it];
+        for (k = 0; k < (int) (sizeof (index_low) / sizeof (int16)); k++)
+        {
+            low = index_low[k];
+            for (d = -3; d <= 3; d++)
+            {
+                CHECK_NEXT_PIXEL
+                bands[4][npix] = low;
+                bands[1][npix] = (int16) (lround (low * (1.0 + t) /
+                    (1.0 - t)) + d);
+                bands[3][npix] = 1100 + bands[3][npix] % 8000;
+                bands[6][npix] = -100;
+                npix++;
+            }
+        }
+    }
+    for (it = 0; it < (int) (sizeof (check_ndvi_thresh) / sizeof (double));
+        it++)
+    {
+        t = check_ndvi_thresh[it];
+        for (k = 0; k < (int) (sizeof (index_low) / sizeof (int16)); k++)
+        {
+            low = index_low[k] + 1100;
+            for (d = -3; d <= 3; d++)
+            {
+                CHECK_NEXT_PIXEL
+                bands[2][npix] = low;
+                bands[3][npix] = (int16) (lround (low * (1.0 + t) /
+                    (1.0 - t)) + d);
+                bands[6][npix] = -100;
+                npix++;
+            }
+        }
+    }
+
+    for (k = 0; k < 64; k++)
+    {
+        /* Band 1 saturated, which saturates all the reflective bands, and
+           another band saturated with band 1 not */
+        CHECK_NEXT_PIXEL
+        bands[0][npix++] = BENCH_REFL_SATU;
+        CHECK_NEXT_PIXEL
+        bands[1 + k % (NBAND_REFL_MAX - 1)][npix++] = BENCH_REFL_SATU;
+
+        /* 0/0 and x/0 NDSI and NDVI */
+        CHECK_NEXT_PIXEL
+        bands[1][npix] = bands[4][npix] = 0;
+        npix++;
+        CHECK_NEXT_PIXEL
+        bands[2][npix] = bands[3][npix] = 0;
+        npix++;
+        CHECK_NEXT_PIXEL
+        bands[1][npix] = bands[2][npix] = bands[3][npix] = bands[4][npix] = 0;
+        npix++;
+        CHECK_NEXT_PIXEL
+        bands[3][npix] = 1100 + k * 100;
+        bands[1][npix] = (int16) (k * 37);
+        bands[4][npix] = (int16) (-k * 37);
+        bands[6][npix] = -100;
+        npix++;
+        CHECK_NEXT_PIXEL
+        bands[3][npix] = 1100 + k * 100;
+        bands[2][npix] = (int16) (-bands[3][npix]);
+        bands[6][npix] = -100;
+        npix++;
+
+        /* One band at the int16 limits, fill, or saturation */
+        CHECK_NEXT_PIXEL
+        bands[k % (NBAND_REFL_MAX + 1)][npix] =
+            limits[k % (sizeof (limits) / sizeof (int16))];
+        npix++;
+    }
+
+    /* Fill pixels, with the QA mask off and on */
+    for (k = 0; k < 32; k++)
+    {
+        for (ib = 0; ib <= NBAND_REFL_MAX; ib++)
+        {
+            bands[ib][npix] = (ib == NBAND_REFL_MAX) ? BENCH_BTEMP_FILL :
+                BENCH_REFL_FILL;
+            bands[ib][npix+1] = bands[ib][npix];
+        }
+        refl_qa_mask[npix] = 0;
+        refl_qa_mask[npix+1] = 1;
+        npix += 2;
+    }
+#undef CHECK_NEXT_PIXEL
+
+    return (npix);
+}
+
+
+/******************************************************************************
+MODULE:  compare_snow_cover_class (static)
+
+PURPOSE:  Runs the snow cover classifier with the AVX2 kernel and with the
+scalar kernel on the same pixels, and reports the outputs which differ.
+
+RETURN VALUE:
+Type = long
+Value      Description
+-----      -----------
+ndiff      Number of pixels with an output which differs
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/15/2026    agent            Original Development
+
+NOTES:
+  1. The first few differences are printed with the band values of the
+     pixel.
+******************************************************************************/
+static long compare_snow_cover_class
+(
+    char *label,          /* I: label of the pixels for the report */
+    int16 **bands,        /* I: bands 1-5 and 7, then band 6 */
+    uint8 *refl_qa_mask,  /* I: reflective QA mask */
+    int npix,             /* I: number of pixels */
+    uint8 **avx2_out,     /* O: outputs of the AVX2 classifier (work
+                                space of CHECK_NOUT arrays of npix) */
+    uint8 **scalar_out,   /* O: outputs of the scalar classifier (work
+                                space of CHECK_NOUT arrays of npix) */
+    long ndiff_out[CHECK_NOUT]  /* I/O: number of differences for each
+                                        output, added to */
+)
+{
+    int pix;              /* current pixel */
+    int io;               /* looping variable for the outputs */
+    int ib;               /* looping variable for the bands */
+    long ndiff = 0;       /* number of pixels which differ */
+    bool differs;         /* does the current pixel differ? */
+    static int nprinted = 0;  /* number of differences printed */
+
+    set_snow_class_avx2 (true);
+    snow_cover_class (bands[0], bands[1], bands[2], bands[3], bands[4],
+        bands[6], bands[5], 1, npix, NULL, BENCH_REFL_SCALE,
+        BENCH_BTEMP_SCALE, BENCH_REFL_SATU, refl_qa_mask, avx2_out[0],
+        avx2_out[1], avx2_out[2], avx2_out[3], avx2_out[4]);
+    set_snow_class_avx2 (false);
+    snow_cover_class (bands[0], bands[1], bands[2], bands[3], bands[4],
+        bands[6], bands[5], 1, npix, NULL, BENCH_REFL_SCALE,
+        BENCH_BTEMP_SCALE, BENCH_REFL_SATU, refl_qa_mask, scalar_out[0],
+        scalar_out[1], scalar_out[2], scalar_out[3], scalar_out[4]);
+    set_snow_class_avx2 (true);
+
+    for (pix = 0; pix < npix; pix++)
+    {
+        differs = false;
+        for (io = 0; io < CHECK_NOUT; io++)
+        {
+            if (avx2_out[io][pix] != scalar_out[io][pix])
+            {
+                ndiff_out[io]++;
+                differs = true;
+            }
+        }
+        if (!differs)
+            continue;
+
+        ndiff++;
+        if (nprinted++ < 10)
+        {
+            printf ("  %s pixel %d: bands", label, pix);
+            for (ib = 0; ib <= NBAND_REFL_MAX; ib++)
+                printf (" %d", bands[ib][pix]);
+            printf (", qa %d; avx2/scalar", refl_qa_mask[pix]);
+            for (io = 0; io < CHECK_NOUT; io++)
+                printf (" %s %d/%d", check_out_names[io], avx2_out[io][pix],
+                    scalar_out[io][pix]);
+            printf ("\n");
+        }
+    }
+
+    return (ndiff);
+}
+
+
+/******************************************************************************
+MODULE:  check_snow_cover_class (static)
+
+PURPOSE:  Checks that the AVX2 snow cover classifier gives the same outputs
+as the scalar classifier, on random pixels and on edge cases.
+
+RETURN VALUE:
+Type = int
+Value      Description
+-----      -----------
+ERROR      An output differs, or memory couldn't be allocated
+SUCCESS    All of the outputs are identical
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/15/2026    agent            Original Development
+
+NOTES:
+  1. The random pixels are nlines lines of nsamps pixels (see
+     set_check_pixel), and the edge cases are one more line (see
+     make_check_edges).  Each line is classified on its own, so the
+     samples which aren't a multiple of 8 exercise the scalar tail of the
+     AVX2 classifier too.
+  2. If the processor doesn't support AVX2, both runs use the scalar
+     classifier, so a warning is printed.
+******************************************************************************/
+static int check_snow_cover_class
+(
+    int nlines,           /* I: number of lines of random pixels */
+    int nsamps,           /* I: number of random pixels in each line */
+    unsigned int seed     /* I: seed for the pixel values */
+)
+{
+    char FUNC_NAME[] = "check_snow_cover_class";  /* function name */
+    char errmsg[STR_SIZE];    /* error message */
+    int line;             /* current line of random pixels */
+    int samp;             /* current sample */
+    int ib;               /* looping variable for the bands */
+    int io;               /* looping variable for the outputs */
+    int nalloc;           /* number of pixels in the buffers */
+    long nedge;           /* number of edge case pixels */
+    long ndiff_random = 0;    /* random pixels which differ */
+    long ndiff_edge;      /* edge case pixels which differ */
+    long ndiff_out[CHECK_NOUT] = {0};  /* differences for each output */
+    int16 *bands[NBAND_REFL_MAX+1];  /* bands 1-5 and 7, then band 6 */
+    uint8 *refl_qa_mask = NULL;   /* reflective QA mask */
+    uint8 *avx2_out[CHECK_NOUT];  /* outputs of the AVX2 classifier */
+    uint8 *scalar_out[CHECK_NOUT];  /* outputs of the scalar classifier */
+    bool ok = true;       /* were the buffers allocated? */
+
+    nalloc = (nsamps > CHECK_MAX_EDGE) ? nsamps : CHECK_MAX_EDGE;
+    for (ib = 0; ib <= NBAND_REFL_MAX; ib++)
+        if ((bands[ib] = calloc (nalloc, sizeof (int16))) == NULL)
+            ok = false;
+    for (io = 0; io < CHECK_NOUT; io++)
+    {
+        avx2_out[io] = calloc (nalloc, sizeof (uint8));
+        scalar_out[io] = calloc (nalloc, sizeof (uint8));
+        if (avx2_out[io] == NULL || scalar_out[io] == NULL)
+            ok = false;
+    }
+    refl_qa_mask = calloc (nalloc, sizeof (uint8));
+    if (!ok || refl_qa_mask == NULL)
+    {
+        sprintf (errmsg, "Error allocating memory for the check buffers");
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+
+    printf ("Checking the AVX2 snow cover classifier against the scalar "
+        "classifier on %d x %d random pixels and the edge cases\n", nlines,
+        nsamps);
+    if (!set_snow_class_avx2 (true))
+    {
+        sprintf (errmsg, "AVX2 isn't available, so the scalar classifier "
+            "is only compared with itself");
+        error_handler (false, FUNC_NAME, errmsg);
+    }
+
+    /* Random pixels, with the QA mask on for some of them */
+    for (line = 0; line < nlines; line++)
+    {
+        for (samp = 0; samp < nsamps; samp++)
+        {
+            set_check_pixel (seed, (long) line * nsamps + samp, bands, samp);
+            refl_qa_mask[samp] = (bench_rand (seed, samp, line) % 10 == 0);
+        }
+        ndiff_random += compare_snow_cover_class ("random", bands,
+            refl_qa_mask, nsamps, avx2_out, scalar_out, ndiff_out);
+    }
+
+    /* Edge cases */
+    nedge = make_check_edges (seed, bands, refl_qa_mask);
+    ndiff_edge = compare_snow_cover_class ("edge case", bands, refl_qa_mask,
+        (int) nedge, avx2_out, scalar_out, ndiff_out);
+
+    printf ("%-30s %12s\n", "output", "differences");
+    for (io = 0; io < CHECK_NOUT; io++)
+        printf ("%-30s %12ld\n", check_out_names[io], ndiff_out[io]);
+    printf ("%ld of %ld random pixels and %ld of %ld edge case pixels "
+        "differ\n", ndiff_random, (long) nlines * nsamps, ndiff_edge, nedge);
+
+    for (ib = 0; ib <= NBAND_REFL_MAX; ib++)
+        free (bands[ib]);
+    for (io = 0; io < CHECK_NOUT; io++)
+    {
+        free (avx2_out[io]);
+        free (scalar_out[io]);
+    }
+    free (refl_qa_mask);
+
+    if (ndiff_random > 0 || ndiff_edge > 0)
+    {
+        sprintf (errmsg, "The AVX2 and scalar snow cover classifiers "
+            "differ");
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+
+    return (SUCCESS);
+}
+
+
+/******************************************************************************
+MODULE:  read_bench_baseline (static)
+
+PURPOSE:  Reads the ns/pixel of each kernel from a baseline file written by
+--save_baseline.
+
+RETURN VALUE:
+Type = int
+Value      Description
+-----      -----------
+ERROR      The baseline file couldn't be opened
+SUCCESS    Successful completion
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. Kernels which aren't in the baseline file are left at 0.
+******************************************************************************/
+static int read_bench_baseline
+(
+    char *baseline_file,  /* I: name of the baseline file */
+    double *base_ns       /* O: baseline ns/pixel for each kernel */
+)
+{
+    char line[STR_SIZE];  /* current line of the baseline file */
+    char name[STR_SIZE];  /* kernel name on the current line */
+    double ns;            /* ns/pixel on the current line */
+    int ik;               /* looping variable for the kernels */
+    FILE *fptr = NULL;    /* baseline file pointer */
+
+    for (ik = 0; ik < BK_NUM; ik++)
+        base_ns[ik] = 0.0;
+
+    fptr = fopen (baseline_file, "r");
+    if (fptr == NULL)
+        return (ERROR);
+
+    while (fgets (line, sizeof (line), fptr) != NULL)
+    {
+        if (line[0] == '#' ||
+            sscanf (line, "%1023s %lf", name, &ns) != 2)
+            continue;
+        for (ik = 0; ik < BK_NUM; ik++)
+            if (!strcmp (name, bench_names[ik]))
+                base_ns[ik] = ns;
+    }
+
+    fclose (fptr);
+    return (SUCCESS);
+}
+
+
+/******************************************************************************
+MODULE:  main
+
+PURPOSE:  Benchmarks the scene_based_sca pixel kernels on a synthetic scene
+and reports the ns/pixel and GB/s of each kernel.
+
+RETURN VALUE:
+Type = int
+Value      Description
+-----      -----------
+ERROR      An error occurred during the benchmark
+SUCCESS    Successful completion
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+10/15/2026    agent            Added the --check mode
+
+NOTES:
+  1. The scene is processed one PROC_NLINES strip at a time, the same as in
+     scene_based_sca, and each kernel is timed on its own over all the
+     strips.  The kernels are run on one thread so the rates are per core.
+  2. With --save_baseline the results are written to the baseline file, and
+     with --baseline the results are compared against a baseline file
+     written earlier.  "make bench" and "make bench_baseline" use
+     bench_baseline.txt.
+  3. With --check nothing is timed.  The AVX2 snow cover classifier is
+     compared with the scalar classifier instead (see
+     check_snow_cover_class), and the exit status is ERROR if they differ.
+     "make check" runs it.
+******************************************************************************/
+int main (int argc, char *argv[])
+{
+    char FUNC_NAME[] = "main";  /* function name */
+    char errmsg[STR_SIZE];    /* error message */
+    char *baseline_file = NULL;  /* baseline file to compare against */
+    char *save_file = NULL;   /* baseline file to be written */
+    int nlines = BENCH_NLINES;  /* number of lines in the scene */
+    int nsamps = BENCH_NSAMPS;  /* number of samples in the scene */
+    int block = BENCH_BLOCK;  /* size of the surface class blocks */
+    float cloud_frac = 0.3;   /* fraction of cloud pixels */
+    float snow_frac = 0.2;    /* fraction of snow pixels */
+    float fill_frac = 0.1;    /* fraction of fill pixels */
+    unsigned int seed = 1;    /* seed for the scene */
+    int c;                    /* current option */
+    int option_index;         /* index of the current option */
+    int ib;                   /* looping variable for the bands */
+    int ik;                   /* looping variable for the kernels */
+    int line;                 /* first line of the current strip */
+    int pline;                /* line in the current strip */
+    int nlines_proc;          /* number of lines in the current strip */
+    int nwords;               /* number of words in a packed line */
+    long npix;                /* number of pixels in a full strip */
+    double bench_sec[BK_NUM]; /* time spent in each kernel */
+    double base_ns[BK_NUM];   /* baseline ns/pixel for each kernel */
+    double t0;                /* start time of the current kernel */
+    double ns;                /* ns/pixel for the current kernel */
+    bool have_baseline = false;  /* was the baseline file read */
+    bool check = false;       /* check the kernels instead of timing them */
+    int16 *bands[NBAND_REFL_MAX+1];  /* bands 1-5 and 7, then band 6 */
+    int16 *dem = NULL;        /* DEM for the strip */
+    uint8 *refl_qa_mask = NULL;   /* reflectance QA mask */
+    uint8 *btemp_qa_mask = NULL;  /* brightness temp QA mask */
+    uint8 *cloud_mask = NULL;     /* cloud mask */
+    uint8 *snow_mask = NULL;      /* snow mask */
+    uint8 *snow_class = NULL;     /* snow mask before post-processing */
+    uint8 *snow_prob = NULL;      /* snow probability score */
+    uint8 *tree_node = NULL;      /* snow tree node */
+    uint8 *ndsi = NULL;           /* NDSI outputs */
+    uint8 *ndvi = NULL;           /* NDVI outputs */
+    uint8 *shaded_relief = NULL;  /* shaded relief */
+    uint8 *deep_shad_mask = NULL; /* deep shadow mask */
+    uint8 *snow_count = NULL;     /* adjacent snow count */
+    Bit_word_t *combined_bits = NULL;  /* packed combined mask */
+    Bit_word_t *snow_bits = NULL;      /* packed snow mask */
+    Cloud_thresh_t thresh;    /* cloud cover thresholds */
+    Hillshade_t hs;           /* hillshade terms */
+    FILE *fptr = NULL;        /* baseline file pointer for the results */
+    static struct option long_options[] =
+    {
+        {"lines", required_argument, 0, 'l'},
+        {"samples", required_argument, 0, 's'},
+        {"block", required_argument, 0, 'b'},
+        {"cloud_frac", required_argument, 0, 'c'},
+        {"snow_frac", required_argument, 0, 'n'},
+        {"fill_frac", required_argument, 0, 'f'},
+        {"seed", required_argument, 0, 'r'},
+        {"baseline", required_argument, 0, 'B'},
+        {"save_baseline", required_argument, 0, 'S'},
+        {"check", no_argument, 0, 'C'},
+        {"help", no_argument, 0, 'h'},
+        {0, 0, 0, 0}
+    };
+
+    /* Read the command-line arguments */
+    opterr = 0;
+    while ((c = getopt_long (argc, argv, "", long_options, &option_index))
+        != -1)
+    {
+        switch (c)
+        {
+            case 'l':
+                nlines = atoi (optarg);
+                break;
+            case 's':
+                nsamps = atoi (optarg);
+                break;
+            case 'b':
+                block = atoi (optarg);
+                break;
+            case 'c':
+                cloud_frac = atof (optarg);
+                break;
+            case 'n':
+                snow_frac = atof (optarg);
+                break;
+            case 'f':
+                fill_frac = atof (optarg);
+                break;
+            case 'r':
+                seed = (unsigned int) atol (optarg);
+                break;
+            case 'B':
+                baseline_file = optarg;
+                break;
+            case 'S':
+                save_file = optarg;
+                break;
+            case 'C':
+                check = true;
+                break;
+            case 'h':
+            default:
+                printf ("usage: bench_kernels [--lines=nlines] "
+                    "[--samples=nsamps] [--block=pixels] "
+                    "[--cloud_frac=fraction] [--snow_frac=fraction] "
+                    "[--fill_frac=fraction] [--seed=seed] "
+                    "[--baseline=file] [--save_baseline=file] "
+                    "[--check]\n");
+                exit (c == 'h' ? SUCCESS : ERROR);
+        }
+    }
+
+    if (nlines < 3 || nsamps < 3 || block < 1 || cloud_frac < 0.0 ||
+        snow_frac < 0.0 || fill_frac < 0.0 ||
+        cloud_frac + snow_frac + fill_frac > 1.0)
+    {
+        sprintf (errmsg, "Invalid scene size, block size, or class "
+            "fractions");
+        error_handler (true, FUNC_NAME, errmsg);
+        exit (ERROR);
+    }
+
+    /* Compare the AVX2 and scalar kernels instead of timing them */
+    if (check)
+        exit (check_snow_cover_class (nlines, nsamps, seed));
+
+    /* Allocate the strip buffers */
+    npix = (long) PROC_NLINES * nsamps;
+    nwords = BIT_MASK_NWORDS (nsamps);
+    for (ib = 0; ib <= NBAND_REFL_MAX; ib++)
+        bands[ib] = calloc (npix, sizeof (int16));
+    dem = calloc (npix + 2 * nsamps, sizeof (int16));
+    refl_qa_mask = calloc (npix, sizeof (uint8));
+    btemp_qa_mask = calloc (npix, sizeof (uint8));
+    cloud_mask = calloc (npix, sizeof (uint8));
+    snow_mask = calloc (npix, sizeof (uint8));
+    snow_class = calloc (npix, sizeof (uint8));
+    snow_prob = calloc (npix, sizeof (uint8));
+    tree_node = calloc (npix, sizeof (uint8));
+    ndsi = calloc (npix, sizeof (uint8));
+    ndvi = calloc (npix, sizeof (uint8));
+    shaded_relief = calloc (npix, sizeof (uint8));
+    deep_shad_mask = calloc (npix, sizeof (uint8));
+    snow_count = calloc (npix, sizeof (uint8));
+    combined_bits = calloc ((long) PROC_NLINES * nwords, sizeof (Bit_word_t));
+    snow_bits = calloc ((long) PROC_NLINES * nwords, sizeof (Bit_word_t));
+    for (ib = 0; ib <= NBAND_REFL_MAX; ib++)
+        if (bands[ib] == NULL)
+            dem = NULL;
+    if (dem == NULL || refl_qa_mask == NULL || btemp_qa_mask == NULL ||
+        cloud_mask == NULL || snow_mask == NULL || snow_class == NULL ||
+        snow_prob == NULL || tree_node == NULL || ndsi == NULL ||
+        ndvi == NULL || shaded_relief == NULL || deep_shad_mask == NULL ||
+        snow_count == NULL || combined_bits == NULL || snow_bits == NULL)
+    {
+        sprintf (errmsg, "Error allocating memory for the strip buffers");
+        error_handler (true, FUNC_NAME, errmsg);
+        exit (ERROR);
+    }
+
+    if (init_cloud_thresh (BENCH_REFL_SCALE, BENCH_BTEMP_SCALE, &thresh)
+        != SUCCESS)
+    {
+        sprintf (errmsg, "Error setting up the cloud cover thresholds");
+        error_handler (true, FUNC_NAME, errmsg);
+        exit (ERROR);
+    }
+    init_hillshade (30.0, 30.0, 30.0 * M_PI / 180.0, 135.0 * M_PI / 180.0,
+        &hs);
+
+    printf ("Benchmarking the scene_based_sca kernels on a %d x %d scene "
+        "(cloud %.2f, snow %.2f, fill %.2f, %d pixel blocks)\n", nlines,
+        nsamps, cloud_frac, snow_frac, fill_frac, block);
+
+    /* Run the kernels one strip at a time, timing each of them */
+    for (ik = 0; ik < BK_NUM; ik++)
+        bench_sec[ik] = 0.0;
+    for (line = 0; line < nlines; line += PROC_NLINES)
+    {
+        nlines_proc = (line + PROC_NLINES > nlines) ? nlines - line :
+            PROC_NLINES;
+        make_bench_strip (line, nlines_proc, nsamps, block, cloud_frac,
+            snow_frac, fill_frac, seed, bands, dem);
+        memset (combined_bits, 0, (long) nlines_proc * nwords *
+            sizeof (Bit_word_t));
+
+        t0 = profile_clock ();
+        for (pline = 0; pline < nlines_proc; pline++)
+            qa_cloud_mask (&bands[0][(long) pline * nsamps],
+                &bands[1][(long) pline * nsamps],
+                &bands[2][(long) pline * nsamps],
+                &bands[3][(long) pline * nsamps],
+                &bands[4][(long) pline * nsamps],
+                &bands[6][(long) pline * nsamps],
+                &bands[5][(long) pline * nsamps], 1, nsamps, NULL,
+                BENCH_REFL_FILL, BENCH_BTEMP_FILL, &thresh,
+                &refl_qa_mask[(long) pline * nsamps],
+                &btemp_qa_mask[(long) pline * nsamps],
+                &cloud_mask[(long) pline * nsamps],
+                &combined_bits[(long) pline * nwords]);
+        bench_sec[BK_QA_CLOUD] += profile_clock () - t0;
+
+        t0 = profile_clock ();
+        cloud_cover_class (bands[0], bands[3], bands[6], bands[5],
+            nlines_proc, nsamps, &thresh, refl_qa_mask, btemp_qa_mask,
+            cloud_mask);
+        bench_sec[BK_CLOUD_CLASS] += profile_clock () - t0;
+
+        t0 = profile_clock ();
+        snow_cover_class (bands[0], bands[1], bands[2], bands[3], bands[4],
+            bands[6], bands[5], nlines_proc, nsamps, NULL, BENCH_REFL_SCALE,
+            BENCH_BTEMP_SCALE, BENCH_REFL_SATU, refl_qa_mask, snow_class,
+            snow_prob, tree_node, ndsi, ndvi);
+        bench_sec[BK_SNOW_TREE] += profile_clock () - t0;
+
+        t0 = profile_clock ();
+        deep_shadow (dem, false, false, nlines_proc, nsamps, NULL, &hs,
+            shaded_relief, deep_shad_mask);
+        bench_sec[BK_DEEP_SHADOW] += profile_clock () - t0;
+
+        t0 = profile_clock ();
+        combine_qa_mask (nlines_proc, nsamps, deep_shad_mask, combined_bits);
+        bench_sec[BK_COMBINE] += profile_clock () - t0;
+
+        /* The post-processing updates the snow mask in place, so it starts
+           from a copy of the classified mask */
+        memcpy (snow_mask, snow_class, (long) nlines_proc * nsamps);
+        t0 = profile_clock ();
+        if (post_process_snow_cover_class (nlines_proc, nsamps, 0,
+            nlines_proc, NULL, snow_mask, tree_node) != SUCCESS)
+        {
+            sprintf (errmsg, "Error post-processing the snow cover mask for "
+                "line %d", line);
+            error_handler (true, FUNC_NAME, errmsg);
+            exit (ERROR);
+        }
+        bench_sec[BK_POST_PROCESS] += profile_clock () - t0;
+
+        t0 = profile_clock ();
+        for (pline = 0; pline < nlines_proc; pline++)
+            pack_mask_line (&snow_mask[(long) pline * nsamps], nsamps,
+                SNOW_COVER, &snow_bits[(long) pline * nwords]);
+        count_adjacent_snow_cover (nlines_proc, nsamps, 0, nlines_proc,
+            snow_bits, combined_bits, snow_count);
+        bench_sec[BK_SNOW_COUNT] += profile_clock () - t0;
+    }  /* end for line */
+
+    /* Report the rates, compared against the baseline if there is one */
+    if (baseline_file != NULL)
+    {
+        if (read_bench_baseline (baseline_file, base_ns) == SUCCESS)
+            have_baseline = true;
+        else
+        {
+            sprintf (errmsg, "Unable to read the baseline file %s; run "
+                "with --save_baseline to create it", baseline_file);
+            error_handler (false, FUNC_NAME, errmsg);
+        }
+    }
+
+    if (save_file != NULL)
+    {
+        fptr = fopen (save_file, "w");
+        if (fptr == NULL)
+        {
+            sprintf (errmsg, "Error opening the baseline file %s",
+                save_file);
+            error_handler (true, FUNC_NAME, errmsg);
+            exit (ERROR);
+        }
+        fprintf (fptr, "# kernel ns_per_pixel gb_per_sec (%d x %d, cloud "
+            "%.2f, snow %.2f, fill %.2f)\n", nlines, nsamps, cloud_frac,
+            snow_frac, fill_frac);
+    }
+
+    printf ("%-30s %12s %10s%s\n", "kernel", "ns/pixel", "GB/s",
+        have_baseline ? "   speedup" : "");
+    for (ik = 0; ik < BK_NUM; ik++)
+    {
+        ns = bench_sec[ik] * 1.0e9 / ((double) nlines * nsamps);
+        printf ("%-30s %12.3f %10.3f", bench_names[ik], ns,
+            (ns > 0.0) ? bench_bytes[ik] / ns : 0.0);
+        if (have_baseline && base_ns[ik] > 0.0 && ns > 0.0)
+            printf (" %9.2fx", base_ns[ik] / ns);
+        printf ("\n");
+        if (fptr != NULL)
+            fprintf (fptr, "%s %.3f %.3f\n", bench_names[ik], ns,
+                (ns > 0.0) ? bench_bytes[ik] / ns : 0.0);
+    }
+
+    if (fptr != NULL && fclose (fptr) != 0)
+    {
+        sprintf (errmsg, "Error writing the baseline file %s", save_file);
+        error_handler (true, FUNC_NAME, errmsg);
+        exit (ERROR);
+    }
+
+    /* Free the strip buffers */
+    for (ib = 0; ib <= NBAND_REFL_MAX; ib++)
+        free (bands[ib]);
+    free (dem);
+    free (refl_qa_mask);
+    free (btemp_qa_mask);
+    free (cloud_mask);
+    free (snow_mask);
+    free (snow_class);
+    free (snow_prob);
+    free (tree_node);
+    free (ndsi);
+    free (ndvi);
+    free (shaded_relief);
+    free (deep_shad_mask);
+    free (snow_count);
+    free (combined_bits);
+    free (snow_bits);
+
+    exit (SUCCESS);
+}
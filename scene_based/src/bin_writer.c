@@ -0,0 +1,382 @@
+#include "sca.h"
+
+/******************************************************************************
+MODULE:  write_queued_bufs (static)
+
+PURPOSE:  Writer thread, which writes each of the queued buffers to its file
+and returns the buffer to the pool, until all of the writes have been queued
+and written.
+
+RETURN VALUE:
+Type = void *
+Value      Description
+-----      -----------
+NULL       Always returned; the status is stored in the writer
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. The buffers are still taken from the queue after a write fails, so
+     the queueing never blocks for good, but they are no longer written.
+  2. The status is read and set under the lock, since queue_bin_write
+     checks it from the main thread.
+******************************************************************************/
+static void *write_queued_bufs
+(
+    void *arg            /* I: pointer to the raw binary writer */
+)
+{
+    char FUNC_NAME[] = "write_queued_bufs";   /* function name */
+    char errmsg[STR_SIZE];    /* error message */
+    Bin_writer_t *this = (Bin_writer_t *) arg;   /* raw binary writer */
+    int ibuf;                 /* buffer being written */
+    int ifile;                /* file the buffer is for */
+    int status;               /* status of the writes so far */
+
+    while (1)
+    {
+        /* Wait for the next buffer */
+        pthread_mutex_lock (&this->lock);
+        while (this->qcount == 0 && !this->done)
+            pthread_cond_wait (&this->queued, &this->lock);
+        if (this->qcount == 0)
+        {
+            pthread_mutex_unlock (&this->lock);
+            break;
+        }
+        ibuf = this->queue[this->qhead];
+        this->qhead = (this->qhead + 1) % BIN_WRITER_NBUFS;
+        this->qcount--;
+        status = this->status;
+        pthread_mutex_unlock (&this->lock);
+
+        /* Write it, outside the lock so more buffers can be queued */
+        ifile = this->buf_file[ibuf];
+        if (status == SUCCESS &&
+            fwrite (this->pool[ibuf], 1, this->buf_len[ibuf],
+            this->fptr[ifile]) != this->buf_len[ibuf])
+        {
+            snprintf (errmsg, sizeof (errmsg),
+                "Error writing raw binary output file %.*s",
+                (int) (sizeof (errmsg) / 2), this->file_name[ifile]);
+            error_handler (true, FUNC_NAME, errmsg);
+            status = ERROR;
+        }
+
+        /* Record a failed write and return the buffer to the pool */
+        pthread_mutex_lock (&this->lock);
+        if (status != SUCCESS)
+            this->status = status;
+        this->free_buf[this->nfree++] = ibuf;
+        pthread_cond_signal (&this->freed);
+        pthread_mutex_unlock (&this->lock);
+    }
+
+    return (NULL);
+}
+
+
+/******************************************************************************
+MODULE:  free_bin_writer (static)
+
+PURPOSE:  Closes the files of the raw binary writer and frees its memory.
+
+RETURN VALUE:
+Type = int
+Value      Description
+-----      -----------
+ERROR      Error closing one of the files
+SUCCESS    Successful completion
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. The writer thread must not be running.
+******************************************************************************/
+static int free_bin_writer
+(
+    Bin_writer_t *this   /* I/O: raw binary writer to free */
+)
+{
+    char FUNC_NAME[] = "free_bin_writer";   /* function name */
+    char errmsg[STR_SIZE];    /* error message */
+    int i;                    /* loop counter for the files and buffers */
+    int status = SUCCESS;     /* return status */
+
+    for (i = 0; i < this->nfiles; i++)
+    {
+        if (this->fptr[i] != NULL && fclose (this->fptr[i]) != 0)
+        {
+            snprintf (errmsg, sizeof (errmsg),
+                "Error closing raw binary output file %.*s",
+                (int) (sizeof (errmsg) / 2), this->file_name[i]);
+            error_handler (true, FUNC_NAME, errmsg);
+            status = ERROR;
+        }
+        free (this->file_name[i]);
+    }
+    for (i = 0; i < BIN_WRITER_NBUFS; i++)
+        free (this->pool[i]);
+    free (this);
+
+    return (status);
+}
+
+
+/******************************************************************************
+MODULE:  open_bin_writer
+
+PURPOSE:  Creates the raw binary files, allocates the buffer pool, and starts
+the writer thread.
+
+RETURN VALUE:
+Type = Bin_writer_t *
+Value          Description
+-----          -----------
+NULL           Error opening the files or starting the writer thread
+non-NULL       Successful completion
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. The files are named prefix_name.bin, so the raw binary files of
+     different output products don't overwrite each other.
+******************************************************************************/
+Bin_writer_t *open_bin_writer
+(
+    char *prefix,        /* I: prefix of the file names */
+    int nfiles,          /* I: number of files to write */
+    char **names         /* I: name of each file, which follows the prefix
+                               and an underscore, and is followed by .bin */
+)
+{
+    char FUNC_NAME[] = "open_bin_writer";   /* function name */
+    char errmsg[STR_SIZE];    /* error message */
+    char bin_file[STR_SIZE];  /* name of the current file */
+    int i;                    /* loop counter for the files and buffers */
+    Bin_writer_t *this = NULL;  /* raw binary writer */
+
+    if (nfiles < 1 || nfiles > BIN_WRITER_MAX_FILES)
+    {
+        sprintf (errmsg, "Invalid number of raw binary files: %d", nfiles);
+        error_handler (true, FUNC_NAME, errmsg);
+        return (NULL);
+    }
+
+    this = calloc (1, sizeof (Bin_writer_t));
+    if (this == NULL)
+    {
+        sprintf (errmsg, "Error allocating memory for the raw binary writer");
+        error_handler (true, FUNC_NAME, errmsg);
+        return (NULL);
+    }
+
+    /* Open the files */
+    this->nfiles = nfiles;
+    for (i = 0; i < nfiles; i++)
+    {
+        if (snprintf (bin_file, STR_SIZE, "%s_%s.bin", prefix, names[i]) >=
+            STR_SIZE)
+        {
+            sprintf (errmsg, "Raw binary output file name for %s is too "
+                "long", names[i]);
+            error_handler (true, FUNC_NAME, errmsg);
+            free_bin_writer (this);
+            return (NULL);
+        }
+        this->file_name[i] = strdup (bin_file);
+        this->fptr[i] = fopen (bin_file, "wb");
+        if (this->file_name[i] == NULL || this->fptr[i] == NULL)
+        {
+            snprintf (errmsg, sizeof (errmsg),
+                "Error opening raw binary output file %.*s",
+                (int) (sizeof (errmsg) / 2), bin_file);
+            error_handler (true, FUNC_NAME, errmsg);
+            free_bin_writer (this);
+            return (NULL);
+        }
+    }
+
+    /* Allocate the buffer pool, with all of the buffers free */
+    for (i = 0; i < BIN_WRITER_NBUFS; i++)
+    {
+        this->pool[i] = malloc (BIN_WRITER_BUF_SIZE);
+        if (this->pool[i] == NULL)
+        {
+            sprintf (errmsg, "Error allocating memory for the raw binary "
+                "write buffers");
+            error_handler (true, FUNC_NAME, errmsg);
+            free_bin_writer (this);
+            return (NULL);
+        }
+        this->free_buf[i] = i;
+    }
+    this->nfree = BIN_WRITER_NBUFS;
+    this->status = SUCCESS;
+
+    /* Start the writer thread */
+    pthread_mutex_init (&this->lock, NULL);
+    pthread_cond_init (&this->queued, NULL);
+    pthread_cond_init (&this->freed, NULL);
+    if (pthread_create (&this->thread, NULL, write_queued_bufs,
+        (void *) this) != 0)
+    {
+        sprintf (errmsg, "Error creating the raw binary writer thread");
+        error_handler (true, FUNC_NAME, errmsg);
+        pthread_mutex_destroy (&this->lock);
+        pthread_cond_destroy (&this->queued);
+        pthread_cond_destroy (&this->freed);
+        free_bin_writer (this);
+        return (NULL);
+    }
+
+    return (this);
+}
+
+
+/******************************************************************************
+MODULE:  queue_bin_write
+
+PURPOSE:  Queues data to be appended to one of the raw binary files by the
+writer thread.
+
+RETURN VALUE:
+Type = int
+Value      Description
+-----      -----------
+ERROR      A previous write failed
+SUCCESS    Successful completion
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. The data is copied to buffers from the pool, so it may be changed as
+     soon as this returns.  This only blocks when all of the buffers in the
+     pool are queued.
+  2. The writes to each file are done in the order they are queued.
+******************************************************************************/
+int queue_bin_write
+(
+    Bin_writer_t *this,  /* I/O: raw binary writer */
+    int ifile,           /* I: file to write to */
+    void *data,          /* I: data to be written */
+    size_t nbytes        /* I: number of bytes to write */
+)
+{
+    char FUNC_NAME[] = "queue_bin_write";   /* function name */
+    char errmsg[STR_SIZE];    /* error message */
+    char *src = (char *) data;  /* data left to be queued */
+    size_t ncopy;             /* number of bytes copied to the buffer */
+    int ibuf;                 /* buffer being filled */
+    int status;               /* status of the writes so far */
+
+    pthread_mutex_lock (&this->lock);
+    status = this->status;
+    pthread_mutex_unlock (&this->lock);
+    if (status != SUCCESS)
+    {
+        sprintf (errmsg, "A previous write to the raw binary files failed");
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+
+    while (nbytes > 0)
+    {
+        /* Get a free buffer, waiting for the writer thread if need be */
+        pthread_mutex_lock (&this->lock);
+        if (this->nfree == 0)
+            this->nwaits++;
+        while (this->nfree == 0)
+            pthread_cond_wait (&this->freed, &this->lock);
+        ibuf = this->free_buf[--this->nfree];
+        pthread_mutex_unlock (&this->lock);
+
+        /* Fill it and queue it */
+        ncopy = (nbytes < BIN_WRITER_BUF_SIZE) ? nbytes : BIN_WRITER_BUF_SIZE;
+        memcpy (this->pool[ibuf], src, ncopy);
+        this->buf_file[ibuf] = ifile;
+        this->buf_len[ibuf] = ncopy;
+        src += ncopy;
+        nbytes -= ncopy;
+        this->nbytes += ncopy;
+
+        pthread_mutex_lock (&this->lock);
+        this->queue[(this->qhead + this->qcount) % BIN_WRITER_NBUFS] = ibuf;
+        this->qcount++;
+        pthread_cond_signal (&this->queued);
+        pthread_mutex_unlock (&this->lock);
+    }
+
+    return (SUCCESS);
+}
+
+
+/******************************************************************************
+MODULE:  close_bin_writer
+
+PURPOSE:  Waits for the writer thread to write all of the queued buffers,
+then closes the raw binary files and frees the writer.
+
+RETURN VALUE:
+Type = int
+Value      Description
+-----      -----------
+ERROR      Error writing or closing the files
+SUCCESS    Successful completion
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+******************************************************************************/
+int close_bin_writer
+(
+    Bin_writer_t *this   /* I/O: raw binary writer to close and free */
+)
+{
+    int status;               /* return status */
+
+    pthread_mutex_lock (&this->lock);
+    this->done = true;
+    pthread_cond_signal (&this->queued);
+    pthread_mutex_unlock (&this->lock);
+    pthread_join (this->thread, NULL);
+
+    pthread_mutex_destroy (&this->lock);
+    pthread_cond_destroy (&this->queued);
+    pthread_cond_destroy (&this->freed);
+    status = this->status;
+    if (free_bin_writer (this) != SUCCESS)
+        status = ERROR;
+
+    return (status);
+}
@@ -0,0 +1,68 @@
+#ifndef _BIN_WRITER_H_
+#define _BIN_WRITER_H_
+
+#include <stdio.h>
+#include <pthread.h>
+#include "bool.h"
+
+/* Define the maximum number of files written by a raw binary writer, and
+   the number and size of the buffers in its pool.  The pool bounds the
+   memory held by writes which are queued but not yet on disk. */
+#define BIN_WRITER_MAX_FILES 16
+#define BIN_WRITER_NBUFS 16
+#define BIN_WRITER_BUF_SIZE (1024 * 1024)
+
+/* Structure for the asynchronous raw binary writer.  The data for each
+   write is copied to buffers from the pool and queued, and a writer thread
+   writes the queued buffers to the files in the order they were queued. */
+typedef struct {
+    int nfiles;           /* number of files being written */
+    FILE *fptr[BIN_WRITER_MAX_FILES];      /* file pointer for each file */
+    char *file_name[BIN_WRITER_MAX_FILES]; /* name of each file */
+    char *pool[BIN_WRITER_NBUFS];          /* buffers of BIN_WRITER_BUF_SIZE
+                                              bytes */
+    int buf_file[BIN_WRITER_NBUFS];  /* file each queued buffer is for */
+    size_t buf_len[BIN_WRITER_NBUFS];  /* number of bytes in each queued
+                                          buffer */
+    int queue[BIN_WRITER_NBUFS];     /* buffers queued for the writer thread,
+                                        starting at qhead */
+    int qhead;            /* location in queue of the next buffer to write */
+    int qcount;           /* number of buffers queued */
+    int free_buf[BIN_WRITER_NBUFS];  /* buffers which are free */
+    int nfree;            /* number of free buffers */
+    bool done;            /* have all of the writes been queued? */
+    int status;           /* status of the writes; ERROR once one fails.
+                             Read and set under lock. */
+    long long nbytes;     /* number of bytes queued */
+    long nwaits;          /* number of times a write waited for a free
+                             buffer */
+    pthread_mutex_t lock; /* lock for the queue and free buffers */
+    pthread_cond_t queued;  /* signaled when a buffer is queued or when all
+                               the writes have been queued */
+    pthread_cond_t freed; /* signaled when a buffer is freed */
+    pthread_t thread;     /* writer thread */
+} Bin_writer_t;
+
+/* Prototypes */
+Bin_writer_t *open_bin_writer
+(
+    char *prefix,        /* I: prefix of the file names */
+    int nfiles,          /* I: number of files to write */
+    char **names         /* I: name of each file, which follows the prefix
+                               and an underscore, and is followed by .bin */
+);
+
+int queue_bin_write
+(
+    Bin_writer_t *this,  /* I/O: raw binary writer */
+    int ifile,           /* I: file to write to */
+    void *data,          /* I: data to be written */
+    size_t nbytes        /* I: number of bytes to write */
+);
+
+int close_bin_writer
+(
+    Bin_writer_t *this   /* I/O: raw binary writer to close and free */
+);
+
+#endif
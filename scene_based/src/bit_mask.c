@@ -0,0 +1,381 @@
+#include "bit_mask.h"
+
+/* The vectorized packing is compiled for AVX2 with gcc's target attribute
+   and selected at run time, so the application doesn't need to be built
+   with -mavx2 to use it */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BIT_MASK_AVX2
+#include <immintrin.h>
+#endif
+
+/******************************************************************************
+MODULE:  mask_word (static)
+
+PURPOSE:  Packs up to BIT_WORD_NBITS mask values into a word.
+
+RETURN VALUE:
+Type = Bit_word_t
+Value      Description
+-----      -----------
+word       Packed mask values
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+******************************************************************************/
+static inline Bit_word_t mask_word
+(
+    uint8 *mask,         /* I: mask values for the word */
+    int nvals,           /* I: number of mask values (BIT_WORD_NBITS except
+                               for the last word of the line) */
+    uint8 on_value       /* I: mask value for which the bit is set */
+)
+{
+    int i;               /* loop counter for the mask values */
+    Bit_word_t word = 0; /* packed mask values */
+
+    for (i = 0; i < nvals; i++)
+        word |= (Bit_word_t) (mask[i] == on_value) << i;
+
+    return (word);
+}
+
+
+#ifdef BIT_MASK_AVX2
+/******************************************************************************
+MODULE:  mask_word_avx2 (static)
+
+PURPOSE:  Packs BIT_WORD_NBITS mask values into a word, 32 values at a time.
+
+RETURN VALUE:
+Type = Bit_word_t
+Value      Description
+-----      -----------
+word       Packed mask values
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. The byte compare sets all the bits of the matching values, and the
+     movemask gathers the top bit of each byte, so the word is the same as
+     the one packed by mask_word.
+******************************************************************************/
+__attribute__ ((target ("avx2")))
+static inline Bit_word_t mask_word_avx2
+(
+    uint8 *mask,         /* I: BIT_WORD_NBITS mask values for the word */
+    __m256i on_value     /* I: mask value for which the bit is set, in each
+                               byte */
+)
+{
+    uint32_t lo, hi;     /* packed values for each half of the word */
+
+    lo = (uint32_t) _mm256_movemask_epi8 (_mm256_cmpeq_epi8 (
+        _mm256_loadu_si256 ((__m256i *) mask), on_value));
+    hi = (uint32_t) _mm256_movemask_epi8 (_mm256_cmpeq_epi8 (
+        _mm256_loadu_si256 ((__m256i *) &mask[32]), on_value));
+
+    return ((Bit_word_t) lo | ((Bit_word_t) hi << 32));
+}
+
+
+/******************************************************************************
+MODULE:  pack_mask_words_avx2 (static)
+
+PURPOSE:  Packs the whole words of a line of the mask using AVX2, setting or
+adding the bits for the pixels equal to on_value.
+
+RETURN VALUE:
+Type = int
+Value      Description
+-----      -----------
+samp       Sample after the last one packed; the caller packs the samples
+           from here to the end of the line
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+******************************************************************************/
+__attribute__ ((target ("avx2")))
+static int pack_mask_words_avx2
+(
+    uint8 *mask,         /* I: mask values for the line */
+    int nsamps,          /* I: number of samples in the line */
+    uint8 on_value,      /* I: mask value for which the bit is set */
+    bool add,            /* I: OR the bits into the packed mask rather than
+                               replacing the words? */
+    Bit_word_t *bits     /* I/O: packed mask for the line */
+)
+{
+    int iw;              /* current word */
+    int samp;            /* first sample of the current word */
+    __m256i on_v = _mm256_set1_epi8 ((char) on_value);  /* on value in each
+                            byte */
+
+    for (iw = 0, samp = 0; samp + BIT_WORD_NBITS <= nsamps;
+         iw++, samp += BIT_WORD_NBITS)
+    {
+        if (add)
+            bits[iw] |= mask_word_avx2 (&mask[samp], on_v);
+        else
+            bits[iw] = mask_word_avx2 (&mask[samp], on_v);
+    }
+
+    return (samp);
+}
+
+
+/******************************************************************************
+MODULE:  expand_mask_words_avx2 (static)
+
+PURPOSE:  Expands the whole words of a packed line of the mask using AVX2.
+
+RETURN VALUE:
+Type = int
+Value      Description
+-----      -----------
+samp       Sample after the last one expanded; the caller expands the
+           samples from here to the end of the line
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. The shuffle copies byte i/8 of each 32 bits to byte i, and the compare
+     tests bit i%8 of it.
+******************************************************************************/
+__attribute__ ((target ("avx2")))
+static int expand_mask_words_avx2
+(
+    Bit_word_t *bits,    /* I: packed mask for the line */
+    int nsamps,          /* I: number of samples in the line */
+    uint8 on_value,      /* I: mask value for the set bits */
+    uint8 *mask          /* O: mask values for the line */
+)
+{
+    int samp;            /* first sample of the current 32 */
+    uint32_t half;       /* packed values for the current 32 samples */
+    __m256i on_v = _mm256_set1_epi8 ((char) on_value);  /* on value in each
+                            byte */
+    __m256i select = _mm256_set1_epi64x (0x8040201008040201LL); /* bit
+                            tested in each byte */
+    __m256i spread = _mm256_setr_epi64x (0, 0x0101010101010101LL,
+        0x0202020202020202LL, 0x0303030303030303LL);  /* byte of the
+                            packed values for each sample */
+    __m256i vals;        /* byte i/8 of the packed values in byte i */
+
+    for (samp = 0; samp + 32 <= nsamps; samp += 32)
+    {
+        half = (uint32_t) (bits[samp / BIT_WORD_NBITS] >>
+            (samp % BIT_WORD_NBITS));
+        vals = _mm256_shuffle_epi8 (_mm256_set1_epi32 ((int) half), spread);
+        vals = _mm256_cmpeq_epi8 (_mm256_and_si256 (vals, select), select);
+        _mm256_storeu_si256 ((__m256i *) &mask[samp],
+            _mm256_and_si256 (vals, on_v));
+    }
+
+    return (samp);
+}
+#endif
+
+
+/******************************************************************************
+MODULE:  pack_mask_line
+
+PURPOSE:  Packs a line of the mask into one bit per pixel.
+
+RETURN VALUE:
+Type = None
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+10/14/2026    agent            Pack the whole words using AVX2
+
+NOTES:
+  1. The bits are set for the pixels equal to on_value.
+  2. The whole words are packed with AVX2 (pack_mask_words_avx2) when the
+     processor supports it.
+******************************************************************************/
+void pack_mask_line
+(
+    uint8 *mask,         /* I: mask values for the line */
+    int nsamps,          /* I: number of samples in the line */
+    uint8 on_value,      /* I: mask value for which the bit is set */
+    Bit_word_t *bits     /* O: packed mask for the line */
+)
+{
+    int iw;              /* current word */
+    int samp = 0;        /* first sample of the current word */
+
+#ifdef BIT_MASK_AVX2
+    if (__builtin_cpu_supports ("avx2"))
+        samp = pack_mask_words_avx2 (mask, nsamps, on_value, false, bits);
+#endif
+
+    for (iw = samp / BIT_WORD_NBITS; samp < nsamps;
+         iw++, samp += BIT_WORD_NBITS)
+        bits[iw] = mask_word (&mask[samp], (nsamps - samp < BIT_WORD_NBITS) ?
+            nsamps - samp : BIT_WORD_NBITS, on_value);
+}
+
+
+/******************************************************************************
+MODULE:  or_mask_line
+
+PURPOSE:  Adds a line of the mask to a packed mask, setting the bits for the
+pixels equal to on_value.
+
+RETURN VALUE:
+Type = None
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+10/14/2026    agent            Add the whole words using AVX2
+
+NOTES:
+  1. The whole words are added with AVX2 (pack_mask_words_avx2) when the
+     processor supports it.
+******************************************************************************/
+void or_mask_line
+(
+    uint8 *mask,         /* I: mask values for the line */
+    int nsamps,          /* I: number of samples in the line */
+    uint8 on_value,      /* I: mask value for which the bit is set */
+    Bit_word_t *bits     /* I/O: packed mask for the line */
+)
+{
+    int iw;              /* current word */
+    int samp = 0;        /* first sample of the current word */
+
+#ifdef BIT_MASK_AVX2
+    if (__builtin_cpu_supports ("avx2"))
+        samp = pack_mask_words_avx2 (mask, nsamps, on_value, true, bits);
+#endif
+
+    for (iw = samp / BIT_WORD_NBITS; samp < nsamps;
+         iw++, samp += BIT_WORD_NBITS)
+        bits[iw] |= mask_word (&mask[samp], (nsamps - samp < BIT_WORD_NBITS) ?
+            nsamps - samp : BIT_WORD_NBITS, on_value);
+}
+
+
+/******************************************************************************
+MODULE:  expand_mask_line
+
+PURPOSE:  Expands a packed line of the mask to one mask value per pixel.
+
+RETURN VALUE:
+Type = None
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+10/14/2026    agent            Expand 32 samples at a time using AVX2
+
+NOTES:
+  1. The samples are expanded with AVX2 (expand_mask_words_avx2) when the
+     processor supports it, leaving the last few samples of the line.
+******************************************************************************/
+void expand_mask_line
+(
+    Bit_word_t *bits,    /* I: packed mask for the line */
+    int nsamps,          /* I: number of samples in the line */
+    uint8 on_value,      /* I: mask value for the set bits */
+    uint8 *mask          /* O: mask values for the line; 0 for the bits
+                               which aren't set */
+)
+{
+    int samp = 0;        /* current sample */
+
+#ifdef BIT_MASK_AVX2
+    if (__builtin_cpu_supports ("avx2"))
+        samp = expand_mask_words_avx2 (bits, nsamps, on_value, mask);
+#endif
+
+    for ( ; samp < nsamps; samp++)
+        mask[samp] = ((bits[samp / BIT_WORD_NBITS] >> (samp % BIT_WORD_NBITS))
+            & 1) ? on_value : 0;
+}
+
+
+/******************************************************************************
+MODULE:  set_mask_range
+
+PURPOSE:  Sets the bits of a packed line of the mask for a range of samples.
+
+RETURN VALUE:
+Type = None
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. The whole words inside the range are set at once, so this is used for
+     the long runs of fill in the corners of the scene.
+******************************************************************************/
+void set_mask_range
+(
+    int start_samp,      /* I: first sample to be set */
+    int end_samp,        /* I: sample after the last one to be set */
+    Bit_word_t *bits     /* I/O: packed mask for the line */
+)
+{
+    int samp;            /* current sample */
+
+    for (samp = start_samp; samp < end_samp; )
+    {
+        if (samp % BIT_WORD_NBITS == 0 && end_samp - samp >= BIT_WORD_NBITS)
+        {
+            bits[samp / BIT_WORD_NBITS] = ~(Bit_word_t) 0;
+            samp += BIT_WORD_NBITS;
+        }
+        else
+        {
+            bits[samp / BIT_WORD_NBITS] |= (Bit_word_t) 1 <<
+                (samp % BIT_WORD_NBITS);
+            samp++;
+        }
+    }
+}
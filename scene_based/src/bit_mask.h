@@ -0,0 +1,50 @@
+#ifndef _BIT_MASK_H_
+#define _BIT_MASK_H_
+
+#include <stdint.h>
+#include "input.h"
+
+/* Packed masks hold one bit per pixel, with sample samp of a line in bit
+   samp % BIT_WORD_NBITS of word samp / BIT_WORD_NBITS.  Each line starts on
+   a new word, and the bits past the last sample of a line are 0s. */
+typedef uint64_t Bit_word_t;
+#define BIT_WORD_NBITS 64
+
+/* Number of words in a packed line of nsamps samples */
+#define BIT_MASK_NWORDS(nsamps) (((nsamps) + BIT_WORD_NBITS - 1) / \
+    BIT_WORD_NBITS)
+
+/* Prototypes */
+void pack_mask_line
+(
+    uint8 *mask,         /* I: mask values for the line */
+    int nsamps,          /* I: number of samples in the line */
+    uint8 on_value,      /* I: mask value for which the bit is set */
+    Bit_word_t *bits     /* O: packed mask for the line */
+);
+
+void or_mask_line
+(
+    uint8 *mask,         /* I: mask values for the line */
+    int nsamps,          /* I: number of samples in the line */
+    uint8 on_value,      /* I: mask value for which the bit is set */
+    Bit_word_t *bits     /* I/O: packed mask for the line */
+);
+
+void expand_mask_line
+(
+    Bit_word_t *bits,    /* I: packed mask for the line */
+    int nsamps,          /* I: number of samples in the line */
+    uint8 on_value,      /* I: mask value for the set bits */
+    uint8 *mask          /* O: mask values for the line; 0 for the bits
+                               which aren't set */
+);
+
+void set_mask_range
+(
+    int start_samp,      /* I: first sample to be set */
+    int end_samp,        /* I: sample after the last one to be set */
+    Bit_word_t *bits     /* I/O: packed mask for the line */
+);
+
+#endif
@@ -1,5 +1,212 @@
 #include "sca.h"
 
+/******************************************************************************
+MODULE:  unscaled_lt_thresh (static)
+
+PURPOSE:  Converts a threshold for the scaled band values to a threshold for
+the unscaled int16 values.  For any int16 value x, (x * scale_fact < thresh)
+is the same as (x < t) for the returned t.
+
+RETURN VALUE:
+Type = int
+Value      Description
+-----      -----------
+t          Smallest int16 value whose scaled value is not less than thresh,
+           or 32768 if there is no such value
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date        Programmer       Reason
+--------    ---------------  -------------------------------------
+10/14/2026  agent            Original Development
+
+NOTES:
+  1. The scale factor must be positive, so the scaled values increase with
+     the unscaled values.
+  2. The scaled values are computed in float and compared against the double
+     threshold, exactly as in the classifier, so the integer test gives the
+     same results.
+******************************************************************************/
+static int unscaled_lt_thresh
+(
+    double thresh,        /* I: threshold for the scaled values */
+    float scale_fact      /* I: scale factor for the band */
+)
+{
+    int low = -32768;     /* smallest candidate threshold */
+    int high = 32768;     /* largest candidate threshold */
+    int mid;              /* value being tested */
+    float scaled;         /* scaled value for mid */
+
+    /* Binary search for the smallest value which isn't below the
+       threshold once scaled */
+    while (low < high)
+    {
+        mid = low + (high - low) / 2;
+        scaled = mid * scale_fact;
+        if (scaled < thresh)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    return (low);
+}
+
+
+/******************************************************************************
+MODULE:  init_cloud_thresh
+
+PURPOSE:  Converts the thresholds of the cloud cover classification tree to
+thresholds for the unscaled band values, so the classification can compare
+the int16 values directly instead of scaling each pixel.
+
+RETURN VALUE:
+Type = int
+Value      Description
+-----      -----------
+ERROR      Error with the scale factors
+SUCCESS    Successful completion
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date        Programmer       Reason
+--------    ---------------  -------------------------------------
+10/14/2026  agent            Original Development
+
+NOTES:
+  1. This only needs to be called once per scene, since the thresholds
+     depend only on the scale factors.
+******************************************************************************/
+int init_cloud_thresh
+(
+    float refl_scale_fact,  /* I: scale factor for the TOA reflectance values */
+    float btemp_scale_fact, /* I: scale factor for the brightness temp values */
+    Cloud_thresh_t *thresh  /* O: cloud cover thresholds for the unscaled
+                                  values */
+)
+{
+    char FUNC_NAME[] = "init_cloud_thresh";  /* function name */
+    char errmsg[STR_SIZE];    /* error message */
+
+    if (refl_scale_fact <= 0.0 || btemp_scale_fact <= 0.0)
+    {
+        sprintf (errmsg, "Scale factors must be positive (refl: %f, "
+            "btemp: %f)", refl_scale_fact, btemp_scale_fact);
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+
+    thresh->b1_30095 = unscaled_lt_thresh (0.30095, refl_scale_fact);
+    thresh->b1_20055 = unscaled_lt_thresh (0.20055, refl_scale_fact);
+    thresh->b4_104525 = unscaled_lt_thresh (1.04525, refl_scale_fact);
+    thresh->b6_7052 = unscaled_lt_thresh (-7.052, btemp_scale_fact);
+    thresh->b6_19316 = unscaled_lt_thresh (-19.316, btemp_scale_fact);
+    thresh->b6_20036 = unscaled_lt_thresh (-20.036, btemp_scale_fact);
+    thresh->b6_8788 = unscaled_lt_thresh (8.788, btemp_scale_fact);
+    thresh->b7_08255 = unscaled_lt_thresh (0.08255, refl_scale_fact);
+    thresh->b7_1166 = unscaled_lt_thresh (0.1166, refl_scale_fact);
+    thresh->b7_15305 = unscaled_lt_thresh (0.15305, refl_scale_fact);
+
+    return (SUCCESS);
+}
+
+
+/******************************************************************************
+MODULE:  cloud_tree (static)
+
+PURPOSE:  Runs the cloud cover classification tree for the unscaled band
+values of one pixel.
+
+RETURN VALUE:
+Type = uint8
+Value        Description
+-----        -----------
+CLOUD_COVER  Pixel is cloud
+NO_CLOUD     Pixel is not cloud
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date        Programmer       Reason
+--------    ---------------  -------------------------------------
+10/14/2026  agent            Original Development (from cloud_cover_class)
+
+NOTES:
+  1. The thresholds commented below are for the scaled values.  The results
+     are the same as scaling each pixel and comparing against them.
+******************************************************************************/
+static inline uint8 cloud_tree
+(
+    int b1_pix,     /* I: unscaled band 1 value for the pixel */
+    int b4_pix,     /* I: unscaled band 4 value for the pixel */
+    int b6_pix,     /* I: unscaled band 6 value for the pixel */
+    int b7_pix,     /* I: unscaled band 7 value for the pixel */
+    Cloud_thresh_t *thresh  /* I: cloud cover thresholds for the unscaled
+                                  values */
+)
+{
+    uint8 cc_mask;  /* cloud cover mask for the pixel */
+
+    if (b1_pix < thresh->b1_30095)   /* 0.30095 */
+    {
+        if (b1_pix < thresh->b1_20055)   /* 0.20055 */
+            cc_mask = NO_CLOUD;
+        else
+        {
+            if (b7_pix < thresh->b7_08255)   /* 0.08255 */
+                cc_mask = NO_CLOUD;
+            else
+            {
+                if (b6_pix < thresh->b6_7052)   /* -7.052, 266.098 K */
+                    cc_mask = CLOUD_COVER;
+                else
+                    cc_mask = NO_CLOUD;
+            }
+        }
+    }
+    else
+    {
+        if (b7_pix < thresh->b7_1166)   /* 0.1166 */
+        {
+            if (b6_pix < thresh->b6_19316)  /* -19.316, 253.834 K */
+                cc_mask = CLOUD_COVER;
+            else
+                cc_mask = NO_CLOUD;
+        }
+        else
+        {
+            if (b7_pix < thresh->b7_15305)   /* 0.15305 */
+            {
+                if (b6_pix < thresh->b6_20036) /* -20.036, 253.114 K */
+                    cc_mask = CLOUD_COVER;
+                else
+                    cc_mask = NO_CLOUD;
+            }
+            else
+            {
+                if (b6_pix < thresh->b6_8788)  /* 8.788, 281.938 K */
+                {
+                    if (b4_pix < thresh->b4_104525)   /* 1.04525 */
+                        cc_mask = CLOUD_COVER;
+                    else
+                        cc_mask = NO_CLOUD;
+                }
+                else
+                    cc_mask = NO_CLOUD;
+            }
+        }
+    }
+
+    return (cc_mask);
+}
+
+
 /******************************************************************************
 
 MODULE:  cloud_cover_class
@@ -19,11 +226,15 @@ Date        Programmer       Reason
 1/8/2013    Gail Schmidt     Converted the brightness temp constants from
                              degrees Kelvin to degrees Celsius since the
                              LEDAPS brightness temps are in Celsius
+10/14/2026  agent            Compare the unscaled band values against the
+                             thresholds from init_cloud_thresh rather than
+                             scaling each pixel
 
 NOTES:
   1. Algorithm is based on the cloud cover classification tree provided by
      Dave Selkowitz, Research Geographer, USGS Alaska Science Center.
   2. Input and output arrays are 1D arrays of size nlines * nsamps.
+  3. The tree is in cloud_tree, which is shared with qa_cloud_mask.
 ******************************************************************************/
 void cloud_cover_class
 (
@@ -34,8 +245,8 @@ void cloud_cover_class
     int16 *b7,     /* I: array of unscaled band 7 TOA reflectance values */
     int nlines,    /* I: number of lines in the data arrays */
     int nsamps,    /* I: number of samples in the data arrays */
-    float refl_scale_fact,  /* I: scale factor for the TOA reflectance values */
-    float btemp_scale_fact, /* I: scale factor for the brightness temp values */
+    Cloud_thresh_t *thresh, /* I: cloud cover thresholds for the unscaled
+                                  values */
     uint8 *refl_qa_mask,  /* I: array of masked values for processing (non-zero
                                 values are not to be processed) reflectance
                                 bands */
@@ -47,20 +258,20 @@ void cloud_cover_class
 {
     uint8 cc_mask;    /* cloud cover mask for the current pixel */
     int pix;          /* current pixel being processed */
-    float b1_pix;     /* scaled band 1 value for current pixel */
-    float b4_pix;     /* scaled band 4 value for current pixel */
-    float b6_pix;     /* scaled band 6 value for current pixel */
-    float b7_pix;     /* scaled band 7 value for current pixel */
+    int b1_pix;       /* unscaled band 1 value for current pixel */
+    int b4_pix;       /* unscaled band 4 value for current pixel */
+    int b6_pix;       /* unscaled band 6 value for current pixel */
+    int b7_pix;       /* unscaled band 7 value for current pixel */
 
     /* Loop through the pixels in the array to determine the cloud cover
        classification */
     for (pix = 0; pix < nlines*nsamps; pix++)
     {
-        /* Scale the current pixel for each band */
-        b1_pix = b1[pix] * refl_scale_fact;
-        b4_pix = b4[pix] * refl_scale_fact;
-        b6_pix = b6[pix] * btemp_scale_fact;
-        b7_pix = b7[pix] * refl_scale_fact;
+        /* Get the current pixel for each band */
+        b1_pix = b1[pix];
+        b4_pix = b4[pix];
+        b6_pix = b6[pix];
+        b7_pix = b7[pix];
 
         /* Initialize the pixel to no cloud cover */
         cc_mask = NO_CLOUD;
@@ -74,56 +285,140 @@ void cloud_cover_class
         }
 
         /* Determine cloud cover */
-        if (b1_pix < 0.30095)
+        cc_mask = cloud_tree (b1_pix, b4_pix, b6_pix, b7_pix, thresh);
+
+        cloud_mask[pix] = cc_mask;
+    }  /* end for pix */
+}
+
+
+/******************************************************************************
+MODULE:  qa_cloud_mask
+
+PURPOSE:  Generates the QA masks for the TOA reflectance and brightness temp
+fill pixels, the cloud cover mask, and the fill and cloud part of the packed
+combined QA mask in a single pass over the bands.
+
+RETURN VALUE:
+Type = None
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date        Programmer       Reason
+--------    ---------------  -------------------------------------
+10/14/2026  agent            Original Development
+10/14/2026  agent            Set the bits of the packed combined QA mask
+10/14/2026  agent            Only test the pixels in the valid span of each
+                             line
+
+NOTES:
+  1. The results are the same as refl_mask, btemp_mask, cloud_cover_class,
+     and the fill and cloud tests of the combined QA mask, but each band
+     value is read once.
+  2. Input and output arrays are 1D arrays of size nlines * nsamps.  The
+     packed combined QA mask has BIT_MASK_NWORDS(nsamps) words per line.
+  3. The combined QA mask is only turned on, so it should be initialized to
+     0s.  combine_qa_mask adds the deep shadow pixels once the deep shadow
+     mask is available.
+  4. The pixels outside the valid span are fill in every band, so they are
+     set to the fill results without looking at the bands.
+******************************************************************************/
+void qa_cloud_mask
+(
+    int16 *b1,     /* I: array of unscaled band 1 TOA reflectance values */
+    int16 *b2,     /* I: array of unscaled band 2 TOA reflectance values */
+    int16 *b3,     /* I: array of unscaled band 3 TOA reflectance values */
+    int16 *b4,     /* I: array of unscaled band 4 TOA reflectance values */
+    int16 *b5,     /* I: array of unscaled band 5 TOA reflectance values */
+    int16 *b6,     /* I: array of unscaled band 6 brightness temp values,
+                         in degrees Celsius */
+    int16 *b7,     /* I: array of unscaled band 7 TOA reflectance values */
+    int nlines,    /* I: number of lines in the data arrays */
+    int nsamps,    /* I: number of samples in the data arrays */
+    Valid_span_t *span,  /* I: valid span of each line, outside of which the
+                               pixels are fill in every band; NULL if all
+                               of the samples are processed */
+    int refl_fill,  /* I: fill value for the TOA reflectance values */
+    int btemp_fill, /* I: fill value for the brightness temp values */
+    Cloud_thresh_t *thresh, /* I: cloud cover thresholds for the unscaled
+                                  values */
+    uint8 *refl_qa_mask,  /* O: array of masked values for processing (non-zero
+                                values are not to be processed) reflectance
+                                bands */
+    uint8 *btemp_qa_mask, /* O: array of masked values for processing (non-zero
+                                values are not to be processed) thermal bands */
+    uint8 *cloud_mask,    /* O: array of cloud cover masked values (non-zero
+                                values represent clouds) */
+    Bit_word_t *combined_bits  /* I/O: packed combined mask, turned on for
+                                       the cloud and fill pixels */
+)
+{
+    int line, samp;   /* current line and sample being processed */
+    int pix;          /* current pixel being processed */
+    int nwords;       /* number of words in a packed line */
+    int start, end;   /* valid span of the current line */
+    Bit_word_t *bits; /* packed combined mask for the current line */
+    int b1_pix;       /* unscaled band 1 value for current pixel */
+    int b4_pix;       /* unscaled band 4 value for current pixel */
+    int b6_pix;       /* unscaled band 6 value for current pixel */
+    int b7_pix;       /* unscaled band 7 value for current pixel */
+    bool refl_fill_pix;   /* is the current pixel fill in any reflective
+                             band? */
+    bool btemp_fill_pix;  /* is the current pixel fill in the thermal band? */
+    uint8 cc_mask;    /* cloud cover mask for the current pixel */
+
+    nwords = BIT_MASK_NWORDS (nsamps);
+    for (line = 0; line < nlines; line++)
+    {
+        /* The pixels outside the valid span are fill */
+        start = 0;
+        end = nsamps;
+        if (span != NULL)
         {
-            if (b1_pix < 0.20055)
-                cc_mask = NO_CLOUD;
-            else
-            {
-                if (b7_pix < 0.08255)
-                    cc_mask = NO_CLOUD;
-                else
-                {
-                    if (b6_pix < -7.052)   /* 266.098 K */
-                        cc_mask = CLOUD_COVER;
-                    else
-                        cc_mask = NO_CLOUD;
-                }
-            }
+            start = span[line].start;
+            end = span[line].end;
         }
-        else
+        pix = line * nsamps;
+        bits = &combined_bits[line * nwords];
+        memset (&refl_qa_mask[pix], NO_DATA, start);
+        memset (&refl_qa_mask[pix + end], NO_DATA, nsamps - end);
+        memset (&btemp_qa_mask[pix], NO_DATA, start);
+        memset (&btemp_qa_mask[pix + end], NO_DATA, nsamps - end);
+        memset (&cloud_mask[pix], NO_CLOUD, start);
+        memset (&cloud_mask[pix + end], NO_CLOUD, nsamps - end);
+        set_mask_range (0, start, bits);
+        set_mask_range (end, nsamps, bits);
+
+        for (samp = start, pix += start; samp < end; samp++, pix++)
         {
-            if (b7_pix < 0.1166)
-            {
-                if (b6_pix < -19.316)   /* 253.834 K */
-                    cc_mask = CLOUD_COVER;
-                else
-                    cc_mask = NO_CLOUD;
-            }
-            else
-            {
-                if (b7_pix < 0.15305)
-                {
-                    if (b6_pix < -20.036)    /* 253.114 K */
-                        cc_mask = CLOUD_COVER;
-                    else
-                        cc_mask = NO_CLOUD;
-                }
-                else
-                {
-                    if (b6_pix < 8.788)    /* 281.938 K */
-                    {
-                        if (b4_pix < 1.04525)
-                            cc_mask = CLOUD_COVER;
-                        else
-                            cc_mask = NO_CLOUD;
-                    }
-                    else
-                        cc_mask = NO_CLOUD;
-                }
-            }
-        }
+            /* Get the current pixel for each band used by the cloud tree */
+            b1_pix = b1[pix];
+            b4_pix = b4[pix];
+            b6_pix = b6[pix];
+            b7_pix = b7[pix];
 
-        cloud_mask[pix] = cc_mask;
-    }  /* end for pix */
+            /* If the current pixel in any band is fill then set the QA
+               value to not be processed.  Otherwise it's valid data. */
+            refl_fill_pix = (b1_pix == refl_fill || b2[pix] == refl_fill ||
+                b3[pix] == refl_fill || b4_pix == refl_fill ||
+                b5[pix] == refl_fill || b7_pix == refl_fill);
+            btemp_fill_pix = (b6_pix == btemp_fill);
+            refl_qa_mask[pix] = refl_fill_pix ? NO_DATA : VALID_DATA;
+            btemp_qa_mask[pix] = btemp_fill_pix ? NO_DATA : VALID_DATA;
+
+            /* Determine cloud cover for the pixels which aren't fill */
+            cc_mask = NO_CLOUD;
+            if (!refl_fill_pix && !btemp_fill_pix)
+                cc_mask = cloud_tree (b1_pix, b4_pix, b6_pix, b7_pix, thresh);
+            cloud_mask[pix] = cc_mask;
+
+            /* If the current pixel is cloud or fill, then flag it in the
+               combined mask */
+            if (refl_fill_pix || btemp_fill_pix || cc_mask == CLOUD_COVER)
+                bits[samp / BIT_WORD_NBITS] |=
+                    (Bit_word_t) 1 << (samp % BIT_WORD_NBITS);
+        }  /* end for samp */
+    }  /* end for line */
 }
@@ -5,7 +5,8 @@ MODULE:  combine_qa_mask
 
 PURPOSE:  Combines the QA masks from cloud, deep shadow, and fill into one
 overall mask.  If the current pixel is flagged as any of these, then the
-combined QA mask is turned on.
+combined QA mask is turned on.  The cloud and fill pixels are flagged by
+qa_cloud_mask, so this adds the deep shadow pixels.
 
 RETURN VALUE:
 Type = None
@@ -17,37 +18,41 @@ HISTORY:
 Date         Programmer       Reason
 ---------    ---------------  -------------------------------------
 2/21/2013    Gail Schmidt     Original Development
+10/14/2026   agent            The cloud and fill pixels are now flagged in
+                              the single pass of qa_cloud_mask, so only the
+                              deep shadow mask is combined here
+10/14/2026   agent            Combine into the packed combined QA mask
+                              a word at a time
+10/14/2026   agent            or_mask_line packs 32 pixels at a time using
+                              AVX2
 
 NOTES:
-  1. Input and output arrays are 1D arrays of size nlines * nsamps.
-  2. Non-zero values represent snow, cloud, fill in the input masks.
+  1. The deep shadow mask is a 1D array of size nlines * nsamps.  The packed
+     combined QA mask has BIT_MASK_NWORDS(nsamps) words per line.
+  2. Non-zero values represent deep shadow in the input mask.
+  3. This is the only pass over the deep shadow mask; the combined QA output
+     band is expanded from the packed mask as the lines are written.
 ******************************************************************************/
 void combine_qa_mask
 (
     int nlines,           /* I: number of lines in the data arrays */
     int nsamps,           /* I: number of samples in the data arrays */
-    uint8 *cloud_mask,    /* I: array of cloud masked values */
     uint8 *shadow_mask,   /* I: array of deep shadow masked values */
-    uint8 *refl_qa_mask,  /* I: quality mask for the TOA reflectance products,
-                                where fill and saturated values are flagged */
-    uint8 *btemp_qa_mask, /* I: quality mask for the brightness temp products,
-                                where fill and saturated values are flagged */
-    uint8 *combined_qa    /* O: combined mask representing cloud, deep shadow,
-                                and fill for the current pixel */
+    Bit_word_t *combined_bits  /* I/O: packed combined mask representing
+                                       cloud, deep shadow, and fill for the
+                                       current pixel; cloud and fill are
+                                       already flagged */
 )
 {
-    int pix;                /* current pixel being processed */
+    int line;               /* current line being processed */
+    int nwords;             /* number of words in a packed line */
 
-    /* Loop through the pixels in the array to count the adjacent snow cover
-       pixels */
-    for (pix = 0; pix < nlines * nsamps; pix++)
+    /* Loop through the lines in the array to add the deep shadow pixels to
+       the combined mask */
+    nwords = BIT_MASK_NWORDS (nsamps);
+    for (line = 0; line < nlines; line++)
     {
-        /* If the current pixel is cloud, deep shadow, or fill, then flag it
-           in the combined mask. */
-        if (cloud_mask[pix] == CLOUD_COVER || refl_qa_mask[pix] == NO_DATA ||
-            btemp_qa_mask[pix] == NO_DATA || shadow_mask[pix] == DEEP_SHADOW)
-        {
-            combined_qa[pix] = COMBINED_MASK;
-        }
+        or_mask_line (&shadow_mask[(long) line * nsamps], nsamps,
+            DEEP_SHADOW, &combined_bits[(long) line * nwords]);
     }
 }
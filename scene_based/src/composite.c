@@ -0,0 +1,590 @@
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "sca.h"
+
+/******************************************************************************
+MODULE:  unmap_composite (static)
+
+PURPOSE:  Unmaps and closes the composite state file, if it's open.
+
+RETURN VALUE:
+Type = None
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. Closing the file releases the lock taken by map_composite.
+******************************************************************************/
+static void unmap_composite
+(
+    Composite_t *this     /* I/O: composite state */
+)
+{
+    if (this->map != NULL)
+        munmap (this->map, this->map_size);
+    if (this->fd >= 0)
+        close (this->fd);
+    this->map = NULL;
+    this->hdr = NULL;
+    this->pixels = NULL;
+    this->fd = -1;
+}
+
+
+/******************************************************************************
+MODULE:  map_composite (static)
+
+PURPOSE:  Opens and locks the composite state file, creating it for the
+output image if it doesn't exist, and memory maps it for read/write access.
+
+RETURN VALUE:
+Type = int
+Value      Description
+-----      -----------
+ERROR      Error creating, locking, or mapping the state file, or the state
+           file is for a different image or path/row
+SUCCESS    Successful completion
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. The file is locked until it's closed, so two runs can't fold scenes
+     into the same state at once.
+  2. A new file is sized and its pixels are set to no observations before
+     the header is written, so a file which was only partly created is
+     rejected rather than used.
+  3. The file is unmapped and closed if there's an error.
+******************************************************************************/
+static int map_composite
+(
+    Composite_t *this,    /* I/O: composite state */
+    int nlines,           /* I: number of lines in the output image */
+    int nsamps,           /* I: number of samples in the output image */
+    int path,             /* I: WRS path of the scene */
+    int row               /* I: WRS row of the scene */
+)
+{
+    char FUNC_NAME[] = "map_composite";   /* function name */
+    char errmsg[STR_SIZE];    /* error message */
+    long pix;                 /* current pixel being initialized */
+    long npix;                /* number of pixels in the output image */
+    bool created;             /* was the state file created by this run? */
+    struct stat file_stat;    /* status of the state file */
+    Composite_header_t *hdr = NULL;  /* header of the mapped file */
+
+    this->fd = open (this->file_name, O_RDWR | O_CREAT, 0644);
+    if (this->fd < 0)
+    {
+        sprintf (errmsg, "Error opening the composite state file %s",
+            this->file_name);
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+    if (flock (this->fd, LOCK_EX | LOCK_NB) != 0)
+    {
+        sprintf (errmsg, "The composite state file %s is in use by another "
+            "run", this->file_name);
+        error_handler (true, FUNC_NAME, errmsg);
+        unmap_composite (this);
+        return (ERROR);
+    }
+    if (fstat (this->fd, &file_stat) != 0)
+    {
+        sprintf (errmsg, "Error getting the status of the composite state "
+            "file %s", this->file_name);
+        error_handler (true, FUNC_NAME, errmsg);
+        unmap_composite (this);
+        return (ERROR);
+    }
+
+    /* Size a new file for the output image */
+    npix = (long) nlines * nsamps;
+    this->map_size = COMPOSITE_HEADER_SIZE +
+        (size_t) npix * sizeof (Composite_pixel_t);
+    created = (file_stat.st_size == 0);
+    if (created && ftruncate (this->fd, (off_t) this->map_size) != 0)
+    {
+        sprintf (errmsg, "Error sizing the composite state file %s",
+            this->file_name);
+        error_handler (true, FUNC_NAME, errmsg);
+        unmap_composite (this);
+        return (ERROR);
+    }
+    if (!created && (size_t) file_stat.st_size != this->map_size)
+    {
+        sprintf (errmsg, "The composite state file %s isn't for an image of "
+            "%d lines and %d samples", this->file_name, nlines, nsamps);
+        error_handler (true, FUNC_NAME, errmsg);
+        unmap_composite (this);
+        return (ERROR);
+    }
+
+    this->map = mmap (NULL, this->map_size, PROT_READ | PROT_WRITE,
+        MAP_SHARED, this->fd, 0);
+    if (this->map == MAP_FAILED)
+    {
+        this->map = NULL;
+        sprintf (errmsg, "Error memory mapping the composite state file %s",
+            this->file_name);
+        error_handler (true, FUNC_NAME, errmsg);
+        unmap_composite (this);
+        return (ERROR);
+    }
+    hdr = (Composite_header_t *) this->map;
+    this->hdr = hdr;
+    this->pixels = (Composite_pixel_t *) ((char *) this->map +
+        COMPOSITE_HEADER_SIZE);
+    this->nlines = nlines;
+    this->nsamps = nsamps;
+
+    /* Set up a new file, writing the header last */
+    if (created)
+    {
+        for (pix = 0; pix < npix; pix++)
+        {
+            this->pixels[pix].last_clear = COMPOSITE_NO_DATE;
+            this->pixels[pix].first_snow = COMPOSITE_NO_DATE;
+            this->pixels[pix].last_snow = COMPOSITE_NO_DATE;
+            this->pixels[pix].nclear = 0;
+            this->pixels[pix].nsnow = 0;
+        }
+        if (msync (this->map, this->map_size, MS_SYNC) != 0)
+        {
+            sprintf (errmsg, "Error writing the composite state file %s",
+                this->file_name);
+            error_handler (true, FUNC_NAME, errmsg);
+            unmap_composite (this);
+            return (ERROR);
+        }
+        hdr->version = COMPOSITE_VERSION;
+        hdr->nlines = nlines;
+        hdr->nsamps = nsamps;
+        hdr->path = path;
+        hdr->row = row;
+        hdr->ndates = 0;
+        hdr->pending_date = COMPOSITE_NO_DATE;
+        memcpy (hdr->magic, COMPOSITE_MAGIC, sizeof (hdr->magic));
+        return (SUCCESS);
+    }
+
+    /* Make sure an existing file is a complete state file for this image */
+    if (memcmp (hdr->magic, COMPOSITE_MAGIC, sizeof (hdr->magic)) != 0 ||
+        hdr->version != COMPOSITE_VERSION || hdr->ndates < 0 ||
+        hdr->ndates > COMPOSITE_MAX_DATES)
+    {
+        sprintf (errmsg, "%s isn't a composite state file", this->file_name);
+        error_handler (true, FUNC_NAME, errmsg);
+        unmap_composite (this);
+        return (ERROR);
+    }
+    if (hdr->nlines != nlines || hdr->nsamps != nsamps)
+    {
+        sprintf (errmsg, "The composite state file %s is for an image of %d "
+            "lines and %d samples, not %d lines and %d samples",
+            this->file_name, hdr->nlines, hdr->nsamps, nlines, nsamps);
+        error_handler (true, FUNC_NAME, errmsg);
+        unmap_composite (this);
+        return (ERROR);
+    }
+    if (hdr->path != path || hdr->row != row)
+    {
+        sprintf (errmsg, "The composite state file %s is for path %d row %d, "
+            "not path %d row %d", this->file_name, hdr->path, hdr->row, path,
+            row);
+        error_handler (true, FUNC_NAME, errmsg);
+        unmap_composite (this);
+        return (ERROR);
+    }
+
+    return (SUCCESS);
+}
+
+
+/******************************************************************************
+MODULE:  open_composite
+
+PURPOSE:  Sets up the composite state for the state file.  The file is
+mapped when the first scene is started, once the size of the output image
+is known.
+
+RETURN VALUE:
+Type = Composite_t*
+Value      Description
+-----      -----------
+NULL       Error allocating the composite state
+non-NULL   Successful completion
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+******************************************************************************/
+Composite_t *open_composite
+(
+    char *file_name       /* I: name of the composite state file */
+)
+{
+    char FUNC_NAME[] = "open_composite";   /* function name */
+    char errmsg[STR_SIZE];    /* error message */
+    Composite_t *this = NULL; /* composite state to be populated and returned
+                                 to the caller */
+
+    this = (Composite_t *) calloc (1, sizeof (Composite_t));
+    if (this == NULL)
+    {
+        sprintf (errmsg, "Error allocating the composite state");
+        error_handler (true, FUNC_NAME, errmsg);
+        return (NULL);
+    }
+    this->file_name = dup_string (file_name);
+    if (this->file_name == NULL)
+    {
+        sprintf (errmsg, "Error allocating the composite state file name");
+        error_handler (true, FUNC_NAME, errmsg);
+        free (this);
+        return (NULL);
+    }
+    this->fd = -1;
+    this->folding = false;
+
+    return (this);
+}
+
+
+/******************************************************************************
+MODULE:  start_composite_scene
+
+PURPOSE:  Starts folding a scene into the composite state, mapping the state
+file if this is the first scene.
+
+RETURN VALUE:
+Type = int
+Value      Description
+-----      -----------
+ERROR      Error mapping the state file, or the scene doesn't match it
+SUCCESS    Successful completion
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. A scene with an acquisition date which was already folded into the
+     state is reported and isn't folded again, so rerunning the scenes of a
+     season doesn't count them twice.
+  2. The date of the scene is recorded as pending until the scene is
+     finished.  A pending date left by a run which failed part way through
+     a scene is reported, since some of the lines of that scene are in the
+     state.
+******************************************************************************/
+int start_composite_scene
+(
+    Composite_t *this,    /* I/O: composite state */
+    int nlines,           /* I: number of lines in the output image */
+    int nsamps,           /* I: number of samples in the output image */
+    Date_t *acq_date,     /* I: acquisition date of the scene */
+    int path,             /* I: WRS path of the scene */
+    int row               /* I: WRS row of the scene */
+)
+{
+    char FUNC_NAME[] = "start_composite_scene";   /* function name */
+    char errmsg[STR_SIZE];    /* error message */
+    int i;                    /* loop counter for the folded dates */
+    Composite_header_t *hdr = NULL;  /* header of the state file */
+
+    this->folding = false;
+    if (acq_date->jday2000 <= COMPOSITE_NO_DATE ||
+        acq_date->jday2000 > INT16_MAX)
+    {
+        sprintf (errmsg, "Acquisition date %d-%03d is out of the range of the "
+            "composite dates", acq_date->year, acq_date->doy);
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+
+    if (this->map == NULL)
+    {
+        if (map_composite (this, nlines, nsamps, path, row) != SUCCESS)
+        {
+            sprintf (errmsg, "Error mapping the composite state file %s",
+                this->file_name);
+            error_handler (true, FUNC_NAME, errmsg);
+            return (ERROR);
+        }
+    }
+    else if (this->nlines != nlines || this->nsamps != nsamps ||
+        this->hdr->path != path || this->hdr->row != row)
+    {
+        sprintf (errmsg, "The composite state file %s is for path %d row %d "
+            "with %d lines and %d samples, not path %d row %d with %d lines "
+            "and %d samples", this->file_name, this->hdr->path,
+            this->hdr->row, this->nlines, this->nsamps, path, row, nlines,
+            nsamps);
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+    hdr = this->hdr;
+
+    if (hdr->pending_date != COMPOSITE_NO_DATE)
+    {
+        sprintf (errmsg, "The scene for day %d of the composite state file %s "
+            "was not finished, so part of it is in the state",
+            hdr->pending_date, this->file_name);
+        error_handler (false, FUNC_NAME, errmsg);
+        hdr->pending_date = COMPOSITE_NO_DATE;
+    }
+
+    /* Skip a date which was already folded */
+    for (i = 0; i < hdr->ndates; i++)
+    {
+        if (hdr->dates[i] == acq_date->jday2000)
+        {
+            sprintf (errmsg, "The scene for %d-%03d was already folded into "
+                "the composite state file %s, so it is skipped",
+                acq_date->year, acq_date->doy, this->file_name);
+            error_handler (false, FUNC_NAME, errmsg);
+            return (SUCCESS);
+        }
+    }
+    if (hdr->ndates >= COMPOSITE_MAX_DATES)
+    {
+        sprintf (errmsg, "The composite state file %s already holds %d "
+            "scenes", this->file_name, COMPOSITE_MAX_DATES);
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+
+    /* Mark the scene as pending before any of its lines are folded */
+    hdr->pending_date = (int32_t) acq_date->jday2000;
+    if (msync (this->map, COMPOSITE_HEADER_SIZE, MS_SYNC) != 0)
+    {
+        sprintf (errmsg, "Error writing the header of the composite state "
+            "file %s", this->file_name);
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+    this->date = (int16_t) acq_date->jday2000;
+    this->folding = true;
+
+    return (SUCCESS);
+}
+
+
+/******************************************************************************
+MODULE:  fold_composite_lines
+
+PURPOSE:  Folds lines of the snow cover and combined QA masks of the scene
+into the composite state.
+
+RETURN VALUE:
+Type = None
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. A pixel is observed if it isn't masked in the combined QA mask (cloud,
+     deep shadow, or fill), and is a snow observation if it is also snow in
+     the snow cover mask.  Pixels which aren't observed are left as they
+     are.
+  2. The first and last dates are the minimum and maximum dates, so the
+     scenes may be folded in any order.  COMPOSITE_NO_DATE is below any
+     date, so it doesn't need to be checked for the last dates.  The counts
+     stop at COMPOSITE_MAX_COUNT.
+  3. Nothing is folded if the scene was skipped by start_composite_scene.
+  4. The lines are independent, so they are divided among the threads.
+******************************************************************************/
+void fold_composite_lines
+(
+    Composite_t *this,    /* I/O: composite state */
+    uint8 *snow_mask,     /* I: snow cover mask for the lines */
+    uint8 *combined_qa,   /* I: combined QA mask for the lines */
+    long stride,          /* I: number of values between the lines of the
+                                masks */
+    int iline,            /* I: first line of the output image (0-based) */
+    int nlines            /* I: number of lines to be folded */
+)
+{
+    int line;                 /* current line being folded */
+    int samp;                 /* current sample being folded */
+    int16_t date = this->date;  /* date of the scene */
+    uint8 *snow = NULL;       /* snow cover mask for the line */
+    uint8 *qa = NULL;         /* combined QA mask for the line */
+    Composite_pixel_t *pixel = NULL;  /* state of the current pixel */
+
+    if (!this->folding)
+        return;
+
+#ifdef _OPENMP
+    #pragma omp parallel for private(samp, snow, qa, pixel)
+#endif
+    for (line = 0; line < nlines; line++)
+    {
+        snow = &snow_mask[line * stride];
+        qa = &combined_qa[line * stride];
+        pixel = &this->pixels[(long) (iline + line) * this->nsamps];
+        for (samp = 0; samp < this->nsamps; samp++, pixel++)
+        {
+            if (qa[samp] == COMBINED_MASK)
+                continue;
+
+            if (date > pixel->last_clear)
+                pixel->last_clear = date;
+            if (pixel->nclear < COMPOSITE_MAX_COUNT)
+                pixel->nclear++;
+
+            if (snow[samp] != SNOW_COVER)
+                continue;
+            if (pixel->first_snow == COMPOSITE_NO_DATE ||
+                date < pixel->first_snow)
+                pixel->first_snow = date;
+            if (date > pixel->last_snow)
+                pixel->last_snow = date;
+            if (pixel->nsnow < COMPOSITE_MAX_COUNT)
+                pixel->nsnow++;
+        }
+    }
+}
+
+
+/******************************************************************************
+MODULE:  finish_composite_scene
+
+PURPOSE:  Finishes folding a scene into the composite state, flushing the
+state to the file and recording the date of the scene.
+
+RETURN VALUE:
+Type = int
+Value      Description
+-----      -----------
+ERROR      Error writing the state file
+SUCCESS    Successful completion
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. Only the pages changed by the scene are written, so the cost of a scene
+     doesn't grow with the number of scenes in the state.  The pixels are
+     flushed before the date is recorded, so a recorded date is in the file.
+******************************************************************************/
+int finish_composite_scene
+(
+    Composite_t *this     /* I/O: composite state */
+)
+{
+    char FUNC_NAME[] = "finish_composite_scene";   /* function name */
+    char errmsg[STR_SIZE];    /* error message */
+    Composite_header_t *hdr = this->hdr;  /* header of the state file */
+
+    if (!this->folding)
+        return (SUCCESS);
+    this->folding = false;
+
+    if (msync (this->map, this->map_size, MS_SYNC) != 0)
+    {
+        sprintf (errmsg, "Error writing the composite state file %s",
+            this->file_name);
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+
+    hdr->dates[hdr->ndates] = this->date;
+    hdr->ndates++;
+    hdr->pending_date = COMPOSITE_NO_DATE;
+    if (msync (this->map, COMPOSITE_HEADER_SIZE, MS_SYNC) != 0)
+    {
+        sprintf (errmsg, "Error writing the header of the composite state "
+            "file %s", this->file_name);
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+
+    return (SUCCESS);
+}
+
+
+/******************************************************************************
+MODULE:  close_composite
+
+PURPOSE:  Unmaps and closes the composite state file, then frees the
+composite state.
+
+RETURN VALUE:
+Type = int
+Value      Description
+-----      -----------
+ERROR      Error writing the state file
+SUCCESS    Successful completion
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. A scene which was started but not finished is left pending in the
+     state file (see start_composite_scene).
+******************************************************************************/
+int close_composite
+(
+    Composite_t *this     /* I/O: composite state to be closed and freed */
+)
+{
+    char FUNC_NAME[] = "close_composite";   /* function name */
+    char errmsg[STR_SIZE];    /* error message */
+    int retval = SUCCESS;     /* return status */
+
+    if (this == NULL)
+        return (SUCCESS);
+
+    if (this->map != NULL && msync (this->map, this->map_size, MS_SYNC) != 0)
+    {
+        sprintf (errmsg, "Error writing the composite state file %s",
+            this->file_name);
+        error_handler (true, FUNC_NAME, errmsg);
+        retval = ERROR;
+    }
+    unmap_composite (this);
+    free (this->file_name);
+    free (this);
+
+    return (retval);
+}
@@ -0,0 +1,96 @@
+#ifndef _COMPOSITE_H_
+#define _COMPOSITE_H_
+
+#include <stdint.h>
+#include "bool.h"
+#include "input.h"
+
+/* Snow cover composite state file, which holds the per-pixel state of the
+   scenes of a path/row folded so far.  The header is followed by a
+   Composite_pixel_t for each pixel of the output image, line by line.
+   The dates are days since Jan. 1, 2000 (see Date_t.jday2000). */
+#define COMPOSITE_MAGIC "SCACOMP1"
+#define COMPOSITE_VERSION 1
+#define COMPOSITE_HEADER_SIZE 8192
+#define COMPOSITE_MAX_DATES 1024
+#define COMPOSITE_NO_DATE (-32768)
+#define COMPOSITE_MAX_COUNT 65535
+
+typedef struct {
+    char magic[8];        /* COMPOSITE_MAGIC */
+    int32_t version;      /* COMPOSITE_VERSION */
+    int32_t nlines;       /* number of lines in the output image */
+    int32_t nsamps;       /* number of samples in the output image */
+    int32_t path;         /* WRS path of the scenes */
+    int32_t row;          /* WRS row of the scenes */
+    int32_t ndates;       /* number of scenes folded into the state */
+    int32_t pending_date; /* date of a scene which was started but not
+                             finished; COMPOSITE_NO_DATE if none */
+    int32_t dates[COMPOSITE_MAX_DATES];  /* dates of the folded scenes, in
+                             the order they were folded */
+} Composite_header_t;
+
+typedef struct {
+    int16_t last_clear;   /* date of the last clear observation */
+    int16_t first_snow;   /* date of the first snow observation */
+    int16_t last_snow;    /* date of the last snow observation */
+    uint16_t nclear;      /* number of clear observations, including the
+                             snow observations */
+    uint16_t nsnow;       /* number of snow observations */
+} Composite_pixel_t;
+
+/* Composite state, memory mapped from the state file once the first scene
+   is started */
+typedef struct {
+    char *file_name;      /* name of the composite state file */
+    int fd;               /* file descriptor of the state file; -1 until the
+                             first scene is started */
+    int nlines;           /* number of lines in the output image */
+    int nsamps;           /* number of samples in the output image */
+    size_t map_size;      /* size of the mapped file in bytes */
+    void *map;            /* mapped state file */
+    Composite_header_t *hdr;  /* header of the state file */
+    Composite_pixel_t *pixels;  /* state of the pixels, following the
+                             header */
+    int16_t date;         /* date of the scene being folded */
+    bool folding;         /* is a scene being folded into the state? */
+} Composite_t;
+
+/* Prototypes */
+Composite_t *open_composite
+(
+    char *file_name       /* I: name of the composite state file */
+);
+
+int start_composite_scene
+(
+    Composite_t *this,    /* I/O: composite state */
+    int nlines,           /* I: number of lines in the output image */
+    int nsamps,           /* I: number of samples in the output image */
+    Date_t *acq_date,     /* I: acquisition date of the scene */
+    int path,             /* I: WRS path of the scene */
+    int row               /* I: WRS row of the scene */
+);
+
+void fold_composite_lines
+(
+    Composite_t *this,    /* I/O: composite state */
+    uint8 *snow_mask,     /* I: snow cover mask for the lines */
+    uint8 *combined_qa,   /* I: combined QA mask for the lines */
+    long stride,          /* I: number of values between the lines of the
+                                masks */
+    int iline,            /* I: first line of the output image (0-based) */
+    int nlines            /* I: number of lines to be folded */
+);
+
+int finish_composite_scene
+(
+    Composite_t *this     /* I/O: composite state */
+);
+
+int close_composite
+(
+    Composite_t *this     /* I/O: composite state to be closed and freed */
+);
+
+#endif
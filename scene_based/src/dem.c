@@ -0,0 +1,265 @@
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "sca.h"
+
+/******************************************************************************
+MODULE:  open_dem
+
+PURPOSE:  Opens the scene-based DEM and memory maps it for read access.
+
+RETURN VALUE:
+Type = Dem_t*
+Value      Description
+-----      -----------
+NULL       Error occurred opening or mapping the DEM
+non-NULL   Successful completion
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. The DEM should be the same size as the input scene, since the scene was
+     used to resample the DEM.  A DEM which is smaller than the scene is an
+     error.
+  2. The DEM is read from the top to the bottom, so the kernel is advised
+     the access will be sequential.
+******************************************************************************/
+Dem_t *open_dem
+(
+    char *file_name,      /* I: name of the DEM file */
+    int nlines,           /* I: number of lines in the scene */
+    int nsamps            /* I: number of samples in the scene */
+)
+{
+    char FUNC_NAME[] = "open_dem";   /* function name */
+    char errmsg[STR_SIZE];    /* error message */
+    size_t scene_size;        /* size of the DEM for the scene in bytes */
+    struct stat file_stat;    /* status of the DEM file */
+    void *map = NULL;         /* mapped DEM file */
+    Dem_t *this = NULL;       /* DEM data structure to be populated and
+                                 returned to the caller */
+
+    /* Create the DEM data structure */
+    this = (Dem_t *) malloc (sizeof (Dem_t));
+    if (this == NULL)
+    {
+        sprintf (errmsg, "Error allocating the DEM data structure");
+        error_handler (true, FUNC_NAME, errmsg);
+        return (NULL);
+    }
+    this->nlines = nlines;
+    this->nsamps = nsamps;
+    this->data = NULL;
+    this->win_data = NULL;
+    this->lines = NULL;
+    this->map_size = 0;
+
+    this->file_name = dup_string (file_name);
+    if (this->file_name == NULL)
+    {
+        sprintf (errmsg, "Error duplicating the DEM file name");
+        error_handler (true, FUNC_NAME, errmsg);
+        free (this);
+        return (NULL);
+    }
+
+    /* Open the DEM and make sure it covers the scene */
+    this->fd = open (file_name, O_RDONLY);
+    if (this->fd < 0)
+    {
+        sprintf (errmsg, "Error opening the DEM file: %s", file_name);
+        error_handler (true, FUNC_NAME, errmsg);
+        free (this->file_name);
+        free (this);
+        return (NULL);
+    }
+
+    scene_size = (size_t) nlines * nsamps * sizeof (int16);
+    if (fstat (this->fd, &file_stat) != 0)
+    {
+        sprintf (errmsg, "Error getting the size of the DEM file: %s",
+            file_name);
+        error_handler (true, FUNC_NAME, errmsg);
+        close_dem (this);
+        return (NULL);
+    }
+    if ((size_t) file_stat.st_size < scene_size)
+    {
+        sprintf (errmsg, "DEM file %s is %ld bytes, which is smaller than "
+            "the %ld bytes needed for the %d lines and %d samples of the "
+            "scene.  The DEM needs to be resampled to the scene.", file_name,
+            (long) file_stat.st_size, (long) scene_size, nlines, nsamps);
+        error_handler (true, FUNC_NAME, errmsg);
+        close_dem (this);
+        return (NULL);
+    }
+
+    /* Map the part of the DEM covering the scene */
+    map = mmap (NULL, scene_size, PROT_READ, MAP_PRIVATE, this->fd, 0);
+    if (map == MAP_FAILED)
+    {
+        sprintf (errmsg, "Error memory mapping the DEM file: %s", file_name);
+        error_handler (true, FUNC_NAME, errmsg);
+        close_dem (this);
+        return (NULL);
+    }
+    this->data = (int16 *) map;
+    this->lines = this->data;
+    this->map_size = scene_size;
+
+    /* The advice is only a hint, so failing to set it isn't an error */
+    madvise (map, scene_size, MADV_SEQUENTIAL);
+
+    return (this);
+}
+
+
+/******************************************************************************
+MODULE:  set_dem_window
+
+PURPOSE:  Sets the window of the scene to be used, so get_dem_line returns
+the lines of the window.
+
+RETURN VALUE:
+Type = int
+Value      Description
+-----      -----------
+ERROR      The window is not within the DEM, or the window couldn't be copied
+SUCCESS    Successful completion
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. The callers use the lines after the one returned by get_dem_line, so
+     the lines of the window need to be contiguous.  A window as wide as the
+     scene is used in place in the mapped DEM.  A narrower window is copied;
+     for the small windows this is meant for, the copy is much smaller than
+     the scene.
+  2. The window is relative to the whole DEM, so it may only be set once.
+******************************************************************************/
+int set_dem_window
+(
+    Dem_t *this,          /* I/O: DEM data structure */
+    Img_window_t *window  /* I: window of the scene to be used */
+)
+{
+    char FUNC_NAME[] = "set_dem_window";   /* function name */
+    char errmsg[STR_SIZE];    /* error message */
+    int line;                 /* looping variable for the window lines */
+
+    if (window->line0 < 0 || window->samp0 < 0 || window->nlines < 1 ||
+        window->nsamps < 1 || window->line0 + window->nlines > this->nlines ||
+        window->samp0 + window->nsamps > this->nsamps)
+    {
+        sprintf (errmsg, "Window of %d lines and %d samples starting at line "
+            "%d, sample %d is not within the DEM", window->nlines,
+            window->nsamps, window->line0, window->samp0);
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+
+    if (window->samp0 == 0 && window->nsamps == this->nsamps)
+        this->lines = &this->data[(size_t) window->line0 * this->nsamps];
+    else
+    {
+        this->win_data = malloc ((size_t) window->nlines * window->nsamps *
+            sizeof (int16));
+        if (this->win_data == NULL)
+        {
+            sprintf (errmsg, "Error allocating memory for the DEM window");
+            error_handler (true, FUNC_NAME, errmsg);
+            return (ERROR);
+        }
+        for (line = 0; line < window->nlines; line++)
+            memcpy (&this->win_data[(size_t) line * window->nsamps],
+                &this->data[(size_t) (window->line0 + line) * this->nsamps +
+                window->samp0], window->nsamps * sizeof (int16));
+        this->lines = this->win_data;
+    }
+    this->nlines = window->nlines;
+    this->nsamps = window->nsamps;
+
+    return (SUCCESS);
+}
+
+
+/******************************************************************************
+MODULE:  get_dem_line
+
+PURPOSE:  Returns a pointer to a line of the mapped DEM.
+
+RETURN VALUE:
+Type = int16*
+Value      Description
+-----      -----------
+non-NULL   DEM values for the line, followed by the rest of the DEM lines
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. The DEM is stored in line order, so the lines after iline follow the
+     returned pointer.  The caller must not access past the last line.
+******************************************************************************/
+int16 *get_dem_line
+(
+    Dem_t *this,          /* I: DEM data structure */
+    int iline             /* I: line of the DEM (0-based) */
+)
+{
+    return (&this->lines[(size_t) iline * this->nsamps]);
+}
+
+
+/******************************************************************************
+MODULE:  close_dem
+
+PURPOSE:  Unmaps and closes the DEM, then frees the DEM data structure.
+
+RETURN VALUE:
+Type = None
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+******************************************************************************/
+void close_dem
+(
+    Dem_t *this           /* I/O: DEM data structure to be closed and freed */
+)
+{
+    if (this == NULL)
+        return;
+
+    if (this->data != NULL)
+        munmap ((void *) this->data, this->map_size);
+    free (this->win_data);
+    if (this->fd >= 0)
+        close (this->fd);
+    free (this->file_name);
+    free (this);
+}
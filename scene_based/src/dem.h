@@ -0,0 +1,52 @@
+#ifndef _DEM_H_
+#define _DEM_H_
+
+#include <stdlib.h>
+#include "bool.h"
+#include "input.h"
+
+/* Scene-based DEM, a raw binary file of int16 elevations (meters) with the
+   same number of lines and samples as the scene.  The file is memory mapped
+   so the DEM lines can be used in place. */
+typedef struct {
+    char *file_name;      /* name of the DEM file */
+    int fd;               /* file descriptor for the DEM file */
+    int nlines;           /* number of lines in the DEM, or in the window
+                             if one is set */
+    int nsamps;           /* number of samples in the DEM, or in the window
+                             if one is set */
+    size_t map_size;      /* size of the mapped file in bytes */
+    int16 *data;          /* mapped DEM values for the scene */
+    int16 *win_data;      /* copy of the DEM values for the window, when the
+                             window is narrower than the scene; NULL
+                             otherwise */
+    int16 *lines;         /* DEM values for the lines returned by
+                             get_dem_line, nlines * nsamps */
+} Dem_t;
+
+/* Prototypes */
+Dem_t *open_dem
+(
+    char *file_name,      /* I: name of the DEM file */
+    int nlines,           /* I: number of lines in the scene */
+    int nsamps            /* I: number of samples in the scene */
+);
+
+int set_dem_window
+(
+    Dem_t *this,          /* I/O: DEM data structure */
+    Img_window_t *window  /* I: window of the scene to be used */
+);
+
+int16 *get_dem_line
+(
+    Dem_t *this,          /* I: DEM data structure */
+    int iline             /* I: line of the DEM (0-based) */
+);
+
+void close_dem
+(
+    Dem_t *this           /* I/O: DEM data structure to be closed and freed */
+);
+
+#endif
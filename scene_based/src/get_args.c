@@ -23,11 +23,35 @@ Date        Programmer       Reason
 --------    ---------------  -------------------------------------
 1/2/2013    Gail Schmidt     Original Development
 2/15/2013   Gail Schmidt     Added support for write raw binary flag
+10/14/2026  agent            Added support for the number of threads
+10/14/2026  agent            Added support for the pre-pass post-processing
+                             flag
+10/14/2026  agent            Added support for the batch manifest
+10/14/2026  agent            Added support for the profile
+10/14/2026  agent            Added support for the processing window
+10/14/2026  agent            Added support for the memory budget
+10/14/2026  agent            Added support for the tiled output flag
+10/14/2026  agent            Allow raw binary output with the batch manifest
+10/14/2026  agent            Added support for the terrain cache directory
+10/14/2026  agent            Added support for the composite state file
 
 NOTES:
   1. Memory is allocated for the input and output files.  All of these should
      be character pointers set to NULL on input.  The caller is responsible
      for freeing the allocated memory upon successful return.
+  2. The number of threads is left at 0 if not specified, which means the
+     OpenMP default (generally the number of cores) will be used.
+  3. The batch manifest replaces the input and output files, which are left
+     NULL when it is specified.
+  4. --profile writes the profile to stdout, and --profile=file writes it to
+     the file.  Memory is allocated for the profile file, if specified.
+  5. --window=line0,samp0,nlines,nsamps processes only that window of the
+     scene.  It's checked against the scene size when the scene is opened.
+     It requires --prepass_post_process (see WINDOW_HALO).
+  6. The memory budget is left at 0 if not specified, which means the strips
+     are PROC_NLINES lines.
+  7. Memory is allocated for the terrain cache directory, if specified.
+  8. Memory is allocated for the composite state file, if specified.
 ******************************************************************************/
 short get_args
 (
@@ -37,7 +61,23 @@ short get_args
     char **btemp_infile,  /* O: address of input TOA filename */
     char **dem_infile,    /* O: address of input DEM filename */
     char **sc_outfile,    /* O: address of output snow cover filename */
+    char **manifest,      /* O: address of batch manifest filename */
     bool *write_binary,   /* O: write raw binary flag */
+    bool *prepass_post,   /* O: post-process the snow cover using the
+                                pre-pass mask for the window counts */
+    int *nthreads,        /* O: number of threads for processing */
+    bool *profile,        /* O: should the processing stages be profiled */
+    char **profile_file,  /* O: address of the profile JSON filename (NULL
+                                for stdout) */
+    Img_window_t *window, /* O: window of the scene to be processed; 0 lines
+                                for the whole scene */
+    long *mem_budget_mb,  /* O: megabytes of memory to size the strips for;
+                                0 for strips of PROC_NLINES lines */
+    bool *tiled_output,   /* O: write the tiled output files flag */
+    char **terrain_cache, /* O: address of the terrain cache directory (NULL
+                                if the terrain isn't cached) */
+    char **composite,     /* O: address of the composite state filename
+                                (NULL if the scenes aren't composited) */
     bool *verbose         /* O: verbose flag */
 )
 {
@@ -45,20 +85,40 @@ short get_args
     int option_index;                /* index for the command-line option */
     static int verbose_flag=0;       /* verbose flag */
     static int binary_flag=0;        /* write binary flag */
+    static int prepass_flag=0;       /* pre-pass post-processing flag */
+    static int tiled_flag=0;         /* tiled output flag */
     char errmsg[STR_SIZE];           /* error message */
     char FUNC_NAME[] = "get_args";   /* function name */
     static struct option long_options[] =
     {
         {"verbose", no_argument, &verbose_flag, 1},
         {"write_binary", no_argument, &binary_flag, 1},
+        {"prepass_post_process", no_argument, &prepass_flag, 1},
+        {"tiled_output", no_argument, &tiled_flag, 1},
         {"toa", required_argument, 0, 't'},
         {"btemp", required_argument, 0, 'b'},
         {"dem", required_argument, 0, 'd'},
         {"snow_cover", required_argument, 0, 's'},
+        {"threads", required_argument, 0, 'n'},
+        {"manifest", required_argument, 0, 'm'},
+        {"profile", optional_argument, 0, 'p'},
+        {"window", required_argument, 0, 'w'},
+        {"mem_budget_mb", required_argument, 0, 'g'},
+        {"terrain_cache", required_argument, 0, 'c'},
+        {"composite", required_argument, 0, 'o'},
         {"help", no_argument, 0, 'h'},
         {0, 0, 0, 0}
     };
 
+    /* The profile is off and the whole scene is processed unless
+       requested */
+    *profile = false;
+    window->line0 = 0;
+    window->samp0 = 0;
+    window->nlines = 0;
+    window->nsamps = 0;
+    *mem_budget_mb = 0;
+
     /* Loop through all the cmd-line options */
     opterr = 0;   /* turn off getopt_long error msgs as we'll print our own */
     while (1)
@@ -99,6 +159,63 @@ short get_args
                 *sc_outfile = strdup (optarg);
                 break;
      
+            case 'm':  /* batch manifest */
+                *manifest = strdup (optarg);
+                break;
+     
+            case 'p':  /* profile, with an optional JSON file */
+                *profile = true;
+                if (optarg != NULL)
+                    *profile_file = strdup (optarg);
+                break;
+     
+            case 'w':  /* processing window */
+                if (sscanf (optarg, "%d,%d,%d,%d", &window->line0,
+                    &window->samp0, &window->nlines, &window->nsamps) != 4 ||
+                    window->line0 < 0 || window->samp0 < 0 ||
+                    window->nlines < 1 || window->nsamps < 1)
+                {
+                    sprintf (errmsg, "Window must be line0,samp0,nlines,"
+                        "nsamps with a starting line and sample of at least "
+                        "0 and a size of at least 1: %s", optarg);
+                    error_handler (true, FUNC_NAME, errmsg);
+                    usage ();
+                    return (ERROR);
+                }
+                break;
+     
+            case 'n':  /* number of threads */
+                *nthreads = atoi (optarg);
+                if (*nthreads < 1)
+                {
+                    sprintf (errmsg, "Number of threads must be at least 1: "
+                        "%s", optarg);
+                    error_handler (true, FUNC_NAME, errmsg);
+                    usage ();
+                    return (ERROR);
+                }
+                break;
+     
+            case 'c':  /* terrain cache directory */
+                *terrain_cache = strdup (optarg);
+                break;
+     
+            case 'o':  /* composite state file */
+                *composite = strdup (optarg);
+                break;
+     
+            case 'g':  /* memory budget */
+                *mem_budget_mb = atol (optarg);
+                if (*mem_budget_mb < 1)
+                {
+                    sprintf (errmsg, "Memory budget must be at least 1 "
+                        "megabyte: %s", optarg);
+                    error_handler (true, FUNC_NAME, errmsg);
+                    usage ();
+                    return (ERROR);
+                }
+                break;
+     
             case '?':
             default:
                 sprintf (errmsg, "Unknown option %s", argv[optind-1]);
@@ -109,8 +226,23 @@ short get_args
         }
     }
 
-    /* Make sure the infiles and outfiles were specified */
-    if (*toa_infile == NULL)
+    /* The batch manifest replaces the infiles and outfiles */
+    if (*manifest != NULL)
+    {
+        if (*toa_infile != NULL || *btemp_infile != NULL ||
+            *dem_infile != NULL || *sc_outfile != NULL)
+        {
+            sprintf (errmsg, "The input and output files can't be specified "
+                "along with the batch manifest");
+            error_handler (true, FUNC_NAME, errmsg);
+            usage ();
+            return (ERROR);
+        }
+    }
+
+    /* Make sure the infiles and outfiles were specified, unless the batch
+       manifest was */
+    if (*manifest == NULL && *toa_infile == NULL)
     {
         sprintf (errmsg, "TOA input file is a required argument");
         error_handler (true, FUNC_NAME, errmsg);
@@ -118,7 +250,7 @@ short get_args
         return (ERROR);
     }
 
-    if (*btemp_infile == NULL)
+    if (*manifest == NULL && *btemp_infile == NULL)
     {
         sprintf (errmsg, "Brightness temperature input file is a required "
             "argument");
@@ -127,7 +259,7 @@ short get_args
         return (ERROR);
     }
 
-    if (*dem_infile == NULL)
+    if (*manifest == NULL && *dem_infile == NULL)
     {
         sprintf (errmsg, "DEM input file is a required argument");
         error_handler (true, FUNC_NAME, errmsg);
@@ -135,7 +267,7 @@ short get_args
         return (ERROR);
     }
 
-    if (*sc_outfile == NULL)
+    if (*manifest == NULL && *sc_outfile == NULL)
     {
         sprintf (errmsg, "Snow cover output file is a required argument");
         error_handler (true, FUNC_NAME, errmsg);
@@ -143,10 +275,43 @@ short get_args
         return (ERROR);
     }
 
+    /* The raw binary masks are written for the whole processed area, so
+       they aren't supported for a window */
+    if (binary_flag && window->nlines > 0)
+    {
+        sprintf (errmsg, "Raw binary output isn't supported with a "
+            "processing window");
+        error_handler (true, FUNC_NAME, errmsg);
+        usage ();
+        return (ERROR);
+    }
+
+    /* The original post-processing of each pixel depends on all the lines
+       above it, so only the pre-pass post-processing gives the same values
+       in a window as for the whole scene */
+    if (!prepass_flag && window->nlines > 0)
+    {
+        sprintf (errmsg, "A processing window requires "
+            "--prepass_post_process");
+        error_handler (true, FUNC_NAME, errmsg);
+        usage ();
+        return (ERROR);
+    }
+
     /* Check the write binary flag */
     if (binary_flag)
         *write_binary = true;
 
+    /* Check the pre-pass post-processing flag */
+    *prepass_post = false;
+    if (prepass_flag)
+        *prepass_post = true;
+
+    /* Check the tiled output flag */
+    *tiled_output = false;
+    if (tiled_flag)
+        *tiled_output = true;
+
     /* Check the verbose flag */
     if (verbose_flag)
         *verbose = true;
@@ -53,6 +53,11 @@ Date        Programmer       Reason
 --------    ---------------  -------------------------------------
 1/2/2012    Gail Schmidt     Original Development (based on input routines
                              from the LEDAPS lndsr application)
+10/14/2026  agent            Allocate a second set of strip buffers for
+                             prefetching
+10/14/2026  agent            Initialize the window to the whole scene
+10/14/2026  agent            Allocate the strip buffers with
+                             set_input_strip_nlines
 
 NOTES:
   1. This routine opens the input TOA reflectance and brightness temperature
@@ -60,6 +65,8 @@ NOTES:
      input structure.  It is up to the caller to use close_input and
      free_input to close the HDF files and free up the memory when done
      using the input data structure.
+  2. The strip buffers hold PROC_NLINES lines until set_input_strip_nlines
+     is called with another number of lines.
 ******************************************************************************/
 Input_t *open_input
 (
@@ -79,8 +86,6 @@ Input_t *open_input
     Input_t *this = NULL;     /* input data structure to be initialized,
                                  populated, and returned to the caller */
     Myhdf_attr_t attr;        /* values for the SDS attributes */
-    int16 *buf = NULL;        /* temporary buffer to allocate memory for
-                                 the TOA reflectance bands */
   
     /* Create the Input data structure */
     this = (Input_t *) malloc (sizeof (Input_t));
@@ -155,12 +160,23 @@ Input_t *open_input
         this->refl_sds[ib].dim[0].name = NULL;
         this->refl_sds[ib].dim[1].name = NULL;
         this->refl_buf[ib] = NULL;
+        this->refl_next_buf[ib] = NULL;
     }
   
     this->btemp_sds.name = NULL;
     this->btemp_sds.dim[0].name = NULL;
     this->btemp_sds.dim[1].name = NULL;
     this->btemp_buf = NULL;
+    this->btemp_next_buf = NULL;
+    this->strip_buf = NULL;
+    this->span = NULL;
+    this->next_span = NULL;
+    this->span_buf = NULL;
+    this->nvalid_lines = 0;
+    this->next_nvalid_lines = 0;
+    this->proc_nlines = 0;
+    this->prefetch_active = false;
+    this->prefetch_status = SUCCESS;
   
     /* Loop through the image bands and obtain the SDS information */
     strcpy (errmsg, "none");
@@ -459,37 +475,19 @@ Input_t *open_input
     }
     this->btemp_saturate_val = (int) dval[0];
 
-    /* Allocate input buffers.  TOA reflectance buffer has multiple bands.
-       Thermal band has one band.  Allocate PROC_NLINES of data for each
-       band. */
-    buf = (int16 *) calloc (PROC_NLINES * this->nsamps * this->nrefl_band,
-        sizeof (int16));
-    if (buf == NULL)
+    /* Read the whole scene until a window is set */
+    this->scene_nlines = this->nlines;
+    this->scene_nsamps = this->nsamps;
+    this->line0 = 0;
+    this->samp0 = 0;
+
+    /* Allocate the input strip buffers */
+    if (set_input_strip_nlines (this, PROC_NLINES) != SUCCESS)
     {
         close_input (this);
         free_input (this);
         sprintf (errmsg, "Error allocating memory for input TOA reflectance "
-            "buffer containing %d lines.", PROC_NLINES);
-        error_handler (true, FUNC_NAME, errmsg);
-        return (NULL);
-    }
-    else
-    {
-        /* Set up the memory buffers for each band */
-        this->refl_buf[0] = buf;
-        for (ib = 1; ib < this->nrefl_band; ib++)
-            this->refl_buf[ib] = this->refl_buf[ib-1] +
-                PROC_NLINES * this->nsamps;
-    }
-  
-    this->btemp_buf = (int16 *) calloc (PROC_NLINES * this->nsamps,
-        sizeof (int16));
-    if (this->btemp_buf == NULL)
-    {
-        close_input (this);
-        free_input (this);
-        sprintf (errmsg, "Error allocating memory for input brightness temp "
-            "buffer containing %d lines.", PROC_NLINES);
+            "and brightness temp buffers containing %d lines.", PROC_NLINES);
         error_handler (true, FUNC_NAME, errmsg);
         return (NULL);
     }
@@ -514,6 +512,7 @@ Date        Programmer       Reason
 --------    ---------------  -------------------------------------
 1/2/2012    Gail Schmidt     Original Development (based on input routines
                              from the LEDAPS lndsr application)
+10/14/2026  agent            Wait for an outstanding prefetch before closing
 
 NOTES:
 ******************************************************************************/
@@ -524,6 +523,13 @@ void close_input
 {
     int ib;      /* loop counter for bands */
   
+    /* Wait for any outstanding prefetch, since it is still using the SDSs */
+    if (this->prefetch_active)
+    {
+        pthread_join (this->prefetch_thread, NULL);
+        this->prefetch_active = false;
+    }
+
     /* Close the TOA reflectance SDSs and HDF file */
     if (this->refl_open)
     {
@@ -618,10 +624,10 @@ void free_input
             free (this->btemp_sds.name);
   
         /* Free the data buffers */
-        if (this->refl_buf[0] != NULL)
-            free (this->refl_buf[0]);
-        if (this->btemp_buf != NULL)
-            free (this->btemp_buf);
+        if (this->strip_buf != NULL)
+            free (this->strip_buf);
+        if (this->span_buf != NULL)
+            free (this->span_buf);
   
         if (this->refl_file_name != NULL)
             free (this->refl_file_name);
@@ -634,6 +640,164 @@ void free_input
 }
 
 
+/******************************************************************************
+MODULE:  set_input_window
+
+PURPOSE:  Sets the window of the scene to be read.  The lines and samples
+passed to the read routines, and nlines and nsamps, are then relative to the
+window.
+
+RETURN VALUE:
+Type = int
+Value      Description
+-----      -----------
+ERROR      The window is not within the scene
+SUCCESS    Successful completion
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. The strip buffers are allocated for the whole width of the scene, so
+     they hold proc_nlines lines of any window.
+  2. This must be called before any lines are read or prefetched.
+******************************************************************************/
+int set_input_window
+(
+    Input_t *this,   /* I/O: pointer to input data structure */
+    Img_window_t *window  /* I: window of the scene to be read */
+)
+{
+    char FUNC_NAME[] = "set_input_window";   /* function name */
+    char errmsg[STR_SIZE];    /* error message */
+
+    if (window->line0 < 0 || window->samp0 < 0 || window->nlines < 1 ||
+        window->nsamps < 1 ||
+        window->line0 + window->nlines > this->scene_nlines ||
+        window->samp0 + window->nsamps > this->scene_nsamps)
+    {
+        sprintf (errmsg, "Window of %d lines and %d samples starting at line "
+            "%d, sample %d is not within the %d lines and %d samples of the "
+            "scene", window->nlines, window->nsamps, window->line0,
+            window->samp0, this->scene_nlines, this->scene_nsamps);
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+
+    this->line0 = window->line0;
+    this->samp0 = window->samp0;
+    this->nlines = window->nlines;
+    this->nsamps = window->nsamps;
+
+    return (SUCCESS);
+}
+
+
+/******************************************************************************
+MODULE:  set_input_strip_nlines
+
+PURPOSE:  Allocates the strip buffers to hold proc_nlines lines, replacing
+the strip buffers already allocated.
+
+RETURN VALUE:
+Type = int
+Value      Description
+-----      -----------
+ERROR      Error allocating the strip buffers
+SUCCESS    Successful completion
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development (pulled from open_input)
+10/14/2026    agent            Don't clear the buffers to 0s
+10/14/2026    agent            Allocate the valid spans of the strip lines
+
+NOTES:
+  1. TOA reflectance buffer has multiple bands.  Thermal band has one band.
+     There are two sets of buffers so the next strip can be read while the
+     current strip is processed, and two sets of valid spans to go with
+     them.
+  2. The buffers are allocated for the whole width of the scene.  If the
+     allocation fails, the previous buffers are kept.
+  3. This must not be called while a prefetch is active.
+  4. The buffers are not cleared to 0s, since the lines of each strip are
+     read into them before they are used.
+******************************************************************************/
+int set_input_strip_nlines
+(
+    Input_t *this,   /* I/O: pointer to input data structure */
+    int proc_nlines  /* I: number of lines in each strip buffer */
+)
+{
+    char FUNC_NAME[] = "set_input_strip_nlines";   /* function name */
+    char errmsg[STR_SIZE];    /* error message */
+    int ib;                   /* loop counter for bands */
+    size_t strip_size;        /* number of pixels in each strip buffer */
+    int16 *buf = NULL;        /* memory block for the strip buffers */
+    Valid_span_t *span_buf = NULL;  /* memory block for the valid spans */
+
+    if (this->prefetch_active)
+    {
+        strcpy (errmsg, "A prefetch is active");
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+    if (proc_nlines < 1)
+    {
+        sprintf (errmsg, "Invalid number of strip lines: %d", proc_nlines);
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+
+    strip_size = (size_t) proc_nlines * this->scene_nsamps;
+    buf = (int16 *) malloc (2 * strip_size * (this->nrefl_band + 1) *
+        sizeof (int16));
+    span_buf = (Valid_span_t *) malloc (2 * proc_nlines *
+        sizeof (Valid_span_t));
+    if (buf == NULL || span_buf == NULL)
+    {
+        free (buf);
+        free (span_buf);
+        sprintf (errmsg, "Error allocating memory for the strip buffers "
+            "containing %d lines", proc_nlines);
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+
+    /* Set up the memory buffers for each band */
+    free (this->strip_buf);
+    this->strip_buf = buf;
+    free (this->span_buf);
+    this->span_buf = span_buf;
+    this->span = span_buf;
+    this->next_span = &span_buf[proc_nlines];
+    this->nvalid_lines = 0;
+    this->next_nvalid_lines = 0;
+    this->proc_nlines = proc_nlines;
+    for (ib = 0; ib < this->nrefl_band; ib++)
+    {
+        this->refl_buf[ib] = buf;
+        buf += strip_size;
+        this->refl_next_buf[ib] = buf;
+        buf += strip_size;
+    }
+    this->btemp_buf = buf;
+    buf += strip_size;
+    this->btemp_next_buf = buf;
+
+    return (SUCCESS);
+}
+
+
 /******************************************************************************
 MODULE:  get_input_refl_lines
 
@@ -701,8 +865,8 @@ int get_input_refl_lines
     }
   
     /* Read the data */
-    start[0] = iline;    /* line to start reading */
-    start[1] = 0;        /* sample to start reading */
+    start[0] = this->line0 + iline;  /* line to start reading */
+    start[1] = this->samp0;          /* sample to start reading */
     nval[0] = nlines;         /* number of lines to read */
     nval[1] = this->nsamps;   /* number of samples to read */
     buf = (void *) this->refl_buf[iband];
@@ -780,8 +944,8 @@ int get_input_btemp_lines
     }
 
     /* Read the data */
-    start[0] = iline;    /* line to start reading */
-    start[1] = 0;        /* sample to start reading */
+    start[0] = this->line0 + iline;  /* line to start reading */
+    start[1] = this->samp0;          /* sample to start reading */
     nval[0] = nlines;         /* number of lines to read */
     nval[1] = this->nsamps;   /* number of samples to read */
     buf = (void *)this->btemp_buf;
@@ -798,6 +962,322 @@ int get_input_btemp_lines
 }
 
 
+/******************************************************************************
+MODULE:  find_valid_spans (static)
+
+PURPOSE:  Finds the valid span of each line in the strip being prefetched,
+outside of which the pixels are fill in every band.
+
+RETURN VALUE:
+Type = int
+Value      Description
+-----      -----------
+nvalid     Number of lines which aren't all fill
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. The search stops at the first pixel from each end of the line which
+     isn't fill in some band, so only the fill corners of the scene and a
+     few pixels of the footprint are looked at.
+******************************************************************************/
+static int find_valid_spans
+(
+    Input_t *this    /* I/O: pointer to input data structure; next_span is
+                             filled in for the strip in the next buffers */
+)
+{
+    int ib;                   /* loop counter for bands */
+    int line;                 /* current line of the strip */
+    int start, end;           /* valid span of the current line */
+    int nvalid = 0;           /* number of lines which aren't all fill */
+    long pix;                 /* first pixel of the current line */
+    bool fill_pix;            /* is the current pixel fill in every band? */
+
+    for (line = 0; line < this->prefetch_nlines; line++)
+    {
+        pix = (long) line * this->nsamps;
+
+        /* Find the first and last pixels which aren't fill in some band */
+        for (start = 0; start < this->nsamps; start++)
+        {
+            fill_pix = (this->btemp_next_buf[pix + start] == this->btemp_fill);
+            for (ib = 0; ib < this->nrefl_band && fill_pix; ib++)
+                fill_pix = (this->refl_next_buf[ib][pix + start] ==
+                    this->refl_fill);
+            if (!fill_pix)
+                break;
+        }
+        for (end = this->nsamps; end > start; end--)
+        {
+            fill_pix = (this->btemp_next_buf[pix + end - 1] ==
+                this->btemp_fill);
+            for (ib = 0; ib < this->nrefl_band && fill_pix; ib++)
+                fill_pix = (this->refl_next_buf[ib][pix + end - 1] ==
+                    this->refl_fill);
+            if (!fill_pix)
+                break;
+        }
+
+        this->next_span[line].start = start;
+        this->next_span[line].end = end;
+        if (start < end)
+            nvalid++;
+    }
+
+    return (nvalid);
+}
+
+
+/******************************************************************************
+MODULE:  read_next_strip (static)
+
+PURPOSE:  Thread routine to read the TOA reflectance and brightness temp data
+for the strip being prefetched into the second set of strip buffers.
+
+RETURN VALUE:
+Type = void *
+Value      Description
+-----      -----------
+NULL       Always returned; the status is stored in prefetch_status
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+10/14/2026    agent            Find the valid spans of the strip lines
+
+NOTES:
+  1. The HDF library is not thread-safe.  The caller may not make any other
+     HDF calls while the prefetch thread is active.
+  2. The valid spans are found here so the search overlaps the processing
+     of the current strip.
+******************************************************************************/
+static void *read_next_strip
+(
+    void *arg        /* I: pointer to input data structure */
+)
+{
+    char FUNC_NAME[] = "read_next_strip";   /* function name */
+    char errmsg[STR_SIZE];    /* error message */
+    Input_t *this = (Input_t *) arg;  /* input data structure */
+    int ib;                   /* loop counter for bands */
+    int32 start[2];           /* array of starting line/samp for reading */
+    int32 nval[2];            /* array of number of lines/samps to be read */
+
+    start[0] = this->line0 + this->prefetch_line;  /* line to start
+                                                      reading */
+    start[1] = this->samp0;             /* sample to start reading */
+    nval[0] = this->prefetch_nlines;    /* number of lines to read */
+    nval[1] = this->nsamps;             /* number of samples to read */
+
+    /* Read the TOA reflectance bands */
+    for (ib = 0; ib < this->nrefl_band; ib++)
+    {
+        if (SDreaddata (this->refl_sds[ib].id, start, NULL, nval,
+            (void *) this->refl_next_buf[ib]) == HDF_ERROR)
+        {
+            sprintf (errmsg, "Error reading %d lines from TOA reflectance "
+                "band %d starting at line %d", this->prefetch_nlines, ib,
+                this->prefetch_line);
+            error_handler (true, FUNC_NAME, errmsg);
+            this->prefetch_status = ERROR;
+            return (NULL);
+        }
+    }
+
+    /* Read the brightness temp band */
+    if (SDreaddata (this->btemp_sds.id, start, NULL, nval,
+        (void *) this->btemp_next_buf) == HDF_ERROR)
+    {
+        sprintf (errmsg, "Error reading %d lines from brightness temperature "
+            "band starting at line %d", this->prefetch_nlines,
+            this->prefetch_line);
+        error_handler (true, FUNC_NAME, errmsg);
+        this->prefetch_status = ERROR;
+        return (NULL);
+    }
+
+    /* Find the part of each line which isn't fill in every band */
+    this->next_nvalid_lines = find_valid_spans (this);
+
+    this->prefetch_status = SUCCESS;
+    return (NULL);
+}
+
+
+/******************************************************************************
+MODULE:  start_input_prefetch
+
+PURPOSE:  Starts a thread to read the TOA reflectance and brightness temp data
+for the specified lines into the second set of strip buffers, so the current
+strip can be processed while the next strip is being read.
+
+RETURN VALUE:
+Type = int
+Value      Description
+-----      -----------
+ERROR      Error occurred starting the prefetch
+SUCCESS    Successful completion
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. The Input_t data structure needs to be populated and memory allocated
+     before calling this routine.  Use open_input to do do.
+  2. Use finish_input_prefetch to wait for the data, after which it is
+     available in refl_buf and btemp_buf.  Only one prefetch may be active
+     at a time, and no other input routines may be called while it is
+     active.
+******************************************************************************/
+int start_input_prefetch
+(
+    Input_t *this,   /* I: pointer to input data structure */
+    int iline,       /* I: first line to read (0-based) */
+    int nlines       /* I: number of lines to read */
+)
+{
+    char FUNC_NAME[] = "start_input_prefetch";   /* function name */
+    char errmsg[STR_SIZE];    /* error message */
+
+    /* Check the parameters */
+    if (this == (Input_t *) NULL) 
+    {
+        strcpy (errmsg, "Input structure has not been opened/initialized");
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+    if (!this->refl_open || !this->btemp_open)
+    {
+        strcpy (errmsg, "TOA reflectance and brightness temperature files "
+            "have not been opened");
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+    if (this->prefetch_active)
+    {
+        strcpy (errmsg, "A prefetch is already active");
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+    if (iline < 0 || iline >= this->nlines || nlines < 1 ||
+        nlines > this->proc_nlines || iline + nlines > this->nlines)
+    {
+        sprintf (errmsg, "Invalid lines to prefetch: %d lines starting at "
+            "line %d", nlines, iline);
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+
+    /* Start the thread to read the strip */
+    this->prefetch_line = iline;
+    this->prefetch_nlines = nlines;
+    this->prefetch_status = SUCCESS;
+    if (pthread_create (&this->prefetch_thread, NULL, read_next_strip,
+        (void *) this) != 0)
+    {
+        strcpy (errmsg, "Error creating the prefetch thread");
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+    this->prefetch_active = true;
+
+    return (SUCCESS);
+}
+
+
+/******************************************************************************
+MODULE:  finish_input_prefetch
+
+PURPOSE:  Waits for the active prefetch to complete, then swaps the strip
+buffers so the prefetched data is available in refl_buf and btemp_buf, and
+its valid spans in span.
+
+RETURN VALUE:
+Type = int
+Value      Description
+-----      -----------
+ERROR      Error occurred reading the prefetched data
+SUCCESS    Successful completion
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+10/14/2026    agent            Swap the valid spans with the buffers
+
+NOTES:
+  1. The previous contents of refl_buf and btemp_buf become the buffers for
+     the next prefetch, so they must no longer be in use by the caller when
+     the next prefetch is started.
+******************************************************************************/
+int finish_input_prefetch
+(
+    Input_t *this    /* I: pointer to input data structure */
+)
+{
+    char FUNC_NAME[] = "finish_input_prefetch";   /* function name */
+    char errmsg[STR_SIZE];    /* error message */
+    int ib;                   /* loop counter for bands */
+    int16 *tmp_buf = NULL;    /* temporary pointer for swapping the buffers */
+    Valid_span_t *tmp_span = NULL;  /* temporary pointer for swapping the
+                                       spans */
+
+    if (this == (Input_t *) NULL || !this->prefetch_active) 
+    {
+        strcpy (errmsg, "No prefetch is active");
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+
+    /* Wait for the thread to finish reading */
+    pthread_join (this->prefetch_thread, NULL);
+    this->prefetch_active = false;
+    if (this->prefetch_status != SUCCESS)
+    {
+        sprintf (errmsg, "Error prefetching %d lines starting at line %d",
+            this->prefetch_nlines, this->prefetch_line);
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+
+    /* Swap the current and next strip buffers */
+    for (ib = 0; ib < this->nrefl_band; ib++)
+    {
+        tmp_buf = this->refl_buf[ib];
+        this->refl_buf[ib] = this->refl_next_buf[ib];
+        this->refl_next_buf[ib] = tmp_buf;
+    }
+    tmp_buf = this->btemp_buf;
+    this->btemp_buf = this->btemp_next_buf;
+    this->btemp_next_buf = tmp_buf;
+    tmp_span = this->span;
+    this->span = this->next_span;
+    this->next_span = tmp_span;
+    this->nvalid_lines = this->next_nvalid_lines;
+
+    return (SUCCESS);
+}
+
+
 /******************************************************************************
 MODULE:  get_input_meta
 
@@ -819,6 +1299,8 @@ Date        Programmer       Reason
 1/2/2012    Gail Schmidt     Original Development (based on input routines
                              from the LEDAPS lndsr application)
 3/22/2013   Gail Schmidt     Modified to read the UL and LR lat/long coords
+10/14/2026  agent            Moved the bounding coordinates to
+                             get_input_bounds
 
 NOTES:
 ******************************************************************************/
@@ -1128,7 +1610,99 @@ int get_input_meta
     meta->lr_corner.lat = dval[0];
     meta->lr_corner.lon = dval[1];
 
-    /* Get the bounding coordinates if they are available */
+    /* The bounding coordinates are only read when they are needed (see
+       get_input_bounds) */
+    meta->bounds.is_fill = true;
+
+    /* Check WRS path/rows */
+    if (!strcmp (meta->wrs_sys, "1"))
+    {
+        if (meta->path > N_LSAT_WRS1_PATHS)
+        {
+            strcpy (errmsg, "WRS path number out of range for WRS system 1");
+            error_handler (true, FUNC_NAME, errmsg);
+            return (ERROR);
+        }
+        else if (meta->row > N_LSAT_WRS1_ROWS)
+        {
+            strcpy (errmsg, "WRS row number out of range for WRS system 1");
+            error_handler (true, FUNC_NAME, errmsg);
+            return (ERROR);
+        }
+    }
+    else if (!strcmp (meta->wrs_sys, "2"))
+    {
+        if (meta->path > N_LSAT_WRS2_PATHS)
+        {
+            strcpy (errmsg, "WRS path number out of range for WRS system 2");
+            error_handler (true, FUNC_NAME, errmsg);
+            return (ERROR);
+        }
+        else if (meta->row > N_LSAT_WRS2_ROWS)
+        {
+            strcpy (errmsg, "WRS row number out of range for WRS system 2");
+            error_handler (true, FUNC_NAME, errmsg);
+            return (ERROR);
+        }
+    }
+    else
+    {
+        strcpy (errmsg, "Invalid WRS system");
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+
+    return (SUCCESS);
+}
+
+
+/******************************************************************************
+MODULE:  get_input_bounds
+
+PURPOSE:  Reads the geographic bounding coordinates of the scene from the
+input file.
+
+RETURN VALUE:
+Type = int
+Value      Description
+-----      -----------
+ERROR      The input file is not open
+SUCCESS    Successful completion
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date        Programmer       Reason
+--------    ---------------  -------------------------------------
+10/14/2026  agent            Original Development (pulled from
+                             get_input_meta)
+
+NOTES:
+  1. The bounds are only written to the output metadata for the whole
+     scene, so they are read when the metadata is written rather than when
+     the file is opened.  Until then, and if any of them can't be read,
+     bounds.is_fill is true.
+******************************************************************************/
+int get_input_bounds
+(
+    Input_t *this    /* I/O: pointer to input data structure */
+)
+{
+    char FUNC_NAME[] = "get_input_bounds";   /* function name */
+    char errmsg[STR_SIZE];        /* error message */
+    Myhdf_attr_t attr;            /* HDF info for the current attribute */
+    double dval[NBAND_REFL_MAX];  /* double value read */
+    Input_meta_t *meta = &this->meta;  /* global metadata of the input */
+
+    /* Check the parameters */
+    if (!this->refl_open)
+    {
+        strcpy (errmsg, "TOA reflectance file is not open");
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+
     meta->bounds.is_fill = false;
     attr.type = DFNT_FLOAT32;
     attr.nval = 1;
@@ -1213,49 +1787,6 @@ int get_input_meta
         meta->bounds.is_fill = true;
     }
     meta->bounds.min_lat = dval[0];
-printf ("DEBUG: Bounding coords:\n");
-printf ("DEBUG:   West - %f\n", meta->bounds.min_lon);
-printf ("DEBUG:   East - %f\n", meta->bounds.max_lon);
-printf ("DEBUG:   North - %f\n", meta->bounds.max_lat);
-printf ("DEBUG:   South - %f\n", meta->bounds.min_lat);
-
-    /* Check WRS path/rows */
-    if (!strcmp (meta->wrs_sys, "1"))
-    {
-        if (meta->path > N_LSAT_WRS1_PATHS)
-        {
-            strcpy (errmsg, "WRS path number out of range for WRS system 1");
-            error_handler (true, FUNC_NAME, errmsg);
-            return (ERROR);
-        }
-        else if (meta->row > N_LSAT_WRS1_ROWS)
-        {
-            strcpy (errmsg, "WRS row number out of range for WRS system 1");
-            error_handler (true, FUNC_NAME, errmsg);
-            return (ERROR);
-        }
-    }
-    else if (!strcmp (meta->wrs_sys, "2"))
-    {
-        if (meta->path > N_LSAT_WRS2_PATHS)
-        {
-            strcpy (errmsg, "WRS path number out of range for WRS system 2");
-            error_handler (true, FUNC_NAME, errmsg);
-            return (ERROR);
-        }
-        else if (meta->row > N_LSAT_WRS2_ROWS)
-        {
-            strcpy (errmsg, "WRS row number out of range for WRS system 2");
-            error_handler (true, FUNC_NAME, errmsg);
-            return (ERROR);
-        }
-    }
-    else
-    {
-        strcpy (errmsg, "Invalid WRS system");
-        error_handler (true, FUNC_NAME, errmsg);
-        return (ERROR);
-    }
 
     return (SUCCESS);
 }
@@ -5,6 +5,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#include <pthread.h>
 #include "bool.h"
 #include "mystring.h"
 #include "myhdf.h"
@@ -31,13 +32,34 @@
 #define NBAND_REFL_MAX 6
 
 /* How many lines of TOA reflectance and brightness temperature data should be
-   processed at one time */
+   processed at one time, unless the strip height is picked from the memory
+   budget (see --mem_budget_mb) */
 #define PROC_NLINES 100
 
+/* Smallest strip height picked from the memory budget */
+#define MIN_PROC_NLINES 16
+
 /* How many lines of DEM data should be processed at one time, multiple of 3
    since the shade relief input needs to be a factor of 3. */
 #define DEM_PROC_NLINES 300
 
+/* Window of the scene, in the lines and samples of the scene */
+typedef struct {
+    int line0;               /* first line of the window */
+    int samp0;               /* first sample of the window */
+    int nlines;              /* number of lines in the window */
+    int nsamps;              /* number of samples in the window */
+} Img_window_t;
+
+/* Valid span of a line: the samples outside of it are fill in every band,
+   which is the case for the corners of the tilted Landsat footprint */
+typedef struct {
+    int start;               /* first sample which isn't fill in every band */
+    int end;                 /* sample after the last one which isn't fill in
+                                every band; start == end if the whole line
+                                is fill */
+} Valid_span_t;
+
 /* Structure for bounding geographic coords */
 typedef struct {
   double min_lon;  /* Geodetic longitude coordinate (degrees) */ 
@@ -87,15 +109,45 @@ typedef struct {
     int nbtemp_band;         /* number of input brightness temp bands */
     int nlines;              /* number of input lines */
     int nsamps;              /* number of input samples */
+    int scene_nlines;        /* number of lines in the input files; nlines is
+                                smaller when a window is processed */
+    int scene_nsamps;        /* number of samples in the input files */
+    int line0;               /* first line of the files which is read as
+                                line 0 (see set_input_window) */
+    int samp0;               /* first sample of the files which is read as
+                                sample 0 */
     int32 refl_sds_file_id;  /* SDS file id for TOA reflectance */
     int32 btemp_sds_file_id; /* SDS file id for brightness temp */
     Myhdf_sds_t refl_sds[NBAND_REFL_MAX]; /* SDS data structures for TOA
                                 reflectance data */
     int16 *refl_buf[NBAND_REFL_MAX]; /* input data buffer for unscaled TOA
-                                reflectance data (PROC_NLINES lines of data) */
+                                reflectance data (proc_nlines lines of data) */
     Myhdf_sds_t btemp_sds;   /* SDS data structure for brightness temp data */
     int16 *btemp_buf;        /* input data buffer for unscaled brightness temp
-                                data (PROC_NLINES lines of thermal data) */
+                                data (proc_nlines lines of thermal data) */
+    int16 *refl_next_buf[NBAND_REFL_MAX]; /* second set of TOA reflectance
+                                buffers, filled by the prefetch thread while
+                                refl_buf is being processed */
+    int16 *btemp_next_buf;   /* second brightness temp buffer, filled by the
+                                prefetch thread while btemp_buf is being
+                                processed */
+    int16 *strip_buf;        /* memory block holding all of the strip buffers
+                                above */
+    Valid_span_t *span;      /* valid span of each line in refl_buf and
+                                btemp_buf, found by the prefetch thread */
+    Valid_span_t *next_span; /* valid span of each line in the strip being
+                                prefetched */
+    Valid_span_t *span_buf;  /* memory block holding both sets of spans */
+    int nvalid_lines;        /* number of lines in refl_buf and btemp_buf
+                                which aren't all fill */
+    int next_nvalid_lines;   /* number of lines in the strip being prefetched
+                                which aren't all fill */
+    int proc_nlines;         /* number of lines held in each strip buffer */
+    bool prefetch_active;    /* is the prefetch thread running? */
+    pthread_t prefetch_thread;  /* thread reading the next strip */
+    int prefetch_line;       /* first line of the strip being prefetched */
+    int prefetch_nlines;     /* number of lines being prefetched */
+    int prefetch_status;     /* return status of the prefetch thread */
     int refl_fill;           /* fill value for TOA reflectance bands */
     int btemp_fill;          /* fill value for brightness temperature band */
     float refl_scale_fact;   /* scale factor for TOA reflectance bands */
@@ -121,6 +173,18 @@ void free_input
     Input_t *this    /* I: pointer to input data structure */
 );
 
+int set_input_window
+(
+    Input_t *this,   /* I/O: pointer to input data structure */
+    Img_window_t *window  /* I: window of the scene to be read */
+);
+
+int set_input_strip_nlines
+(
+    Input_t *this,   /* I/O: pointer to input data structure */
+    int proc_nlines  /* I: number of lines in each strip buffer */
+);
+
 int get_input_refl_lines
 (
     Input_t *this,   /* I: pointer to input data structure */
@@ -136,9 +200,26 @@ int get_input_btemp_lines
     int nlines       /* I: number of lines to read */
 );
 
+int start_input_prefetch
+(
+    Input_t *this,   /* I: pointer to input data structure */
+    int iline,       /* I: first line to read (0-based) */
+    int nlines       /* I: number of lines to read */
+);
+
+int finish_input_prefetch
+(
+    Input_t *this    /* I: pointer to input data structure */
+);
+
 int get_input_meta
 (
     Input_t *this    /* I: pointer to input data structure */
 );
 
+int get_input_bounds
+(
+    Input_t *this    /* I/O: pointer to input data structure */
+);
+
 #endif
@@ -0,0 +1,451 @@
+#include "sca.h"
+
+/******************************************************************************
+MODULE:  alloc_mask_buffer
+
+PURPOSE:  Carves the rolling mask buffers, holding a strip of proc_nlines
+lines plus the lines kept from the previous strip, from the arena.
+
+RETURN VALUE:
+Type = int
+Value      Description
+-----      -----------
+ERROR      Error allocating the buffers
+SUCCESS    Successful completion
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+10/14/2026    agent            Take the strip height as a parameter
+10/14/2026    agent            Carve the buffers from the scene arena
+
+NOTES:
+  1. The buffers are initialized to 0s, and the lines are cleared to 0s
+     again when they are released by shift_mask_buffer, since the masks are
+     only set when the mask is turned on.
+  2. The packed masks have the same lines as the other masks.
+  3. The arena must have room for MASK_BUF_ARENA_SIZE (nsamps, proc_nlines)
+     bytes.  The buffers are released with the arena.
+******************************************************************************/
+int alloc_mask_buffer
+(
+    int nsamps,          /* I: number of samples in each line */
+    int proc_nlines,     /* I: number of lines in each strip */
+    Arena_t *arena,      /* I/O: arena to carve the buffers from */
+    Mask_buffer_t *mb    /* O: mask buffer to be allocated */
+)
+{
+    char FUNC_NAME[] = "alloc_mask_buffer";   /* function name */
+    char errmsg[STR_SIZE];    /* error message */
+    int ib;                   /* loop counter for the masks */
+    long mask_size;           /* number of values in each mask */
+    long bits_size;           /* number of words in each packed mask */
+    uint8 *buf = NULL;        /* memory block for all of the masks */
+    Bit_word_t *bits = NULL;  /* memory block for all of the packed masks */
+
+    mb->nsamps = nsamps;
+    mb->nwords = BIT_MASK_NWORDS (nsamps);
+    mb->max_lines = proc_nlines + MASK_BUF_EXTRA_NLINES;
+    mb->first_line = 0;
+    mb->nlines = 0;
+    mask_size = (long) mb->max_lines * nsamps;
+    bits_size = (long) mb->max_lines * mb->nwords;
+
+    buf = (uint8 *) carve_arena (arena, MB_NUM * mask_size * sizeof (uint8),
+        true);
+    bits = (Bit_word_t *) carve_arena (arena, MBB_NUM * bits_size *
+        sizeof (Bit_word_t), true);
+    if (buf == NULL || bits == NULL)
+    {
+        sprintf (errmsg, "Error allocating memory for the mask buffers "
+            "containing %d lines.", mb->max_lines);
+        error_handler (true, FUNC_NAME, errmsg);
+        free_mask_buffer (mb);
+        return (ERROR);
+    }
+
+    for (ib = 0; ib < MB_NUM; ib++)
+        mb->mask[ib] = buf + ib * mask_size;
+    for (ib = 0; ib < MBB_NUM; ib++)
+        mb->bits[ib] = bits + ib * bits_size;
+
+    return (SUCCESS);
+}
+
+
+/******************************************************************************
+MODULE:  free_mask_buffer
+
+PURPOSE:  Releases the rolling mask buffers.
+
+RETURN VALUE:
+Type = None
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+10/14/2026    agent            The memory is owned by the scene arena
+
+NOTES:
+  1. The memory is freed with the arena the buffers were carved from.
+******************************************************************************/
+void free_mask_buffer
+(
+    Mask_buffer_t *mb    /* I/O: mask buffer to be freed */
+)
+{
+    int ib;                   /* loop counter for the masks */
+
+    for (ib = 0; ib < MB_NUM; ib++)
+        mb->mask[ib] = NULL;
+    for (ib = 0; ib < MBB_NUM; ib++)
+        mb->bits[ib] = NULL;
+    mb->nlines = 0;
+}
+
+
+/******************************************************************************
+MODULE:  shift_mask_buffer
+
+PURPOSE:  Releases the lines before keep_line from the rolling mask buffers
+by moving the remaining lines to the start of the buffers, so the next strip
+can be appended after them.
+
+RETURN VALUE:
+Type = None
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. At most MASK_BUF_EXTRA_NLINES lines are kept between strips, so moving
+     them is cheap compared to processing the strip.
+  2. The released lines are cleared to 0s.
+******************************************************************************/
+void shift_mask_buffer
+(
+    int keep_line,       /* I: first line in the scene to keep */
+    Mask_buffer_t *mb    /* I/O: mask buffer to be shifted */
+)
+{
+    int ib;                   /* loop counter for the masks */
+    int nskip;                /* number of lines being released */
+    int nkeep;                /* number of lines being kept */
+    long line_size;           /* number of values in a line */
+    long line_words;          /* number of words in a packed line */
+
+    nskip = keep_line - mb->first_line;
+    if (nskip <= 0)
+        return;
+    if (nskip > mb->nlines)
+        nskip = mb->nlines;
+    nkeep = mb->nlines - nskip;
+    line_size = mb->nsamps;
+    line_words = mb->nwords;
+
+    for (ib = 0; ib < MB_NUM; ib++)
+    {
+        if (nkeep > 0)
+            memmove (mb->mask[ib], &mb->mask[ib][nskip * line_size],
+                nkeep * line_size * sizeof (uint8));
+        memset (&mb->mask[ib][nkeep * line_size], 0,
+            nskip * line_size * sizeof (uint8));
+    }
+
+    for (ib = 0; ib < MBB_NUM; ib++)
+    {
+        if (nkeep > 0)
+            memmove (mb->bits[ib], &mb->bits[ib][nskip * line_words],
+                nkeep * line_words * sizeof (Bit_word_t));
+        memset (&mb->bits[ib][nkeep * line_words], 0,
+            nskip * line_words * sizeof (Bit_word_t));
+    }
+
+    mb->first_line += nskip;
+    mb->nlines = nkeep;
+}
+
+
+/******************************************************************************
+MODULE:  put_mask_buffer_lines
+
+PURPOSE:  Writes the specified lines of the output masks from the rolling
+mask buffers to the output HDF file, and of any of the masks with a raw
+binary file to the raw binary writer.
+
+RETURN VALUE:
+Type = int
+Value      Description
+-----      -----------
+ERROR      Error writing the lines
+SUCCESS    Successful completion
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+10/14/2026    agent            Queue the raw binary lines to the writer thread
+
+NOTES:
+  1. The lines must be held in the buffers and must be final.
+  2. The lines must be written in order, since the raw binary files are
+     written sequentially.  The lines are copied by queue_bin_write, so the
+     buffers may be shifted as soon as this returns.
+  3. The packed combined QA mask is expanded into mask[MB_COMBINED_QA] for
+     the lines being written.
+  4. When a window is processed with a halo, only the part of the lines in
+     the output image (see output->offset) is written to the HDF file.  The
+     raw binary files get the whole lines.
+******************************************************************************/
+int put_mask_buffer_lines
+(
+    Mask_buffer_t *mb,   /* I: mask buffer */
+    Output_t *output,    /* I: output data structure */
+    Bin_writer_t *bin_writer,  /* I/O: raw binary writer; NULL if no raw
+                               binary output is written */
+    int *bin_file,       /* I: raw binary file of each mask in bin_writer
+                               (-1 if the mask is not written to raw binary) */
+    int iline,           /* I: first line in the scene to be written */
+    int nlines           /* I: number of lines to be written */
+)
+{
+    char FUNC_NAME[] = "put_mask_buffer_lines";   /* function name */
+    char errmsg[STR_SIZE];    /* error message */
+    int ib;                   /* loop counter for the output bands */
+    int line;                 /* loop counter for the lines */
+    int out_start;            /* first line written to the output image */
+    int out_end;              /* line after the last line written to the
+                                 output image */
+    long offset;              /* location of iline in the buffers */
+
+    if (nlines <= 0)
+        return (SUCCESS);
+    if (iline < mb->first_line ||
+        iline + nlines > mb->first_line + mb->nlines)
+    {
+        sprintf (errmsg, "Lines %d to %d are not held in the mask buffers",
+            iline, iline + nlines - 1);
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+
+    /* Expand the combined QA mask for the lines */
+    for (line = iline - mb->first_line;
+         line < iline - mb->first_line + nlines; line++)
+    {
+        expand_mask_line (&mb->bits[MBB_COMBINED_QA][(long) line *
+            mb->nwords], mb->nsamps, COMBINED_MASK,
+            &mb->mask[MB_COMBINED_QA][(long) line * mb->nsamps]);
+    }
+
+    /* Write the lines in the output image.  Whole lines are written
+       together, while the lines of a narrower window are written one at a
+       time from their first sample in the window. */
+    out_start = (iline > output->offset.l) ? iline : output->offset.l;
+    out_end = (iline + nlines < output->offset.l + output->size.l) ?
+        iline + nlines : output->offset.l + output->size.l;
+    for (ib = 0; ib < NUM_OUT_SDS && out_start < out_end; ib++)
+    {
+        if (output->offset.s == 0 && output->size.s == mb->nsamps)
+        {
+            output->buf[ib] = &mb->mask[ib][(long) (out_start -
+                mb->first_line) * mb->nsamps];
+            if (put_output_line (output, ib, out_start - output->offset.l,
+                out_end - out_start) != SUCCESS)
+            {
+                sprintf (errmsg, "Writing output data to HDF for band %d",
+                    ib);
+                error_handler (true, FUNC_NAME, errmsg);
+                return (ERROR);
+            }
+            continue;
+        }
+
+        for (line = out_start; line < out_end; line++)
+        {
+            output->buf[ib] = &mb->mask[ib][(long) (line - mb->first_line) *
+                mb->nsamps + output->offset.s];
+            if (put_output_line (output, ib, line - output->offset.l, 1)
+                != SUCCESS)
+            {
+                sprintf (errmsg, "Writing output data to HDF for band %d",
+                    ib);
+                error_handler (true, FUNC_NAME, errmsg);
+                return (ERROR);
+            }
+        }
+    }
+
+    offset = (long) (iline - mb->first_line) * mb->nsamps;
+
+    for (ib = 0; ib < MB_NUM && bin_writer != NULL; ib++)
+    {
+        if (bin_file[ib] < 0)
+            continue;
+        if (queue_bin_write (bin_writer, bin_file[ib], &mb->mask[ib][offset],
+            (size_t) nlines * mb->nsamps * sizeof (uint8)) != SUCCESS)
+        {
+            sprintf (errmsg, "Writing raw binary output data for mask %d", ib);
+            error_handler (true, FUNC_NAME, errmsg);
+            return (ERROR);
+        }
+    }
+
+    return (SUCCESS);
+}
+
+
+/******************************************************************************
+MODULE:  init_scene_buffers
+
+PURPOSE:  Initializes the scene buffers so they hold no memory.
+
+RETURN VALUE:
+Type = None
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+******************************************************************************/
+void init_scene_buffers
+(
+    Scene_buffers_t *sb  /* O: scene buffers to be initialized */
+)
+{
+    memset (sb, 0, sizeof (Scene_buffers_t));
+    init_arena (&sb->arena);
+}
+
+
+/******************************************************************************
+MODULE:  alloc_scene_buffers
+
+PURPOSE:  Sets up the scene buffers for a scene with nsamps samples per line,
+processed in strips of proc_nlines lines.  All of the buffers are carved from
+the scene arena, which is reused from the previous scenes if it is large
+enough, otherwise it is reallocated.
+
+RETURN VALUE:
+Type = int
+Value      Description
+-----      -----------
+ERROR      Error allocating the buffers
+SUCCESS    Successful completion
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+10/14/2026    agent            Take the strip height as a parameter
+10/14/2026    agent            Carve the buffers from one arena
+
+NOTES:
+  1. The mask buffers are cleared to 0s.  The snow cover probability, NDVI,
+     NDSI, and shaded relief strips are not, since they are completely
+     written for each strip before they are read.
+******************************************************************************/
+int alloc_scene_buffers
+(
+    int nsamps,          /* I: number of samples in each line of the scene */
+    int proc_nlines,     /* I: number of lines in each strip */
+    Scene_buffers_t *sb  /* I/O: scene buffers to be allocated or reused */
+)
+{
+    char FUNC_NAME[] = "alloc_scene_buffers";   /* function name */
+    char errmsg[STR_SIZE];    /* error message */
+    size_t strip_size = (size_t) proc_nlines * nsamps;  /* size of a strip */
+
+    /* Release the buffers of the previous scene and make sure the arena can
+       hold the buffers for this scene */
+    free_mask_buffer (&sb->mask_buf);
+    sb->snow_prob = sb->ndvi = sb->ndsi = sb->shaded_relief = NULL;
+    if (reserve_arena (&sb->arena, MASK_BUF_ARENA_SIZE (nsamps, proc_nlines) +
+        4 * ARENA_SIZE (strip_size * sizeof (uint8))) != SUCCESS)
+    {
+        sprintf (errmsg, "Error allocating memory for the scene buffers");
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+
+    if (alloc_mask_buffer (nsamps, proc_nlines, &sb->arena, &sb->mask_buf)
+        != SUCCESS)
+    {
+        sprintf (errmsg, "Error allocating memory for the mask buffers");
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+
+    sb->snow_prob = (uint8 *) carve_arena (&sb->arena, strip_size *
+        sizeof (uint8), false);
+    sb->ndvi = (uint8 *) carve_arena (&sb->arena, strip_size *
+        sizeof (uint8), false);
+    sb->ndsi = (uint8 *) carve_arena (&sb->arena, strip_size *
+        sizeof (uint8), false);
+    sb->shaded_relief = (uint8 *) carve_arena (&sb->arena, strip_size *
+        sizeof (uint8), false);
+    if (sb->snow_prob == NULL || sb->ndvi == NULL || sb->ndsi == NULL ||
+        sb->shaded_relief == NULL)
+    {
+        sprintf (errmsg, "Error allocating memory for the snow cover "
+            "probability, NDVI, NDSI, and shaded relief strips");
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+
+    return (SUCCESS);
+}
+
+
+/******************************************************************************
+MODULE:  free_scene_buffers
+
+PURPOSE:  Frees the scene buffers.
+
+RETURN VALUE:
+Type = None
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+10/14/2026    agent            Free the arena in one call
+
+NOTES:
+******************************************************************************/
+void free_scene_buffers
+(
+    Scene_buffers_t *sb  /* I/O: scene buffers to be freed */
+)
+{
+    free_mask_buffer (&sb->mask_buf);
+    free_arena (&sb->arena);
+    init_scene_buffers (sb);
+}
@@ -0,0 +1,115 @@
+#ifndef _MASK_BUFFER_H_
+#define _MASK_BUFFER_H_
+
+#include "bool.h"
+#include "arena.h"
+#include "input.h"
+#include "output.h"
+#include "bit_mask.h"
+#include "bin_writer.h"
+
+/* Number of lines kept from the previous strip in the rolling mask buffers.
+   The 9x9 post-processing window needs four lines after the line being
+   post-processed and four lines before it, which have already been
+   post-processed. */
+#define MASK_BUF_EXTRA_NLINES 8
+
+/* Number of bytes of the arena used by the rolling mask buffers for strips of
+   proc_nlines lines of nsamps samples */
+#define MASK_BUF_ARENA_SIZE(nsamps, proc_nlines) \
+    (ARENA_SIZE ((size_t) MB_NUM * ((proc_nlines) + MASK_BUF_EXTRA_NLINES) * \
+    (nsamps) * sizeof (uint8)) + \
+    ARENA_SIZE ((size_t) MBB_NUM * ((proc_nlines) + MASK_BUF_EXTRA_NLINES) * \
+    BIT_MASK_NWORDS (nsamps) * sizeof (Bit_word_t)))
+
+/* Masks held in the rolling mask buffers.  The first NUM_OUT_SDS masks are
+   in the same order as the output SDSs (see out_sds_names in
+   scene_based_sca.c).  MB_SNOW_PREPASS holds the snow mask before the
+   post-processing, for the pre-pass mode of the post-processing. */
+typedef enum {MB_REFL_QA=0, MB_BTEMP_QA, MB_SNOW, MB_CLOUD, MB_DEEP_SHADOW,
+    MB_COMBINED_QA, MB_TREE_NODE, MB_SNOW_COUNT, MB_SNOW_PREPASS, MB_NUM}
+    Mask_buf_band_t;
+
+/* Masks held packed in the rolling mask buffers (see bit_mask.h).  The
+   combined QA mask is only expanded into mask[MB_COMBINED_QA] when it is
+   written.  MBB_SNOW is the final (post-processed) snow mask, packed for the
+   adjacent snow count. */
+typedef enum {MBB_COMBINED_QA=0, MBB_SNOW, MBB_NUM} Mask_buf_bits_t;
+
+/* Rolling buffers holding the masks for the current strip, plus the lines
+   from the previous strip which are still needed for the post-processing
+   windows */
+typedef struct {
+    int nsamps;           /* number of samples in each line */
+    int max_lines;        /* number of lines allocated for each mask */
+    int first_line;       /* line in the scene held in the first line of the
+                             buffers */
+    int nlines;           /* number of lines currently held in the buffers */
+    int nwords;           /* number of words in each packed line */
+    uint8 *mask[MB_NUM];  /* buffer for each of the masks */
+    Bit_word_t *bits[MBB_NUM];  /* buffer for each of the packed masks */
+} Mask_buffer_t;
+
+/* Buffers for processing a scene, which are all carved from one arena.  The
+   arena is kept and reused for each of the scenes processed in a batch, and
+   is only reallocated when a scene needs more memory than the scenes before
+   it. */
+typedef struct {
+    Arena_t arena;        /* arena holding all of the buffers */
+    Mask_buffer_t mask_buf;  /* rolling buffers for the masks */
+    uint8 *snow_prob;     /* snow cover probability for the strip */
+    uint8 *ndvi;          /* NDVI for the strip */
+    uint8 *ndsi;          /* NDSI for the strip */
+    uint8 *shaded_relief; /* shaded relief for the strip */
+} Scene_buffers_t;
+
+/* Prototypes */
+int alloc_mask_buffer
+(
+    int nsamps,          /* I: number of samples in each line */
+    int proc_nlines,     /* I: number of lines in each strip */
+    Arena_t *arena,      /* I/O: arena to carve the buffers from */
+    Mask_buffer_t *mb    /* O: mask buffer to be allocated */
+);
+
+void free_mask_buffer
+(
+    Mask_buffer_t *mb    /* I/O: mask buffer to be freed */
+);
+
+void shift_mask_buffer
+(
+    int keep_line,       /* I: first line in the scene to keep */
+    Mask_buffer_t *mb    /* I/O: mask buffer to be shifted */
+);
+
+int put_mask_buffer_lines
+(
+    Mask_buffer_t *mb,   /* I: mask buffer */
+    Output_t *output,    /* I: output data structure */
+    Bin_writer_t *bin_writer,  /* I/O: raw binary writer; NULL if no raw
+                               binary output is written */
+    int *bin_file,       /* I: raw binary file of each mask in bin_writer
+                               (-1 if the mask is not written to raw binary) */
+    int iline,           /* I: first line in the scene to be written */
+    int nlines           /* I: number of lines to be written */
+);
+
+void init_scene_buffers
+(
+    Scene_buffers_t *sb  /* O: scene buffers to be initialized */
+);
+
+int alloc_scene_buffers
+(
+    int nsamps,          /* I: number of samples in each line of the scene */
+    int proc_nlines,     /* I: number of lines in each strip */
+    Scene_buffers_t *sb  /* I/O: scene buffers to be allocated or reused */
+);
+
+void free_scene_buffers
+(
+    Scene_buffers_t *sb  /* I/O: scene buffers to be freed */
+);
+
+#endif
@@ -18,6 +18,8 @@
 #define OUTPUT_LOCAL_GRAN_ID ("LocalGranuleID")
 #define OUTPUT_PROD_DATE ("SCAProductionDate")
 #define OUTPUT_SCAVERSION ("SCAVersion")
+#define OUTPUT_CLOUD_COVER ("CloudCover")
+#define OUTPUT_SNOW_COVER ("SnowCover")
 
 #define OUTPUT_WEST_BOUND  ("WestBoundingCoordinate")
 #define OUTPUT_EAST_BOUND  ("EastBoundingCoordinate")
@@ -106,10 +108,16 @@ Date         Programmer       Reason
 ---------    ---------------  -------------------------------------
 2/12/2012    Gail Schmidt     Original Development (based on input routines
                               from the LEDAPS lndsr application)
+10/14/2026   agent            Create the SDSs chunked and deflate compressed
 
 NOTES:
   1. Don't allocate space for buf, since pointers to existing buffers will
      be assigned in the output structure.
+  2. The SDSs are chunked by OUT_CHUNK_NLINES x OUT_CHUNK_NSAMPS and
+     compressed with deflate.  The lines are written strip by strip as they
+     become final, and those writes don't start on a chunk boundary, so the
+     chunk cache holds two rows of chunks to avoid compressing any chunk
+     more than once.
 ******************************************************************************/
 Output_t *open_output
 (
@@ -128,6 +136,8 @@ Output_t *open_output
     Myhdf_sds_t *sds = NULL;  /* SDS information */
     int ir;    /* looping variable for rank/dimension */
     int ib;    /* looping variable for bands */
+    int ncache;               /* number of chunks in the chunk cache */
+    HDF_CHUNK_DEF chunk_def;  /* chunking and compression parameters */
 
     /* Check parameters */
     if (nlines < 1)
@@ -174,12 +184,15 @@ Output_t *open_output
     this->nband = nband;
     this->size.l = nlines;
     this->size.s = nsamps;
+    this->offset.l = 0;
+    this->offset.s = 0;
     for (ib = 0; ib < this->nband; ib++)
     {
         this->sds[ib].name = NULL;
         this->sds[ib].dim[0].name = NULL;
         this->sds[ib].dim[1].name = NULL;
         this->buf[ib] = NULL;
+        this->tiled[ib] = NULL;
     }
   
     /* Open file for SD access */
@@ -258,12 +271,116 @@ Output_t *open_output
                 return (NULL);
             }
         }
+
+        /* Chunk and compress the SDS */
+        memset (&chunk_def, 0, sizeof (chunk_def));
+        chunk_def.comp.chunk_lengths[0] = (this->size.l < OUT_CHUNK_NLINES) ?
+            this->size.l : OUT_CHUNK_NLINES;
+        chunk_def.comp.chunk_lengths[1] = (this->size.s < OUT_CHUNK_NSAMPS) ?
+            this->size.s : OUT_CHUNK_NSAMPS;
+        chunk_def.comp.comp_type = COMP_CODE_DEFLATE;
+        chunk_def.comp.cinfo.deflate.level = OUT_DEFLATE_LEVEL;
+        if (SDsetchunk (sds->id, chunk_def, HDF_CHUNK | HDF_COMP) == HDF_ERROR)
+        {
+            free_output (this);
+            close_output (this);
+            sprintf (errmsg, "Error setting up chunking and compression for "
+                "the SDS");
+            error_handler (true, FUNC_NAME, errmsg);
+            return (NULL);
+        }
+
+        ncache = 2 * ((this->size.s + chunk_def.comp.chunk_lengths[1] - 1) /
+            chunk_def.comp.chunk_lengths[1]);
+        if (SDsetchunkcache (sds->id, ncache, 0) == HDF_ERROR)
+        {
+            free_output (this);
+            close_output (this);
+            sprintf (errmsg, "Error setting up the chunk cache for the SDS");
+            error_handler (true, FUNC_NAME, errmsg);
+            return (NULL);
+        }
     }  /* end for image bands */
   
     return this;
 }
 
 
+/******************************************************************************
+MODULE:  open_output_tiles
+
+PURPOSE:  Creates a tiled output file for each of the output bands, so the
+lines written to the HDF file are also written as tiles with overviews.
+
+RETURN VALUE:
+Type = int
+Value      Description
+-----      -----------
+ERROR      Error creating the tiled output files
+SUCCESS    Successful completion
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. The tiled output file for each band is named after the output HDF
+     file, without its extension, followed by _sds_name.tile.  See
+     tiled_output.h for the layout of the files.
+  2. The tiles are written by put_output_line and the files are finished by
+     close_output, so the lines must be written in order.
+******************************************************************************/
+int open_output_tiles
+(
+    Output_t *this,      /* I/O: Output data structure */
+    char *sds_names[NUM_OUT_SDS],  /* I: array of SDS names for each band */
+    double ul_corner[2], /* I: map x and y of the UL corner of the image */
+    double pixel_size[2] /* I: pixel size in x and y */
+)
+{
+    char FUNC_NAME[] = "open_output_tiles";   /* function name */
+    char errmsg[STR_SIZE];       /* error message */
+    char tile_file[STR_SIZE];    /* name of the tiled output file */
+    char *cptr = NULL;           /* extension of the output HDF file */
+    int ib;                      /* looping variable for bands */
+    int base_len;                /* length of the HDF file name without its
+                                    extension */
+
+    cptr = strrchr (this->file_name, '.');
+    base_len = (cptr != NULL && strchr (cptr, '/') == NULL) ?
+        (int) (cptr - this->file_name) : (int) strlen (this->file_name);
+
+    for (ib = 0; ib < this->nband; ib++)
+    {
+        if (snprintf (tile_file, STR_SIZE, "%.*s_%s.tile", base_len,
+            this->file_name, sds_names[ib]) >= STR_SIZE)
+        {
+            sprintf (errmsg, "Tiled output file name for band %d is too long",
+                ib);
+            error_handler (true, FUNC_NAME, errmsg);
+            return (ERROR);
+        }
+
+        this->tiled[ib] = open_tiled_output (tile_file, this->size.l,
+            this->size.s, sizeof (uint8), ul_corner, pixel_size);
+        if (this->tiled[ib] == NULL)
+        {
+            snprintf (errmsg, sizeof (errmsg),
+                "Error creating the tiled output file %.*s",
+                (int) (sizeof (errmsg) / 2), tile_file);
+            error_handler (true, FUNC_NAME, errmsg);
+            return (ERROR);
+        }
+    }
+
+    return (SUCCESS);
+}
+
+
 /******************************************************************************
 MODULE:  close_output
 
@@ -284,6 +401,7 @@ Date         Programmer       Reason
 ---------    ---------------  -------------------------------------
 2/12/2012    Gail Schmidt     Original Development (based on input routines
                               from the LEDAPS lndsr application)
+10/14/2026   agent            Finish the tiled output files
 
 NOTES:
 ******************************************************************************/
@@ -295,6 +413,7 @@ int close_output
     char FUNC_NAME[] = "close_output";   /* function name */
     char errmsg[STR_SIZE];    /* error message */
     int ib;                   /* looping variable */
+    int status = SUCCESS;     /* return status */
 
     if (!this->open)
     {
@@ -318,7 +437,21 @@ int close_output
     SDend (this->sds_file_id);
     this->open = false;
 
-    return (SUCCESS);
+    /* Write the headers of the tiled output files and close them */
+    for (ib = 0; ib < this->nband; ib++)
+    {
+        if (this->tiled[ib] == NULL)
+            continue;
+        if (close_tiled_output (this->tiled[ib]) != SUCCESS)
+        {
+            sprintf (errmsg, "Error closing the tiled output file for band "
+                "%d.", ib);
+            error_handler (true, FUNC_NAME, errmsg);
+            status = ERROR;
+        }
+    }
+
+    return (status);
 }
 
 
@@ -342,6 +475,7 @@ Date         Programmer       Reason
 ---------    ---------------  -------------------------------------
 2/12/2012    Gail Schmidt     Original Development (based on input routines
                               from the LEDAPS lndsr application)
+10/14/2026   agent            Free the tiled output files
 
 NOTES:
 ******************************************************************************/
@@ -374,6 +508,7 @@ int free_output
             }
             if (this->sds[ib].name != NULL) 
                 free (this->sds[ib].name);
+            free_tiled_output (this->tiled[ib]);
         }
     
         if (this->file_name != NULL)
@@ -406,8 +541,11 @@ Date         Programmer       Reason
 ---------    ---------------  -------------------------------------
 2/12/2012    Gail Schmidt     Original Development (based on input routines
                               from the LEDAPS lndsr application)
+10/14/2026   agent            Also write the lines to the tiled output file
 
 NOTES:
+  1. If the band has a tiled output file, the lines must be written in
+     order.
 ******************************************************************************/
 int put_output_line
 (
@@ -469,6 +607,16 @@ int put_output_line
         error_handler (true, FUNC_NAME, errmsg);
         return (ERROR);
     }
+
+    if (this->tiled[iband] != NULL &&
+        put_tiled_output_lines (this->tiled[iband], buf, iline, nlines) !=
+        SUCCESS)
+    {
+        sprintf (errmsg, "Error writing the output line(s) to the tiled "
+            "output file.");
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
     
     return (SUCCESS);
 }
@@ -496,8 +644,11 @@ Date         Programmer       Reason
                               from the LEDAPS lndsr application)
 4/10/2013    Gail Schmidt     Corrected the output of the solar zenith value.
                               Previously we were writing the solar elevation.
+10/14/2026   agent            Write the cloud and snow cover percentages
 
 NOTES:
+  1. The cloud and snow cover are percentages of the valid pixels in the
+     output image.  They aren't written if all of the pixels are fill.
 ******************************************************************************/
 int put_metadata
 (
@@ -506,7 +657,8 @@ int put_metadata
     char *band_names[NUM_OUT_SDS],  /* I: band names to write */
     char *QA_on[NUM_OUT_SDS],  /* I: metadata info for the current band "on" */
     char *QA_off[NUM_OUT_SDS], /* I: metadata info for the current band "off" */
-    Input_meta_t *meta         /* I: metadata to be written */
+    Input_meta_t *meta,        /* I: metadata to be written */
+    Cover_stats_t *stats       /* I: cover statistics of the output image */
 )
 {
     char FUNC_NAME[] = "put_metadata";   /* function name */
@@ -760,6 +912,33 @@ int put_metadata
         }
     }  /* if geographic bounds are not fill */
 
+    /* output the cloud and snow cover percentages if there are valid
+       pixels */
+    if (stats->nvalid > 0)
+    {
+        attr.type = DFNT_FLOAT32;
+        attr.nval = 1;
+        attr.name = OUTPUT_CLOUD_COVER;
+        dval[0] = 100.0 * stats->ncloud / stats->nvalid;
+        if (put_attr_double (this->sds_file_id, &attr, dval) != SUCCESS)
+        {
+            sprintf (errmsg, "Error writing attribute (cloud cover)");
+            error_handler (true, FUNC_NAME, errmsg);
+            return (ERROR);
+        }
+
+        attr.type = DFNT_FLOAT32;
+        attr.nval = 1;
+        attr.name = OUTPUT_SNOW_COVER;
+        dval[0] = 100.0 * stats->nsnow / stats->nvalid;
+        if (put_attr_double (this->sds_file_id, &attr, dval) != SUCCESS)
+        {
+            sprintf (errmsg, "Error writing attribute (snow cover)");
+            error_handler (true, FUNC_NAME, errmsg);
+            return (ERROR);
+        }
+    }  /* if there are valid pixels */
+
     /* now write out the per sds attributes */
     for (ib = 0; ib < nband; ib++)
     {
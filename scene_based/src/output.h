@@ -4,11 +4,34 @@
 #include "mystring.h"
 #include "input.h"
 #include "space.h"
+#include "tiled_output.h"
 
 /* Define the number of SDS that will be output to the HDF-EOS file.  The
    actual SDS names are defined at the top of scene_based_sca.c. */
 #define NUM_OUT_SDS 6
 
+/* Define the chunk size and deflate level of the output SDSs.  The chunks
+   are the height of a processing strip, so the strips fill whole rows of
+   chunks, and narrow enough that subsets can be read back quickly. */
+#define OUT_CHUNK_NLINES PROC_NLINES
+#define OUT_CHUNK_NSAMPS 512
+#define OUT_DEFLATE_LEVEL 6
+
+/* Cover statistics of the pixels in the output image, counted as the
+   strips are processed and written to the output metadata as the scene-level
+   cloud and snow cover percentages */
+typedef struct {
+  long nvalid;          /* Number of pixels which aren't fill in any band */
+  long ncloud;          /* Number of valid pixels which are cloud */
+  long nsnow;           /* Number of valid pixels which are snow, after
+                           post-processing */
+  long nsnow_cand;      /* Number of pixels which passed the water and
+                           thermal tests of the snow cover classification;
+                           this includes the halo of a window */
+  long nskip_lines;     /* Number of lines without any of these pixels, for
+                           which the snow cover tree was skipped */
+} Cover_stats_t;
+
 /* Structure for the 'output' data type */
 typedef struct {
   char *file_name;      /* Output file name */
@@ -16,9 +39,14 @@ typedef struct {
                            for access; 'true' = open, 'false' = not open */
   int nband;            /* Number of output image bands */
   Img_coord_int_t size; /* Output image size */
+  Img_coord_int_t offset; /* Line/sample of the processed lines and samples
+                           which is line/sample 0 of the output image; 0s
+                           unless a window with a halo is processed */
   int32 sds_file_id;    /* SDS file id */
   Myhdf_sds_t sds[NUM_OUT_SDS]; /* SDS data structures for image data */
   uint8 *buf[NUM_OUT_SDS]; /* Output data buffer */
+  Tiled_output_t *tiled[NUM_OUT_SDS]; /* Tiled output file for each band;
+                           NULL unless the tiles are written */
 } Output_t;
 
 /* Prototypes */
@@ -47,6 +75,14 @@ int free_output
     Output_t *this    /* I/O: Output data structure to free */
 );
 
+int open_output_tiles
+(
+    Output_t *this,      /* I/O: Output data structure */
+    char *sds_names[NUM_OUT_SDS],  /* I: array of SDS names for each band */
+    double ul_corner[2], /* I: map x and y of the UL corner of the image */
+    double pixel_size[2] /* I: pixel size in x and y */
+);
+
 int put_output_line
 (
     Output_t *this,    /* I: Output data structure; buf contains the line to
@@ -63,7 +99,8 @@ int put_metadata
     char *band_names[NUM_OUT_SDS],  /* I: band names to write */
     char *QA_on[NUM_OUT_SDS],  /* I: metadata info for the current band "on" */
     char *QA_off[NUM_OUT_SDS], /* I: metadata info for the current band "off" */
-    Input_meta_t *meta         /* I: metadata to be written */
+    Input_meta_t *meta,        /* I: metadata to be written */
+    Cover_stats_t *stats       /* I: cover statistics of the output image */
 );
 
 #endif
@@ -11,6 +11,14 @@
 #include "input.h"
 #include "output.h"
 #include "space.h"
+#include "mask_buffer.h"
+#include "dem.h"
+#include "terrain.h"
+#include "composite.h"
+#include "profile.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 /* Set up the fill, cloud, snow, and deep shadow mask values */
 #define NO_DATA 255
@@ -27,6 +35,63 @@
 /* Define the terrain-derived deep shadow threshold */
 #define TERRAIN_DEEP_SHADOW_THRESH 0.03
 
+/* Number of lines post-processed by each thread in the pre-pass mode of the
+   snow cover post-processing */
+#define POST_PROCESS_NLINES 10
+
+/* Number of lines and samples around a processing window which are also
+   processed, so the 9x9 pre-pass post-processing window and the 3x3
+   adjacent snow count see the same pixels at the edges of the window as for
+   the whole scene.  The original post-processing counts the mask as it is
+   being modified, so a pixel depends on every line above it and no halo is
+   enough; a window therefore requires --prepass_post_process. */
+#define WINDOW_HALO 5
+
+/* Thresholds for the cloud cover classification tree, converted to the
+   unscaled int16 values of the bands (see init_cloud_thresh).  Each test
+   band_pix < thresh in the tree is band[pix] < the value here. */
+typedef struct {
+    int b1_30095;    /* band 1 < 0.30095 */
+    int b1_20055;    /* band 1 < 0.20055 */
+    int b4_104525;   /* band 4 < 1.04525 */
+    int b6_7052;     /* band 6 < -7.052 */
+    int b6_19316;    /* band 6 < -19.316 */
+    int b6_20036;    /* band 6 < -20.036 */
+    int b6_8788;     /* band 6 < 8.788 */
+    int b7_08255;    /* band 7 < 0.08255 */
+    int b7_1166;     /* band 7 < 0.1166 */
+    int b7_15305;    /* band 7 < 0.15305 */
+} Cloud_thresh_t;
+
+/* Terms of the hillshade algorithm which are constant for the scene (see
+   init_hillshade) */
+typedef struct {
+    float ew_res;         /* east/west resolution */
+    float ns_res;         /* north/south resolution, negated since the lines
+                             go from north to south */
+    float solar_az;       /* solar azimuth angle */
+    double sin_elev;      /* sine of the sun elevation angle */
+    double cos_elev;      /* cosine of the sun elevation angle */
+    float x_scale;        /* Horn z scale / east/west resolution, for the
+                             terrain normals */
+    float y_scale;        /* Horn z scale / north/south resolution, negated,
+                             for the terrain normals */
+    float shadow_thresh;  /* terrain-derived deep shadow threshold as a
+                             float */
+    float sun_x;          /* east/west component of the sun vector, divided
+                             by the scale of the terrain normals */
+    float sun_y;          /* north/south component of the sun vector,
+                             divided by the scale of the terrain normals */
+    float sun_z;          /* vertical component of the sun vector, divided
+                             by the scale of the terrain normals */
+} Hillshade_t;
+
+/* Stages of the processing which are timed for --profile; the names are
+   in profile_stage_names in scene_based_sca.c */
+typedef enum {SP_INPUT_READ=0, SP_QA_CLOUD, SP_SNOW_TREE, SP_DEM_HILLSHADE,
+    SP_COMBINE, SP_POST_PROCESS, SP_SNOW_COUNT, SP_OUTPUT_WRITE, SP_NUM}
+    Sca_profile_stage_t;
+
 /* Prototypes */
 void usage ();
 
@@ -38,10 +103,34 @@ short get_args
     char **btemp_infile,  /* O: address of input TOA filename */
     char **dem_infile,    /* O: address of input DEM filename */
     char **sc_outfile,    /* O: address of output snow cover filename */
+    char **manifest,      /* O: address of batch manifest filename */
     bool *write_binary,   /* O: write raw binary flag */
+    bool *prepass_post,   /* O: post-process the snow cover using the
+                                pre-pass mask for the window counts */
+    int *nthreads,        /* O: number of threads for processing */
+    bool *profile,        /* O: should the processing stages be profiled */
+    char **profile_file,  /* O: address of the profile JSON filename (NULL
+                                for stdout) */
+    Img_window_t *window, /* O: window of the scene to be processed; 0 lines
+                                for the whole scene */
+    long *mem_budget_mb,  /* O: megabytes of memory to size the strips for;
+                                0 for strips of PROC_NLINES lines */
+    bool *tiled_output,   /* O: write the tiled output files flag */
+    char **terrain_cache, /* O: address of the terrain cache directory (NULL
+                                if the terrain isn't cached) */
+    char **composite,     /* O: address of the composite state filename
+                                (NULL if the scenes aren't composited) */
     bool *verbose         /* O: verbose flag */
 );
 
+int init_cloud_thresh
+(
+    float refl_scale_fact,  /* I: scale factor for the TOA reflectance values */
+    float btemp_scale_fact, /* I: scale factor for the brightness temp values */
+    Cloud_thresh_t *thresh  /* O: cloud cover thresholds for the unscaled
+                                  values */
+);
+
 void cloud_cover_class
 (
     int16 *b1,     /* I: array of unscaled band 1 TOA reflectance values */
@@ -50,8 +139,8 @@ void cloud_cover_class
     int16 *b7,     /* I: array of unscaled band 7 TOA reflectance values */
     int nlines,    /* I: number of lines in the data arrays */
     int nsamps,    /* I: number of samples in the data arrays */
-    float refl_scale_fact,  /* I: scale factor for the TOA reflectance values */
-    float btemp_scale_fact, /* I: scale factor for the broghtness temp values */
+    Cloud_thresh_t *thresh, /* I: cloud cover thresholds for the unscaled
+                                  values */
     uint8 *refl_qa_mask,  /* I: array of masked values for processing (non-zero
                                 values are not to be processed) reflectance
                                 bands */
@@ -61,6 +150,40 @@ void cloud_cover_class
                                 values represent clouds) */
 );
 
+void qa_cloud_mask
+(
+    int16 *b1,     /* I: array of unscaled band 1 TOA reflectance values */
+    int16 *b2,     /* I: array of unscaled band 2 TOA reflectance values */
+    int16 *b3,     /* I: array of unscaled band 3 TOA reflectance values */
+    int16 *b4,     /* I: array of unscaled band 4 TOA reflectance values */
+    int16 *b5,     /* I: array of unscaled band 5 TOA reflectance values */
+    int16 *b6,     /* I: array of unscaled band 6 brightness temp values */
+    int16 *b7,     /* I: array of unscaled band 7 TOA reflectance values */
+    int nlines,    /* I: number of lines in the data arrays */
+    int nsamps,    /* I: number of samples in the data arrays */
+    Valid_span_t *span,  /* I: valid span of each line, outside of which the
+                               pixels are fill in every band; NULL if all
+                               of the samples are processed */
+    int refl_fill,  /* I: fill value for the TOA reflectance values */
+    int btemp_fill, /* I: fill value for the brightness temp values */
+    Cloud_thresh_t *thresh, /* I: cloud cover thresholds for the unscaled
+                                  values */
+    uint8 *refl_qa_mask,  /* O: array of masked values for processing (non-zero
+                                values are not to be processed) reflectance
+                                bands */
+    uint8 *btemp_qa_mask, /* O: array of masked values for processing (non-zero
+                                values are not to be processed) thermal bands */
+    uint8 *cloud_mask,    /* O: array of cloud cover masked values (non-zero
+                                values represent clouds) */
+    Bit_word_t *combined_bits  /* I/O: packed combined mask, turned on for
+                                       the cloud and fill pixels */
+);
+
+bool set_snow_class_avx2
+(
+    bool allow           /* I: allow the AVX2 kernels? */
+);
+
 void snow_cover_class
 (
     int16 *b1,     /* I: array of unscaled band 1 TOA reflectance values */
@@ -72,6 +195,9 @@ void snow_cover_class
     int16 *b7,     /* I: array of unscaled band 7 TOA reflectance values */
     int nlines,    /* I: number of lines in the data arrays */
     int nsamps,    /* I: number of samples in the data arrays */
+    Valid_span_t *span,  /* I: valid span of each line, outside of which the
+                               pixels are fill in every band; NULL if all
+                               of the samples are processed */
     float refl_scale_fact,  /* I: scale factor for the TOA reflectance values */
     float btemp_scale_fact, /* I: scale factor for the brightness temp values */
     int refl_sat_value,     /* I: saturation value for TOA reflectance values */
@@ -88,10 +214,49 @@ void snow_cover_class
     uint8 *ndvi_array    /* O: NDVI outputs (used for debugging) */
 );
 
-void post_process_snow_cover_class
+long count_snow_candidates
+(
+    int16 *b1,     /* I: array of unscaled band 1 TOA reflectance values */
+    int16 *b4,     /* I: array of unscaled band 4 TOA reflectance values */
+    int16 *b6,     /* I: array of unscaled band 6 brightness temp values */
+    int nlines,    /* I: number of lines in the data arrays */
+    int nsamps,    /* I: number of samples in the data arrays */
+    Valid_span_t *span,  /* I: valid span of each line, outside of which the
+                               pixels are fill in every band; NULL if all
+                               of the samples are processed */
+    float refl_scale_fact,  /* I: scale factor for the TOA reflectance values */
+    float btemp_scale_fact, /* I: scale factor for the brightness temp values */
+    int refl_sat_value,     /* I: saturation value for TOA reflectance values */
+    uint8 *refl_qa_mask  /* I: array of masked values for processing (non-zero
+                               values are not to be processed) reflectance
+                               bands */
+);
+
+void no_snow_cover_class
+(
+    int nlines,    /* I: number of lines in the data arrays */
+    int nsamps,    /* I: number of samples in the data arrays */
+    uint8 *refl_qa_mask, /* I: array of masked values for processing (non-zero
+                               values are not to be processed) reflectance
+                               bands */
+    uint8 *snow_mask,    /* O: array of snow cover masked values */
+    uint8 *probability_score,/* O: probability pixel was classified
+                               correctly */
+    uint8 *tree_node,    /* O: node in tree used to classify each pixel */
+    uint8 *ndsi_array,   /* O: NDSI outputs */
+    uint8 *ndvi_array    /* O: NDVI outputs */
+);
+
+int post_process_snow_cover_class
 (
     int nlines,         /* I: number of lines in the data arrays */
     int nsamps,         /* I: number of samples in the data arrays */
+    int start_line,     /* I: first line in the arrays to be processed */
+    int end_line,       /* I: line after the last line to be processed */
+    uint8 *prepass_mask,/* I: array of snow cover masked values before
+                              post-processing, used for the window counts
+                              (pre-pass mode); NULL to count snow_mask as it
+                              is modified (raster mode) */
     uint8 *snow_mask,   /* I/O: array of snow cover masked values (non-zero
                                 values represent snow) */
     uint8 *tree_node    /* I: node in tree used to classify each pixel */
@@ -101,23 +266,25 @@ void count_adjacent_snow_cover
 (
     int nlines,           /* I: number of lines in the data arrays */
     int nsamps,           /* I: number of samples in the data arrays */
-    uint8 *snow_mask,     /* I: array of snow cover masked values */
-    uint8 *combined_mask, /* I: array of masked values for cloud, shadow, and
-                                fill */
+    int start_line,       /* I: first line in the arrays to be processed */
+    int end_line,         /* I: line after the last line to be processed */
+    Bit_word_t *snow_bits,     /* I: packed snow cover mask */
+    Bit_word_t *combined_bits, /* I: packed mask for cloud, shadow, and
+                                     fill */
     uint8 *snow_count     /* O: count of the snow cover results in the adjacent
                                 3x3 window, or high value if one or more of
                                 the adjacent pixels are cloud/shadow/fill */
 );
 
-float hillshade
+void init_hillshade
 (
-    int16 *elev_window,   /* I: 3x3 array of elevation values in meters */
     float ew_res,         /* I: east/west resolution of the elevation data in
                                 meters */
     float ns_res,         /* I: north/south resolution of the elevation data in
                                 meters */
     float sun_elev,       /* I: sun elevation angle in radians */
-    float solar_azimuth   /* I: solar azimuth angle in radians */
+    float solar_azimuth,  /* I: solar azimuth angle in radians */
+    Hillshade_t *hs       /* O: hillshade terms for the scene */
 );
 
 void deep_shadow
@@ -140,12 +307,9 @@ void deep_shadow
                                of samples therefore the first and last sample
                                will not be processed as part of the mask since
                                a 3x3 window won't be available */
-    float ew_res,        /* I: east/west resolution of the elevation data in
-                               meters */
-    float ns_res,        /* I: north/south resolution of the elevation data in
-                               meters */
-    float sun_elev,      /* I: sun elevation angle in radians */
-    float solar_azimuth, /* I: solar azimuth angle in radians */
+    Valid_span_t *span,  /* I: valid span of each line in the mask array;
+                               NULL if all of the samples are processed */
+    Hillshade_t *hs,     /* I: hillshade terms for the scene */
     uint8 *shaded_relief,    /* O: array of shaded relief values (multiplied
                                    by 255 to take advantage of the 8-bit int)
                                    of size nlines * nsamps */
@@ -154,6 +318,32 @@ void deep_shadow
                                    shadow areas) of size nlines * nsamps */
 );
 
+void terrain_normal_line
+(
+    int16 *up,           /* I: DEM values for the line above */
+    int16 *mid,          /* I: DEM values for the current line */
+    int16 *down,         /* I: DEM values for the line below */
+    int nsamps,          /* I: number of samples in the line */
+    float x_scale,       /* I: east/west slope scale (see init_hillshade) */
+    float y_scale,       /* I: north/south slope scale */
+    int16 *normals       /* O: x, y, and z components of the normals, one
+                               plane of nsamps values after the other */
+);
+
+void terrain_shadow
+(
+    int16 *normals,      /* I: x components of the normals for the line; the
+                               y and z components follow at plane_size and
+                               2 * plane_size values (see get_terrain_line) */
+    int plane_size,      /* I: number of values in each plane of normals */
+    int nsamps,          /* I: number of samples in the line */
+    Valid_span_t *span,  /* I: valid span of the line; NULL if all of the
+                               samples are processed */
+    Hillshade_t *hs,     /* I: hillshade terms for the scene */
+    uint8 *shaded_relief,    /* O: shaded relief values for the line */
+    uint8 *deep_shadow_mask  /* O: deep shadow mask values for the line */
+);
+
 void refl_mask
 (
     int16 *b1,     /* I: array of unscaled band 1 TOA reflectance values */
@@ -185,14 +375,11 @@ void combine_qa_mask
 (
     int nlines,           /* I: number of lines in the data arrays */
     int nsamps,           /* I: number of samples in the data arrays */
-    uint8 *cloud_mask,    /* I: array of cloud masked values */
     uint8 *shadow_mask,   /* I: array of deep shadow masked values */
-    uint8 *refl_qa_mask,  /* I: quality mask for the TOA reflectance products,
-                                where fill and saturated values are flagged */
-    uint8 *btemp_qa_mask, /* I: quality mask for the brightness temp products,
-                                where fill and saturated values are flagged */
-    uint8 *combined_qa    /* O: combined mask representing cloud, deep shadow,
-                                and fill for the current pixel */
+    Bit_word_t *combined_bits  /* I/O: packed combined mask representing
+                                       cloud, deep shadow, and fill for the
+                                       current pixel; cloud and fill are
+                                       already flagged */
 );
 
 int write_envi_hdr
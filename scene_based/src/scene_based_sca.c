@@ -1,3 +1,4 @@
+#include <ctype.h>
 #include "sca.h"
 
 /* Define the output SDS names to be written to the HDF-EOS file */
@@ -5,12 +6,335 @@
 char *out_sds_names[NUM_OUT_SDS] = {"toa_refl_qa", "btemp_qa",
     "snow_cover_mask", "cloud_mask", "deep_shadow_mask", "combined_qa"};
 
+/* Define the temporary raw binary outputs, which are the files of the raw
+   binary writer in the order their ENVI headers are written */
+typedef enum {
+    BIN_SNOW=0, BIN_SNOW_PROB, BIN_TREE_NODE, BIN_SNOW_COUNT, BIN_CLOUD,
+    BIN_DEEP_SHADOW, BIN_RELIEF, BIN_REFL_QA, BIN_BTEMP_QA, BIN_COMBINED_QA,
+    BIN_NDSI, BIN_NDVI, NUM_BIN_MASKS
+} Bin_mask_t;
+
+/* Define the names of the raw binary outputs, which follow the output
+   prefix (see process_scene) */
+static char *bin_mask_names[NUM_BIN_MASKS] = {"snow_cover_mask",
+    "snow_cover_probability_score", "snow_cover_node", "adjacent_snow_count",
+    "cloud_mask", "deep_shadow_mask", "shade_relief", "toa_refl_qa",
+    "btemp_qa", "combined_qa", "ndsi", "ndvi"};
+
+/* Define the names of the profiled stages (see Sca_profile_stage_t) */
+static char *profile_stage_names[SP_NUM] = {"input_read", "qa_cloud",
+    "snow_tree", "dem_hillshade", "combine", "post_process", "snow_count",
+    "output_write"};
+
+/* Define the maximum length of a line in the batch manifest */
+#define MANIFEST_LINE_SIZE (4 * STR_SIZE)
+
 /******************************************************************************
-MODULE:  scene_based_sca
+MODULE:  close_scene (static)
+
+PURPOSE:  Closes and frees the input, DEM, terrain cache, output, and raw
+binary writer for a scene which failed to process.
+
+RETURN VALUE:
+Type = None
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. Any of the structures which haven't been opened yet are NULL.
+******************************************************************************/
+static void close_scene
+(
+    Input_t *toa_input,   /* I/O: input TOA and brightness temperature */
+    Dem_t *dem,           /* I/O: input DEM */
+    Terrain_t *terrain,   /* I/O: terrain normals for the DEM */
+    Output_t *output,     /* I/O: output snow cover product */
+    Bin_writer_t *bin_writer  /* I/O: raw binary writer */
+)
+{
+    if (toa_input != NULL)
+    {
+        close_input (toa_input);
+        free_input (toa_input);
+    }
+    if (dem != NULL)
+        close_dem (dem);
+    if (terrain != NULL)
+        close_terrain (terrain);
+    if (output != NULL)
+    {
+        close_output (output);
+        free_output (output);
+    }
+    if (bin_writer != NULL)
+        close_bin_writer (bin_writer);
+}
+
+
+/******************************************************************************
+MODULE:  fold_output_lines (static)
+
+PURPOSE:  Folds the part of the written lines which is in the output image
+into the composite state.
+
+RETURN VALUE:
+Type = None
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. This follows put_mask_buffer_lines, which expands the combined QA mask
+     for the lines, so the lines must still be held in the mask buffers.
+******************************************************************************/
+static void fold_output_lines
+(
+    Composite_t *composite,  /* I/O: composite state; NULL if the scenes
+                                aren't composited */
+    Mask_buffer_t *mb,    /* I: mask buffer */
+    Output_t *output,     /* I: output data structure */
+    int iline,            /* I: first line in the scene written */
+    int nlines            /* I: number of lines written */
+)
+{
+    int out_start;        /* first line in the output image */
+    int out_end;          /* line after the last line in the output image */
+    long offset;          /* location of out_start in the buffers */
+
+    if (composite == NULL)
+        return;
+
+    out_start = (iline > output->offset.l) ? iline : output->offset.l;
+    out_end = (iline + nlines < output->offset.l + output->size.l) ?
+        iline + nlines : output->offset.l + output->size.l;
+    if (out_start >= out_end)
+        return;
+
+    offset = (long) (out_start - mb->first_line) * mb->nsamps +
+        output->offset.s;
+    fold_composite_lines (composite, &mb->mask[MB_SNOW][offset],
+        &mb->mask[MB_COMBINED_QA][offset], mb->nsamps,
+        out_start - output->offset.l, out_end - out_start);
+}
+
+
+/******************************************************************************
+MODULE:  count_output_lines (static)
+
+PURPOSE:  Adds the valid, cloud, and snow pixels of the part of the written
+lines which is in the output image to the cover statistics.
+
+RETURN VALUE:
+Type = None
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. The valid pixels aren't fill in the TOA reflectance or the brightness
+     temperature.  The masks are the final (post-processed) masks written
+     to the output file, so the lines must still be held in the mask
+     buffers.
+******************************************************************************/
+static void count_output_lines
+(
+    Cover_stats_t *stats, /* I/O: cover statistics of the output image */
+    Mask_buffer_t *mb,    /* I: mask buffer */
+    Output_t *output,     /* I: output data structure */
+    int iline,            /* I: first line in the scene written */
+    int nlines            /* I: number of lines written */
+)
+{
+    int line, samp;       /* current line and sample in the output image */
+    int out_start;        /* first line in the output image */
+    int out_end;          /* line after the last line in the output image */
+    long pix;             /* location of the current pixel in the buffers */
+    long nvalid = 0;      /* number of valid pixels */
+    long ncloud = 0;      /* number of valid cloud pixels */
+    long nsnow = 0;       /* number of valid snow pixels */
+
+    out_start = (iline > output->offset.l) ? iline : output->offset.l;
+    out_end = (iline + nlines < output->offset.l + output->size.l) ?
+        iline + nlines : output->offset.l + output->size.l;
+    for (line = out_start; line < out_end; line++)
+    {
+        pix = (long) (line - mb->first_line) * mb->nsamps + output->offset.s;
+        for (samp = 0; samp < output->size.s; samp++, pix++)
+        {
+            if (mb->mask[MB_REFL_QA][pix] != VALID_DATA ||
+                mb->mask[MB_BTEMP_QA][pix] != VALID_DATA)
+                continue;
+            nvalid++;
+            ncloud += (mb->mask[MB_CLOUD][pix] == CLOUD_COVER);
+            nsnow += (mb->mask[MB_SNOW][pix] == SNOW_COVER);
+        }
+    }
+
+    stats->nvalid += nvalid;
+    stats->ncloud += ncloud;
+    stats->nsnow += nsnow;
+}
+
+
+/******************************************************************************
+MODULE:  pick_strip_nlines (static)
+
+PURPOSE:  Picks the number of lines in each strip so the buffers for the
+scene fit in the memory budget, and reports how the budget is used.
+
+RETURN VALUE:
+Type = int
+Value           Description
+-----           -----------
+nlines          Number of lines in each strip
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. The strip buffers are the double-buffered input strips, the rolling
+     mask buffers, and the probability, NDVI, NDSI, and shaded relief
+     strips.  The lines the mask buffers keep from the previous strip, and
+     the copy of the DEM for a window narrower than the scene, don't depend
+     on the strip height.  The DEM is otherwise mapped from the file, so its
+     pages are dropped by the kernel as needed and it isn't counted.
+  2. The strips are never taller than the scene, or shorter than
+     MIN_PROC_NLINES lines.  If the budget doesn't allow MIN_PROC_NLINES
+     lines, a warning is printed and MIN_PROC_NLINES is used anyway.
+******************************************************************************/
+static int pick_strip_nlines
+(
+    Input_t *toa_input,   /* I: input TOA and brightness temperature */
+    long mem_budget_mb    /* I: megabytes of memory to size the strips for */
+)
+{
+    char FUNC_NAME[] = "pick_strip_nlines"; /* function name */
+    char errmsg[STR_SIZE];   /* error message */
+    double budget;           /* memory budget (bytes) */
+    double line_bytes;       /* bytes of the strip buffers for each line */
+    double fixed_bytes;      /* bytes of the buffers which don't depend on
+                                the strip height */
+    double mask_line_bytes;  /* bytes of the mask buffers for each line */
+    double nlines;           /* number of lines which fit in the budget */
+    int proc_nlines;         /* number of lines in each strip */
+
+    budget = mem_budget_mb * 1024.0 * 1024.0;
+    mask_line_bytes = (double) MB_NUM * toa_input->nsamps +
+        (double) MBB_NUM * BIT_MASK_NWORDS (toa_input->nsamps) *
+        sizeof (Bit_word_t);
+    line_bytes = 2.0 * (toa_input->nrefl_band + 1) *
+        toa_input->scene_nsamps * sizeof (int16) + mask_line_bytes +
+        4.0 * toa_input->nsamps * sizeof (uint8);
+    fixed_bytes = MASK_BUF_EXTRA_NLINES * mask_line_bytes;
+    if (toa_input->nsamps < toa_input->scene_nsamps)
+        fixed_bytes += (double) toa_input->nlines * toa_input->nsamps *
+            sizeof (int16);
+
+    nlines = (budget - fixed_bytes) / line_bytes;
+    if (nlines < MIN_PROC_NLINES)
+    {
+        if (toa_input->nlines > nlines)
+        {
+            sprintf (errmsg, "Memory budget of %ld MB doesn't allow strips "
+                "of %d lines; using %d lines anyway", mem_budget_mb,
+                MIN_PROC_NLINES, MIN_PROC_NLINES);
+            error_handler (false, FUNC_NAME, errmsg);
+        }
+        nlines = MIN_PROC_NLINES;
+    }
+    if (nlines >= toa_input->nlines)
+        proc_nlines = toa_input->nlines;
+    else
+        proc_nlines = (int) nlines;
+
+    printf ("  Memory budget: %ld MB; strips of %d lines use %.1f MB and "
+        "the fixed buffers use %.1f MB\n", mem_budget_mb, proc_nlines,
+        proc_nlines * line_bytes / (1024.0 * 1024.0),
+        fixed_bytes / (1024.0 * 1024.0));
+
+    return (proc_nlines);
+}
+
+
+/******************************************************************************
+MODULE:  init_scene_sun (static)
+
+PURPOSE:  Adjusts the solar azimuth of an ascending scene, then sets up the
+hillshade terms for the scene from the adjusted sun angles.
+
+RETURN VALUE:
+Type = None
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/15/2026    agent            Original Development (from process_scene)
+
+NOTES:
+  1. The hillshade terms hold the sines and cosines of the solar azimuth,
+     so they must be set up from the adjusted azimuth.  Both are done here
+     so the two steps can't be separated or reordered.
+  2. The adjusted azimuth is left in the input metadata, since it is also
+     written to the output metadata.
+******************************************************************************/
+static void init_scene_sun
+(
+    Input_t *toa_input,   /* I/O: input TOA and brightness temperature; the
+                                  solar azimuth is adjusted */
+    Hillshade_t *hs       /* O: hillshade terms for the scene */
+)
+{
+    /* If the scene is an ascending polar scene (flipped upside down), then
+       the solar azimuth needs to be adjusted by 180 degrees.  The scene in
+       this case would be north down and the solar azimuth is based on north
+       being up. */
+    if (!toa_input->meta.ul_corner.is_fill &&
+        !toa_input->meta.lr_corner.is_fill &&
+        toa_input->meta.ul_corner.lat < toa_input->meta.lr_corner.lat)
+    {
+        toa_input->meta.solar_az += 180.0*RAD;
+        if (toa_input->meta.solar_az > 360*RAD)
+            toa_input->meta.solar_az -= 360*RAD;
+        printf ("  Polar or ascending scene.  Readjusting solar azimuth by "
+            "180 degrees.\n    New value: %f radians (%f degrees)\n",
+            toa_input->meta.solar_az, toa_input->meta.solar_az*DEG);
+    }
+
+    /* Set up the hillshade terms for the scene from the adjusted azimuth */
+    init_hillshade (toa_input->meta.pixsize, toa_input->meta.pixsize,
+        toa_input->meta.solar_elev, toa_input->meta.solar_az, hs);
+}
+
+
+/******************************************************************************
+MODULE:  process_scene (static)
 
 PURPOSE:  Calculate the snow cover mask, cloud cover mask, deep shadow mask,
-and shaded relieve for the current scene, provided the TOA reflectance,
-brightness temperature, and elevation.
+and shaded relieve for one scene.
 
 RETURN VALUE:
 Type = int
@@ -25,62 +349,123 @@ at the USGS EROS
 HISTORY:
 Date          Programmer       Reason
 ----------    ---------------  -------------------------------------
-12/31/2012    Gail Schmidt     Original Development
-2/11/2012     Gail Schmidt     Updated to write an ENVI header when processing
-                               raw binary outputs
-2/13/2012     Gail Schmidt     Added support for counting the number of adjacent
-                               snow-covered pixels
-2/15/2013     Gail Schmidt     Added support for HDF-EOS output files
-2/21/2013     Gail Schmidt     Added support for a combined QA mask for clouds,
-                               deep shadows, and fill QA pixels
-3/21/2013     Gail Schmidt     Modifed to support polar stereographic products
-3/21/2013     Gail Schmidt     Adjusted the solar azimuth if the scene is
-                               flipped/ascending
+10/14/2026    agent            Moved from main so a batch of scenes can be
+                               processed in one run
+10/14/2026    agent            Pick the strip height from the memory budget
+10/14/2026    agent            Write the tiled output files
+10/14/2026    agent            Queue the raw binary outputs to a writer thread
+10/14/2026    agent            Compute the shaded relief from the terrain
+                               cache, if one is specified, and adjust the
+                               solar azimuth before the hillshade terms are
+                               set up
+10/14/2026    agent            Fold the output masks into the composite
+                               state, if one is specified
+10/14/2026    agent            Only read the bounding coordinates when they
+                               are written to the metadata
+10/14/2026    agent            Skip the snow cover tree for the lines without
+                               snow cover candidates, and write the cloud
+                               and snow cover percentages to the metadata
+10/15/2026    agent            Adjust the solar azimuth and set up the
+                               hillshade terms together in init_scene_sun
 
 NOTES:
-  1. The scene-based snow cover mask is based on an algorithm developed by
-     Dave Selkowitz, Research Geographer, USGS Alaska Science Center.
-  2. Processing will occur on a subset of lines at a time, however, the snow
-     related buffers for snow cover and probability will need to be full-scene
-     buffers to handle the 7x7 window post-processing.  The other option is
-     to write out the NPROC_LINES buffer to a file, then read that file back
-     for post-processing.  The later seems inefficient, and the former should
-     be doable since the masks are 8-bit unsigned integers.
+  1. See the notes for main about how the strips are processed.
+  2. The buffers in sb are reused from the previous scene when they are
+     large enough, so only the buffers which depend on the input files are
+     allocated for each scene.
+  3. The input read stage of the profile is the time spent waiting for the
+     prefetch of each strip, which is the part of the read which isn't
+     overlapped with the processing.  The QA/cloud and snow tree kernels
+     run in the same parallel loop, so the time of the loop is divided
+     between them by the time the threads spent in each kernel.
+  4. For a window, the window plus a halo of WINDOW_HALO lines and samples
+     (where the scene has them) is processed, and only the window is written
+     to the output file.  A window is only allowed with the pre-pass
+     post-processing (see get_args), which is what the halo covers.  The
+     output grid starts at the upper left corner of the window.  The
+     geographic bounds of the scene don't apply to the window, so they
+     aren't read or written.
+  5. The strips are PROC_NLINES lines unless a memory budget is specified,
+     in which case the strip height is picked to fit the budget once the
+     window is known.
+  6. With tiled output, each output SDS is also written to a tiled file with
+     overviews (see open_output_tiles), on the same grid as the SDS.
+  7. The raw binary outputs are named after the output file, with
+     _name.bin in place of its extension, so the scenes of a batch and
+     concurrent runs don't overwrite each other's files.  The writes are
+     queued to a writer thread (see bin_writer.h), so they overlap the
+     processing of the next strips.
+  8. With a terrain cache directory, the surface normals of the DEM are
+     computed once and kept in the cache (see open_terrain), so the shaded
+     relief of each scene with that DEM is a dot product of the normals with
+     the sun vector.
+  9. With a composite state, the snow cover and combined QA masks of the
+     output image are folded into the state as the lines are written (see
+     composite.h), so the scene is added to the composite without reading
+     the earlier scenes.
+ 10. The snow cover candidates of each line (see count_snow_candidates) are
+      counted before it is classified.  A line without any, such as a line
+      of water or warm ground, gets the no snow results without running the
+      snow cover tree, and the post-processing skips the lines without snow
+      from the nodes it revisits.  The valid, cloud, and snow pixels of the
+      output image are counted as the lines are written, for the cover
+      percentages in the metadata.
 ******************************************************************************/
-int main (int argc, char *argv[])
+static int process_scene
+(
+    char *toa_infile,     /* I: input TOA reflectance filename */
+    char *btemp_infile,   /* I: input brightness temperature filename */
+    char *dem_infile,     /* I: input DEM filename */
+    char *sc_outfile,     /* I: output snow cover filename */
+    bool write_binary,    /* I: should raw binary output be written? */
+    bool prepass_post,    /* I: should the snow cover post-processing count
+                                the pre-pass snow mask? */
+    bool verbose,         /* I: should intermediate messages be printed? */
+    Img_window_t *window, /* I: window of the scene to be processed; 0
+                                lines for the whole scene */
+    long mem_budget_mb,   /* I: megabytes of memory to size the strips for;
+                                0 for strips of PROC_NLINES lines */
+    bool tiled_output,    /* I: should the tiled output files be written? */
+    char *terrain_cache,  /* I: directory of the terrain cache files; NULL
+                                to compute the hillshade from the DEM */
+    Composite_t *composite,  /* I/O: composite state the scene is folded
+                                into; NULL if the scenes aren't composited */
+    Scene_buffers_t *sb,  /* I/O: buffers reused between the scenes */
+    Profile_t *prof       /* I/O: profile of the processing stages */
+)
 {
-    bool verbose;            /* verbose flag for printing messages */
-    bool write_binary;       /* should we write raw binary output? */
-    bool dem_top;            /* are we at the top of the dem for shaded
-                                relief processing */
-    bool dem_bottom;         /* are we at the bottom of the dem for shaded
-                                relief processing */
-    char FUNC_NAME[] = "main"; /* function name */
+    char FUNC_NAME[] = "process_scene"; /* function name */
     char errmsg[STR_SIZE];   /* error message */
+    char envi_file[STR_SIZE];  /* name of the ENVI header file */
+    char bin_prefix[STR_SIZE];  /* output filename without its extension,
+                                which prefixes the raw binary files */
+    char *cptr = NULL;       /* extension of the output filename */
     char *hdf_grid_name = "Grid";  /* name of the grid for HDF-EOS */
-    char *toa_infile=NULL;   /* input TOA filename */
-    char *btemp_infile=NULL; /* input brightness temperature filename */
-    char *dem_infile=NULL;   /* input DEM filename */
-    char *sc_outfile=NULL;   /* output snow cover filename */
     char *QA_on[NUM_OUT_SDS] = {"fill", "fill", "snow", "cloud",
                                 "deep shadow", "cloud, shadow, or fill"};
     char *QA_off[NUM_OUT_SDS] = {"not fill", "not fill", "clear", "clear",
                                  "clear", "clear"};
-
     int retval;              /* return status */
     int k;                   /* variable to keep track of the % complete */
     int band;                /* current band to be processed */
     int line;                /* current line to be processed */
+    int proc_nlines;         /* number of lines in each strip */
     int nlines_proc;         /* number of lines to process at one time */
-    int start_line;          /* line of DEM to start reading */
-    int extra_lines_start;   /* number of extra lines at the start of the DEM
-                                to be read as part of the 3x3 window */
-    int extra_lines_end;     /* number of extra lines at the end of the DEM
-                                to be read as part of the 3x3 window */
-    int nvals_to_read;       /* actual number of values to be read from the DEM
-                                to include padding for the 3x3 */
-    int offset;              /* offset in the raw binary DEM file to seek to
-                                to begin reading the window in the DEM */
+    int next_line;           /* first line of the next strip to be read;
+                                also the line through which the next
+                                post-processing/count step can proceed */
+    int next_nlines;         /* number of lines in the next strip */
+    int pline;               /* line in the current strip being processed */
+    int class_end;           /* line after the last classified line */
+    int post_end;            /* line after the last post-processed line */
+    int count_end;           /* line after the last line with the adjacent
+                                snow count */
+    int write_end;           /* line after the last line written */
+    int keep_line;           /* first line to keep in the mask buffers */
+    int nerrors;             /* number of errors in the parallel
+                                post-processing */
+    int pix;                 /* location of pline in the strip buffers */
+    int dem_line;            /* line in the scene for pline */
     int curr_snow_pix;       /* starting location/pixel of the current line
                                 in the snow-cover related arrays, which are
                                 full scene buffers */
@@ -90,7 +475,8 @@ int main (int argc, char *argv[])
     uint8 *btemp_qa_mask=NULL;/* quality mask for the brightness temp products,
                                 where fill and saturated values are flagged */
     uint8 *cloud_mask=NULL;  /* cloud mask */
-    uint8 *combined_qa=NULL; /* combined QA mask */
+    Bit_word_t *combined_bits=NULL;  /* packed combined QA mask */
+    Bit_word_t *snow_bits=NULL;      /* packed post-processed snow mask */
     uint8 *snow_mask=NULL;   /* snow cover mask */
     uint8 *snow_count=NULL;  /* snow count for adjacent pixels */
     uint8 *snow_prob=NULL;   /* snow cover probability score (percentage) */
@@ -99,36 +485,45 @@ int main (int argc, char *argv[])
     uint8 *ndvi=NULL;        /* NDVI values */
     uint8 *deep_shad_mask=NULL; /* deep shadow mask */
     uint8 *shaded_relief=NULL;  /* shaded relief values */
-    int16 *dem=NULL;         /* input DEM data (meters) */
     Input_t *toa_input=NULL; /* input structure for both the TOA reflectance
                                 and brightness temperature products */
     Space_def_t space_def;   /* spatial definition information */
+    Img_window_t proc_window;  /* window being processed, which is the
+                                  requested window plus the halo */
+    double dl, ds;           /* distance from the UL corner of the scene to
+                                the UL corner of the window */
+    double tile_ul[2];       /* map x and y of the UL corner of the output
+                                image, for the tiled output files */
+    double tile_pixel_size[2];  /* pixel size for the tiled output files */
     Output_t *output = NULL; /* output structure and metadata */
-
-    FILE *dem_fptr=NULL;     /* input scene-based DEM file pointer */
-    FILE *scm_fptr=NULL;     /* snow cover mask file pointer */
-    FILE *sc_prob_fptr=NULL; /* snow cover probability file pointer */
-    FILE *node_fptr=NULL;    /* tree node file pointer */
-    FILE *adj_count_fptr=NULL; /* adjacent snow cover counter file pointer */
-    FILE *cm_fptr=NULL;      /* cloud mask file pointer */
-    FILE *combined_fptr=NULL;  /* combined QA mask file pointer */
-    FILE *dsm_fptr=NULL;     /* deep shadow mask file pointer */
-    FILE *relief_fptr=NULL;  /* shade relief file pointer */
-    FILE *refl_qa_fptr=NULL; /* TOA reflectance QA file pointer */
-    FILE *btemp_qa_fptr=NULL;/* brightness temp QA file pointer */
-    FILE *ndsi_fptr=NULL;    /* NDSI file pointer */
-    FILE *ndvi_fptr=NULL;    /* NDVI file pointer */
-
-    printf ("Starting scene-based snow cover processing ...\n");
-
-    /* Read the command-line arguments, including the name of the input
-       Landsat TOA reflectance product and the DEM */
-    retval = get_args (argc, argv, &toa_infile, &btemp_infile, &dem_infile,
-        &sc_outfile, &write_binary, &verbose);
-    if (retval != SUCCESS)
-    {   /* get_args already printed the error message */
-        exit (ERROR);
-    }
+    Mask_buffer_t *mask_buf; /* rolling buffers for the masks; the mask
+                                pointers above point into these buffers */
+    Cloud_thresh_t cloud_thresh;  /* cloud cover thresholds for the unscaled
+                                     band values */
+    Hillshade_t hs;          /* hillshade terms for the scene */
+    Profile_mark_t mark;     /* start of the stage being profiled */
+    int class_stages[2] = {SP_QA_CLOUD, SP_SNOW_TREE};  /* profile stages of
+                                the classification loop */
+    double class_sec[2];     /* time the threads spent in each stage of the
+                                classification loop */
+    double qa_sec;           /* time the threads spent in qa_cloud_mask */
+    double snow_sec;         /* time the threads spent in snow_cover_class */
+    double t0 = 0.0, t1 = 0.0;  /* times around the kernels for the
+                                profile */
+    Cover_stats_t stats;     /* cover statistics of the output image */
+    long ncand;              /* number of snow cover candidates in a line */
+    long nsnow_cand;         /* number of snow cover candidates in a strip */
+    long nskip_lines;        /* number of lines of a strip for which the snow
+                                cover tree was skipped */
+
+    Dem_t *dem = NULL;       /* input scene-based DEM (meters) */
+    Terrain_t *terrain = NULL;  /* cached terrain normals for the DEM; NULL
+                                if the hillshade is computed from the DEM */
+    Bin_writer_t *bin_writer = NULL;  /* raw binary writer; NULL if raw
+                                binary output isn't written */
+    int mask_bin[MB_NUM];    /* raw binary file of the masks in the mask
+                                buffers (-1 if not written) */
+    size_t nbytes_bin;       /* number of bytes of each raw binary strip */
 
     /* Provide user information if verbose is turned on */
     if (verbose)
@@ -141,21 +536,32 @@ int main (int argc, char *argv[])
             printf ("    -- Also writing raw binary output.\n");
     }
 
-    /* Temporary -- open the mask output files for raw binary output */
+    /* Temporary -- open the raw binary writer for the mask output files,
+       named after the output file */
     if (write_binary)
     {
-        scm_fptr = fopen ("snow_cover_mask.bin", "wb");
-        sc_prob_fptr = fopen ("snow_cover_probability_score.bin", "wb");
-        node_fptr = fopen ("snow_cover_node.bin", "wb");
-        adj_count_fptr = fopen ("adjacent_snow_count.bin", "wb");
-        cm_fptr = fopen ("cloud_mask.bin", "wb");
-        dsm_fptr = fopen ("deep_shadow_mask.bin", "wb");
-        relief_fptr = fopen ("shade_relief.bin", "wb");
-        refl_qa_fptr = fopen ("toa_refl_qa.bin", "wb");
-        btemp_qa_fptr = fopen ("btemp_qa.bin", "wb");
-        combined_fptr = fopen ("combined_qa.bin", "wb");
-        ndsi_fptr = fopen ("ndsi.bin", "wb");
-        ndvi_fptr = fopen ("ndvi.bin", "wb");
+        cptr = strrchr (sc_outfile, '.');
+        if (cptr == NULL || strchr (cptr, '/') != NULL)
+            cptr = sc_outfile + strlen (sc_outfile);
+        if (cptr - sc_outfile >= STR_SIZE)
+        {
+            sprintf (errmsg, "Output snow cover filename is too long for the "
+                "raw binary output files: %s", sc_outfile);
+            error_handler (true, FUNC_NAME, errmsg);
+            return (ERROR);
+        }
+        sprintf (bin_prefix, "%.*s", (int) (cptr - sc_outfile), sc_outfile);
+
+        bin_writer = open_bin_writer (bin_prefix, NUM_BIN_MASKS,
+            bin_mask_names);
+        if (bin_writer == NULL)
+        {
+            snprintf (errmsg, sizeof (errmsg),
+                "Error opening the raw binary output files for %.*s",
+                (int) (sizeof (errmsg) / 2), bin_prefix);
+            error_handler (true, FUNC_NAME, errmsg);
+            return (ERROR);
+        }
     }
 
     /* Open the TOA reflectance and brightness temperature products, set up
@@ -168,7 +574,8 @@ int main (int argc, char *argv[])
             "and the brightness temperature file: %s", toa_infile,
             btemp_infile);
         error_handler (true, FUNC_NAME, errmsg);
-        exit (ERROR);
+        close_scene (NULL, NULL, NULL, NULL, bin_writer);
+        return (ERROR);
     }
 
     /* Output some information from the input files if verbose */
@@ -193,110 +600,163 @@ int main (int argc, char *argv[])
             toa_input->refl_saturate_val, toa_input->btemp_saturate_val);
     }
 
-    /* Allocate memory for the TOA reflectance QA mask (full scene to handle
-       post-processing) */
-    refl_qa_mask = (uint8 *) calloc (toa_input->nlines * toa_input->nsamps,
-        sizeof (uint8));
-    if (refl_qa_mask == NULL)
+    /* Restrict the processing to the window, if one was specified, plus the
+       halo needed by the neighborhood operators */
+    if (window->nlines > 0)
     {
-        sprintf (errmsg, "Error allocating memory (full scene) for the TOA "
-            "reflectance QA mask");
-        error_handler (true, FUNC_NAME, errmsg);
-        close_input (toa_input);
-        free_input (toa_input);
-        exit (ERROR);
+        if (window->line0 + window->nlines > toa_input->nlines ||
+            window->samp0 + window->nsamps > toa_input->nsamps)
+        {
+            sprintf (errmsg, "Window of %d lines and %d samples starting at "
+                "line %d, sample %d is not within the %d lines and %d "
+                "samples of the scene", window->nlines, window->nsamps,
+                window->line0, window->samp0, toa_input->nlines,
+                toa_input->nsamps);
+            error_handler (true, FUNC_NAME, errmsg);
+            close_scene (toa_input, dem, terrain, output, bin_writer);
+            return (ERROR);
+        }
+
+        proc_window.line0 = (window->line0 > WINDOW_HALO) ?
+            window->line0 - WINDOW_HALO : 0;
+        proc_window.samp0 = (window->samp0 > WINDOW_HALO) ?
+            window->samp0 - WINDOW_HALO : 0;
+        proc_window.nlines = ((window->line0 + window->nlines + WINDOW_HALO <
+            toa_input->nlines) ? window->line0 + window->nlines + WINDOW_HALO :
+            toa_input->nlines) - proc_window.line0;
+        proc_window.nsamps = ((window->samp0 + window->nsamps + WINDOW_HALO <
+            toa_input->nsamps) ? window->samp0 + window->nsamps + WINDOW_HALO :
+            toa_input->nsamps) - proc_window.samp0;
+        if (set_input_window (toa_input, &proc_window) != SUCCESS)
+        {
+            sprintf (errmsg, "Error setting the processing window");
+            error_handler (true, FUNC_NAME, errmsg);
+            close_scene (toa_input, dem, terrain, output, bin_writer);
+            return (ERROR);
+        }
+
+        if (verbose)
+            printf ("  Window lines/samples: %d/%d starting at line %d, "
+                "sample %d (processing %d/%d with the halo)\n",
+                window->nlines, window->nsamps, window->line0,
+                window->samp0, proc_window.nlines, proc_window.nsamps);
     }
 
-    /* Allocate memory for the brightness temperature QA mask (full scene to
-       handle post-processing) */
-    btemp_qa_mask = (uint8 *) calloc (toa_input->nlines * toa_input->nsamps,
-        sizeof (uint8));
-    if (btemp_qa_mask == NULL)
+    /* Convert the cloud cover thresholds to the unscaled band values so
+       the cloud cover classification doesn't need to scale each pixel */
+    if (init_cloud_thresh (toa_input->refl_scale_fact,
+        toa_input->btemp_scale_fact, &cloud_thresh) != SUCCESS)
     {
-        sprintf (errmsg, "Error allocating memory (full scene) for the "
-            "brightness temp QA mask");
+        sprintf (errmsg, "Error setting up the cloud cover thresholds");
         error_handler (true, FUNC_NAME, errmsg);
-        close_input (toa_input);
-        free_input (toa_input);
-        exit (ERROR);
+        close_scene (toa_input, dem, terrain, output, bin_writer);
+        return (ERROR);
     }
 
-    /* Allocate memory for the cloud mask (full scene to handle
-       post-processing) */
-    cloud_mask = (uint8 *) calloc (toa_input->nlines * toa_input->nsamps,
-        sizeof (uint8));
-    if (cloud_mask == NULL)
+    /* Adjust the solar azimuth for an ascending scene and set up the
+       hillshade terms for the scene */
+    init_scene_sun (toa_input, &hs);
+
+    /* Size the strips for the memory budget, if one was specified */
+    proc_nlines = PROC_NLINES;
+    if (mem_budget_mb > 0)
     {
-        sprintf (errmsg, "Error allocating memory (full scene) for the cloud "
-            "mask");
-        error_handler (true, FUNC_NAME, errmsg);
-        close_input (toa_input);
-        free_input (toa_input);
-        exit (ERROR);
+        proc_nlines = pick_strip_nlines (toa_input, mem_budget_mb);
+        if (set_input_strip_nlines (toa_input, proc_nlines) != SUCCESS)
+        {
+            sprintf (errmsg, "Error allocating the input strips of %d lines",
+                proc_nlines);
+            error_handler (true, FUNC_NAME, errmsg);
+            close_scene (toa_input, dem, terrain, output, bin_writer);
+            return (ERROR);
+        }
     }
 
-    /* Allocate memory for the snow cover mask (full scene to handle
-       post-processing) */
-    snow_mask = (uint8 *) calloc (toa_input->nlines * toa_input->nsamps,
-        sizeof (uint8));
-    if (snow_mask == NULL)
+    /* Set up the buffers for the scene, carved from the arena of the
+       previous scene if there is one.  Rather than holding the full scene,
+       the rolling mask buffers hold the current strip plus the lines from
+       the previous strip which are still needed by the post-processing
+       windows. */
+    if (alloc_scene_buffers (toa_input->nsamps, proc_nlines, sb) != SUCCESS)
     {
-        sprintf (errmsg, "Error allocating memory (full scene) for the snow "
-            "mask");
+        sprintf (errmsg, "Error allocating memory for the scene buffers");
         error_handler (true, FUNC_NAME, errmsg);
-        close_input (toa_input);
-        free_input (toa_input);
-        exit (ERROR);
+        close_scene (toa_input, dem, terrain, output, bin_writer);
+        return (ERROR);
     }
-
-    /* Allocate memory for the snow cover probability */
-    snow_prob = (uint8 *) calloc (PROC_NLINES * toa_input->nsamps,
-        sizeof (uint8));
-    if (snow_prob == NULL)
+    mask_buf = &sb->mask_buf;
+    refl_qa_mask = mask_buf->mask[MB_REFL_QA];
+    btemp_qa_mask = mask_buf->mask[MB_BTEMP_QA];
+    snow_mask = mask_buf->mask[MB_SNOW];
+    cloud_mask = mask_buf->mask[MB_CLOUD];
+    deep_shad_mask = mask_buf->mask[MB_DEEP_SHADOW];
+    combined_bits = mask_buf->bits[MBB_COMBINED_QA];
+    snow_bits = mask_buf->bits[MBB_SNOW];
+    tree_node = mask_buf->mask[MB_TREE_NODE];
+    snow_count = mask_buf->mask[MB_SNOW_COUNT];
+
+    /* Set up the raw binary output files for the masks in the buffers */
+    for (band = 0; band < MB_NUM; band++)
+        mask_bin[band] = -1;
+    if (write_binary)
     {
-        sprintf (errmsg, "Error allocating memory for the snow cover "
-            "probability");
-        error_handler (true, FUNC_NAME, errmsg);
-        close_input (toa_input);
-        free_input (toa_input);
-        exit (ERROR);
+        mask_bin[MB_REFL_QA] = BIN_REFL_QA;
+        mask_bin[MB_BTEMP_QA] = BIN_BTEMP_QA;
+        mask_bin[MB_SNOW] = BIN_SNOW;
+        mask_bin[MB_CLOUD] = BIN_CLOUD;
+        mask_bin[MB_DEEP_SHADOW] = BIN_DEEP_SHADOW;
+        mask_bin[MB_COMBINED_QA] = BIN_COMBINED_QA;
+        mask_bin[MB_TREE_NODE] = BIN_TREE_NODE;
+        mask_bin[MB_SNOW_COUNT] = BIN_SNOW_COUNT;
     }
 
-    /* Allocate memory for the tree node (full scene to handle
-       post-processing) */
-    tree_node = (uint8 *) calloc (toa_input->nlines * toa_input->nsamps,
-        sizeof (uint8));
-    if (tree_node == NULL)
+    /* Point to the strips for the snow cover probability, NDVI, NDSI, and
+       shaded relief */
+    snow_prob = sb->snow_prob;
+    ndvi = sb->ndvi;
+    ndsi = sb->ndsi;
+    shaded_relief = sb->shaded_relief;
+
+    /* Open and map the DEM.  The DEM should be the same size as the input
+       scene, since the scene was used to resample the DEM. */
+    dem = open_dem (dem_infile, toa_input->scene_nlines,
+        toa_input->scene_nsamps);
+    if (dem == NULL)
     {
-        sprintf (errmsg, "Error allocating memory (full scene) for the tree "
-            "node");
+        sprintf (errmsg, "Error opening the DEM file: %s", dem_infile);
         error_handler (true, FUNC_NAME, errmsg);
-        close_input (toa_input);
-        free_input (toa_input);
-        exit (ERROR);
+        close_scene (toa_input, dem, terrain, output, bin_writer);
+        return (ERROR);
     }
 
-    /* Allocate memory for the NDVI */
-    ndvi = (uint8 *) calloc (PROC_NLINES * toa_input->nsamps, sizeof (uint8));
-    if (ndvi == NULL)
+    /* Open the cached terrain normals for the DEM, building them if this
+       DEM hasn't been cached yet.  This needs the whole DEM, so it's done
+       before the window is set. */
+    if (terrain_cache != NULL)
     {
-        sprintf (errmsg, "Error allocating memory for the NDVI");
-        error_handler (true, FUNC_NAME, errmsg);
-        close_input (toa_input);
-        free_input (toa_input);
-        exit (ERROR);
+        terrain = open_terrain (terrain_cache, dem, hs.x_scale, hs.y_scale);
+        if (terrain == NULL)
+        {
+            sprintf (errmsg, "Error opening the terrain cache for the DEM "
+                "file: %s", dem_infile);
+            error_handler (true, FUNC_NAME, errmsg);
+            close_scene (toa_input, dem, terrain, output, bin_writer);
+            return (ERROR);
+        }
+        if (verbose)
+            printf ("  Terrain cache file: %s (%s)\n", terrain->file_name,
+                terrain->built ? "built" : "reused");
     }
 
-    /* Allocate memory for the NDSI */
-    ndsi = (uint8 *) calloc (PROC_NLINES * toa_input->nsamps, sizeof (uint8));
-    if (ndsi == NULL)
+    if (window->nlines > 0 && set_dem_window (dem, &proc_window) != SUCCESS)
     {
-        sprintf (errmsg, "Error allocating memory for the NDSI");
+        sprintf (errmsg, "Error setting the processing window for the DEM");
         error_handler (true, FUNC_NAME, errmsg);
-        close_input (toa_input);
-        free_input (toa_input);
-        exit (ERROR);
+        close_scene (toa_input, dem, terrain, output, bin_writer);
+        return (ERROR);
     }
+    if (terrain != NULL && window->nlines > 0)
+        set_terrain_window (terrain, &proc_window);
 
     /* Get the projection and spatial information from the input TOA
        reflectance product */
@@ -306,42 +766,123 @@ int main (int argc, char *argv[])
         sprintf (errmsg, "Error reading spatial metadata from the HDF file: "
             "%s", toa_infile);
         error_handler (true, FUNC_NAME, errmsg);
-        close_input (toa_input);
-        free_input (toa_input);
-        exit (ERROR);
+        close_scene (toa_input, dem, terrain, output, bin_writer);
+        return (ERROR);
+    }
+
+    /* Move the grid to the upper left corner of the window, the same way
+       the lower right corner is found from the image size */
+    if (window->nlines > 0)
+    {
+        dl = window->line0 * space_def.pixel_size;
+        ds = window->samp0 * space_def.pixel_size;
+        space_def.ul_corner.y += ds * sin (space_def.orientation_angle) -
+            dl * cos (space_def.orientation_angle);
+        space_def.ul_corner.x += ds * cos (space_def.orientation_angle) +
+            dl * sin (space_def.orientation_angle);
+        space_def.img_size.l = window->nlines;
+        space_def.img_size.s = window->nsamps;
     }
 
     /* Create and open the output HDF-EOS file */
     if (create_output (sc_outfile) != SUCCESS)
     {   /* error message already printed */
         error_handler (true, FUNC_NAME, errmsg);
-        close_input (toa_input);
-        free_input (toa_input);
-        exit (ERROR);
+        close_scene (toa_input, dem, terrain, output, bin_writer);
+        return (ERROR);
     }
 
-    output = open_output (sc_outfile, NUM_OUT_SDS, out_sds_names,
-        toa_input->nlines, toa_input->nsamps);
+    if (window->nlines > 0)
+        output = open_output (sc_outfile, NUM_OUT_SDS, out_sds_names,
+            window->nlines, window->nsamps);
+    else
+        output = open_output (sc_outfile, NUM_OUT_SDS, out_sds_names,
+            toa_input->nlines, toa_input->nsamps);
     if (output == NULL)
     {   /* error message already printed */
         error_handler (true, FUNC_NAME, errmsg);
-        close_input (toa_input);
-        free_input (toa_input);
-        exit (ERROR);
+        close_scene (toa_input, dem, terrain, output, bin_writer);
+        return (ERROR);
+    }
+    if (window->nlines > 0)
+    {
+        output->offset.l = window->line0 - proc_window.line0;
+        output->offset.s = window->samp0 - proc_window.samp0;
+    }
+
+    /* Start folding the scene into the composite state, on the grid of the
+       output image */
+    if (composite != NULL && start_composite_scene (composite,
+        output->size.l, output->size.s, &toa_input->meta.acq_date,
+        toa_input->meta.path, toa_input->meta.row) != SUCCESS)
+    {
+        sprintf (errmsg, "Error starting the composite of %s", toa_infile);
+        error_handler (true, FUNC_NAME, errmsg);
+        close_scene (toa_input, dem, terrain, output, bin_writer);
+        return (ERROR);
+    }
+
+    /* Create the tiled output files, on the grid of the output image */
+    if (tiled_output)
+    {
+        if (space_def.orientation_angle != 0.0)
+        {
+            sprintf (errmsg, "The grid of %s is rotated, but the tiled output "
+                "files only hold the upper left corner and pixel size",
+                toa_infile);
+            error_handler (false, FUNC_NAME, errmsg);
+        }
+        tile_ul[0] = space_def.ul_corner.x;
+        tile_ul[1] = space_def.ul_corner.y;
+        tile_pixel_size[0] = space_def.pixel_size;
+        tile_pixel_size[1] = space_def.pixel_size;
+        if (open_output_tiles (output, out_sds_names, tile_ul,
+            tile_pixel_size) != SUCCESS)
+        {
+            sprintf (errmsg, "Error creating the tiled output files");
+            error_handler (true, FUNC_NAME, errmsg);
+            close_scene (toa_input, dem, terrain, output, bin_writer);
+            return (ERROR);
+        }
     }
 
     /* Print the processing status if verbose */
     if (verbose)
     {
-        printf ("  Processing %d lines at a time\n", PROC_NLINES);
-        printf ("  Cloud and snow cover -- %% complete: 0%%\r");
+        printf ("  Processing %d lines at a time\n", proc_nlines);
+        printf ("  Snow cover -- %% complete: 0%%\r");
     }
 
     /* Loop through the lines and samples in the TOA reflectance and
-       brightness temperature products, computing the cloud and snow cover */
-    nlines_proc = PROC_NLINES;
+       brightness temperature products and the DEM, computing the cloud and
+       snow cover, the deep shadow mask, and the combined QA mask for each
+       strip.  The snow cover post-processing and the adjacent snow count
+       then follow behind the classification as far as the windows allow.
+       class_end, post_end, count_end, and write_end are the lines in the
+       scene at which each of these steps, and the writing of the final
+       lines, currently stands. */
+    nlines_proc = proc_nlines;
+    if (nlines_proc > toa_input->nlines)
+        nlines_proc = toa_input->nlines;
     k = 0;
-    for (line = 0; line < toa_input->nlines; line += PROC_NLINES)
+    class_end = 0;
+    post_end = 0;
+    count_end = 0;
+    write_end = 0;
+    memset (&stats, 0, sizeof (stats));
+
+    /* Start reading the first strip */
+    if (start_input_prefetch (toa_input, 0, nlines_proc) != SUCCESS)
+    {
+        sprintf (errmsg, "Error starting the read of the first %d lines of "
+            "the TOA reflectance and brightness temperature files",
+            nlines_proc);
+        error_handler (true, FUNC_NAME, errmsg);
+        close_scene (toa_input, dem, terrain, output, bin_writer);
+        return (ERROR);
+    }
+
+    for (line = 0; line < toa_input->nlines; line += proc_nlines)
     {
         /* Do we have nlines_proc left to process? */
         if (line + nlines_proc >= toa_input->nlines)
@@ -353,419 +894,460 @@ int main (int argc, char *argv[])
             k = 100 * line / toa_input->nlines;
             if (k % 10 == 0)
             {
-                printf ("  Cloud and snow cover -- %% complete: %d%%\r", k);
+                printf ("  Snow cover -- %% complete: %d%%\r", k);
                 fflush (stdout);
             }
         }
 
-        /* Read the current lines from the TOA file for each of the TOA
-           reflectance bands */
-        for (band = 0; band < toa_input->nrefl_band; band++)
+        /* Wait for the current lines from the TOA reflectance and
+           brightness temp files */
+        start_profile_stage (prof, &mark);
+        if (finish_input_prefetch (toa_input) != SUCCESS)
         {
-            if (get_input_refl_lines (toa_input, band, line, nlines_proc) !=
-                SUCCESS)
-            {
-                sprintf (errmsg, "Error reading %d lines from band %d of the "
-                    "TOA reflectance file starting at line %d", nlines_proc,
-                    band, line);
-                error_handler (true, FUNC_NAME, errmsg);
-                close_input (toa_input);
-                free_input (toa_input);
-                exit (ERROR);
-            }
-        }  /* end for band */
-
-        /* Read the current lines from the brightness temp file */
-        if (get_input_btemp_lines (toa_input, line, nlines_proc) != SUCCESS)
+            sprintf (errmsg, "Error reading %d lines from the TOA reflectance "
+                "and brightness temperature files starting at line %d",
+                nlines_proc, line);
+            error_handler (true, FUNC_NAME, errmsg);
+            close_scene (toa_input, dem, terrain, output, bin_writer);
+            return (ERROR);
+        }
+        stop_profile_stage (prof, SP_INPUT_READ, &mark,
+            (long long) nlines_proc * toa_input->nsamps,
+            (long long) nlines_proc * toa_input->nsamps *
+            (toa_input->nrefl_band + 1) * sizeof (int16), 0);
+
+        /* Write the lines completed by the previous strip.  This needs to
+           happen before the next read is started, since the HDF library
+           can't be used from two threads at once. */
+        start_profile_stage (prof, &mark);
+        if (put_mask_buffer_lines (mask_buf, output, bin_writer, mask_bin,
+            write_end, count_end - write_end) != SUCCESS)
         {
-            sprintf (errmsg, "Error reading %d lines from the brightness "
-                "temperature file starting at line %d", nlines_proc, line);
+            sprintf (errmsg, "Error writing the output masks for %d lines "
+                "starting at line %d", count_end - write_end, write_end);
             error_handler (true, FUNC_NAME, errmsg);
-            close_input (toa_input);
-            free_input (toa_input);
-            exit (ERROR);
+            close_scene (toa_input, dem, terrain, output, bin_writer);
+            return (ERROR);
         }
-
-        /* Find the location of the current line in the snow cover masks,
-           since they are full scene array buffers */
-        curr_snow_pix = line * toa_input->nsamps;
-
-        /* Set up mask for the TOA reflectance values */
-        refl_mask (toa_input->refl_buf[0] /*b1*/, toa_input->refl_buf[1] /*b2*/,
-            toa_input->refl_buf[2] /*b3*/, toa_input->refl_buf[3] /*b4*/,
-            toa_input->refl_buf[4] /*b5*/, toa_input->refl_buf[5] /*b7*/,
-            nlines_proc, toa_input->nsamps, toa_input->refl_fill,
-            &refl_qa_mask[curr_snow_pix]);
-
-        /* Set up mask for the brightness temperature values */
-        btemp_mask (toa_input->btemp_buf, nlines_proc, toa_input->nsamps,
-            toa_input->btemp_fill, &btemp_qa_mask[curr_snow_pix]);
-
-        /* Compute the cloud mask */
-        cloud_cover_class (toa_input->refl_buf[0] /*b1*/,
-            toa_input->refl_buf[3] /*b4*/, toa_input->btemp_buf /*b6*/,
-            toa_input->refl_buf[5] /*b7*/, nlines_proc, toa_input->nsamps,
-            toa_input->refl_scale_fact, toa_input->btemp_scale_fact,
-            &refl_qa_mask[curr_snow_pix], &btemp_qa_mask[curr_snow_pix],
-            &cloud_mask[curr_snow_pix]);
-
-        /* Compute the snow cover mask */
-        snow_cover_class (toa_input->refl_buf[0] /*b1*/,
-            toa_input->refl_buf[1] /*b2*/, toa_input->refl_buf[2] /*b3*/,
-            toa_input->refl_buf[3] /*b4*/, toa_input->refl_buf[4] /*b5*/,
-            toa_input->btemp_buf /*b6*/, toa_input->refl_buf[5] /*b7*/,
-            nlines_proc, toa_input->nsamps, toa_input->refl_scale_fact,
-            toa_input->btemp_scale_fact, toa_input->refl_saturate_val,
-            &refl_qa_mask[curr_snow_pix], &snow_mask[curr_snow_pix], snow_prob,
-            &tree_node[curr_snow_pix], ndsi, ndvi);
-
-        /* Temporary - write the non snow-related masks to raw binary output */
-        if (write_binary)
+        fold_output_lines (composite, mask_buf, output, write_end,
+            count_end - write_end);
+        count_output_lines (&stats, mask_buf, output, write_end,
+            count_end - write_end);
+        stop_profile_stage (prof, SP_OUTPUT_WRITE, &mark,
+            (long long) (count_end - write_end) * toa_input->nsamps, 0,
+            (long long) (count_end - write_end) * toa_input->nsamps *
+            NUM_OUT_SDS);
+        write_end = count_end;
+
+        /* Release the lines which are no longer needed by the windows for
+           the post-processing (HALF_WINDOW of 4 lines before post_end) or
+           the adjacent snow count (1 line before count_end) */
+        keep_line = post_end - MASK_BUF_EXTRA_NLINES / 2;
+        if (keep_line > count_end - 1)
+            keep_line = count_end - 1;
+        shift_mask_buffer (keep_line, mask_buf);
+
+        /* Start reading the next strip while this one is processed */
+        next_line = line + proc_nlines;
+        if (next_line < toa_input->nlines)
         {
-            fwrite (snow_prob, 1, nlines_proc*toa_input->nsamps * sizeof(uint8),
-                sc_prob_fptr);
-            fwrite (ndvi, 1, nlines_proc*toa_input->nsamps * sizeof(uint8),
-                ndvi_fptr);
-            fwrite (ndsi, 1, nlines_proc*toa_input->nsamps * sizeof(uint8),
-                ndsi_fptr);
+            next_nlines = proc_nlines;
+            if (next_line + next_nlines > toa_input->nlines)
+                next_nlines = toa_input->nlines - next_line;
+            if (start_input_prefetch (toa_input, next_line, next_nlines) !=
+                SUCCESS)
+            {
+                sprintf (errmsg, "Error starting the read of %d lines of the "
+                    "TOA reflectance and brightness temperature files "
+                    "starting at line %d", next_nlines, next_line);
+                error_handler (true, FUNC_NAME, errmsg);
+                close_scene (toa_input, dem, terrain, output, bin_writer);
+                return (ERROR);
+            }
         }
-    }  /* end for line */
-
-    /* Print the processing status if verbose */
-    if (verbose)
-        printf ("  Cloud and snow cover -- %% complete: 100%%\n");
-
-    /* Full scene post-processing of the snow cover pixels to deal with
-       false positives in the dense conifer forest areas */
-    if (verbose)
-        printf ("  Post-processing snow cover mask.\n");
-    post_process_snow_cover_class (toa_input->nlines, toa_input->nsamps,
-        snow_mask, tree_node);
-
-    /* Temporary - write the snow-related masks to raw binary output */
-    if (write_binary)
-    {
-        fwrite (snow_mask, 1, toa_input->nlines * toa_input->nsamps *
-            sizeof(uint8), scm_fptr);
-        fwrite (tree_node, 1, toa_input->nlines * toa_input->nsamps *
-            sizeof(uint8), node_fptr);
-        fwrite (refl_qa_mask, 1, toa_input->nlines * toa_input->nsamps *
-            sizeof(uint8), refl_qa_fptr);
-        fwrite (btemp_qa_mask, 1, toa_input->nlines * toa_input->nsamps *
-            sizeof(uint8), btemp_qa_fptr);
-        fwrite (cloud_mask, 1, toa_input->nlines * toa_input->nsamps *
-            sizeof(uint8), cm_fptr);
-    }
-
-    /* Temporary -- close the mask output files */
-    if (write_binary)
-    {
-        fclose (scm_fptr);
-        fclose (sc_prob_fptr);
-        fclose (node_fptr);
-        fclose (cm_fptr);
-        fclose (ndsi_fptr);
-        fclose (ndvi_fptr);
-    }
 
-    /* Free the mask pointers */
-    if (snow_prob != NULL)
-    {
-        free (snow_prob);
-        snow_prob = NULL;
-    }
-    if (tree_node != NULL)
-    {
-        free (tree_node);
-        tree_node = NULL;
-    }
-    if (ndsi != NULL)
-    {
-        free (ndsi);
-        ndsi = NULL;
-    }
-    if (ndvi != NULL)
-    {
-        free (ndvi);
-        ndvi = NULL;
-    }
-
-    /* Open the DEM for reading raw binary */
-    dem_fptr = fopen (dem_infile, "rb");
-    if (dem_fptr == NULL)
-    {
-        sprintf (errmsg, "Error opening the DEM file: %s", dem_infile);
-        error_handler (true, FUNC_NAME, errmsg);
-        close_input (toa_input);
-        free_input (toa_input);
-        exit (ERROR);
-    }
-
-    /* Allocate memory for the DEM, which will hold PROC_NLINES of data.  The
-       DEM should be the same size as the input scene, since the scene was
-       used to resample the DEM.  To process the shaded relieve we need to
-       read an extra two lines to process a 3x3 window. */
-    dem = (int16 *) calloc ((PROC_NLINES+2) * toa_input->nsamps, sizeof(int16));
-    if (dem == NULL)
-    {
-        sprintf (errmsg, "Error allocating memory for the DEM data");
-        error_handler (true, FUNC_NAME, errmsg);
-        close_input (toa_input);
-        free_input (toa_input);
-        exit (ERROR);
-    }
-
-    /* Allocate memory for the shaded relief and deep shadow mask.  Deep
-       shadow mask needs to be full scene since it will be used as part of
-       the post-processing. */
-    deep_shad_mask = (uint8 *) calloc (toa_input->nlines * toa_input->nsamps,
-        sizeof (uint8));
-    if (deep_shad_mask == NULL)
-    {
-        sprintf (errmsg, "Error allocating memory (full scene) for the deep "
-            "shadow mask");
-        error_handler (true, FUNC_NAME, errmsg);
-        close_input (toa_input);
-        free_input (toa_input);
-        exit (ERROR);
-    }
-
-    shaded_relief = (uint8 *) calloc (PROC_NLINES * toa_input->nsamps,
-        sizeof (uint8));
-    if (shaded_relief == NULL)
-    {
-        sprintf (errmsg, "Error allocating memory for the shaded relief");
-        error_handler (true, FUNC_NAME, errmsg);
-        close_input (toa_input);
-        free_input (toa_input);
-        exit (ERROR);
-    }
-
-    /* If the scene is an ascending polar scene (flipped upside down), then
-       the solar azimuth needs to be adjusted by 180 degrees.  The scene in
-       this case would be north down and the solar azimuth is based on north
-       being up. */
-    if (!toa_input->meta.ul_corner.is_fill &&
-        !toa_input->meta.lr_corner.is_fill &&
-        toa_input->meta.ul_corner.lat < toa_input->meta.lr_corner.lat)
-    {
-        toa_input->meta.solar_az += 180.0*RAD;
-        if (toa_input->meta.solar_az > 360*RAD)
-            toa_input->meta.solar_az -= 360*RAD;
-        printf ("  Polar or ascending scene.  Readjusting solar azimuth by "
-            "180 degrees.\n    New value: %f radians (%f degrees)\n",
-            toa_input->meta.solar_az, toa_input->meta.solar_az*DEG);
-    }
+        /* Find the location of the current line in the mask buffers, since
+           the strip is appended after the lines kept from the previous
+           strip */
+        curr_snow_pix = mask_buf->nlines * toa_input->nsamps;
+
+        /* Process the lines of the strip in parallel.  pix is the location
+           of the current line in the strip buffers; curr_snow_pix + pix is
+           its location in the mask buffers.  Only the valid span of each
+           line is classified, and the fill corners of the scene outside of
+           it are set to the fill results, so a strip which is all fill
+           (toa_input->nvalid_lines is 0) is only cleared. */
+        start_profile_stage (prof, &mark);
+        qa_sec = 0.0;
+        snow_sec = 0.0;
+        nsnow_cand = 0;
+        nskip_lines = 0;
+#ifdef _OPENMP
+        #pragma omp parallel for private(pix, ncand) firstprivate(t0, t1) \
+            reduction(+:qa_sec, snow_sec, nsnow_cand, nskip_lines) \
+            schedule(dynamic, 2)
+#endif
+        for (pline = 0; pline < nlines_proc; pline++)
+        {
+            pix = pline * toa_input->nsamps;
+            if (prof->enabled)
+                t0 = profile_clock ();
+
+            /* Set up the QA masks for the TOA reflectance and brightness
+               temperature values, the cloud mask, and the fill and cloud
+               part of the combined QA mask in one pass */
+            qa_cloud_mask (&toa_input->refl_buf[0][pix] /*b1*/,
+                &toa_input->refl_buf[1][pix] /*b2*/,
+                &toa_input->refl_buf[2][pix] /*b3*/,
+                &toa_input->refl_buf[3][pix] /*b4*/,
+                &toa_input->refl_buf[4][pix] /*b5*/,
+                &toa_input->btemp_buf[pix] /*b6*/,
+                &toa_input->refl_buf[5][pix] /*b7*/, 1, toa_input->nsamps,
+                &toa_input->span[pline], toa_input->refl_fill,
+                toa_input->btemp_fill, &cloud_thresh,
+                &refl_qa_mask[curr_snow_pix + pix],
+                &btemp_qa_mask[curr_snow_pix + pix],
+                &cloud_mask[curr_snow_pix + pix],
+                &combined_bits[(long) (mask_buf->nlines + pline) *
+                mask_buf->nwords]);
+            if (prof->enabled)
+            {
+                t1 = profile_clock ();
+                qa_sec += t1 - t0;
+            }
 
-    /* Print the processing status if verbose */
-    if (verbose)
-    {
-        printf ("  Processing %d lines at a time\n", PROC_NLINES);
-        printf ("  Shaded relief -- %% complete: 0%%\r");
-    }
+            /* Compute the snow cover mask.  If no pixel of the line gets
+               past the water and thermal tests, the snow cover tree is
+               skipped and the line gets the no snow results. */
+            ncand = count_snow_candidates (&toa_input->refl_buf[0][pix],
+                &toa_input->refl_buf[3][pix], &toa_input->btemp_buf[pix], 1,
+                toa_input->nsamps, &toa_input->span[pline],
+                toa_input->refl_scale_fact, toa_input->btemp_scale_fact,
+                toa_input->refl_saturate_val,
+                &refl_qa_mask[curr_snow_pix + pix]);
+            nsnow_cand += ncand;
+            if (ncand == 0)
+            {
+                no_snow_cover_class (1, toa_input->nsamps,
+                    &refl_qa_mask[curr_snow_pix + pix],
+                    &snow_mask[curr_snow_pix + pix], &snow_prob[pix],
+                    &tree_node[curr_snow_pix + pix], &ndsi[pix], &ndvi[pix]);
+                nskip_lines++;
+            }
+            else
+                snow_cover_class (&toa_input->refl_buf[0][pix] /*b1*/,
+                    &toa_input->refl_buf[1][pix] /*b2*/,
+                    &toa_input->refl_buf[2][pix] /*b3*/,
+                    &toa_input->refl_buf[3][pix] /*b4*/,
+                    &toa_input->refl_buf[4][pix] /*b5*/,
+                    &toa_input->btemp_buf[pix] /*b6*/,
+                    &toa_input->refl_buf[5][pix] /*b7*/, 1, toa_input->nsamps,
+                    &toa_input->span[pline], toa_input->refl_scale_fact,
+                    toa_input->btemp_scale_fact, toa_input->refl_saturate_val,
+                    &refl_qa_mask[curr_snow_pix + pix],
+                    &snow_mask[curr_snow_pix + pix], &snow_prob[pix],
+                    &tree_node[curr_snow_pix + pix], &ndsi[pix], &ndvi[pix]);
+            if (prof->enabled)
+                snow_sec += profile_clock () - t1;
+        }  /* end for pline */
+        class_sec[0] = qa_sec;
+        class_sec[1] = snow_sec;
+        split_profile_stage (prof, 2, class_stages, class_sec, &mark,
+            (long long) nlines_proc * toa_input->nsamps);
+        stats.nsnow_cand += nsnow_cand;
+        stats.nskip_lines += nskip_lines;
+
+        /* Temporary - queue the non snow-related masks for raw binary
+           output */
+        if (write_binary)
+        {
+            nbytes_bin = (size_t) nlines_proc * toa_input->nsamps *
+                sizeof (uint8);
+            if (queue_bin_write (bin_writer, BIN_SNOW_PROB, snow_prob,
+                    nbytes_bin) != SUCCESS ||
+                queue_bin_write (bin_writer, BIN_NDVI, ndvi, nbytes_bin)
+                    != SUCCESS ||
+                queue_bin_write (bin_writer, BIN_NDSI, ndsi, nbytes_bin)
+                    != SUCCESS)
+            {
+                sprintf (errmsg, "Error writing the raw binary snow cover "
+                    "probability, NDVI, and NDSI for line %d", line);
+                error_handler (true, FUNC_NAME, errmsg);
+                close_scene (toa_input, dem, terrain, output, bin_writer);
+                return (ERROR);
+            }
+        }
 
-    /* Loop through the lines and samples in the DEM and compute the
-       relief shading */
-    nlines_proc = PROC_NLINES;
-    k = 0;
-    for (line = 0; line < toa_input->nlines; line += nlines_proc)
-    {
-        /* Do we have nlines_proc left to process? */
-        if (line + nlines_proc >= toa_input->nlines)
-            nlines_proc = toa_input->nlines - line;
+        /* Reset the shaded relief to 0s for the current window.  The first
+           and last pixel will not get processed.  The deep shadow mask lines
+           in the mask buffers have already been initialized to 0s. */
+        memset ((void *) shaded_relief, 0, (size_t) proc_nlines *
+            toa_input->nsamps * sizeof (uint8));
 
-        /* Update processing status? */
-        if (verbose && (100 * line / toa_input->nlines > k))
+        /* Compute the shaded relief and associated terrain-derived deep
+           shadow mask, processing the lines of the strip in parallel.  The
+           3x3 windows for scene line dem_line start at DEM line
+           dem_line - 1, which is used in place from the mapped DEM.  The
+           first line of the image and the last line of the image are
+           flagged as the top and bottom, which deep_shadow skips.  With the
+           terrain cache, the shade is computed from the cached normals for
+           the same lines instead.  The DEM isn't fill outside the valid
+           span of each line, so the whole line is processed to keep the
+           shaded relief and deep shadow mask of the fill corners. */
+        start_profile_stage (prof, &mark);
+#ifdef _OPENMP
+        #pragma omp parallel for private(pix, dem_line) schedule(dynamic, 2)
+#endif
+        for (pline = 0; pline < nlines_proc; pline++)
         {
-            k = 100 * line / toa_input->nlines;
-            if (k % 10 == 0)
+            pix = pline * toa_input->nsamps;
+            dem_line = line + pline;
+            if (terrain != NULL)
             {
-                printf ("  Shaded relief -- %% complete: %d%%\r", k);
-                fflush (stdout);
+                if (dem_line > 0 && dem_line < toa_input->nlines - 1)
+                    terrain_shadow (get_terrain_line (terrain, dem_line),
+                        terrain->nsamps, toa_input->nsamps, NULL, &hs,
+                        &shaded_relief[pix],
+                        &deep_shad_mask[curr_snow_pix + pix]);
             }
+            else if (dem_line == 0)
+                deep_shadow (get_dem_line (dem, 0), true, false, 1,
+                    toa_input->nsamps, NULL, &hs, &shaded_relief[pix],
+                    &deep_shad_mask[curr_snow_pix + pix]);
+            else
+                deep_shadow (get_dem_line (dem, dem_line - 1), false,
+                    dem_line == toa_input->nlines - 1, 1, toa_input->nsamps,
+                    NULL, &hs, &shaded_relief[pix],
+                    &deep_shad_mask[curr_snow_pix + pix]);
+        }  /* end for pline */
+        stop_profile_stage (prof, SP_DEM_HILLSHADE, &mark,
+            (long long) nlines_proc * toa_input->nsamps,
+            (long long) nlines_proc * toa_input->nsamps * sizeof (int16) *
+            ((terrain != NULL) ? 3 : 1), 0);
+
+        /* Temporary - queue the shaded relief for raw binary output.  The
+           deep shadow mask is written with the other masks in the mask
+           buffers. */
+        if (write_binary &&
+            queue_bin_write (bin_writer, BIN_RELIEF, shaded_relief,
+            (size_t) nlines_proc * toa_input->nsamps * sizeof (uint8))
+            != SUCCESS)
+        {
+            sprintf (errmsg, "Error writing the raw binary shaded relief for "
+                "line %d", line);
+            error_handler (true, FUNC_NAME, errmsg);
+            close_scene (toa_input, dem, terrain, output, bin_writer);
+            return (ERROR);
         }
 
-        /* Find the location of the current line in the deep shadow mask
-           since it is a full scene array buffer */
-        curr_snow_pix = line * toa_input->nsamps;
-
-        /* Prepare to read the current lines from the DEM.  We need an extra
-           line at the start and end for the shaded relief.  If we are just
-           starting at line 0, then read an extra line from the end of the
-           image window.  If we aren't at line 0, then read an extra line at
-           the start and end of the image window.  If we are at the end of the
-           image, then read an extra line from the start of the image window. */
-        start_line = line - 1;
-        extra_lines_start = 1;
-        dem_top = false;
-        dem_bottom = false;
-        if (start_line < 0)
-        {   /* adjust for the number of lines at the start which we
-               don't have then read at line 0 */
-            extra_lines_start = 0;
-            start_line = 0;
-            dem_top = true;
+        /* Add the deep shadow mask to the combined QA mask, which already
+           has the cloud and fill pixels */
+        start_profile_stage (prof, &mark);
+        combine_qa_mask (nlines_proc, toa_input->nsamps,
+            &deep_shad_mask[curr_snow_pix],
+            &combined_bits[(long) mask_buf->nlines * mask_buf->nwords]);
+        stop_profile_stage (prof, SP_COMBINE, &mark,
+            (long long) nlines_proc * toa_input->nsamps, 0, 0);
+
+        /* Save the snow mask before post-processing for the pre-pass mode */
+        if (prepass_post)
+            memcpy (&mask_buf->mask[MB_SNOW_PREPASS][curr_snow_pix],
+                &snow_mask[curr_snow_pix],
+                nlines_proc * toa_input->nsamps * sizeof (uint8));
+        mask_buf->nlines += nlines_proc;
+        class_end = line + nlines_proc;
+
+        /* Post-process the snow cover pixels to deal with false positives in
+           the dense conifer forest areas.  The 9x9 window needs the four
+           lines after the current line to be classified, unless this is the
+           end of the scene.  In the default raster mode the lines are
+           processed in order, the same as when processing the full scene.
+           In the pre-pass mode the windows are counted in the pre-pass mask,
+           so groups of lines are processed in parallel. */
+        start_profile_stage (prof, &mark);
+        if (class_end == toa_input->nlines)
+            next_line = class_end;
+        else
+            next_line = class_end - MASK_BUF_EXTRA_NLINES / 2;
+        nerrors = 0;
+        if (!prepass_post)
+        {
+            if (post_process_snow_cover_class (mask_buf->nlines,
+                toa_input->nsamps, post_end - mask_buf->first_line,
+                next_line - mask_buf->first_line, NULL, snow_mask, tree_node)
+                != SUCCESS)
+                nerrors++;
         }
-        if (line + nlines_proc < toa_input->nlines)
-            extra_lines_end = 1;
         else
         {
-            extra_lines_end = 0;
-            dem_bottom = true;
+#ifdef _OPENMP
+            #pragma omp parallel for reduction(+:nerrors) schedule(dynamic, 1)
+#endif
+            for (pline = post_end - mask_buf->first_line;
+                 pline < next_line - mask_buf->first_line;
+                 pline += POST_PROCESS_NLINES)
+            {
+                if (post_process_snow_cover_class (mask_buf->nlines,
+                    toa_input->nsamps, pline, (pline + POST_PROCESS_NLINES <
+                    next_line - mask_buf->first_line) ? pline +
+                    POST_PROCESS_NLINES : next_line - mask_buf->first_line,
+                    mask_buf->mask[MB_SNOW_PREPASS], snow_mask, tree_node)
+                    != SUCCESS)
+                    nerrors++;
+            }
         }
-
-        /* Start reading from the start_line and read
-           nlines_proc + extra_lines_start + extra_lines_end lines */
-        nvals_to_read = (nlines_proc+extra_lines_start+extra_lines_end) *
-            toa_input->nsamps;
-        offset = sizeof (int16) * start_line * toa_input->nsamps;
-        fseek (dem_fptr, offset, SEEK_SET);
-        if (fread (dem, sizeof (int16), nvals_to_read, dem_fptr)
-            != nvals_to_read)
+        if (nerrors > 0)
         {
-            sprintf (errmsg, "Error reading %d values from the DEM file "
-                "starting at line %d.", nvals_to_read, start_line);
+            sprintf (errmsg, "Error post-processing the snow cover mask "
+                "through line %d", next_line);
             error_handler (true, FUNC_NAME, errmsg);
-            close_input (toa_input);
-            free_input (toa_input);
-            fclose (dem_fptr);
-            exit (ERROR);
+            close_scene (toa_input, dem, terrain, output, bin_writer);
+            return (ERROR);
         }
 
-        /* Reset the shaded relief to 0s for the current window.  The first
-           and last pixel will not get processed.  The entire deep shadow mask
-           has already been initialized to 0s. */
-        memset ((void *) shaded_relief, 0, PROC_NLINES * toa_input->nsamps
-            * sizeof (uint8));
-
-        /* Compute the shaded relief and associated terrain-derived deep
-           shadow mask */
-        deep_shadow (dem, dem_top, dem_bottom, nlines_proc, toa_input->nsamps,
-            toa_input->meta.pixsize, toa_input->meta.pixsize,
-            toa_input->meta.solar_elev, toa_input->meta.solar_az,
-            shaded_relief, &deep_shad_mask[curr_snow_pix]);
-
-        /* Temporary - write the shaded relief and deep shadow mask to raw
-           binary output */
-        if (write_binary)
+        /* Pack the post-processed lines of the snow mask for the adjacent
+           snow count */
+#ifdef _OPENMP
+        #pragma omp parallel for schedule(static)
+#endif
+        for (pline = post_end - mask_buf->first_line;
+             pline < next_line - mask_buf->first_line; pline++)
+        {
+            pack_mask_line (&snow_mask[(long) pline * toa_input->nsamps],
+                toa_input->nsamps, SNOW_COVER,
+                &snow_bits[(long) pline * mask_buf->nwords]);
+        }
+        stop_profile_stage (prof, SP_POST_PROCESS, &mark,
+            (long long) (next_line - post_end) * toa_input->nsamps, 0, 0);
+        post_end = next_line;
+
+        /* Count the adjacent snow cover pixels and flag pixels with adjacent
+           cloud, shadow, or fill pixels.  The 3x3 window needs the line after
+           the current line to be post-processed, unless this is the end of
+           the scene.  The lines are independent, so they are processed in
+           parallel. */
+        start_profile_stage (prof, &mark);
+        if (post_end == toa_input->nlines)
+            next_line = post_end;
+        else
+            next_line = post_end - 1;
+#ifdef _OPENMP
+        #pragma omp parallel for schedule(dynamic, 4)
+#endif
+        for (pline = count_end - mask_buf->first_line;
+             pline < next_line - mask_buf->first_line; pline++)
         {
-            fwrite (shaded_relief, 1, nlines_proc*toa_input->nsamps *
-                sizeof(uint8), relief_fptr);
+            count_adjacent_snow_cover (mask_buf->nlines, toa_input->nsamps,
+                pline, pline + 1, snow_bits, combined_bits, snow_count);
         }
+        stop_profile_stage (prof, SP_SNOW_COUNT, &mark,
+            (long long) (next_line - count_end) * toa_input->nsamps, 0, 0);
+        count_end = next_line;
     }  /* end for line */
 
-    /* Temporary - write the deep shadow mask to raw binary output */
-    if (write_binary)
+    /* Write the remaining lines */
+    start_profile_stage (prof, &mark);
+    if (put_mask_buffer_lines (mask_buf, output, bin_writer, mask_bin,
+        write_end, count_end - write_end) != SUCCESS)
     {
-        fwrite (deep_shad_mask, 1, toa_input->nlines * toa_input->nsamps *
-            sizeof(uint8), dsm_fptr);
+        sprintf (errmsg, "Error writing the output masks for %d lines "
+            "starting at line %d", count_end - write_end, write_end);
+        error_handler (true, FUNC_NAME, errmsg);
+        close_scene (toa_input, dem, terrain, output, bin_writer);
+        return (ERROR);
     }
+    fold_output_lines (composite, mask_buf, output, write_end,
+        count_end - write_end);
+    count_output_lines (&stats, mask_buf, output, write_end,
+        count_end - write_end);
+    stop_profile_stage (prof, SP_OUTPUT_WRITE, &mark,
+        (long long) (count_end - write_end) * toa_input->nsamps, 0,
+        (long long) (count_end - write_end) * toa_input->nsamps *
+        NUM_OUT_SDS);
+    write_end = count_end;
 
     /* Print the processing status if verbose */
     if (verbose)
-        printf ("  Shaded relief -- %% complete: 100%%\n");
-
-    /* Temporary -- close the mask output files for raw binary output */
-    if (write_binary)
     {
-        fclose (dem_fptr);
-        fclose (dsm_fptr);
-        fclose (relief_fptr);
+        printf ("  Snow cover -- %% complete: 100%%\n");
+        printf ("  Snow cover candidates: %ld; snow cover tree skipped for "
+            "%ld lines\n", stats.nsnow_cand, stats.nskip_lines);
+        if (stats.nvalid > 0)
+            printf ("  Cloud cover: %.2f%%, snow cover: %.2f%% of %ld valid "
+                "pixels\n", 100.0 * stats.ncloud / stats.nvalid,
+                100.0 * stats.nsnow / stats.nvalid, stats.nvalid);
     }
 
-    /* Free the mask pointers */
-    if (dem != NULL)
+    /* Record the scene in the composite state */
+    if (composite != NULL && finish_composite_scene (composite) != SUCCESS)
     {
-        free (dem);
-        dem = NULL;
-    }
-    if (shaded_relief != NULL)
-    {
-        free (shaded_relief);
-        shaded_relief = NULL;
-    }
-
-    /* Allocate memory for the combined QA mask (full scene to handle
-       post-processing) */
-    combined_qa = (uint8 *) calloc (toa_input->nlines * toa_input->nsamps,
-        sizeof (uint8));
-    if (combined_qa == NULL)
-    {
-        sprintf (errmsg, "Error allocating memory (full scene) for the "
-            "combined QA mask.");
+        sprintf (errmsg, "Error finishing the composite of %s", toa_infile);
         error_handler (true, FUNC_NAME, errmsg);
-        close_input (toa_input);
-        free_input (toa_input);
-        exit (ERROR);
-    }
-
-    /* Combine the cloud, deep shadow, and fill QA masks */
-    if (verbose)
-        printf ("  Combining the cloud, deep shadow, and fill QA masks.\n");
-    combine_qa_mask (toa_input->nlines, toa_input->nsamps, cloud_mask,
-        deep_shad_mask, refl_qa_mask, btemp_qa_mask, combined_qa);
-
-    /* Allocate memory for the snow count mask (full scene to handle
-       post-processing) */
-    snow_count = (uint8 *) calloc (toa_input->nlines * toa_input->nsamps,
-        sizeof (uint8));
-    if (snow_count == NULL)
-    {
-        sprintf (errmsg, "Error allocating memory (full scene) for the snow "
-            "count array");
-        error_handler (true, FUNC_NAME, errmsg);
-        close_input (toa_input);
-        free_input (toa_input);
-        exit (ERROR);
+        close_scene (toa_input, dem, terrain, output, bin_writer);
+        return (ERROR);
     }
 
-    /* Full scene post-processing of the snow cover pixels to count the
-       adjacent cloud pixels and to flag pixels with adjacent cloud, shadow,
-       or fill pixels */
-    if (verbose)
-        printf ("  Post-processing adjacent pixel snow count.\n");
-    count_adjacent_snow_cover (toa_input->nlines, toa_input->nsamps,
-        snow_mask, combined_qa, snow_count);
-
-    /* Write the data to the HDF file for the entire image. Note: look at the
-       order of the SDS names in out_sds_names for setting up the output
-       buffer correctly. */
-    if (verbose)
-        printf ("  Writing data to the HDF file.\n");
-    output->buf[0] = refl_qa_mask;
-    output->buf[1] = btemp_qa_mask;
-    output->buf[2] = snow_mask;
-    output->buf[3] = cloud_mask;
-    output->buf[4] = deep_shad_mask;
-    output->buf[5] = combined_qa;
-    for (band = 0; band < NUM_OUT_SDS; band++)
+    /* Temporary -- wait for the queued raw binary writes and close the mask
+       output files */
+    if (write_binary)
     {
-        if (put_output_line (output, band, 0, toa_input->nlines) != SUCCESS)
+        if (verbose)
+            printf ("  Raw binary output: %lld bytes, waited for a free "
+                "buffer %ld times\n", bin_writer->nbytes,
+                bin_writer->nwaits);
+        retval = close_bin_writer (bin_writer);
+        bin_writer = NULL;
+        if (retval != SUCCESS)
         {
-            sprintf (errmsg, "Writing output data to HDF for band %d", band);
+            sprintf (errmsg, "Error writing the raw binary output files");
             error_handler (true, FUNC_NAME, errmsg);
-            close_input (toa_input);
-            free_input (toa_input);
-            exit (ERROR);
+            close_scene (toa_input, dem, terrain, output, bin_writer);
+            return (ERROR);
         }
     }
+    close_dem (dem);
+    dem = NULL;
+    close_terrain (terrain);
+    terrain = NULL;
+
+    /* Read the geographic bounds of the scene for the metadata.  They don't
+       apply to a window, so they're left as fill for one. */
+    if (window->nlines == 0 && get_input_bounds (toa_input) != SUCCESS)
+    {
+        sprintf (errmsg, "Error reading the bounding coordinates of %s",
+            toa_infile);
+        error_handler (true, FUNC_NAME, errmsg);
+        close_scene (toa_input, dem, terrain, output, bin_writer);
+        return (ERROR);
+    }
+    if (verbose && !toa_input->meta.bounds.is_fill)
+        printf ("  Bounding coords: west %f, east %f, north %f, south %f\n",
+            toa_input->meta.bounds.min_lon, toa_input->meta.bounds.max_lon,
+            toa_input->meta.bounds.max_lat, toa_input->meta.bounds.min_lat);
 
     /* Write the output metadata */
     if (put_metadata (output, NUM_OUT_SDS, out_sds_names, QA_on, QA_off,
-        &toa_input->meta) != SUCCESS)
+        &toa_input->meta, &stats) != SUCCESS)
     {
         sprintf (errmsg, "Error writing metadata to the output HDF file");
         error_handler (true, FUNC_NAME, errmsg);
-        close_input (toa_input);
-        free_input (toa_input);
-        exit (ERROR);
+        close_scene (toa_input, dem, terrain, output, bin_writer);
+        return (ERROR);
     }
 
     /* Close the TOA reflectance and brightness temperature products and the
        output snow cover product */
     close_input (toa_input);
-    close_output (output);
+    if (close_output (output) != SUCCESS)
+    {
+        sprintf (errmsg, "Error closing the output snow cover product");
+        error_handler (true, FUNC_NAME, errmsg);
+        free_input (toa_input);
+        free_output (output);
+        return (ERROR);
+    }
     free_output (output);
+    output = NULL;
 
     /* Write the spatial information, after the file has been closed */
     for (band = 0; band < NUM_OUT_SDS; band++)
@@ -776,67 +1358,335 @@ int main (int argc, char *argv[])
         sprintf (errmsg, "Error writing spatial metadata to the output HDF "
             "file");
         error_handler (true, FUNC_NAME, errmsg);
-        close_input (toa_input);
-        free_input (toa_input);
-        exit (ERROR);
+        close_scene (toa_input, dem, terrain, output, bin_writer);
+        return (ERROR);
     }
 
-    /* Temporary - write the combined QA and adjacent snow cover count to
-       raw binary output */
+    /* Temporary -- write the ENVI headers */
     if (write_binary)
     {
-        fwrite (combined_qa, 1, toa_input->nlines * toa_input->nsamps *
-            sizeof(uint8), combined_fptr);
-        fwrite (snow_count, 1, toa_input->nlines * toa_input->nsamps *
-            sizeof(uint8), adj_count_fptr);
+        if (verbose)
+            printf ("  Creating ENVI headers for each mask.\n");
+        for (band = 0; band < NUM_BIN_MASKS; band++)
+        {
+            if (snprintf (envi_file, STR_SIZE, "%s_%s.hdr", bin_prefix,
+                bin_mask_names[band]) >= STR_SIZE)
+            {
+                sprintf (errmsg, "ENVI header filename for the %s raw binary "
+                    "output is too long", bin_mask_names[band]);
+                error_handler (true, FUNC_NAME, errmsg);
+                free_input (toa_input);
+                return (ERROR);
+            }
+            if (write_envi_hdr (envi_file, toa_input, &space_def) == ERROR)
+            {
+                free_input (toa_input);
+                return (ERROR);
+            }
+        }
     }
 
-    /* Temporary -- close the combined QA and adjacent snow cover count files
-       for raw binary output */
-    if (write_binary)
+    /* Free the TOA reflectance and brightness temperature pointers */
+    free_input (toa_input);
+
+    return (SUCCESS);
+}
+
+
+/******************************************************************************
+MODULE:  scene_based_sca
+
+PURPOSE:  Calculate the snow cover mask, cloud cover mask, deep shadow mask,
+and shaded relieve for the current scene, provided the TOA reflectance,
+brightness temperature, and elevation.
+
+RETURN VALUE:
+Type = int
+Value           Description
+-----           -----------
+ERROR           An error occurred during processing of the snow cover
+SUCCESS         Processing was successful
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+12/31/2012    Gail Schmidt     Original Development
+2/11/2012     Gail Schmidt     Updated to write an ENVI header when processing
+                               raw binary outputs
+2/13/2012     Gail Schmidt     Added support for counting the number of
+                               adjacent snow-covered pixels
+2/15/2013     Gail Schmidt     Added support for HDF-EOS output files
+2/21/2013     Gail Schmidt     Added support for a combined QA mask for clouds,
+                               deep shadows, and fill QA pixels
+3/21/2013     Gail Schmidt     Modifed to support polar stereographic products
+3/21/2013     Gail Schmidt     Adjusted the solar azimuth if the scene is
+                               flipped/ascending
+10/14/2026    agent            Split the lines of each strip across threads
+                               (OpenMP) for the masks and classifications
+10/14/2026    agent            Read the next strip of TOA reflectance and
+                               brightness temp while the current strip is
+                               processed
+10/14/2026    agent            Stream the masks through rolling strip buffers,
+                               computing the deep shadow mask, post-processing,
+                               and adjacent snow count as each strip is
+                               classified, instead of holding full scenes
+10/14/2026    agent            Convert the cloud cover thresholds to unscaled
+                               values once for the scene
+10/14/2026    agent            Set up the hillshade sun terms once for the
+                               scene
+10/14/2026    agent            Memory map the DEM and use its lines in place
+                               rather than reading each strip and its overlap
+                               lines
+10/14/2026    agent            Compute the QA masks, cloud mask, and the fill
+                               and cloud part of the combined QA mask in a
+                               single pass over the bands
+10/14/2026    agent            Keep the combined QA mask and the snow mask for
+                               the adjacent snow count packed one bit per
+                               pixel
+10/14/2026    agent            Added the batch mode, which processes the
+                               scenes in a manifest in one run
+10/14/2026    agent            Added the --profile JSON summary of the time
+                               and throughput of each processing stage
+10/14/2026    agent            Added the --window processing of a subset of
+                               the scene
+10/14/2026    agent            Added the --mem_budget_mb sizing of the strips
+10/14/2026    agent            Added the --tiled_output files, with overviews
+10/14/2026    agent            Write the --write_binary files from a writer
+                               thread, named after the output file
+10/14/2026    agent            Added the --terrain_cache of the DEM surface
+                               normals for the shaded relief
+10/14/2026    agent            Only process the valid span of each line,
+                               skipping the fill corners of the scene
+10/14/2026    agent            Added the --composite state of the snow
+                               cover time series
+
+NOTES:
+  1. The scene-based snow cover mask is based on an algorithm developed by
+     Dave Selkowitz, Research Geographer, USGS Alaska Science Center.
+  2. Processing will occur on a subset of lines at a time.  The masks are
+     held in rolling buffers of PROC_NLINES + MASK_BUF_EXTRA_NLINES lines
+     rather than full-scene buffers.  With --mem_budget_mb, the strip height
+     is picked for each scene so the buffers fit in the budget.  The snow
+     cover post-processing (9x9 window) and the adjacent snow count (3x3
+     window) follow behind the classification of each strip, and the lines
+     are written to the output file as soon as they are final.  The
+     post-processing still visits the lines in order, so the results match
+     processing the full scene at once.
+  3. The QA masks, cloud and snow classifications, and the shaded relief are
+     computed independently for each line, so the lines of the current strip
+     are divided among the threads.  Each thread calls the classifiers for
+     its lines using pointers offset to the start of each line.  The reading
+     of the strips and the full scene post-processing remain single-threaded.
+  4. The strips are double-buffered.  The next strip is read by a prefetch
+     thread while the current strip is processed, so the HDF reads overlap
+     the classification.
+  5. With --manifest, each line of the manifest names the TOA reflectance,
+     brightness temperature, DEM, and output snow cover files for a scene,
+     separated by white space.  Blank lines and lines starting with '#' are
+     skipped.  The scenes are processed one after the other, since the HDF
+     library isn't thread safe.  The OpenMP threads and the strip and mask
+     buffers are kept from one scene to the next, so each scene only pays
+     for opening its own files.  A scene which fails is reported and the
+     rest of the scenes are still processed.
+  6. With --tiled_output, each output SDS is also written to a tiled file
+     with overviews (see tiled_output.h), which can be read a tile at a time
+     without converting the HDF file.
+  7. With --terrain_cache, the surface normals of each DEM are kept in the
+     cache directory (see terrain.h), so the scenes of a path/row, which
+     share a DEM, only compute them once across the runs.
+  8. With --composite, each scene is folded into the memory mapped state
+     file of the path/row (see composite.h), which holds the last clear
+     date, the first and last snow dates, and the clear and snow counts of
+     each pixel.  The state persists across the runs, so each run only pays
+     for its own scenes.
+******************************************************************************/
+int main (int argc, char *argv[])
+{
+    bool verbose;            /* verbose flag for printing messages */
+    bool write_binary;       /* should we write raw binary output? */
+    bool prepass_post;       /* should the snow cover post-processing count
+                                the pre-pass snow mask? */
+    char FUNC_NAME[] = "main"; /* function name */
+    char errmsg[STR_SIZE];   /* error message */
+    char *toa_infile=NULL;   /* input TOA filename */
+    char *btemp_infile=NULL; /* input brightness temperature filename */
+    char *dem_infile=NULL;   /* input DEM filename */
+    char *sc_outfile=NULL;   /* output snow cover filename */
+    char *manifest=NULL;     /* batch manifest filename */
+    char *profile_file=NULL; /* profile JSON filename; NULL for stdout */
+    char *terrain_cache=NULL;  /* terrain cache directory; NULL if the
+                                terrain isn't cached */
+    char *composite_file=NULL;  /* composite state filename; NULL if the
+                                scenes aren't composited */
+    bool profile;            /* should the processing stages be profiled */
+    char mline[MANIFEST_LINE_SIZE];   /* current line of the manifest */
+    char scene_toa[STR_SIZE];     /* TOA filename for the manifest scene */
+    char scene_btemp[STR_SIZE];   /* brightness temp filename for the scene */
+    char scene_dem[STR_SIZE];     /* DEM filename for the scene */
+    char scene_sc[STR_SIZE];      /* snow cover filename for the scene */
+    char *cptr = NULL;       /* first non-blank character of the line */
+    int retval;              /* return status */
+    int iline;               /* current line of the manifest */
+    int nscenes = 0;         /* number of scenes processed */
+    int nfailed = 0;         /* number of scenes which failed */
+    int nthreads = 0;        /* number of threads for processing; 0 uses the
+                                OpenMP default */
+    FILE *manifest_fptr=NULL;  /* batch manifest file pointer */
+    Scene_buffers_t sb;      /* buffers reused between the scenes */
+    Profile_t prof;          /* profile of the processing stages */
+    Img_window_t window;     /* window of the scene to be processed */
+    long mem_budget_mb;      /* megabytes of memory to size the strips for;
+                                0 for strips of PROC_NLINES lines */
+    bool tiled_output;       /* should the tiled output files be written? */
+    bool batch;              /* are the scenes read from a batch manifest? */
+    Composite_t *composite = NULL;  /* composite state of the scenes; NULL
+                                if the scenes aren't composited */
+
+    printf ("Starting scene-based snow cover processing ...\n");
+
+    /* Read the command-line arguments, including the name of the input
+       Landsat TOA reflectance product and the DEM, or the manifest of
+       scenes */
+    retval = get_args (argc, argv, &toa_infile, &btemp_infile, &dem_infile,
+        &sc_outfile, &manifest, &write_binary, &prepass_post, &nthreads,
+        &profile, &profile_file, &window, &mem_budget_mb, &tiled_output,
+        &terrain_cache, &composite_file, &verbose);
+    if (retval != SUCCESS)
+    {   /* get_args already printed the error message */
+        exit (ERROR);
+    }
+    batch = (manifest != NULL);
+
+    /* Set up the number of threads for processing */
+#ifdef _OPENMP
+    if (nthreads > 0)
+        omp_set_num_threads (nthreads);
+    else
+        nthreads = omp_get_max_threads ();
+#else
+    if (nthreads > 1)
+        printf ("  Warning: not built with OpenMP support.  Processing with "
+            "a single thread.\n");
+    nthreads = 1;
+#endif
+
+    /* Provide user information if verbose is turned on */
+    if (verbose)
     {
-        fclose (adj_count_fptr);
-        fclose (combined_fptr);
+        if (manifest)
+            printf ("  Batch manifest: %s\n", manifest);
+        printf ("  Number of threads: %d\n", nthreads);
+        if (prepass_post)
+            printf ("  Post-processing the snow cover with the pre-pass "
+                "mask.\n");
+        if (terrain_cache)
+            printf ("  Terrain cache directory: %s\n", terrain_cache);
+        if (composite_file)
+            printf ("  Composite state file: %s\n", composite_file);
     }
 
-    /* Temporary -- write the ENVI headers */
-    if (write_binary)
+    /* Set up the composite state, which is mapped by the first scene */
+    if (composite_file != NULL)
     {
-        if (verbose)
-            printf ("  Creating ENVI headers for each mask.\n");
-        if (write_envi_hdr ("snow_cover_mask.hdr", toa_input, &space_def)
-            == ERROR)
-            exit (ERROR);
-        if (write_envi_hdr ("snow_cover_probability_score.hdr", toa_input,
-            &space_def) == ERROR)
-            exit (ERROR);
-        if (write_envi_hdr ("snow_cover_node.hdr", toa_input, &space_def)
-            == ERROR)
-            exit (ERROR);
-        if (write_envi_hdr ("adjacent_snow_count.hdr", toa_input, &space_def)
-            == ERROR)
-            exit (ERROR);
-        if (write_envi_hdr ("cloud_mask.hdr", toa_input, &space_def) == ERROR)
-            exit (ERROR);
-        if (write_envi_hdr ("deep_shadow_mask.hdr", toa_input, &space_def)
-            == ERROR)
-            exit (ERROR);
-        if (write_envi_hdr ("shade_relief.hdr", toa_input, &space_def) == ERROR)
-            exit (ERROR);
-        if (write_envi_hdr ("toa_refl_qa.hdr", toa_input, &space_def) == ERROR)
-            exit (ERROR);
-        if (write_envi_hdr ("btemp_qa.hdr", toa_input, &space_def) == ERROR)
-            exit (ERROR);
-        if (write_envi_hdr ("combined_qa.hdr", toa_input, &space_def) == ERROR)
+        composite = open_composite (composite_file);
+        if (composite == NULL)
+        {
+            sprintf (errmsg, "Error opening the composite state file: %s",
+                composite_file);
+            error_handler (true, FUNC_NAME, errmsg);
             exit (ERROR);
-        if (write_envi_hdr ("ndsi.hdr", toa_input, &space_def) == ERROR)
+        }
+    }
+
+    init_scene_buffers (&sb);
+    init_profile (profile, SP_NUM, profile_stage_names, &prof);
+    if (manifest == NULL)
+    {
+        /* Process the scene from the command line */
+        if (process_scene (toa_infile, btemp_infile, dem_infile, sc_outfile,
+            write_binary, prepass_post, verbose, &window, mem_budget_mb,
+            tiled_output, terrain_cache, composite, &sb, &prof) != SUCCESS)
+        {
+            sprintf (errmsg, "Error processing the snow cover for %s",
+                toa_infile);
+            error_handler (true, FUNC_NAME, errmsg);
             exit (ERROR);
-        if (write_envi_hdr ("ndvi.hdr", toa_input, &space_def) == ERROR)
+        }
+        nscenes++;
+    }
+    else
+    {
+        /* Process each of the scenes in the manifest */
+        manifest_fptr = fopen (manifest, "r");
+        if (manifest_fptr == NULL)
+        {
+            sprintf (errmsg, "Error opening the batch manifest: %s", manifest);
+            error_handler (true, FUNC_NAME, errmsg);
             exit (ERROR);
+        }
+
+        iline = 0;
+        while (fgets (mline, sizeof (mline), manifest_fptr) != NULL)
+        {
+            iline++;
+            cptr = mline;
+            while (isspace ((unsigned char) *cptr))
+                cptr++;
+            if (*cptr == '\0' || *cptr == '#')
+                continue;
+
+            if (sscanf (cptr, "%1023s %1023s %1023s %1023s", scene_toa,
+                scene_btemp, scene_dem, scene_sc) != 4)
+            {
+                sprintf (errmsg, "Line %d of the batch manifest doesn't have "
+                    "the TOA, brightness temperature, DEM, and snow cover "
+                    "files", iline);
+                error_handler (true, FUNC_NAME, errmsg);
+                nfailed++;
+                continue;
+            }
+
+            printf ("  Scene %d: %s\n", nscenes + nfailed + 1, scene_toa);
+            if (process_scene (scene_toa, scene_btemp, scene_dem, scene_sc,
+                write_binary, prepass_post, verbose, &window, mem_budget_mb,
+                tiled_output, terrain_cache, composite, &sb, &prof) !=
+                SUCCESS)
+            {
+                snprintf (errmsg, sizeof (errmsg),
+                    "Error processing the snow cover for %.*s",
+                    (int) (sizeof (errmsg) / 2), scene_toa);
+                error_handler (true, FUNC_NAME, errmsg);
+                nfailed++;
+                continue;
+            }
+            nscenes++;
+        }
+        fclose (manifest_fptr);
     }
 
-    /* Free the TOA reflectance and brightness temperature pointers */
-    free_input (toa_input);
+    /* Close the composite state file */
+    if (close_composite (composite) != SUCCESS)
+    {
+        sprintf (errmsg, "Error closing the composite state file: %s",
+            composite_file);
+        error_handler (true, FUNC_NAME, errmsg);
+        exit (ERROR);
+    }
+
+    /* Write the profile of the processing stages, if requested */
+    if (write_profile (&prof, "scene_based_sca", nthreads, profile_file)
+        != SUCCESS)
+    {
+        sprintf (errmsg, "Error writing the profile");
+        error_handler (true, FUNC_NAME, errmsg);
+        exit (ERROR);
+    }
+
+    /* Free the buffers */
+    free_scene_buffers (&sb);
 
     /* Free the filename pointers */
     if (toa_infile != NULL)
@@ -847,29 +1697,36 @@ int main (int argc, char *argv[])
         free (dem_infile);
     if (sc_outfile != NULL)
         free (sc_outfile);
-
-    /* Free the mask pointers */
-    if (refl_qa_mask != NULL)
-        free (refl_qa_mask);
-    if (btemp_qa_mask != NULL)
-        free (btemp_qa_mask);
-    if (cloud_mask != NULL)
-        free (cloud_mask);
-    if (snow_mask != NULL)
-        free (snow_mask);
-    if (snow_count != NULL)
-        free (snow_count);
-    if (deep_shad_mask != NULL)
-        free (deep_shad_mask);
-    if (combined_qa != NULL)
-        free (combined_qa);
+    if (manifest != NULL)
+    {
+        free (manifest);
+        manifest = NULL;
+    }
+    if (profile_file != NULL)
+        free (profile_file);
+    if (terrain_cache != NULL)
+        free (terrain_cache);
+    if (composite_file != NULL)
+        free (composite_file);
+
+    /* Report the scenes which failed in the batch */
+    if (nfailed > 0)
+    {
+        sprintf (errmsg, "%d of the %d scenes in the batch manifest failed",
+            nfailed, nscenes + nfailed);
+        error_handler (true, FUNC_NAME, errmsg);
+        exit (ERROR);
+    }
 
     /* Indicate successful completion of processing */
+    if (batch)
+        printf ("  Number of scenes processed: %d\n", nscenes);
     printf ("Scene-based snow cover processing complete!\n");
     exit (SUCCESS);
 }
 
 
+
 /******************************************************************************
 MODULE:  usage
 
@@ -896,20 +1753,77 @@ void usage ()
             "--btemp=input_brightness_temperature_Landsat_filename "
             "--dem=input_DEM_filename "
             "--snow_cover=output_snow_cover_filename "
+            "[--threads=num_threads] [--prepass_post_process] "
+            "[--profile[=profile_file]] "
+            "[--window=line0,samp0,nlines,nsamps] "
+            "[--mem_budget_mb=megabytes] [--tiled_output] "
+            "[--terrain_cache=cache_dir] [--composite=state_file] "
+            "[--write_binary] [--verbose]\n");
+    printf ("   or: scene_based_snow_cover --manifest=batch_manifest_filename "
+            "[--threads=num_threads] [--prepass_post_process] "
+            "[--profile[=profile_file]] "
+            "[--window=line0,samp0,nlines,nsamps] "
+            "[--mem_budget_mb=megabytes] [--tiled_output] "
+            "[--terrain_cache=cache_dir] [--composite=state_file] "
             "[--write_binary] [--verbose]\n");
 
     printf ("\nwhere the following parameters are required:\n");
     printf ("    -toa: name of the input Landsat TOA reflectance file to be "
             "classified (HDF)\n");
-    printf ("    -btemp: name of the input Landsat brightness temperature file "
-            "to be classified (HDF)\n");
+    printf ("    -btemp: name of the input Landsat brightness temperature "
+            "file to be classified (HDF)\n");
     printf ("    -dem: name of the DEM associated with the Landsat TOA file "
             "(raw binary 16-bit integers)\n");
     printf ("    -snow_cover: name of the output snow cover file (HDF)\n");
+    printf ("    -manifest: name of a batch manifest, replacing the four "
+            "file parameters above.  Each line of the manifest holds the "
+            "TOA, brightness temperature, DEM, and snow cover files for one "
+            "scene, and all the scenes are processed in one run.\n");
     printf ("\nwhere the following parameters are optional:\n");
+    printf ("    -threads: number of threads to use for processing "
+            "(default is the number of cores)\n");
+    printf ("    -prepass_post_process: should the snow cover "
+            "post-processing count the snow mask from before the "
+            "post-processing, rather than the mask as it is being modified? "
+            "This allows the post-processing to run in parallel, but the "
+            "results may differ slightly from the original algorithm. "
+            "(default is false)\n");
+    printf ("    -profile: write a JSON summary of the time, bytes, and "
+            "pixels per second of each processing stage, to profile_file "
+            "if given, otherwise to stdout (default is no profile)\n");
+    printf ("    -window: only process the window of nlines lines and "
+            "nsamps samples starting at line line0 and sample samp0 (0-based) "
+            "of each scene.  The output covers the window, with the same "
+            "values as for the whole scene with --prepass_post_process, "
+            "which is required.  Not supported with --write_binary. "
+            "(default is the whole scene)\n");
+    printf ("    -mem_budget_mb: megabytes of memory for the processing "
+            "buffers.  The strip height is picked for each scene so the "
+            "buffers fit, and the choice is reported. (default is strips of "
+            "%d lines)\n", PROC_NLINES);
+    printf ("    -tiled_output: should each output SDS also be written to a "
+            "tiled file with overviews, named after the output file with "
+            "_sds_name.tile in place of its extension?  The tiles are %dx%d "
+            "pixels and deflate compressed, and the overviews hold every "
+            "other line and sample of the level before them. (default is "
+            "false)\n", TILE_SIZE, TILE_SIZE);
+    printf ("    -terrain_cache: directory in which to cache the surface "
+            "normals of each DEM, so the shaded relief of the scenes which "
+            "share a DEM is computed from the cached normals instead of the "
+            "DEM.  The cache is built the first time a DEM is used and "
+            "rebuilt if the DEM changes.  The shaded relief can differ from "
+            "the one computed from the DEM by the rounding of the normals. "
+            "(default is no cache)\n");
+    printf ("    -composite: name of the snow cover composite state file of "
+            "the path/row, into which each scene is folded.  It holds the "
+            "last clear date, the first and last snow dates, and the clear "
+            "and snow counts of each pixel of the output image, and is "
+            "created by the first scene.  A scene whose date is already in "
+            "the state is skipped. (default is no composite)\n");
     printf ("    -write_binary: should raw binary outputs and ENVI header "
-            "files be written in addition to the HDF file? (default is false)"
-            "\n");
+            "files be written in addition to the HDF file?  They are named "
+            "after the output file with _name.bin and _name.hdr in place of "
+            "its extension. (default is false)\n");
     printf ("    -verbose: should intermediate messages be printed? (default "
             "is false)\n");
     printf ("\nscene_based_sca --help will print the usage statement\n");
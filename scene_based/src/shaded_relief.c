@@ -1,16 +1,24 @@
 #include "sca.h"
 
+/* The vectorized shaded relief from the terrain normals is compiled for AVX2 with gcc's target
+   attribute and selected at run time, so the application doesn't need to be
+   built with -mavx2 to use it */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SHADED_RELIEF_AVX2
+#include <immintrin.h>
+#endif
+
+/* Constant from GDAL for the Horn algorithm (1/8) */
+#define HORN_Z_SCALE 0.125
+
 /******************************************************************************
-MODULE:  hillshade
+MODULE:  init_hillshade
 
-PURPOSE:  Performs the hillshade algorithm (from GDALDEM) to compute the
-shaded relief for the current 3x3 window.
+PURPOSE:  Sets up the terms of the hillshade algorithm which are constant for
+the scene, so they don't need to be computed for each pixel.
 
 RETURN VALUE:
-Type = float 
-Value      Description
------      -----------
-0.0 - 1.0  Represents the shaded relief for the current pixel area
+Type = None
 
 PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
 at the USGS EROS
@@ -25,65 +33,469 @@ Date        Programmer       Reason
                              top to the bottom of the image.  Thus the ns_res
                              needs to be negative or the slope is incorrect.
 2/1/2013    Gail Schmidt     Added z scaling for Horn's algorithm.
+10/14/2026  agent            Split the per-scene terms out of the per-pixel
+                             hillshade routine
+10/14/2026  agent            Added the sun vector for the terrain normals
+10/15/2026  agent            Keep the sines and cosines of the sun elevation
+                             in double, as the original hillshade used them
 
 NOTES:
-  1. Algorithm is based on Lambert's cosine law using Horn's algorithm for
-     calculating the slope of the current point.  The other option is to use
-     Zevenbergen and Thorn's algorithm.  The litterature suggests Zevenbergen
-     and Thorne to be more suited to smooth landscapes, whereas Horn's formula
-     to perform better on rougher terrain.
-  2. Input and output arrays are 1D arrays of size 3 lines x 3 samples where
-     the 3x3 indices are and the current pixel being processed is 4.
-       0 1 2
-       3 4 5
-       6 7 8
+  1. The sine and cosine of the sun elevation are the values the original
+     hillshade computed for each pixel, so hillshade_line gives the same
+     shade as it did.
+  2. The Horn z scale is folded into the x and y scale factors for the
+     slopes of the terrain normals.
+  3. The sun vector is divided by the scale of the quantized terrain
+     normals, so terrain_shadow doesn't need to scale the normals.
 ******************************************************************************/
-float hillshade
+void init_hillshade
 (
-    int16 *elev_window,   /* I: 3x3 array of elevation values in meters */
     float ew_res,         /* I: east/west resolution of the elevation data in
                                 meters */
     float ns_res,         /* I: north/south resolution of the elevation data in
                                 meters */
     float sun_elev,       /* I: sun elevation angle in radians; 0 deg at the
                                 horizon and 90 deg if directly above the DEM */
-    float solar_azimuth   /* I: solar azimuth angle in radians; 0 deg=North,
+    float solar_azimuth,  /* I: solar azimuth angle in radians; 0 deg=North,
                                 90 deg=East, 180 deg=South, 270 deg=West */
+    Hillshade_t *hs       /* O: hillshade terms for the scene */
+)
+{
+    float thresh;         /* deep shadow threshold rounded to a float */
+
+    /* Since the data goes from west to east, leave the ew_res as positive.
+       However since the data goes from north to south, we need to negate the
+       ns_res. */
+    hs->ew_res = ew_res;
+    hs->ns_res = -ns_res;
+    hs->x_scale = HORN_Z_SCALE / ew_res;
+    hs->y_scale = HORN_Z_SCALE / -ns_res;
+
+    /* Sun terms */
+    hs->solar_az = solar_azimuth;
+    hs->sin_elev = sin (sun_elev);
+    hs->cos_elev = cos (sun_elev);
+    hs->sun_x = cos (sun_elev) * sin (solar_azimuth) / TERRAIN_NORMAL_SCALE;
+    hs->sun_y = -cos (sun_elev) * cos (solar_azimuth) / TERRAIN_NORMAL_SCALE;
+    hs->sun_z = sin (sun_elev) / TERRAIN_NORMAL_SCALE;
+
+    /* Find the largest float which is less than or equal to the deep shadow
+       threshold, so comparing the float shaded relief against it matches
+       comparing against the double threshold */
+    thresh = (float) TERRAIN_DEEP_SHADOW_THRESH;
+    if ((double) thresh > TERRAIN_DEEP_SHADOW_THRESH)
+        thresh = nextafterf (thresh, -HUGE_VALF);
+    hs->shadow_thresh = thresh;
+}
+
+
+/******************************************************************************
+MODULE:  hillshade_line (static)
+
+PURPOSE:  Performs the hillshade algorithm (from GDALDEM) to compute the
+shaded relief for a range of samples in a line, then masks the terrain-based
+deep shadow pixels.
+
+RETURN VALUE:
+Type = None
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date        Programmer       Reason
+--------    ---------------  -------------------------------------
+12/31/2012  Gail Schmidt     Original Development (based on GDALHillshade
+                             algorithm in GDALDEM v1.9.2)
+2/1/2013    Gail Schmidt     The north/south resolution needs to indicate
+                             that we decrease in meters as we go from the
+                             top to the bottom of the image.  Thus the ns_res
+                             needs to be negative or the slope is incorrect.
+2/1/2013    Gail Schmidt     Added z scaling for Horn's algorithm.
+10/14/2026  agent            Process a range of samples of a line, reading
+                             the 3x3 windows in place
+10/15/2026  agent            Compute the slopes, aspect, and shade with the
+                             expressions of the original hillshade
+
+NOTES:
+  1. Algorithm is based on Lambert's cosine law using Horn's algorithm for
+     calculating the slope of the current point.  The other option is to use
+     Zevenbergen and Thorn's algorithm.  The litterature suggests Zevenbergen
+     and Thorne to be more suited to smooth landscapes, whereas Horn's formula
+     to perform better on rougher terrain.
+  2. The 3x3 window for each sample is read in place from the line above,
+     the current line, and the line below.
+  3. The slopes, aspect, and shade are computed with the same expressions,
+     in the same order and precision, as the original per-pixel hillshade:
+     the slopes and aspect are rounded to float and the shade is computed
+     in double.  Only the sine and cosine of the sun elevation, which are
+     the same for every pixel, come from init_hillshade.  The shaded relief
+     and deep shadow mask are therefore identical to the original ones.
+******************************************************************************/
+static void hillshade_line
+(
+    int16 *up,           /* I: DEM values for the line above */
+    int16 *mid,          /* I: DEM values for the current line */
+    int16 *down,         /* I: DEM values for the line below */
+    int start_samp,      /* I: first sample to be processed */
+    int end_samp,        /* I: sample after the last one to be processed */
+    Hillshade_t *hs,     /* I: hillshade terms for the scene */
+    uint8 *shaded_relief,    /* O: shaded relief values for the line */
+    uint8 *deep_shadow_mask  /* O: deep shadow mask values for the line */
 )
 {
+    int samp;             /* current sample being processed */
     float x_slope;        /* slope at this point in east/west direction */
     float y_slope;        /* slope at this point in north/south direction */
     float xx_plus_yy;     /* value of x * x + y * y */
     float aspect;         /* aspect at this point in radians */
-    float relief;         /* shaded relief value at this point */
-    float z_scale = 0.125; /* constant from GDAL for Horn algorithm (1/8) */
+    float shade;          /* shaded relief value at this point */
+    float z_scale = HORN_Z_SCALE;  /* constant for the Horn algorithm */
 
-    /* Since the data goes from west to east, leave the ew_res as positive.
-       However since the data goes from north to south, we need to negate the
-       ns_res. */
-    ns_res = -ns_res;
-
-    /* Compute the slope */
-    x_slope = ((elev_window[0] + 2.0 * elev_window[3] + elev_window[6]) -
-               (elev_window[2] + 2.0 * elev_window[5] + elev_window[8])) /
-               ew_res;
-    y_slope = ((elev_window[6] + 2.0 * elev_window[7] + elev_window[8]) -
-               (elev_window[0] + 2.0 * elev_window[1] + elev_window[2])) /
-               ns_res;
-    xx_plus_yy = x_slope * x_slope + y_slope * y_slope;
-
-    /* Compute the aspect */
-    aspect = atan2 (y_slope, x_slope);
-
-    /* Compute the shade value */
-    relief = (sin (sun_elev) - cos (sun_elev) * z_scale * sqrt (xx_plus_yy) *
-        sin (aspect - solar_azimuth)) / sqrt (1.0 + z_scale * z_scale *
-        xx_plus_yy);
-
-    return relief;
+    for (samp = start_samp; samp < end_samp; samp++)
+    {
+        /* Compute the slope */
+        x_slope = ((up[samp-1] + 2.0 * mid[samp-1] + down[samp-1]) -
+                   (up[samp+1] + 2.0 * mid[samp+1] + down[samp+1])) /
+                   hs->ew_res;
+        y_slope = ((down[samp-1] + 2.0 * down[samp] + down[samp+1]) -
+                   (up[samp-1] + 2.0 * up[samp] + up[samp+1])) / hs->ns_res;
+        xx_plus_yy = x_slope * x_slope + y_slope * y_slope;
+
+        /* Compute the aspect */
+        aspect = atan2 (y_slope, x_slope);
+
+        /* Compute the shade value */
+        shade = (hs->sin_elev - hs->cos_elev * z_scale * sqrt (xx_plus_yy) *
+            sin (aspect - hs->solar_az)) / sqrt (1.0 + z_scale * z_scale *
+            xx_plus_yy);
+
+        /* If the shaded relief value is below the shaded relief threshold,
+           then mask this pixel as a terrain-derived deep shadow pixel */
+        deep_shadow_mask[samp] = NO_DEEP_SHADOW;
+        if (shade <= hs->shadow_thresh)
+            deep_shadow_mask[samp] = DEEP_SHADOW;
+
+        /* Scale the shaded relief values from 0.0 to 1.0 to 0 to 100 */
+        if (shade <= 0.0)
+            shaded_relief[samp] = 0;
+        else
+            shaded_relief[samp] = (int) (100.0 * shade + 0.5);
+    }
+}
+
+
+/******************************************************************************
+MODULE:  terrain_normal_line
+
+PURPOSE:  Computes the unit surface normals for a line of the DEM, quantized
+for the terrain cache.
+
+RETURN VALUE:
+Type = None
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date        Programmer       Reason
+--------    ---------------  -------------------------------------
+10/14/2026  agent            Original Development
+
+NOTES:
+  1. The slopes are the Horn slopes of hillshade_line, scaled by the z
+     scale.  The normal of the surface is (zx, zy, 1) / sqrt(1 + zx*zx +
+     zy*zy), so the shade value in hillshade_line is, up to rounding, the
+     dot product of the normal with the sun vector
+       (cos(elev) * sin(azimuth), -cos(elev) * cos(azimuth), sin(elev))
+     The normal only depends on the DEM, so it can be computed once and
+     reused for each sun geometry.
+  2. The components are scaled by TERRAIN_NORMAL_SCALE and rounded to int16.
+     The first and last samples don't have a 3x3 window, so they are 0.
+******************************************************************************/
+void terrain_normal_line
+(
+    int16 *up,           /* I: DEM values for the line above */
+    int16 *mid,          /* I: DEM values for the current line */
+    int16 *down,         /* I: DEM values for the line below */
+    int nsamps,          /* I: number of samples in the line */
+    float x_scale,       /* I: east/west slope scale (see init_hillshade) */
+    float y_scale,       /* I: north/south slope scale */
+    int16 *normals       /* O: x, y, and z components of the normals, one
+                               plane of nsamps values after the other */
+)
+{
+    int samp;             /* current sample being processed */
+    float x_slope;        /* scaled slope in the east/west direction */
+    float y_slope;        /* scaled slope in the north/south direction */
+    double scale;         /* TERRAIN_NORMAL_SCALE / length of (zx, zy, 1) */
+    int16 *nx = normals;  /* x components of the normals */
+    int16 *ny = &normals[nsamps];      /* y components of the normals */
+    int16 *nz = &normals[2 * nsamps];  /* z components of the normals */
+
+    nx[0] = ny[0] = nz[0] = 0;
+    nx[nsamps-1] = ny[nsamps-1] = nz[nsamps-1] = 0;
+    for (samp = 1; samp < nsamps - 1; samp++)
+    {
+        x_slope = ((up[samp-1] + 2 * mid[samp-1] + down[samp-1]) -
+                   (up[samp+1] + 2 * mid[samp+1] + down[samp+1])) * x_scale;
+        y_slope = ((down[samp-1] + 2 * down[samp] + down[samp+1]) -
+                   (up[samp-1] + 2 * up[samp] + up[samp+1])) * y_scale;
+
+        scale = TERRAIN_NORMAL_SCALE / sqrt (1.0 + ((double) x_slope *
+            x_slope + (double) y_slope * y_slope));
+        nx[samp] = (int16) lrint (x_slope * scale);
+        ny[samp] = (int16) lrint (y_slope * scale);
+        nz[samp] = (int16) lrint (scale);
+    }
+}
+
+
+/******************************************************************************
+MODULE:  terrain_shadow_line (static)
+
+PURPOSE:  Computes the shaded relief for a range of samples in a line from
+the terrain normals, then masks the terrain-based deep shadow pixels.
+
+RETURN VALUE:
+Type = None
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date        Programmer       Reason
+--------    ---------------  -------------------------------------
+10/14/2026  agent            Original Development
+
+NOTES:
+  1. The shade value is the dot product of the normal with the sun vector
+     (see terrain_normal_line), and is scaled and thresholded the same as in
+     hillshade_line.
+******************************************************************************/
+static void terrain_shadow_line
+(
+    int16 *nx,           /* I: x components of the normals */
+    int16 *ny,           /* I: y components of the normals */
+    int16 *nz,           /* I: z components of the normals */
+    int start_samp,      /* I: first sample to be processed */
+    int end_samp,        /* I: sample after the last one to be processed */
+    Hillshade_t *hs,     /* I: hillshade terms for the scene */
+    uint8 *shaded_relief,    /* O: shaded relief values for the line */
+    uint8 *deep_shadow_mask  /* O: deep shadow mask values for the line */
+)
+{
+    int samp;             /* current sample being processed */
+    float shade;          /* shaded relief value at this point */
+
+    for (samp = start_samp; samp < end_samp; samp++)
+    {
+        shade = (nx[samp] * hs->sun_x + ny[samp] * hs->sun_y) +
+            nz[samp] * hs->sun_z;
+
+        deep_shadow_mask[samp] = NO_DEEP_SHADOW;
+        if (shade <= hs->shadow_thresh)
+            deep_shadow_mask[samp] = DEEP_SHADOW;
+
+        if (shade <= 0.0)
+            shaded_relief[samp] = 0;
+        else
+            shaded_relief[samp] = (int) (100.0 * shade + 0.5);
+    }
 }
 
 
+#ifdef SHADED_RELIEF_AVX2
+/******************************************************************************
+MODULE:  load_dem_avx2 (static)
+
+PURPOSE:  Loads 8 DEM values or terrain normals as 32-bit integers.
+
+RETURN VALUE:
+Type = __m256i
+Value      Description
+-----      -----------
+values     DEM values
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date        Programmer       Reason
+--------    ---------------  -------------------------------------
+10/14/2026  agent            Original Development
+
+NOTES:
+******************************************************************************/
+__attribute__ ((target ("avx2")))
+static inline __m256i load_dem_avx2
+(
+    int16 *dem           /* I: DEM values to be loaded */
+)
+{
+    return (_mm256_cvtepi16_epi32 (_mm_loadu_si128 ((__m128i *) dem)));
+}
+
+
+/******************************************************************************
+MODULE:  store_u8_avx2 (static)
+
+PURPOSE:  Stores 8 32-bit integers in the range 0 to 255 as 8-bit values.
+
+RETURN VALUE:
+Type = None
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date        Programmer       Reason
+--------    ---------------  -------------------------------------
+10/14/2026  agent            Original Development
+
+NOTES:
+******************************************************************************/
+__attribute__ ((target ("avx2")))
+static inline void store_u8_avx2
+(
+    __m256i vals,        /* I: values to be stored */
+    uint8 *out           /* O: output array of 8 values */
+)
+{
+    __m128i packed;      /* values packed to 16 and then 8 bits */
+
+    packed = _mm_packus_epi32 (_mm256_castsi256_si128 (vals),
+        _mm256_extracti128_si256 (vals, 1));
+    packed = _mm_packus_epi16 (packed, packed);
+    _mm_storel_epi64 ((__m128i *) out, packed);
+}
+
+
+/******************************************************************************
+MODULE:  store_shade_avx2 (static)
+
+PURPOSE:  Masks the terrain-derived deep shadow pixels and stores the scaled
+shaded relief for 8 shade values.
+
+RETURN VALUE:
+Type = None
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date        Programmer       Reason
+--------    ---------------  -------------------------------------
+10/14/2026  agent            Original Development
+
+NOTES:
+  1. The results are identical to the scalar code; the relief is scaled in
+     double precision.
+******************************************************************************/
+__attribute__ ((target ("avx2")))
+static inline void store_shade_avx2
+(
+    __m256 shade,            /* I: shaded relief values */
+    __m256 shadow_thresh,    /* I: deep shadow threshold */
+    uint8 *shaded_relief,    /* O: 8 scaled shaded relief values */
+    uint8 *deep_shadow_mask  /* O: 8 deep shadow mask values */
+)
+{
+    __m256d lo, hi;        /* shaded relief values in double precision */
+    __m256i relief;        /* scaled shaded relief values */
+    __m256i shadow;        /* deep shadow mask values */
+
+    /* Mask the terrain-derived deep shadow pixels */
+    shadow = _mm256_and_si256 (_mm256_castps_si256 (_mm256_cmp_ps (shade,
+        shadow_thresh, _CMP_LE_OQ)), _mm256_set1_epi32 (DEEP_SHADOW));
+    store_u8_avx2 (shadow, deep_shadow_mask);
+
+    /* Scale the shaded relief values from 0.0 to 1.0 to 0 to 100, in
+       double precision */
+    lo = _mm256_cvtps_pd (_mm256_castps256_ps128 (shade));
+    hi = _mm256_cvtps_pd (_mm256_extractf128_ps (shade, 1));
+    lo = _mm256_add_pd (_mm256_mul_pd (lo, _mm256_set1_pd (100.0)),
+        _mm256_set1_pd (0.5));
+    hi = _mm256_add_pd (_mm256_mul_pd (hi, _mm256_set1_pd (100.0)),
+        _mm256_set1_pd (0.5));
+    relief = _mm256_set_m128i (_mm256_cvttpd_epi32 (hi),
+        _mm256_cvttpd_epi32 (lo));
+    relief = _mm256_andnot_si256 (_mm256_castps_si256 (_mm256_cmp_ps (
+        shade, _mm256_setzero_ps (), _CMP_LE_OQ)), relief);
+    store_u8_avx2 (relief, shaded_relief);
+}
+
+
+/******************************************************************************
+MODULE:  terrain_shadow_line_avx2 (static)
+
+PURPOSE:  Computes the shaded relief and terrain-based deep shadow mask from
+the terrain normals for groups of 8 samples in a line using AVX2.
+
+RETURN VALUE:
+Type = int
+Value      Description
+-----      -----------
+samp       Sample after the last one processed; the caller processes the
+           remaining samples
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date        Programmer       Reason
+--------    ---------------  -------------------------------------
+10/14/2026  agent            Original Development
+
+NOTES:
+  1. The results are identical to terrain_shadow_line; the operations are
+     done in the same order and precision, and no FMA is used.
+******************************************************************************/
+__attribute__ ((target ("avx2")))
+static int terrain_shadow_line_avx2
+(
+    int16 *nx,           /* I: x components of the normals */
+    int16 *ny,           /* I: y components of the normals */
+    int16 *nz,           /* I: z components of the normals */
+    int start_samp,      /* I: first sample to be processed */
+    int end_samp,        /* I: sample after the last one to be processed */
+    Hillshade_t *hs,     /* I: hillshade terms for the scene */
+    uint8 *shaded_relief,    /* O: shaded relief values for the line */
+    uint8 *deep_shadow_mask  /* O: deep shadow mask values for the line */
+)
+{
+    int samp;              /* current sample being processed */
+    __m256 shade;          /* shaded relief values */
+    __m256 sun_x, sun_y, sun_z;  /* sun vector */
+    __m256 shadow_thresh;  /* deep shadow threshold */
+
+    sun_x = _mm256_set1_ps (hs->sun_x);
+    sun_y = _mm256_set1_ps (hs->sun_y);
+    sun_z = _mm256_set1_ps (hs->sun_z);
+    shadow_thresh = _mm256_set1_ps (hs->shadow_thresh);
+
+    for (samp = start_samp; samp + 8 <= end_samp; samp += 8)
+    {
+        /* Compute the shade value as the dot product of the normals with
+           the sun vector */
+        shade = _mm256_add_ps (_mm256_add_ps (
+            _mm256_mul_ps (_mm256_cvtepi32_ps (load_dem_avx2 (&nx[samp])),
+                sun_x),
+            _mm256_mul_ps (_mm256_cvtepi32_ps (load_dem_avx2 (&ny[samp])),
+                sun_y)),
+            _mm256_mul_ps (_mm256_cvtepi32_ps (load_dem_avx2 (&nz[samp])),
+                sun_z));
+
+        /* Mask the deep shadow pixels and scale the shaded relief */
+        store_shade_avx2 (shade, shadow_thresh, &shaded_relief[samp],
+            &deep_shadow_mask[samp]);
+    }
+
+    return (samp);
+}
+#endif
+
+
 /******************************************************************************
 MODULE:  deep_shadow_mask
 
@@ -100,6 +512,12 @@ HISTORY:
 Date        Programmer       Reason
 --------    ---------------  -------------------------------------
 12/31/2012  Gail Schmidt     Original Development
+10/14/2026  agent            Process each line with the line-oriented
+                             hillshade, using AVX2 when the processor
+                             supports it
+10/14/2026  agent            Only process the valid span of each line
+10/15/2026  agent            Dropped the AVX2 hillshade, which didn't
+                             compute the original expression
 
 NOTES:
   1. Algorithm is based on the terrain-derived deep shadow algorithm provided
@@ -111,9 +529,12 @@ NOTES:
      either end of the line.  The first and last sample simply will not be
      processed for the shaded relief and the deep shadow mask, thus they should
      already be initialized to an appropriate value before calling this
-     function.  The hillshade module requires a 3x3 window to be provided
-     surrounding each pixel, thus the extra line(s) of data.
+     function.  The hillshade requires a 3x3 window surrounding each pixel,
+     thus the extra line(s) of data.
   3. Output mask arrays are 1D arrays of size nlines * nsamps.
+  4. The samples outside the valid span of a line are fill in the TOA
+     inputs, so they are not processed either.  They are left at the values
+     they were initialized to, the same as the first and last sample.
 ******************************************************************************/
 void deep_shadow
 (
@@ -135,12 +556,10 @@ void deep_shadow
                                of samples therefore the first and last sample
                                will not be processed as part of the mask since
                                a 3x3 window won't be available */
-    float ew_res,        /* I: east/west resolution of the elevation data in
-                               meters */
-    float ns_res,        /* I: north/south resolution of the elevation data in
-                               meters */
-    float sun_elev,      /* I: sun elevation angle in radians */
-    float solar_azimuth, /* I: solar azimuth angle in radians */
+    Valid_span_t *span,  /* I: valid span of each line in the mask array;
+                               NULL if all of the samples are processed */
+    Hillshade_t *hs,     /* I: hillshade terms for the scene (see
+                               init_hillshade) */
     uint8 *shaded_relief,    /* O: array of shaded relief values (multiplied
                                    by 100 to indicate percent intensity)
                                    of size nlines * nsamps */
@@ -149,17 +568,18 @@ void deep_shadow
                                    shadow areas) of size nlines * nsamps */
 )
 {
-    int line, samp;        /* line and sample being processed */
-    int curr_pix;          /* current input pixel being processed */
-    int out_pix;           /* current output pixel being processed */
+    int line;              /* line being processed */
+    int samp;              /* first sample to be processed */
+    int end_samp;          /* sample after the last one to be processed */
+    int out_pix;           /* first output pixel of the current line */
     int start_line;        /* which line to start processing of the output
                               shaded relief and mask */
     int dem_line;          /* line in the DEM associated with the start_line
                               in the mask; should always be a value of 1 */
     int proc_nlines;       /* number of lines to process in the output mask */
-    float shade;           /* shaded relief value for the current pixel */
-    int16 elev_window[9];  /* 3x3 window of elevation values surrounding the
-                              current pixel */
+    int16 *up;             /* DEM line above the current line */
+    int16 *mid;            /* DEM line for the current line */
+    int16 *down;           /* DEM line below the current line */
 
     /* Loop through the lines samples in the array to calculate the relief
        shading and determine the terrain-derived deep shadow mask.  The first
@@ -177,42 +597,91 @@ void deep_shadow
     for (line = start_line, dem_line = 1; line < proc_nlines;
          line++, dem_line++)
     {
-        for (samp = 1; samp < nsamps-1; samp++)
+        /* Determine the DEM lines for the 3x3 windows and the output
+           location for the current line */
+        up = &dem[(dem_line-1) * nsamps];
+        mid = &dem[dem_line * nsamps];
+        down = &dem[(dem_line+1) * nsamps];
+        out_pix = line * nsamps;
+
+        /* Compute the shaded relief and deep shadow mask for the samples
+           in the valid span which have a full 3x3 window */
+        samp = 1;
+        end_samp = nsamps-1;
+        if (span != NULL)
         {
-            /* Determine the output pixel location for the current line/samp */
-            out_pix = line * nsamps + samp;
-
-            /* Fill in the 3x3 elevation window surrounding the current pixel */
-            curr_pix = (dem_line-1) * nsamps + (samp-1);
-            elev_window[0] = dem[curr_pix];
-            elev_window[1] = dem[curr_pix+1];
-            elev_window[2] = dem[curr_pix+2];
-            curr_pix = dem_line * nsamps + (samp-1);
-            elev_window[3] = dem[curr_pix];
-            elev_window[4] = dem[curr_pix+1];
-            elev_window[5] = dem[curr_pix+2];
-            curr_pix = (dem_line+1) * nsamps + (samp-1);
-            elev_window[6] = dem[curr_pix];
-            elev_window[7] = dem[curr_pix+1];
-            elev_window[8] = dem[curr_pix+2];
-
-            /* Compute the shaded relief for the current pixel */
-            shade = hillshade (elev_window, ew_res, ns_res, sun_elev,
-                solar_azimuth);
-
-            /* If the shaded relief value is below the shaded relief
-               threshold, then mask this pixel as a terrain-derived deep
-               shadow pixel */
-            deep_shadow_mask[out_pix] = NO_DEEP_SHADOW;
-            if (shade <= TERRAIN_DEEP_SHADOW_THRESH)
-                deep_shadow_mask[out_pix] = DEEP_SHADOW;
-
-            /* Scale the shaded relief values from 0.0 to 1.0 to 0 to 100 */
-            if (shade <= 0.0)
-                shaded_relief[out_pix] = 0;
-            else
-                shaded_relief[out_pix] = (int) (100.0 * shade + 0.5);
+            if (span[line].start > samp)
+                samp = span[line].start;
+            if (span[line].end < end_samp)
+                end_samp = span[line].end;
         }
+        hillshade_line (up, mid, down, samp, end_samp, hs,
+            &shaded_relief[out_pix], &deep_shadow_mask[out_pix]);
     }
 }
 
+
+/******************************************************************************
+MODULE:  terrain_shadow
+
+PURPOSE:  Computes the shaded relief for a line from the cached terrain
+normals, then masks terrain-based deep shadow pixels.
+
+RETURN VALUE:
+Type = None
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date        Programmer       Reason
+--------    ---------------  -------------------------------------
+10/14/2026  agent            Original Development
+10/14/2026  agent            Only process the valid span of the line
+
+NOTES:
+  1. This replaces the hillshade of the DEM with a dot product of the
+     normals and the sun vector, so it is done only for the lines which
+     deep_shadow would process.  The first and last sample are not
+     processed, the same as in deep_shadow.
+  2. The normals are quantized to int16, so the shade value is within about
+     5e-5 of the one deep_shadow computes.  A pixel whose shade is that
+     close to the deep shadow threshold or to the rounding of the relief can
+     get a different mask or relief value.
+  3. Only the samples in the valid span are processed, as in deep_shadow.
+******************************************************************************/
+void terrain_shadow
+(
+    int16 *normals,      /* I: x components of the normals for the line; the
+                               y and z components follow at plane_size and
+                               2 * plane_size values (see get_terrain_line) */
+    int plane_size,      /* I: number of values in each plane of normals */
+    int nsamps,          /* I: number of samples in the line */
+    Valid_span_t *span,  /* I: valid span of the line; NULL if all of the
+                               samples are processed */
+    Hillshade_t *hs,     /* I: hillshade terms for the scene */
+    uint8 *shaded_relief,    /* O: shaded relief values for the line */
+    uint8 *deep_shadow_mask  /* O: deep shadow mask values for the line */
+)
+{
+    int samp = 1;          /* first sample left for the scalar code */
+    int end_samp = nsamps-1;  /* sample after the last one to be processed */
+    int16 *nx = normals;   /* x components of the normals */
+    int16 *ny = &normals[plane_size];      /* y components of the normals */
+    int16 *nz = &normals[2 * plane_size];  /* z components of the normals */
+
+    if (span != NULL)
+    {
+        if (span->start > samp)
+            samp = span->start;
+        if (span->end < end_samp)
+            end_samp = span->end;
+    }
+#ifdef SHADED_RELIEF_AVX2
+    if (__builtin_cpu_supports ("avx2"))
+        samp = terrain_shadow_line_avx2 (nx, ny, nz, samp, end_samp, hs,
+            shaded_relief, deep_shadow_mask);
+#endif
+    terrain_shadow_line (nx, ny, nz, samp, end_samp, hs, shaded_relief,
+        deep_shadow_mask);
+}
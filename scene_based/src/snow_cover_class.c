@@ -1,5 +1,472 @@
 #include "sca.h"
 
+/* The vectorized classifier is compiled for AVX2 with gcc's target attribute
+   and selected at run time, so the application doesn't need to be built
+   with -mavx2 to use it */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SNOW_CLASS_AVX2
+#include <immintrin.h>
+#endif
+
+/* Are the AVX2 kernels of this file allowed?  They are still only used
+   when the processor supports AVX2.  See set_snow_class_avx2. */
+static bool snow_class_avx2 = true;
+
+#ifdef SNOW_CLASS_AVX2
+/* Packed results for a leaf of the snow cover tree: tree node in bits 0-7,
+   probability score in bits 8-15, and snow cover flag in bit 16 */
+#define SC_CODE(node,prob,snow) ((node) | ((prob) << 8) | ((snow) << 16))
+
+/******************************************************************************
+MODULE:  float_lt_thresh (static)
+
+PURPOSE:  Finds the float threshold t for a double threshold, such that for
+any float x, (x < thresh) is the same as (x < t) and (x >= thresh) is the same
+as (x >= t).
+
+RETURN VALUE:
+Type = float
+Value      Description
+-----      -----------
+t          Smallest float which is greater than or equal to thresh
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. The scalar classifier compares the float band values against double
+     constants.  Rounding the constants to floats this way allows the
+     vectorized classifier to compare in single precision with identical
+     results.
+******************************************************************************/
+static float float_lt_thresh
+(
+    double thresh        /* I: double threshold */
+)
+{
+    float t = (float) thresh;     /* threshold rounded to a float */
+
+    if ((double) t < thresh)
+        t = nextafterf (t, HUGE_VALF);
+    return (t);
+}
+
+
+/******************************************************************************
+MODULE:  float_gt_thresh (static)
+
+PURPOSE:  Finds the float threshold t for a double threshold, such that for
+any float x, (x > thresh) is the same as (x > t).
+
+RETURN VALUE:
+Type = float
+Value      Description
+-----      -----------
+t          Largest float which is less than or equal to thresh
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+******************************************************************************/
+static float float_gt_thresh
+(
+    double thresh        /* I: double threshold */
+)
+{
+    float t = (float) thresh;     /* threshold rounded to a float */
+
+    if ((double) t > thresh)
+        t = nextafterf (t, -HUGE_VALF);
+    return (t);
+}
+
+
+/* Helpers for the AVX2 classifier: a float compare as an integer mask, and
+   a select of a where the mask is set and b elsewhere */
+#define SC_LT(x,t) _mm256_castps_si256 (_mm256_cmp_ps ((x), (t), _CMP_LT_OQ))
+#define SC_GE(x,t) _mm256_castps_si256 (_mm256_cmp_ps ((x), (t), _CMP_GE_OQ))
+#define SC_GT(x,t) _mm256_castps_si256 (_mm256_cmp_ps ((x), (t), _CMP_GT_OQ))
+#define SC_SEL(m,a,b) _mm256_blendv_epi8 ((b), (a), (m))
+#define SC_LEAF(node,prob,snow) _mm256_set1_epi32 (SC_CODE (node, prob, snow))
+
+/******************************************************************************
+MODULE:  load_band_avx2 (static)
+
+PURPOSE:  Loads and scales 8 values of a TOA reflectance band, setting the
+values to 1.0 where the saturation mask is set.
+
+RETURN VALUE:
+Type = __m256
+Value      Description
+-----      -----------
+values     Scaled band values
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+******************************************************************************/
+__attribute__ ((target ("avx2")))
+static inline __m256 load_band_avx2
+(
+    int16 *band,         /* I: band values to be loaded */
+    __m256 scale,        /* I: scale factor */
+    __m256i sat          /* I: saturation mask */
+)
+{
+    __m256 vals;         /* scaled values */
+
+    vals = _mm256_cvtepi32_ps (_mm256_cvtepi16_epi32 (_mm_loadu_si128
+        ((__m128i *) band)));
+    vals = _mm256_mul_ps (vals, scale);
+    return (_mm256_blendv_ps (vals, _mm256_set1_ps (1.0),
+        _mm256_castsi256_ps (sat)));
+}
+
+
+/******************************************************************************
+MODULE:  index_avx2 (static)
+
+PURPOSE:  Converts 8 NDSI/NDVI values to the 8-bit percentages output by the
+classifier.
+
+RETURN VALUE:
+Type = __m256i
+Value      Description
+-----      -----------
+values     Percentages as 32-bit integers in the range 0 to 255
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. The scaling is done in double precision and truncated, and only the low
+     8 bits are kept, as for the assignment to a uint8 in the scalar
+     classifier.  Negative indices are output as 0.
+******************************************************************************/
+__attribute__ ((target ("avx2")))
+static inline __m256i index_avx2
+(
+    __m256 index         /* I: NDSI or NDVI values */
+)
+{
+    __m256d lo, hi;      /* values in double precision */
+    __m256i result;      /* truncated values */
+
+    lo = _mm256_cvtps_pd (_mm256_castps256_ps128 (index));
+    hi = _mm256_cvtps_pd (_mm256_extractf128_ps (index, 1));
+    lo = _mm256_add_pd (_mm256_mul_pd (lo, _mm256_set1_pd (100.0)),
+        _mm256_set1_pd (0.5));
+    hi = _mm256_add_pd (_mm256_mul_pd (hi, _mm256_set1_pd (100.0)),
+        _mm256_set1_pd (0.5));
+    result = _mm256_set_m128i (_mm256_cvttpd_epi32 (hi),
+        _mm256_cvttpd_epi32 (lo));
+    result = _mm256_and_si256 (result, _mm256_set1_epi32 (0xff));
+    return (_mm256_andnot_si256 (SC_LT (index, _mm256_setzero_ps ()),
+        result));
+}
+
+
+/******************************************************************************
+MODULE:  store_u8_avx2 (static)
+
+PURPOSE:  Stores 8 32-bit integers in the range 0 to 255 as 8-bit values.
+
+RETURN VALUE:
+Type = None
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+******************************************************************************/
+__attribute__ ((target ("avx2")))
+static inline void store_u8_avx2
+(
+    __m256i vals,        /* I: values to be stored */
+    uint8 *out           /* O: output array of 8 values */
+)
+{
+    __m128i packed;      /* values packed to 16 and then 8 bits */
+
+    packed = _mm_packus_epi32 (_mm256_castsi256_si128 (vals),
+        _mm256_extracti128_si256 (vals, 1));
+    packed = _mm_packus_epi16 (packed, packed);
+    _mm_storel_epi64 ((__m128i *) out, packed);
+}
+
+
+/******************************************************************************
+MODULE:  snow_cover_class_avx2 (static)
+
+PURPOSE:  Performs the snow cover classification for groups of 8 pixels
+using AVX2.
+
+RETURN VALUE:
+Type = int
+Value      Description
+-----      -----------
+n          Number of pixels processed, a multiple of 8; the caller processes
+           the remaining pixels
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. The results are identical to the scalar classifier in snow_cover_class,
+     including setting all reflective bands to 1.0 when band 1 is saturated.
+  2. Rather than walking the tree, every test in the tree is evaluated as a
+     mask and the leaves are selected with blends.  Each leaf is packed as
+     SC_CODE so one set of blends selects the node, probability score, and
+     snow cover flag.
+  3. The double constants are converted to float thresholds which give the
+     same comparison results (see float_lt_thresh and float_gt_thresh).  The
+     NDSI/NDVI percentages are scaled in double precision, as in the scalar
+     classifier.  Only SSE/AVX arithmetic is used (no FMA), so the results
+     are rounded the same as the scalar code.
+******************************************************************************/
+__attribute__ ((target ("avx2")))
+static int snow_cover_class_avx2
+(
+    int16 *b1,     /* I: array of unscaled band 1 TOA reflectance values */
+    int16 *b2,     /* I: array of unscaled band 2 TOA reflectance values */
+    int16 *b3,     /* I: array of unscaled band 3 TOA reflectance values */
+    int16 *b4,     /* I: array of unscaled band 4 TOA reflectance values */
+    int16 *b5,     /* I: array of unscaled band 5 TOA reflectance values */
+    int16 *b6,     /* I: array of unscaled band 6 brightness temp values */
+    int16 *b7,     /* I: array of unscaled band 7 TOA reflectance values */
+    int npix,      /* I: number of pixels in the data arrays */
+    float refl_scale_fact,  /* I: scale factor for the TOA reflectance values */
+    float btemp_scale_fact, /* I: scale factor for the brightness temp values */
+    int refl_sat_value,     /* I: saturation value for TOA reflectance values */
+    uint8 *refl_qa_mask, /* I: array of masked values for processing */
+    uint8 *snow_mask,    /* O: array of snow cover masked values */
+    uint8 *probability_score,/* O: probability pixel was classified correctly */
+    uint8 *tree_node,    /* O: node in tree used to classify each pixel */
+    uint8 *ndsi_array,   /* O: NDSI outputs */
+    uint8 *ndvi_array    /* O: NDVI outputs */
+)
+{
+    int pix;                   /* current pixel being processed */
+    __m256 refl_scale;         /* TOA reflectance scale factor */
+    __m256 btemp_scale;        /* brightness temp scale factor */
+    __m256i sat_value;         /* TOA reflectance saturation value */
+    __m256 zero;               /* 0.0 */
+    __m256 b1_pix, b2_pix, b3_pix, b4_pix, b5_pix, b6_pix, b7_pix;
+                               /* scaled band values for the pixels */
+    __m256 ndsi, ndvi;         /* NDSI and NDVI for the pixels */
+    __m256i qa;                /* reflective QA mask is on */
+    __m256i sat;               /* band 1 is saturated */
+    __m256i valid;             /* pixel passed the short-circuit tests */
+    __m256i left, right;       /* leaf for the NDSI < 0.25 branch and for the
+                                  NDSI >= 0.25 branch of the tree */
+    __m256i code;              /* packed leaf for the pixels */
+    __m256i hot;               /* pixel fails the post-processing thermal
+                                  test */
+    __m256i byte_mask;         /* mask for the low 8 bits */
+    __m256 t_b4_11, t_b6_2485, t_ndsi_25, t_b5_072, t_b3_35, t_b1_11,
+        t_ndsi_21, t_b3_042, t_ndsi_15, t_b7_14, t_b4_32, t_ndvi_19, t_b1_3,
+        t_ndsi_57, t_ndvi_18, t_b1_35, t_b7_22, t_b5_1, t_b7_11, t_b1_34,
+        t_b3_0432, t_b6_1885;  /* thresholds for the tests in the tree */
+
+    /* Set up the constants */
+    refl_scale = _mm256_set1_ps (refl_scale_fact);
+    btemp_scale = _mm256_set1_ps (btemp_scale_fact);
+    sat_value = _mm256_set1_epi32 (refl_sat_value);
+    zero = _mm256_setzero_ps ();
+    byte_mask = _mm256_set1_epi32 (0xff);
+    t_b4_11 = _mm256_set1_ps (float_lt_thresh (0.11));
+    t_b6_2485 = _mm256_set1_ps (float_gt_thresh (24.85));
+    t_ndsi_25 = _mm256_set1_ps (float_lt_thresh (0.25));
+    t_b5_072 = _mm256_set1_ps (float_lt_thresh (0.072));
+    t_b3_35 = _mm256_set1_ps (float_lt_thresh (0.35));
+    t_b1_11 = _mm256_set1_ps (float_lt_thresh (0.11));
+    t_ndsi_21 = _mm256_set1_ps (float_lt_thresh (0.21));
+    t_b3_042 = _mm256_set1_ps (float_lt_thresh (0.042));
+    t_ndsi_15 = _mm256_set1_ps (float_lt_thresh (0.15));
+    t_b7_14 = _mm256_set1_ps (float_lt_thresh (0.14));
+    t_b4_32 = _mm256_set1_ps (float_lt_thresh (0.32));
+    t_ndvi_19 = _mm256_set1_ps (float_lt_thresh (0.19));
+    t_b1_3 = _mm256_set1_ps (float_lt_thresh (0.3));
+    t_ndsi_57 = _mm256_set1_ps (float_lt_thresh (0.57));
+    t_ndvi_18 = _mm256_set1_ps (float_lt_thresh (0.18));
+    t_b1_35 = _mm256_set1_ps (float_lt_thresh (0.35));
+    t_b7_22 = _mm256_set1_ps (float_lt_thresh (0.22));
+    t_b5_1 = _mm256_set1_ps (float_lt_thresh (0.1));
+    t_b7_11 = _mm256_set1_ps (float_lt_thresh (0.11));
+    t_b1_34 = _mm256_set1_ps (float_lt_thresh (0.34));
+    t_b3_0432 = _mm256_set1_ps (float_lt_thresh (0.0432));
+    t_b6_1885 = _mm256_set1_ps (float_gt_thresh (18.85));
+
+    for (pix = 0; pix + 8 <= npix; pix += 8)
+    {
+        /* Scale the pixels for each band, setting the reflective bands to
+           1.0 if band 1 is saturated */
+        qa = _mm256_cvtepu8_epi32 (_mm_loadl_epi64 ((__m128i *)
+            &refl_qa_mask[pix]));
+        qa = _mm256_xor_si256 (_mm256_cmpeq_epi32 (qa,
+            _mm256_setzero_si256 ()), _mm256_set1_epi32 (-1));
+        sat = _mm256_cmpeq_epi32 (_mm256_cvtepi16_epi32 (_mm_loadu_si128
+            ((__m128i *) &b1[pix])), sat_value);
+        b1_pix = load_band_avx2 (&b1[pix], refl_scale, sat);
+        b2_pix = load_band_avx2 (&b2[pix], refl_scale, sat);
+        b3_pix = load_band_avx2 (&b3[pix], refl_scale, sat);
+        b4_pix = load_band_avx2 (&b4[pix], refl_scale, sat);
+        b5_pix = load_band_avx2 (&b5[pix], refl_scale, sat);
+        b7_pix = load_band_avx2 (&b7[pix], refl_scale, sat);
+        b6_pix = _mm256_mul_ps (_mm256_cvtepi32_ps (_mm256_cvtepi16_epi32
+            (_mm_loadu_si128 ((__m128i *) &b6[pix]))), btemp_scale);
+
+        /* Short-circuit tests for QA, water, thermal, and the NDSI and NDVI
+           which can't be computed */
+        valid = _mm256_or_si256 (qa, SC_LT (b4_pix, t_b4_11));
+        valid = _mm256_or_si256 (valid, SC_GT (b6_pix, t_b6_2485));
+        valid = _mm256_or_si256 (valid, _mm256_and_si256 (
+            _mm256_castps_si256 (_mm256_cmp_ps (b2_pix, zero, _CMP_EQ_OQ)),
+            _mm256_castps_si256 (_mm256_cmp_ps (b5_pix, zero, _CMP_EQ_OQ))));
+        valid = _mm256_or_si256 (valid, _mm256_and_si256 (
+            _mm256_castps_si256 (_mm256_cmp_ps (b3_pix, zero, _CMP_EQ_OQ)),
+            _mm256_castps_si256 (_mm256_cmp_ps (b4_pix, zero, _CMP_EQ_OQ))));
+        valid = _mm256_xor_si256 (valid, _mm256_set1_epi32 (-1));
+
+        /* Compute the NDSI and NDVI */
+        ndsi = _mm256_div_ps (_mm256_sub_ps (b2_pix, b5_pix),
+            _mm256_add_ps (b2_pix, b5_pix));
+        ndvi = _mm256_div_ps (_mm256_sub_ps (b4_pix, b3_pix),
+            _mm256_add_ps (b4_pix, b3_pix));
+
+        /* Evaluate the binary snow cover tree */
+        left = SC_SEL (SC_GE (b5_pix, t_b5_072),
+            SC_SEL (SC_LT (b3_pix, t_b3_35), SC_LEAF (1, 98, 0),
+                SC_LEAF (2, 100, 1)),
+            SC_SEL (SC_LT (b1_pix, t_b1_11),
+                SC_SEL (SC_LT (ndsi, t_ndsi_21), SC_LEAF (31, 98, 0),
+                    SC_SEL (SC_LT (b3_pix, t_b3_042), SC_LEAF (32, 91, 0),
+                        SC_LEAF (33, 85, 1))),
+                SC_SEL (SC_LT (ndsi, t_ndsi_15), SC_LEAF (34, 83, 0),
+                    SC_LEAF (35, 95, 1))));
+        right = SC_SEL (SC_GE (b7_pix, t_b7_14),
+            SC_SEL (SC_LT (b4_pix, t_b4_32),
+                SC_SEL (SC_LT (ndvi, t_ndvi_19),
+                    SC_SEL (SC_LT (b1_pix, t_b1_3), SC_LEAF (4, 96, 0),
+                        SC_LEAF (5, 100, 1)),
+                    SC_LEAF (6, 91, 1)),
+                SC_SEL (SC_LT (ndsi, t_ndsi_57),
+                    SC_SEL (SC_LT (ndvi, t_ndvi_18),
+                        SC_SEL (SC_LT (b1_pix, t_b1_35), SC_LEAF (7, 79, 0),
+                            SC_SEL (SC_GE (b7_pix, t_b7_22),
+                                SC_LEAF (8, 84, 0), SC_LEAF (9, 88, 1))),
+                        SC_LEAF (10, 95, 1)),
+                    SC_LEAF (11, 93, 1))),
+            SC_SEL (SC_GE (b5_pix, t_b5_1),
+                SC_SEL (SC_GE (b7_pix, t_b7_11),
+                    SC_SEL (SC_LT (b1_pix, t_b1_34), SC_LEAF (12, 90, 0),
+                        SC_LEAF (13, 100, 1)),
+                    SC_LEAF (14, 81, 1)),
+                SC_SEL (SC_LT (b3_pix, t_b3_0432), SC_LEAF (151, 93, 0),
+                    SC_LEAF (152, 99, 1))));
+        code = SC_SEL (SC_LT (ndsi, t_ndsi_25), left, right);
+
+        /* Post-processing thermal test for the pixels with a probability
+           score below 98 */
+        hot = _mm256_and_si256 (SC_GT (b6_pix, t_b6_1885),
+            _mm256_cmpgt_epi32 (_mm256_set1_epi32 (98), _mm256_and_si256
+            (_mm256_srli_epi32 (code, 8), byte_mask)));
+        code = SC_SEL (hot, SC_LEAF (0, 2, 0), code);
+
+        /* Pixels which didn't pass the short-circuit tests have a
+           probability score of 3, or 0 if the QA mask is on */
+        code = SC_SEL (valid, code, SC_LEAF (0, 3, 0));
+        code = _mm256_andnot_si256 (qa, code);
+
+        /* Assign the outputs */
+        store_u8_avx2 (_mm256_and_si256 (code, byte_mask), &tree_node[pix]);
+        store_u8_avx2 (_mm256_and_si256 (_mm256_srli_epi32 (code, 8),
+            byte_mask), &probability_score[pix]);
+        store_u8_avx2 (_mm256_and_si256 (_mm256_cmpeq_epi32 (
+            _mm256_srli_epi32 (code, 16), _mm256_set1_epi32 (1)),
+            _mm256_set1_epi32 (SNOW_COVER)), &snow_mask[pix]);
+        store_u8_avx2 (_mm256_and_si256 (valid, index_avx2 (ndsi)),
+            &ndsi_array[pix]);
+        store_u8_avx2 (_mm256_and_si256 (valid, index_avx2 (ndvi)),
+            &ndvi_array[pix]);
+    }
+
+    return (pix);
+}
+#endif
+
+/******************************************************************************
+MODULE:  set_snow_class_avx2
+
+PURPOSE:  Allows or disallows the AVX2 kernels of the snow cover
+classification and adjacent snow count.
+
+RETURN VALUE:
+Type = bool
+Value      Description
+-----      -----------
+true       The AVX2 kernels will be used
+false      The scalar kernels will be used
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date        Programmer       Reason
+--------    ---------------  -------------------------------------
+10/15/2026  agent            Original Development
+
+NOTES:
+  1. The AVX2 kernels are allowed by default.  Disallowing them runs the
+     scalar kernels, which bench_kernels --check compares them against.
+  2. This must not be called while the kernels are running.
+******************************************************************************/
+bool set_snow_class_avx2
+(
+    bool allow           /* I: allow the AVX2 kernels? */
+)
+{
+    snow_class_avx2 = allow;
+#ifdef SNOW_CLASS_AVX2
+    return (allow && __builtin_cpu_supports ("avx2"));
+#else
+    return (false);
+#endif
+}
+
+
 /******************************************************************************
 MODULE:  snow_cover_class
 
@@ -23,11 +490,22 @@ Date        Programmer       Reason
                              false-positives.
 2/6/2013    Gail Schmidt     Added subclassifications for nodes 3 and 15 to
                              work with false positives in heavy conifer areas
+10/14/2026  agent            Use the AVX2 classifier for groups of 8 pixels
+                             when the processor supports it.  Test the band 1
+                             saturation once for all the reflective bands.
+10/14/2026  agent            Only classify the pixels in the valid span of
+                             each line
 
 NOTES:
   1. Algorithm is based on the snow cover classification algorithm provided by
      Dave Selkowitz, Research Geographer, USGS Alaska Science Center.
   2. Input and output arrays are 1D arrays of size nlines * nsamps.
+  3. The AVX2 classifier (snow_cover_class_avx2) produces identical results.
+     The loop below processes the pixels it leaves over, or all of the pixels
+     if AVX2 isn't available.
+  4. The pixels outside the valid span are fill, so the reflective QA mask
+     is on for them and they get the same 0 outputs without being
+     classified.
 ******************************************************************************/
 void snow_cover_class
 (
@@ -40,6 +518,9 @@ void snow_cover_class
     int16 *b7,     /* I: array of unscaled band 7 TOA reflectance values */
     int nlines,    /* I: number of lines in the data arrays */
     int nsamps,    /* I: number of samples in the data arrays */
+    Valid_span_t *span,  /* I: valid span of each line, outside of which the
+                               pixels are fill in every band; NULL if all
+                               of the samples are processed */
     float refl_scale_fact,  /* I: scale factor for the TOA reflectance values */
     float btemp_scale_fact, /* I: scale factor for the brightness temp values */
     int refl_sat_value,     /* I: saturation value for TOA reflectance values */
@@ -69,10 +550,52 @@ void snow_cover_class
     float b5_pix;     /* scaled band 5 value for current pixel */
     float b6_pix;     /* scaled band 6 value for current pixel */
     float b7_pix;     /* scaled band 7 value for current pixel */
+    int line;         /* current line being processed */
+    int start, end;   /* valid span of the current line */
 
-    /* Loop through the pixels in the array to determine the snow cover
-       classification */
-    for (pix = 0; pix < nlines*nsamps; pix++)
+    /* Classify the valid span of each line on its own, setting the fill
+       pixels outside of it to 0s */
+    if (span != NULL)
+    {
+        for (line = 0, pix = 0; line < nlines; line++, pix += nsamps)
+        {
+            start = span[line].start;
+            end = span[line].end;
+            memset (&snow_mask[pix], NO_SNOW, start);
+            memset (&snow_mask[pix + end], NO_SNOW, nsamps - end);
+            memset (&probability_score[pix], 0, start);
+            memset (&probability_score[pix + end], 0, nsamps - end);
+            memset (&tree_node[pix], 0, start);
+            memset (&tree_node[pix + end], 0, nsamps - end);
+            memset (&ndsi_array[pix], 0, start);
+            memset (&ndsi_array[pix + end], 0, nsamps - end);
+            memset (&ndvi_array[pix], 0, start);
+            memset (&ndvi_array[pix + end], 0, nsamps - end);
+            if (start < end)
+                snow_cover_class (&b1[pix + start], &b2[pix + start],
+                    &b3[pix + start], &b4[pix + start], &b5[pix + start],
+                    &b6[pix + start], &b7[pix + start], 1, end - start, NULL,
+                    refl_scale_fact, btemp_scale_fact, refl_sat_value,
+                    &refl_qa_mask[pix + start], &snow_mask[pix + start],
+                    &probability_score[pix + start], &tree_node[pix + start],
+                    &ndsi_array[pix + start], &ndvi_array[pix + start]);
+        }
+        return;
+    }
+
+    /* Classify as many pixels as possible with the AVX2 classifier */
+    pix = 0;
+#ifdef SNOW_CLASS_AVX2
+    if (snow_class_avx2 && __builtin_cpu_supports ("avx2"))
+        pix = snow_cover_class_avx2 (b1, b2, b3, b4, b5, b6, b7,
+            nlines*nsamps, refl_scale_fact, btemp_scale_fact, refl_sat_value,
+            refl_qa_mask, snow_mask, probability_score, tree_node, ndsi_array,
+            ndvi_array);
+#endif
+
+    /* Loop through the remaining pixels in the array to determine the snow
+       cover classification */
+    for ( ; pix < nlines*nsamps; pix++)
     {
         /* If the reflective QA mask is turned on, then skip the snow cover
            processing for this pixel */
@@ -90,38 +613,29 @@ void snow_cover_class
            then set it to it's maximum instead of the saturated value.  The
            maximum TOA reflectance value is 1.0.  Given that we are focused
            on cold pixels (clouds, snow), we won't worry about saturated
-           thermal pixels and will just use the thermal values as-is. */
+           thermal pixels and will just use the thermal values as-is.
+           Saturation is tested once, on band 1, for all the reflective
+           bands. */
         b6_pix = b6[pix] * btemp_scale_fact;
 
         if (b1[pix] == refl_sat_value)
+        {
             b1_pix = 1.0;
-        else
-            b1_pix = b1[pix] * refl_scale_fact;
-
-        if (b1[pix] == refl_sat_value)
             b2_pix = 1.0;
-        else
-            b2_pix = b2[pix] * refl_scale_fact;
-
-        if (b1[pix] == refl_sat_value)
             b3_pix = 1.0;
-        else
-            b3_pix = b3[pix] * refl_scale_fact;
-
-        if (b1[pix] == refl_sat_value)
             b4_pix = 1.0;
-        else
-            b4_pix = b4[pix] * refl_scale_fact;
-
-        if (b1[pix] == refl_sat_value)
             b5_pix = 1.0;
-        else
-            b5_pix = b5[pix] * refl_scale_fact;
-
-        if (b1[pix] == refl_sat_value)
             b7_pix = 1.0;
+        }
         else
+        {
+            b1_pix = b1[pix] * refl_scale_fact;
+            b2_pix = b2[pix] * refl_scale_fact;
+            b3_pix = b3[pix] * refl_scale_fact;
+            b4_pix = b4[pix] * refl_scale_fact;
+            b5_pix = b5[pix] * refl_scale_fact;
             b7_pix = b7[pix] * refl_scale_fact;
+        }
 
         /* Run the short-circuit tests for water and false-positives first
            to save time from running the other tests */
@@ -360,6 +874,182 @@ void snow_cover_class
 }
 
 
+/******************************************************************************
+MODULE:  count_snow_candidates
+
+PURPOSE:  Counts the pixels which pass the QA, water, and thermal tests at
+the start of the snow cover classification.  At least one of them is needed
+for a pixel to be classified as snow.
+
+RETURN VALUE:
+Type = long
+Value      Description
+-----      -----------
+ncand      Number of snow cover candidates in the arrays
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date        Programmer       Reason
+--------    ---------------  -------------------------------------
+10/14/2026  agent            Original Development
+
+NOTES:
+  1. The band values are scaled and compared the same way as in
+     snow_cover_class, so if there are no candidates, none of the pixels
+     gets past the water and thermal tests and the results are the same as
+     no_snow_cover_class.
+  2. Only two bands are read and nothing is written, so this costs a small
+     part of the classification it lets the caller skip.
+******************************************************************************/
+long count_snow_candidates
+(
+    int16 *b1,     /* I: array of unscaled band 1 TOA reflectance values */
+    int16 *b4,     /* I: array of unscaled band 4 TOA reflectance values */
+    int16 *b6,     /* I: array of unscaled band 6 brightness temp values */
+    int nlines,    /* I: number of lines in the data arrays */
+    int nsamps,    /* I: number of samples in the data arrays */
+    Valid_span_t *span,  /* I: valid span of each line, outside of which the
+                               pixels are fill in every band; NULL if all
+                               of the samples are processed */
+    float refl_scale_fact,  /* I: scale factor for the TOA reflectance values */
+    float btemp_scale_fact, /* I: scale factor for the brightness temp values */
+    int refl_sat_value,     /* I: saturation value for TOA reflectance values */
+    uint8 *refl_qa_mask  /* I: array of masked values for processing (non-zero
+                               values are not to be processed) reflectance
+                               bands */
+)
+{
+    int line;         /* current line being processed */
+    int start, end;   /* valid span of the current line */
+    long pix;         /* current pixel being processed */
+    long ncand = 0;   /* number of snow cover candidates */
+    float b4_pix;     /* scaled band 4 value for current pixel */
+    float b6_pix;     /* scaled band 6 value for current pixel */
+
+    for (line = 0; line < nlines; line++)
+    {
+        start = 0;
+        end = nsamps;
+        if (span != NULL)
+        {
+            start = span[line].start;
+            end = span[line].end;
+        }
+        for (pix = (long) line * nsamps + start;
+             pix < (long) line * nsamps + end; pix++)
+        {
+            if (refl_qa_mask[pix] != 0)
+                continue;
+            b4_pix = (b1[pix] == refl_sat_value) ? 1.0 :
+                b4[pix] * refl_scale_fact;
+            b6_pix = b6[pix] * btemp_scale_fact;
+            if (!(b4_pix < 0.11) && !(b6_pix > 24.85))
+                ncand++;
+        }
+    }
+
+    return (ncand);
+}
+
+
+/******************************************************************************
+MODULE:  no_snow_cover_class
+
+PURPOSE:  Sets the snow cover classification outputs for pixels which have
+no snow cover candidates (see count_snow_candidates), without running the
+snow cover tree.
+
+RETURN VALUE:
+Type = None
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date        Programmer       Reason
+--------    ---------------  -------------------------------------
+10/14/2026  agent            Original Development
+
+NOTES:
+  1. These are the outputs of snow_cover_class for the pixels which stop at
+     the QA test (all 0s) or the water and thermal tests (probability score
+     of 3, and 0s otherwise).
+******************************************************************************/
+void no_snow_cover_class
+(
+    int nlines,    /* I: number of lines in the data arrays */
+    int nsamps,    /* I: number of samples in the data arrays */
+    uint8 *refl_qa_mask, /* I: array of masked values for processing (non-zero
+                               values are not to be processed) reflectance
+                               bands */
+    uint8 *snow_mask,    /* O: array of snow cover masked values */
+    uint8 *probability_score,/* O: probability pixel was classified
+                               correctly */
+    uint8 *tree_node,    /* O: node in tree used to classify each pixel */
+    uint8 *ndsi_array,   /* O: NDSI outputs */
+    uint8 *ndvi_array    /* O: NDVI outputs */
+)
+{
+    long pix;         /* current pixel being processed */
+    long npix = (long) nlines * nsamps;  /* number of pixels */
+
+    memset (snow_mask, NO_SNOW, npix);
+    memset (tree_node, 0, npix);
+    memset (ndsi_array, 0, npix);
+    memset (ndvi_array, 0, npix);
+    for (pix = 0; pix < npix; pix++)
+        probability_score[pix] = (refl_qa_mask[pix] != 0) ? 0 : 3;
+}
+
+
+/******************************************************************************
+MODULE:  post_process_line_needed (static)
+
+PURPOSE:  Determines if a line of the snow mask has any pixels which the
+post-processing may change.
+
+RETURN VALUE:
+Type = bool
+Value      Description
+-----      -----------
+true       The line has snow pixels from nodes 3-x or 15-x
+false      The post-processing leaves the line as it is
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date        Programmer       Reason
+--------    ---------------  -------------------------------------
+10/14/2026  agent            Original Development
+
+NOTES:
+******************************************************************************/
+static bool post_process_line_needed
+(
+    int nsamps,         /* I: number of samples in the line */
+    uint8 *snow_mask,   /* I: snow cover mask values for the line */
+    uint8 *tree_node    /* I: tree nodes for the line */
+)
+{
+    int samp;           /* current sample being processed */
+    int orig_node;      /* original node number of the pixel */
+
+    for (samp = 0; samp < nsamps; samp++)
+    {
+        if (snow_mask[samp] != SNOW_COVER)
+            continue;
+        orig_node = tree_node[samp] / 10;
+        if (orig_node == 15 || orig_node == 3)
+            return (true);
+    }
+
+    return (false);
+}
+
+
 /******************************************************************************
 MODULE:  post_process_snow_cover_class
 
@@ -368,7 +1058,11 @@ PURPOSE:  Performs snow cover classification post-processing to clear out
     conifer regions flagged by nodes 3 or 15 of the snow cover binary tree.
 
 RETURN VALUE:
-Type = None
+Type = int
+Value      Description
+-----      -----------
+ERROR      Error allocating memory for the column counts
+SUCCESS    Successful completion
 
 PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
 at the USGS EROS
@@ -377,6 +1071,12 @@ HISTORY:
 Date        Programmer       Reason
 --------    ---------------  -------------------------------------
 2/4/2013    Gail Schmidt     Original Development
+10/14/2026  agent            Process a range of lines so the mask can be
+                             post-processed as each strip is classified
+10/14/2026  agent            Use running column counts for the window, and
+                             added the option to count the pre-pass mask
+10/14/2026  agent            Skip the lines at either end of the range
+                             which have no pixels to be post-processed
 
 NOTES:
   1. Algorithm is based on the snow cover classification algorithm provided by
@@ -388,38 +1088,106 @@ NOTES:
      covered.  If there are fewer than the snow cover threshold, then change
      the pixel to be snow free.
   3. Input and output arrays are 1D arrays of size nlines * nsamps.
+  4. The window count is not recomputed for each pixel.  The number of snow
+     pixels in the window lines is kept for each column, and is updated by
+     one line at the top and bottom as we move to the next line.  The count
+     for the window is a running sum of the column counts, updated by one
+     column at each end as we move to the next sample.
+  5. If prepass_mask is NULL (raster mode), the snow mask is modified in place
+     as the lines are processed in order, so the windows for later pixels see
+     the pixels which have already been reset.  This is the original behavior
+     of the algorithm.  Resetting a pixel also decrements its column count
+     and the running sum, so the counts match counting the current mask.
+     When processing a subset of the lines, the lines before start_line must
+     already be post-processed and the four lines after end_line (or the last
+     line of the arrays) must be available, but not yet post-processed, for
+     the results to match processing the full scene at once.  The lines need
+     to be processed in order, so they can't be split across threads.
+  6. If prepass_mask is provided (pre-pass mode), the windows are counted in
+     prepass_mask, which holds the snow mask before any post-processing, and
+     only snow_mask is modified.  The result of each pixel then doesn't
+     depend on the order of processing, so the lines may be processed in any
+     order or in parallel.  The results can differ from the raster mode,
+     since a reset pixel still counts as snow for its neighbors.
+  7. The windows are clipped at the first and last line of the arrays, which
+     are expected to be the first and last lines of the scene whenever the
+     window would extend past them.
+  8. Only the snow pixels from nodes 3-x and 15-x are changed, so the range
+     is first narrowed to the lines from the first to the last line which
+     has one of them.  The lines skipped at the start don't change the mask,
+     so the column counts of the first line left are the same in either
+     mode, and a range without any of these pixels (such as one without
+     snow) is skipped entirely.
 ******************************************************************************/
-void post_process_snow_cover_class
+int post_process_snow_cover_class
 (
     int nlines,         /* I: number of lines in the data arrays */
     int nsamps,         /* I: number of samples in the data arrays */
+    int start_line,     /* I: first line in the arrays to be processed */
+    int end_line,       /* I: line after the last line to be processed */
+    uint8 *prepass_mask,/* I: array of snow cover masked values before
+                              post-processing, used for the window counts
+                              (pre-pass mode); NULL to count snow_mask as it
+                              is modified (raster mode) */
     uint8 *snow_mask,   /* I/O: array of snow cover masked values (non-zero
                                 values represent snow) */
     uint8 *tree_node    /* I: node in binary tree used to classify each pixel */
 )
 {
+    char FUNC_NAME[] = "post_process_snow_cover_class";  /* function name */
+    char errmsg[STR_SIZE];  /* error message */
     int count;              /* number of snow-covered pixels in NxN window */
     int line, samp;         /* current line and sample being processed */
     int pix;                /* current pixel being processed */
     int start_window_line;  /* starting line for the NxN window */
     int end_window_line;    /* ending line for the NxN window */
-    int start_window_samp;  /* starting sample for the NxN window */
-    int end_window_samp;    /* ending sample for the NxN window */
-    int win_line, win_samp; /* current line and sample being processed in the
-                               NxN window */
+    int prev_start_line;    /* starting line for the window of the previous
+                               line */
+    int prev_end_line;      /* ending line for the window of the previous
+                               line */
+    int win_line;           /* current line being processed in the NxN
+                               window */
     int win_pix;            /* current window pixel being processed */
     int orig_node;          /* nodes 3 and 15 have been expanded and therefore
                                are of a value of 3-x (31, 33 .. 35) and 15-x
                                (151, 152).  this variable will represent the
                                original node number without the secondary
                                node numbers */
+    int *col_count = NULL;  /* count of snow-covered pixels in the window
+                               lines for each column */
+    uint8 *count_mask = NULL;  /* mask used for the window counts */
     static int HALF_WINDOW = 4;  /* half of 9x9 window around current pixel */
     static float SNOW_COUNT_THRESH = 7; /* threshold for count of pixels in
                                            the NxN window needing to be snow */
 
+    /* Narrow the range to the lines which have pixels to be
+       post-processed */
+    while (start_line < end_line && !post_process_line_needed (nsamps,
+        &snow_mask[(long) start_line * nsamps],
+        &tree_node[(long) start_line * nsamps]))
+        start_line++;
+    while (end_line > start_line && !post_process_line_needed (nsamps,
+        &snow_mask[(long) (end_line - 1) * nsamps],
+        &tree_node[(long) (end_line - 1) * nsamps]))
+        end_line--;
+    if (start_line >= end_line)
+        return (SUCCESS);
+
+    /* Allocate the column counts */
+    col_count = (int *) calloc (nsamps, sizeof (int));
+    if (col_count == NULL)
+    {
+        sprintf (errmsg, "Error allocating memory for the column counts");
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+    count_mask = (prepass_mask != NULL) ? prepass_mask : snow_mask;
+
     /* Loop through the pixels in the array to determine the snow cover
        classification */
-    for (line = 0; line < nlines; line++)
+    prev_start_line = 0;
+    prev_end_line = 0;
+    for (line = start_line; line < end_line; line++)
     {
         /* Find the valid NxN window for the current line */
         start_window_line = line - HALF_WINDOW;
@@ -429,54 +1197,171 @@ void post_process_snow_cover_class
         if (end_window_line >= nlines)
             end_window_line = nlines - 1;
 
+        /* Update the column counts for the lines entering and leaving the
+           window.  For the first line, count all the lines in the window. */
+        if (line == start_line)
+        {
+            prev_start_line = start_window_line;
+            prev_end_line = start_window_line - 1;
+        }
+        for (win_line = prev_start_line; win_line < start_window_line;
+             win_line++)
+        {
+            win_pix = win_line * nsamps;
+            for (samp = 0; samp < nsamps; samp++, win_pix++)
+            {
+                if (count_mask[win_pix] == SNOW_COVER)
+                    col_count[samp]--;
+            }
+        }
+        for (win_line = prev_end_line + 1; win_line <= end_window_line;
+             win_line++)
+        {
+            win_pix = win_line * nsamps;
+            for (samp = 0; samp < nsamps; samp++, win_pix++)
+            {
+                if (count_mask[win_pix] == SNOW_COVER)
+                    col_count[samp]++;
+            }
+        }
+        prev_start_line = start_window_line;
+        prev_end_line = end_window_line;
+
+        /* Start the running window count with the columns in the window for
+           the first sample */
+        count = 0;
+        for (samp = 0; samp <= HALF_WINDOW && samp < nsamps; samp++)
+            count += col_count[samp];
+
         for (samp = 0; samp < nsamps; samp++)
         {
             /* Calculate the location of the current pixel in the 1D array */
             pix = line * nsamps + samp;
 
             /* If the current pixel is snow covered and the tree node is 15-x
-               or 3-x then count the snow-covered pixels in the surrounding NxN
-               window.  If that count exceeds the threshold, then leave the
-               pixel as snow.  Otherwise change the mask to not snow covered. */
+               or 3-x then use the count of the snow-covered pixels in the
+               surrounding NxN window (or whatever smaller window is
+               available).  If that count exceeds the threshold, then leave
+               the pixel as snow.  Otherwise change the mask to not snow
+               covered. */
             orig_node = tree_node[pix] / 10;
             if (snow_mask[pix] == SNOW_COVER && (orig_node == 15 ||
                 orig_node == 3))
             {
-                /* Find the valid NxN window for the current line */
-                start_window_samp = samp - HALF_WINDOW;
-                end_window_samp = samp + HALF_WINDOW;
-                if (start_window_samp < 0)
-                    start_window_samp = 0;
-                if (end_window_samp >= nsamps)
-                    end_window_samp = nsamps - 1;
-
-                /* Loop through the NxN window (or whatever smaller window is
-                   available) */
-                count = 0;
-                for (win_line = start_window_line; win_line <= end_window_line;
-                     win_line++)
-                {
-                    /* Calculate the starting location of the current window
-                       pixel in the 1D array */
-                    win_pix = win_line * nsamps + start_window_samp;
-                    for (win_samp = start_window_samp;
-                         win_samp <= end_window_samp; win_samp++, win_pix++)
-                    {
-                        if (snow_mask[win_pix] == SNOW_COVER)
-                            count++;
-                    }
-                }
-
                 /* If the snow cover count for this pixel is less than the
-                   threshold, then reset it to no snow cover */
+                   threshold, then reset it to no snow cover.  In raster mode
+                   the pixel no longer counts for the later windows. */
                 if (count < SNOW_COUNT_THRESH)
                 {
                     snow_mask[pix] = NO_SNOW;
+                    if (prepass_mask == NULL)
+                    {
+                        col_count[samp]--;
+                        count--;
+                    }
                 }
             }  /* end if snow cover and nodes 3 or 15 */
+
+            /* Slide the window to the next sample */
+            if (samp - HALF_WINDOW >= 0)
+                count -= col_count[samp - HALF_WINDOW];
+            if (samp + HALF_WINDOW + 1 < nsamps)
+                count += col_count[samp + HALF_WINDOW + 1];
         }  /* end for samp */
     }  /* end for line */
+
+    free (col_count);
+    return (SUCCESS);
+}
+
+
+#ifdef SNOW_CLASS_AVX2
+/******************************************************************************
+MODULE:  expand_bits_avx2 (static)
+
+PURPOSE:  Expands 32 bits of a packed mask to one byte per bit.
+
+RETURN VALUE:
+Type = __m256i
+Value      Description
+-----      -----------
+bytes      All bits set in byte i if bit i is set, 0 otherwise
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. The shuffle copies byte i/8 of the bits to byte i, and the compare
+     tests bit i%8 of it.
+******************************************************************************/
+__attribute__ ((target ("avx2")))
+static inline __m256i expand_bits_avx2
+(
+    uint32_t bits        /* I: packed mask bits */
+)
+{
+    __m256i select = _mm256_set1_epi64x (0x8040201008040201LL); /* bit
+                            tested in each byte */
+    __m256i vals;        /* byte i/8 of the bits in byte i */
+
+    vals = _mm256_shuffle_epi8 (_mm256_set1_epi32 ((int) bits),
+        _mm256_setr_epi64x (0, 0x0101010101010101LL, 0x0202020202020202LL,
+        0x0303030303030303LL));
+    return (_mm256_cmpeq_epi8 (_mm256_and_si256 (vals, select), select));
+}
+
+
+/******************************************************************************
+MODULE:  store_snow_count_avx2 (static)
+
+PURPOSE:  Stores the adjacent snow counts for 32 pixels from the bit-sliced
+3x3 counts and the combined mask of the windows.
+
+RETURN VALUE:
+Type = None
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. The counts are the same as the ones assigned a bit at a time in
+     count_adjacent_snow_cover.
+******************************************************************************/
+__attribute__ ((target ("avx2")))
+static inline void store_snow_count_avx2
+(
+    uint32_t m,          /* I: combined mask for the 3x3 windows */
+    uint32_t t0,         /* I: bit 0 of the 3x3 snow counts */
+    uint32_t t1,         /* I: bit 1 of the 3x3 snow counts */
+    uint32_t t2,         /* I: bit 2 of the 3x3 snow counts */
+    uint32_t t3,         /* I: bit 3 of the 3x3 snow counts */
+    uint8 *snow_count    /* O: snow counts for the 32 pixels */
+)
+{
+    __m256i count;       /* snow counts for the pixels */
+
+    count = _mm256_or_si256 (
+        _mm256_or_si256 (
+            _mm256_and_si256 (expand_bits_avx2 (t0), _mm256_set1_epi8 (1)),
+            _mm256_and_si256 (expand_bits_avx2 (t1), _mm256_set1_epi8 (2))),
+        _mm256_or_si256 (
+            _mm256_and_si256 (expand_bits_avx2 (t2), _mm256_set1_epi8 (4)),
+            _mm256_and_si256 (expand_bits_avx2 (t3), _mm256_set1_epi8 (8))));
+    count = _mm256_blendv_epi8 (count, _mm256_set1_epi8 ((char)
+        ADJ_PIX_MASKED), expand_bits_avx2 (m));
+    _mm256_storeu_si256 ((__m256i *) snow_count, count);
 }
+#endif
 
 
 /******************************************************************************
@@ -501,97 +1386,172 @@ Date         Programmer       Reason
 2/13/2013    Gail Schmidt     Original Development
 2/21/2013    Gail Schmidt     Modified to use the combined QA mask vs. the
                               individual cloud, deep shadow, and fill masks
+10/14/2026   agent            Process a range of lines so the counts can be
+                              computed as each strip is post-processed
+10/14/2026   agent            Count a word of pixels at a time from the
+                              packed snow and combined QA masks
+10/14/2026   agent            Store the counts 32 pixels at a time using
+                              AVX2
 
 NOTES:
   1. Algorithm is based on the snow cover classification algorithm provided by
      Dave Selkowitz, Research Geographer, USGS Alaska Science Center.
-  2. Input and output arrays are 1D arrays of size nlines * nsamps.
-  3. Non-zero values represent snow, cloud, fill in the input masks.
+  2. The snow count array is a 1D array of size nlines * nsamps.  The packed
+     masks have BIT_MASK_NWORDS(nsamps) words per line.
+  3. Only lines start_line through end_line-1 of snow_count are computed.
+     The lines before and after them in the arrays must hold the final snow
+     and combined masks, since they are used for the 3x3 windows.  The
+     windows are clipped at the first and last line of the arrays.
+  4. Clipping the windows is the same as padding the masks with 0s, so each
+     word of a line is handled at once.  The window lines are OR'd for the
+     combined mask and added for the snow mask, as 2-bit sums in two words.
+     Shifting the words by one bit gives the neighboring samples, so the
+     window is OR'd or added with the words shifted each way.  The 3x3 snow
+     counts (0 to 9) end up bit-sliced in four words.
+  5. The line sums of each word are computed once and reused for the words
+     on either side of it.  The counts are unpacked from the bit-sliced
+     words 32 pixels at a time with AVX2 (store_snow_count_avx2) when the
+     processor supports it, and a bit at a time otherwise.
 ******************************************************************************/
 void count_adjacent_snow_cover
 (
     int nlines,           /* I: number of lines in the data arrays */
     int nsamps,           /* I: number of samples in the data arrays */
-    uint8 *snow_mask,     /* I: array of snow cover masked values */
-    uint8 *combined_mask, /* I: array of masked values for cloud, shadow, and
-                                fill */
+    int start_line,       /* I: first line in the arrays to be processed */
+    int end_line,         /* I: line after the last line to be processed */
+    Bit_word_t *snow_bits,     /* I: packed snow cover mask */
+    Bit_word_t *combined_bits, /* I: packed mask for cloud, shadow, and
+                                     fill */
     uint8 *snow_count     /* O: count of the snow cover results in the adjacent
                                 3x3 window, or high value if one or more of
                                 the adjacent pixels are cloud/shadow/fill */
 )
 {
-    int count;              /* number of snow-covered pixels in NxN window */
     int line, samp;         /* current line and sample being processed */
-    int pix;                /* current pixel being processed */
-    int start_window_line;  /* starting line for the NxN window */
-    int end_window_line;    /* ending line for the NxN window */
-    int start_window_samp;  /* starting sample for the NxN window */
-    int end_window_samp;    /* ending sample for the NxN window */
-    int win_line, win_samp; /* current line and sample being processed in the
-                               NxN window */
-    int win_pix;            /* current window pixel being processed */
-    static int HALF_WINDOW = 1;  /* half of 3x3 window around current pixel */
+    int iw;                 /* current word being processed */
+    int nwords;             /* number of words in a packed line */
+    int nbits;              /* number of samples in the current word */
+    int bit;                /* current bit in the word */
+    int count;              /* number of snow-covered pixels in the window */
+    Bit_word_t *snow_line[3];   /* packed snow lines for the window, NULL
+                                   past the first or last line */
+    Bit_word_t *comb_line[3];   /* packed combined lines for the window */
+    Bit_word_t masked[3];   /* window lines OR'd for the combined mask for
+                               the previous, current, and next words */
+    Bit_word_t sum0[3];     /* low bit of the window line sums of the snow
+                               mask for the previous, current, and next
+                               words */
+    Bit_word_t sum1[3];     /* high bit of the window line sums */
+    Bit_word_t m;           /* combined mask for the 3x3 windows */
+    Bit_word_t l0, l1, r0, r1;  /* line sums for the samples to the left
+                                   and right */
+    Bit_word_t s0, s1, s2;  /* sum of the left and center line sums */
+    Bit_word_t c;           /* carry */
+    Bit_word_t t0, t1, t2, t3;  /* 3x3 snow counts (bit-sliced) */
+    int i;                  /* loop counter for the window lines */
+    bool use_avx2 = false;  /* store the counts using AVX2? */
 
-    /* Loop through the pixels in the array to count the adjacent snow cover
-       pixels */
-    for (line = 0; line < nlines; line++)
+#ifdef SNOW_CLASS_AVX2
+    use_avx2 = snow_class_avx2 && __builtin_cpu_supports ("avx2");
+#endif
+
+    nwords = BIT_MASK_NWORDS (nsamps);
+    for (line = start_line; line < end_line; line++)
     {
-        /* Find the valid NxN window for the current line */
-        start_window_line = line - HALF_WINDOW;
-        end_window_line = line + HALF_WINDOW;
-        if (start_window_line < 0)
-            start_window_line = 0;
-        if (end_window_line >= nlines)
-            end_window_line = nlines - 1;
+        /* Find the valid window lines for the current line */
+        for (i = 0; i < 3; i++)
+        {
+            snow_line[i] = NULL;
+            comb_line[i] = NULL;
+            if (line - 1 + i >= 0 && line - 1 + i < nlines)
+            {
+                snow_line[i] = &snow_bits[(long) (line - 1 + i) * nwords];
+                comb_line[i] = &combined_bits[(long) (line - 1 + i) * nwords];
+            }
+        }
 
-        for (samp = 0; samp < nsamps; samp++)
+        /* Loop through the words in the line, keeping the window line
+           values for the previous, current, and next words */
+        masked[1] = sum0[1] = sum1[1] = 0;
+        for (iw = -1; iw < nwords; iw++)
         {
-            /* Calculate the location of the current pixel in the 1D array */
-            pix = line * nsamps + samp;
+            if (iw >= 0)
+            {
+                masked[0] = masked[1];
+                sum0[0] = sum0[1];
+                sum1[0] = sum1[1];
+                masked[1] = masked[2];
+                sum0[1] = sum0[2];
+                sum1[1] = sum1[2];
+            }
 
-            /* Find the valid NxN window for the current line */
-            start_window_samp = samp - HALF_WINDOW;
-            end_window_samp = samp + HALF_WINDOW;
-            if (start_window_samp < 0)
-                start_window_samp = 0;
-            if (end_window_samp >= nsamps)
-                end_window_samp = nsamps - 1;
-
-            /* Loop through the NxN window (or whatever smaller window is
-               available) */
-            count = 0;
-            for (win_line = start_window_line; win_line <= end_window_line;
-                 win_line++)
+            /* Combine the window lines for the next word */
+            masked[2] = sum0[2] = sum1[2] = 0;
+            if (iw + 1 < nwords)
             {
-                /* Calculate the starting location of the current window
-                   pixel in the 1D array */
-                win_pix = win_line * nsamps + start_window_samp;
-                for (win_samp = start_window_samp;
-                     win_samp <= end_window_samp; win_samp++, win_pix++)
+                for (i = 0; i < 3; i++)
                 {
-                    /* If the current pixel is cloud, shadow, or fill, then
-                       flag it and move to the next pixel in the image.
-                       Otherwise keep track of the count of adjacent snow
-                       pixels. */
-                    if (combined_mask[win_pix] == COMBINED_MASK)
-                    {
-                        snow_count[pix] = ADJ_PIX_MASKED;
-                        win_line = end_window_line+1;  /* make sure we break
-                            the line loop for the window as well */
-                        break;
-                    }
-
-                    /* Otherwise keep track of the count of adjacent snow
-                       pixels */
-                    if (snow_mask[win_pix] == SNOW_COVER)
-                        count++;
+                    if (snow_line[i] == NULL)
+                        continue;
+                    masked[2] |= comb_line[i][iw+1];
+                    c = sum0[2] & snow_line[i][iw+1];
+                    sum0[2] ^= snow_line[i][iw+1];
+                    sum1[2] |= c;
                 }
             }
+            if (iw < 0)
+                continue;
+
+            /* Neighboring samples for the combined mask */
+            m = masked[1] | (masked[1] << 1) | (masked[0] >> 63) |
+                (masked[1] >> 1) | (masked[2] << 63);
+
+            /* Add the line sums for the left, center, and right samples */
+            l0 = (sum0[1] << 1) | (sum0[0] >> 63);
+            l1 = (sum1[1] << 1) | (sum1[0] >> 63);
+            r0 = (sum0[1] >> 1) | (sum0[2] << 63);
+            r1 = (sum1[1] >> 1) | (sum1[2] << 63);
+
+            s0 = l0 ^ sum0[1];
+            c = l0 & sum0[1];
+            s1 = l1 ^ sum1[1] ^ c;
+            s2 = (l1 & sum1[1]) | (c & (l1 ^ sum1[1]));
+
+            t0 = s0 ^ r0;
+            c = s0 & r0;
+            t1 = s1 ^ r1 ^ c;
+            c = (s1 & r1) | (c & (s1 ^ r1));
+            t2 = s2 ^ c;
+            t3 = s2 & c;
 
             /* If the current pixel doesn't have adjacent cloud/shadow/fill
                pixels, then assign the count of adjacent snow pixels */
-            if (snow_count[pix] != ADJ_PIX_MASKED)
-                snow_count[pix] = count;
-        }  /* end for samp */
+            samp = iw * BIT_WORD_NBITS;
+            nbits = (nsamps - samp < BIT_WORD_NBITS) ? nsamps - samp :
+                BIT_WORD_NBITS;
+            bit = 0;
+#ifdef SNOW_CLASS_AVX2
+            if (use_avx2)
+            {
+                for ( ; bit + 32 <= nbits; bit += 32)
+                    store_snow_count_avx2 ((uint32_t) (m >> bit),
+                        (uint32_t) (t0 >> bit), (uint32_t) (t1 >> bit),
+                        (uint32_t) (t2 >> bit), (uint32_t) (t3 >> bit),
+                        &snow_count[(long) line * nsamps + samp + bit]);
+            }
+#endif
+            for ( ; bit < nbits; bit++)
+            {
+                if ((m >> bit) & 1)
+                    snow_count[(long) line * nsamps + samp + bit] =
+                        ADJ_PIX_MASKED;
+                else
+                {
+                    count = ((t0 >> bit) & 1) | (((t1 >> bit) & 1) << 1) |
+                        (((t2 >> bit) & 1) << 2) | (((t3 >> bit) & 1) << 3);
+                    snow_count[(long) line * nsamps + samp + bit] = count;
+                }
+            }
+        }  /* end for iw */
     }  /* end for line */
 }
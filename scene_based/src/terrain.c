@@ -0,0 +1,458 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "sca.h"
+
+/* Number of DEM lines whose normals are computed at a time when the cache
+   file is built */
+#define TERRAIN_BUILD_NLINES 64
+
+/******************************************************************************
+MODULE:  hash_file_name (static)
+
+PURPOSE:  Computes the 64-bit FNV-1a hash of a file name, which keeps the
+cache files of DEMs with the same base name apart.
+
+RETURN VALUE:
+Type = uint64_t
+Value      Description
+-----      -----------
+hash       Hash of the file name
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+******************************************************************************/
+static uint64_t hash_file_name
+(
+    char *name            /* I: file name to be hashed */
+)
+{
+    uint64_t hash = 14695981039346656037ULL;  /* FNV-1a offset basis */
+
+    for (; *name != '\0'; name++)
+    {
+        hash ^= (unsigned char) *name;
+        hash *= 1099511628211ULL;             /* FNV-1a prime */
+    }
+
+    return (hash);
+}
+
+
+/******************************************************************************
+MODULE:  build_terrain (static)
+
+PURPOSE:  Computes the surface normals of the DEM and writes them to the
+terrain cache file.
+
+RETURN VALUE:
+Type = int
+Value      Description
+-----      -----------
+ERROR      Error writing the cache file
+SUCCESS    Successful completion
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. The file is written under a temporary name and renamed when it's
+     complete, so a run reading the cache never sees a partial file, even if
+     several runs build the same cache file at once.
+  2. The first and last line and sample don't have a 3x3 window, so their
+     normals are 0.  The hillshade doesn't process them.
+  3. The lines of each block are computed in parallel and written in order.
+******************************************************************************/
+static int build_terrain
+(
+    char *file_name,         /* I: name of the cache file */
+    Terrain_header_t *hdr,   /* I: header identifying the DEM */
+    Dem_t *dem               /* I: DEM, without a window set */
+)
+{
+    char FUNC_NAME[] = "build_terrain";   /* function name */
+    char errmsg[STR_SIZE];    /* error message */
+    char tmp_file[STR_SIZE];  /* temporary name of the cache file */
+    char header[TERRAIN_HEADER_SIZE];  /* header, padded to its size */
+    int line;                 /* first line of the current block */
+    int pline;                /* line in the current block */
+    int nblock;               /* number of lines in the current block */
+    size_t line_size;         /* number of values for the normals of a line */
+    int16 *block = NULL;      /* normals for the block of lines */
+    FILE *fptr = NULL;        /* temporary cache file pointer */
+
+    if (snprintf (tmp_file, STR_SIZE, "%s.%ld.tmp", file_name,
+        (long) getpid ()) >= STR_SIZE)
+    {
+        sprintf (errmsg, "Temporary terrain cache file name is too long");
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+
+    line_size = (size_t) 3 * dem->nsamps;
+    block = calloc ((size_t) TERRAIN_BUILD_NLINES * line_size,
+        sizeof (int16));
+    if (block == NULL)
+    {
+        sprintf (errmsg, "Error allocating memory for the terrain normals");
+        error_handler (true, FUNC_NAME, errmsg);
+        return (ERROR);
+    }
+
+    fptr = fopen (tmp_file, "wb");
+    if (fptr == NULL)
+    {
+        snprintf (errmsg, sizeof (errmsg),
+            "Error opening the terrain cache file %.*s",
+            (int) (sizeof (errmsg) / 2), tmp_file);
+        error_handler (true, FUNC_NAME, errmsg);
+        free (block);
+        return (ERROR);
+    }
+
+    memset (header, 0, TERRAIN_HEADER_SIZE);
+    memcpy (header, hdr, sizeof (Terrain_header_t));
+    if (fwrite (header, 1, TERRAIN_HEADER_SIZE, fptr) != TERRAIN_HEADER_SIZE)
+    {
+        snprintf (errmsg, sizeof (errmsg),
+            "Error writing the terrain cache file %.*s",
+            (int) (sizeof (errmsg) / 2), tmp_file);
+        error_handler (true, FUNC_NAME, errmsg);
+        fclose (fptr);
+        unlink (tmp_file);
+        free (block);
+        return (ERROR);
+    }
+
+    for (line = 0; line < dem->nlines; line += nblock)
+    {
+        nblock = (dem->nlines - line < TERRAIN_BUILD_NLINES) ?
+            dem->nlines - line : TERRAIN_BUILD_NLINES;
+
+#ifdef _OPENMP
+        #pragma omp parallel for schedule(static)
+#endif
+        for (pline = 0; pline < nblock; pline++)
+        {
+            if (line + pline == 0 || line + pline == dem->nlines - 1)
+                memset (&block[pline * line_size], 0,
+                    line_size * sizeof (int16));
+            else
+                terrain_normal_line (get_dem_line (dem, line + pline - 1),
+                    get_dem_line (dem, line + pline),
+                    get_dem_line (dem, line + pline + 1), dem->nsamps,
+                    hdr->x_scale, hdr->y_scale, &block[pline * line_size]);
+        }
+
+        if (fwrite (block, sizeof (int16), nblock * line_size, fptr) !=
+            nblock * line_size)
+        {
+            snprintf (errmsg, sizeof (errmsg),
+                "Error writing the terrain cache file %.*s",
+                (int) (sizeof (errmsg) / 2), tmp_file);
+            error_handler (true, FUNC_NAME, errmsg);
+            fclose (fptr);
+            unlink (tmp_file);
+            free (block);
+            return (ERROR);
+        }
+    }
+    free (block);
+
+    if (fclose (fptr) != 0 || rename (tmp_file, file_name) != 0)
+    {
+        snprintf (errmsg, sizeof (errmsg),
+            "Error completing the terrain cache file %.*s",
+            (int) (sizeof (errmsg) / 2), file_name);
+        error_handler (true, FUNC_NAME, errmsg);
+        unlink (tmp_file);
+        return (ERROR);
+    }
+
+    return (SUCCESS);
+}
+
+
+/******************************************************************************
+MODULE:  open_terrain
+
+PURPOSE:  Opens the terrain cache file for the DEM, building it if it doesn't
+exist or was built from a different DEM, and memory maps it for read access.
+
+RETURN VALUE:
+Type = Terrain_t*
+Value      Description
+-----      -----------
+NULL       Error occurred building or mapping the cache file
+non-NULL   Successful completion
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. The cache file is named after the DEM file and a hash of its full path,
+     so the scenes of a path/row which share a DEM share the cache file.
+     The header holds the size, modification time, and inode of the DEM and
+     the slope scales, so the file is rebuilt if the DEM is replaced or the
+     pixel size is different.
+  2. The normals only depend on the DEM, so the cache file is reused for
+     any sun geometry.
+  3. The cache directory is created if it doesn't exist.
+******************************************************************************/
+Terrain_t *open_terrain
+(
+    char *cache_dir,      /* I: directory of the terrain cache files */
+    Dem_t *dem,           /* I: DEM, without a window set */
+    float x_scale,        /* I: east/west slope scale (see init_hillshade) */
+    float y_scale         /* I: north/south slope scale */
+)
+{
+    char FUNC_NAME[] = "open_terrain";   /* function name */
+    char errmsg[STR_SIZE];    /* error message */
+    char file_name[STR_SIZE]; /* name of the cache file */
+    char full_path[PATH_MAX]; /* full path of the DEM file */
+    char *base_name = NULL;   /* base name of the DEM file */
+    int fd;                   /* file descriptor of the cache file */
+    struct stat dem_stat;     /* status of the DEM file */
+    struct stat file_stat;    /* status of the cache file */
+    Terrain_header_t hdr;     /* header for the DEM */
+    Terrain_header_t file_hdr;  /* header of the existing cache file */
+    bool built = false;       /* was the cache file built? */
+    size_t file_size;         /* size of the cache file in bytes */
+    Terrain_t *this = NULL;   /* terrain data structure to be populated and
+                                 returned to the caller */
+
+    /* Identify the DEM */
+    if (fstat (dem->fd, &dem_stat) != 0)
+    {
+        sprintf (errmsg, "Error getting the status of the DEM file: %s",
+            dem->file_name);
+        error_handler (true, FUNC_NAME, errmsg);
+        return (NULL);
+    }
+    memset (&hdr, 0, sizeof (hdr));
+    memcpy (hdr.magic, TERRAIN_MAGIC, sizeof (hdr.magic));
+    hdr.nlines = dem->nlines;
+    hdr.nsamps = dem->nsamps;
+    hdr.x_scale = x_scale;
+    hdr.y_scale = y_scale;
+    hdr.dem_size = dem_stat.st_size;
+    hdr.dem_mtime = dem_stat.st_mtim.tv_sec;
+    hdr.dem_mtime_ns = dem_stat.st_mtim.tv_nsec;
+    hdr.dem_ino = dem_stat.st_ino;
+    hdr.dem_dev = dem_stat.st_dev;
+    file_size = TERRAIN_HEADER_SIZE +
+        (size_t) 3 * dem->nlines * dem->nsamps * sizeof (int16);
+
+    /* Name the cache file after the DEM */
+    if (realpath (dem->file_name, full_path) == NULL)
+        snprintf (full_path, PATH_MAX, "%s", dem->file_name);
+    base_name = strrchr (dem->file_name, '/');
+    base_name = (base_name == NULL) ? dem->file_name : base_name + 1;
+    if (snprintf (file_name, STR_SIZE, "%s/%s_%016llx.terrain", cache_dir,
+        base_name, (unsigned long long) hash_file_name (full_path)) >=
+        STR_SIZE)
+    {
+        sprintf (errmsg, "Terrain cache file name for the DEM %s is too long",
+            dem->file_name);
+        error_handler (true, FUNC_NAME, errmsg);
+        return (NULL);
+    }
+    if (mkdir (cache_dir, 0755) != 0 && errno != EEXIST)
+    {
+        sprintf (errmsg, "Error creating the terrain cache directory: %s",
+            cache_dir);
+        error_handler (true, FUNC_NAME, errmsg);
+        return (NULL);
+    }
+
+    /* Use the existing cache file if it was built from this DEM, otherwise
+       build it */
+    fd = open (file_name, O_RDONLY);
+    if (fd < 0 || read (fd, &file_hdr, sizeof (file_hdr)) !=
+        sizeof (file_hdr) || fstat (fd, &file_stat) != 0 ||
+        (size_t) file_stat.st_size != file_size ||
+        memcmp (&file_hdr, &hdr, sizeof (hdr)) != 0)
+    {
+        if (fd >= 0)
+            close (fd);
+        if (build_terrain (file_name, &hdr, dem) != SUCCESS)
+        {
+            snprintf (errmsg, sizeof (errmsg),
+                "Error building the terrain cache file %.*s",
+                (int) (sizeof (errmsg) / 2), file_name);
+            error_handler (true, FUNC_NAME, errmsg);
+            return (NULL);
+        }
+        built = true;
+        fd = open (file_name, O_RDONLY);
+        if (fd < 0)
+        {
+            snprintf (errmsg, sizeof (errmsg),
+                "Error opening the terrain cache file %.*s",
+                (int) (sizeof (errmsg) / 2), file_name);
+            error_handler (true, FUNC_NAME, errmsg);
+            return (NULL);
+        }
+    }
+
+    /* Create the terrain data structure and map the cache file */
+    this = (Terrain_t *) malloc (sizeof (Terrain_t));
+    if (this == NULL)
+    {
+        sprintf (errmsg, "Error allocating the terrain data structure");
+        error_handler (true, FUNC_NAME, errmsg);
+        close (fd);
+        return (NULL);
+    }
+    this->built = built;
+    this->nlines = dem->nlines;
+    this->nsamps = dem->nsamps;
+    this->line0 = 0;
+    this->samp0 = 0;
+    this->map_size = file_size;
+    this->file_name = dup_string (file_name);
+    this->map = mmap (NULL, file_size, PROT_READ, MAP_SHARED, fd, 0);
+    close (fd);
+    if (this->file_name == NULL || this->map == MAP_FAILED)
+    {
+        snprintf (errmsg, sizeof (errmsg),
+            "Error memory mapping the terrain cache file %.*s",
+            (int) (sizeof (errmsg) / 2), file_name);
+        error_handler (true, FUNC_NAME, errmsg);
+        if (this->map != MAP_FAILED)
+            munmap (this->map, file_size);
+        free (this->file_name);
+        free (this);
+        return (NULL);
+    }
+    this->normals = (int16 *) ((char *) this->map + TERRAIN_HEADER_SIZE);
+
+    /* The advice is only a hint, so failing to set it isn't an error */
+    madvise (this->map, file_size, MADV_SEQUENTIAL);
+
+    return (this);
+}
+
+
+/******************************************************************************
+MODULE:  set_terrain_window
+
+PURPOSE:  Sets the window of the scene to be used, so get_terrain_line
+returns the lines of the window.
+
+RETURN VALUE:
+Type = None
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+  1. The window is used in place, since each line is accessed on its own.
+     The normals of the pixels at the edges of the window are computed from
+     the DEM around the window, but the edges of the window aren't processed,
+     the same as when the hillshade is computed from the DEM window.
+******************************************************************************/
+void set_terrain_window
+(
+    Terrain_t *this,      /* I/O: terrain data structure */
+    Img_window_t *window  /* I: window of the scene to be used; must be
+                                within the DEM */
+)
+{
+    this->line0 = window->line0;
+    this->samp0 = window->samp0;
+}
+
+
+/******************************************************************************
+MODULE:  get_terrain_line
+
+PURPOSE:  Returns a pointer to the normals of a line of the DEM.
+
+RETURN VALUE:
+Type = int16*
+Value      Description
+-----      -----------
+non-NULL   x components of the normals for the line, starting at the first
+           sample of the window; the y and z components follow at nsamps and
+           2 * nsamps values after the x components
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+******************************************************************************/
+int16 *get_terrain_line
+(
+    Terrain_t *this,      /* I: terrain data structure */
+    int iline             /* I: line of the DEM or window (0-based) */
+)
+{
+    return (&this->normals[(size_t) (this->line0 + iline) * 3 *
+        this->nsamps + this->samp0]);
+}
+
+
+/******************************************************************************
+MODULE:  close_terrain
+
+PURPOSE:  Unmaps the terrain cache file, then frees the terrain data
+structure.
+
+RETURN VALUE:
+Type = None
+
+PROJECT:  Land Satellites Data System Science Research and Development (LSRD)
+at the USGS EROS
+
+HISTORY:
+Date          Programmer       Reason
+----------    ---------------  -------------------------------------
+10/14/2026    agent            Original Development
+
+NOTES:
+******************************************************************************/
+void close_terrain
+(
+    Terrain_t *this       /* I/O: terrain data structure to be closed and
+                                freed */
+)
+{
+    if (this == NULL)
+        return;
+
+    munmap (this->map, this->map_size);
+    free (this->file_name);
+    free (this);
+}
@@ -0,0 +1,76 @@
+#ifndef _TERRAIN_H_
+#define _TERRAIN_H_
+
+#include <stdint.h>
+#include "bool.h"
+#include "input.h"
+#include "dem.h"
+
+/* Terrain cache file, which holds the unit surface normal of each DEM
+   pixel as three planes of int16 values scaled by TERRAIN_NORMAL_SCALE.
+   The header identifies the DEM the normals were computed from. */
+#define TERRAIN_MAGIC "SCATERR1"
+#define TERRAIN_HEADER_SIZE 64
+#define TERRAIN_NORMAL_SCALE 32767.0
+
+typedef struct {
+    char magic[8];        /* TERRAIN_MAGIC */
+    int32_t nlines;       /* number of lines in the DEM */
+    int32_t nsamps;       /* number of samples in the DEM */
+    float x_scale;        /* east/west slope scale the normals were computed
+                             with (see init_hillshade) */
+    float y_scale;        /* north/south slope scale the normals were
+                             computed with */
+    int64_t dem_size;     /* size of the DEM file in bytes */
+    int64_t dem_mtime;    /* modification time of the DEM file (seconds) */
+    int64_t dem_mtime_ns; /* nanoseconds of the modification time */
+    int64_t dem_ino;      /* inode of the DEM file */
+    int64_t dem_dev;      /* device of the DEM file */
+} Terrain_header_t;
+
+/* Terrain planes for a scene, memory mapped from the cache file.  Each
+   line of the file holds the x, y, and z components of the normals for
+   the line, one plane of nsamps values after the other. */
+typedef struct {
+    char *file_name;      /* name of the terrain cache file */
+    bool built;           /* was the cache file built for this scene, rather
+                             than reused? */
+    int nlines;           /* number of lines in the DEM */
+    int nsamps;           /* number of samples in the DEM; also the size of
+                             each plane in a line */
+    int line0;            /* first line of the window, if one is set */
+    int samp0;            /* first sample of the window, if one is set */
+    size_t map_size;      /* size of the mapped file in bytes */
+    void *map;            /* mapped cache file */
+    int16 *normals;       /* normals for the DEM, following the header */
+} Terrain_t;
+
+/* Prototypes */
+Terrain_t *open_terrain
+(
+    char *cache_dir,      /* I: directory of the terrain cache files */
+    Dem_t *dem,           /* I: DEM, without a window set */
+    float x_scale,        /* I: east/west slope scale (see init_hillshade) */
+    float y_scale         /* I: north/south slope scale */
+);
+
+void set_terrain_window
+(
+    Terrain_t *this,      /* I/O: terrain data structure */
+    Img_window_t *window  /* I: window of the scene to be used; must be
+                                within the DEM */
+);
+
+int16 *get_terrain_line
+(
+    Terrain_t *this,      /* I: terrain data structure */
+    int iline             /* I: line of the DEM or window (0-based) */
+);
+
+void close_terrain
+(
+    Terrain_t *this       /* I/O: terrain data structure to be closed and
+                                freed */
+);
+
+#endif